@@ -40,6 +40,12 @@
 #include <sys/queue.h>
 #include <stdlib.h>
 #include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include <rte_eal.h>
 #include <rte_common.h>
@@ -57,6 +63,9 @@
 #include <rte_atomic.h>
 #include <rte_branch_prediction.h>
 #include <rte_string_fns.h>
+#include <rte_trace.h>
+#include <rte_latencystats.h>
+#include <rte_metrics.h>
 
 /* Maximum long option length for option parsing. */
 #define MAX_LONG_OPT_SZ 64
@@ -74,6 +83,24 @@ static uint32_t reset_stats;
 static uint32_t reset_xstats;
 /**< Enable memory info. */
 static uint32_t mem_info;
+/**< Enable latency statistics. */
+static uint32_t enable_latency;
+/**< Enable latency statistics reset. */
+static uint32_t reset_latency;
+/**< Enable metrics. */
+static uint32_t enable_metrics;
+/**< Socket path receiving the metric deltas, - for stdout. */
+static const char *metrics_stream;
+/**< Interval between the metric deltas, in milliseconds. */
+static unsigned metrics_interval = 1000;
+/**< Set on SIGINT or SIGTERM. */
+static volatile int force_quit;
+/**< Tracepoints to enable. */
+static const char *trace_enable;
+/**< Tracepoints to disable. */
+static const char *trace_disable;
+/**< File receiving the trace buffers. */
+static const char *trace_dump;
 
 /**< display usage */
 static void
@@ -86,7 +113,19 @@ proc_info_usage(const char *prgname)
 		"  --xstats: to display extended port statistics, disabled by "
 			"default\n"
 		"  --stats-reset: to reset port statistics\n"
-		"  --xstats-reset: to reset port extended statistics\n",
+		"  --xstats-reset: to reset port extended statistics\n"
+		"  --latency: to display the latency statistics of the TX "
+			"queues\n"
+		"  --latency-reset: to reset the latency statistics\n"
+		"  --metrics: to display the metrics\n"
+		"  --metrics-stream PATH: to send the metric changes to the "
+			"clients of a local socket (- for stdout)\n"
+		"  --metrics-interval MS: interval between the metric changes, "
+			"1000 by default\n"
+		"  --trace-enable PATTERN: to enable the matching tracepoints\n"
+		"  --trace-disable PATTERN: to disable the matching tracepoints\n"
+		"  --trace-dump FILE: to write the trace buffers in the Trace "
+			"Event Format (- for stdout)\n",
 		prgname);
 }
 
@@ -128,6 +167,14 @@ proc_info_parse_args(int argc, char **argv)
 		{"stats-reset", 0, NULL, 0},
 		{"xstats", 0, NULL, 0},
 		{"xstats-reset", 0, NULL, 0},
+		{"latency", 0, NULL, 0},
+		{"latency-reset", 0, NULL, 0},
+		{"metrics", 0, NULL, 0},
+		{"metrics-stream", 1, NULL, 0},
+		{"metrics-interval", 1, NULL, 0},
+		{"trace-enable", 1, NULL, 0},
+		{"trace-disable", 1, NULL, 0},
+		{"trace-dump", 1, NULL, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -167,6 +214,39 @@ proc_info_parse_args(int argc, char **argv)
 			else if (!strncmp(long_option[option_index].name, "xstats-reset",
 					MAX_LONG_OPT_SZ))
 				reset_xstats = 1;
+			/* Latency statistics */
+			else if (!strncmp(long_option[option_index].name,
+					"latency", MAX_LONG_OPT_SZ))
+				enable_latency = 1;
+			else if (!strncmp(long_option[option_index].name,
+					"latency-reset", MAX_LONG_OPT_SZ))
+				reset_latency = 1;
+			/* Metrics */
+			else if (!strncmp(long_option[option_index].name,
+					"metrics", MAX_LONG_OPT_SZ))
+				enable_metrics = 1;
+			else if (!strncmp(long_option[option_index].name,
+					"metrics-stream", MAX_LONG_OPT_SZ))
+				metrics_stream = optarg;
+			else if (!strncmp(long_option[option_index].name,
+					"metrics-interval", MAX_LONG_OPT_SZ)) {
+				metrics_interval = strtoul(optarg, NULL, 10);
+				if (metrics_interval == 0) {
+					printf("invalid metrics interval\n");
+					proc_info_usage(prgname);
+					return -1;
+				}
+			}
+			/* Trace buffers */
+			else if (!strncmp(long_option[option_index].name,
+					"trace-enable", MAX_LONG_OPT_SZ))
+				trace_enable = optarg;
+			else if (!strncmp(long_option[option_index].name,
+					"trace-disable", MAX_LONG_OPT_SZ))
+				trace_disable = optarg;
+			else if (!strncmp(long_option[option_index].name,
+					"trace-dump", MAX_LONG_OPT_SZ))
+				trace_dump = optarg;
 			break;
 
 		default:
@@ -193,6 +273,39 @@ meminfo_display(void)
 	printf("---------- END_TAIL_QUEUES ------------\n");
 }
 
+static int
+trace_handle(void)
+{
+	FILE *f;
+	int ret;
+
+	if (trace_enable != NULL)
+		printf("%d tracepoints enabled\n",
+			rte_trace_set_enable_pattern(trace_enable, 1));
+	if (trace_disable != NULL)
+		printf("%d tracepoints disabled\n",
+			rte_trace_set_enable_pattern(trace_disable, 0));
+	if (trace_dump == NULL)
+		return 0;
+
+	if (strcmp(trace_dump, "-") == 0)
+		f = stdout;
+	else
+		f = fopen(trace_dump, "w");
+	if (f == NULL) {
+		printf("Cannot open %s\n", trace_dump);
+		return -1;
+	}
+	ret = rte_trace_dump_json(f);
+	if (f != stdout)
+		fclose(f);
+	if (ret < 0) {
+		printf("Cannot write trace buffers\n");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 nic_stats_display(uint8_t port_id)
 {
@@ -285,6 +398,281 @@ nic_xstats_clear(uint8_t port_id)
 	printf("\n  NIC extended statistics for port %d cleared\n", port_id);
 }
 
+static void
+latency_display(uint8_t port_id)
+{
+	static const char *latency_border = "########################";
+
+	printf("\n  %s latency statistics for port %-2d %s\n",
+		latency_border, port_id, latency_border);
+	rte_latencystats_dump(stdout, port_id);
+}
+
+static void
+latency_clear(uint8_t port_id)
+{
+	uint16_t i, nb_queues;
+
+	printf("\n Clearing latency statistics for port %d\n", port_id);
+	nb_queues = rte_latencystats_queue_count(port_id);
+	for (i = 0; i < nb_queues; i++)
+		rte_latencystats_reset(port_id, i);
+	printf("\n  Latency statistics for port %d cleared\n", port_id);
+}
+
+/*
+ * The latency statistics are kept in memzones, so they are found even for
+ * the ports that were created at runtime by the primary process.
+ */
+static void
+latency_handle(void)
+{
+	unsigned i, nb_found = 0;
+
+	for (i = 0; i < RTE_MAX_ETHPORTS; i++) {
+		if (enabled_port_mask != 0 &&
+				(i >= 32 || !(enabled_port_mask & (1U << i))))
+			continue;
+		if (rte_latencystats_queue_count(i) == 0)
+			continue;
+		nb_found++;
+		if (enable_latency)
+			latency_display(i);
+		else
+			latency_clear(i);
+	}
+	if (nb_found == 0)
+		printf("Latency measurement not enabled\n");
+}
+
+/* Maximum number of clients of the metrics socket. */
+#define METRICS_MAX_CLIENTS 8
+
+static void
+signal_handler(int signum)
+{
+	if (signum == SIGINT || signum == SIGTERM)
+		force_quit = 1;
+}
+
+/* Metric names and values, kept across intervals. */
+struct metrics_snapshot {
+	struct rte_metric_name *names;
+	uint64_t *values;
+	uint64_t *prev;
+	int nb;
+	int capacity;
+};
+
+static int
+metrics_snapshot_read(struct metrics_snapshot *snap)
+{
+	int nb;
+
+	nb = rte_metrics_get_names(NULL, 0);
+	if (nb < 0)
+		return nb;
+
+	if (nb > snap->capacity) {
+		snap->names = realloc(snap->names, nb * sizeof(snap->names[0]));
+		snap->values = realloc(snap->values, nb * sizeof(uint64_t));
+		snap->prev = realloc(snap->prev, nb * sizeof(uint64_t));
+		if (snap->names == NULL || snap->values == NULL ||
+				snap->prev == NULL)
+			return -ENOMEM;
+		memset(snap->prev + snap->capacity, 0,
+			(nb - snap->capacity) * sizeof(uint64_t));
+		snap->capacity = nb;
+	}
+
+	/* values first, so that every value read has a name */
+	nb = RTE_MIN(rte_metrics_get_values(snap->values, nb), nb);
+	rte_metrics_get_names(snap->names, nb);
+	snap->nb = nb;
+
+	return nb;
+}
+
+static void
+metrics_display(void)
+{
+	struct metrics_snapshot snap;
+	int i;
+
+	memset(&snap, 0, sizeof(snap));
+	if (metrics_snapshot_read(&snap) < 0) {
+		printf("Metrics not enabled\n");
+		return;
+	}
+
+	for (i = 0; i < snap.nb; i++)
+		printf("%s %" PRIu64 "\n", snap.names[i].name, snap.values[i]);
+
+	free(snap.names);
+	free(snap.values);
+	free(snap.prev);
+}
+
+/*
+ * Write one line "<time in ms> <name> <value> <delta>" per metric which
+ * changed since the previous interval, or per metric if full is set.
+ */
+static char *
+metrics_format(const struct metrics_snapshot *snap, uint64_t now_ms,
+	int full, size_t *len)
+{
+	char *buf = NULL;
+	FILE *f;
+	int i;
+
+	f = open_memstream(&buf, len);
+	if (f == NULL)
+		return NULL;
+
+	for (i = 0; i < snap->nb; i++) {
+		if (!full && snap->values[i] == snap->prev[i])
+			continue;
+		fprintf(f, "%" PRIu64 " %s %" PRIu64 " %" PRId64 "\n",
+			now_ms, snap->names[i].name, snap->values[i],
+			full ? 0 : (int64_t) (snap->values[i] - snap->prev[i]));
+	}
+
+	fclose(f);
+	return buf;
+}
+
+static int
+metrics_send(int fd, const char *buf, size_t len)
+{
+	if (fd == STDOUT_FILENO) {
+		fwrite(buf, 1, len, stdout);
+		fflush(stdout);
+		return 0;
+	}
+
+	return (send(fd, buf, len, MSG_NOSIGNAL | MSG_DONTWAIT) ==
+		(ssize_t) len) ? 0 : -1;
+}
+
+static int
+metrics_listen(const char *path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+			listen(fd, METRICS_MAX_CLIENTS) < 0 ||
+			fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/*
+ * Send the metric changes at a fixed interval until interrupted. A client
+ * connecting first receives all the metrics with a zero delta, and the
+ * clients which cannot receive a whole interval are disconnected.
+ */
+static int
+metrics_stream_handle(void)
+{
+	struct metrics_snapshot snap;
+	int clients[METRICS_MAX_CLIENTS];
+	int new_clients[METRICS_MAX_CLIENTS];
+	int nb_clients = 0, nb_new = 0;
+	int listen_fd = -1;
+	struct timeval tv;
+	uint64_t now_ms;
+	char *buf, *full_buf;
+	size_t len, full_len;
+	int i, fd;
+
+	memset(&snap, 0, sizeof(snap));
+	if (metrics_snapshot_read(&snap) < 0) {
+		printf("Metrics not enabled\n");
+		return -1;
+	}
+
+	if (strcmp(metrics_stream, "-") == 0) {
+		new_clients[nb_new++] = STDOUT_FILENO;
+	} else {
+		listen_fd = metrics_listen(metrics_stream);
+		if (listen_fd < 0) {
+			printf("Cannot listen on %s: %s\n", metrics_stream,
+				strerror(errno));
+			return -1;
+		}
+	}
+
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+
+	while (!force_quit) {
+		while (listen_fd >= 0 &&
+				nb_clients + nb_new < METRICS_MAX_CLIENTS &&
+				(fd = accept(listen_fd, NULL, NULL)) >= 0)
+			new_clients[nb_new++] = fd;
+
+		if (metrics_snapshot_read(&snap) < 0)
+			break;
+		gettimeofday(&tv, NULL);
+		now_ms = (uint64_t) tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+		buf = metrics_format(&snap, now_ms, 0, &len);
+		full_buf = (nb_new == 0) ? NULL :
+			metrics_format(&snap, now_ms, 1, &full_len);
+
+		for (i = 0; i < nb_clients; i++) {
+			if (buf == NULL ||
+					metrics_send(clients[i], buf, len) == 0)
+				continue;
+			close(clients[i]);
+			clients[i--] = clients[--nb_clients];
+		}
+		for (i = 0; i < nb_new; i++) {
+			if (full_buf != NULL && metrics_send(new_clients[i],
+					full_buf, full_len) == 0)
+				clients[nb_clients++] = new_clients[i];
+			else
+				close(new_clients[i]);
+		}
+		nb_new = 0;
+
+		free(buf);
+		free(full_buf);
+		memcpy(snap.prev, snap.values, snap.nb * sizeof(uint64_t));
+
+		usleep(metrics_interval * 1000);
+	}
+
+	for (i = 0; i < nb_clients; i++)
+		if (clients[i] != STDOUT_FILENO)
+			close(clients[i]);
+	if (listen_fd >= 0) {
+		close(listen_fd);
+		unlink(metrics_stream);
+	}
+	free(snap.names);
+	free(snap.values);
+	free(snap.prev);
+
+	return 0;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -323,6 +711,29 @@ main(int argc, char **argv)
 		return 0;
 	}
 
+	if (trace_enable != NULL || trace_disable != NULL ||
+			trace_dump != NULL) {
+		if (trace_handle() < 0)
+			rte_exit(EXIT_FAILURE, "Trace error\n");
+		return 0;
+	}
+
+	if (enable_latency || reset_latency) {
+		latency_handle();
+		return 0;
+	}
+
+	if (metrics_stream != NULL) {
+		if (metrics_stream_handle() < 0)
+			rte_exit(EXIT_FAILURE, "Metrics error\n");
+		return 0;
+	}
+
+	if (enable_metrics) {
+		metrics_display();
+		return 0;
+	}
+
 	nb_ports = rte_eth_dev_count();
 	if (nb_ports == 0)
 		rte_exit(EXIT_FAILURE, "No Ethernet ports - bye\n");
@@ -240,6 +240,36 @@ parallel_test_group_list = [
 		 "Func" :	default_autotest,
 		 "Report" :	None,
 		},
+		{
+		 "Name" :	"Lcore mailbox autotest",
+		 "Command" : 	"mailbox_autotest",
+		 "Func" :	default_autotest,
+		 "Report" :	None,
+		},
+		{
+		 "Name" :	"Service cores autotest",
+		 "Command" : 	"service_autotest",
+		 "Func" :	default_autotest,
+		 "Report" :	None,
+		},
+		{
+		 "Name" :	"Trace autotest",
+		 "Command" : 	"trace_autotest",
+		 "Func" :	default_autotest,
+		 "Report" :	None,
+		},
+		{
+		 "Name" :	"Latency stats autotest",
+		 "Command" : 	"latencystats_autotest",
+		 "Func" :	default_autotest,
+		 "Report" :	None,
+		},
+		{
+		 "Name" :	"Metrics autotest",
+		 "Command" : 	"metrics_autotest",
+		 "Func" :	default_autotest,
+		 "Report" :	None,
+		},
 		{
 		 "Name" :	"Ring autotest",
 		 "Command" : 	"ring_autotest",
@@ -449,6 +479,19 @@ non_parallel_test_group_list = [
 		},
 	]
 },
+{
+	"Prefix" :      "power_pmd_mgmt",
+	"Memory" :      "512",
+	"Tests" :
+	[
+		{
+		 "Name" :       "Power PMD management autotest",
+		 "Command" :    "power_pmd_mgmt_autotest",
+		 "Func" :       default_autotest,
+		 "Report" :     None,
+		},
+	]
+},
 {
 	"Prefix" :	"lpm6",
 	"Memory" :	"512",
@@ -35,6 +35,8 @@
 #include <rte_mbuf.h>
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 
 #include <rte_crypto.h>
 #include <rte_cryptodev.h>
@@ -4244,6 +4246,369 @@ test_null_burst_operation(void)
 }
 
 
+/* ***** Worker lcore offload Tests ***** */
+
+#define WORKER_MODE_BURST_LENGTH	(32)
+#define WORKER_MODE_NB_BURSTS		(16)
+
+/*
+ * Virtual devices can't be freed, so the devices processing their operations
+ * on a dedicated worker lcore are only created on the first run.
+ */
+static int aesni_mb_worker_dev_id = -1;
+static int aesni_gcm_worker_dev_id = -1;
+
+struct worker_mode_params {
+	uint8_t dev_id;
+	struct rte_cryptodev_sym_session *sess;
+	uint16_t qp_id[RTE_MAX_LCORE];
+	int status[RTE_MAX_LCORE];
+};
+
+static struct worker_mode_params worker_mode_params;
+
+static int
+worker_mode_create_op(struct rte_crypto_op *op, struct rte_mempool *mpool)
+{
+	const struct gcm_test_data *tdata = &gcm_test_case_3;
+	struct rte_crypto_sym_op *sym_op = op->sym;
+	struct rte_mbuf *m;
+	uint8_t *data;
+
+	if (gbl_cryptodev_type == RTE_CRYPTODEV_AESNI_GCM_PMD) {
+		m = setup_test_string(mpool, (const char *)tdata->plaintext.data,
+				tdata->plaintext.len, 16);
+		if (m == NULL)
+			return -1;
+
+		sym_op->auth.digest.data = (uint8_t *)rte_pktmbuf_append(m,
+				tdata->auth_tag.len);
+		sym_op->auth.digest.phys_addr = rte_pktmbuf_mtophys_offset(m,
+				tdata->plaintext.len);
+		sym_op->auth.digest.length = tdata->auth_tag.len;
+
+		/* no aad, the iv is padded to the block size */
+		data = (uint8_t *)rte_pktmbuf_prepend(m, 16);
+		if (sym_op->auth.digest.data == NULL || data == NULL) {
+			rte_pktmbuf_free(m);
+			return -1;
+		}
+		sym_op->auth.aad.data = data;
+		sym_op->auth.aad.phys_addr = rte_pktmbuf_mtophys(m);
+		sym_op->auth.aad.length = 0;
+
+		memset(data, 0, 16);
+		memcpy(data, tdata->iv.data, tdata->iv.len);
+		data[15] = 1;
+		sym_op->cipher.iv.data = data;
+		sym_op->cipher.iv.phys_addr = rte_pktmbuf_mtophys(m);
+		sym_op->cipher.iv.length = 16;
+
+		sym_op->cipher.data.offset = 16;
+		sym_op->cipher.data.length = tdata->plaintext.len;
+		sym_op->auth.data.offset = 16;
+		sym_op->auth.data.length = tdata->plaintext.len;
+	} else {
+		m = setup_test_string(mpool, catch_22_quote, QUOTE_512_BYTES,
+				0);
+		if (m == NULL)
+			return -1;
+
+		sym_op->auth.digest.data = (uint8_t *)rte_pktmbuf_append(m,
+				DIGEST_BYTE_LENGTH_SHA1);
+		sym_op->auth.digest.phys_addr = rte_pktmbuf_mtophys_offset(m,
+				QUOTE_512_BYTES);
+		sym_op->auth.digest.length = DIGEST_BYTE_LENGTH_SHA1;
+		sym_op->auth.data.offset = CIPHER_IV_LENGTH_AES_CBC;
+		sym_op->auth.data.length = QUOTE_512_BYTES;
+
+		data = (uint8_t *)rte_pktmbuf_prepend(m,
+				CIPHER_IV_LENGTH_AES_CBC);
+		if (sym_op->auth.digest.data == NULL || data == NULL) {
+			rte_pktmbuf_free(m);
+			return -1;
+		}
+		rte_memcpy(data, aes_cbc_iv, CIPHER_IV_LENGTH_AES_CBC);
+		sym_op->cipher.iv.data = data;
+		sym_op->cipher.iv.phys_addr = rte_pktmbuf_mtophys(m);
+		sym_op->cipher.iv.length = CIPHER_IV_LENGTH_AES_CBC;
+		sym_op->cipher.data.offset = CIPHER_IV_LENGTH_AES_CBC;
+		sym_op->cipher.data.length = QUOTE_512_BYTES;
+	}
+
+	sym_op->m_src = m;
+	rte_crypto_op_attach_sym_session(op, worker_mode_params.sess);
+
+	return 0;
+}
+
+static int
+worker_mode_check_op(struct rte_crypto_op *op)
+{
+	const struct gcm_test_data *tdata = &gcm_test_case_3;
+	struct rte_mbuf *m = op->sym->m_src;
+	uint8_t *data;
+
+	TEST_ASSERT_EQUAL(op->status, RTE_CRYPTO_OP_STATUS_SUCCESS,
+			"crypto op processing failed");
+
+	if (gbl_cryptodev_type == RTE_CRYPTODEV_AESNI_GCM_PMD) {
+		data = rte_pktmbuf_mtod_offset(m, uint8_t *, 16);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(data, tdata->ciphertext.data,
+				tdata->ciphertext.len,
+				"GCM Ciphertext data not as expected");
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(data + tdata->plaintext.len,
+				tdata->auth_tag.data, tdata->auth_tag.len,
+				"GCM Generated auth tag not as expected");
+	} else {
+		data = rte_pktmbuf_mtod_offset(m, uint8_t *,
+				CIPHER_IV_LENGTH_AES_CBC);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(data,
+				catch_22_quote_2_512_bytes_AES_CBC_ciphertext,
+				QUOTE_512_BYTES,
+				"ciphertext data not as expected");
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(data + QUOTE_512_BYTES,
+				catch_22_quote_2_512_bytes_AES_CBC_HMAC_SHA1_digest,
+				TRUNCATED_DIGEST_BYTE_LENGTH_SHA1,
+				"Generated digest data not as expected");
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Enqueue bursts of operations on the queue pair of the calling lcore, while
+ * the worker lcore processes them, and check the completions dequeued.
+ */
+static int
+worker_mode_enqueue_dequeue(void *arg __rte_unused)
+{
+	struct crypto_testsuite_params *ts_params = &testsuite_params;
+	struct worker_mode_params *params = &worker_mode_params;
+	struct rte_crypto_op *burst[WORKER_MODE_BURST_LENGTH];
+	struct rte_crypto_op *burst_dequeued[WORKER_MODE_BURST_LENGTH];
+	unsigned lcore_id = rte_lcore_id();
+	uint16_t qp_id = params->qp_id[lcore_id];
+	unsigned i, n, nb_enq, nb_deq;
+	int ret = TEST_SUCCESS;
+
+	for (n = 0; n < WORKER_MODE_NB_BURSTS && ret == TEST_SUCCESS; n++) {
+		if (rte_crypto_op_bulk_alloc(ts_params->op_mpool,
+				RTE_CRYPTO_OP_TYPE_SYMMETRIC, burst,
+				WORKER_MODE_BURST_LENGTH) !=
+				WORKER_MODE_BURST_LENGTH) {
+			printf("lcore %u: failed to allocate crypto ops\n",
+					lcore_id);
+			ret = TEST_FAILED;
+			break;
+		}
+
+		for (i = 0; i < WORKER_MODE_BURST_LENGTH; i++) {
+			if (worker_mode_create_op(burst[i],
+					ts_params->mbuf_pool) != 0) {
+				printf("lcore %u: failed to set up crypto op\n",
+						lcore_id);
+				while (i-- > 0)
+					rte_pktmbuf_free(burst[i]->sym->m_src);
+				for (i = 0; i < WORKER_MODE_BURST_LENGTH; i++)
+					rte_crypto_op_free(burst[i]);
+				ret = TEST_FAILED;
+				break;
+			}
+		}
+		if (ret != TEST_SUCCESS)
+			break;
+
+		nb_enq = 0;
+		nb_deq = 0;
+		while (nb_deq < WORKER_MODE_BURST_LENGTH) {
+			if (nb_enq < WORKER_MODE_BURST_LENGTH)
+				nb_enq += rte_cryptodev_enqueue_burst(
+						params->dev_id, qp_id,
+						&burst[nb_enq],
+						WORKER_MODE_BURST_LENGTH - nb_enq);
+			nb_deq += rte_cryptodev_dequeue_burst(params->dev_id,
+					qp_id, &burst_dequeued[nb_deq],
+					WORKER_MODE_BURST_LENGTH - nb_deq);
+		}
+
+		for (i = 0; i < WORKER_MODE_BURST_LENGTH; i++) {
+			if (ret == TEST_SUCCESS &&
+					worker_mode_check_op(burst_dequeued[i]) !=
+					TEST_SUCCESS) {
+				printf("lcore %u: bad completion on qp %u\n",
+						lcore_id, qp_id);
+				ret = TEST_FAILED;
+			}
+			rte_pktmbuf_free(burst_dequeued[i]->sym->m_src);
+			rte_crypto_op_free(burst_dequeued[i]);
+		}
+	}
+
+	params->status[lcore_id] = ret;
+	return ret;
+}
+
+static int
+worker_mode_create_device(void)
+{
+	int *dev_id = gbl_cryptodev_type == RTE_CRYPTODEV_AESNI_GCM_PMD ?
+			&aesni_gcm_worker_dev_id : &aesni_mb_worker_dev_id;
+	const char *name = gbl_cryptodev_type == RTE_CRYPTODEV_AESNI_GCM_PMD ?
+			CRYPTODEV_NAME_AESNI_GCM_PMD :
+			CRYPTODEV_NAME_AESNI_MB_PMD;
+	unsigned lcore_id, worker_lcore = RTE_MAX_LCORE;
+	char args[32];
+	uint8_t nb_devs;
+
+	if (*dev_id >= 0)
+		return *dev_id;
+
+	/* the last slave lcore is dedicated to the device */
+	RTE_LCORE_FOREACH_SLAVE(lcore_id)
+		worker_lcore = lcore_id;
+
+	snprintf(args, sizeof(args), "%s=%u",
+			RTE_CRYPTODEV_VDEV_WORKER_LCORE_ARG, worker_lcore);
+
+	nb_devs = rte_cryptodev_count();
+	if (rte_eal_vdev_init(name, args) != 0 ||
+			rte_cryptodev_count() != nb_devs + 1)
+		return -1;
+
+	*dev_id = nb_devs;
+	return *dev_id;
+}
+
+static int
+test_worker_mode_multi_lcore(void)
+{
+	struct crypto_unittest_params *ut_params = &unittest_params;
+	struct worker_mode_params *params = &worker_mode_params;
+	const struct gcm_test_data *tdata = &gcm_test_case_3;
+	struct rte_cryptodev_config conf;
+	struct rte_cryptodev_qp_conf qp_conf;
+	struct rte_cryptodev_info info;
+	unsigned lcore_id, worker_lcore = RTE_MAX_LCORE;
+	uint16_t nb_qps = 0, qp_id;
+	int dev_id, ret = TEST_SUCCESS;
+
+	/* a worker lcore plus at least two lcores enqueuing */
+	if (rte_lcore_count() < 3) {
+		printf("Not enough lcores to run tests for worker mode\n");
+		return TEST_SUCCESS;
+	}
+
+	dev_id = worker_mode_create_device();
+	TEST_ASSERT(dev_id >= 0, "Failed to create device with a worker lcore");
+
+	memset(params, 0, sizeof(*params));
+	params->dev_id = dev_id;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id)
+		worker_lcore = lcore_id;
+
+	/*
+	 * One queue pair for each lcore but the worker, the master lcore uses
+	 * queue pair 0 so slave lcores left with it have nothing to enqueue.
+	 */
+	rte_cryptodev_info_get(dev_id, &info);
+	params->qp_id[rte_get_master_lcore()] = nb_qps++;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (lcore_id == worker_lcore)
+			continue;
+		if (nb_qps == info.max_nb_queue_pairs)
+			break;
+		params->qp_id[lcore_id] = nb_qps++;
+	}
+
+	conf.nb_queue_pairs = nb_qps;
+	conf.socket_id = SOCKET_ID_ANY;
+	conf.session_mp.nb_objs = DEFAULT_NUM_OPS_INFLIGHT;
+	conf.session_mp.cache_size = 0;
+	TEST_ASSERT_SUCCESS(rte_cryptodev_configure(dev_id, &conf),
+			"Failed to configure cryptodev %d", dev_id);
+
+	qp_conf.nb_descriptors = DEFAULT_NUM_OPS_INFLIGHT;
+	for (qp_id = 0; qp_id < nb_qps; qp_id++)
+		TEST_ASSERT_SUCCESS(rte_cryptodev_queue_pair_setup(dev_id,
+				qp_id, &qp_conf, rte_cryptodev_socket_id(dev_id)),
+				"Failed to setup queue pair %u on cryptodev %d",
+				qp_id, dev_id);
+
+	if (gbl_cryptodev_type == RTE_CRYPTODEV_AESNI_GCM_PMD) {
+		ut_params->cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
+		ut_params->cipher_xform.next = &ut_params->auth_xform;
+		ut_params->cipher_xform.cipher.algo = RTE_CRYPTO_CIPHER_AES_GCM;
+		ut_params->cipher_xform.cipher.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
+		ut_params->cipher_xform.cipher.key.data =
+				(uint8_t *)(uintptr_t)tdata->key.data;
+		ut_params->cipher_xform.cipher.key.length = tdata->key.len;
+
+		ut_params->auth_xform.type = RTE_CRYPTO_SYM_XFORM_AUTH;
+		ut_params->auth_xform.next = NULL;
+		ut_params->auth_xform.auth.algo = RTE_CRYPTO_AUTH_AES_GCM;
+		ut_params->auth_xform.auth.op = RTE_CRYPTO_AUTH_OP_GENERATE;
+		ut_params->auth_xform.auth.digest_length = tdata->auth_tag.len;
+		ut_params->auth_xform.auth.add_auth_data_length = tdata->aad.len;
+	} else {
+		ut_params->cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
+		ut_params->cipher_xform.next = &ut_params->auth_xform;
+		ut_params->cipher_xform.cipher.algo = RTE_CRYPTO_CIPHER_AES_CBC;
+		ut_params->cipher_xform.cipher.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
+		ut_params->cipher_xform.cipher.key.data = aes_cbc_key;
+		ut_params->cipher_xform.cipher.key.length =
+				CIPHER_KEY_LENGTH_AES_CBC;
+
+		ut_params->auth_xform.type = RTE_CRYPTO_SYM_XFORM_AUTH;
+		ut_params->auth_xform.next = NULL;
+		ut_params->auth_xform.auth.algo = RTE_CRYPTO_AUTH_SHA1_HMAC;
+		ut_params->auth_xform.auth.op = RTE_CRYPTO_AUTH_OP_GENERATE;
+		ut_params->auth_xform.auth.key.data = hmac_sha1_key;
+		ut_params->auth_xform.auth.key.length = HMAC_KEY_LENGTH_SHA1;
+		ut_params->auth_xform.auth.digest_length =
+				DIGEST_BYTE_LENGTH_SHA1;
+	}
+
+	params->sess = rte_cryptodev_sym_session_create(dev_id,
+			&ut_params->cipher_xform);
+	TEST_ASSERT_NOT_NULL(params->sess, "Session creation failed");
+
+	/* the worker is launched on its lcore when the device starts */
+	if (rte_cryptodev_start(dev_id) != 0) {
+		printf("Failed to start cryptodev %d\n", dev_id);
+		rte_cryptodev_sym_session_free(dev_id, params->sess);
+		return TEST_FAILED;
+	}
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (lcore_id != worker_lcore &&
+				params->qp_id[lcore_id] != 0)
+			rte_eal_remote_launch(worker_mode_enqueue_dequeue,
+					NULL, lcore_id);
+	}
+	worker_mode_enqueue_dequeue(NULL);
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (lcore_id == worker_lcore || params->qp_id[lcore_id] == 0)
+			continue;
+		rte_eal_wait_lcore(lcore_id);
+		if (params->status[lcore_id] != TEST_SUCCESS)
+			ret = TEST_FAILED;
+	}
+	if (params->status[rte_get_master_lcore()] != TEST_SUCCESS)
+		ret = TEST_FAILED;
+
+	/* stopping the device waits for the worker lcore */
+	rte_cryptodev_stop(dev_id);
+	rte_cryptodev_sym_session_free(dev_id, params->sess);
+
+	TEST_ASSERT_SUCCESS(ret, "Worker mode processing failed");
+
+	return TEST_SUCCESS;
+}
+
+
 
 
 static struct unit_test_suite cryptodev_qat_testsuite  = {
@@ -4397,6 +4762,9 @@ static struct unit_test_suite cryptodev_aesni_mb_testsuite  = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			test_not_in_place_crypto),
 
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			test_worker_mode_multi_lcore),
+
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -4438,6 +4806,9 @@ static struct unit_test_suite cryptodev_aesni_gcm_testsuite  = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			test_mb_AES_GCM_authenticated_decryption_test_case_7),
 
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			test_worker_mode_multi_lcore),
+
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
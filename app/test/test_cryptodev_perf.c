@@ -95,6 +95,43 @@ setup_test_string(struct rte_mempool *mpool,
 	return m;
 }
 
+/*
+ * Spread the test string over a chain of nb_segs mbufs, the last segment
+ * carrying the remainder of the data.
+ */
+static struct rte_mbuf *
+setup_test_string_chained(struct rte_mempool *mpool,
+		const uint8_t *data, size_t len, uint8_t nb_segs)
+{
+	struct rte_mbuf *m = NULL, *seg;
+	size_t seg_len = len / nb_segs;
+	size_t off = 0;
+	uint8_t i;
+
+	for (i = 0; i < nb_segs; i++) {
+		if (i == nb_segs - 1)
+			seg_len = len - off;
+
+		seg = setup_test_string(mpool, data + off, seg_len, 0);
+		if (seg == NULL)
+			goto fail;
+
+		if (m == NULL)
+			m = seg;
+		else if (rte_pktmbuf_chain(m, seg) != 0) {
+			rte_pktmbuf_free(seg);
+			goto fail;
+		}
+		off += seg_len;
+	}
+	return m;
+
+fail:
+	if (m)
+		rte_pktmbuf_free(m);
+	return NULL;
+}
+
 static struct crypto_testsuite_params testsuite_params = { NULL };
 static struct crypto_unittest_params unittest_params;
 static enum rte_cryptodev_type gbl_cryptodev_preftest_devtype;
@@ -1857,7 +1894,8 @@ test_perf_crypto_qp_vary_burst_size(uint16_t dev_num)
 }
 
 static int
-test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num)
+test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num,
+		uint8_t nb_segs, int sessionless)
 {
 	uint16_t index;
 	uint32_t burst_sent, burst_received;
@@ -1872,12 +1910,21 @@ test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num)
 	struct crypto_testsuite_params *ts_params = &testsuite_params;
 	struct crypto_unittest_params *ut_params = &unittest_params;
 	struct crypto_data_params *data_params = aes_cbc_hmac_sha256_output;
+	struct rte_cryptodev_info info;
 
 	if (rte_cryptodev_count() == 0) {
 		printf("\nNo crypto devices available. Is kernel driver loaded?\n");
 		return TEST_FAILED;
 	}
 
+	rte_cryptodev_info_get(dev_num, &info);
+	if (nb_segs > 1 && !(info.feature_flags &
+			RTE_CRYPTODEV_FF_MBUF_SCATTER_GATHER)) {
+		printf("\nChained mbufs not supported by device %u, "
+				"skipping test\n", dev_num);
+		return TEST_SUCCESS;
+	}
+
 	/* Setup Cipher Parameters */
 	ut_params->cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
 	ut_params->cipher_xform.next = &ut_params->auth_xform;
@@ -1898,14 +1945,21 @@ test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num)
 	ut_params->auth_xform.auth.digest_length = DIGEST_BYTE_LENGTH_SHA256;
 
 	/* Create Crypto session*/
-	ut_params->sess = rte_cryptodev_sym_session_create(ts_params->dev_id,
-			&ut_params->cipher_xform);
+	if (!sessionless) {
+		ut_params->sess = rte_cryptodev_sym_session_create(
+				ts_params->dev_id, &ut_params->cipher_xform);
 
-	TEST_ASSERT_NOT_NULL(ut_params->sess, "Session creation failed");
+		TEST_ASSERT_NOT_NULL(ut_params->sess,
+				"Session creation failed");
+	}
 
 	printf("\nThroughput test which will continually attempt to send "
 			"AES128_CBC_SHA256_HMAC requests with a constant burst "
 			"size of %u while varying payload sizes", DEFAULT_BURST_SIZE);
+	if (nb_segs > 1)
+		printf(", each payload spread over %u chained mbufs", nb_segs);
+	if (sessionless)
+		printf(", using session-less operations");
 	printf("\nDev No\tQP No\tReq Size(B)\tNum Sent\tNum Received\t"
 			"Mrps\tThoughput(Gbps)");
 	printf("\tRetries (Attempted a burst, but the device was busy)");
@@ -1917,12 +1971,13 @@ test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num)
 
 		/* Generate Crypto op data structure(s) */
 		for (b = 0; b < DEFAULT_BURST_SIZE ; b++) {
-			struct rte_mbuf *m = setup_test_string(
+			struct rte_mbuf *m = setup_test_string_chained(
 					ts_params->mbuf_mp,
 					(const uint8_t *)
 					data_params[index].plaintext,
 					data_params[index].length,
-					0);
+					nb_segs);
+			TEST_ASSERT_NOT_NULL(m, "Failed to allocate tx_buf");
 
 			ut_params->digest = (uint8_t *)rte_pktmbuf_append(m,
 					DIGEST_BYTE_LENGTH_SHA256);
@@ -1937,12 +1992,26 @@ test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(uint16_t dev_num)
 					ts_params->op_mpool,
 					RTE_CRYPTO_OP_TYPE_SYMMETRIC);
 
-			rte_crypto_op_attach_sym_session(op, ut_params->sess);
+			if (sessionless) {
+				struct rte_crypto_sym_xform *xform =
+					rte_crypto_op_sym_xforms_alloc(op, 2);
+				TEST_ASSERT_NOT_NULL(xform,
+						"Failed to allocate op xforms");
+
+				xform->type = ut_params->cipher_xform.type;
+				xform->cipher = ut_params->cipher_xform.cipher;
+				xform->next->type = ut_params->auth_xform.type;
+				xform->next->auth = ut_params->auth_xform.auth;
+			} else
+				rte_crypto_op_attach_sym_session(op,
+						ut_params->sess);
 
 			op->sym->auth.digest.data = ut_params->digest;
 			op->sym->auth.digest.phys_addr =
-					rte_pktmbuf_mtophys_offset(m,
-						data_params[index].length);
+					rte_pktmbuf_mtophys_offset(
+						rte_pktmbuf_lastseg(m),
+						rte_pktmbuf_lastseg(m)->data_len -
+						DIGEST_BYTE_LENGTH_SHA256);
 			op->sym->auth.digest.length = DIGEST_BYTE_LENGTH_SHA256;
 
 			op->sym->auth.data.offset = CIPHER_IV_LENGTH_AES_CBC;
@@ -2024,6 +2093,112 @@ static int
 test_perf_encrypt_digest_vary_req_size(void)
 {
 	return test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(
+			testsuite_params.dev_id, 1, 0);
+}
+
+static int
+test_perf_encrypt_digest_vary_req_size_sessionless(void)
+{
+	return test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(
+			testsuite_params.dev_id, 1, 1);
+}
+
+static int
+test_perf_encrypt_digest_vary_req_size_chained(void)
+{
+	return test_perf_AES_CBC_HMAC_SHA256_encrypt_digest_vary_req_size(
+			testsuite_params.dev_id, 4, 0);
+}
+
+#define SESSION_SETUP_NUM_KEYS		(64)
+#define SESSION_SETUP_NUM_ITERATIONS	(16)
+
+/*
+ * Measure the cycle cost of setting up and freeing an AES128_CBC_SHA256_HMAC
+ * session, first with keys never seen by the device, then when rekeying with
+ * keys that were used by earlier sessions.
+ */
+static int
+test_perf_AES_CBC_HMAC_SHA256_session_setup(uint16_t dev_num)
+{
+	struct crypto_unittest_params *ut_params = &unittest_params;
+	struct rte_cryptodev_sym_session *sess;
+	uint8_t cipher_keys[SESSION_SETUP_NUM_KEYS][CIPHER_KEY_LENGTH_AES_CBC];
+	uint8_t auth_keys[SESSION_SETUP_NUM_KEYS][HMAC_KEY_LENGTH_SHA256];
+	uint64_t start_cycles, cold_cycles = 0, warm_cycles = 0;
+	unsigned i, j, k;
+
+	if (rte_cryptodev_count() == 0) {
+		printf("\nNo crypto devices available. Is kernel driver loaded?\n");
+		return TEST_FAILED;
+	}
+
+	/* Setup Cipher Parameters */
+	ut_params->cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
+	ut_params->cipher_xform.next = &ut_params->auth_xform;
+
+	ut_params->cipher_xform.cipher.algo = RTE_CRYPTO_CIPHER_AES_CBC;
+	ut_params->cipher_xform.cipher.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
+	ut_params->cipher_xform.cipher.key.length = CIPHER_KEY_LENGTH_AES_CBC;
+
+	/* Setup HMAC Parameters */
+	ut_params->auth_xform.type = RTE_CRYPTO_SYM_XFORM_AUTH;
+	ut_params->auth_xform.next = NULL;
+
+	ut_params->auth_xform.auth.op = RTE_CRYPTO_AUTH_OP_GENERATE;
+	ut_params->auth_xform.auth.algo = RTE_CRYPTO_AUTH_SHA256_HMAC;
+	ut_params->auth_xform.auth.key.length = HMAC_KEY_LENGTH_SHA256;
+	ut_params->auth_xform.auth.digest_length = DIGEST_BYTE_LENGTH_SHA256;
+
+	/* Derive distinct keys from the test keys and the TSC */
+	for (i = 0; i < SESSION_SETUP_NUM_KEYS; i++) {
+		uint64_t seed = rte_rdtsc() + i;
+
+		for (k = 0; k < CIPHER_KEY_LENGTH_AES_CBC; k++)
+			cipher_keys[i][k] = aes_cbc_key[k] ^
+					(uint8_t)(seed >> (8 * (k % 8)));
+		for (k = 0; k < HMAC_KEY_LENGTH_SHA256; k++)
+			auth_keys[i][k] = hmac_sha256_key[k] ^
+					(uint8_t)(seed >> (8 * (k % 8)));
+	}
+
+	for (j = 0; j <= SESSION_SETUP_NUM_ITERATIONS; j++) {
+		for (i = 0; i < SESSION_SETUP_NUM_KEYS; i++) {
+			ut_params->cipher_xform.cipher.key.data =
+					cipher_keys[i];
+			ut_params->auth_xform.auth.key.data = auth_keys[i];
+
+			start_cycles = rte_rdtsc_precise();
+			sess = rte_cryptodev_sym_session_create(dev_num,
+					&ut_params->cipher_xform);
+			TEST_ASSERT_NOT_NULL(sess, "Session creation failed");
+			rte_cryptodev_sym_session_free(dev_num, sess);
+
+			/* First pass sets up sessions with new keys */
+			if (j == 0)
+				cold_cycles += rte_rdtsc_precise() -
+						start_cycles;
+			else
+				warm_cycles += rte_rdtsc_precise() -
+						start_cycles;
+		}
+	}
+
+	printf("\nSession setup test measuring the IA cycle cost of creating "
+			"and freeing AES128_CBC_SHA256_HMAC sessions");
+	printf("\nDev No\tNew keys (cycles)\tKnown keys (cycles)");
+	printf("\n%u\t%"PRIu64"\t\t\t%"PRIu64"\n", dev_num,
+			cold_cycles / SESSION_SETUP_NUM_KEYS,
+			warm_cycles / (SESSION_SETUP_NUM_KEYS *
+				SESSION_SETUP_NUM_ITERATIONS));
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_perf_session_setup(void)
+{
+	return test_perf_AES_CBC_HMAC_SHA256_session_setup(
 			testsuite_params.dev_id);
 }
 
@@ -2041,6 +2216,12 @@ static struct unit_test_suite cryptodev_testsuite  = {
 	.unit_test_cases = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 				test_perf_encrypt_digest_vary_req_size),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+				test_perf_encrypt_digest_vary_req_size_chained),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+				test_perf_encrypt_digest_vary_req_size_sessionless),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+				test_perf_session_setup),
 		TEST_CASE_ST(ut_setup, ut_teardown,
 				test_perf_vary_burst_size),
 		TEST_CASES_END() /**< NULL terminate unit test array */
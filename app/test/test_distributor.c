@@ -40,6 +40,7 @@
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
 #include <rte_distributor.h>
+#include <rte_reorder.h>
 
 #define ITER_POWER 20 /* log 2 of how many iterations we do when timing. */
 #define BURST 32
@@ -478,6 +479,85 @@ int test_error_distributor_create_numworkers(void)
 }
 
 
+static struct rte_reorder_mp_buffer *reorder;
+
+/* worker function inserting the packets in the reorder buffer set in the
+ * distributor. Half of the workers insert the packets themselves and the
+ * others return them to the distributor which inserts them.
+ */
+static int
+handle_work_with_reorder(void *arg)
+{
+	struct rte_mbuf *pkt = NULL;
+	struct rte_distributor *d = arg;
+	unsigned id = __sync_fetch_and_add(&worker_idx, 1);
+
+	pkt = rte_distributor_get_pkt(d, id, NULL);
+	while (!quit) {
+		worker_stats[id].handled_packets++;
+		if ((id & 1) == 0 && rte_reorder_mp_insert(reorder, pkt) == 0)
+			pkt = NULL;
+		pkt = rte_distributor_get_pkt(d, id, pkt);
+	}
+	worker_stats[id].handled_packets++;
+	rte_distributor_return_pkt(d, id, pkt);
+	return 0;
+}
+
+/* check that packets spread over the workers with different tags are put
+ * back in order in the reorder buffer */
+static int
+sanity_test_with_reorder(struct rte_distributor *d, struct rte_mempool *p)
+{
+	struct rte_mbuf *many_bufs[BIG_BATCH], *return_bufs[BIG_BATCH];
+	unsigned num_returned = 0;
+	unsigned i;
+
+	printf("=== Sanity test of reordering of returned packets ===\n");
+	clear_packet_count();
+	if (rte_distributor_reorder_set(d, reorder) != 0) {
+		printf("line %d: Error setting reorder buffer\n", __LINE__);
+		return -1;
+	}
+
+	if (rte_mempool_get_bulk(p, (void *)many_bufs, BIG_BATCH) != 0) {
+		printf("line %d: Error getting mbufs from pool\n", __LINE__);
+		rte_distributor_reorder_set(d, NULL);
+		return -1;
+	}
+	for (i = 0; i < BIG_BATCH; i++)
+		many_bufs[i]->hash.usr = i;
+
+	for (i = 0; i < BIG_BATCH/BURST; i++) {
+		rte_distributor_process(d, &many_bufs[i*BURST], BURST);
+		num_returned += rte_reorder_mp_drain(reorder,
+				&return_bufs[num_returned],
+				BIG_BATCH - num_returned);
+	}
+	rte_distributor_flush(d);
+	num_returned += rte_reorder_mp_drain(reorder,
+			&return_bufs[num_returned], BIG_BATCH - num_returned);
+	rte_distributor_reorder_set(d, NULL);
+
+	rte_mempool_put_bulk(p, (void *)many_bufs, BIG_BATCH);
+
+	if (num_returned != BIG_BATCH) {
+		printf("line %d: Number reordered %u is not the same as "
+				"number sent\n", __LINE__, num_returned);
+		return -1;
+	}
+	for (i = 0; i < BIG_BATCH; i++) {
+		if (return_bufs[i] != many_bufs[i]) {
+			printf("line %d: Packet #%u returned out of order\n",
+					__LINE__, i);
+			return -1;
+		}
+	}
+	printf("Sanity test of reordering done\n\n");
+
+	return 0;
+}
+
 /* Useful function which ensures that all worker functions terminate */
 static void
 quit_workers(struct rte_distributor *d, struct rte_mempool *p)
@@ -541,6 +621,22 @@ test_distributor(void)
 		goto err;
 	quit_workers(d, p);
 
+	if (reorder == NULL) {
+		reorder = rte_reorder_mp_create("Test_distributor", rte_socket_id(),
+				BIG_BATCH);
+		if (reorder == NULL) {
+			printf("Error creating reorder buffer\n");
+			return -1;
+		}
+	}
+
+	rte_eal_mp_remote_launch(handle_work_with_reorder, d, SKIP_MASTER);
+	if (sanity_test_with_reorder(d, p) < 0)
+		goto err;
+	quit_workers(d, p);
+	rte_reorder_mp_free(reorder);
+	reorder = NULL;
+
 	rte_eal_mp_remote_launch(handle_work_with_free_mbufs, d, SKIP_MASTER);
 	if (sanity_test_with_mbuf_alloc(d, p) < 0)
 		goto err;
@@ -573,6 +669,9 @@ test_distributor(void)
 
 err:
 	quit_workers(d, p);
+	rte_distributor_reorder_set(d, NULL);
+	rte_reorder_mp_free(reorder);
+	reorder = NULL;
 	return -1;
 }
 
@@ -988,6 +988,13 @@ test_misc_flags(void)
 	const char *argv15[] = {prgname, "--file-prefix=intr",
 			"-c", "1", "-n", "2", "--vfio-intr=invalid"};
 
+	/* try running with --iova-mode PA flag */
+	const char *argv16[] = {prgname, "--file-prefix=iova",
+			"-c", "1", "-n", "2", "--iova-mode=pa"};
+
+	/* try running with --iova-mode invalid flag */
+	const char *argv17[] = {prgname, "--file-prefix=iova",
+			"-c", "1", "-n", "2", "--iova-mode=invalid"};
 
 	if (launch_proc(argv0) == 0) {
 		printf("Error - process ran ok with invalid flag\n");
@@ -1060,6 +1067,16 @@ test_misc_flags(void)
 				"--vfio-intr invalid parameter\n");
 		return -1;
 	}
+	if (launch_proc(argv16) != 0) {
+		printf("Error - process did not run ok with "
+				"--iova-mode PA parameter\n");
+		return -1;
+	}
+	if (launch_proc(argv17) == 0) {
+		printf("Error - process run ok with "
+				"--iova-mode invalid parameter\n");
+		return -1;
+	}
 	return 0;
 }
 #endif
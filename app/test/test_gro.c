@@ -0,0 +1,432 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <netinet/in.h>
+
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_lcore.h>
+#include <rte_gro.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 256
+#define GRO_TEST_PAYLOAD_LEN 100
+#define GRO_TEST_VXLAN_PORT 4789
+#define GRO_TEST_TCP_HDR_LEN \
+	(ETHER_HDR_LEN + sizeof(struct ipv4_hdr) + sizeof(struct tcp_hdr))
+#define GRO_TEST_VXLAN_HDR_LEN \
+	(ETHER_HDR_LEN + sizeof(struct ipv4_hdr) + ETHER_VXLAN_HLEN + \
+	 GRO_TEST_TCP_HDR_LEN)
+
+/* the inner IPv4 packet fits in 64K, not the outer one */
+#define GRO_TEST_LARGE_NB_PKTS 40
+#define GRO_TEST_LARGE_PAYLOAD_LEN 1637
+
+#define TCP_ACK 0x10
+#define TCP_SYN 0x02
+
+static struct rte_mempool *gro_pool;
+
+static const struct rte_gro_param gro_param = {
+	.gro_types = RTE_GRO_TCP_IPV4 | RTE_GRO_IPV4_VXLAN_TCP_IPV4,
+	.max_flow_num = 4,
+	.max_item_per_flow = 8,
+	.vxlan_port = 0,
+	.socket_id = SOCKET_ID_ANY,
+};
+
+static void
+fill_ipv4_hdr(struct ipv4_hdr *ip, uint16_t len, uint8_t proto,
+		uint16_t ip_id, uint32_t src_addr)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(len);
+	ip->packet_id = rte_cpu_to_be_16(ip_id);
+	ip->time_to_live = 64;
+	ip->next_proto_id = proto;
+	ip->src_addr = rte_cpu_to_be_32(src_addr);
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 2));
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+}
+
+/*
+ * Build a TCP/IPv4 segment, encapsulated in VXLAN if vxlan is set. The
+ * payload bytes are derived from their sequence number.
+ */
+static struct rte_mbuf *
+build_pkt(uint16_t src_port, uint32_t seq, uint16_t ip_id,
+		uint16_t payload_len, uint8_t flags, int vxlan)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	struct vxlan_hdr *vxh;
+	struct tcp_hdr *tcp;
+	uint16_t len, i;
+	uint8_t *p;
+
+	m = rte_pktmbuf_alloc(gro_pool);
+	if (m == NULL)
+		return NULL;
+
+	len = GRO_TEST_TCP_HDR_LEN + payload_len;
+	if (vxlan)
+		len += GRO_TEST_VXLAN_HDR_LEN - GRO_TEST_TCP_HDR_LEN;
+	p = (uint8_t *)rte_pktmbuf_append(m, len);
+	if (p == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(p, 0, len);
+
+	if (vxlan) {
+		eth = (struct ether_hdr *)p;
+		eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+		eth->s_addr.addr_bytes[5] = 0x11;
+		ip = (struct ipv4_hdr *)(eth + 1);
+		fill_ipv4_hdr(ip, len - ETHER_HDR_LEN, IPPROTO_UDP, ip_id,
+			IPv4(192, 168, 0, 1));
+		udp = (struct udp_hdr *)(ip + 1);
+		udp->src_port = rte_cpu_to_be_16(src_port);
+		udp->dst_port = rte_cpu_to_be_16(GRO_TEST_VXLAN_PORT);
+		udp->dgram_len = rte_cpu_to_be_16(len - ETHER_HDR_LEN -
+			sizeof(*ip));
+		vxh = (struct vxlan_hdr *)(udp + 1);
+		vxh->vx_flags = rte_cpu_to_be_32(0x08000000);
+		vxh->vx_vni = rte_cpu_to_be_32(100 << 8);
+		p = (uint8_t *)(vxh + 1);
+		len -= GRO_TEST_VXLAN_HDR_LEN - GRO_TEST_TCP_HDR_LEN;
+	}
+
+	eth = (struct ether_hdr *)p;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	eth->s_addr.addr_bytes[5] = 0x22;
+	ip = (struct ipv4_hdr *)(eth + 1);
+	fill_ipv4_hdr(ip, len - ETHER_HDR_LEN, IPPROTO_TCP, ip_id,
+		IPv4(10, 0, 0, 1));
+	tcp = (struct tcp_hdr *)(ip + 1);
+	tcp->src_port = rte_cpu_to_be_16(src_port);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = (sizeof(*tcp) / 4) << 4;
+	tcp->tcp_flags = flags;
+
+	p = (uint8_t *)(tcp + 1);
+	for (i = 0; i < payload_len; i++)
+		p[i] = (uint8_t)(seq + i);
+
+	return m;
+}
+
+/* check the IPv4 header of a merged packet */
+static int
+check_ipv4_hdr(const struct ipv4_hdr *ip, uint16_t len)
+{
+	struct ipv4_hdr hdr = *ip;
+
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length), len,
+		"Bad IPv4 total length");
+	hdr.hdr_checksum = 0;
+	TEST_ASSERT_EQUAL(rte_ipv4_cksum(&hdr), ip->hdr_checksum,
+		"Bad IPv4 checksum");
+	return 0;
+}
+
+/* check the length, the headers and the payload of a merged packet */
+static int
+check_merged(struct rte_mbuf *m, uint32_t seq, uint32_t payload_len,
+		int vxlan)
+{
+	const struct ipv4_hdr *ip;
+	const struct udp_hdr *udp;
+	uint32_t hdr_len, off;
+	uint8_t buf[GRO_TEST_PAYLOAD_LEN];
+	const uint8_t *p;
+	uint32_t i, len;
+
+	hdr_len = vxlan ? GRO_TEST_VXLAN_HDR_LEN : GRO_TEST_TCP_HDR_LEN;
+	TEST_ASSERT_EQUAL(m->pkt_len, hdr_len + payload_len,
+		"Bad length of merged packet");
+
+	ip = rte_pktmbuf_mtod_offset(m, const struct ipv4_hdr *,
+		ETHER_HDR_LEN);
+	if (vxlan) {
+		if (check_ipv4_hdr(ip, m->pkt_len - ETHER_HDR_LEN) < 0)
+			return -1;
+		udp = (const struct udp_hdr *)(ip + 1);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(udp->dgram_len),
+			m->pkt_len - ETHER_HDR_LEN - sizeof(*ip),
+			"Bad outer UDP length");
+		ip = (const struct ipv4_hdr *)((const char *)(udp + 1) +
+			sizeof(struct vxlan_hdr) + ETHER_HDR_LEN);
+	}
+	if (check_ipv4_hdr(ip, sizeof(*ip) + sizeof(struct tcp_hdr) +
+			payload_len) < 0)
+		return -1;
+
+	for (off = 0; off < payload_len; off += len) {
+		len = RTE_MIN(payload_len - off, sizeof(buf));
+		p = rte_pktmbuf_read(m, hdr_len + off, len, buf);
+		TEST_ASSERT_NOT_NULL(p, "Cannot read payload");
+		for (i = 0; i < len; i++)
+			TEST_ASSERT_EQUAL(p[i], (uint8_t)(seq + off + i),
+				"Bad payload at offset %u", off + i);
+	}
+	return 0;
+}
+
+static int
+test_gro_tcp4_burst(void)
+{
+	struct rte_mbuf *pkts[8];
+	uint16_t nb_pkts;
+	unsigned i;
+
+	/* two interleaved flows, one of them out of order */
+	pkts[0] = build_pkt(1000, 100, 10, GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	pkts[1] = build_pkt(2000, 500 + GRO_TEST_PAYLOAD_LEN, 21,
+		GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	pkts[2] = build_pkt(1000, 100 + GRO_TEST_PAYLOAD_LEN, 11,
+		GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	pkts[3] = build_pkt(2000, 500, 20, GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	/* a SYN is never merged */
+	pkts[4] = build_pkt(1000, 100 + 2 * GRO_TEST_PAYLOAD_LEN, 12,
+		GRO_TEST_PAYLOAD_LEN, TCP_SYN, 0);
+	pkts[5] = build_pkt(1000, 100 + 2 * GRO_TEST_PAYLOAD_LEN, 12,
+		GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	/* a gap in the sequence numbers */
+	pkts[6] = build_pkt(1000, 100 + 4 * GRO_TEST_PAYLOAD_LEN, 13,
+		GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	/* a discontinuous IPv4 ID without DF */
+	pkts[7] = build_pkt(1000, 100 + 3 * GRO_TEST_PAYLOAD_LEN, 20,
+		GRO_TEST_PAYLOAD_LEN, TCP_ACK, 0);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u", i);
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &gro_param);
+	TEST_ASSERT_EQUAL(nb_pkts, 5, "Bad number of packets after GRO");
+
+	/* the merged packets take the place of the first packet */
+	TEST_ASSERT_SUCCESS(check_merged(pkts[0], 100,
+		3 * GRO_TEST_PAYLOAD_LEN, 0), "Bad first flow");
+	TEST_ASSERT_EQUAL(pkts[0]->nb_segs, 3, "Bad number of segments");
+	TEST_ASSERT_SUCCESS(check_merged(pkts[1], 500,
+		2 * GRO_TEST_PAYLOAD_LEN, 0), "Bad second flow");
+	TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[2]),
+		GRO_TEST_TCP_HDR_LEN + GRO_TEST_PAYLOAD_LEN, "SYN was merged");
+	TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[3]),
+		GRO_TEST_TCP_HDR_LEN + GRO_TEST_PAYLOAD_LEN,
+		"Packet after a gap was merged");
+	TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[4]),
+		GRO_TEST_TCP_HDR_LEN + GRO_TEST_PAYLOAD_LEN,
+		"Packet with a bad IPv4 ID was merged");
+
+	for (i = 0; i < nb_pkts; i++)
+		rte_pktmbuf_free(pkts[i]);
+	return 0;
+}
+
+static int
+test_gro_vxlan_burst(void)
+{
+	struct rte_mbuf *pkts[4];
+	uint16_t nb_pkts;
+	unsigned i;
+
+	for (i = 0; i < RTE_DIM(pkts); i++) {
+		pkts[i] = build_pkt(3000, 1000 + i * GRO_TEST_PAYLOAD_LEN,
+			30 + i, GRO_TEST_PAYLOAD_LEN, TCP_ACK, 1);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u", i);
+	}
+
+	/* VXLAN packets are not merged as plain TCP/IPv4 */
+	{
+		struct rte_gro_param param = gro_param;
+
+		param.gro_types = RTE_GRO_TCP_IPV4;
+		nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts),
+			&param);
+		TEST_ASSERT_EQUAL(nb_pkts, RTE_DIM(pkts),
+			"VXLAN packets merged as TCP/IPv4");
+	}
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &gro_param);
+	TEST_ASSERT_EQUAL(nb_pkts, 1, "VXLAN packets were not merged");
+	TEST_ASSERT_SUCCESS(check_merged(pkts[0], 1000,
+		RTE_DIM(pkts) * GRO_TEST_PAYLOAD_LEN, 1), "Bad VXLAN packet");
+
+	rte_pktmbuf_free(pkts[0]);
+	return 0;
+}
+
+static int
+test_gro_vxlan_max_len(void)
+{
+	struct rte_mbuf *pkts[GRO_TEST_LARGE_NB_PKTS];
+	uint16_t nb_pkts;
+	unsigned i;
+
+	for (i = 0; i < RTE_DIM(pkts); i++) {
+		pkts[i] = build_pkt(4000, i * GRO_TEST_LARGE_PAYLOAD_LEN,
+			40 + i, GRO_TEST_LARGE_PAYLOAD_LEN, TCP_ACK, 1);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u", i);
+	}
+
+	/* the last packet would overflow the outer IPv4 total length */
+	nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &gro_param);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Bad number of packets after GRO");
+	TEST_ASSERT_SUCCESS(check_merged(pkts[0], 0,
+		(RTE_DIM(pkts) - 1) * GRO_TEST_LARGE_PAYLOAD_LEN, 1),
+		"Bad VXLAN packet");
+	TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[1]),
+		GRO_TEST_VXLAN_HDR_LEN + GRO_TEST_LARGE_PAYLOAD_LEN,
+		"Packet overflowing the outer length was merged");
+
+	for (i = 0; i < nb_pkts; i++)
+		rte_pktmbuf_free(pkts[i]);
+	return 0;
+}
+
+static int
+test_gro_ctx(void)
+{
+	struct rte_mbuf *pkts[4], *out[4];
+	struct rte_gro_param param = gro_param;
+	uint16_t nb_pkts;
+	void *ctx;
+	unsigned i;
+
+	param.gro_types = 0;
+	TEST_ASSERT_NULL(rte_gro_ctx_create(&param),
+		"Context created without type");
+
+	ctx = rte_gro_ctx_create(&gro_param);
+	TEST_ASSERT_NOT_NULL(ctx, "Cannot create GRO context");
+
+	/* the segments of a flow are merged across bursts */
+	for (i = 0; i < RTE_DIM(pkts); i++) {
+		pkts[0] = build_pkt(4000, 2000 + i * GRO_TEST_PAYLOAD_LEN,
+			40 + i, GRO_TEST_PAYLOAD_LEN, TCP_ACK, i >= 2);
+		pkts[1] = build_pkt(5000, 0, 0, 0, TCP_ACK, 0);
+		TEST_ASSERT_NOT_NULL(pkts[0], "Cannot build packet");
+		TEST_ASSERT_NOT_NULL(pkts[1], "Cannot build packet");
+
+		/* the pure ACK is returned */
+		nb_pkts = rte_gro_reassemble(pkts, 2, ctx);
+		TEST_ASSERT_EQUAL(nb_pkts, 1, "Bad number of packets left");
+		TEST_ASSERT_EQUAL(rte_pktmbuf_pkt_len(pkts[0]),
+			GRO_TEST_TCP_HDR_LEN, "Bad packet left");
+		rte_pktmbuf_free(pkts[0]);
+	}
+	/* one TCP/IPv4 and one VXLAN packet */
+	TEST_ASSERT_EQUAL(rte_gro_get_pkt_count(ctx), 2,
+		"Bad number of packets in context");
+
+	/* the packets are not flushed before the timeout */
+	TEST_ASSERT_EQUAL(rte_gro_timeout_flush(ctx, UINT64_MAX,
+		gro_param.gro_types, out, RTE_DIM(out)), 0,
+		"Packets flushed before timeout");
+
+	TEST_ASSERT_EQUAL(rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV4,
+		out, RTE_DIM(out)), 1, "Bad number of flushed packets");
+	TEST_ASSERT_SUCCESS(check_merged(out[0], 2000,
+		2 * GRO_TEST_PAYLOAD_LEN, 0), "Bad flushed packet");
+	rte_pktmbuf_free(out[0]);
+
+	TEST_ASSERT_EQUAL(rte_gro_timeout_flush(ctx, 0, gro_param.gro_types,
+		out, RTE_DIM(out)), 1, "Bad number of flushed packets");
+	TEST_ASSERT_SUCCESS(check_merged(out[0], 2000 +
+		2 * GRO_TEST_PAYLOAD_LEN, 2 * GRO_TEST_PAYLOAD_LEN, 1),
+		"Bad flushed VXLAN packet");
+	rte_pktmbuf_free(out[0]);
+	TEST_ASSERT_EQUAL(rte_gro_get_pkt_count(ctx), 0,
+		"Packets left in context");
+
+	rte_gro_ctx_destroy(ctx);
+	return 0;
+}
+
+static int
+test_setup(void)
+{
+	if (gro_pool == NULL) {
+		gro_pool = rte_pktmbuf_pool_create("GRO_MBUF_POOL", NUM_MBUFS,
+			0, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+		if (gro_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+test_gro_no_leak(void)
+{
+	TEST_ASSERT_EQUAL(rte_mempool_count(gro_pool), NUM_MBUFS,
+		"Mbufs were leaked");
+	return 0;
+}
+
+static struct unit_test_suite gro_test_suite  = {
+	.setup = test_setup,
+	.suite_name = "GRO Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_gro_tcp4_burst),
+		TEST_CASE(test_gro_vxlan_burst),
+		TEST_CASE(test_gro_vxlan_max_len),
+		TEST_CASE(test_gro_ctx),
+		TEST_CASE(test_gro_no_leak),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gro(void)
+{
+	return unit_test_suite_runner(&gro_test_suite);
+}
+
+static struct test_command gro_cmd = {
+	.command = "gro_autotest",
+	.callback = test_gro,
+};
+REGISTER_TEST_COMMAND(gro_cmd);
@@ -0,0 +1,570 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <netinet/in.h>
+
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_ring.h>
+#include <rte_lcore.h>
+#include <rte_gso.h>
+#ifdef RTE_LIBRTE_PMD_RING
+#include <rte_eth_ring.h>
+#endif
+
+#include "test.h"
+
+#define NUM_MBUFS 256
+#define GSO_TEST_PAYLOAD_LEN 3000
+/* the payload is split at an odd offset between two segments */
+#define GSO_TEST_FIRST_PAYLOAD_LEN 999
+#define GSO_TEST_MSS 1000
+#define GSO_TEST_NB_SEGS 3
+#define GSO_TEST_VXLAN_PORT 4789
+#define GSO_TEST_IP_ID 100
+#define GSO_TEST_SEQ 1000
+
+#define GSO_TEST_L3_HDR_LEN (ETHER_HDR_LEN + sizeof(struct ipv4_hdr))
+#define GSO_TEST_TCP_HDR_LEN (GSO_TEST_L3_HDR_LEN + sizeof(struct tcp_hdr))
+#define GSO_TEST_OUTER_HDR_LEN (GSO_TEST_L3_HDR_LEN + ETHER_VXLAN_HLEN)
+
+#define TCP_FIN 0x01
+#define TCP_PSH 0x08
+#define TCP_ACK 0x10
+#define TCP_CWR 0x80
+
+static struct rte_mempool *gso_pool;
+static struct rte_mempool *gso_indirect_pool;
+
+static void
+fill_ipv4_hdr(struct ipv4_hdr *ip, uint16_t len, uint8_t proto)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(len);
+	ip->packet_id = rte_cpu_to_be_16(GSO_TEST_IP_ID);
+	ip->time_to_live = 64;
+	ip->next_proto_id = proto;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 2));
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+}
+
+/*
+ * Build a TCP/IPv4 packet, encapsulated in VXLAN if vxlan is set, or a
+ * UDP/IPv4 datagram if proto is IPPROTO_UDP, with a payload of
+ * GSO_TEST_PAYLOAD_LEN bytes split over two segments. The payload bytes
+ * are derived from their offset.
+ */
+static struct rte_mbuf *
+build_pkt(uint8_t proto, int vxlan)
+{
+	struct rte_mbuf *m, *tail;
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	struct vxlan_hdr *vxh;
+	struct tcp_hdr *tcp;
+	uint16_t hdr_len, l4_hdr_len, len, i;
+	uint8_t *p;
+
+	m = rte_pktmbuf_alloc(gso_pool);
+	tail = rte_pktmbuf_alloc(gso_pool);
+	if (m == NULL || tail == NULL)
+		goto fail;
+
+	l4_hdr_len = proto == IPPROTO_TCP ? sizeof(*tcp) : sizeof(*udp);
+	hdr_len = GSO_TEST_L3_HDR_LEN + l4_hdr_len;
+	if (vxlan)
+		hdr_len += GSO_TEST_OUTER_HDR_LEN;
+	p = (uint8_t *)rte_pktmbuf_append(m, hdr_len +
+		GSO_TEST_FIRST_PAYLOAD_LEN);
+	if (p == NULL)
+		goto fail;
+	memset(p, 0, hdr_len);
+
+	len = hdr_len + GSO_TEST_PAYLOAD_LEN;
+	m->ol_flags = PKT_TX_IPV4;
+	m->l2_len = ETHER_HDR_LEN;
+	m->l3_len = sizeof(*ip);
+	if (vxlan) {
+		eth = (struct ether_hdr *)p;
+		eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+		ip = (struct ipv4_hdr *)(eth + 1);
+		fill_ipv4_hdr(ip, len - ETHER_HDR_LEN, IPPROTO_UDP);
+		udp = (struct udp_hdr *)(ip + 1);
+		udp->src_port = rte_cpu_to_be_16(5000);
+		udp->dst_port = rte_cpu_to_be_16(GSO_TEST_VXLAN_PORT);
+		udp->dgram_len = rte_cpu_to_be_16(len - GSO_TEST_L3_HDR_LEN);
+		vxh = (struct vxlan_hdr *)(udp + 1);
+		vxh->vx_flags = rte_cpu_to_be_32(0x08000000);
+		vxh->vx_vni = rte_cpu_to_be_32(100 << 8);
+		p = (uint8_t *)(vxh + 1);
+		len -= GSO_TEST_OUTER_HDR_LEN;
+
+		m->ol_flags |= PKT_TX_OUTER_IPV4;
+		m->outer_l2_len = ETHER_HDR_LEN;
+		m->outer_l3_len = sizeof(*ip);
+		m->l2_len = ETHER_VXLAN_HLEN + ETHER_HDR_LEN;
+	}
+
+	eth = (struct ether_hdr *)p;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	ip = (struct ipv4_hdr *)(eth + 1);
+	fill_ipv4_hdr(ip, len - ETHER_HDR_LEN, proto);
+	if (proto == IPPROTO_TCP) {
+		tcp = (struct tcp_hdr *)(ip + 1);
+		tcp->src_port = rte_cpu_to_be_16(1000);
+		tcp->dst_port = rte_cpu_to_be_16(80);
+		tcp->sent_seq = rte_cpu_to_be_32(GSO_TEST_SEQ);
+		tcp->recv_ack = rte_cpu_to_be_32(1);
+		tcp->data_off = (sizeof(*tcp) / 4) << 4;
+		tcp->tcp_flags = TCP_CWR | TCP_ACK | TCP_PSH | TCP_FIN;
+		p = (uint8_t *)(tcp + 1);
+		m->ol_flags |= PKT_TX_TCP_SEG;
+		m->l4_len = sizeof(*tcp);
+	} else {
+		udp = (struct udp_hdr *)(ip + 1);
+		udp->src_port = rte_cpu_to_be_16(1000);
+		udp->dst_port = rte_cpu_to_be_16(53);
+		udp->dgram_len = rte_cpu_to_be_16(len - GSO_TEST_L3_HDR_LEN);
+		p = (uint8_t *)(udp + 1);
+		m->ol_flags |= PKT_TX_UDP_SEG | PKT_TX_UDP_CKSUM;
+	}
+	for (i = 0; i < GSO_TEST_FIRST_PAYLOAD_LEN; i++)
+		p[i] = (uint8_t)i;
+
+	p = (uint8_t *)rte_pktmbuf_append(tail,
+		GSO_TEST_PAYLOAD_LEN - GSO_TEST_FIRST_PAYLOAD_LEN);
+	if (p == NULL)
+		goto fail;
+	for (; i < GSO_TEST_PAYLOAD_LEN; i++)
+		p[i - GSO_TEST_FIRST_PAYLOAD_LEN] = (uint8_t)i;
+	if (rte_pktmbuf_chain(m, tail) < 0)
+		goto fail;
+
+	return m;
+
+fail:
+	rte_pktmbuf_free(m);
+	rte_pktmbuf_free(tail);
+	return NULL;
+}
+
+/* check the header checksum of an IPv4 header */
+static int
+check_ipv4_cksum(const struct ipv4_hdr *ip)
+{
+	TEST_ASSERT_EQUAL(rte_raw_cksum(ip, sizeof(*ip)), 0xffff,
+		"Bad IPv4 checksum");
+	return 0;
+}
+
+/*
+ * Check the TCP segment at offset l4_off of an output packet: its IPv4
+ * header, checksum and payload, which starts at offset pyld_off of the
+ * original payload.
+ */
+static int
+check_tcp_segment(struct rte_mbuf *m, uint16_t l4_off, uint16_t pyld_off,
+		uint16_t pyld_len, uint16_t ip_id)
+{
+	static uint8_t buf[sizeof(struct tcp_hdr) + GSO_TEST_MSS];
+	const struct ipv4_hdr *ip;
+	const struct tcp_hdr *tcp;
+	const uint8_t *p;
+	uint16_t l4_len, i;
+	uint32_t sum;
+
+	l4_len = sizeof(*tcp) + pyld_len;
+	TEST_ASSERT_EQUAL(m->pkt_len, l4_off + l4_len, "Bad segment length");
+	TEST_ASSERT_EQUAL((m->ol_flags & PKT_TX_TCP_SEG), 0,
+		"TSO flag not cleared");
+
+	ip = rte_pktmbuf_mtod_offset(m, const struct ipv4_hdr *,
+		l4_off - sizeof(*ip));
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+		sizeof(*ip) + l4_len, "Bad IPv4 total length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->packet_id), ip_id,
+		"Bad IPv4 ID");
+	if (check_ipv4_cksum(ip) < 0)
+		return -1;
+
+	tcp = rte_pktmbuf_mtod_offset(m, const struct tcp_hdr *, l4_off);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp->sent_seq),
+		GSO_TEST_SEQ + pyld_off, "Bad TCP sequence number");
+	TEST_ASSERT_EQUAL(!!(tcp->tcp_flags & TCP_CWR), (pyld_off == 0),
+		"Bad TCP CWR flag");
+	TEST_ASSERT_EQUAL(!!(tcp->tcp_flags & (TCP_PSH | TCP_FIN)),
+		(pyld_off + pyld_len == GSO_TEST_PAYLOAD_LEN),
+		"Bad TCP PSH or FIN flag");
+
+	p = rte_pktmbuf_read(m, l4_off, l4_len, buf);
+	TEST_ASSERT_NOT_NULL(p, "Cannot read segment");
+	sum = rte_raw_cksum(p, l4_len);
+	sum += rte_ipv4_phdr_cksum(ip, 0);
+	TEST_ASSERT_EQUAL(__rte_raw_cksum_reduce(sum), 0xffff,
+		"Bad TCP checksum");
+
+	p += sizeof(*tcp);
+	for (i = 0; i < pyld_len; i++)
+		TEST_ASSERT_EQUAL(p[i], (uint8_t)(pyld_off + i),
+			"Bad payload at offset %u", pyld_off + i);
+	return 0;
+}
+
+static int
+test_gso_tcp4(void)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = gso_pool,
+		.indirect_pool = gso_indirect_pool,
+		.gso_types = RTE_GSO_TCP_IPV4,
+		.gso_size = ETHER_MAX_LEN - ETHER_CRC_LEN,
+		.flag = 0,
+	};
+	struct rte_mbuf *pkt, *segs[GSO_TEST_NB_SEGS + 1];
+	int i, nb_segs;
+
+	pkt = build_pkt(IPPROTO_TCP, 0);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build packet");
+	pkt->tso_segsz = GSO_TEST_MSS;
+
+	/* too small an output array */
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, GSO_TEST_NB_SEGS - 1);
+	TEST_ASSERT_EQUAL(nb_segs, -EINVAL, "Output array overflowed");
+	TEST_ASSERT_EQUAL(rte_mbuf_refcnt_read(pkt), 1,
+		"Packet modified on error");
+
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, GSO_TEST_NB_SEGS,
+		"Bad number of segments");
+	for (i = 0; i < nb_segs; i++) {
+		TEST_ASSERT_SUCCESS(check_tcp_segment(segs[i],
+			GSO_TEST_TCP_HDR_LEN - sizeof(struct tcp_hdr),
+			i * GSO_TEST_MSS, GSO_TEST_MSS, GSO_TEST_IP_ID + i),
+			"Bad segment %d", i);
+		rte_pktmbuf_free(segs[i]);
+	}
+	return 0;
+}
+
+static int
+test_gso_vxlan_tcp4(void)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = gso_pool,
+		.indirect_pool = gso_indirect_pool,
+		.gso_types = RTE_GSO_IPV4_VXLAN_TCP_IPV4,
+		.gso_size = GSO_TEST_OUTER_HDR_LEN + GSO_TEST_TCP_HDR_LEN +
+			GSO_TEST_MSS,
+		.flag = RTE_GSO_FLAG_IPID_FIXED,
+	};
+	struct rte_mbuf *pkt, *segs[GSO_TEST_NB_SEGS];
+	const struct ipv4_hdr *ip;
+	const struct udp_hdr *udp;
+	int i, nb_segs;
+
+	pkt = build_pkt(IPPROTO_TCP, 1);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build packet");
+
+	/* VXLAN packets are not segmented unless requested */
+	ctx.gso_types = RTE_GSO_TCP_IPV4;
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, 1, "VXLAN packet segmented");
+	TEST_ASSERT_EQUAL(segs[0], pkt, "VXLAN packet modified");
+
+	/* the MSS is given by gso_size */
+	ctx.gso_types = RTE_GSO_IPV4_VXLAN_TCP_IPV4;
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, GSO_TEST_NB_SEGS,
+		"Bad number of segments");
+	for (i = 0; i < nb_segs; i++) {
+		ip = rte_pktmbuf_mtod_offset(segs[i], const struct ipv4_hdr *,
+			ETHER_HDR_LEN);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+			segs[i]->pkt_len - ETHER_HDR_LEN,
+			"Bad outer IPv4 total length");
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->packet_id),
+			GSO_TEST_IP_ID, "Bad outer IPv4 ID");
+		TEST_ASSERT_SUCCESS(check_ipv4_cksum(ip),
+			"Bad outer IPv4 checksum");
+		udp = (const struct udp_hdr *)(ip + 1);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(udp->dgram_len),
+			segs[i]->pkt_len - GSO_TEST_L3_HDR_LEN,
+			"Bad outer UDP length");
+		TEST_ASSERT_EQUAL(udp->dgram_cksum, 0,
+			"Outer UDP checksum not cleared");
+
+		TEST_ASSERT_SUCCESS(check_tcp_segment(segs[i],
+			GSO_TEST_OUTER_HDR_LEN + GSO_TEST_L3_HDR_LEN,
+			i * GSO_TEST_MSS, GSO_TEST_MSS, GSO_TEST_IP_ID),
+			"Bad segment %d", i);
+		rte_pktmbuf_free(segs[i]);
+	}
+	return 0;
+}
+
+static int
+test_gso_udp4(void)
+{
+	static uint8_t buf[sizeof(struct udp_hdr) + GSO_TEST_PAYLOAD_LEN];
+	struct rte_gso_ctx ctx = {
+		.direct_pool = gso_pool,
+		.indirect_pool = gso_indirect_pool,
+		.gso_types = RTE_GSO_UDP_IPV4,
+		.gso_size = ETHER_MAX_LEN - ETHER_CRC_LEN,
+		.flag = 0,
+	};
+	struct rte_mbuf *pkt, *segs[GSO_TEST_NB_SEGS];
+	struct ipv4_hdr *ip, hdr;
+	const uint8_t *p;
+	uint16_t frag_off, frag_len, pyld_unit_size;
+	uint32_t sum;
+	int i, nb_segs;
+
+	pkt = build_pkt(IPPROTO_UDP, 0);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build packet");
+
+	/* datagrams are only fragmented on request */
+	pkt->ol_flags &= ~PKT_TX_UDP_SEG;
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, 1, "Datagram fragmented without request");
+	TEST_ASSERT_EQUAL(segs[0], pkt, "Datagram modified without request");
+	pkt->ol_flags |= PKT_TX_UDP_SEG;
+
+	/* datagrams with DF are not fragmented */
+	ip = rte_pktmbuf_mtod_offset(pkt, struct ipv4_hdr *, ETHER_HDR_LEN);
+	ip->fragment_offset = rte_cpu_to_be_16(IPV4_HDR_DF_FLAG);
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, 1, "Datagram with DF fragmented");
+	TEST_ASSERT_EQUAL(segs[0], pkt, "Datagram with DF modified");
+	ip->fragment_offset = 0;
+
+	pyld_unit_size = (ctx.gso_size - GSO_TEST_L3_HDR_LEN) & ~7;
+	nb_segs = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(nb_segs, GSO_TEST_NB_SEGS,
+		"Bad number of fragments");
+
+	frag_off = 0;
+	for (i = 0; i < nb_segs; i++) {
+		frag_len = segs[i]->pkt_len - GSO_TEST_L3_HDR_LEN;
+		TEST_ASSERT(frag_len == pyld_unit_size || i == nb_segs - 1,
+			"Bad fragment length");
+		TEST_ASSERT_EQUAL((segs[i]->ol_flags & PKT_TX_L4_MASK), 0,
+			"UDP checksum offload not cleared");
+		TEST_ASSERT_EQUAL((segs[i]->ol_flags & PKT_TX_UDP_SEG), 0,
+			"UDP segmentation request not cleared");
+
+		ip = rte_pktmbuf_mtod_offset(segs[i], struct ipv4_hdr *,
+			ETHER_HDR_LEN);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+			sizeof(*ip) + frag_len, "Bad IPv4 total length");
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->packet_id),
+			GSO_TEST_IP_ID, "Bad IPv4 ID");
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->fragment_offset),
+			((frag_off / IPV4_HDR_OFFSET_UNITS) |
+			(i < nb_segs - 1 ? IPV4_HDR_MF_FLAG : 0)),
+			"Bad IPv4 fragment offset");
+		TEST_ASSERT_SUCCESS(check_ipv4_cksum(ip), "Bad IPv4 checksum");
+
+		p = rte_pktmbuf_read(segs[i], GSO_TEST_L3_HDR_LEN, frag_len,
+			buf + frag_off);
+		TEST_ASSERT_NOT_NULL(p, "Cannot read fragment");
+		if (p != buf + frag_off)
+			memcpy(buf + frag_off, p, frag_len);
+		frag_off += frag_len;
+	}
+	TEST_ASSERT_EQUAL(frag_off, sizeof(buf), "Bad datagram length");
+
+	/* the UDP checksum covers the whole datagram */
+	hdr = *ip;
+	hdr.fragment_offset = 0;
+	hdr.total_length = rte_cpu_to_be_16(sizeof(hdr) + sizeof(buf));
+	sum = rte_raw_cksum(buf, sizeof(buf));
+	sum += rte_ipv4_phdr_cksum(&hdr, 0);
+	TEST_ASSERT_EQUAL(__rte_raw_cksum_reduce(sum), 0xffff,
+		"Bad UDP checksum");
+
+	for (i = 0; i < nb_segs; i++)
+		rte_pktmbuf_free(segs[i]);
+	return 0;
+}
+
+#ifdef RTE_LIBRTE_PMD_RING
+static int
+test_gso_tx_burst(void)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = gso_pool,
+		.indirect_pool = gso_indirect_pool,
+		.gso_types = RTE_GSO_TCP_IPV4,
+		.gso_size = ETHER_MAX_LEN - ETHER_CRC_LEN,
+		.flag = 0,
+	};
+	static struct rte_ring *ring;
+	static int port = -1;
+	struct rte_mbuf *pkts[3], *out[8];
+	unsigned i, nb_out;
+	uint16_t nb_tx, nb_drops;
+
+	/* the ring holds up to 7 packets */
+	if (port < 0) {
+		ring = rte_ring_create("GSO_TX_RING", 8, rte_socket_id(),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+		TEST_ASSERT_NOT_NULL(ring, "Cannot create ring");
+		port = rte_eth_from_ring(ring);
+		TEST_ASSERT(port >= 0, "Cannot create ring port");
+	}
+
+	/* only the TCP packet between the UDP datagrams is segmented */
+	pkts[0] = build_pkt(IPPROTO_UDP, 0);
+	pkts[1] = build_pkt(IPPROTO_TCP, 0);
+	pkts[2] = build_pkt(IPPROTO_UDP, 0);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u", i);
+	pkts[1]->tso_segsz = GSO_TEST_MSS;
+
+	nb_tx = rte_gso_tx_burst(port, 0, pkts, RTE_DIM(pkts), &ctx, &nb_drops);
+	TEST_ASSERT_EQUAL(nb_tx, RTE_DIM(pkts), "Bad number of sent packets");
+	TEST_ASSERT_EQUAL(nb_drops, 0, "Segments dropped");
+	nb_out = rte_ring_dequeue_burst(ring, (void **)out, RTE_DIM(out));
+	TEST_ASSERT_EQUAL(nb_out, GSO_TEST_NB_SEGS + 2,
+		"Bad number of packets in ring");
+	TEST_ASSERT(out[0] == pkts[0] && out[nb_out - 1] == pkts[2],
+		"Packets reordered");
+	for (i = 1; i < nb_out - 1; i++)
+		TEST_ASSERT_SUCCESS(check_tcp_segment(out[i],
+			GSO_TEST_TCP_HDR_LEN - sizeof(struct tcp_hdr),
+			(i - 1) * GSO_TEST_MSS, GSO_TEST_MSS,
+			GSO_TEST_IP_ID + i - 1), "Bad segment %u", i - 1);
+	rte_pktmbuf_free_bulk(out, nb_out);
+
+	/* with room for 2 packets, the last segment is dropped */
+	pkts[0] = build_pkt(IPPROTO_TCP, 0);
+	pkts[1] = build_pkt(IPPROTO_TCP, 0);
+	TEST_ASSERT(pkts[0] != NULL && pkts[1] != NULL,
+		"Cannot build packets");
+	for (i = 0; i < 5; i++)
+		TEST_ASSERT_SUCCESS(rte_ring_enqueue(ring, pkts[1]),
+			"Cannot fill ring");
+	nb_tx = rte_gso_tx_burst(port, 0, pkts, 2, &ctx, &nb_drops);
+	TEST_ASSERT_EQUAL(nb_tx, 1, "Partially sent packet not consumed");
+	TEST_ASSERT_EQUAL(nb_drops, GSO_TEST_NB_SEGS - 2,
+		"Bad number of dropped segments");
+	nb_out = rte_ring_dequeue_burst(ring, (void **)out, RTE_DIM(out));
+	TEST_ASSERT_EQUAL(nb_out, 7, "Bad number of packets in ring");
+	rte_pktmbuf_free_bulk(&out[5], 2);
+
+	/* with a full ring, the packet is left to the caller */
+	for (i = 0; i < 7; i++)
+		TEST_ASSERT_SUCCESS(rte_ring_enqueue(ring, pkts[1]),
+			"Cannot fill ring");
+	nb_tx = rte_gso_tx_burst(port, 0, &pkts[1], 1, &ctx, &nb_drops);
+	TEST_ASSERT_EQUAL(nb_tx, 0, "Packet sent to a full ring");
+	TEST_ASSERT_EQUAL(nb_drops, 0, "Segments of a packet not sent dropped");
+	while (rte_ring_dequeue(ring, (void **)&out[0]) == 0)
+		;
+	TEST_ASSERT_EQUAL(rte_mbuf_refcnt_read(pkts[1]), 1,
+		"Bad reference count of the packet not sent");
+	TEST_ASSERT_EQUAL(rte_mbuf_refcnt_read(pkts[1]->next), 1,
+		"Bad reference count of the packet not sent");
+	rte_pktmbuf_free(pkts[1]);
+	return 0;
+}
+#endif
+
+static int
+test_setup(void)
+{
+	if (gso_pool == NULL) {
+		gso_pool = rte_pktmbuf_pool_create("GSO_MBUF_POOL", NUM_MBUFS,
+			0, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+		if (gso_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	if (gso_indirect_pool == NULL) {
+		gso_indirect_pool = rte_pktmbuf_pool_create(
+			"GSO_INDIRECT_POOL", NUM_MBUFS, 0, 0, 0,
+			rte_socket_id());
+		if (gso_indirect_pool == NULL) {
+			printf("%s: Error creating indirect mempool\n",
+				__func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+test_gso_no_leak(void)
+{
+	TEST_ASSERT_EQUAL(rte_mempool_count(gso_pool), NUM_MBUFS,
+		"Mbufs were leaked");
+	TEST_ASSERT_EQUAL(rte_mempool_count(gso_indirect_pool), NUM_MBUFS,
+		"Indirect mbufs were leaked");
+	return 0;
+}
+
+static struct unit_test_suite gso_test_suite  = {
+	.setup = test_setup,
+	.suite_name = "GSO Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_gso_tcp4),
+		TEST_CASE(test_gso_vxlan_tcp4),
+		TEST_CASE(test_gso_udp4),
+#ifdef RTE_LIBRTE_PMD_RING
+		TEST_CASE(test_gso_tx_burst),
+#endif
+		TEST_CASE(test_gso_no_leak),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gso(void)
+{
+	return unit_test_suite_runner(&gso_test_suite);
+}
+
+static struct test_command gso_cmd = {
+	.command = "gso_autotest",
+	.callback = test_gso,
+};
+REGISTER_TEST_COMMAND(gso_cmd);
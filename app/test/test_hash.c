@@ -101,13 +101,15 @@ struct flow_key {
 
 /*
  * Hash function that always returns the same value, to easily test what
- * happens when a bucket is full.
+ * happens when a bucket is full. Upper 16 bits (the short signature
+ * stored in the buckets) are non-zero, so that the alternative bucket
+ * differs from the primary one.
  */
 static uint32_t pseudo_hash(__attribute__((unused)) const void *keys,
 			    __attribute__((unused)) uint32_t key_len,
 			    __attribute__((unused)) uint32_t init_val)
 {
-	return 3;
+	return 3 | (1 << 16);
 }
 
 /*
@@ -540,15 +542,18 @@ static int test_five_keys(void)
 	return 0;
 }
 
+#define BUCKET_ENTRIES 8
+#define FULL_BUCKET_KEYS (BUCKET_ENTRIES + 1)
+
 /*
  * Add keys to the same bucket until bucket full.
- *	- add 5 keys to the same bucket (hash created with 4 keys per bucket):
- *	  first 4 successful, 5th successful, pushing existing item in bucket
- *	- lookup the 5 keys: 5 hits
- *	- add the 5 keys again: 5 OK
- *	- lookup the 5 keys: 5 hits (updated data)
- *	- delete the 5 keys: 5 OK
- *	- lookup the 5 keys: 5 misses
+ *	- add 9 keys to the same bucket (hash created with 8 keys per bucket):
+ *	  first 8 successful, 9th successful, pushing existing item in bucket
+ *	- lookup the 9 keys: 9 hits
+ *	- add the 9 keys again: 9 OK
+ *	- lookup the 9 keys: 9 hits (updated data)
+ *	- delete the 9 keys: 9 OK
+ *	- lookup the 9 keys: 9 misses
  */
 static int test_full_bucket(void)
 {
@@ -561,17 +566,24 @@ static int test_full_bucket(void)
 		.socket_id = 0,
 	};
 	struct rte_hash *handle;
-	int pos[5];
-	int expected_pos[5];
+	struct flow_key full_keys[FULL_BUCKET_KEYS];
+	int pos[FULL_BUCKET_KEYS];
+	int expected_pos[FULL_BUCKET_KEYS];
 	unsigned i;
 
+	/* Derive different keys from the first one */
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		full_keys[i] = keys[0];
+		full_keys[i].port_src += i;
+	}
+
 	handle = rte_hash_create(&params_pseudo_hash);
 	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
 
 	/* Fill bucket */
-	for (i = 0; i < 4; i++) {
-		pos[i] = rte_hash_add_key(handle, &keys[i]);
-		print_key_info("Add", &keys[i], pos[i]);
+	for (i = 0; i < BUCKET_ENTRIES; i++) {
+		pos[i] = rte_hash_add_key(handle, &full_keys[i]);
+		print_key_info("Add", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] < 0,
 			"failed to add key (pos[%u]=%d)", i, pos[i]);
 		expected_pos[i] = pos[i];
@@ -580,65 +592,67 @@ static int test_full_bucket(void)
 	 * This should work and will push one of the items
 	 * in the bucket because it is full
 	 */
-	pos[4] = rte_hash_add_key(handle, &keys[4]);
-	print_key_info("Add", &keys[4], pos[4]);
-	RETURN_IF_ERROR(pos[4] < 0,
-			"failed to add key (pos[4]=%d)", pos[4]);
-	expected_pos[4] = pos[4];
+	pos[BUCKET_ENTRIES] = rte_hash_add_key(handle,
+				&full_keys[BUCKET_ENTRIES]);
+	print_key_info("Add", &full_keys[BUCKET_ENTRIES], pos[BUCKET_ENTRIES]);
+	RETURN_IF_ERROR(pos[BUCKET_ENTRIES] < 0,
+			"failed to add key (pos[%u]=%d)", BUCKET_ENTRIES,
+			pos[BUCKET_ENTRIES]);
+	expected_pos[BUCKET_ENTRIES] = pos[BUCKET_ENTRIES];
 
 	/* Lookup */
-	for (i = 0; i < 5; i++) {
-		pos[i] = rte_hash_lookup(handle, &keys[i]);
-		print_key_info("Lkp", &keys[i], pos[i]);
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		pos[i] = rte_hash_lookup(handle, &full_keys[i]);
+		print_key_info("Lkp", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] != expected_pos[i],
 			"failed to find key (pos[%u]=%d)", i, pos[i]);
 	}
 
 	/* Add - update */
-	for (i = 0; i < 5; i++) {
-		pos[i] = rte_hash_add_key(handle, &keys[i]);
-		print_key_info("Add", &keys[i], pos[i]);
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		pos[i] = rte_hash_add_key(handle, &full_keys[i]);
+		print_key_info("Add", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] != expected_pos[i],
 			"failed to add key (pos[%u]=%d)", i, pos[i]);
 	}
 
 	/* Lookup */
-	for (i = 0; i < 5; i++) {
-		pos[i] = rte_hash_lookup(handle, &keys[i]);
-		print_key_info("Lkp", &keys[i], pos[i]);
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		pos[i] = rte_hash_lookup(handle, &full_keys[i]);
+		print_key_info("Lkp", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] != expected_pos[i],
 			"failed to find key (pos[%u]=%d)", i, pos[i]);
 	}
 
 	/* Delete 1 key, check other keys are still found */
-	pos[1] = rte_hash_del_key(handle, &keys[1]);
-	print_key_info("Del", &keys[1], pos[1]);
+	pos[1] = rte_hash_del_key(handle, &full_keys[1]);
+	print_key_info("Del", &full_keys[1], pos[1]);
 	RETURN_IF_ERROR(pos[1] != expected_pos[1],
 			"failed to delete key (pos[1]=%d)", pos[1]);
-	pos[3] = rte_hash_lookup(handle, &keys[3]);
-	print_key_info("Lkp", &keys[3], pos[3]);
+	pos[3] = rte_hash_lookup(handle, &full_keys[3]);
+	print_key_info("Lkp", &full_keys[3], pos[3]);
 	RETURN_IF_ERROR(pos[3] != expected_pos[3],
 			"failed lookup after deleting key from same bucket "
 			"(pos[3]=%d)", pos[3]);
 
 	/* Go back to previous state */
-	pos[1] = rte_hash_add_key(handle, &keys[1]);
-	print_key_info("Add", &keys[1], pos[1]);
+	pos[1] = rte_hash_add_key(handle, &full_keys[1]);
+	print_key_info("Add", &full_keys[1], pos[1]);
 	expected_pos[1] = pos[1];
 	RETURN_IF_ERROR(pos[1] < 0, "failed to add key (pos[1]=%d)", pos[1]);
 
 	/* Delete */
-	for (i = 0; i < 5; i++) {
-		pos[i] = rte_hash_del_key(handle, &keys[i]);
-		print_key_info("Del", &keys[i], pos[i]);
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		pos[i] = rte_hash_del_key(handle, &full_keys[i]);
+		print_key_info("Del", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] != expected_pos[i],
 			"failed to delete key (pos[%u]=%d)", i, pos[i]);
 	}
 
 	/* Lookup */
-	for (i = 0; i < 5; i++) {
-		pos[i] = rte_hash_lookup(handle, &keys[i]);
-		print_key_info("Lkp", &keys[i], pos[i]);
+	for (i = 0; i < FULL_BUCKET_KEYS; i++) {
+		pos[i] = rte_hash_lookup(handle, &full_keys[i]);
+		print_key_info("Lkp", &full_keys[i], pos[i]);
 		RETURN_IF_ERROR(pos[i] != -ENOENT,
 			"fail: found non-existent key (pos[%u]=%d)", i, pos[i]);
 	}
@@ -978,7 +992,6 @@ static int test_fbk_hash_find_existing(void)
 	return 0;
 }
 
-#define BUCKET_ENTRIES 4
 /*
  * Do tests for hash creation with bad parameters.
  */
@@ -1133,6 +1146,10 @@ static int test_average_table_utilization(void)
 	printf("\nAverage table utilization = %.2f%% (%u/%u)\n",
 		((double) average_keys_added / ut_params.entries * 100),
 		average_keys_added, ut_params.entries);
+
+	/* 8-entry buckets should keep the table at least 95% utilized */
+	RETURN_IF_ERROR(average_keys_added < ut_params.entries / 100 * 95,
+			"table utilization below 95%%");
 	rte_hash_free(handle);
 
 	return 0;
@@ -0,0 +1,674 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <netinet/in.h>
+
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_cycles.h>
+#include <rte_ip_frag.h>
+#ifdef RTE_LIBRTE_PORT
+#include <rte_port_frag.h>
+#endif
+
+#include "test.h"
+
+#define NUM_MBUFS 256
+#define FRAG_TEST_BUCKETS 64
+#define FRAG_TEST_BUCKET_ENTRIES 4
+#define FRAG_TEST_MAX_ENTRIES 128
+#define FRAG_TEST_FRAG_LEN 64
+#define FRAG_TEST_NB_FRAGS 3
+#define FRAG_TEST_PKT_LEN (FRAG_TEST_NB_FRAGS * FRAG_TEST_FRAG_LEN)
+/* large enough to be split in several internal passes */
+#define FRAG_TEST_NB_DGRAMS 40
+/* fragmentation: 4 fragments for the single segment packet */
+#define FRAG_TEST_MTU_PAYLOAD 256
+#define FRAG_TEST_JUMBO_LEN 1000
+#define FRAG_TEST_JUMBO_FRAGS 4
+/* and 3 fragments of 4 segments for the two segment one */
+#define FRAG_TEST_SEG0_LEN 300
+#define FRAG_TEST_SEG1_LEN 400
+#define FRAG_TEST_CHAIN_FRAGS 3
+#define FRAG_TEST_SMALL_LEN 100
+#define FRAG_TEST_OUT 8
+
+#define IPV4_HDR_LEN sizeof(struct ipv4_hdr)
+#define IPV6_HDR_LEN \
+	(sizeof(struct ipv6_hdr) + sizeof(struct ipv6_extension_fragment))
+
+static struct rte_mempool *frag_pool;
+static struct rte_mempool *frag_indirect_pool;
+static struct rte_ip_frag_tbl *frag_tbl;
+static struct rte_ip_frag_death_row death_row;
+
+static uint8_t
+payload_byte(uint16_t id, uint32_t ofs)
+{
+	return (uint8_t)(id + ofs);
+}
+
+static struct rte_mbuf *
+build_pkt(uint16_t hdr_len, uint32_t ofs, uint16_t len, uint16_t id)
+{
+	struct rte_mbuf *m;
+	char *data;
+	uint16_t i;
+
+	m = rte_pktmbuf_alloc(frag_pool);
+	if (m == NULL)
+		return NULL;
+
+	data = rte_pktmbuf_append(m, ETHER_HDR_LEN + hdr_len + len);
+	if (data == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+
+	memset(data, 0, ETHER_HDR_LEN + hdr_len);
+	for (i = 0; i != len; i++)
+		data[ETHER_HDR_LEN + hdr_len + i] = payload_byte(id, ofs + i);
+
+	m->l2_len = ETHER_HDR_LEN;
+	m->l3_len = hdr_len;
+	return m;
+}
+
+static struct rte_mbuf *
+build_ipv4_frag(uint16_t id, uint32_t ofs, uint16_t len, int mf)
+{
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+
+	m = build_pkt(IPV4_HDR_LEN, ofs, len, id);
+	if (m == NULL)
+		return NULL;
+
+	ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, ETHER_HDR_LEN);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(IPV4_HDR_LEN + len);
+	ip->packet_id = rte_cpu_to_be_16(id);
+	ip->fragment_offset = rte_cpu_to_be_16(
+		(ofs / IPV4_HDR_OFFSET_UNITS) | (mf ? IPV4_HDR_MF_FLAG : 0));
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 2));
+	return m;
+}
+
+/* build a non-fragmented IPv4 packet without L2 header */
+static struct rte_mbuf *
+build_ipv4_pkt(uint16_t id, uint16_t len, int df)
+{
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+
+	m = build_ipv4_frag(id, 0, len, 0);
+	if (m == NULL)
+		return NULL;
+
+	rte_pktmbuf_adj(m, ETHER_HDR_LEN);
+	m->l2_len = 0;
+	ip = rte_pktmbuf_mtod(m, struct ipv4_hdr *);
+	if (df)
+		ip->fragment_offset = rte_cpu_to_be_16(IPV4_HDR_DF_FLAG);
+	return m;
+}
+
+static struct rte_mbuf *
+build_ipv6_frag(uint16_t id, uint32_t ofs, uint16_t len, int mf)
+{
+	struct rte_mbuf *m;
+	struct ipv6_hdr *ip;
+	struct ipv6_extension_fragment *fh;
+
+	m = build_pkt(IPV6_HDR_LEN, ofs, len, id);
+	if (m == NULL)
+		return NULL;
+
+	ip = rte_pktmbuf_mtod_offset(m, struct ipv6_hdr *, ETHER_HDR_LEN);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(sizeof(*fh) + len);
+	ip->proto = IPPROTO_FRAGMENT;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0x20;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0x20;
+	ip->dst_addr[15] = 2;
+
+	fh = (struct ipv6_extension_fragment *)(ip + 1);
+	fh->next_header = IPPROTO_UDP;
+	fh->frag_data = rte_cpu_to_be_16(RTE_IPV6_SET_FRAG_DATA(ofs, !!mf));
+	fh->id = rte_cpu_to_be_32(id);
+	return m;
+}
+
+/* build a non-fragmented IPv6 packet without L2 header */
+static struct rte_mbuf *
+build_ipv6_pkt(uint16_t id, uint16_t len)
+{
+	struct rte_mbuf *m;
+	struct ipv6_hdr *ip;
+
+	m = build_pkt(sizeof(*ip), 0, len, id);
+	if (m == NULL)
+		return NULL;
+
+	rte_pktmbuf_adj(m, ETHER_HDR_LEN);
+	m->l2_len = 0;
+	ip = rte_pktmbuf_mtod(m, struct ipv6_hdr *);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(len);
+	ip->proto = IPPROTO_UDP;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0x20;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0x20;
+	ip->dst_addr[15] = 2;
+	return m;
+}
+
+/* build an IPv4 packet with the payload split into two segments */
+static struct rte_mbuf *
+build_ipv4_chain(uint16_t id)
+{
+	struct rte_mbuf *m, *seg;
+	struct ipv4_hdr *ip;
+	char *data;
+	uint16_t i;
+
+	m = build_ipv4_pkt(id, FRAG_TEST_SEG0_LEN, 0);
+	seg = rte_pktmbuf_alloc(frag_pool);
+	if (m == NULL || seg == NULL)
+		goto fail;
+
+	data = rte_pktmbuf_append(seg, FRAG_TEST_SEG1_LEN);
+	if (data == NULL)
+		goto fail;
+	for (i = 0; i != FRAG_TEST_SEG1_LEN; i++)
+		data[i] = payload_byte(id, FRAG_TEST_SEG0_LEN + i);
+
+	ip = rte_pktmbuf_mtod(m, struct ipv4_hdr *);
+	ip->total_length = rte_cpu_to_be_16(IPV4_HDR_LEN +
+		FRAG_TEST_SEG0_LEN + FRAG_TEST_SEG1_LEN);
+	rte_pktmbuf_chain(m, seg);
+	return m;
+
+fail:
+	rte_pktmbuf_free(m);
+	rte_pktmbuf_free(seg);
+	return NULL;
+}
+
+/* check headers and payload of a reassembled datagram */
+static int
+check_dgram(struct rte_mbuf *m, int ipv6, uint16_t id, uint32_t len)
+{
+	struct ipv4_hdr *ip4;
+	struct ipv6_hdr *ip6;
+	uint32_t i, hdr_len;
+	uint8_t buf;
+	const uint8_t *p;
+
+	hdr_len = ipv6 ? sizeof(*ip6) : IPV4_HDR_LEN;
+	TEST_ASSERT_EQUAL(m->pkt_len, (m->l2_len + hdr_len + len),
+		"Wrong packet length %u", m->pkt_len);
+
+	if (ipv6) {
+		ip6 = rte_pktmbuf_mtod_offset(m, struct ipv6_hdr *,
+			m->l2_len);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len), len,
+			"Wrong IPv6 payload length");
+		TEST_ASSERT_EQUAL(ip6->proto, IPPROTO_UDP,
+			"Fragment header was not removed");
+	} else {
+		ip4 = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *,
+			m->l2_len);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip4->total_length),
+			(hdr_len + len), "Wrong IPv4 total length");
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip4->packet_id), id,
+			"Wrong IPv4 id");
+		TEST_ASSERT_EQUAL(rte_ipv4_frag_pkt_is_fragmented(ip4), 0,
+			"Reassembled packet is still a fragment");
+	}
+
+	for (i = 0; i != len; i++) {
+		p = rte_pktmbuf_read(m, m->l2_len + hdr_len + i, 1, &buf);
+		TEST_ASSERT_NOT_NULL(p, "Can't read payload byte %u", i);
+		TEST_ASSERT_EQUAL(*p, payload_byte(id, i),
+			"Wrong payload byte at offset %u", i);
+	}
+	return 0;
+}
+
+static void
+free_pkts(struct rte_mbuf **pkts, uint16_t nb)
+{
+	uint16_t i;
+
+	for (i = 0; i != nb; i++)
+		rte_pktmbuf_free(pkts[i]);
+	rte_ip_frag_free_death_row(&death_row, 0);
+}
+
+/* fragments of two interleaved datagrams, last fragments first */
+static int
+test_reassemble_burst(int ipv6)
+{
+	struct rte_mbuf *pkts[2 * FRAG_TEST_NB_FRAGS + 1];
+	struct rte_mbuf *(*build)(uint16_t, uint32_t, uint16_t, int);
+	uint16_t i, k, n, id;
+	uint32_t ofs;
+
+	build = ipv6 ? build_ipv6_frag : build_ipv4_frag;
+
+	n = 0;
+	for (i = FRAG_TEST_NB_FRAGS; i != 0; i--) {
+		ofs = (i - 1) * FRAG_TEST_FRAG_LEN;
+		for (id = 1; id != 3; id++) {
+			pkts[n] = build(id, ofs, FRAG_TEST_FRAG_LEN,
+				i != FRAG_TEST_NB_FRAGS);
+			TEST_ASSERT_NOT_NULL(pkts[n], "Can't build fragment");
+			n++;
+		}
+	}
+
+	/* non-fragmented packet in the middle of the burst */
+	pkts[n] = pkts[n - 1];
+	pkts[n - 1] = ipv6 ? build_pkt(sizeof(struct ipv6_hdr), 0, 10, 3) :
+		build_ipv4_frag(3, 0, 10, 0);
+	TEST_ASSERT_NOT_NULL(pkts[n - 1], "Can't build packet");
+	if (ipv6)
+		rte_pktmbuf_mtod_offset(pkts[n - 1], struct ipv6_hdr *,
+			ETHER_HDR_LEN)->proto = IPPROTO_UDP;
+	n++;
+
+	k = ipv6 ? rte_ipv6_frag_reassemble_burst(frag_tbl, &death_row,
+			pkts, n, rte_rdtsc()) :
+		rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row,
+			pkts, n, rte_rdtsc());
+
+	/* packets are returned in their order of completion */
+	TEST_ASSERT_EQUAL(k, 3, "Expected 3 packets, got %u", k);
+	TEST_ASSERT_SUCCESS(check_dgram(pkts[0], ipv6, 1, FRAG_TEST_PKT_LEN),
+		"Wrong first datagram");
+	TEST_ASSERT_EQUAL(pkts[1]->pkt_len, (ETHER_HDR_LEN + 10 +
+		(ipv6 ? sizeof(struct ipv6_hdr) : IPV4_HDR_LEN)),
+		"Non-fragmented packet was modified");
+	TEST_ASSERT_SUCCESS(check_dgram(pkts[2], ipv6, 2, FRAG_TEST_PKT_LEN),
+		"Wrong second datagram");
+	TEST_ASSERT_EQUAL(frag_tbl->use_entries, 0,
+		"Table entries were not released");
+
+	free_pkts(pkts, k);
+	return 0;
+}
+
+static int
+test_ipv4_reassemble_burst(void)
+{
+	return test_reassemble_burst(0);
+}
+
+static int
+test_ipv6_reassemble_burst(void)
+{
+	return test_reassemble_burst(1);
+}
+
+/* burst larger than one internal pass, mixed with the per packet API */
+static int
+test_ipv4_reassemble_burst_large(void)
+{
+	struct rte_mbuf *pkts[2 * FRAG_TEST_NB_DGRAMS];
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+	uint16_t i, k;
+
+	for (i = 0; i != FRAG_TEST_NB_DGRAMS; i++) {
+		pkts[i] = build_ipv4_frag(i, 0, FRAG_TEST_FRAG_LEN, 1);
+		pkts[i + FRAG_TEST_NB_DGRAMS] = build_ipv4_frag(i,
+			FRAG_TEST_FRAG_LEN, FRAG_TEST_FRAG_LEN, 0);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Can't build fragment");
+		TEST_ASSERT_NOT_NULL(pkts[i + FRAG_TEST_NB_DGRAMS],
+			"Can't build fragment");
+	}
+
+	/* first fragment of datagram 0 goes through the per packet API */
+	ip = rte_pktmbuf_mtod_offset(pkts[0], struct ipv4_hdr *,
+		ETHER_HDR_LEN);
+	m = rte_ipv4_frag_reassemble_packet(frag_tbl, &death_row, pkts[0],
+		rte_rdtsc(), ip);
+	TEST_ASSERT_NULL(m, "Incomplete datagram was returned");
+
+	k = rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row, pkts + 1,
+		RTE_DIM(pkts) - 1, rte_rdtsc());
+	TEST_ASSERT_EQUAL(k, FRAG_TEST_NB_DGRAMS, "Expected %u packets, got %u",
+		FRAG_TEST_NB_DGRAMS, k);
+
+	for (i = 0; i != k; i++)
+		TEST_ASSERT_SUCCESS(check_dgram(pkts[i + 1], 0, i,
+			2 * FRAG_TEST_FRAG_LEN), "Wrong datagram %u", i);
+
+	free_pkts(pkts + 1, k);
+	return 0;
+}
+
+static int
+test_max_frags(void)
+{
+	struct rte_mbuf *pkts[IP_MAX_FRAG_NUM];
+	uint16_t i, k, nb_frags;
+	int ret;
+
+	TEST_ASSERT_EQUAL(rte_ip_frag_table_max_frags_set(frag_tbl,
+		IP_MIN_FRAG_NUM - 1), -EINVAL, "Too small limit accepted");
+	TEST_ASSERT_EQUAL(rte_ip_frag_table_max_frags_set(frag_tbl,
+		IP_MAX_FRAG_NUM + 1), -EINVAL, "Too large limit accepted");
+
+	/*
+	 * datagram with one fragment more than allowed is dropped,
+	 * the intermediate fragment comes last to drop the whole entry.
+	 */
+	nb_frags = IP_MIN_FRAG_NUM + 1;
+	ret = rte_ip_frag_table_max_frags_set(frag_tbl, nb_frags - 1);
+	TEST_ASSERT_SUCCESS(ret, "Can't set fragment limit");
+
+	pkts[0] = build_ipv4_frag(7, 0, FRAG_TEST_FRAG_LEN, 1);
+	pkts[1] = build_ipv4_frag(7, 2 * FRAG_TEST_FRAG_LEN,
+		FRAG_TEST_FRAG_LEN, 0);
+	pkts[2] = build_ipv4_frag(7, FRAG_TEST_FRAG_LEN,
+		FRAG_TEST_FRAG_LEN, 1);
+	for (i = 0; i != nb_frags; i++)
+		TEST_ASSERT_NOT_NULL(pkts[i], "Can't build fragment");
+
+	k = rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row, pkts,
+		nb_frags, rte_rdtsc());
+	TEST_ASSERT_EQUAL(k, 0, "Datagram over the limit was reassembled");
+	TEST_ASSERT_EQUAL(death_row.cnt, nb_frags,
+		"Fragments were not put on the death row");
+	free_pkts(pkts, 0);
+
+	/* the same datagram passes with the default limit */
+	ret = rte_ip_frag_table_max_frags_set(frag_tbl, IP_MAX_FRAG_NUM);
+	TEST_ASSERT_SUCCESS(ret, "Can't set fragment limit");
+
+	for (i = 0; i != nb_frags; i++) {
+		pkts[i] = build_ipv4_frag(7, i * FRAG_TEST_FRAG_LEN,
+			FRAG_TEST_FRAG_LEN, i != nb_frags - 1);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Can't build fragment");
+	}
+
+	k = rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row, pkts,
+		nb_frags, rte_rdtsc());
+	TEST_ASSERT_EQUAL(k, 1, "Datagram was not reassembled");
+	TEST_ASSERT_SUCCESS(check_dgram(pkts[0], 0, 7,
+		nb_frags * FRAG_TEST_FRAG_LEN), "Wrong datagram");
+
+	free_pkts(pkts, k);
+	return 0;
+}
+
+static int
+test_ipv4_fragment_burst(void)
+{
+	struct rte_mbuf *in[4], *out[2 * FRAG_TEST_OUT];
+	uint16_t nb_frags[RTE_DIM(in)];
+	uint16_t i, k, n, nb_out, mtu;
+
+	mtu = IPV4_HDR_LEN + FRAG_TEST_MTU_PAYLOAD;
+
+	in[0] = build_ipv4_pkt(1, FRAG_TEST_JUMBO_LEN, 0);
+	in[1] = build_ipv4_pkt(2, FRAG_TEST_SMALL_LEN, 0);
+	in[2] = build_ipv4_chain(3);
+	in[3] = build_ipv4_pkt(4, FRAG_TEST_JUMBO_LEN, 1);
+	for (i = 0; i != RTE_DIM(in); i++)
+		TEST_ASSERT_NOT_NULL(in[i], "Can't build packet %u", i);
+
+	/* not enough room for all fragments of the first packet */
+	n = rte_ipv4_fragment_burst(in, RTE_DIM(in), out,
+		FRAG_TEST_JUMBO_FRAGS - 1, nb_frags, mtu, frag_pool,
+		frag_indirect_pool);
+	TEST_ASSERT_EQUAL(n, 0, "Packet fragmented into a too small array");
+
+	/* stops at the packet with DF flag set */
+	n = rte_ipv4_fragment_burst(in, RTE_DIM(in), out, RTE_DIM(out),
+		nb_frags, mtu, frag_pool, frag_indirect_pool);
+	TEST_ASSERT_EQUAL(n, 3, "Expected 3 consumed packets, got %u", n);
+	TEST_ASSERT_EQUAL(nb_frags[0], FRAG_TEST_JUMBO_FRAGS,
+		"Wrong number of fragments %u", nb_frags[0]);
+	TEST_ASSERT_EQUAL(nb_frags[1], 1, "Small packet was fragmented");
+	TEST_ASSERT_EQUAL(nb_frags[2], FRAG_TEST_CHAIN_FRAGS,
+		"Wrong number of fragments %u", nb_frags[2]);
+
+	nb_out = nb_frags[0] + nb_frags[1] + nb_frags[2];
+	TEST_ASSERT(out[FRAG_TEST_JUMBO_FRAGS] == in[1],
+		"Small packet was not passed through");
+	for (i = 0; i != nb_out; i++)
+		TEST_ASSERT(out[i]->pkt_len <= mtu,
+			"Fragment %u is larger than MTU", i);
+
+	rte_pktmbuf_free(in[0]);
+	rte_pktmbuf_free(in[2]);
+	rte_pktmbuf_free(in[3]);
+
+	/* fragments have to reassemble into the original packets */
+	k = rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row, out, nb_out,
+		rte_rdtsc());
+	TEST_ASSERT_EQUAL(k, 3, "Expected 3 packets, got %u", k);
+	TEST_ASSERT_SUCCESS(check_dgram(out[0], 0, 1, FRAG_TEST_JUMBO_LEN),
+		"Wrong first packet");
+	TEST_ASSERT(out[1] == in[1], "Small packet was modified");
+	TEST_ASSERT_SUCCESS(check_dgram(out[2], 0, 3,
+		FRAG_TEST_SEG0_LEN + FRAG_TEST_SEG1_LEN),
+		"Wrong segmented packet");
+
+	free_pkts(out, k);
+	return 0;
+}
+
+static int
+test_ipv6_fragment_burst(void)
+{
+	struct rte_mbuf *in[2], *out[FRAG_TEST_OUT];
+	uint16_t nb_frags[RTE_DIM(in)];
+	uint16_t i, k, n, nb_out, mtu;
+
+	mtu = IPV6_HDR_LEN + FRAG_TEST_MTU_PAYLOAD;
+
+	in[0] = build_ipv6_pkt(1, FRAG_TEST_JUMBO_LEN);
+	in[1] = build_ipv6_pkt(2, FRAG_TEST_SMALL_LEN);
+	for (i = 0; i != RTE_DIM(in); i++)
+		TEST_ASSERT_NOT_NULL(in[i], "Can't build packet %u", i);
+
+	n = rte_ipv6_fragment_burst(in, RTE_DIM(in), out, RTE_DIM(out),
+		nb_frags, mtu, frag_pool, frag_indirect_pool);
+	TEST_ASSERT_EQUAL(n, 2, "Expected 2 consumed packets, got %u", n);
+	TEST_ASSERT_EQUAL(nb_frags[0], FRAG_TEST_JUMBO_FRAGS,
+		"Wrong number of fragments %u", nb_frags[0]);
+	TEST_ASSERT_EQUAL(nb_frags[1], 1, "Small packet was fragmented");
+
+	nb_out = nb_frags[0] + nb_frags[1];
+	for (i = 0; i != nb_frags[0]; i++) {
+		TEST_ASSERT(out[i]->pkt_len <= mtu,
+			"Fragment %u is larger than MTU", i);
+		out[i]->l3_len = IPV6_HDR_LEN;
+	}
+	rte_pktmbuf_free(in[0]);
+
+	k = rte_ipv6_frag_reassemble_burst(frag_tbl, &death_row, out, nb_out,
+		rte_rdtsc());
+	TEST_ASSERT_EQUAL(k, 2, "Expected 2 packets, got %u", k);
+	TEST_ASSERT_SUCCESS(check_dgram(out[0], 1, 1, FRAG_TEST_JUMBO_LEN),
+		"Wrong fragmented packet");
+	TEST_ASSERT(out[1] == in[1], "Small packet was modified");
+
+	free_pkts(out, k);
+	return 0;
+}
+
+#ifdef RTE_LIBRTE_PORT
+static int
+test_port_ring_reader_ipv4_frag(void)
+{
+	struct rte_port_ring_reader_ipv4_frag_params params;
+	struct rte_mbuf *in[3], *out[FRAG_TEST_OUT];
+	struct rte_ring *ring;
+	void *port;
+	uint16_t i, n;
+
+	ring = rte_ring_lookup("IP_FRAG_RING");
+	if (ring == NULL)
+		ring = rte_ring_create("IP_FRAG_RING", 64, rte_socket_id(),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(ring, "Can't create ring");
+
+	memset(&params, 0, sizeof(params));
+	params.ring = ring;
+	params.mtu = IPV4_HDR_LEN + FRAG_TEST_MTU_PAYLOAD;
+	params.pool_direct = frag_pool;
+	params.pool_indirect = frag_indirect_pool;
+	port = rte_port_ring_reader_ipv4_frag_ops.f_create(&params,
+		rte_socket_id());
+	TEST_ASSERT_NOT_NULL(port, "Can't create port");
+
+	in[0] = build_ipv4_pkt(1, FRAG_TEST_SMALL_LEN, 0);
+	in[1] = build_ipv4_pkt(2, FRAG_TEST_JUMBO_LEN, 1);
+	in[2] = build_ipv4_pkt(3, FRAG_TEST_JUMBO_LEN, 0);
+	for (i = 0; i != RTE_DIM(in); i++)
+		TEST_ASSERT_NOT_NULL(in[i], "Can't build packet %u", i);
+	TEST_ASSERT_SUCCESS(rte_ring_sp_enqueue_bulk(ring, (void **)in,
+		RTE_DIM(in)), "Can't enqueue packets");
+
+	/* the DF packet is dropped, read the rest in two calls */
+	n = rte_port_ring_reader_ipv4_frag_ops.f_rx(port, out, 2);
+	TEST_ASSERT_EQUAL(n, 2, "Expected 2 packets, got %u", n);
+	n += rte_port_ring_reader_ipv4_frag_ops.f_rx(port, out + 2,
+		RTE_DIM(out) - 2);
+	TEST_ASSERT_EQUAL(n, 1 + FRAG_TEST_JUMBO_FRAGS,
+		"Expected %u packets, got %u", 1 + FRAG_TEST_JUMBO_FRAGS, n);
+	TEST_ASSERT(out[0] == in[0], "Small packet was not passed through");
+
+	n = rte_ipv4_frag_reassemble_burst(frag_tbl, &death_row, out, n,
+		rte_rdtsc());
+	TEST_ASSERT_EQUAL(n, 2, "Expected 2 packets, got %u", n);
+	TEST_ASSERT_SUCCESS(check_dgram(out[1], 0, 3, FRAG_TEST_JUMBO_LEN),
+		"Wrong fragmented packet");
+
+	free_pkts(out, n);
+	rte_port_ring_reader_ipv4_frag_ops.f_free(port);
+	return 0;
+}
+#endif
+
+static int
+test_ip_frag_no_leak(void)
+{
+	rte_ip_frag_free_death_row(&death_row, 0);
+	TEST_ASSERT_EQUAL(rte_mempool_count(frag_pool), NUM_MBUFS,
+		"Mbufs were leaked");
+	TEST_ASSERT_EQUAL(rte_mempool_count(frag_indirect_pool), NUM_MBUFS,
+		"Indirect mbufs were leaked");
+	return 0;
+}
+
+static int
+test_setup(void)
+{
+	uint64_t max_cycles;
+
+	if (frag_pool == NULL) {
+		frag_pool = rte_pktmbuf_pool_create("IP_FRAG_MBUF_POOL",
+			NUM_MBUFS, 0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+		if (frag_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	if (frag_indirect_pool == NULL) {
+		frag_indirect_pool = rte_pktmbuf_pool_create(
+			"IP_FRAG_INDIRECT_POOL", NUM_MBUFS, 0, 0, 0,
+			rte_socket_id());
+		if (frag_indirect_pool == NULL) {
+			printf("%s: Error creating indirect mempool\n",
+				__func__);
+			return -1;
+		}
+	}
+	if (frag_tbl == NULL) {
+		max_cycles = rte_get_tsc_hz() * 10;
+		frag_tbl = rte_ip_frag_table_create(FRAG_TEST_BUCKETS,
+			FRAG_TEST_BUCKET_ENTRIES, FRAG_TEST_MAX_ENTRIES,
+			max_cycles, rte_socket_id());
+		if (frag_tbl == NULL) {
+			printf("%s: Error creating fragment table\n", __func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static struct unit_test_suite ip_frag_test_suite  = {
+	.setup = test_setup,
+	.suite_name = "IP Fragmentation Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_ipv4_reassemble_burst),
+		TEST_CASE(test_ipv6_reassemble_burst),
+		TEST_CASE(test_ipv4_reassemble_burst_large),
+		TEST_CASE(test_max_frags),
+		TEST_CASE(test_ipv4_fragment_burst),
+		TEST_CASE(test_ipv6_fragment_burst),
+#ifdef RTE_LIBRTE_PORT
+		TEST_CASE(test_port_ring_reader_ipv4_frag),
+#endif
+		TEST_CASE(test_ip_frag_no_leak),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_ip_frag(void)
+{
+	return unit_test_suite_runner(&ip_frag_test_suite);
+}
+
+static struct test_command ip_frag_cmd = {
+	.command = "ip_frag_autotest",
+	.callback = test_ip_frag,
+};
+REGISTER_TEST_COMMAND(ip_frag_cmd);
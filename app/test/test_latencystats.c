@@ -0,0 +1,299 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_eth_ring.h>
+#include <rte_mbuf.h>
+#include <rte_ring.h>
+#include <rte_latencystats.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 255
+#define BURST 16
+#define RING_SIZE 64
+
+static struct rte_mempool *latency_pool;
+static struct rte_ring *latency_ring;
+static int latency_port = -1;
+
+/* receive a burst from the ring port and send it back after a delay */
+static int
+latency_loop(unsigned delay_us)
+{
+	struct rte_mbuf *pkts[BURST];
+	uint16_t nb;
+
+	nb = rte_eth_rx_burst(latency_port, 0, pkts, BURST);
+	if (nb != BURST)
+		return -1;
+	rte_delay_us(delay_us);
+	if (rte_eth_tx_burst(latency_port, 0, pkts, nb) != nb)
+		return -1;
+	return 0;
+}
+
+static int
+test_setup(void)
+{
+	struct rte_eth_conf null_conf;
+	struct rte_mbuf *pkts[BURST];
+	unsigned i;
+
+	if (latency_pool == NULL) {
+		latency_pool = rte_pktmbuf_pool_create("LATENCY_MBUF_POOL",
+			NUM_MBUFS, 0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+		if (latency_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	if (latency_ring == NULL) {
+		latency_ring = rte_ring_create("LATENCY_RING", RING_SIZE,
+			rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (latency_ring == NULL) {
+			printf("%s: Error creating ring\n", __func__);
+			return -1;
+		}
+	}
+	if (latency_port < 0) {
+		latency_port = rte_eth_from_rings("net_latency", &latency_ring,
+			1, &latency_ring, 1, rte_socket_id());
+		if (latency_port < 0) {
+			printf("%s: Error creating ring port\n", __func__);
+			return -1;
+		}
+		memset(&null_conf, 0, sizeof(null_conf));
+		if (rte_eth_dev_configure(latency_port, 1, 1, &null_conf) < 0 ||
+				rte_eth_tx_queue_setup(latency_port, 0,
+					RING_SIZE, rte_socket_id(), NULL) < 0 ||
+				rte_eth_rx_queue_setup(latency_port, 0,
+					RING_SIZE, rte_socket_id(), NULL,
+					latency_pool) < 0 ||
+				rte_eth_dev_start(latency_port) < 0) {
+			printf("%s: Error setting up ring port\n", __func__);
+			return -1;
+		}
+
+		/* fill the ring before the measurement is enabled */
+		for (i = 0; i < BURST; i++) {
+			pkts[i] = rte_pktmbuf_alloc(latency_pool);
+			if (pkts[i] == NULL)
+				return -1;
+		}
+		if (rte_eth_tx_burst(latency_port, 0, pkts, BURST) != BURST)
+			return -1;
+	}
+	return 0;
+}
+
+static int
+test_latencystats_bucket(void)
+{
+	uint64_t v;
+	uint32_t b;
+
+	for (b = 0; b < RTE_LATENCYSTATS_HIST_SIZE; b++)
+		TEST_ASSERT_EQUAL(rte_latencystats_bucket(
+				rte_latencystats_bucket_min(b)), b,
+			"Wrong bucket %u", b);
+	for (v = 1; v < (1ULL << 32); v = v * 3 + 1) {
+		b = rte_latencystats_bucket(v);
+		TEST_ASSERT(rte_latencystats_bucket_min(b) <= v &&
+			rte_latencystats_bucket_min(b + 1) > v,
+			"Value %" PRIu64 " out of bucket %u", v, b);
+	}
+	TEST_ASSERT_EQUAL(rte_latencystats_bucket(UINT64_MAX),
+		RTE_LATENCYSTATS_HIST_SIZE - 1, "Wrong last bucket");
+	return TEST_SUCCESS;
+}
+
+static int
+test_latencystats_percentile(void)
+{
+	struct rte_latencystats stats;
+
+	memset(&stats, 0, sizeof(stats));
+	TEST_ASSERT_EQUAL(rte_latencystats_percentile(&stats, 50), 0,
+		"Percentile without samples");
+
+	/* 90 packets of 1000 cycles and 10 of 100000, at 1 GHz */
+	stats.tsc_hz = 1000000000;
+	stats.samples = 100;
+	stats.max_ns = 100000;
+	stats.hist[rte_latencystats_bucket(1000)] = 90;
+	stats.hist[rte_latencystats_bucket(100000)] = 10;
+
+	TEST_ASSERT(rte_latencystats_percentile(&stats, 50) >= 1000 &&
+		rte_latencystats_percentile(&stats, 50) < 1250,
+		"Wrong median");
+	TEST_ASSERT(rte_latencystats_percentile(&stats, 89.9) < 1250,
+		"Wrong 89.9th percentile");
+	TEST_ASSERT(rte_latencystats_percentile(&stats, 95) >= 100000 * 3 / 4,
+		"Wrong 95th percentile");
+	TEST_ASSERT_EQUAL(rte_latencystats_percentile(&stats, 100), 100000,
+		"Wrong 100th percentile");
+	return TEST_SUCCESS;
+}
+
+static int
+test_latencystats_measure(void)
+{
+	struct rte_latencystats stats;
+	struct rte_mbuf *pkts[BURST], *fill[RING_SIZE];
+	uint64_t p50;
+	unsigned i;
+
+	TEST_ASSERT_EQUAL(rte_latencystats_get(latency_port, 0, &stats),
+		-ENOENT, "Statistics of a port not measured");
+	TEST_ASSERT_EQUAL(rte_latencystats_disable(latency_port), -ENOENT,
+		"Disabled a port not measured");
+
+	/* the packets received before enabling have no timestamp */
+	TEST_ASSERT_EQUAL(rte_eth_rx_burst(latency_port, 0, pkts, BURST),
+		BURST, "Cannot receive packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_enable(latency_port),
+		"Cannot enable the measurement");
+	TEST_ASSERT_EQUAL(rte_latencystats_enable(latency_port), -EEXIST,
+		"Enabled the measurement twice");
+	TEST_ASSERT_EQUAL(rte_latencystats_queue_count(latency_port), 1,
+		"Wrong number of queues");
+	TEST_ASSERT_EQUAL(rte_latencystats_get(latency_port, 1, &stats),
+		-EINVAL, "Statistics of an invalid queue");
+
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(latency_port, 0, pkts, BURST),
+		BURST, "Cannot send packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT(stats.samples == 0 && stats.unstamped == BURST,
+		"Unstamped packets measured");
+
+	TEST_ASSERT_SUCCESS(latency_loop(100), "Cannot loop packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT_EQUAL(stats.samples, BURST, "Wrong number of samples");
+	TEST_ASSERT(stats.min_ns >= 100000 && stats.min_ns <= stats.avg_ns &&
+		stats.avg_ns <= stats.max_ns && stats.max_ns < 1000000000,
+		"Wrong latency: min %" PRIu64 " avg %" PRIu64 " max %" PRIu64,
+		stats.min_ns, stats.avg_ns, stats.max_ns);
+	TEST_ASSERT_EQUAL(stats.jitter_ns, 0, "Jitter within a burst");
+	p50 = rte_latencystats_percentile(&stats, 50);
+	TEST_ASSERT(p50 >= stats.min_ns && p50 <= stats.max_ns,
+		"Median out of range");
+
+	/* a longer delay makes the latency vary between the bursts */
+	TEST_ASSERT_SUCCESS(latency_loop(1000), "Cannot loop packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT_EQUAL(stats.samples, 2 * BURST, "Wrong number of samples");
+	TEST_ASSERT(stats.max_ns >= 1000000, "Wrong highest latency");
+	TEST_ASSERT(stats.jitter_ns > 0 && stats.jitter_ns < stats.max_ns,
+		"Wrong jitter %" PRIu64, stats.jitter_ns);
+	rte_latencystats_dump(stdout, latency_port);
+
+	/* the reset is applied by the next TX burst */
+	TEST_ASSERT_SUCCESS(rte_latencystats_reset(latency_port, 0),
+		"Cannot reset statistics");
+	TEST_ASSERT_SUCCESS(latency_loop(0), "Cannot loop packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT(stats.samples == BURST && stats.unstamped == 0 &&
+		stats.max_ns < 1000000, "Statistics not reset");
+
+	/* the packets refused by the PMD are not measured again */
+	TEST_ASSERT_EQUAL(rte_eth_rx_burst(latency_port, 0, pkts, BURST),
+		BURST, "Cannot receive packets");
+	for (i = 0; i < RING_SIZE - 1 - BURST / 2; i++) {
+		fill[i] = rte_pktmbuf_alloc(latency_pool);
+		TEST_ASSERT_NOT_NULL(fill[i], "Cannot allocate packet");
+	}
+	TEST_ASSERT_SUCCESS(rte_ring_enqueue_bulk(latency_ring,
+		(void **)fill, i), "Cannot fill ring");
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(latency_port, 0, pkts, BURST),
+		BURST / 2, "Ring not full");
+	TEST_ASSERT_SUCCESS(rte_ring_dequeue_bulk(latency_ring,
+		(void **)fill, i), "Cannot drain ring");
+	rte_pktmbuf_free_bulk(fill, i);
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(latency_port, 0, &pkts[BURST / 2],
+		BURST / 2), BURST / 2, "Cannot send refused packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT(stats.samples == 2 * BURST && stats.unstamped == 0,
+		"Refused packets measured again");
+
+	TEST_ASSERT_SUCCESS(rte_latencystats_disable(latency_port),
+		"Cannot disable the measurement");
+	TEST_ASSERT_SUCCESS(latency_loop(0), "Cannot loop packets");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics after disable");
+	TEST_ASSERT_EQUAL(stats.samples, 2 * BURST, "Measured after disable");
+	TEST_ASSERT_SUCCESS(rte_latencystats_reset(latency_port, 0),
+		"Cannot reset statistics");
+	TEST_ASSERT_SUCCESS(rte_latencystats_get(latency_port, 0, &stats),
+		"Cannot read statistics");
+	TEST_ASSERT_EQUAL(stats.samples, 0, "Statistics not reset");
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite latencystats_testsuite = {
+	.suite_name = "Latency Statistics Unit Test Suite",
+	.setup = test_setup,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_latencystats_bucket),
+		TEST_CASE(test_latencystats_percentile),
+		TEST_CASE(test_latencystats_measure),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_latencystats(void)
+{
+	return unit_test_suite_runner(&latencystats_testsuite);
+}
+
+static struct test_command latencystats_cmd = {
+	.command = "latencystats_autotest",
+	.callback = test_latencystats,
+};
+REGISTER_TEST_COMMAND(latencystats_cmd);
@@ -78,6 +78,8 @@
 #define SLAVE_DEV_NAME_FMT      ("unit_test_mode4_slave_%d")
 #define SLAVE_RX_QUEUE_FMT      ("unit_test_mode4_slave_%d_rx")
 #define SLAVE_TX_QUEUE_FMT      ("unit_test_mode4_slave_%d_tx")
+#define SLAVE_SLOW_RX_QUEUE_FMT ("unit_test_mode4_slave_%d_srx")
+#define SLAVE_SLOW_TX_QUEUE_FMT ("unit_test_mode4_slave_%d_stx")
 
 #define INVALID_SOCKET_ID       (-1)
 #define INVALID_PORT_ID         (0xFF)
@@ -102,6 +104,10 @@ static const struct ether_addr slow_protocol_mac_addr = {
 struct slave_conf {
 	struct rte_ring *rx_queue;
 	struct rte_ring *tx_queue;
+	/* Extra queue pair used when slow packets are on dedicated queues */
+	struct rte_ring *slow_rx_queue;
+	struct rte_ring *slow_tx_queue;
+	const struct eth_dev_ops *dev_ops;
 	uint8_t port_id;
 	uint8_t bonded : 1;
 
@@ -118,6 +124,9 @@ struct link_bonding_unittest_params {
 	struct slave_conf slave_ports[SLAVE_COUNT];
 
 	struct rte_mempool *mbuf_pool;
+
+	/* LACP frames are exchanged on the slow queues of the slaves */
+	uint8_t dedicated_queues;
 };
 
 #define TEST_DEFAULT_SLAVE_COUNT     RTE_DIM(test_params.slave_ports)
@@ -207,6 +216,27 @@ slave_put_pkts(struct slave_conf *slave, struct rte_mbuf **buf, uint16_t size)
 	return rte_ring_enqueue_burst(slave->rx_queue, (void **)buf, size);
 }
 
+/*
+ * Returns packets from slaves TX queue dedicated to slow packets.
+ */
+static int
+slave_get_slow_pkts(struct slave_conf *slave, struct rte_mbuf **buf,
+		uint16_t size)
+{
+	return rte_ring_dequeue_burst(slave->slow_tx_queue, (void **)buf, size);
+}
+
+/*
+ * Injects given packets into slaves RX queue dedicated to slow packets, as
+ * an ethertype filter would do.
+ */
+static int
+slave_put_slow_pkts(struct slave_conf *slave, struct rte_mbuf **buf,
+		uint16_t size)
+{
+	return rte_ring_enqueue_burst(slave->slow_rx_queue, (void **)buf, size);
+}
+
 static uint16_t
 bond_rx(struct rte_mbuf **buf, uint16_t size)
 {
@@ -416,11 +446,39 @@ test_setup(void)
 				rte_strerror(rte_errno));
 		}
 
+		if (port->slow_rx_queue == NULL) {
+			retval = snprintf(name, RTE_DIM(name), SLAVE_SLOW_RX_QUEUE_FMT,
+					i);
+			TEST_ASSERT(retval <= (int)RTE_DIM(name) - 1, "Name too long");
+			port->slow_rx_queue = rte_ring_create(name, RX_RING_SIZE,
+					socket_id, 0);
+			TEST_ASSERT_NOT_NULL(port->slow_rx_queue,
+				"Failed to allocate slow rx ring '%s': %s", name,
+				rte_strerror(rte_errno));
+		}
+
+		if (port->slow_tx_queue == NULL) {
+			retval = snprintf(name, RTE_DIM(name), SLAVE_SLOW_TX_QUEUE_FMT,
+					i);
+			TEST_ASSERT(retval <= (int)RTE_DIM(name) - 1, "Name too long");
+			port->slow_tx_queue = rte_ring_create(name, TX_RING_SIZE,
+					socket_id, 0);
+			TEST_ASSERT_NOT_NULL(port->slow_tx_queue,
+				"Failed to allocate slow tx ring '%s': %s", name,
+				rte_strerror(rte_errno));
+		}
+
 		if (port->port_id == INVALID_PORT_ID) {
+			struct rte_ring *rx_queues[] = {
+				port->rx_queue, port->slow_rx_queue };
+			struct rte_ring *tx_queues[] = {
+				port->tx_queue, port->slow_tx_queue };
+
+			/* Second queue pair is only used by dedicated queues */
 			retval = snprintf(name, RTE_DIM(name), SLAVE_DEV_NAME_FMT, i);
 			TEST_ASSERT(retval < (int)RTE_DIM(name) - 1, "Name too long");
-			retval = rte_eth_from_rings(name, &port->rx_queue, 1,
-					&port->tx_queue, 1, socket_id);
+			retval = rte_eth_from_rings(name, rx_queues, RTE_DIM(rx_queues),
+					tx_queues, RTE_DIM(tx_queues), socket_id);
 			TEST_ASSERT(retval >= 0,
 				"Failed to create ring ethdev '%s'\n", name);
 
@@ -533,7 +591,10 @@ bond_handshake_reply(struct slave_conf *slave)
 	struct rte_mbuf *lacp_tx_buf[MAX_PKT_BURST];
 	uint16_t lacp_tx_buf_cnt = 0, i;
 
-	retval = slave_get_pkts(slave, rx_buf, RTE_DIM(rx_buf));
+	if (test_params.dedicated_queues)
+		retval = slave_get_slow_pkts(slave, rx_buf, RTE_DIM(rx_buf));
+	else
+		retval = slave_get_pkts(slave, rx_buf, RTE_DIM(rx_buf));
 	TEST_ASSERT(retval >= 0, "Getting slave %u packets failed.",
 			slave->port_id);
 
@@ -548,7 +609,10 @@ bond_handshake_reply(struct slave_conf *slave)
 	if (lacp_tx_buf_cnt == 0)
 		return 0;
 
-	retval = slave_put_pkts(slave, lacp_tx_buf, lacp_tx_buf_cnt);
+	if (test_params.dedicated_queues)
+		retval = slave_put_slow_pkts(slave, lacp_tx_buf, lacp_tx_buf_cnt);
+	else
+		retval = slave_put_pkts(slave, lacp_tx_buf, lacp_tx_buf_cnt);
 	if (retval <= lacp_tx_buf_cnt) {
 		/* retval might be negative */
 		for (i = RTE_MAX(0, retval); retval < lacp_tx_buf_cnt; retval++)
@@ -1265,6 +1329,196 @@ test_mode4_expired(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_mode4_dedicated_queues(void)
+{
+	int retval;
+
+	retval = initialize_bonded_device_with_slaves(TEST_DEFAULT_SLAVE_COUNT, 0);
+	TEST_ASSERT_SUCCESS(retval, "Failed to initialize bonded device");
+
+	/* Ring slaves can't steer slow packets with an ethertype filter */
+	retval = rte_eth_bond_8023ad_dedicated_queues_enable(
+			test_params.bonded_port_id);
+	TEST_ASSERT_EQUAL(retval, -ENOTSUP,
+		"Dedicated queues enabled on slaves without ethertype filter");
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_start(test_params.bonded_port_id),
+		"Failed to start bonded device");
+
+	/* Queues can't be reconfigured while the bonded device is started */
+	retval = rte_eth_bond_8023ad_dedicated_queues_enable(
+			test_params.bonded_port_id);
+	TEST_ASSERT_EQUAL(retval, -EINVAL,
+		"Dedicated queues enabled on started bonded device");
+
+	retval = rte_eth_bond_8023ad_dedicated_queues_disable(
+			test_params.bonded_port_id);
+	TEST_ASSERT_EQUAL(retval, -EINVAL,
+		"Dedicated queues disabled on started bonded device");
+
+	rte_eth_dev_stop(test_params.bonded_port_id);
+
+	TEST_ASSERT_SUCCESS(rte_eth_bond_8023ad_dedicated_queues_disable(
+			test_params.bonded_port_id),
+		"Failed to disable dedicated queues on stopped bonded device");
+
+	return remove_slaves_and_stop_bonded_device();
+}
+
+/*
+ * Ethertype filter of the ring slaves. Slow packets are steered by the test
+ * itself, which puts them on the slow RX ring of the slave.
+ */
+static int
+slave_filter_ctrl(struct rte_eth_dev *dev __rte_unused,
+		enum rte_filter_type filter_type,
+		enum rte_filter_op filter_op __rte_unused, void *arg __rte_unused)
+{
+	return filter_type == RTE_ETH_FILTER_ETHERTYPE ? 0 : -ENOTSUP;
+}
+
+static struct eth_dev_ops slave_filter_dev_ops;
+
+static void
+slaves_filter_set(uint8_t enable)
+{
+	struct slave_conf *port;
+	struct rte_eth_dev *dev;
+	uint8_t i;
+
+	FOR_EACH_PORT(i, port) {
+		dev = &rte_eth_devices[port->port_id];
+		if (enable) {
+			port->dev_ops = dev->dev_ops;
+			slave_filter_dev_ops = *dev->dev_ops;
+			slave_filter_dev_ops.filter_ctrl = slave_filter_ctrl;
+			dev->dev_ops = &slave_filter_dev_ops;
+		} else if (port->dev_ops != NULL) {
+			dev->dev_ops = port->dev_ops;
+			port->dev_ops = NULL;
+		}
+	}
+}
+
+static int
+test_mode4_dedicated_queues_lacp(void)
+{
+	const uint8_t expected_state = STATE_COLLECTING | STATE_DISTRIBUTING;
+	struct rte_eth_bond_8023ad_slave_info info;
+	struct slave_conf *slave;
+	struct rte_mbuf *pkts[MAX_PKT_BURST];
+	uint16_t exp_pkts_cnt, pkts_cnt, j;
+	int retval;
+	uint8_t i;
+	void *pkt;
+
+	struct ether_addr src_mac = { { 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00 } };
+	struct ether_addr dst_mac = { { 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00 } };
+	struct ether_addr bonded_mac;
+
+	retval = initialize_bonded_device_with_slaves(TEST_DEFAULT_SLAVE_COUNT, 0);
+	TEST_ASSERT_SUCCESS(retval, "Failed to initialize bonded device");
+
+	TEST_ASSERT_SUCCESS(rte_eth_bond_8023ad_dedicated_queues_enable(
+			test_params.bonded_port_id),
+		"Failed to enable dedicated queues");
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_start(test_params.bonded_port_id),
+		"Failed to start bonded device");
+
+	/* LACP frames are only exchanged on the slow rings of the slaves */
+	retval = bond_handshake();
+	TEST_ASSERT_SUCCESS(retval, "Handshake on dedicated queues failed");
+
+	FOR_EACH_SLAVE(i, slave) {
+		retval = rte_eth_bond_8023ad_slave_info(test_params.bonded_port_id,
+				slave->port_id, &info);
+		TEST_ASSERT_SUCCESS(retval, "Failed to get slave %u info",
+			slave->port_id);
+
+		TEST_ASSERT_EQUAL(info.actor_state & expected_state,
+			expected_state,
+			"Slave %u is not collecting and distributing (state 0x%02x)",
+			slave->port_id, info.actor_state);
+	}
+
+	rte_eth_macaddr_get(test_params.bonded_port_id, &bonded_mac);
+
+	/* Data is distributed over every slave, with no slow packet inside */
+	for (pkts_cnt = 0; pkts_cnt < RTE_DIM(pkts); pkts_cnt++) {
+		dst_mac.addr_bytes[ETHER_ADDR_LEN - 1] = pkts_cnt;
+		retval = generate_packets(&bonded_mac, &dst_mac, 1, &pkts[pkts_cnt]);
+
+		if (retval != 1)
+			free_pkts(pkts, pkts_cnt);
+
+		TEST_ASSERT_EQUAL(retval, 1, "Failed to generate packet %u", pkts_cnt);
+	}
+	exp_pkts_cnt = pkts_cnt;
+
+	retval = bond_tx(pkts, pkts_cnt);
+	if (retval > 0 && retval < pkts_cnt)
+		free_pkts(&pkts[retval], pkts_cnt - retval);
+
+	TEST_ASSERT_EQUAL(retval, pkts_cnt, "TX on bonded device failed");
+
+	pkts_cnt = 0;
+	FOR_EACH_SLAVE(i, slave) {
+		uint16_t normal_cnt, slow_cnt;
+
+		retval = slave_get_pkts(slave, pkts, RTE_DIM(pkts));
+		normal_cnt = 0;
+		slow_cnt = 0;
+
+		for (j = 0; j < retval; j++) {
+			if (make_lacp_reply(slave, pkts[j]) == 1)
+				normal_cnt++;
+			else
+				slow_cnt++;
+		}
+
+		free_pkts(pkts, normal_cnt + slow_cnt);
+		TEST_ASSERT_EQUAL(slow_cnt, 0,
+			"slave %u transmitted %u SLOW packets on its data queue",
+			slave->port_id, slow_cnt);
+
+		TEST_ASSERT_NOT_EQUAL(normal_cnt, 0,
+			"slave %u did not transmitted any packets", slave->port_id);
+
+		pkts_cnt += normal_cnt;
+	}
+
+	TEST_ASSERT_EQUAL(exp_pkts_cnt, pkts_cnt,
+		"Expected %u packets but transmitted only %d", exp_pkts_cnt, pkts_cnt);
+
+	/* Data received by a collecting slave is passed up */
+	FOR_EACH_SLAVE(i, slave) {
+		retval = generate_and_put_packets(slave, &src_mac, &bonded_mac, 1);
+		TEST_ASSERT_SUCCESS(retval, "Failed to enqueue packets to slave %u",
+			slave->port_id);
+	}
+
+	retval = bond_rx(pkts, RTE_DIM(pkts));
+	if (retval > 0)
+		free_pkts(pkts, retval);
+
+	TEST_ASSERT_EQUAL(retval, (int)TEST_DEFAULT_SLAVE_COUNT,
+		"Expected %u packets but received %d",
+		(unsigned)TEST_DEFAULT_SLAVE_COUNT, retval);
+
+	retval = remove_slaves_and_stop_bonded_device();
+	TEST_ASSERT_SUCCESS(retval, "Test cleanup failed.");
+
+	/* Periodic LACP frames sent after the handshake */
+	FOR_EACH_PORT(i, slave) {
+		while (rte_ring_dequeue(slave->slow_tx_queue, &pkt) == 0)
+			rte_pktmbuf_free(pkt);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static int
 check_environment(void)
 {
@@ -1345,6 +1599,12 @@ test_mode4_executor(int (*test_func)(void))
 				if (rte_ring_dequeue(port->tx_queue, &pkt) == 0)
 					rte_pktmbuf_free(pkt);
 			}
+
+			while (rte_ring_dequeue(port->slow_rx_queue, &pkt) == 0)
+				rte_pktmbuf_free(pkt);
+
+			while (rte_ring_dequeue(port->slow_tx_queue, &pkt) == 0)
+				rte_pktmbuf_free(pkt);
 		}
 	}
 
@@ -1381,6 +1641,29 @@ test_mode4_expired_wrapper(void)
 	return test_mode4_executor(&test_mode4_expired);
 }
 
+static int
+test_mode4_dedicated_queues_wrapper(void)
+{
+	return test_mode4_executor(&test_mode4_dedicated_queues);
+}
+
+static int
+test_mode4_dedicated_queues_lacp_wrapper(void)
+{
+	int retval;
+
+	slaves_filter_set(1);
+	test_params.dedicated_queues = 1;
+
+	retval = test_mode4_executor(&test_mode4_dedicated_queues_lacp);
+
+	test_params.dedicated_queues = 0;
+	rte_eth_bond_8023ad_dedicated_queues_disable(test_params.bonded_port_id);
+	slaves_filter_set(0);
+
+	return retval;
+}
+
 static struct unit_test_suite link_bonding_mode4_test_suite  = {
 	.suite_name = "Link Bonding mode 4 Unit Test Suite",
 	.setup = test_setup,
@@ -1391,6 +1674,10 @@ static struct unit_test_suite link_bonding_mode4_test_suite  = {
 		TEST_CASE_NAMED("test_mode4_tx_burst", test_mode4_tx_burst_wrapper),
 		TEST_CASE_NAMED("test_mode4_marker", test_mode4_marker_wrapper),
 		TEST_CASE_NAMED("test_mode4_expired", test_mode4_expired_wrapper),
+		TEST_CASE_NAMED("test_mode4_dedicated_queues",
+				test_mode4_dedicated_queues_wrapper),
+		TEST_CASE_NAMED("test_mode4_dedicated_queues_lacp",
+				test_mode4_dedicated_queues_lacp_wrapper),
 
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
@@ -0,0 +1,260 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_launch.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+
+#include "test.h"
+
+/*
+ * Lcore mailbox
+ * =============
+ *
+ * - Post work items to a slave lcore in the WAIT state, and check they
+ *   are all called by this lcore.
+ *
+ * - Post work items to a slave lcore running a job that polls its
+ *   mailbox, one of them stopping the job.
+ *
+ * - Fill the mailbox of a slave lcore running a job that does not poll
+ *   it, check that posting fails, then that the items are called once
+ *   the job is finished.
+ *
+ * - Post a work item to the calling lcore and poll it.
+ *
+ * - Measure the time to launch an empty job and wait for it.
+ */
+
+#define MAILBOX_TIMEOUT_MS 1000
+#define LAUNCH_ITERATIONS 10000
+
+static rte_atomic32_t item_count;
+static volatile unsigned item_bad_lcore;
+static volatile unsigned job_stop;
+static volatile unsigned job_lcore;
+
+static int
+count_item(__attribute__((unused)) void *arg)
+{
+	if (rte_lcore_id() != job_lcore)
+		item_bad_lcore = 1;
+	rte_atomic32_inc(&item_count);
+	return 0;
+}
+
+static int
+stop_item(__attribute__((unused)) void *arg)
+{
+	job_stop = 1;
+	return 0;
+}
+
+/* job processing its mailbox until a work item stops it */
+static int
+polling_job(__attribute__((unused)) void *arg)
+{
+	unsigned n = 0;
+
+	while (!job_stop)
+		n += rte_eal_mailbox_poll();
+	return n;
+}
+
+/* job ignoring its mailbox until it is stopped */
+static int
+busy_job(__attribute__((unused)) void *arg)
+{
+	while (!job_stop)
+		rte_pause();
+	return 0;
+}
+
+static int
+empty_job(__attribute__((unused)) void *arg)
+{
+	return 0;
+}
+
+static int
+wait_item_count(int expected)
+{
+	uint64_t end = rte_get_timer_cycles() +
+		rte_get_timer_hz() * MAILBOX_TIMEOUT_MS / 1000;
+
+	while (rte_atomic32_read(&item_count) != expected) {
+		if (rte_get_timer_cycles() > end) {
+			printf("Got %d work items instead of %d\n",
+				rte_atomic32_read(&item_count), expected);
+			return -1;
+		}
+		rte_pause();
+	}
+	if (item_bad_lcore) {
+		printf("Work item called on the wrong lcore\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+test_mailbox_idle(unsigned lcore_id)
+{
+	unsigned i;
+
+	rte_atomic32_clear(&item_count);
+	for (i = 0; i < RTE_EAL_MAILBOX_SIZE; i++)
+		TEST_ASSERT_SUCCESS(rte_eal_mailbox_post(lcore_id, count_item,
+				NULL), "Cannot post work item %u", i);
+
+	return wait_item_count(RTE_EAL_MAILBOX_SIZE);
+}
+
+static int
+test_mailbox_polling(unsigned lcore_id)
+{
+	unsigned i;
+
+	rte_atomic32_clear(&item_count);
+	job_stop = 0;
+	TEST_ASSERT_SUCCESS(rte_eal_remote_launch(polling_job, NULL, lcore_id),
+		"Cannot launch polling job");
+
+	for (i = 0; i < RTE_EAL_MAILBOX_SIZE / 2; i++)
+		TEST_ASSERT_SUCCESS(rte_eal_mailbox_post(lcore_id, count_item,
+				NULL), "Cannot post work item %u", i);
+	TEST_ASSERT_SUCCESS(rte_eal_mailbox_post(lcore_id, stop_item, NULL),
+		"Cannot post stop work item");
+
+	TEST_ASSERT_EQUAL(rte_eal_wait_lcore(lcore_id),
+		RTE_EAL_MAILBOX_SIZE / 2 + 1,
+		"Polling job did not call all work items");
+	return wait_item_count(RTE_EAL_MAILBOX_SIZE / 2);
+}
+
+static int
+test_mailbox_full(unsigned lcore_id)
+{
+	unsigned i;
+
+	rte_atomic32_clear(&item_count);
+	job_stop = 0;
+	TEST_ASSERT_SUCCESS(rte_eal_remote_launch(busy_job, NULL, lcore_id),
+		"Cannot launch busy job");
+
+	for (i = 0; i < RTE_EAL_MAILBOX_SIZE; i++)
+		TEST_ASSERT_SUCCESS(rte_eal_mailbox_post(lcore_id, count_item,
+				NULL), "Cannot post work item %u", i);
+	TEST_ASSERT_EQUAL(rte_eal_mailbox_post(lcore_id, count_item, NULL),
+		-ENOBUFS, "Posting to a full mailbox did not fail");
+	TEST_ASSERT_EQUAL(rte_atomic32_read(&item_count), 0,
+		"Work item called while the job was running");
+
+	job_stop = 1;
+	rte_eal_wait_lcore(lcore_id);
+	return wait_item_count(RTE_EAL_MAILBOX_SIZE);
+}
+
+static int
+test_mailbox_self(void)
+{
+	rte_atomic32_clear(&item_count);
+	job_lcore = rte_lcore_id();
+	TEST_ASSERT_SUCCESS(rte_eal_mailbox_post(rte_lcore_id(), count_item,
+			NULL), "Cannot post work item to the calling lcore");
+	TEST_ASSERT_EQUAL(rte_eal_mailbox_poll(), 1,
+		"Work item not called by the calling lcore");
+	TEST_ASSERT_EQUAL(rte_eal_mailbox_poll(), 0,
+		"Work item called twice");
+	return wait_item_count(1);
+}
+
+static void
+test_launch_perf(unsigned lcore_id)
+{
+	uint64_t start;
+	unsigned i;
+
+	start = rte_get_timer_cycles();
+	for (i = 0; i < LAUNCH_ITERATIONS; i++) {
+		rte_eal_remote_launch(empty_job, NULL, lcore_id);
+		rte_eal_wait_lcore(lcore_id);
+	}
+	printf("launch and wait of an empty job: %"PRIu64" cycles\n",
+		(rte_get_timer_cycles() - start) / LAUNCH_ITERATIONS);
+}
+
+static int
+test_mailbox(void)
+{
+	unsigned lcore_id = rte_get_next_lcore(-1, 1, 0);
+
+	TEST_ASSERT_EQUAL(rte_eal_mailbox_post(RTE_MAX_LCORE, count_item,
+			NULL), -EINVAL, "Posting to an invalid lcore did not fail");
+	TEST_ASSERT_EQUAL(rte_eal_mailbox_post(rte_lcore_id(), NULL, NULL),
+		-EINVAL, "Posting a NULL function did not fail");
+
+	if (test_mailbox_self() < 0)
+		return -1;
+
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Slave lcore tests need at least 2 lcores, skipping\n");
+		return 0;
+	}
+	job_lcore = lcore_id;
+	item_bad_lcore = 0;
+
+	if (test_mailbox_idle(lcore_id) < 0)
+		return -1;
+	if (test_mailbox_polling(lcore_id) < 0)
+		return -1;
+	if (test_mailbox_full(lcore_id) < 0)
+		return -1;
+
+	test_launch_perf(lcore_id);
+	return 0;
+}
+
+static struct test_command mailbox_cmd = {
+	.command = "mailbox_autotest",
+	.callback = test_mailbox,
+};
+REGISTER_TEST_COMMAND(mailbox_cmd);
@@ -45,6 +45,7 @@
 #include <rte_per_lcore.h>
 #include <rte_launch.h>
 #include <rte_eal.h>
+#include <rte_eal_memconfig.h>
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
@@ -849,6 +850,94 @@ test_alloc_socket(void)
 	return 0;
 }
 
+static unsigned dynamic_mem_events[2];
+
+static int
+dynamic_mem_event_count(enum rte_mem_event event,
+		const struct rte_memseg *ms __rte_unused, void *arg)
+{
+	unsigned *events = arg;
+
+	events[event]++;
+	return 0;
+}
+
+/*
+ * With --dynamic-mem, allocate more than the free memory of the heap:
+ * hugepages must be mapped, then unmapped when the blocks are freed,
+ * except at most one segment kept unused by the heap.
+ * The blocks fit in a 2 MB hugepage, as the pages mapped at runtime are
+ * not necessarily physically contiguous.
+ */
+static int
+test_dynamic_mem(void)
+{
+	const struct rte_mem_config *mcfg =
+		rte_eal_get_configuration()->mem_config;
+	const size_t size = RTE_PGSIZE_2M / 2;
+	struct rte_malloc_socket_stats stats;
+	uint64_t physmem_size;
+	void **p;
+	unsigned i, nb_blocks;
+	int ret = -1;
+
+	if (!mcfg->dynamic_mem) {
+		printf("Memory is not dynamic, skipping\n");
+		return 0;
+	}
+
+	if (rte_mem_event_callback_register(dynamic_mem_event_count,
+			dynamic_mem_events) != 0) {
+		printf("Cannot register memory event callback\n");
+		return -1;
+	}
+	if (rte_mem_event_callback_register(dynamic_mem_event_count,
+			dynamic_mem_events) != -EEXIST) {
+		printf("Memory event callback registered twice\n");
+		goto end;
+	}
+
+	physmem_size = rte_eal_get_physmem_size();
+	rte_malloc_get_socket_stats(0, &stats);
+	nb_blocks = stats.heap_freesz_bytes / size + 4;
+	p = calloc(nb_blocks, sizeof(*p));
+	if (p == NULL)
+		goto end;
+
+	for (i = 0; i < nb_blocks; i++) {
+		p[i] = rte_malloc_socket("dynamic", size, 0, 0);
+		if (p[i] == NULL) {
+			printf("Cannot allocate block %u\n", i);
+			goto free;
+		}
+		memset(p[i], 0, size);
+	}
+	if (dynamic_mem_events[RTE_MEM_EVENT_ALLOC] == 0 ||
+			rte_eal_get_physmem_size() <= physmem_size) {
+		printf("No memory was mapped\n");
+		goto free;
+	}
+	ret = 0;
+free:
+	for (i = 0; i < nb_blocks; i++)
+		rte_free(p[i]);
+	free(p);
+	if (ret == 0 && dynamic_mem_events[RTE_MEM_EVENT_FREE] + 1 <
+			dynamic_mem_events[RTE_MEM_EVENT_ALLOC]) {
+		printf("Memory was not unmapped\n");
+		ret = -1;
+	}
+end:
+	rte_mem_event_callback_unregister(dynamic_mem_event_count,
+			dynamic_mem_events);
+	if (rte_mem_event_callback_unregister(dynamic_mem_event_count,
+			dynamic_mem_events) != -ENOENT) {
+		printf("Memory event callback unregistered twice\n");
+		ret = -1;
+	}
+	return ret;
+}
+
 static int
 test_malloc(void)
 {
@@ -956,6 +1045,14 @@ test_malloc(void)
 	else
 		printf("test_multi_alloc_statistics() passed\n");
 
+	ret = test_dynamic_mem();
+	if (ret < 0) {
+		printf("test_dynamic_mem() failed\n");
+		return ret;
+	}
+	else
+		printf("test_dynamic_mem() passed\n");
+
 	return 0;
 }
 
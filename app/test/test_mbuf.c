@@ -55,6 +55,7 @@
 #include <rte_branch_prediction.h>
 #include <rte_ring.h>
 #include <rte_mempool.h>
+#include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_random.h>
 #include <rte_cycles.h>
@@ -71,6 +72,9 @@
 
 /* size of private data for mbuf in pktmbuf_pool2 */
 #define MBUF2_PRIV_SIZE         128
+#define MBUF_SMALL_DATA_SIZE    (RTE_PKTMBUF_HEADROOM + 128)
+#define MBUF_COMPACT_BURST      40
+#define MBUF_EXT_BUF_SIZE       256
 
 #define REFCNT_MAX_ITER         64
 #define REFCNT_MAX_TIMEOUT      10
@@ -84,6 +88,7 @@
 
 static struct rte_mempool *pktmbuf_pool = NULL;
 static struct rte_mempool *pktmbuf_pool2 = NULL;
+static struct rte_mempool *pktmbuf_pool_small = NULL;
 
 #ifdef RTE_MBUF_REFCNT_ATOMIC
 
@@ -532,6 +537,362 @@ fail:
 		rte_pktmbuf_free(clone2);
 	return -1;
 }
+
+/*
+ * test reading and writing data spread over the segments of a chained mbuf
+ */
+static int
+test_pktmbuf_read_write(void)
+{
+	struct rte_mbuf *m = NULL, *seg;
+	uint8_t buf[3 * MBUF_TEST_DATA_LEN2];
+	const uint8_t *data;
+	char *seg_data;
+	unsigned i;
+
+	for (i = 0; i < 3; i++) {
+		seg = rte_pktmbuf_alloc(pktmbuf_pool);
+		if (seg == NULL)
+			GOTO_FAIL("Cannot allocate mbuf");
+		seg_data = rte_pktmbuf_append(seg, MBUF_TEST_DATA_LEN2);
+		if (seg_data == NULL) {
+			rte_pktmbuf_free(seg);
+			GOTO_FAIL("Cannot append data");
+		}
+		memset(seg_data, i, MBUF_TEST_DATA_LEN2);
+		if (m == NULL)
+			m = seg;
+		else if (rte_pktmbuf_chain(m, seg) != 0) {
+			rte_pktmbuf_free(seg);
+			GOTO_FAIL("Cannot chain mbuf");
+		}
+	}
+
+	/* data contained in the first segment is not copied */
+	data = rte_pktmbuf_read(m, 10, 20, buf);
+	if (data != rte_pktmbuf_mtod_offset(m, uint8_t *, 10))
+		GOTO_FAIL("Contiguous data was copied");
+
+	/* data contained in a following segment is not copied either */
+	data = rte_pktmbuf_read(m, MBUF_TEST_DATA_LEN2 + 10, 20, buf);
+	if (data != rte_pktmbuf_mtod_offset(m->next, uint8_t *, 10))
+		GOTO_FAIL("Contiguous data of second segment was copied");
+
+	/* data spread over the three segments is gathered in buf */
+	data = rte_pktmbuf_read(m, 10, 2 * MBUF_TEST_DATA_LEN2, buf);
+	if (data != buf)
+		GOTO_FAIL("Non contiguous data was not copied");
+	for (i = 0; i < 2 * MBUF_TEST_DATA_LEN2; i++) {
+		if (data[i] != (10 + i) / MBUF_TEST_DATA_LEN2)
+			GOTO_FAIL("Invalid data at offset %u", 10 + i);
+	}
+
+	/* out of bounds */
+	if (rte_pktmbuf_read(m, 1, 3 * MBUF_TEST_DATA_LEN2, buf) != NULL)
+		GOTO_FAIL("Read beyond packet length succeeded");
+	if (rte_pktmbuf_write(m, 1, 3 * MBUF_TEST_DATA_LEN2, buf) == 0)
+		GOTO_FAIL("Write beyond packet length succeeded");
+	if (rte_pktmbuf_read(m, UINT32_MAX, 2, buf) != NULL)
+		GOTO_FAIL("Read with wrapping offset succeeded");
+	if (rte_pktmbuf_write(m, UINT32_MAX, 2, buf) == 0)
+		GOTO_FAIL("Write with wrapping offset succeeded");
+
+	/* nothing to access at the end of the packet */
+	if (rte_pktmbuf_read(m, 3 * MBUF_TEST_DATA_LEN2, 0, buf) == NULL)
+		GOTO_FAIL("Empty read at end of packet failed");
+	if (rte_pktmbuf_write(m, 3 * MBUF_TEST_DATA_LEN2, 0, buf) != 0)
+		GOTO_FAIL("Empty write at end of packet failed");
+
+	/* scatter the buffer back over the segments */
+	memset(buf, 0xaa, sizeof(buf));
+	if (rte_pktmbuf_write(m, 10, 2 * MBUF_TEST_DATA_LEN2, buf) != 0)
+		GOTO_FAIL("Cannot write data");
+	data = rte_pktmbuf_read(m, 0, 3 * MBUF_TEST_DATA_LEN2, buf);
+	if (data != buf)
+		GOTO_FAIL("Non contiguous data was not copied");
+	for (i = 0; i < 3 * MBUF_TEST_DATA_LEN2; i++) {
+		uint8_t expected = (i < 10 || i >= 10 + 2 * MBUF_TEST_DATA_LEN2) ?
+				i / MBUF_TEST_DATA_LEN2 : 0xaa;
+
+		if (data[i] != expected)
+			GOTO_FAIL("Invalid data at offset %u after write", i);
+	}
+
+	rte_pktmbuf_free(m);
+	return 0;
+
+fail:
+	if (m)
+		rte_pktmbuf_free(m);
+	return -1;
+}
+
+static int
+test_pktmbuf_compact_burst(void)
+{
+	struct rte_mbuf *pkts[MBUF_COMPACT_BURST];
+	struct rte_mbuf *clone = NULL;
+	unsigned avail, small_avail, i, j, len, nb_small;
+	char *data;
+
+	memset(pkts, 0, sizeof(pkts));
+	avail = rte_mempool_count(pktmbuf_pool);
+	small_avail = rte_mempool_count(pktmbuf_pool_small);
+
+	/* one packet out of three is too large for the small pool */
+	nb_small = 0;
+	for (i = 0; i < MBUF_COMPACT_BURST; i++) {
+		pkts[i] = rte_pktmbuf_alloc(pktmbuf_pool);
+		if (pkts[i] == NULL)
+			GOTO_FAIL("Cannot allocate mbuf");
+		len = (i % 3 == 0) ? MBUF_TEST_DATA_LEN : MBUF_TEST_DATA_LEN2;
+		data = rte_pktmbuf_append(pkts[i], len);
+		if (data == NULL)
+			GOTO_FAIL("Cannot append data");
+		memset(data, i, len);
+		pkts[i]->port = i;
+		pkts[i]->ol_flags = PKT_RX_RSS_HASH;
+		pkts[i]->hash.rss = i * 1000;
+		if (i % 3 != 0)
+			nb_small++;
+	}
+
+	/* a shared mbuf is not copied */
+	clone = rte_pktmbuf_clone(pkts[1], pktmbuf_pool);
+	if (clone == NULL)
+		GOTO_FAIL("Cannot clone mbuf");
+	nb_small--;
+
+	if (rte_pktmbuf_compact_burst(pkts, MBUF_COMPACT_BURST,
+			pktmbuf_pool_small) != nb_small)
+		GOTO_FAIL("Invalid number of compacted packets");
+
+	for (i = 0; i < MBUF_COMPACT_BURST; i++) {
+		len = (i % 3 == 0) ? MBUF_TEST_DATA_LEN : MBUF_TEST_DATA_LEN2;
+		if ((i % 3 == 0 || i == 1) && pkts[i]->pool != pktmbuf_pool)
+			GOTO_FAIL("Packet %u was compacted", i);
+		if (i % 3 != 0 && i != 1 && pkts[i]->pool != pktmbuf_pool_small)
+			GOTO_FAIL("Packet %u was not compacted", i);
+		if (rte_pktmbuf_pkt_len(pkts[i]) != len ||
+				rte_pktmbuf_data_len(pkts[i]) != len)
+			GOTO_FAIL("Bad length for packet %u", i);
+		if (pkts[i]->port != i || pkts[i]->ol_flags != PKT_RX_RSS_HASH ||
+				pkts[i]->hash.rss != i * 1000)
+			GOTO_FAIL("Bad metadata for packet %u", i);
+		data = rte_pktmbuf_mtod(pkts[i], char *);
+		for (j = 0; j < len; j++) {
+			if (data[j] != (char)i)
+				GOTO_FAIL("Bad data for packet %u", i);
+		}
+	}
+
+	/* the large buffers of the copied packets were released */
+	if (rte_mempool_count(pktmbuf_pool) != avail - MBUF_COMPACT_BURST +
+			nb_small - 1)
+		GOTO_FAIL("Large buffers were not released");
+
+	/* compacting again is a no-op */
+	if (rte_pktmbuf_compact_burst(pkts, MBUF_COMPACT_BURST,
+			pktmbuf_pool_small) != 0)
+		GOTO_FAIL("Compacted packets were copied again");
+
+	/* each mbuf returns to its own pool */
+	rte_pktmbuf_free(clone);
+	clone = NULL;
+	for (i = 0; i < MBUF_COMPACT_BURST; i++) {
+		rte_pktmbuf_free(pkts[i]);
+		pkts[i] = NULL;
+	}
+	if (rte_mempool_count(pktmbuf_pool) != avail ||
+			rte_mempool_count(pktmbuf_pool_small) != small_avail)
+		GOTO_FAIL("Mbufs were not returned to their pools");
+
+	return 0;
+
+fail:
+	if (clone)
+		rte_pktmbuf_free(clone);
+	for (i = 0; i < MBUF_COMPACT_BURST; i++) {
+		if (pkts[i])
+			rte_pktmbuf_free(pkts[i]);
+	}
+	return -1;
+}
+
+static int
+test_pktmbuf_free_bulk(void)
+{
+	struct rte_mbuf *pkts[MBUF_COMPACT_BURST];
+	struct rte_mbuf *m = NULL, *shared = NULL, *seg;
+	unsigned avail, avail2, i;
+
+	memset(pkts, 0, sizeof(pkts));
+	avail = rte_mempool_count(pktmbuf_pool);
+	avail2 = rte_mempool_count(pktmbuf_pool2);
+
+	/* mix mbufs of both pools, chained mbufs and clones */
+	for (i = 0; i < MBUF_COMPACT_BURST; i++) {
+		if (i % 5 == 4)
+			continue; /* NULL entries are skipped */
+		pkts[i] = rte_pktmbuf_alloc((i & 2) ? pktmbuf_pool2 :
+			pktmbuf_pool);
+		if (pkts[i] == NULL)
+			GOTO_FAIL("Cannot allocate mbuf");
+		if (i % 3 == 0) {
+			seg = rte_pktmbuf_alloc(pktmbuf_pool);
+			if (seg == NULL)
+				GOTO_FAIL("Cannot allocate segment");
+			if (rte_pktmbuf_chain(pkts[i], seg) != 0) {
+				rte_pktmbuf_free(seg);
+				GOTO_FAIL("Cannot chain mbuf");
+			}
+		}
+	}
+
+	/* the direct mbufs of the clone are freed by the last reference */
+	m = rte_pktmbuf_alloc(pktmbuf_pool);
+	if (m == NULL)
+		GOTO_FAIL("Cannot allocate mbuf");
+	pkts[4] = rte_pktmbuf_clone(m, pktmbuf_pool2);
+	if (pkts[4] == NULL)
+		GOTO_FAIL("Cannot clone mbuf");
+	shared = pkts[1];
+	rte_mbuf_refcnt_update(shared, 1);
+
+	rte_pktmbuf_free_bulk(pkts, MBUF_COMPACT_BURST);
+	memset(pkts, 0, sizeof(pkts));
+
+	/* shared mbufs are still referenced */
+	if (rte_mbuf_refcnt_read(shared) != 1 ||
+			rte_mbuf_refcnt_read(m) != 1)
+		GOTO_FAIL("Shared mbuf was freed");
+	if (rte_mempool_count(pktmbuf_pool2) != avail2)
+		GOTO_FAIL("Mbufs were not returned to pool2");
+	if (rte_mempool_count(pktmbuf_pool) != avail - 2)
+		GOTO_FAIL("Mbufs were not returned to pool");
+
+	pkts[0] = shared;
+	pkts[1] = m;
+	shared = NULL;
+	m = NULL;
+	rte_pktmbuf_free_bulk(pkts, 2);
+	if (rte_mempool_count(pktmbuf_pool) != avail)
+		GOTO_FAIL("Shared mbufs were not returned to pool");
+
+	return 0;
+
+fail:
+	if (m)
+		rte_pktmbuf_free(m);
+	if (shared)
+		rte_pktmbuf_free(shared);
+	rte_pktmbuf_free_bulk(pkts, MBUF_COMPACT_BURST);
+	return -1;
+}
+
+static void
+ext_buf_free_cb(void *addr, void *opaque)
+{
+	unsigned *nb_free = opaque;
+
+	rte_free(addr);
+	(*nb_free)++;
+}
+
+static int
+test_pktmbuf_ext_buf(void)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+	struct rte_mbuf *m = NULL, *clone = NULL, *seg;
+	unsigned avail, i, nb_free = 0;
+	uint16_t buf_len = MBUF_EXT_BUF_SIZE;
+	char *buf, *data;
+
+	avail = rte_mempool_count(pktmbuf_pool);
+
+	buf = rte_malloc(NULL, MBUF_EXT_BUF_SIZE, 0);
+	if (buf == NULL)
+		GOTO_FAIL("Cannot allocate external buffer");
+	shinfo = rte_pktmbuf_ext_shinfo_init_helper(buf, &buf_len,
+		ext_buf_free_cb, &nb_free);
+	if (shinfo == NULL) {
+		rte_free(buf);
+		GOTO_FAIL("Cannot initialize shared info");
+	}
+	if (buf_len >= MBUF_EXT_BUF_SIZE ||
+			(char *)shinfo + sizeof(*shinfo) > buf + MBUF_EXT_BUF_SIZE) {
+		rte_free(buf);
+		GOTO_FAIL("Bad shared info location");
+	}
+
+	/* attach the external buffer and fill it */
+	m = rte_pktmbuf_alloc(pktmbuf_pool);
+	if (m == NULL) {
+		rte_free(buf);
+		GOTO_FAIL("Cannot allocate mbuf");
+	}
+	rte_pktmbuf_attach_extbuf(m, buf, rte_malloc_virt2phy(buf), buf_len,
+		shinfo);
+	if (!RTE_MBUF_HAS_EXTBUF(m) || RTE_MBUF_DIRECT(m) ||
+			RTE_MBUF_INDIRECT(m))
+		GOTO_FAIL("Bad flags after attach");
+	if (rte_pktmbuf_mtod(m, char *) != buf || m->buf_len != buf_len)
+		GOTO_FAIL("Bad buffer after attach");
+	data = rte_pktmbuf_append(m, MBUF_TEST_DATA_LEN2);
+	if (data == NULL)
+		GOTO_FAIL("Cannot append data");
+	memset(data, 0xcc, MBUF_TEST_DATA_LEN2);
+
+	/* chain a direct segment */
+	seg = rte_pktmbuf_alloc(pktmbuf_pool);
+	if (seg == NULL)
+		GOTO_FAIL("Cannot allocate segment");
+	if (rte_pktmbuf_append(seg, MBUF_TEST_DATA_LEN2) == NULL ||
+			rte_pktmbuf_chain(m, seg) != 0) {
+		rte_pktmbuf_free(seg);
+		GOTO_FAIL("Cannot chain segment");
+	}
+
+	/* the clone shares the external buffer */
+	clone = rte_pktmbuf_clone(m, pktmbuf_pool);
+	if (clone == NULL)
+		GOTO_FAIL("Cannot clone mbuf");
+	if (rte_mbuf_ext_refcnt_read(shinfo) != 2)
+		GOTO_FAIL("Bad external buffer refcnt after clone");
+	if (!RTE_MBUF_HAS_EXTBUF(clone) || clone->shinfo != shinfo ||
+			!RTE_MBUF_INDIRECT(clone->next))
+		GOTO_FAIL("Bad flags in clone");
+	if (rte_pktmbuf_pkt_len(clone) != 2 * MBUF_TEST_DATA_LEN2)
+		GOTO_FAIL("Bad clone length");
+	data = rte_pktmbuf_mtod(clone, char *);
+	for (i = 0; i < MBUF_TEST_DATA_LEN2; i++) {
+		if (data[i] != (char)0xcc)
+			GOTO_FAIL("Bad data in clone");
+	}
+
+	/* the buffer is freed with its last reference */
+	rte_pktmbuf_free(m);
+	m = NULL;
+	if (nb_free != 0 || rte_mbuf_ext_refcnt_read(shinfo) != 1)
+		GOTO_FAIL("External buffer freed while referenced");
+	rte_pktmbuf_free_bulk(&clone, 1);
+	clone = NULL;
+	if (nb_free != 1)
+		GOTO_FAIL("External buffer was not freed");
+
+	if (rte_mempool_count(pktmbuf_pool) != avail)
+		GOTO_FAIL("Mbufs were not returned to pool");
+
+	return 0;
+
+fail:
+	if (clone)
+		rte_pktmbuf_free(clone);
+	if (m)
+		rte_pktmbuf_free(m);
+	return -1;
+}
+
 #undef GOTO_FAIL
 
 /*
@@ -955,6 +1316,18 @@ test_mbuf(void)
 		return -1;
 	}
 
+	/* create a pktmbuf pool with a small data room */
+	if (pktmbuf_pool_small == NULL) {
+		pktmbuf_pool_small = rte_pktmbuf_pool_create(
+			"test_pktmbuf_pool_small", NB_MBUF, 32, 0,
+			MBUF_SMALL_DATA_SIZE, SOCKET_ID_ANY);
+	}
+
+	if (pktmbuf_pool_small == NULL) {
+		printf("cannot allocate mbuf pool\n");
+		return -1;
+	}
+
 	/* test multiple mbuf alloc */
 	if (test_pktmbuf_pool() < 0) {
 		printf("test_mbuf_pool() failed\n");
@@ -1000,6 +1373,26 @@ test_mbuf(void)
 		return -1;
 	}
 
+	if (test_pktmbuf_read_write() < 0) {
+		printf("test_pktmbuf_read_write() failed\n");
+		return -1;
+	}
+
+	if (test_pktmbuf_compact_burst() < 0) {
+		printf("test_pktmbuf_compact_burst() failed\n");
+		return -1;
+	}
+
+	if (test_pktmbuf_free_bulk() < 0) {
+		printf("test_pktmbuf_free_bulk() failed\n");
+		return -1;
+	}
+
+	if (test_pktmbuf_ext_buf() < 0) {
+		printf("test_pktmbuf_ext_buf() failed\n");
+		return -1;
+	}
+
 	if (testclone_testupdate_testdetach()<0){
 		printf("testclone_and_testupdate() failed \n");
 		return -1;
@@ -75,7 +75,9 @@ test_memory(void)
 
 	/* try to read memory (should not segfault) */
 	mem = rte_eal_get_physmem_layout();
-	for (i = 0; i < RTE_MAX_MEMSEG && mem[i].addr != NULL ; i++) {
+	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
+		if (mem[i].addr == NULL)
+			continue;
 
 		/* check memory */
 		for (j = 0; j<mem[i].len; j++) {
@@ -427,6 +427,37 @@ test_mempool_same_name_twice_creation(void)
 	return 0;
 }
 
+static int
+test_mempool_free(void)
+{
+	struct rte_mempool *mp_free;
+	unsigned i;
+
+	/* a freed pool releases its name and its memory for the next one */
+	for (i = 0; i < 2; i++) {
+		mp_free = rte_mempool_create("test_mempool_free", MEMPOOL_SIZE,
+						MEMPOOL_ELT_SIZE, 0, 0,
+						NULL, NULL,
+						my_obj_init, NULL,
+						SOCKET_ID_ANY, 0);
+		if (NULL == mp_free) {
+			printf("Cannot create mempool after free\n");
+			return -1;
+		}
+
+		rte_mempool_free(mp_free);
+
+		if (rte_mempool_lookup("test_mempool_free") != NULL) {
+			printf("Freed mempool can still be looked up\n");
+			return -1;
+		}
+	}
+
+	rte_mempool_free(NULL);
+
+	return 0;
+}
+
 /*
  * BAsic test for mempool_xmem functions.
  */
@@ -513,6 +544,9 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		return -1;
 
+	if (test_mempool_free() < 0)
+		return -1;
+
 	if (test_mempool_xmem_misc() < 0)
 		return -1;
 
@@ -0,0 +1,243 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_ethdev.h>
+#include <rte_eth_ring.h>
+#include <rte_jobstats.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#include <rte_metrics.h>
+
+#include "test.h"
+
+#define METRICS_MANY 1000
+#define METRICS_RING_SIZE 64
+#define METRICS_POOL_SIZE 63
+#define METRICS_CACHE_SIZE 8
+
+static struct rte_metric_name names[RTE_METRICS_MAX_METRICS];
+static uint64_t values[RTE_METRICS_MAX_METRICS];
+
+/* value of a metric, found by name */
+static int
+metrics_find(const char *name, uint64_t *value)
+{
+	int i, n;
+
+	n = rte_metrics_get_names(names, RTE_DIM(names));
+	if (n < 0 || rte_metrics_get_values(values, RTE_DIM(values)) < n)
+		return -1;
+
+	for (i = 0; i < n; i++) {
+		if (strcmp(names[i].name, name) == 0) {
+			*value = values[i];
+			return 0;
+		}
+	}
+	return -1;
+}
+
+static int
+test_metrics_reg(void)
+{
+	char name[RTE_METRICS_NAME_SIZE + 1];
+	int id_a, id_b, n;
+
+	TEST_ASSERT_EQUAL(rte_metrics_reg_name(""), -EINVAL,
+		"Registered an empty name");
+	TEST_ASSERT_EQUAL(rte_metrics_reg_name("test metric"), -EINVAL,
+		"Registered a name with a space");
+	memset(name, 'a', RTE_METRICS_NAME_SIZE);
+	name[RTE_METRICS_NAME_SIZE] = '\0';
+	TEST_ASSERT_EQUAL(rte_metrics_reg_name(name), -EINVAL,
+		"Registered a name too long");
+
+	id_a = rte_metrics_reg_name("test.a");
+	id_b = rte_metrics_reg_name("test.b");
+	TEST_ASSERT(id_a >= 0 && id_b >= 0 && id_a != id_b,
+		"Cannot register metrics");
+	TEST_ASSERT_EQUAL(rte_metrics_reg_name("test.a"), id_a,
+		"Wrong identifier on second registration");
+
+	n = rte_metrics_get_names(names, RTE_DIM(names));
+	TEST_ASSERT(n > id_a && n > id_b, "Wrong number of metrics");
+	TEST_ASSERT(strcmp(names[id_a].name, "test.a") == 0 &&
+		strcmp(names[id_b].name, "test.b") == 0, "Wrong metric names");
+	TEST_ASSERT_EQUAL(rte_metrics_get_names(NULL, 0), n,
+		"Wrong number of metrics without array");
+
+	TEST_ASSERT_SUCCESS(rte_metrics_update_value(id_a, 42),
+		"Cannot update metric");
+	TEST_ASSERT_EQUAL(rte_metrics_update_value(n, 42), -EINVAL,
+		"Updated an unregistered metric");
+	TEST_ASSERT_EQUAL(rte_metrics_update_value(-1, 42), -EINVAL,
+		"Updated an invalid metric");
+	TEST_ASSERT_EQUAL(rte_metrics_get_values(values, RTE_DIM(values)), n,
+		"Wrong number of values");
+	TEST_ASSERT(values[id_a] == 42 && values[id_b] == 0,
+		"Wrong metric values");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_metrics_many(void)
+{
+	const char *name_ptrs[METRICS_MANY];
+	static char many[METRICS_MANY][RTE_METRICS_NAME_SIZE];
+	static int ids[METRICS_MANY];
+	static uint64_t vals[METRICS_MANY];
+	unsigned i;
+
+	for (i = 0; i < METRICS_MANY; i++) {
+		snprintf(many[i], sizeof(many[i]), "test.many.%u", i);
+		name_ptrs[i] = many[i];
+		vals[i] = i * 3;
+	}
+	TEST_ASSERT_SUCCESS(rte_metrics_reg_names(name_ptrs, ids,
+			METRICS_MANY), "Cannot register metrics");
+	TEST_ASSERT_SUCCESS(rte_metrics_update_values(ids, vals,
+			METRICS_MANY), "Cannot update metrics");
+
+	rte_metrics_get_names(names, RTE_DIM(names));
+	rte_metrics_get_values(values, RTE_DIM(values));
+	for (i = 0; i < METRICS_MANY; i++) {
+		TEST_ASSERT_EQUAL(rte_metrics_reg_name(many[i]), ids[i],
+			"Wrong identifier of %s", many[i]);
+		TEST_ASSERT(strcmp(names[ids[i]].name, many[i]) == 0 &&
+			values[ids[i]] == vals[i], "Wrong metric %s", many[i]);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_metrics_publish(void)
+{
+	struct rte_ring *r;
+	struct rte_mempool *mp;
+	struct rte_jobstats job;
+	struct rte_eth_conf null_conf;
+	char name[RTE_METRICS_NAME_SIZE];
+	void *objs[5];
+	uint64_t v;
+	unsigned i;
+	int port;
+
+	r = rte_ring_create("METRICS_RING", METRICS_RING_SIZE,
+		SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(r, "Cannot create ring");
+	for (i = 0; i < RTE_DIM(objs); i++)
+		objs[i] = (void *)(uintptr_t)(i + 1);
+	TEST_ASSERT_SUCCESS(rte_ring_enqueue_bulk(r, objs, RTE_DIM(objs)),
+		"Cannot enqueue");
+	TEST_ASSERT_SUCCESS(rte_metrics_publish_ring(r),
+		"Cannot publish ring");
+	TEST_ASSERT(metrics_find("ring.METRICS_RING.count", &v) == 0 &&
+		v == RTE_DIM(objs), "Wrong ring count");
+	TEST_ASSERT(metrics_find("ring.METRICS_RING.free", &v) == 0 &&
+		v == METRICS_RING_SIZE - 1 - RTE_DIM(objs),
+		"Wrong ring free count");
+
+	mp = rte_mempool_create("METRICS_POOL", METRICS_POOL_SIZE, 64,
+		METRICS_CACHE_SIZE, 0, NULL, NULL, NULL, NULL,
+		SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool");
+	TEST_ASSERT_SUCCESS(rte_mempool_get_bulk(mp, objs, RTE_DIM(objs)),
+		"Cannot get objects");
+	TEST_ASSERT_SUCCESS(rte_metrics_publish_mempool(mp),
+		"Cannot publish mempool");
+	TEST_ASSERT(metrics_find("mempool.METRICS_POOL.in_use", &v) == 0 &&
+		v == RTE_DIM(objs), "Wrong mempool usage");
+	rte_mempool_put_bulk(mp, objs, RTE_DIM(objs));
+	TEST_ASSERT_SUCCESS(rte_metrics_publish_mempool(mp),
+		"Cannot publish mempool");
+	TEST_ASSERT(metrics_find("mempool.METRICS_POOL.in_use", &v) == 0 &&
+		v == 0, "Wrong mempool usage after put");
+	TEST_ASSERT(metrics_find("mempool.METRICS_POOL.cache_count", &v) == 0 &&
+		v <= METRICS_POOL_SIZE, "Wrong mempool cache count");
+
+	TEST_ASSERT_SUCCESS(rte_jobstats_init(&job, "metrics_job", 10, 1000,
+		100, 0), "Cannot init job");
+	TEST_ASSERT_SUCCESS(rte_metrics_publish_job(&job),
+		"Cannot publish job");
+	TEST_ASSERT(metrics_find("job.metrics_job.period", &v) == 0 &&
+		v == 100, "Wrong job period");
+
+	port = rte_eth_from_rings("net_metrics", &r, 1, &r, 1, SOCKET_ID_ANY);
+	TEST_ASSERT(port >= 0, "Cannot create ring port");
+	memset(&null_conf, 0, sizeof(null_conf));
+	TEST_ASSERT_SUCCESS(rte_eth_dev_configure(port, 1, 1, &null_conf),
+		"Cannot configure port");
+	TEST_ASSERT_SUCCESS(rte_eth_tx_queue_setup(port, 0, METRICS_RING_SIZE,
+		SOCKET_ID_ANY, NULL), "Cannot setup TX queue");
+	TEST_ASSERT_SUCCESS(rte_metrics_publish_ethdev(port),
+		"Cannot publish ethdev");
+	snprintf(name, sizeof(name), "ethdev.%d.rx_good_packets", port);
+	TEST_ASSERT_SUCCESS(metrics_find(name, &v), "No ethdev metric");
+
+	TEST_ASSERT(rte_metrics_publish_ring(NULL) < 0,
+		"Published a NULL ring");
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite metrics_testsuite = {
+	.suite_name = "Metrics Unit Test Suite",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_metrics_reg),
+		TEST_CASE(test_metrics_many),
+		TEST_CASE(test_metrics_publish),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_metrics(void)
+{
+	return unit_test_suite_runner(&metrics_testsuite);
+}
+
+static struct test_command metrics_cmd = {
+	.command = "metrics_autotest",
+	.callback = test_metrics,
+};
+REGISTER_TEST_COMMAND(metrics_cmd);
@@ -0,0 +1,438 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <netinet/in.h>
+
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_gre.h>
+#include <rte_net.h>
+#include <rte_lcore.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 32
+#define NET_TEST_CKSUM_MAX_LEN 2048
+#define NET_TEST_CKSUM_BIG_LEN 65536
+/* size of the first segment of the packets split in two */
+#define NET_TEST_SPLIT_LEN 16
+
+#define NET_TEST_ALL_LAYERS 0x0fffffff
+
+static struct rte_mempool *net_pool;
+
+/* sum the 16-bit words of a buffer the simplest way */
+static uint16_t
+ref_cksum(const uint8_t *buf, size_t len)
+{
+	uint64_t sum = 0;
+	uint16_t w;
+	size_t i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		memcpy(&w, buf + i, sizeof(w));
+		sum += w;
+	}
+	if (len & 1)
+		sum += buf[len - 1];
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+	return (uint16_t)sum;
+}
+
+static int
+test_net_raw_cksum(void)
+{
+	uint8_t *buf;
+	size_t len, off;
+	unsigned i;
+
+	buf = malloc(NET_TEST_CKSUM_BIG_LEN + 4);
+	TEST_ASSERT_NOT_NULL(buf, "Cannot allocate buffer");
+
+	srand(0);
+	for (i = 0; i < NET_TEST_CKSUM_MAX_LEN + 4; i++)
+		buf[i] = rand();
+	for (len = 0; len <= NET_TEST_CKSUM_MAX_LEN; len++) {
+		for (off = 0; off < 4; off++) {
+			if (rte_raw_cksum(buf + off, len) !=
+					ref_cksum(buf + off, len)) {
+				free(buf);
+				TEST_ASSERT(0, "Bad checksum of %zu bytes at "
+					"offset %zu", len, off);
+			}
+		}
+	}
+
+	/* the largest sums, which must not overflow */
+	memset(buf, 0xff, NET_TEST_CKSUM_BIG_LEN + 4);
+	for (off = 0; off < 2; off++) {
+		len = NET_TEST_CKSUM_BIG_LEN + off;
+		if (rte_raw_cksum(buf + off, len) != ref_cksum(buf + off, len)) {
+			free(buf);
+			TEST_ASSERT(0, "Bad checksum of %zu bytes", len);
+		}
+	}
+
+	free(buf);
+	return 0;
+}
+
+/*
+ * Build a packet from the len bytes of hdr, followed by some payload,
+ * split in two segments if split is set.
+ */
+static struct rte_mbuf *
+build_pkt(const uint8_t *hdr, uint16_t len, int split)
+{
+	struct rte_mbuf *m, *tail;
+	uint16_t first_len;
+	char *p;
+
+	m = rte_pktmbuf_alloc(net_pool);
+	if (m == NULL)
+		return NULL;
+	first_len = split ? NET_TEST_SPLIT_LEN : len;
+	p = rte_pktmbuf_append(m, first_len);
+	if (p == NULL)
+		goto fail;
+	memcpy(p, hdr, first_len);
+	if (!split)
+		return m;
+
+	tail = rte_pktmbuf_alloc(net_pool);
+	if (tail == NULL)
+		goto fail;
+	p = rte_pktmbuf_append(tail, len - first_len);
+	if (p == NULL || rte_pktmbuf_chain(m, tail) < 0) {
+		rte_pktmbuf_free(tail);
+		goto fail;
+	}
+	memcpy(p, hdr + first_len, len - first_len);
+	return m;
+
+fail:
+	rte_pktmbuf_free(m);
+	return NULL;
+}
+
+/* append an Ethernet header, with n VLAN tags */
+static uint8_t *
+put_eth(uint8_t *p, uint16_t ether_type, unsigned n)
+{
+	struct ether_hdr *eh = (struct ether_hdr *)p;
+	struct vlan_hdr *vh;
+	unsigned i;
+
+	memset(eh, 0, sizeof(*eh));
+	p += sizeof(*eh);
+	if (n == 0) {
+		eh->ether_type = rte_cpu_to_be_16(ether_type);
+		return p;
+	}
+	eh->ether_type = rte_cpu_to_be_16(n == 1 ? ETHER_TYPE_VLAN :
+		ETHER_TYPE_QINQ);
+	for (i = 0; i < n; i++) {
+		vh = (struct vlan_hdr *)p;
+		vh->vlan_tci = rte_cpu_to_be_16(i + 1);
+		vh->eth_proto = rte_cpu_to_be_16(i == n - 1 ? ether_type :
+			ETHER_TYPE_VLAN);
+		p += sizeof(*vh);
+	}
+	return p;
+}
+
+/* append an IPv4 header with opt_len bytes of options */
+static uint8_t *
+put_ipv4(uint8_t *p, uint8_t proto, uint16_t opt_len, uint16_t frag)
+{
+	struct ipv4_hdr *ip = (struct ipv4_hdr *)p;
+
+	memset(ip, 0, sizeof(*ip) + opt_len);
+	ip->version_ihl = 0x40 | ((sizeof(*ip) + opt_len) / 4);
+	ip->fragment_offset = rte_cpu_to_be_16(frag);
+	ip->next_proto_id = proto;
+	return p + sizeof(*ip) + opt_len;
+}
+
+/* append an IPv6 header, followed by a hop-by-hop options header if ext */
+static uint8_t *
+put_ipv6(uint8_t *p, uint8_t proto, int ext)
+{
+	struct ipv6_hdr *ip6 = (struct ipv6_hdr *)p;
+
+	memset(ip6, 0, sizeof(*ip6));
+	ip6->vtc_flow = rte_cpu_to_be_32(0x60000000);
+	ip6->proto = ext ? IPPROTO_HOPOPTS : proto;
+	p += sizeof(*ip6);
+	if (ext) {
+		memset(p, 0, 8);
+		p[0] = proto;
+		p += 8;
+	}
+	return p;
+}
+
+static uint8_t *
+put_tcp(uint8_t *p, uint8_t hdr_len)
+{
+	struct tcp_hdr *th = (struct tcp_hdr *)p;
+
+	memset(th, 0, hdr_len);
+	th->data_off = (hdr_len / 4) << 4;
+	return p + hdr_len;
+}
+
+static uint8_t *
+put_udp(uint8_t *p, uint16_t dst_port)
+{
+	struct udp_hdr *uh = (struct udp_hdr *)p;
+
+	memset(uh, 0, sizeof(*uh));
+	uh->dst_port = rte_cpu_to_be_16(dst_port);
+	return p + sizeof(*uh);
+}
+
+/* parse a packet and check its packet type and header lengths */
+static int
+check_ptype(const uint8_t *hdr, uint16_t len, uint32_t layers,
+		uint32_t ptype, const struct rte_net_hdr_lens *lens)
+{
+	struct rte_net_hdr_lens hdr_lens;
+	struct rte_mbuf *m;
+	uint32_t ret;
+	int split;
+
+	for (split = 0; split < 2; split++) {
+		m = build_pkt(hdr, len, split);
+		TEST_ASSERT_NOT_NULL(m, "Cannot build packet");
+		ret = rte_net_get_ptype(m, &hdr_lens, layers);
+		rte_pktmbuf_free(m);
+		TEST_ASSERT_EQUAL(ret, ptype, "Bad packet type %#x", ret);
+		TEST_ASSERT_SUCCESS(memcmp(&hdr_lens, lens, sizeof(*lens)),
+			"Bad header lengths");
+	}
+	return 0;
+}
+
+static int
+test_net_ptype(void)
+{
+	uint8_t hdr[256], *p;
+	struct rte_net_hdr_lens lens;
+	struct gre_hdr *gh;
+
+	/* VLAN, IPv4, TCP with options */
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 1);
+	p = put_ipv4(p, IPPROTO_TCP, 0, 0);
+	p = put_tcp(p, 32);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 18;
+	lens.l3_len = 20;
+	lens.l4_len = 32;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr, NET_TEST_ALL_LAYERS,
+		RTE_PTYPE_L2_ETHER_VLAN | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_TCP, &lens), "Bad VLAN TCP/IPv4 packet");
+
+	/* the layers to parse are limited */
+	lens.l4_len = 0;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr,
+		RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK,
+		RTE_PTYPE_L2_ETHER_VLAN | RTE_PTYPE_L3_IPV4, &lens),
+		"Bad limited parsing");
+
+	/* QinQ, IPv6 with an extension header, UDP */
+	p = put_eth(hdr, ETHER_TYPE_IPv6, 2);
+	p = put_ipv6(p, IPPROTO_UDP, 1);
+	p = put_udp(p, 53);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 22;
+	lens.l3_len = 48;
+	lens.l4_len = 8;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr, NET_TEST_ALL_LAYERS,
+		RTE_PTYPE_L2_ETHER_QINQ | RTE_PTYPE_L3_IPV6_EXT |
+		RTE_PTYPE_L4_UDP, &lens), "Bad QinQ UDP/IPv6 packet");
+
+	/* IPv4 fragment with options */
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 0);
+	p = put_ipv4(p, IPPROTO_TCP, 4, 100);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 14;
+	lens.l3_len = 24;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr, NET_TEST_ALL_LAYERS,
+		RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4_EXT |
+		RTE_PTYPE_L4_FRAG, &lens), "Bad IPv4 fragment");
+
+	/* ARP */
+	p = put_eth(hdr, ETHER_TYPE_ARP, 0);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 14;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr + 28,
+		NET_TEST_ALL_LAYERS, RTE_PTYPE_L2_ETHER_ARP, &lens),
+		"Bad ARP packet");
+
+	/* TCP/IPv6 in VXLAN over IPv4 */
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 0);
+	p = put_ipv4(p, IPPROTO_UDP, 0, 0);
+	p = put_udp(p, RTE_NET_VXLAN_DEFAULT_PORT);
+	memset(p, 0, sizeof(struct vxlan_hdr));
+	p += sizeof(struct vxlan_hdr);
+	p = put_eth(p, ETHER_TYPE_IPv6, 0);
+	p = put_ipv6(p, IPPROTO_TCP, 0);
+	p = put_tcp(p, 20);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 14;
+	lens.l3_len = 20;
+	lens.l4_len = 8;
+	lens.tunnel_len = 8;
+	lens.inner_l2_len = 14;
+	lens.inner_l3_len = 40;
+	lens.inner_l4_len = 20;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr, NET_TEST_ALL_LAYERS,
+		RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 | RTE_PTYPE_L4_UDP |
+		RTE_PTYPE_TUNNEL_VXLAN | RTE_PTYPE_INNER_L2_ETHER |
+		RTE_PTYPE_INNER_L3_IPV6 | RTE_PTYPE_INNER_L4_TCP, &lens),
+		"Bad VXLAN packet");
+
+	/* UDP/IPv4 in GRE with a key */
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 0);
+	p = put_ipv4(p, IPPROTO_GRE, 0, 0);
+	gh = (struct gre_hdr *)p;
+	memset(gh, 0, sizeof(*gh) + 4);
+	gh->k = 1;
+	gh->proto = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	p += sizeof(*gh) + 4;
+	p = put_ipv4(p, IPPROTO_UDP, 0, 0);
+	p = put_udp(p, 53);
+	memset(&lens, 0, sizeof(lens));
+	lens.l2_len = 14;
+	lens.l3_len = 20;
+	lens.tunnel_len = 8;
+	lens.inner_l3_len = 20;
+	lens.inner_l4_len = 8;
+	TEST_ASSERT_SUCCESS(check_ptype(hdr, p - hdr, NET_TEST_ALL_LAYERS,
+		RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_TUNNEL_GRE | RTE_PTYPE_INNER_L3_IPV4 |
+		RTE_PTYPE_INNER_L4_UDP, &lens), "Bad GRE packet");
+
+	return 0;
+}
+
+static int
+test_net_ptype_burst(void)
+{
+	uint8_t hdr[128], *p;
+	struct rte_mbuf *pkts[2];
+
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 1);
+	p = put_ipv4(p, IPPROTO_TCP, 0, 0);
+	p = put_tcp(p, 20);
+	pkts[0] = build_pkt(hdr, p - hdr, 0);
+
+	p = put_eth(hdr, ETHER_TYPE_IPv4, 0);
+	p = put_ipv4(p, IPPROTO_UDP, 0, 0);
+	p = put_udp(p, RTE_NET_VXLAN_DEFAULT_PORT);
+	memset(p, 0, sizeof(struct vxlan_hdr));
+	p += sizeof(struct vxlan_hdr);
+	p = put_eth(p, ETHER_TYPE_IPv4, 0);
+	p = put_ipv4(p, IPPROTO_TCP, 0, 0);
+	p = put_tcp(p, 20);
+	pkts[1] = build_pkt(hdr, p - hdr, 1);
+	TEST_ASSERT(pkts[0] != NULL && pkts[1] != NULL,
+		"Cannot build packets");
+
+	rte_net_get_ptype_burst(pkts, RTE_DIM(pkts), NET_TEST_ALL_LAYERS);
+
+	TEST_ASSERT_EQUAL(pkts[0]->packet_type, (RTE_PTYPE_L2_ETHER_VLAN |
+		RTE_PTYPE_L3_IPV4 | RTE_PTYPE_L4_TCP), "Bad packet type");
+	TEST_ASSERT(pkts[0]->l2_len == 18 && pkts[0]->l3_len == 20 &&
+		pkts[0]->l4_len == 20, "Bad header lengths");
+
+	/* the lengths of a tunneled packet follow the TX conventions */
+	TEST_ASSERT_EQUAL(pkts[1]->packet_type, (RTE_PTYPE_L2_ETHER |
+		RTE_PTYPE_L3_IPV4 | RTE_PTYPE_L4_UDP |
+		RTE_PTYPE_TUNNEL_VXLAN | RTE_PTYPE_INNER_L2_ETHER |
+		RTE_PTYPE_INNER_L3_IPV4 | RTE_PTYPE_INNER_L4_TCP),
+		"Bad tunnel packet type");
+	TEST_ASSERT(pkts[1]->outer_l2_len == 14 &&
+		pkts[1]->outer_l3_len == 20 &&
+		pkts[1]->l2_len == ETHER_VXLAN_HLEN + ETHER_HDR_LEN &&
+		pkts[1]->l3_len == 20 && pkts[1]->l4_len == 20,
+		"Bad tunnel header lengths");
+
+	rte_pktmbuf_free(pkts[0]);
+	rte_pktmbuf_free(pkts[1]);
+	return 0;
+}
+
+static int
+test_setup(void)
+{
+	if (net_pool == NULL) {
+		net_pool = rte_pktmbuf_pool_create("NET_MBUF_POOL", NUM_MBUFS,
+			0, 0, RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+		if (net_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static struct unit_test_suite net_test_suite  = {
+	.setup = test_setup,
+	.suite_name = "Net Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_net_raw_cksum),
+		TEST_CASE(test_net_ptype),
+		TEST_CASE(test_net_ptype_burst),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_net(void)
+{
+	return unit_test_suite_runner(&net_test_suite);
+}
+
+static struct test_command net_cmd = {
+	.command = "net_autotest",
+	.callback = test_net,
+};
+REGISTER_TEST_COMMAND(net_cmd);
@@ -33,6 +33,8 @@
 #include "test.h"
 
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 
 #include <rte_eth_ring.h>
 #include <rte_ethdev.h>
@@ -240,6 +242,77 @@ test_stats_reset(int port)
 	return 0;
 }
 
+static int
+test_xstats_by_id(int port)
+{
+	static const char * const names[] = {
+		"tx_q0_packets", "rx_good_packets", "rx_q0_packets",
+	};
+	struct rte_eth_xstats xstats[64];
+	struct rte_mbuf buf, *pbuf = &buf;
+	uint64_t ids[RTE_DIM(names)], values[RTE_DIM(names)], bad_id;
+	int count;
+	unsigned i;
+
+	printf("Testing ring PMD xstats_get_by_id port %d\n", port);
+
+	for (i = 0; i < RTE_DIM(names); i++) {
+		if (rte_eth_xstats_get_id_by_name(port, names[i],
+				&ids[i]) != 0) {
+			printf("Error: port %d has no xstat %s\n", port,
+				names[i]);
+			return -1;
+		}
+	}
+	if (rte_eth_xstats_get_id_by_name(port, "rx_q99_packets",
+			&bad_id) != -EINVAL) {
+		printf("Error: port %d found an unknown xstat\n", port);
+		return -1;
+	}
+
+	/* send and receive 1 packet and check for stats update */
+	if (rte_eth_tx_burst(port, 0, &pbuf, 1) != 1) {
+		printf("Error sending packet to port %d\n", port);
+		return -1;
+	}
+
+	if (rte_eth_rx_burst(port, 0, &pbuf, 1) != 1) {
+		printf("Error receiving packet from port %d\n", port);
+		return -1;
+	}
+
+	if (rte_eth_xstats_get_by_id(port, ids, values, RTE_DIM(ids)) !=
+			(int)RTE_DIM(ids)) {
+		printf("Error: port %d xstats by id failed\n", port);
+		return -1;
+	}
+
+	/* the values must match the full table */
+	count = rte_eth_xstats_get(port, xstats, RTE_DIM(xstats));
+	if (count < 0 || count > (int)RTE_DIM(xstats)) {
+		printf("Error: port %d xstats failed\n", port);
+		return -1;
+	}
+	for (i = 0; i < RTE_DIM(ids); i++) {
+		if (ids[i] >= (uint64_t)count ||
+				strcmp(xstats[ids[i]].name, names[i]) != 0 ||
+				xstats[ids[i]].value != values[i] ||
+				values[i] == 0) {
+			printf("Error: port %d xstat %s is not as expected\n",
+				port, names[i]);
+			return -1;
+		}
+	}
+
+	bad_id = count;
+	if (rte_eth_xstats_get_by_id(port, &bad_id, values, 1) != -EINVAL) {
+		printf("Error: port %d read an invalid xstat\n", port);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_pmd_ring_pair_create_attach(int portd, int porte)
 {
@@ -494,6 +567,9 @@ test_pmd_ring(void)
 	if (test_stats_reset(rxtx_portc) < 0)
 		return -1;
 
+	if (test_xstats_by_id(rxtx_portc) < 0)
+		return -1;
+
 	rte_eth_dev_stop(tx_porta);
 	rte_eth_dev_stop(rx_portb);
 	rte_eth_dev_stop(rxtx_portc);
@@ -0,0 +1,256 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_ring.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+#include <rte_eth_ring.h>
+#include <rte_power_pmd_mgmt.h>
+
+#include "test.h"
+
+#define PMGMT_RING_SIZE 64
+#define PMGMT_NB_QUEUES 2
+
+static int pmgmt_port = -1;
+
+static int
+pmgmt_setup(void)
+{
+	struct rte_ring *rings[PMGMT_NB_QUEUES];
+	struct rte_mempool *mp;
+	struct rte_eth_conf null_conf;
+	char name[RTE_RING_NAMESIZE];
+	uint16_t q;
+
+	if (pmgmt_port >= 0)
+		return 0;
+
+	mp = rte_pktmbuf_pool_create("PMGMT_POOL", PMGMT_RING_SIZE - 1, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	if (mp == NULL)
+		return -1;
+
+	for (q = 0; q < PMGMT_NB_QUEUES; q++) {
+		snprintf(name, sizeof(name), "PMGMT_R%u", q);
+		rings[q] = rte_ring_create(name, PMGMT_RING_SIZE,
+			rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (rings[q] == NULL)
+			return -1;
+	}
+
+	pmgmt_port = rte_eth_from_rings("eth_pmgmt", rings, PMGMT_NB_QUEUES,
+		rings, PMGMT_NB_QUEUES, rte_socket_id());
+	if (pmgmt_port < 0)
+		return -1;
+
+	memset(&null_conf, 0, sizeof(null_conf));
+	if (rte_eth_dev_configure(pmgmt_port, PMGMT_NB_QUEUES,
+			PMGMT_NB_QUEUES, &null_conf) < 0)
+		return -1;
+	for (q = 0; q < PMGMT_NB_QUEUES; q++) {
+		if (rte_eth_rx_queue_setup(pmgmt_port, q, PMGMT_RING_SIZE,
+				rte_socket_id(), NULL, mp) < 0 ||
+				rte_eth_tx_queue_setup(pmgmt_port, q,
+				PMGMT_RING_SIZE, rte_socket_id(), NULL) < 0)
+			return -1;
+	}
+	return rte_eth_dev_start(pmgmt_port);
+}
+
+/* poll a queue, after sending a packet to it if requested */
+static uint16_t
+pmgmt_poll(uint16_t queue_id, int send)
+{
+	struct rte_mbuf buf, *pbuf = &buf;
+
+	if (send && rte_eth_tx_burst(pmgmt_port, queue_id, &pbuf, 1) != 1)
+		return 0;
+	return rte_eth_rx_burst(pmgmt_port, queue_id, &pbuf, 1);
+}
+
+static int
+test_power_pmd_mgmt_states(void)
+{
+	struct rte_power_pmd_mgmt_conf conf = {
+		.pause_threshold = 4,
+		.pause_us = 1,
+		.sleep_threshold = 16,
+		.sleep_timeout_ms = 1,
+		.scale_threshold = 0,
+	};
+	struct rte_power_pmd_mgmt_stats stats;
+	unsigned lcore_id = rte_lcore_id();
+	unsigned i;
+
+	TEST_ASSERT_SUCCESS(pmgmt_setup(), "Cannot create ring port");
+	TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_set_conf(lcore_id, &conf),
+		"Cannot configure lcore");
+
+	TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_queue_enable(lcore_id,
+		pmgmt_port, 0), "Cannot enable queue");
+	TEST_ASSERT_EQUAL(rte_power_pmd_mgmt_queue_enable(lcore_id,
+		pmgmt_port, 0), -EEXIST, "Enabled a queue twice");
+	TEST_ASSERT_EQUAL(rte_power_pmd_mgmt_queue_enable(lcore_id,
+		pmgmt_port, PMGMT_NB_QUEUES), -EINVAL,
+		"Enabled an invalid queue");
+	rte_power_pmd_mgmt_stats_reset(lcore_id);
+
+	/* busy below the pause threshold */
+	for (i = 0; i < conf.pause_threshold - 1; i++)
+		pmgmt_poll(0, 0);
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT(rte_power_pmd_mgmt_get_state(lcore_id) ==
+		RTE_POWER_PMD_MGMT_BUSY && stats.pauses == 0 &&
+		stats.empty_polls == conf.pause_threshold - 1,
+		"Paused too early");
+
+	/* one pause per empty poll from the threshold */
+	for (; i < conf.pause_threshold + 5; i++)
+		pmgmt_poll(0, 0);
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT(rte_power_pmd_mgmt_get_state(lcore_id) ==
+		RTE_POWER_PMD_MGMT_PAUSE && stats.pauses == 6,
+		"Wrong pauses: %"PRIu64, stats.pauses);
+
+	/* the ring PMD has no RX interrupt, so it keeps pausing */
+	for (; i < conf.sleep_threshold * 2; i++)
+		pmgmt_poll(0, 0);
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT(rte_power_pmd_mgmt_get_state(lcore_id) ==
+		RTE_POWER_PMD_MGMT_PAUSE && stats.sleeps == 0 &&
+		stats.pauses == i - conf.pause_threshold + 1,
+		"Wrong fallback from sleep to pause");
+
+	/* a received packet makes the lcore busy again */
+	TEST_ASSERT_EQUAL(pmgmt_poll(0, 1), 1, "Cannot receive a packet");
+	TEST_ASSERT(rte_power_pmd_mgmt_get_state(lcore_id) ==
+		RTE_POWER_PMD_MGMT_BUSY, "Not busy after a packet");
+	pmgmt_poll(0, 0);
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT_EQUAL(stats.pauses, i - conf.pause_threshold + 1,
+		"Paused after a packet");
+
+	TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_queue_disable(lcore_id,
+		pmgmt_port, 0), "Cannot disable queue");
+	TEST_ASSERT_EQUAL(rte_power_pmd_mgmt_queue_disable(lcore_id,
+		pmgmt_port, 0), -EINVAL, "Disabled a queue twice");
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	pmgmt_poll(0, 0);
+	TEST_ASSERT_EQUAL(rte_power_pmd_mgmt_stats_get(lcore_id, &stats), 0,
+		"Cannot get stats");
+	TEST_ASSERT_EQUAL(stats.empty_polls, (uint64_t)conf.sleep_threshold
+		* 2 + 1, "Queue still managed after disable");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_power_pmd_mgmt_queues(void)
+{
+	struct rte_power_pmd_mgmt_conf conf = {
+		.pause_threshold = 2,
+		.pause_us = 1,
+		.sleep_threshold = 0,
+		.sleep_timeout_ms = 0,
+		/* not initialized with rte_power_init(), so it is disabled */
+		.scale_threshold = 2,
+	};
+	struct rte_power_pmd_mgmt_stats stats;
+	unsigned lcore_id = rte_lcore_id();
+	unsigned i;
+	uint16_t q;
+
+	TEST_ASSERT_SUCCESS(pmgmt_setup(), "Cannot create ring port");
+	TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_set_conf(lcore_id, &conf),
+		"Cannot configure lcore");
+	for (q = 0; q < PMGMT_NB_QUEUES; q++)
+		TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_queue_enable(lcore_id,
+			pmgmt_port, q), "Cannot enable queue %u", q);
+	rte_power_pmd_mgmt_stats_reset(lcore_id);
+
+	/* the lcore does not pause while a queue receives packets */
+	for (i = 0; i < 10; i++) {
+		pmgmt_poll(0, 0);
+		pmgmt_poll(1, 1);
+	}
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT(stats.pauses == 0 && stats.empty_polls == 10,
+		"Paused with a busy queue");
+
+	/* and pauses once all the queues are idle */
+	for (i = 0; i < 10; i++) {
+		pmgmt_poll(0, 0);
+		pmgmt_poll(1, 0);
+	}
+	rte_power_pmd_mgmt_stats_get(lcore_id, &stats);
+	TEST_ASSERT(stats.pauses > 0 && stats.scale_downs == 0,
+		"Wrong idle queues handling");
+
+	for (q = 0; q < PMGMT_NB_QUEUES; q++)
+		TEST_ASSERT_SUCCESS(rte_power_pmd_mgmt_queue_disable(lcore_id,
+			pmgmt_port, q), "Cannot disable queue %u", q);
+	rte_power_pmd_mgmt_set_conf(lcore_id, NULL);
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite power_pmd_mgmt_testsuite = {
+	.suite_name = "Power PMD Management Unit Test Suite",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_power_pmd_mgmt_states),
+		TEST_CASE(test_power_pmd_mgmt_queues),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_power_pmd_mgmt(void)
+{
+	return unit_test_suite_runner(&power_pmd_mgmt_testsuite);
+}
+
+static struct test_command power_pmd_mgmt_cmd = {
+	.command = "power_pmd_mgmt_autotest",
+	.callback = test_power_pmd_mgmt,
+};
+REGISTER_TEST_COMMAND(power_pmd_mgmt_cmd);
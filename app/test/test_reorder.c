@@ -89,9 +89,9 @@ test_reorder_init(void)
 	struct rte_reorder_buffer *b = NULL;
 	unsigned int size;
 	/*
-	 * The minimum memory area size that should be passed to library is,
-	 * sizeof(struct rte_reorder_buffer) + (2 * size * sizeof(struct rte_mbuf *));
-	 * Otherwise error will be thrown
+	 * The minimum memory area size that should be passed to library is
+	 * given by rte_reorder_memory_footprint_get(). Otherwise error will be
+	 * thrown
 	 */
 
 	size = 100;
@@ -116,6 +116,20 @@ test_reorder_init(void)
 			"No error on init with invalid name.");
 	rte_free(b);
 
+	size = rte_reorder_memory_footprint_get(REORDER_BUFFER_SIZE);
+	b = rte_malloc(NULL, size - 1, 0);
+	TEST_ASSERT_NOT_NULL(b, "Failed to allocate reorder buffer memory");
+	TEST_ASSERT((rte_reorder_init(b, size - 1, "PKT1",
+			REORDER_BUFFER_SIZE) == NULL) && (rte_errno == EINVAL),
+			"No error on init with too small mem zone size.");
+	rte_free(b);
+
+	b = rte_malloc(NULL, size, 0);
+	TEST_ASSERT_NOT_NULL(b, "Failed to allocate reorder buffer memory");
+	TEST_ASSERT_EQUAL(rte_reorder_init(b, size, "PKT1", REORDER_BUFFER_SIZE),
+			b, "Failed to init with footprint mem zone size.");
+	rte_free(b);
+
 	return 0;
 }
 
@@ -334,6 +348,281 @@ exit:
 	return ret;
 }
 
+static int
+test_reorder_insert_burst(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 128;
+	const unsigned int num_bufs = 100;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	int ret = 0;
+	unsigned i, cnt;
+
+	b = rte_reorder_create("test_insert_burst", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	ret = rte_mempool_get_bulk(p, (void *)bufs, num_bufs);
+	TEST_ASSERT_SUCCESS(ret, "Error getting mbuf from pool");
+
+	/* Insert the packets in reverse order, seqn 0 being the first one so
+	 * that it sets the start of the sequence */
+	bufs[0]->seqn = 0;
+	for (i = 1; i < num_bufs; i++)
+		bufs[i]->seqn = num_bufs - i;
+
+	cnt = rte_reorder_insert_burst(b, bufs, num_bufs);
+	if (cnt != num_bufs) {
+		printf("%s:%d:%d: number of expected packets not inserted\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != num_bufs) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	for (i = 0; i < num_bufs; i++) {
+		if (robufs[i]->seqn != i) {
+			printf("%s:%d: packet %u drained out of order, seqn %u\n",
+					__func__, __LINE__, i, robufs[i]->seqn);
+			ret = -1;
+			goto exit;
+		}
+	}
+
+	/* Insertion stops at the first packet out of range */
+	for (i = 0; i < num_bufs; i++)
+		bufs[i]->seqn = num_bufs + i;
+	bufs[10]->seqn = num_bufs + 4 * size;
+
+	cnt = rte_reorder_insert_burst(b, bufs, num_bufs);
+	if (cnt != 10 || rte_errno != ERANGE) {
+		printf("%s:%d:%d: insertion not stopped at late packet\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 10) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_mempool_put_bulk(p, (void *)bufs, num_bufs);
+	rte_reorder_free(b);
+	return ret;
+}
+
+static int
+test_reorder_drain_until(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 128;
+	const unsigned int num_bufs = 8;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	uint64_t tsc;
+	int ret = 0;
+	unsigned i, cnt;
+
+	b = rte_reorder_create("test_drain_until", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	ret = rte_mempool_get_bulk(p, (void *)bufs, num_bufs);
+	TEST_ASSERT_SUCCESS(ret, "Error getting mbuf from pool");
+
+	for (i = 0; i < num_bufs; i++)
+		bufs[i]->seqn = i;
+
+	/* Insert seqn 0, then 3 and 4 leaving a gap at 1 and 2:
+	 * OB[] = {NULL, NULL, 3, 4, NULL, ...}
+	 */
+	rte_reorder_insert(b, bufs[0]);
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 1) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	tsc = rte_rdtsc();
+	rte_reorder_insert_burst(b, &bufs[3], 2);
+
+	/* Deadline before the insertion, the gap holds the packets back */
+	cnt = rte_reorder_drain_until(b, robufs, num_bufs, tsc);
+	if (cnt != 0) {
+		printf("%s:%d:%d: packets drained before the deadline\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* Insert seqn 7 later, leaving gaps at 5 and 6 */
+	rte_delay_us(10);
+	tsc = rte_rdtsc();
+	rte_delay_us(10);
+	rte_reorder_insert_tsc(b, bufs[7], rte_rdtsc());
+
+	/* Deadline after the first insertion, only the first gap is skipped */
+	cnt = rte_reorder_drain_until(b, robufs, num_bufs, tsc);
+	if (cnt != 2 || robufs[0]->seqn != 3 || robufs[1]->seqn != 4) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* Late packet of the skipped gap can't be reordered anymore */
+	if (rte_reorder_insert(b, bufs[1]) != -1 || rte_errno != ERANGE) {
+		printf("%s:%d: No error inserting packet of skipped gap\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	cnt = rte_reorder_drain_until(b, robufs, num_bufs, rte_rdtsc());
+	if (cnt != 1 || robufs[0]->seqn != 7) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* Packets inserted without timestamp are held back by a gap */
+	bufs[6]->seqn = 9;
+	rte_reorder_insert(b, bufs[6]);
+	cnt = rte_reorder_drain_until(b, robufs, num_bufs, rte_rdtsc());
+	if (cnt != 0) {
+		printf("%s:%d:%d: packets without timestamp drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	bufs[5]->seqn = 8;
+	rte_reorder_insert(b, bufs[5]);
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 2 || robufs[0]->seqn != 8 || robufs[1]->seqn != 9) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_mempool_put_bulk(p, (void *)bufs, num_bufs);
+	rte_reorder_free(b);
+	return ret;
+}
+
+static int
+test_reorder_mp(void)
+{
+	struct rte_reorder_mp_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 8;
+	const unsigned int num_bufs = 12;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	int ret = 0;
+	unsigned i, cnt;
+
+	b = rte_reorder_mp_create("test_mp", rte_socket_id(), size - 1);
+	TEST_ASSERT((b == NULL) && (rte_errno == EINVAL),
+			"No error on create() with invalid buffer size param.");
+
+	b = rte_reorder_mp_create("test_mp", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	ret = rte_mempool_get_bulk(p, (void *)bufs, num_bufs);
+	TEST_ASSERT_SUCCESS(ret, "Error getting mbuf from pool");
+
+	for (i = 0; i < num_bufs; i++)
+		bufs[i]->seqn = i;
+
+	/* Insert seqn 1 to 7, then 0 which releases the whole window */
+	cnt = rte_reorder_mp_insert_burst(b, &bufs[1], size - 1);
+	if (cnt != size - 1) {
+		printf("%s:%d:%d: number of expected packets not inserted\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	cnt = rte_reorder_mp_drain(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d:%d: packets drained with missing seqn 0\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* Packet ahead of the window */
+	if (rte_reorder_mp_insert(b, bufs[size]) != -1 || rte_errno != ENOSPC) {
+		printf("%s:%d: No error inserting packet ahead of window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	rte_reorder_mp_insert(b, bufs[0]);
+	cnt = rte_reorder_mp_drain(b, robufs, num_bufs);
+	if (cnt != size) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		if (robufs[i]->seqn != i) {
+			printf("%s:%d: packet %u drained out of order, seqn %u\n",
+					__func__, __LINE__, i, robufs[i]->seqn);
+			ret = -1;
+			goto exit;
+		}
+	}
+
+	/* Packet behind the window */
+	if (rte_reorder_mp_insert(b, bufs[0]) != -1 || rte_errno != ERANGE) {
+		printf("%s:%d: No error inserting packet behind window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* A gap at seqn 8 is skipped once seqn 9 is older than deadline */
+	rte_reorder_mp_insert(b, bufs[9]);
+	rte_delay_us(10);
+	cnt = rte_reorder_mp_drain_until(b, robufs, num_bufs, rte_rdtsc());
+	if (cnt != 1 || robufs[0]->seqn != 9) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_mempool_put_bulk(p, (void *)bufs, num_bufs);
+	rte_reorder_mp_free(b);
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -373,6 +662,9 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_insert_burst),
+		TEST_CASE(test_reorder_drain_until),
+		TEST_CASE(test_reorder_mp),
 		TEST_CASES_END()
 	}
 };
@@ -174,9 +174,21 @@ test_sched(void)
 	err = rte_sched_port_enqueue(port, in_mbufs, 10);
 	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
 
+	uint32_t tc_qlen[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+	err = rte_sched_subport_read_qlen(port, SUBPORT, tc_qlen);
+	TEST_ASSERT_SUCCESS(err, "Error reading subport qlen, err=%d\n", err);
+	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+		TEST_ASSERT_EQUAL(tc_qlen[i], (i == TC ? 10U : 0U),
+			"Wrong qlen of traffic class %d\n", i);
+	err = rte_sched_subport_read_qlen(port, SUBPORT + 1, tc_qlen);
+	TEST_ASSERT(err != 0, "Read qlen of an invalid subport\n");
+
 	err = rte_sched_port_dequeue(port, out_mbufs, 10);
 	TEST_ASSERT_EQUAL(err, 10, "Wrong dequeue, err=%d\n", err);
 
+	err = rte_sched_subport_read_qlen(port, SUBPORT, tc_qlen);
+	TEST_ASSERT(err == 0 && tc_qlen[TC] == 0, "Wrong qlen after dequeue\n");
+
 	for (i = 0; i < 10; i++) {
 		enum rte_meter_color color;
 		uint32_t subport, traffic_class, queue;
@@ -0,0 +1,308 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_cycles.h>
+#include <rte_memory.h>
+#include <rte_service.h>
+#include <rte_timer.h>
+
+#include "test.h"
+
+#define SERVICE_NAME "service_autotest"
+#define SERVICE_TIMEOUT_MS 1000
+
+static uint32_t service_id;
+static volatile uint64_t service_calls;
+static volatile int service_hold;
+static volatile int service_holding;
+
+static int32_t
+service_func(__attribute__((unused)) void *args)
+{
+	service_calls++;
+	/* keep the service busy, to check that calls are serialized */
+	while (service_hold) {
+		service_holding = 1;
+		rte_pause();
+	}
+	service_holding = 0;
+	return 0;
+}
+
+static void
+timer_cb(__attribute__((unused)) struct rte_timer *tim,
+		__attribute__((unused)) void *arg)
+{
+}
+
+static int
+service_setup(void)
+{
+	struct rte_service_spec spec;
+
+	memset(&spec, 0, sizeof(spec));
+	snprintf(spec.name, sizeof(spec.name), SERVICE_NAME);
+	spec.callback = service_func;
+	spec.socket_id = SOCKET_ID_ANY;
+
+	service_calls = 0;
+	service_hold = 0;
+	return rte_service_register(&spec, &service_id);
+}
+
+static void
+service_teardown(void)
+{
+	rte_service_unregister(service_id);
+}
+
+static int
+wait_service_calls(uint64_t calls)
+{
+	uint64_t end = rte_get_timer_cycles() +
+		rte_get_timer_hz() * SERVICE_TIMEOUT_MS / 1000;
+
+	while (service_calls < calls) {
+		if (rte_get_timer_cycles() > end)
+			return -1;
+		rte_pause();
+	}
+	return 0;
+}
+
+static int
+test_service_register(void)
+{
+	struct rte_service_spec spec;
+	uint32_t id;
+
+	memset(&spec, 0, sizeof(spec));
+	TEST_ASSERT_EQUAL(rte_service_register(&spec, &id), -EINVAL,
+		"Registered a service without name nor function");
+	snprintf(spec.name, sizeof(spec.name), SERVICE_NAME);
+	TEST_ASSERT_EQUAL(rte_service_register(&spec, &id), -EINVAL,
+		"Registered a service without function");
+	spec.callback = service_func;
+	TEST_ASSERT_EQUAL(rte_service_register(&spec, &id), -EEXIST,
+		"Registered a service twice");
+
+	TEST_ASSERT_SUCCESS(rte_service_get_by_name(SERVICE_NAME, &id),
+		"Cannot find service by name");
+	TEST_ASSERT_EQUAL(id, service_id, "Wrong service found by name");
+	TEST_ASSERT(strcmp(rte_service_get_name(id), SERVICE_NAME) == 0,
+		"Wrong service name");
+	TEST_ASSERT_EQUAL(rte_service_get_by_name("unknown", &id), -ENODEV,
+		"Found an unknown service");
+	TEST_ASSERT(rte_service_count() >= 1, "Service not counted");
+
+	TEST_ASSERT_SUCCESS(rte_service_unregister(service_id),
+		"Cannot unregister service");
+	TEST_ASSERT_EQUAL(rte_service_unregister(service_id), -EINVAL,
+		"Unregistered a service twice");
+	TEST_ASSERT(rte_service_get_name(service_id) == NULL,
+		"Unregistered service still has a name");
+
+	return service_setup();
+}
+
+/* call the service from a thread unknown to the EAL */
+static void *
+app_thread_func(__attribute__((unused)) void *arg)
+{
+	uintptr_t ret = rte_service_run_iter_on_app_lcore(service_id);
+
+	return (void *)ret;
+}
+
+static int
+test_service_app_lcore(void)
+{
+	pthread_t thread;
+	void *ret;
+	struct rte_service_stats stats;
+
+	TEST_ASSERT_EQUAL(rte_service_runstate_get(service_id), 0,
+		"Service not stopped after registration");
+	TEST_ASSERT_EQUAL(rte_service_run_iter_on_app_lcore(service_id),
+		-ENOEXEC, "Stopped service was called");
+
+	TEST_ASSERT_SUCCESS(rte_service_runstate_set(service_id, 1),
+		"Cannot start service");
+	TEST_ASSERT_SUCCESS(rte_service_run_iter_on_app_lcore(service_id),
+		"Cannot call service");
+	TEST_ASSERT_EQUAL(service_calls, 1, "Service function not called");
+
+	TEST_ASSERT_SUCCESS(rte_service_stats_get(service_id, &stats),
+		"Cannot get service stats");
+	TEST_ASSERT_EQUAL(stats.calls, 1, "Wrong number of calls");
+	TEST_ASSERT_EQUAL(stats.cycles, 0, "Cycles counted while disabled");
+
+	TEST_ASSERT_SUCCESS(rte_service_set_stats_enable(service_id, 1),
+		"Cannot enable service stats");
+	TEST_ASSERT_SUCCESS(rte_service_run_iter_on_app_lcore(service_id),
+		"Cannot call service");
+	rte_service_stats_get(service_id, &stats);
+	TEST_ASSERT_EQUAL(stats.calls, 2, "Wrong number of calls");
+	TEST_ASSERT(stats.cycles > 0, "Cycles not counted");
+
+	TEST_ASSERT_SUCCESS(pthread_create(&thread, NULL, app_thread_func,
+		NULL), "Cannot create non-EAL thread");
+	pthread_join(thread, &ret);
+	TEST_ASSERT(ret == NULL, "Cannot call service from non-EAL thread");
+	rte_service_stats_get(service_id, &stats);
+	TEST_ASSERT_EQUAL(stats.calls, 3,
+		"Wrong number of calls from non-EAL thread");
+
+	TEST_ASSERT_SUCCESS(rte_service_stats_reset(service_id),
+		"Cannot reset service stats");
+	rte_service_stats_get(service_id, &stats);
+	TEST_ASSERT_EQUAL(stats.calls, 0, "Stats not reset");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_service_lcore(void)
+{
+	unsigned lcore_id = rte_get_next_lcore(-1, 1, 0);
+	unsigned lcore_count = rte_lcore_count();
+	uint32_t list[RTE_MAX_LCORE];
+	struct rte_timer tim;
+	uint64_t calls;
+
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Service lcore test needs at least 2 lcores, skipping\n");
+		return TEST_SUCCESS;
+	}
+
+	TEST_ASSERT_EQUAL(rte_service_map_lcore_set(service_id, lcore_id, 1),
+		-EINVAL, "Mapped a service to a slave lcore");
+	TEST_ASSERT_EQUAL(rte_service_lcore_add(rte_get_master_lcore()),
+		-EINVAL, "Master lcore became a service lcore");
+
+	TEST_ASSERT_SUCCESS(rte_service_lcore_add(lcore_id),
+		"Cannot add service lcore");
+	TEST_ASSERT_EQUAL(rte_service_lcore_add(lcore_id), -EALREADY,
+		"Added a service lcore twice");
+	TEST_ASSERT(!rte_lcore_is_enabled(lcore_id),
+		"Service lcore is still an application lcore");
+	TEST_ASSERT_EQUAL(rte_lcore_count(), lcore_count - 1,
+		"Service lcore still counted");
+
+	/* a timer service can have timers armed on its own lcore */
+	rte_timer_subsystem_init();
+	rte_timer_init(&tim);
+	TEST_ASSERT_SUCCESS(rte_timer_reset(&tim, rte_get_timer_hz(), SINGLE,
+		lcore_id, timer_cb, NULL),
+		"Cannot arm a timer on a service lcore");
+	rte_timer_stop_sync(&tim);
+	TEST_ASSERT(rte_service_lcore_list(list, RTE_DIM(list)) >= 1,
+		"Service lcore not listed");
+
+	TEST_ASSERT_SUCCESS(rte_service_map_lcore_set(service_id, lcore_id, 1),
+		"Cannot map service");
+	TEST_ASSERT_EQUAL(rte_service_map_lcore_get(service_id, lcore_id), 1,
+		"Service not mapped");
+	TEST_ASSERT_SUCCESS(rte_service_runstate_set(service_id, 1),
+		"Cannot start service");
+	TEST_ASSERT_SUCCESS(rte_service_lcore_start(lcore_id),
+		"Cannot start service lcore");
+	TEST_ASSERT_EQUAL(rte_service_lcore_start(lcore_id), -EALREADY,
+		"Started a service lcore twice");
+	TEST_ASSERT_SUCCESS(wait_service_calls(service_calls + 10),
+		"Service not called by service lcore");
+
+	/* the service is not MT safe: it cannot run on two lcores */
+	service_hold = 1;
+	while (!service_holding)
+		rte_pause();
+	TEST_ASSERT_EQUAL(rte_service_run_iter_on_app_lcore(service_id),
+		-EBUSY, "Service called while running on another lcore");
+	service_hold = 0;
+
+	/* a stopped service is no longer called */
+	TEST_ASSERT_SUCCESS(rte_service_runstate_set(service_id, 0),
+		"Cannot stop service");
+	rte_delay_ms(10);
+	calls = service_calls;
+	rte_delay_ms(10);
+	TEST_ASSERT_EQUAL(service_calls, calls, "Stopped service called");
+
+	TEST_ASSERT_EQUAL(rte_service_lcore_del(lcore_id), -EBUSY,
+		"Removed a running service lcore");
+	TEST_ASSERT_SUCCESS(rte_service_lcore_stop(lcore_id),
+		"Cannot stop service lcore");
+	TEST_ASSERT_SUCCESS(rte_service_lcore_del(lcore_id),
+		"Cannot remove service lcore");
+	TEST_ASSERT(rte_lcore_is_enabled(lcore_id),
+		"Lcore not given back to the application");
+	TEST_ASSERT_EQUAL(rte_lcore_count(), lcore_count,
+		"Lcore count not restored");
+
+	rte_service_dump(stdout);
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite service_testsuite = {
+	.suite_name = "service core test suite",
+	.setup = service_setup,
+	.teardown = service_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_service_register),
+		TEST_CASE(test_service_app_lcore),
+		TEST_CASE(test_service_lcore),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_service(void)
+{
+	return unit_test_suite_runner(&service_testsuite);
+}
+
+static struct test_command service_cmd = {
+	.command = "service_autotest",
+	.callback = test_service,
+};
+REGISTER_TEST_COMMAND(service_cmd);
@@ -428,6 +428,81 @@ fail:
 	return -1;
 }
 
+static int
+check_pipeline_cycles(void)
+{
+	struct rte_pipeline_port_in_cycles port_cycles;
+	struct rte_pipeline_table_cycles table_cycles;
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	uint64_t n_pkts = N_PORTS;
+#else
+	uint64_t n_pkts = 0; /* cycles are not collected */
+#endif
+	int ret;
+
+	ret = rte_pipeline_port_in_cycles_read(p, 0, &port_cycles, 1);
+	if (ret != 0 || port_cycles.rx.n_pkts != n_pkts) {
+		RTE_LOG(INFO, PIPELINE, "%s: Wrong input port cycles\n",
+			__func__);
+		return -1;
+	}
+
+	ret = rte_pipeline_table_cycles_read(p, 0, &table_cycles, 1);
+	if (ret != 0 || (table_cycles.lookup.n_bursts == 0) != (n_pkts == 0)) {
+		RTE_LOG(INFO, PIPELINE, "%s: Wrong table cycles\n", __func__);
+		return -1;
+	}
+
+	ret = rte_pipeline_table_cycles_read(p, 0, &table_cycles, 0);
+	if (ret != 0 || table_cycles.lookup.n_bursts != 0) {
+		RTE_LOG(INFO, PIPELINE, "%s: Table cycles not cleared\n",
+			__func__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_pipeline_cycles_hist(void)
+{
+	struct rte_pipeline_cycles c;
+	uint64_t cycles;
+	uint32_t bucket;
+
+	/* Each value is within the bounds of its bucket */
+	for (cycles = 0; cycles < (1ULL << 20); cycles += 1 + cycles / 64) {
+		bucket = rte_pipeline_cycles_bucket(cycles);
+		if (rte_pipeline_cycles_bucket_min(bucket) > cycles ||
+			(bucket < RTE_PIPELINE_CYCLES_HIST_SIZE - 1 &&
+			rte_pipeline_cycles_bucket_min(bucket + 1) <= cycles)) {
+			RTE_LOG(INFO, PIPELINE,
+				"%s: Wrong bucket %u for %" PRIu64 " cycles\n",
+				__func__, bucket, cycles);
+			return -1;
+		}
+	}
+	if (rte_pipeline_cycles_bucket(UINT64_MAX) !=
+			RTE_PIPELINE_CYCLES_HIST_SIZE - 1)
+		return -1;
+
+	/* 90 bursts of 100 cycles and 10 bursts of 1000 cycles */
+	memset(&c, 0, sizeof(c));
+	c.n_bursts = 100;
+	c.cycles_max = 1000;
+	c.hist[rte_pipeline_cycles_bucket(100)] = 90;
+	c.hist[rte_pipeline_cycles_bucket(1000)] = 10;
+	if (rte_pipeline_cycles_percentile(&c, 50) < 100 ||
+		rte_pipeline_cycles_percentile(&c, 50) >= 128 ||
+		rte_pipeline_cycles_percentile(&c, 95) < 1000 ||
+		rte_pipeline_cycles_percentile(&c, 100) != 1000) {
+		RTE_LOG(INFO, PIPELINE, "%s: Wrong percentiles\n", __func__);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_pipeline_single_filter(int test_type, int expected_count)
 {
@@ -519,6 +594,9 @@ test_pipeline_single_filter(int test_type, int expected_count)
 		goto fail;
 	}
 
+	if (check_pipeline_cycles() < 0)
+		goto fail;
+
 	cleanup_pipeline();
 
 	return 0;
@@ -530,6 +608,9 @@ fail:
 int
 test_table_pipeline(void)
 {
+	if (test_pipeline_cycles_hist() < 0)
+		return -1;
+
 	/* TEST - All packets dropped */
 	action_handler_hit = NULL;
 	action_handler_miss = NULL;
@@ -0,0 +1,215 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_cycles.h>
+#include <rte_trace.h>
+
+#include "test.h"
+
+#define TRACE_SLAVE_RECORDS 100
+#define TRACE_PERF_ITER 100000
+
+static struct rte_trace_record recs[RTE_TRACE_BUFFER_SIZE];
+static uint16_t id_a, id_b;
+
+static int
+trace_slave(__attribute__((unused)) void *arg)
+{
+	unsigned i;
+
+	for (i = 0; i < TRACE_SLAVE_RECORDS; i++)
+		RTE_TRACE(DEBUG, id_b, rte_lcore_id(), i);
+	return 0;
+}
+
+static int
+test_trace_register(void)
+{
+	uint16_t id;
+
+	TEST_ASSERT_EQUAL(rte_trace_register("", &id), -EINVAL,
+		"Registered an empty name");
+	TEST_ASSERT_EQUAL(rte_trace_register("bad\"name", &id), -EINVAL,
+		"Registered an invalid name");
+	TEST_ASSERT_SUCCESS(rte_trace_register("test.a", &id_a),
+		"Cannot register tracepoint");
+	TEST_ASSERT_SUCCESS(rte_trace_register("test.b", &id_b),
+		"Cannot register tracepoint");
+	TEST_ASSERT(id_a != id_b, "Same identifier for two tracepoints");
+	TEST_ASSERT_SUCCESS(rte_trace_register("test.a", &id),
+		"Cannot register tracepoint again");
+	TEST_ASSERT_EQUAL(id, id_a, "Wrong identifier on second registration");
+	TEST_ASSERT(strcmp(rte_trace_get_name(id_a), "test.a") == 0,
+		"Wrong tracepoint name");
+	TEST_ASSERT(!rte_trace_is_enabled(id_a),
+		"Tracepoint enabled at registration");
+	return TEST_SUCCESS;
+}
+
+static int
+test_trace_master(void)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned i, n;
+
+	rte_trace_reset();
+	RTE_TRACE(DEBUG, id_a, 1, 2);
+	TEST_ASSERT_EQUAL(rte_trace_read(lcore_id, recs, RTE_DIM(recs)), 0,
+		"Disabled tracepoint recorded");
+
+	TEST_ASSERT_SUCCESS(rte_trace_set_enable(id_a, 1),
+		"Cannot enable tracepoint");
+	for (i = 0; i < 10; i++)
+		RTE_TRACE(DEBUG, id_a, i, ~i);
+	n = rte_trace_read(lcore_id, recs, RTE_DIM(recs));
+	TEST_ASSERT_EQUAL(n, 10, "Wrong number of records");
+	for (i = 0; i < n; i++) {
+		TEST_ASSERT(recs[i].id == id_a && recs[i].lcore_id == lcore_id,
+			"Wrong record header");
+		TEST_ASSERT(recs[i].arg0 == i && recs[i].arg1 == (uint64_t)~i,
+			"Wrong record arguments");
+		TEST_ASSERT(i == 0 || recs[i].tsc >= recs[i - 1].tsc,
+			"Records not in order");
+	}
+	n = rte_trace_read(lcore_id, recs, 4);
+	TEST_ASSERT(n == 4 && recs[0].arg0 == 6, "Latest records not read");
+
+	/* the oldest records are overwritten */
+	rte_trace_reset();
+	for (i = 0; i < RTE_TRACE_BUFFER_SIZE + 10; i++)
+		RTE_TRACE(DEBUG, id_a, i, 0);
+	n = rte_trace_read(lcore_id, recs, RTE_DIM(recs));
+	TEST_ASSERT_EQUAL(n, RTE_TRACE_BUFFER_SIZE, "Buffer not full");
+	TEST_ASSERT_EQUAL(recs[0].arg0, 10, "Wrong oldest record");
+
+	TEST_ASSERT_SUCCESS(rte_trace_set_enable(id_a, 0),
+		"Cannot disable tracepoint");
+	rte_trace_reset();
+	return TEST_SUCCESS;
+}
+
+static int
+test_trace_slave(void)
+{
+	unsigned lcore_id = rte_get_next_lcore(-1, 1, 0);
+	FILE *f;
+	unsigned i, n;
+	int nb_events;
+
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Slave lcore test needs at least 2 lcores, skipping\n");
+		return TEST_SUCCESS;
+	}
+
+	TEST_ASSERT_EQUAL(rte_trace_set_enable_pattern("test.*", 1), 2,
+		"Wrong number of tracepoints enabled");
+	RTE_TRACE(INFO, id_a, 0, 0);
+	rte_eal_remote_launch(trace_slave, NULL, lcore_id);
+	rte_eal_wait_lcore(lcore_id);
+	rte_trace_set_enable_pattern("test.*", 0);
+
+	n = rte_trace_read(lcore_id, recs, RTE_DIM(recs));
+	TEST_ASSERT_EQUAL(n, TRACE_SLAVE_RECORDS, "Wrong number of records");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(recs[i].id == id_b && recs[i].arg0 == lcore_id &&
+			recs[i].arg1 == i, "Wrong slave record");
+
+	f = tmpfile();
+	TEST_ASSERT_NOT_NULL(f, "Cannot create temporary file");
+	nb_events = rte_trace_dump_json(f);
+	fclose(f);
+	/* a thread name and the records of each lcore */
+	TEST_ASSERT_EQUAL(nb_events, 2 + 1 + TRACE_SLAVE_RECORDS,
+		"Wrong number of trace events");
+
+	rte_trace_reset();
+	return TEST_SUCCESS;
+}
+
+static int
+test_trace_perf(void)
+{
+	uint64_t start, disabled, enabled;
+	unsigned i;
+
+	start = rte_rdtsc();
+	for (i = 0; i < TRACE_PERF_ITER; i++)
+		RTE_TRACE(DEBUG, id_a, i, 0);
+	disabled = rte_rdtsc() - start;
+
+	rte_trace_set_enable(id_a, 1);
+	start = rte_rdtsc();
+	for (i = 0; i < TRACE_PERF_ITER; i++)
+		RTE_TRACE(DEBUG, id_a, i, 0);
+	enabled = rte_rdtsc() - start;
+	rte_trace_set_enable(id_a, 0);
+	rte_trace_reset();
+
+	printf("Tracepoint cost: %.1f cycles disabled, %.1f cycles enabled\n",
+		(double)disabled / TRACE_PERF_ITER,
+		(double)enabled / TRACE_PERF_ITER);
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite trace_testsuite = {
+	.suite_name = "trace buffers test suite",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_trace_register),
+		TEST_CASE(test_trace_master),
+		TEST_CASE(test_trace_slave),
+		TEST_CASE(test_trace_perf),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_trace(void)
+{
+	return unit_test_suite_runner(&trace_testsuite);
+}
+
+static struct test_command trace_cmd = {
+	.command = "trace_autotest",
+	.callback = test_trace,
+};
+REGISTER_TEST_COMMAND(trace_cmd);
@@ -519,7 +519,9 @@ get_number_of_sockets(void)
 	int i;
 	const struct rte_memseg *ms = rte_eal_get_physmem_layout();
 
-	for (i = 0; i < RTE_MAX_MEMSEG && ms[i].addr != NULL; i++) {
+	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
+		if (ms[i].addr == NULL)
+			continue;
 		if (sockets < ms[i].socket_id)
 			sockets = ms[i].socket_id;
 	}
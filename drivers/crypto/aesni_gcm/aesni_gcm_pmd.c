@@ -40,6 +40,8 @@
 #include <rte_dev.h>
 #include <rte_malloc.h>
 #include <rte_cpuflags.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 
 #include "aesni_gcm_pmd_private.h"
 
@@ -199,11 +201,24 @@ aesni_gcm_get_session(struct aesni_gcm_qp *qp, struct rte_crypto_sym_op *op)
 				sess, op->xform) != 0)) {
 			rte_mempool_put(qp->sess_mp, _sess);
 			sess = NULL;
+		} else {
+			/* Attached until the operation completes */
+			op->session = _sess;
 		}
 	}
 	return sess;
 }
 
+/** Return the session of a session-less operation to the session mempool */
+static inline void
+put_session(struct aesni_gcm_qp *qp, struct rte_crypto_op *op)
+{
+	if (op->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
+		rte_mempool_put(qp->sess_mp, op->sym->session);
+		op->sym->session = NULL;
+	}
+}
+
 /**
  * Process a crypto operation and complete a JOB_AES_HMAC job structure for
  * submission to the multi buffer library for processing.
@@ -219,15 +234,37 @@ static int
 process_gcm_crypto_op(struct aesni_gcm_qp *qp, struct rte_crypto_sym_op *op,
 		struct aesni_gcm_session *session)
 {
-	uint8_t *src, *dst;
+	const uint8_t *src;
+	uint8_t *dst;
 	struct rte_mbuf *m = op->m_src;
+	struct rte_mbuf *m_dst = op->m_dst ? op->m_dst : m;
+	uint32_t offset = op->cipher.data.offset;
+	uint32_t length = op->cipher.data.length;
+
+	if (unlikely(length > AESNI_GCM_SGL_BUF_SIZE)) {
+		GCM_LOG_ERR("data length");
+		return -1;
+	}
+
+	/*
+	 * Data spanning several segments of chained mbufs is gathered in the
+	 * queue pair buffer, which is then also used as output and scattered
+	 * back into the destination mbuf
+	 */
+	src = rte_pktmbuf_read(m, offset, length, qp->sgl_buf);
+	if (src == NULL) {
+		GCM_LOG_ERR("data length");
+		return -1;
+	}
 
-	src = rte_pktmbuf_mtod(m, uint8_t *) + op->cipher.data.offset;
-	dst = op->m_dst ?
-			rte_pktmbuf_mtod_offset(op->m_dst, uint8_t *,
-					op->cipher.data.offset) :
-			rte_pktmbuf_mtod_offset(m, uint8_t *,
-					op->cipher.data.offset);
+	if (likely(offset + length <= rte_pktmbuf_data_len(m_dst)))
+		dst = rte_pktmbuf_mtod_offset(m_dst, uint8_t *, offset);
+	else if (offset + length <= rte_pktmbuf_pkt_len(m_dst))
+		dst = qp->sgl_buf;
+	else {
+		GCM_LOG_ERR("data length");
+		return -1;
+	}
 
 	/* sanity checks */
 	if (op->cipher.iv.length != 16 && op->cipher.iv.length != 0) {
@@ -279,6 +316,9 @@ process_gcm_crypto_op(struct aesni_gcm_qp *qp, struct rte_crypto_sym_op *op,
 		return -1;
 	}
 
+	if (unlikely(dst == qp->sgl_buf))
+		rte_pktmbuf_write(m_dst, offset, length, dst);
+
 	return 0;
 }
 
@@ -305,8 +345,10 @@ post_process_gcm_crypto_op(struct rte_crypto_op *op)
 	/* Verify digest if required */
 	if (session->op == AESNI_GCM_OP_AUTHENTICATED_DECRYPTION) {
 
-		uint8_t *tag = rte_pktmbuf_mtod_offset(m, uint8_t *,
-				m->data_len - op->sym->auth.digest.length);
+		/* the tag is appended to the last segment of chained mbufs */
+		struct rte_mbuf *m_last = rte_pktmbuf_lastseg(m);
+		uint8_t *tag = rte_pktmbuf_mtod_offset(m_last, uint8_t *,
+				m_last->data_len - op->sym->auth.digest.length);
 
 #ifdef RTE_LIBRTE_PMD_AESNI_GCM_DEBUG
 		rte_hexdump(stdout, "auth tag (orig):",
@@ -340,10 +382,7 @@ handle_completed_gcm_crypto_op(struct aesni_gcm_qp *qp,
 	post_process_gcm_crypto_op(op);
 
 	/* Free session if a session-less crypto op */
-	if (op->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
-		rte_mempool_put(qp->sess_mp, op->sym->session);
-		op->sym->session = NULL;
-	}
+	put_session(qp, op);
 
 	rte_ring_enqueue(qp->processed_pkts, (void *)op);
 }
@@ -370,6 +409,7 @@ aesni_gcm_pmd_enqueue_burst(void *queue_pair,
 		if (retval < 0) {
 			ops[i]->status = RTE_CRYPTO_OP_STATUS_INVALID_ARGS;
 			qp->qp_stats.enqueue_err_count++;
+			put_session(qp, ops[i]);
 			break;
 		}
 
@@ -395,6 +435,149 @@ aesni_gcm_pmd_dequeue_burst(void *queue_pair,
 	return nb_dequeued;
 }
 
+/**
+ * Enqueue burst used when the device has dedicated workers, operations are
+ * only handed over to the worker serving the queue pair.
+ */
+static uint16_t
+aesni_gcm_pmd_enqueue_burst_worker(void *queue_pair,
+		struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	struct aesni_gcm_qp *qp = queue_pair;
+
+	return rte_ring_enqueue_burst(qp->ingress_pkts, (void **)ops, nb_ops);
+}
+
+/**
+ * Process the operations pending on a queue pair ingress ring. Operations
+ * which can't be processed are returned with an error status.
+ *
+ * @return
+ * - Number of operations taken from the queue pair
+ */
+static unsigned
+aesni_gcm_worker_process_qp(struct aesni_gcm_qp *qp)
+{
+	struct rte_crypto_op *ops[AESNI_GCM_WORKER_BURST_SIZE];
+	struct aesni_gcm_session *sess;
+	unsigned i, nb_ops, room;
+
+	/* Never take more operations than can be returned */
+	room = RTE_MIN(rte_ring_free_count(qp->processed_pkts),
+			(unsigned)AESNI_GCM_WORKER_BURST_SIZE);
+
+	nb_ops = rte_ring_dequeue_burst(qp->ingress_pkts, (void **)ops, room);
+
+	for (i = 0; i < nb_ops; i++) {
+		sess = aesni_gcm_get_session(qp, ops[i]->sym);
+		if (unlikely(sess == NULL ||
+				process_gcm_crypto_op(qp, ops[i]->sym,
+						sess) < 0)) {
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_INVALID_ARGS;
+			qp->qp_stats.enqueue_err_count++;
+			if (sess != NULL)
+				put_session(qp, ops[i]);
+			rte_ring_enqueue(qp->processed_pkts, (void *)ops[i]);
+			continue;
+		}
+
+		handle_completed_gcm_crypto_op(qp, ops[i]);
+
+		qp->qp_stats.enqueued_count++;
+	}
+
+	return nb_ops;
+}
+
+/** Worker main loop, polling all queue pairs served by the worker */
+static int
+aesni_gcm_worker_loop(void *arg)
+{
+	struct aesni_gcm_worker *worker = arg;
+	struct rte_cryptodev *dev = worker->dev;
+	struct aesni_gcm_private *internals = dev->data->dev_private;
+	unsigned qp_id;
+
+	while (worker->running) {
+		for (qp_id = worker->id; qp_id < dev->data->nb_queue_pairs;
+				qp_id += internals->nb_workers) {
+			struct aesni_gcm_qp *qp = dev->data->queue_pairs[qp_id];
+
+			if (qp != NULL)
+				aesni_gcm_worker_process_qp(qp);
+		}
+	}
+
+	return 0;
+}
+
+int
+aesni_gcm_workers_start(struct rte_cryptodev *dev)
+{
+	struct aesni_gcm_private *internals = dev->data->dev_private;
+	struct aesni_gcm_worker *worker;
+	unsigned i;
+
+	for (i = 0; i < internals->nb_workers; i++) {
+		worker = &internals->workers[i];
+
+		if (worker->lcore_id == rte_get_master_lcore() ||
+				!rte_lcore_is_enabled(worker->lcore_id) ||
+				rte_eal_get_lcore_state(worker->lcore_id) !=
+						WAIT) {
+			GCM_LOG_ERR("worker lcore %u is not available",
+					worker->lcore_id);
+			goto start_error;
+		}
+
+		worker->dev = dev;
+		worker->running = 1;
+		if (rte_eal_remote_launch(aesni_gcm_worker_loop, worker,
+				worker->lcore_id) != 0) {
+			worker->running = 0;
+			GCM_LOG_ERR("failed to launch worker on lcore %u",
+					worker->lcore_id);
+			goto start_error;
+		}
+	}
+
+	return 0;
+
+start_error:
+	aesni_gcm_workers_stop(dev);
+	return -EBUSY;
+}
+
+void
+aesni_gcm_workers_stop(struct rte_cryptodev *dev)
+{
+	struct aesni_gcm_private *internals = dev->data->dev_private;
+	struct aesni_gcm_worker *worker;
+	unsigned i;
+
+	for (i = 0; i < internals->nb_workers; i++) {
+		worker = &internals->workers[i];
+
+		if (!worker->running)
+			continue;
+
+		worker->running = 0;
+		rte_eal_wait_lcore(worker->lcore_id);
+	}
+}
+
+/** Free the dedicated workers of a device, they must be stopped */
+static void
+aesni_gcm_workers_free(struct aesni_gcm_private *internals)
+{
+	if (internals->workers == NULL)
+		return;
+
+	rte_free(internals->workers);
+	internals->workers = NULL;
+	internals->nb_workers = 0;
+}
+
 static int aesni_gcm_uninit(const char *name);
 
 static int
@@ -444,11 +627,15 @@ aesni_gcm_create(const char *name,
 
 	/* register rx/tx burst functions for data path */
 	dev->dequeue_burst = aesni_gcm_pmd_dequeue_burst;
-	dev->enqueue_burst = aesni_gcm_pmd_enqueue_burst;
+	if (init_params->nb_worker_lcores > 0)
+		dev->enqueue_burst = aesni_gcm_pmd_enqueue_burst_worker;
+	else
+		dev->enqueue_burst = aesni_gcm_pmd_enqueue_burst;
 
 	dev->feature_flags = RTE_CRYPTODEV_FF_SYMMETRIC_CRYPTO |
 			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
-			RTE_CRYPTODEV_FF_CPU_AESNI;
+			RTE_CRYPTODEV_FF_CPU_AESNI |
+			RTE_CRYPTODEV_FF_MBUF_SCATTER_GATHER;
 
 	switch (vector_mode) {
 	case RTE_AESNI_GCM_SSE:
@@ -472,6 +659,27 @@ aesni_gcm_create(const char *name,
 	internals->max_nb_queue_pairs = init_params->max_nb_queue_pairs;
 	internals->max_nb_sessions = init_params->max_nb_sessions;
 
+	/* Set up dedicated workers, they are launched on device start */
+	internals->nb_workers = init_params->nb_worker_lcores;
+	if (internals->nb_workers > 0) {
+		unsigned i;
+
+		internals->workers = rte_zmalloc_socket("AES-NI GCM PMD Workers",
+				internals->nb_workers *
+					sizeof(struct aesni_gcm_worker),
+				RTE_CACHE_LINE_SIZE, init_params->socket_id);
+		if (internals->workers == NULL) {
+			GCM_LOG_ERR("failed to allocate workers");
+			goto init_error;
+		}
+
+		for (i = 0; i < internals->nb_workers; i++) {
+			internals->workers[i].id = i;
+			internals->workers[i].lcore_id =
+					init_params->worker_lcores[i];
+		}
+	}
+
 	return 0;
 
 init_error:
@@ -485,9 +693,9 @@ static int
 aesni_gcm_init(const char *name, const char *input_args)
 {
 	struct rte_crypto_vdev_init_params init_params = {
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
-		rte_socket_id()
+		.max_nb_queue_pairs = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
+		.max_nb_sessions = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
+		.socket_id = rte_socket_id()
 	};
 
 	rte_cryptodev_parse_vdev_init_params(&init_params, input_args);
@@ -498,6 +706,8 @@ aesni_gcm_init(const char *name, const char *input_args)
 			init_params.max_nb_queue_pairs);
 	RTE_LOG(INFO, PMD, "  Max number of sessions = %d\n",
 			init_params.max_nb_sessions);
+	RTE_LOG(INFO, PMD, "  Number of worker lcores = %u\n",
+			init_params.nb_worker_lcores);
 
 	return aesni_gcm_create(name, &init_params);
 }
@@ -505,9 +715,17 @@ aesni_gcm_init(const char *name, const char *input_args)
 static int
 aesni_gcm_uninit(const char *name)
 {
+	struct rte_cryptodev *dev;
+
 	if (name == NULL)
 		return -EINVAL;
 
+	dev = rte_cryptodev_pmd_get_named_dev(name);
+	if (dev != NULL && dev->dev_type == RTE_CRYPTODEV_AESNI_GCM_PMD) {
+		aesni_gcm_workers_stop(dev);
+		aesni_gcm_workers_free(dev->data->dev_private);
+	}
+
 	GCM_LOG_INFO("Closing AESNI crypto device %s on numa socket %u\n",
 			name, rte_socket_id());
 
@@ -96,15 +96,16 @@ aesni_gcm_pmd_config(__rte_unused struct rte_cryptodev *dev)
 
 /** Start device */
 static int
-aesni_gcm_pmd_start(__rte_unused struct rte_cryptodev *dev)
+aesni_gcm_pmd_start(struct rte_cryptodev *dev)
 {
-	return 0;
+	return aesni_gcm_workers_start(dev);
 }
 
 /** Stop device */
 static void
-aesni_gcm_pmd_stop(__rte_unused struct rte_cryptodev *dev)
+aesni_gcm_pmd_stop(struct rte_cryptodev *dev)
 {
+	aesni_gcm_workers_stop(dev);
 }
 
 /** Close device */
@@ -168,8 +169,11 @@ aesni_gcm_pmd_info_get(struct rte_cryptodev *dev,
 static int
 aesni_gcm_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 {
-	if (dev->data->queue_pairs[qp_id] != NULL) {
-		rte_free(dev->data->queue_pairs[qp_id]);
+	struct aesni_gcm_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (qp != NULL) {
+		rte_free(qp->sgl_buf);
+		rte_free(qp);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
 	return 0;
@@ -190,27 +194,25 @@ aesni_gcm_pmd_qp_set_unique_name(struct rte_cryptodev *dev,
 	return 0;
 }
 
-/** Create a ring to place process packets on */
+/** Create a ring to place packets on, reusing it if it already exists */
 static struct rte_ring *
-aesni_gcm_pmd_qp_create_processed_pkts_ring(struct aesni_gcm_qp *qp,
-		unsigned ring_size, int socket_id)
+aesni_gcm_pmd_qp_create_ring(const char *name, unsigned ring_size,
+		int socket_id)
 {
 	struct rte_ring *r;
 
-	r = rte_ring_lookup(qp->name);
+	r = rte_ring_lookup(name);
 	if (r) {
 		if (r->prod.size >= ring_size) {
-			GCM_LOG_INFO("Reusing existing ring %s for processed"
-					" packets", qp->name);
+			GCM_LOG_INFO("Reusing existing ring %s", name);
 			return r;
 		}
 
-		GCM_LOG_ERR("Unable to reuse existing ring %s for processed"
-				" packets", qp->name);
+		GCM_LOG_ERR("Unable to reuse existing ring %s", name);
 		return NULL;
 	}
 
-	return rte_ring_create(qp->name, ring_size, socket_id,
+	return rte_ring_create(name, ring_size, socket_id,
 			RING_F_SP_ENQ | RING_F_SC_DEQ);
 }
 
@@ -241,11 +243,29 @@ aesni_gcm_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 
 	qp->ops = &gcm_ops[internals->vector_mode];
 
-	qp->processed_pkts = aesni_gcm_pmd_qp_create_processed_pkts_ring(qp,
+	qp->processed_pkts = aesni_gcm_pmd_qp_create_ring(qp->name,
 			qp_conf->nb_descriptors, socket_id);
 	if (qp->processed_pkts == NULL)
 		goto qp_setup_cleanup;
 
+	/* Packets are handed over to a dedicated worker if configured */
+	if (internals->nb_workers > 0) {
+		char ring_name[RTE_RING_NAMESIZE];
+
+		snprintf(ring_name, sizeof(ring_name),
+				"aesni_gcm_pmd_%u_qp_%u_in",
+				dev->data->dev_id, qp->id);
+		qp->ingress_pkts = aesni_gcm_pmd_qp_create_ring(ring_name,
+				qp_conf->nb_descriptors, socket_id);
+		if (qp->ingress_pkts == NULL)
+			goto qp_setup_cleanup;
+	}
+
+	qp->sgl_buf = rte_malloc_socket("AES-NI GCM PMD SGL Buffer",
+			AESNI_GCM_SGL_BUF_SIZE, RTE_CACHE_LINE_SIZE, socket_id);
+	if (qp->sgl_buf == NULL)
+		goto qp_setup_cleanup;
+
 	qp->sess_mp = dev->data->session_pool;
 
 	memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
@@ -253,8 +273,10 @@ aesni_gcm_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 	return 0;
 
 qp_setup_cleanup:
-	if (qp)
+	if (qp) {
+		rte_free(qp->sgl_buf);
 		rte_free(qp);
+	}
 
 	return -1;
 }
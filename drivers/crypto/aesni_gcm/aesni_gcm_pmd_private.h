@@ -56,6 +56,27 @@
 #endif
 
 
+/**
+ * Size of the buffer in which the data of chained mbufs is gathered, the
+ * GCM library only processes contiguous data
+ */
+#define AESNI_GCM_SGL_BUF_SIZE		(64 * 1024)
+
+/** Maximum number of operations a worker pulls from a queue pair at once */
+#define AESNI_GCM_WORKER_BURST_SIZE	(32)
+
+/** AESNI GCM worker, processing the operations of a subset of queue pairs */
+struct aesni_gcm_worker {
+	unsigned lcore_id;
+	/**< lcore the worker runs on */
+	unsigned id;
+	/**< Worker index, the worker serves queue pairs id, id + nb_workers.. */
+	volatile int running;
+	/**< Set while the worker is expected to poll its queue pairs */
+	struct rte_cryptodev *dev;
+	/**< Device the worker belongs to */
+} __rte_cache_aligned;
+
 /** private data structure for each virtual AESNI GCM device */
 struct aesni_gcm_private {
 	enum aesni_gcm_vector_mode vector_mode;
@@ -64,6 +85,10 @@ struct aesni_gcm_private {
 	/**< Max number of queue pairs supported by device */
 	unsigned max_nb_sessions;
 	/**< Max number of sessions supported by device */
+	unsigned nb_workers;
+	/**< Number of dedicated worker lcores, 0 for synchronous processing */
+	struct aesni_gcm_worker *workers;
+	/**< Dedicated workers */
 };
 
 struct aesni_gcm_qp {
@@ -75,6 +100,10 @@ struct aesni_gcm_qp {
 	/**< Architecture dependent function pointer table of the gcm APIs */
 	struct rte_ring *processed_pkts;
 	/**< Ring for placing process packets */
+	struct rte_ring *ingress_pkts;
+	/**< Ring for passing packets to a worker, NULL if no workers */
+	uint8_t *sgl_buf;
+	/**< Buffer for gathering chained mbuf data */
 	struct rte_mempool *sess_mp;
 	/**< Session Mempool */
 	struct rte_cryptodev_stats qp_stats;
@@ -112,6 +141,14 @@ aesni_gcm_set_session_parameters(const struct aesni_gcm_ops *ops,
 		const struct rte_crypto_sym_xform *xform);
 
 
+/** Start the dedicated workers of a device */
+extern int
+aesni_gcm_workers_start(struct rte_cryptodev *dev);
+
+/** Stop the dedicated workers of a device */
+extern void
+aesni_gcm_workers_stop(struct rte_cryptodev *dev);
+
 /**
  * Device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *rte_aesni_gcm_pmd_ops;
@@ -37,6 +37,9 @@
 #include <rte_dev.h>
 #include <rte_malloc.h>
 #include <rte_cpuflags.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_jhash.h>
 
 #include "rte_aesni_mb_pmd_private.h"
 
@@ -61,6 +64,120 @@ create_unique_device_name(char *name, size_t size)
 	return 0;
 }
 
+/**
+ * Key schedule cache shared by all the AES-NI multi buffer devices, so that
+ * sessions set up again with the same keys, on any device, skip the key
+ * expansion and the HMAC pre-computes. It is direct mapped, an entry being
+ * held by the sessions set up with its key. The key and its schedule are
+ * wiped once the last of them is cleared, only then may the entry be taken
+ * by another key hashing to it.
+ */
+static struct aesni_mb_key_cache_entry *key_cache;
+
+/** Allocate the key schedule cache on creation of the first device */
+static int
+aesni_mb_key_cache_init(void)
+{
+	unsigned i;
+
+	RTE_BUILD_BUG_ON((AESNI_MB_KEY_CACHE_SIZE &
+			(AESNI_MB_KEY_CACHE_SIZE - 1)) != 0);
+
+	if (AESNI_MB_KEY_CACHE_SIZE == 0 || key_cache != NULL)
+		return 0;
+
+	key_cache = rte_zmalloc("AES-NI MB PMD key cache",
+			AESNI_MB_KEY_CACHE_SIZE * sizeof(*key_cache),
+			RTE_CACHE_LINE_SIZE);
+	if (key_cache == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < AESNI_MB_KEY_CACHE_SIZE; i++)
+		rte_spinlock_init(&key_cache[i].lock);
+
+	return 0;
+}
+
+/**
+ * Look up the key schedule cache entry of a key, the entry is returned locked
+ * and must be unlocked with key_cache_entry_put(). The caller holds a
+ * reference to the entry, dropped with key_cache_entry_release().
+ *
+ * @param type		xform type the key belongs to
+ * @param algo		cipher or authentication algorithm
+ * @param key		key
+ * @param key_length	key length in bytes
+ * @param hit		set to 1 if the entry holds the schedule of the key,
+ *			otherwise the entry is to be filled by the caller
+ *
+ * @return
+ * - Locked cache entry
+ * - NULL if the key can't be cached, or the entry is held for another key
+ */
+static struct aesni_mb_key_cache_entry *
+key_cache_entry_get(enum rte_crypto_sym_xform_type type, int algo,
+		const uint8_t *key, uint16_t key_length, int *hit)
+{
+	struct aesni_mb_key_cache_entry *entry;
+	uint32_t idx;
+
+	*hit = 0;
+	if (key_cache == NULL || key_length > AESNI_MB_KEY_CACHE_MAX_KEY_LEN)
+		return NULL;
+
+	idx = rte_jhash(key, key_length, ((uint32_t)type << 16) ^ algo) &
+			(AESNI_MB_KEY_CACHE_SIZE - 1);
+	entry = &key_cache[idx];
+
+	rte_spinlock_lock(&entry->lock);
+
+	if (entry->type == type && entry->algo == algo &&
+			entry->key_length == key_length &&
+			memcmp(entry->key, key, key_length) == 0) {
+		entry->refcnt++;
+		*hit = 1;
+		return entry;
+	}
+
+	if (entry->refcnt != 0) {
+		rte_spinlock_unlock(&entry->lock);
+		return NULL;
+	}
+
+	entry->refcnt = 1;
+	entry->type = type;
+	entry->algo = algo;
+	entry->key_length = key_length;
+	memcpy(entry->key, key, key_length);
+
+	return entry;
+}
+
+/** Release a key schedule cache entry */
+static inline void
+key_cache_entry_put(struct aesni_mb_key_cache_entry *entry)
+{
+	if (entry != NULL)
+		rte_spinlock_unlock(&entry->lock);
+}
+
+/** Drop a reference to a key schedule cache entry */
+static void
+key_cache_entry_release(struct aesni_mb_key_cache_entry *entry)
+{
+	if (entry == NULL)
+		return;
+
+	rte_spinlock_lock(&entry->lock);
+
+	/* Wipe the key and its schedule once no session uses them */
+	if (--entry->refcnt == 0)
+		memset(&entry->type, 0, sizeof(*entry) -
+				offsetof(struct aesni_mb_key_cache_entry, type));
+
+	rte_spinlock_unlock(&entry->lock);
+}
+
 typedef void (*hash_one_block_t)(void *data, void *digest);
 typedef void (*aes_keyexp_t)(void *key, void *enc_exp_keys, void *dec_exp_keys);
 
@@ -136,6 +253,8 @@ aesni_mb_set_session_auth_parameters(const struct aesni_mb_ops *mb_ops,
 		const struct rte_crypto_sym_xform *xform)
 {
 	hash_one_block_t hash_oneblock_fn;
+	struct aesni_mb_key_cache_entry *entry;
+	int hit;
 
 	if (xform->type != RTE_CRYPTO_SYM_XFORM_AUTH) {
 		MB_LOG_ERR("Crypto xform struct not of type auth");
@@ -145,9 +264,34 @@ aesni_mb_set_session_auth_parameters(const struct aesni_mb_ops *mb_ops,
 	/* Set Authentication Parameters */
 	if (xform->auth.algo == RTE_CRYPTO_AUTH_AES_XCBC_MAC) {
 		sess->auth.algo = AES_XCBC;
-		(*mb_ops->aux.keyexp.aes_xcbc)(xform->auth.key.data,
-				sess->auth.xcbc.k1_expanded,
-				sess->auth.xcbc.k2, sess->auth.xcbc.k3);
+
+		entry = key_cache_entry_get(RTE_CRYPTO_SYM_XFORM_AUTH,
+				xform->auth.algo, xform->auth.key.data,
+				xform->auth.key.length, &hit);
+		if (hit) {
+			memcpy(sess->auth.xcbc.k1_expanded,
+					entry->xcbc.k1_expanded,
+					sizeof(entry->xcbc.k1_expanded));
+			memcpy(sess->auth.xcbc.k2, entry->xcbc.k2,
+					sizeof(entry->xcbc.k2));
+			memcpy(sess->auth.xcbc.k3, entry->xcbc.k3,
+					sizeof(entry->xcbc.k3));
+		} else {
+			(*mb_ops->aux.keyexp.aes_xcbc)(xform->auth.key.data,
+					sess->auth.xcbc.k1_expanded,
+					sess->auth.xcbc.k2, sess->auth.xcbc.k3);
+			if (entry != NULL) {
+				memcpy(entry->xcbc.k1_expanded,
+						sess->auth.xcbc.k1_expanded,
+						sizeof(entry->xcbc.k1_expanded));
+				memcpy(entry->xcbc.k2, sess->auth.xcbc.k2,
+						sizeof(entry->xcbc.k2));
+				memcpy(entry->xcbc.k3, sess->auth.xcbc.k3,
+						sizeof(entry->xcbc.k3));
+			}
+		}
+		key_cache_entry_put(entry);
+		sess->auth_key_entry = entry;
 		return 0;
 	}
 
@@ -181,12 +325,30 @@ aesni_mb_set_session_auth_parameters(const struct aesni_mb_ops *mb_ops,
 		return -1;
 	}
 
-	/* Calculate Authentication precomputes */
-	calculate_auth_precomputes(hash_oneblock_fn,
-			sess->auth.pads.inner, sess->auth.pads.outer,
-			xform->auth.key.data,
-			xform->auth.key.length,
-			get_auth_algo_blocksize(sess->auth.algo));
+	/* Calculate Authentication precomputes, unless already cached */
+	entry = key_cache_entry_get(RTE_CRYPTO_SYM_XFORM_AUTH,
+			xform->auth.algo, xform->auth.key.data,
+			xform->auth.key.length, &hit);
+	if (hit) {
+		memcpy(sess->auth.pads.inner, entry->pads.inner,
+				sizeof(entry->pads.inner));
+		memcpy(sess->auth.pads.outer, entry->pads.outer,
+				sizeof(entry->pads.outer));
+	} else {
+		calculate_auth_precomputes(hash_oneblock_fn,
+				sess->auth.pads.inner, sess->auth.pads.outer,
+				xform->auth.key.data,
+				xform->auth.key.length,
+				get_auth_algo_blocksize(sess->auth.algo));
+		if (entry != NULL) {
+			memcpy(entry->pads.inner, sess->auth.pads.inner,
+					sizeof(entry->pads.inner));
+			memcpy(entry->pads.outer, sess->auth.pads.outer,
+					sizeof(entry->pads.outer));
+		}
+	}
+	key_cache_entry_put(entry);
+	sess->auth_key_entry = entry;
 
 	return 0;
 }
@@ -198,6 +360,8 @@ aesni_mb_set_session_cipher_parameters(const struct aesni_mb_ops *mb_ops,
 		const struct rte_crypto_sym_xform *xform)
 {
 	aes_keyexp_t aes_keyexp_fn;
+	struct aesni_mb_key_cache_entry *entry;
+	int hit;
 
 	if (xform->type != RTE_CRYPTO_SYM_XFORM_CIPHER) {
 		MB_LOG_ERR("Crypto xform struct not of type cipher");
@@ -246,10 +410,30 @@ aesni_mb_set_session_cipher_parameters(const struct aesni_mb_ops *mb_ops,
 		return -1;
 	}
 
-	/* Expanded cipher keys */
-	(*aes_keyexp_fn)(xform->cipher.key.data,
-			sess->cipher.expanded_aes_keys.encode,
-			sess->cipher.expanded_aes_keys.decode);
+	/* Expanded cipher keys, unless already cached */
+	entry = key_cache_entry_get(RTE_CRYPTO_SYM_XFORM_CIPHER,
+			xform->cipher.algo, xform->cipher.key.data,
+			xform->cipher.key.length, &hit);
+	if (hit) {
+		memcpy(sess->cipher.expanded_aes_keys.encode, entry->aes.encode,
+				sizeof(entry->aes.encode));
+		memcpy(sess->cipher.expanded_aes_keys.decode, entry->aes.decode,
+				sizeof(entry->aes.decode));
+	} else {
+		(*aes_keyexp_fn)(xform->cipher.key.data,
+				sess->cipher.expanded_aes_keys.encode,
+				sess->cipher.expanded_aes_keys.decode);
+		if (entry != NULL) {
+			memcpy(entry->aes.encode,
+					sess->cipher.expanded_aes_keys.encode,
+					sizeof(entry->aes.encode));
+			memcpy(entry->aes.decode,
+					sess->cipher.expanded_aes_keys.decode,
+					sizeof(entry->aes.decode));
+		}
+	}
+	key_cache_entry_put(entry);
+	sess->cipher_key_entry = entry;
 
 	return 0;
 }
@@ -288,11 +472,21 @@ aesni_mb_set_session_parameters(const struct aesni_mb_ops *mb_ops,
 	if (aesni_mb_set_session_cipher_parameters(mb_ops, sess,
 			cipher_xform)) {
 		MB_LOG_ERR("Invalid/unsupported cipher parameters");
+		aesni_mb_release_session_keys(sess);
 		return -1;
 	}
 	return 0;
 }
 
+void
+aesni_mb_release_session_keys(struct aesni_mb_session *sess)
+{
+	key_cache_entry_release(sess->cipher_key_entry);
+	sess->cipher_key_entry = NULL;
+	key_cache_entry_release(sess->auth_key_entry);
+	sess->auth_key_entry = NULL;
+}
+
 /** Get multi buffer session */
 static struct aesni_mb_session *
 get_session(struct aesni_mb_qp *qp, struct rte_crypto_op *op)
@@ -318,34 +512,83 @@ get_session(struct aesni_mb_qp *qp, struct rte_crypto_op *op)
 				sess, op->sym->xform) != 0)) {
 			rte_mempool_put(qp->sess_mp, _sess);
 			sess = NULL;
+		} else {
+			/* Attached until the operation completes */
+			op->sym->session = _sess;
 		}
 	}
 
 	return sess;
 }
 
+/** Return the session of a session-less operation to the session mempool */
+static inline void
+put_session(struct aesni_mb_qp *qp, struct rte_crypto_op *op)
+{
+	if (op->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
+		aesni_mb_release_session_keys((struct aesni_mb_session *)
+				op->sym->session->_private);
+		rte_mempool_put(qp->sess_mp, op->sym->session);
+		op->sym->session = NULL;
+	}
+}
+
 /**
  * Process a crypto operation and complete a JOB_AES_HMAC job structure for
  * submission to the multi buffer library for processing.
  *
- * @param	qp	queue pair
- * @param	job	JOB_AES_HMAC structure to fill
- * @param	m	mbuf to process
+ * @param	mb_ops	multi-buffer API table
+ * @param	mb_mgr	multi-buffer manager to get the job from
+ * @param	sgl_buf	buffer to gather the data of a chained mbuf in, the job
+ *			must be completed before the buffer is used again
+ * @param	qp	queue pair the operation was enqueued on
+ * @param	op	crypto operation to process
+ * @param	session	multi-buffer session of the operation
  *
  * @return
  * - Completed JOB_AES_HMAC structure pointer on success
  * - NULL pointer if completion of JOB_AES_HMAC structure isn't possible
  */
 static JOB_AES_HMAC *
-process_crypto_op(struct aesni_mb_qp *qp, struct rte_crypto_op *op,
-		struct aesni_mb_session *session)
+process_crypto_op(const struct aesni_mb_ops *mb_ops, MB_MGR *mb_mgr,
+		uint8_t *sgl_buf, struct aesni_mb_qp *qp,
+		struct rte_crypto_op *op, struct aesni_mb_session *session)
 {
 	JOB_AES_HMAC *job;
 
 	struct rte_mbuf *m_src = op->sym->m_src, *m_dst;
 	uint16_t m_offset = 0;
+	uint32_t sgl_len = 0;
+
+	/* The output is written to the first segment of the destination */
+	if (unlikely(op->sym->m_dst != NULL &&
+			!rte_pktmbuf_is_contiguous(op->sym->m_dst))) {
+		MB_LOG_ERR("chained destination mbufs are not supported");
+		return NULL;
+	}
+
+	/*
+	 * Chained mbufs are processed in place, gathering the data covered by
+	 * the operation in a contiguous buffer if it spans several segments
+	 */
+	if (unlikely(!rte_pktmbuf_is_contiguous(m_src))) {
+		if (op->sym->m_dst != NULL) {
+			MB_LOG_ERR("chained mbufs are only supported in place");
+			return NULL;
+		}
 
-	job = (*qp->ops->job.get_next)(&qp->mb_mgr);
+		sgl_len = RTE_MAX(op->sym->cipher.data.offset +
+					op->sym->cipher.data.length,
+				op->sym->auth.data.offset +
+					op->sym->auth.data.length);
+		if (sgl_len > AESNI_MB_SGL_BUF_SIZE) {
+			MB_LOG_ERR("chained mbuf data exceeds %u bytes",
+					AESNI_MB_SGL_BUF_SIZE);
+			return NULL;
+		}
+	}
+
+	job = (*mb_ops->job.get_next)(mb_mgr);
 	if (unlikely(job == NULL))
 		return job;
 
@@ -420,8 +663,18 @@ process_crypto_op(struct aesni_mb_qp *qp, struct rte_crypto_op *op,
 	job->iv_len_in_bytes = op->sym->cipher.iv.length;
 
 	/* Data  Parameter */
-	job->src = rte_pktmbuf_mtod(m_src, uint8_t *);
-	job->dst = rte_pktmbuf_mtod_offset(m_dst, uint8_t *, m_offset);
+	if (likely(sgl_len == 0)) {
+		job->src = rte_pktmbuf_mtod(m_src, uint8_t *);
+		job->dst = rte_pktmbuf_mtod_offset(m_dst, uint8_t *, m_offset);
+	} else {
+		job->src = rte_pktmbuf_read(m_src, 0, sgl_len, sgl_buf);
+		if (job->src == NULL) {
+			MB_LOG_ERR("operation data exceeds mbuf length");
+			return NULL;
+		}
+		job->dst = job->src == sgl_buf ? sgl_buf + m_offset :
+			rte_pktmbuf_mtod_offset(m_dst, uint8_t *, m_offset);
+	}
 
 	job->cipher_start_src_offset_in_bytes = op->sym->cipher.data.offset;
 	job->msg_len_to_cipher_in_bytes = op->sym->cipher.data.length;
@@ -429,9 +682,12 @@ process_crypto_op(struct aesni_mb_qp *qp, struct rte_crypto_op *op,
 	job->hash_start_src_offset_in_bytes = op->sym->auth.data.offset;
 	job->msg_len_to_hash_in_bytes = op->sym->auth.data.length;
 
-	/* Set user data to be crypto operation data struct */
+	/*
+	 * Set user data to be crypto operation data struct and the queue pair
+	 * it completes on, a worker manager holds jobs of several queue pairs
+	 */
 	job->user_data = op;
-	job->user_data2 = m_dst;
+	job->user_data2 = qp;
 
 	return job;
 }
@@ -451,20 +707,28 @@ post_process_mb_job(struct aesni_mb_qp *qp, JOB_AES_HMAC *job)
 {
 	struct rte_crypto_op *op =
 			(struct rte_crypto_op *)job->user_data;
-	struct rte_mbuf *m_dst =
-			(struct rte_mbuf *)job->user_data2;
+	struct rte_mbuf *m_dst;
 
-	if (op == NULL || m_dst == NULL)
+	if (op == NULL)
 		return NULL;
 
+	m_dst = op->sym->m_dst ? op->sym->m_dst : op->sym->m_src;
+
 	/* set status as successful by default */
 	op->status = RTE_CRYPTO_OP_STATUS_SUCCESS;
 
 	/* check if job has been processed  */
 	if (unlikely(job->status != STS_COMPLETED)) {
 		op->status = RTE_CRYPTO_OP_STATUS_ERROR;
-		return op;
-	} else if (job->chain_order == HASH_CIPHER) {
+		goto out;
+	}
+
+	/* Scatter the output back if the data of a chained mbuf was gathered */
+	if (unlikely(job->src != rte_pktmbuf_mtod(m_dst, uint8_t *)))
+		rte_pktmbuf_write(m_dst, op->sym->cipher.data.offset,
+				op->sym->cipher.data.length, job->dst);
+
+	if (job->chain_order == HASH_CIPHER) {
 		/* Verify digest if required */
 		if (memcmp(job->auth_tag_output, op->sym->auth.digest.data,
 				job->auth_tag_output_len_in_bytes) != 0)
@@ -474,11 +738,9 @@ post_process_mb_job(struct aesni_mb_qp *qp, JOB_AES_HMAC *job)
 		rte_pktmbuf_trim(m_dst, get_digest_byte_length(job->hash_alg));
 	}
 
+out:
 	/* Free session if a session-less crypto op */
-	if (op->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
-		rte_mempool_put(qp->sess_mp, op->sym->session);
-		op->sym->session = NULL;
-	}
+	put_session(qp, op);
 
 	return op;
 }
@@ -487,31 +749,50 @@ post_process_mb_job(struct aesni_mb_qp *qp, JOB_AES_HMAC *job)
  * Process a completed JOB_AES_HMAC job and keep processing jobs until
  * get_completed_job return NULL
  *
- * @param qp		Queue Pair to process
+ * @param mb_ops	multi-buffer API table
+ * @param mb_mgr	multi-buffer manager the job completed on
  * @param job		JOB_AES_HMAC job
  *
  * @return
  * - Number of processed jobs
  */
 static unsigned
-handle_completed_jobs(struct aesni_mb_qp *qp, JOB_AES_HMAC *job)
+handle_completed_jobs(const struct aesni_mb_ops *mb_ops, MB_MGR *mb_mgr,
+		JOB_AES_HMAC *job)
 {
+	struct aesni_mb_qp *qp;
 	struct rte_crypto_op *op = NULL;
 	unsigned processed_jobs = 0;
 
 	while (job) {
 		processed_jobs++;
+		qp = (struct aesni_mb_qp *)job->user_data2;
 		op = post_process_mb_job(qp, job);
 		if (op)
 			rte_ring_enqueue(qp->processed_ops, (void *)op);
 		else
 			qp->stats.dequeue_err_count++;
-		job = (*qp->ops->job.get_completed_job)(&qp->mb_mgr);
+		qp->stats.enqueued_count++;
+		qp->nb_inflight--;
+		job = (*mb_ops->job.get_completed_job)(mb_mgr);
 	}
 
 	return processed_jobs;
 }
 
+/** Flush all jobs held by a multi-buffer manager */
+static unsigned
+flush_jobs(const struct aesni_mb_ops *mb_ops, MB_MGR *mb_mgr)
+{
+	JOB_AES_HMAC *job;
+	unsigned processed_jobs = 0;
+
+	while ((job = (*mb_ops->job.flush_job)(mb_mgr)) != NULL)
+		processed_jobs += handle_completed_jobs(mb_ops, mb_mgr, job);
+
+	return processed_jobs;
+}
+
 static uint16_t
 aesni_mb_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 		uint16_t nb_ops)
@@ -521,14 +802,14 @@ aesni_mb_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 
 	JOB_AES_HMAC *job = NULL;
 
-	int i, processed_jobs = 0;
+	int i, sgl, processed_jobs = 0;
 
 	for (i = 0; i < nb_ops; i++) {
 #ifdef RTE_LIBRTE_AESNI_MB_DEBUG
-		if (unlikely(op->type != RTE_CRYPTO_OP_TYPE_SYMMETRIC)) {
+		if (unlikely(ops[i]->type != RTE_CRYPTO_OP_TYPE_SYMMETRIC)) {
 			MB_LOG_ERR("PMD only supports symmetric crypto "
 				"operation requests, op (%p) is not a "
-				"symmetric operation.", op);
+				"symmetric operation.", ops[i]);
 			qp->stats.enqueue_err_count++;
 			goto flush_jobs;
 		}
@@ -539,13 +820,17 @@ aesni_mb_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 			goto flush_jobs;
 		}
 
-		job = process_crypto_op(qp, ops[i], sess);
+		job = process_crypto_op(qp->ops, &qp->mb_mgr, qp->sgl_buf, qp,
+				ops[i], sess);
 		if (unlikely(job == NULL)) {
+			put_session(qp, ops[i]);
 			qp->stats.enqueue_err_count++;
 			goto flush_jobs;
 		}
+		sgl = job->src == qp->sgl_buf;
 
 		/* Submit Job */
+		qp->nb_inflight++;
 		job = (*qp->ops->job.submit)(&qp->mb_mgr);
 
 		/*
@@ -553,13 +838,15 @@ aesni_mb_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 		 * before submitting subsequent jobs
 		 */
 		if (job)
-			processed_jobs += handle_completed_jobs(qp, job);
+			processed_jobs += handle_completed_jobs(qp->ops,
+					&qp->mb_mgr, job);
+
+		/* Gathered data must be processed before reusing the buffer */
+		if (unlikely(sgl))
+			processed_jobs += flush_jobs(qp->ops, &qp->mb_mgr);
 	}
 
-	if (processed_jobs == 0)
-		goto flush_jobs;
-	else
-		qp->stats.enqueued_count += processed_jobs;
+	if (processed_jobs != 0)
 		return i;
 
 flush_jobs:
@@ -569,11 +856,24 @@ flush_jobs:
 	 */
 	job = (*qp->ops->job.flush_job)(&qp->mb_mgr);
 	if (job)
-		qp->stats.enqueued_count += handle_completed_jobs(qp, job);
+		handle_completed_jobs(qp->ops, &qp->mb_mgr, job);
 
 	return i;
 }
 
+/**
+ * Enqueue burst used when the device has dedicated workers, operations are
+ * only handed over to the worker serving the queue pair.
+ */
+static uint16_t
+aesni_mb_pmd_enqueue_burst_worker(void *queue_pair,
+		struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	struct aesni_mb_qp *qp = queue_pair;
+
+	return rte_ring_enqueue_burst(qp->ingress_ops, (void **)ops, nb_ops);
+}
+
 static uint16_t
 aesni_mb_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 		uint16_t nb_ops)
@@ -589,6 +889,180 @@ aesni_mb_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 	return nb_dequeued;
 }
 
+/**
+ * Pull operations from a queue pair ingress ring and submit them to the
+ * worker multi-buffer manager. Operations which can't be submitted are
+ * returned to the queue pair straight away with an error status.
+ *
+ * @return
+ * - Number of operations taken from the queue pair
+ */
+static unsigned
+aesni_mb_worker_process_qp(struct aesni_mb_worker *worker,
+		struct aesni_mb_qp *qp)
+{
+	struct rte_crypto_op *ops[AESNI_MB_WORKER_BURST_SIZE];
+	struct aesni_mb_session *sess;
+	JOB_AES_HMAC *job;
+	unsigned i, nb_ops, room;
+	int sgl;
+
+	/*
+	 * Never take more operations than can be returned on the processed
+	 * ring, accounting for jobs of this queue pair still in the lanes
+	 */
+	room = rte_ring_free_count(qp->processed_ops);
+	if (room <= qp->nb_inflight)
+		return 0;
+	room = RTE_MIN(room - qp->nb_inflight,
+			(unsigned)AESNI_MB_WORKER_BURST_SIZE);
+
+	nb_ops = rte_ring_dequeue_burst(qp->ingress_ops, (void **)ops, room);
+
+	for (i = 0; i < nb_ops; i++) {
+		sess = get_session(qp, ops[i]);
+		if (unlikely(sess == NULL)) {
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_INVALID_SESSION;
+			goto op_error;
+		}
+
+		job = process_crypto_op(worker->ops, &worker->mb_mgr,
+				worker->sgl_buf, qp, ops[i], sess);
+		if (unlikely(job == NULL)) {
+			put_session(qp, ops[i]);
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_ERROR;
+			goto op_error;
+		}
+		sgl = job->src == worker->sgl_buf;
+
+		qp->nb_inflight++;
+		job = (*worker->ops->job.submit)(&worker->mb_mgr);
+		if (job)
+			handle_completed_jobs(worker->ops, &worker->mb_mgr,
+					job);
+
+		/* Gathered data must be processed before reusing the buffer */
+		if (unlikely(sgl))
+			flush_jobs(worker->ops, &worker->mb_mgr);
+		continue;
+
+op_error:
+		qp->stats.enqueue_err_count++;
+		rte_ring_enqueue(qp->processed_ops, (void *)ops[i]);
+	}
+
+	return nb_ops;
+}
+
+/**
+ * Worker main loop. Operations from all served queue pairs are submitted to
+ * a single multi-buffer manager so the lanes stay filled across bursts of
+ * different callers; the manager is only flushed once all queue pairs are
+ * idle.
+ */
+static int
+aesni_mb_worker_loop(void *arg)
+{
+	struct aesni_mb_worker *worker = arg;
+	struct rte_cryptodev *dev = worker->dev;
+	struct aesni_mb_private *internals = dev->data->dev_private;
+	unsigned qp_id, nb_ops;
+
+	while (worker->running) {
+		nb_ops = 0;
+
+		for (qp_id = worker->id; qp_id < dev->data->nb_queue_pairs;
+				qp_id += internals->nb_workers) {
+			struct aesni_mb_qp *qp = dev->data->queue_pairs[qp_id];
+
+			if (qp != NULL)
+				nb_ops += aesni_mb_worker_process_qp(worker,
+						qp);
+		}
+
+		if (nb_ops == 0)
+			flush_jobs(worker->ops, &worker->mb_mgr);
+	}
+
+	flush_jobs(worker->ops, &worker->mb_mgr);
+
+	return 0;
+}
+
+int
+aesni_mb_workers_start(struct rte_cryptodev *dev)
+{
+	struct aesni_mb_private *internals = dev->data->dev_private;
+	struct aesni_mb_worker *worker;
+	unsigned i;
+
+	for (i = 0; i < internals->nb_workers; i++) {
+		worker = &internals->workers[i];
+
+		if (worker->lcore_id == rte_get_master_lcore() ||
+				!rte_lcore_is_enabled(worker->lcore_id) ||
+				rte_eal_get_lcore_state(worker->lcore_id) !=
+						WAIT) {
+			MB_LOG_ERR("worker lcore %u is not available",
+					worker->lcore_id);
+			goto start_error;
+		}
+
+		worker->dev = dev;
+		worker->ops = &job_ops[internals->vector_mode];
+		(*worker->ops->job.init_mgr)(&worker->mb_mgr);
+
+		worker->running = 1;
+		if (rte_eal_remote_launch(aesni_mb_worker_loop, worker,
+				worker->lcore_id) != 0) {
+			worker->running = 0;
+			MB_LOG_ERR("failed to launch worker on lcore %u",
+					worker->lcore_id);
+			goto start_error;
+		}
+	}
+
+	return 0;
+
+start_error:
+	aesni_mb_workers_stop(dev);
+	return -EBUSY;
+}
+
+void
+aesni_mb_workers_stop(struct rte_cryptodev *dev)
+{
+	struct aesni_mb_private *internals = dev->data->dev_private;
+	struct aesni_mb_worker *worker;
+	unsigned i;
+
+	for (i = 0; i < internals->nb_workers; i++) {
+		worker = &internals->workers[i];
+
+		if (!worker->running)
+			continue;
+
+		worker->running = 0;
+		rte_eal_wait_lcore(worker->lcore_id);
+	}
+}
+
+/** Free the dedicated workers of a device, they must be stopped */
+static void
+aesni_mb_workers_free(struct aesni_mb_private *internals)
+{
+	unsigned i;
+
+	if (internals->workers == NULL)
+		return;
+
+	for (i = 0; i < internals->nb_workers; i++)
+		rte_free(internals->workers[i].sgl_buf);
+	rte_free(internals->workers);
+	internals->workers = NULL;
+	internals->nb_workers = 0;
+}
+
 
 static int cryptodev_aesni_mb_uninit(const char *name);
 
@@ -639,11 +1113,15 @@ cryptodev_aesni_mb_create(const char *name,
 
 	/* register rx/tx burst functions for data path */
 	dev->dequeue_burst = aesni_mb_pmd_dequeue_burst;
-	dev->enqueue_burst = aesni_mb_pmd_enqueue_burst;
+	if (init_params->nb_worker_lcores > 0)
+		dev->enqueue_burst = aesni_mb_pmd_enqueue_burst_worker;
+	else
+		dev->enqueue_burst = aesni_mb_pmd_enqueue_burst;
 
 	dev->feature_flags = RTE_CRYPTODEV_FF_SYMMETRIC_CRYPTO |
 			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
-			RTE_CRYPTODEV_FF_CPU_AESNI;
+			RTE_CRYPTODEV_FF_CPU_AESNI |
+			RTE_CRYPTODEV_FF_MBUF_SCATTER_GATHER;
 
 	switch (vector_mode) {
 	case RTE_AESNI_MB_SSE:
@@ -659,6 +1137,11 @@ cryptodev_aesni_mb_create(const char *name,
 		break;
 	}
 
+	if (aesni_mb_key_cache_init() != 0) {
+		MB_LOG_ERR("failed to allocate key schedule cache");
+		goto init_error;
+	}
+
 	/* Set vector instructions mode supported */
 	internals = dev->data->dev_private;
 
@@ -666,6 +1149,36 @@ cryptodev_aesni_mb_create(const char *name,
 	internals->max_nb_queue_pairs = init_params->max_nb_queue_pairs;
 	internals->max_nb_sessions = init_params->max_nb_sessions;
 
+	/* Set up dedicated workers, they are launched on device start */
+	internals->nb_workers = init_params->nb_worker_lcores;
+	if (internals->nb_workers > 0) {
+		unsigned i;
+
+		internals->workers = rte_zmalloc_socket("AES-NI PMD Workers",
+				internals->nb_workers *
+					sizeof(struct aesni_mb_worker),
+				RTE_CACHE_LINE_SIZE, init_params->socket_id);
+		if (internals->workers == NULL) {
+			MB_LOG_ERR("failed to allocate workers");
+			goto init_error;
+		}
+
+		for (i = 0; i < internals->nb_workers; i++) {
+			internals->workers[i].id = i;
+			internals->workers[i].lcore_id =
+					init_params->worker_lcores[i];
+			internals->workers[i].sgl_buf = rte_malloc_socket(
+					"AES-NI PMD SGL Buffer",
+					AESNI_MB_SGL_BUF_SIZE,
+					RTE_CACHE_LINE_SIZE,
+					init_params->socket_id);
+			if (internals->workers[i].sgl_buf == NULL) {
+				MB_LOG_ERR("failed to allocate worker buffer");
+				goto init_error;
+			}
+		}
+	}
+
 	return 0;
 init_error:
 	MB_LOG_ERR("driver %s: cryptodev_aesni_create failed", name);
@@ -680,9 +1193,9 @@ cryptodev_aesni_mb_init(const char *name,
 		const char *input_args)
 {
 	struct rte_crypto_vdev_init_params init_params = {
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
-		rte_socket_id()
+		.max_nb_queue_pairs = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
+		.max_nb_sessions = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
+		.socket_id = rte_socket_id()
 	};
 
 	rte_cryptodev_parse_vdev_init_params(&init_params, input_args);
@@ -693,6 +1206,8 @@ cryptodev_aesni_mb_init(const char *name,
 			init_params.max_nb_queue_pairs);
 	RTE_LOG(INFO, PMD, "  Max number of sessions = %d\n",
 			init_params.max_nb_sessions);
+	RTE_LOG(INFO, PMD, "  Number of worker lcores = %u\n",
+			init_params.nb_worker_lcores);
 
 	return cryptodev_aesni_mb_create(name, &init_params);
 }
@@ -700,9 +1215,17 @@ cryptodev_aesni_mb_init(const char *name,
 static int
 cryptodev_aesni_mb_uninit(const char *name)
 {
+	struct rte_cryptodev *dev;
+
 	if (name == NULL)
 		return -EINVAL;
 
+	dev = rte_cryptodev_pmd_get_named_dev(name);
+	if (dev != NULL && dev->dev_type == RTE_CRYPTODEV_AESNI_MB_PMD) {
+		aesni_mb_workers_stop(dev);
+		aesni_mb_workers_free(dev->data->dev_private);
+	}
+
 	RTE_LOG(INFO, PMD, "Closing AESNI crypto device %s on numa socket %u\n",
 			name, rte_socket_id());
 
@@ -220,15 +220,16 @@ aesni_mb_pmd_config(__rte_unused struct rte_cryptodev *dev)
 
 /** Start device */
 static int
-aesni_mb_pmd_start(__rte_unused struct rte_cryptodev *dev)
+aesni_mb_pmd_start(struct rte_cryptodev *dev)
 {
-	return 0;
+	return aesni_mb_workers_start(dev);
 }
 
 /** Stop device */
 static void
-aesni_mb_pmd_stop(__rte_unused struct rte_cryptodev *dev)
+aesni_mb_pmd_stop(struct rte_cryptodev *dev)
 {
+	aesni_mb_workers_stop(dev);
 }
 
 /** Close device */
@@ -291,8 +292,11 @@ aesni_mb_pmd_info_get(struct rte_cryptodev *dev,
 static int
 aesni_mb_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 {
-	if (dev->data->queue_pairs[qp_id] != NULL) {
-		rte_free(dev->data->queue_pairs[qp_id]);
+	struct aesni_mb_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (qp != NULL) {
+		rte_free(qp->sgl_buf);
+		rte_free(qp);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
 	return 0;
@@ -313,27 +317,25 @@ aesni_mb_pmd_qp_set_unique_name(struct rte_cryptodev *dev,
 	return 0;
 }
 
-/** Create a ring to place processed operations on */
+/** Create a ring to place operations on, reusing it if it already exists */
 static struct rte_ring *
-aesni_mb_pmd_qp_create_processed_ops_ring(struct aesni_mb_qp *qp,
-		unsigned ring_size, int socket_id)
+aesni_mb_pmd_qp_create_ring(const char *name, unsigned ring_size,
+		int socket_id)
 {
 	struct rte_ring *r;
 
-	r = rte_ring_lookup(qp->name);
+	r = rte_ring_lookup(name);
 	if (r) {
 		if (r->prod.size >= ring_size) {
-			MB_LOG_INFO("Reusing existing ring %s for processed ops",
-					 qp->name);
+			MB_LOG_INFO("Reusing existing ring %s", name);
 			return r;
 		}
 
-		MB_LOG_ERR("Unable to reuse existing ring %s for processed ops",
-				 qp->name);
+		MB_LOG_ERR("Unable to reuse existing ring %s", name);
 		return NULL;
 	}
 
-	return rte_ring_create(qp->name, ring_size, socket_id,
+	return rte_ring_create(name, ring_size, socket_id,
 			RING_F_SP_ENQ | RING_F_SC_DEQ);
 }
 
@@ -364,11 +366,29 @@ aesni_mb_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 
 	qp->ops = &job_ops[internals->vector_mode];
 
-	qp->processed_ops = aesni_mb_pmd_qp_create_processed_ops_ring(qp,
+	qp->processed_ops = aesni_mb_pmd_qp_create_ring(qp->name,
 			qp_conf->nb_descriptors, socket_id);
 	if (qp->processed_ops == NULL)
 		goto qp_setup_cleanup;
 
+	/* Operations are handed over to a dedicated worker if configured */
+	if (internals->nb_workers > 0) {
+		char ring_name[RTE_RING_NAMESIZE];
+
+		snprintf(ring_name, sizeof(ring_name), "aesni_mb_pmd_%u_qp_%u_in",
+				dev->data->dev_id, qp->id);
+		qp->ingress_ops = aesni_mb_pmd_qp_create_ring(ring_name,
+				qp_conf->nb_descriptors, socket_id);
+		if (qp->ingress_ops == NULL)
+			goto qp_setup_cleanup;
+	} else {
+		qp->sgl_buf = rte_malloc_socket("AES-NI PMD SGL Buffer",
+				AESNI_MB_SGL_BUF_SIZE, RTE_CACHE_LINE_SIZE,
+				socket_id);
+		if (qp->sgl_buf == NULL)
+			goto qp_setup_cleanup;
+	}
+
 	qp->sess_mp = dev->data->session_pool;
 
 	memset(&qp->stats, 0, sizeof(qp->stats));
@@ -379,8 +399,10 @@ aesni_mb_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 	return 0;
 
 qp_setup_cleanup:
-	if (qp)
+	if (qp) {
+		rte_free(qp->sgl_buf);
 		rte_free(qp);
+	}
 
 	return -1;
 }
@@ -444,8 +466,10 @@ aesni_mb_pmd_session_clear(struct rte_cryptodev *dev __rte_unused, void *sess)
 	 * Current just resetting the whole data structure, need to investigate
 	 * whether a more selective reset of key would be more performant
 	 */
-	if (sess)
+	if (sess) {
+		aesni_mb_release_session_keys(sess);
 		memset(sess, 0, sizeof(struct aesni_mb_session));
+	}
 }
 
 struct rte_cryptodev_ops aesni_mb_pmd_ops = {
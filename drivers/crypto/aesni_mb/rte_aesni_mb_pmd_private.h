@@ -33,6 +33,8 @@
 #ifndef _RTE_AESNI_MB_PMD_PRIVATE_H_
 #define _RTE_AESNI_MB_PMD_PRIVATE_H_
 
+#include <rte_spinlock.h>
+
 #include "aesni_mb_ops.h"
 
 #define MB_LOG_ERR(fmt, args...) \
@@ -126,6 +128,82 @@ get_digest_byte_length(JOB_HASH_ALG algo)
 }
 
 
+/**
+ * Size of the buffer in which the data of chained mbufs is gathered, the
+ * multi-buffer library only processes contiguous data
+ */
+#define AESNI_MB_SGL_BUF_SIZE		(64 * 1024)
+
+/**
+ * Number of entries of the key schedule cache shared by all the devices, must
+ * be a power of 2, 0 disables the cache
+ */
+#define AESNI_MB_KEY_CACHE_SIZE		RTE_LIBRTE_PMD_AESNI_MB_KEY_CACHE_SIZE
+
+/** Maximum length of the keys whose schedule is cached */
+#define AESNI_MB_KEY_CACHE_MAX_KEY_LEN	(128)
+
+/**
+ * Key schedule cache entry, holding the expanded keys or the authentication
+ * pre-computes derived from a key of a given algorithm
+ */
+struct aesni_mb_key_cache_entry {
+	rte_spinlock_t lock;
+	/**< Protects the entry against concurrent session set up */
+	uint32_t refcnt;
+	/**< Number of sessions holding the entry */
+	enum rte_crypto_sym_xform_type type;
+	/**< Xform type, RTE_CRYPTO_SYM_XFORM_NOT_SPECIFIED if unused */
+	int algo;
+	/**< Cipher or authentication algorithm of the xform type */
+	uint16_t key_length;
+	/**< Key length in bytes */
+	uint8_t key[AESNI_MB_KEY_CACHE_MAX_KEY_LEN];
+	/**< Key the schedule is derived from */
+	union {
+		struct {
+			uint32_t encode[60] __rte_aligned(16);
+			uint32_t decode[60] __rte_aligned(16);
+		} aes;
+		/**< Expanded AES keys */
+		struct {
+			uint8_t inner[128] __rte_aligned(16);
+			uint8_t outer[128] __rte_aligned(16);
+		} pads;
+		/**< HMAC authentication pads */
+		struct {
+			uint32_t k1_expanded[44] __rte_aligned(16);
+			uint8_t k2[16] __rte_aligned(16);
+			uint8_t k3[16] __rte_aligned(16);
+		} xcbc;
+		/**< Expanded XCBC authentication keys */
+	};
+} __rte_cache_aligned;
+
+/** Maximum number of operations a worker pulls from a queue pair at once */
+#define AESNI_MB_WORKER_BURST_SIZE	(32)
+
+/**
+ * AESNI Multi buffer worker, owning a multi-buffer manager which is fed with
+ * the operations enqueued on a subset of the device queue pairs.
+ */
+struct aesni_mb_worker {
+	unsigned lcore_id;
+	/**< lcore the worker runs on */
+	unsigned id;
+	/**< Worker index, the worker serves queue pairs id, id + nb_workers.. */
+	volatile int running;
+	/**< Set while the worker is expected to poll its queue pairs */
+	struct rte_cryptodev *dev;
+	/**< Device the worker belongs to */
+	const struct aesni_mb_ops *ops;
+	/**< Vector mode dependent pointer table of the multi-buffer APIs */
+	MB_MGR mb_mgr;
+	/**< Multi-buffer instance shared by all queue pairs of the worker */
+	uint8_t *sgl_buf;
+	/**< Buffer for gathering chained mbuf data */
+} __rte_cache_aligned;
+
 /** private data structure for each virtual AESNI device */
 struct aesni_mb_private {
 	enum aesni_mb_vector_mode vector_mode;
@@ -134,6 +212,10 @@ struct aesni_mb_private {
 	/**< Max number of queue pairs supported by device */
 	unsigned max_nb_sessions;
 	/**< Max number of sessions supported by device */
+	unsigned nb_workers;
+	/**< Number of dedicated worker lcores, 0 for synchronous processing */
+	struct aesni_mb_worker *workers;
+	/**< Dedicated workers */
 };
 
 /** AESNI Multi buffer queue pair */
@@ -146,8 +228,14 @@ struct aesni_mb_qp {
 	/**< Vector mode dependent pointer table of the multi-buffer APIs */
 	MB_MGR mb_mgr;
 	/**< Multi-buffer instance */
+	uint8_t *sgl_buf;
+	/**< Buffer for gathering chained mbuf data, NULL if there are workers */
 	struct rte_ring *processed_ops;
 	/**< Ring for placing process operations */
+	struct rte_ring *ingress_ops;
+	/**< Ring for passing operations to a worker, NULL if no workers */
+	unsigned nb_inflight;
+	/**< Operations held by the worker, only accessed by the worker */
 	struct rte_mempool *sess_mp;
 	/**< Session Mempool */
 	struct rte_cryptodev_stats stats;
@@ -159,6 +247,11 @@ struct aesni_mb_qp {
 struct aesni_mb_session {
 	JOB_CHAIN_ORDER chain_order;
 
+	struct aesni_mb_key_cache_entry *cipher_key_entry;
+	/**< Key cache entry of the cipher key held, if any */
+	struct aesni_mb_key_cache_entry *auth_key_entry;
+	/**< Key cache entry of the authentication key held, if any */
+
 	/** Cipher Parameters */
 	struct {
 		/** Cipher direction - encrypt / decrypt */
@@ -220,6 +313,18 @@ aesni_mb_set_session_parameters(const struct aesni_mb_ops *mb_ops,
 		struct aesni_mb_session *sess,
 		const struct rte_crypto_sym_xform *xform);
 
+/** Release the key cache entries held by a session */
+extern void
+aesni_mb_release_session_keys(struct aesni_mb_session *sess);
+
+
+/** Start the dedicated workers of a device */
+extern int
+aesni_mb_workers_start(struct rte_cryptodev *dev);
+
+/** Stop the dedicated workers of a device, completing in-flight operations */
+extern void
+aesni_mb_workers_stop(struct rte_cryptodev *dev);
 
 /** device specific operations function pointer structure */
 extern struct rte_cryptodev_ops *rte_aesni_mb_pmd_ops;
@@ -238,9 +238,9 @@ cryptodev_null_init(const char *name,
 		const char *input_args)
 {
 	struct rte_crypto_vdev_init_params init_params = {
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
-		rte_socket_id()
+		.max_nb_queue_pairs = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
+		.max_nb_sessions = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
+		.socket_id = rte_socket_id()
 	};
 
 	rte_cryptodev_parse_vdev_init_params(&init_params, input_args);
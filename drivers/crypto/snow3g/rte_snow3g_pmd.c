@@ -177,24 +177,78 @@ snow3g_get_session(struct snow3g_qp *qp, struct rte_crypto_op *op)
 		sess = (struct snow3g_session *)c_sess->_private;
 
 		if (unlikely(snow3g_set_session_parameters(sess,
-				op->sym->xform) != 0))
+				op->sym->xform) != 0)) {
+			rte_mempool_put(qp->sess_mp, c_sess);
 			return NULL;
+		}
+
+		/* Attached until the operation completes */
+		op->sym->session = (struct rte_cryptodev_sym_session *)c_sess;
 	}
 
 	return sess;
 }
 
+/** Return the session of a session-less operation to the session mempool */
+static inline void
+put_session(struct snow3g_qp *qp, struct rte_crypto_op *op)
+{
+	if (op->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
+		rte_mempool_put(qp->sess_mp, op->sym->session);
+		op->sym->session = NULL;
+	}
+}
+
+/**
+ * Encrypt/decrypt the data of an operation which spans several segments of
+ * chained mbufs, gathering it in the queue pair buffer.
+ */
+static int
+process_snow3g_cipher_op_sgl(struct snow3g_qp *qp, struct rte_crypto_op *op,
+		struct snow3g_session *session)
+{
+	struct rte_mbuf *m_dst = op->sym->m_dst ?
+			op->sym->m_dst : op->sym->m_src;
+	uint32_t offset = op->sym->cipher.data.offset >> 3;
+	uint32_t length = op->sym->cipher.data.length >> 3;
+	const uint8_t *src;
+	uint8_t *dst;
+
+	if (length > SNOW3G_SGL_BUF_SIZE ||
+			offset + length > rte_pktmbuf_pkt_len(m_dst))
+		return -1;
+
+	src = rte_pktmbuf_read(op->sym->m_src, offset, length, qp->sgl_buf);
+	if (src == NULL)
+		return -1;
+
+	if (offset + length <= rte_pktmbuf_data_len(m_dst))
+		dst = rte_pktmbuf_mtod_offset(m_dst, uint8_t *, offset);
+	else
+		dst = qp->sgl_buf;
+
+	sso_snow3g_f8_1_buffer(&session->pKeySched_cipher,
+			op->sym->cipher.iv.data, (void *)(uintptr_t)src, dst,
+			length);
+
+	if (dst == qp->sgl_buf)
+		rte_pktmbuf_write(m_dst, offset, length, dst);
+
+	return 0;
+}
+
 /** Encrypt/decrypt mbufs with same cipher key. */
 static uint8_t
-process_snow3g_cipher_op(struct rte_crypto_op **ops,
+process_snow3g_cipher_op(struct snow3g_qp *qp, struct rte_crypto_op **ops,
 		struct snow3g_session *session,
 		uint8_t num_ops)
 {
-	unsigned i;
+	unsigned i, nb_bufs = 0;
 	uint8_t processed_ops = 0;
 	uint8_t *src[SNOW3G_MAX_BURST], *dst[SNOW3G_MAX_BURST];
 	uint8_t *IV[SNOW3G_MAX_BURST];
 	uint32_t num_bytes[SNOW3G_MAX_BURST];
+	uint32_t end;
 
 	for (i = 0; i < num_ops; i++) {
 		/* Sanity checks. */
@@ -212,34 +266,55 @@ process_snow3g_cipher_op(struct rte_crypto_op **ops,
 			break;
 		}
 
-		src[i] = rte_pktmbuf_mtod(ops[i]->sym->m_src, uint8_t *) +
+		/* Data of chained mbufs spanning segments is handled alone */
+		end = (ops[i]->sym->cipher.data.offset +
+				ops[i]->sym->cipher.data.length) >> 3;
+		if (unlikely(end > rte_pktmbuf_data_len(ops[i]->sym->m_src) ||
+				(ops[i]->sym->m_dst != NULL &&
+				end > rte_pktmbuf_data_len(
+						ops[i]->sym->m_dst)))) {
+			if (process_snow3g_cipher_op_sgl(qp, ops[i],
+					session) != 0) {
+				ops[i]->status =
+					RTE_CRYPTO_OP_STATUS_INVALID_ARGS;
+				SNOW3G_LOG_ERR("Data Length or offset");
+				break;
+			}
+			processed_ops++;
+			continue;
+		}
+
+		src[nb_bufs] = rte_pktmbuf_mtod(ops[i]->sym->m_src, uint8_t *) +
 				(ops[i]->sym->cipher.data.offset >> 3);
-		dst[i] = ops[i]->sym->m_dst ?
+		dst[nb_bufs] = ops[i]->sym->m_dst ?
 			rte_pktmbuf_mtod(ops[i]->sym->m_dst, uint8_t *) +
 				(ops[i]->sym->cipher.data.offset >> 3) :
 			rte_pktmbuf_mtod(ops[i]->sym->m_src, uint8_t *) +
 				(ops[i]->sym->cipher.data.offset >> 3);
-		IV[i] = ops[i]->sym->cipher.iv.data;
-		num_bytes[i] = ops[i]->sym->cipher.data.length >> 3;
+		IV[nb_bufs] = ops[i]->sym->cipher.iv.data;
+		num_bytes[nb_bufs] = ops[i]->sym->cipher.data.length >> 3;
+		nb_bufs++;
 
 		processed_ops++;
 	}
 
-	sso_snow3g_f8_n_buffer(&session->pKeySched_cipher, IV, src, dst,
-			num_bytes, processed_ops);
+	if (nb_bufs != 0)
+		sso_snow3g_f8_n_buffer(&session->pKeySched_cipher, IV, src,
+				dst, num_bytes, nb_bufs);
 
 	return processed_ops;
 }
 
 /** Generate/verify hash from mbufs with same hash key. */
 static int
-process_snow3g_hash_op(struct rte_crypto_op **ops,
+process_snow3g_hash_op(struct snow3g_qp *qp, struct rte_crypto_op **ops,
 		struct snow3g_session *session,
 		uint8_t num_ops)
 {
 	unsigned i;
 	uint8_t processed_ops = 0;
-	uint8_t *src, *dst;
+	const uint8_t *src;
+	uint8_t *dst;
 	uint32_t length_in_bits;
 
 	for (i = 0; i < num_ops; i++) {
@@ -265,15 +340,26 @@ process_snow3g_hash_op(struct rte_crypto_op **ops,
 
 		length_in_bits = ops[i]->sym->auth.data.length;
 
-		src = rte_pktmbuf_mtod(ops[i]->sym->m_src, uint8_t *) +
-				(ops[i]->sym->auth.data.offset >> 3);
+		/* Data of chained mbufs spanning segments is gathered */
+		if ((length_in_bits >> 3) > SNOW3G_SGL_BUF_SIZE)
+			src = NULL;
+		else
+			src = rte_pktmbuf_read(ops[i]->sym->m_src,
+					ops[i]->sym->auth.data.offset >> 3,
+					length_in_bits >> 3, qp->sgl_buf);
+		if (src == NULL) {
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_INVALID_ARGS;
+			SNOW3G_LOG_ERR("Data Length or offset");
+			break;
+		}
 
 		if (session->auth_op == RTE_CRYPTO_AUTH_OP_VERIFY) {
 			dst = (uint8_t *)rte_pktmbuf_append(ops[i]->sym->m_src,
 					ops[i]->sym->auth.digest.length);
 
 			sso_snow3g_f9_1_buffer(&session->pKeySched_hash,
-					ops[i]->sym->auth.aad.data, src,
+					ops[i]->sym->auth.aad.data,
+					(void *)(uintptr_t)src,
 					length_in_bits,	dst);
 			/* Verify digest. */
 			if (memcmp(dst, ops[i]->sym->auth.digest.data,
@@ -287,7 +373,8 @@ process_snow3g_hash_op(struct rte_crypto_op **ops,
 			dst = ops[i]->sym->auth.digest.data;
 
 			sso_snow3g_f9_1_buffer(&session->pKeySched_hash,
-					ops[i]->sym->auth.aad.data, src,
+					ops[i]->sym->auth.aad.data,
+					(void *)(uintptr_t)src,
 					length_in_bits, dst);
 		}
 		processed_ops++;
@@ -306,22 +393,22 @@ process_ops(struct rte_crypto_op **ops, struct snow3g_session *session,
 
 	switch (session->op) {
 	case SNOW3G_OP_ONLY_CIPHER:
-		processed_ops = process_snow3g_cipher_op(ops,
+		processed_ops = process_snow3g_cipher_op(qp, ops,
 				session, num_ops);
 		break;
 	case SNOW3G_OP_ONLY_AUTH:
-		processed_ops = process_snow3g_hash_op(ops, session,
+		processed_ops = process_snow3g_hash_op(qp, ops, session,
 				num_ops);
 		break;
 	case SNOW3G_OP_CIPHER_AUTH:
-		processed_ops = process_snow3g_cipher_op(ops, session,
+		processed_ops = process_snow3g_cipher_op(qp, ops, session,
 				num_ops);
-		process_snow3g_hash_op(ops, session, processed_ops);
+		process_snow3g_hash_op(qp, ops, session, processed_ops);
 		break;
 	case SNOW3G_OP_AUTH_CIPHER:
-		processed_ops = process_snow3g_hash_op(ops, session,
+		processed_ops = process_snow3g_hash_op(qp, ops, session,
 				num_ops);
-		process_snow3g_cipher_op(ops, session, processed_ops);
+		process_snow3g_cipher_op(qp, ops, session, processed_ops);
 		break;
 	default:
 		/* Operation not supported. */
@@ -336,10 +423,7 @@ process_ops(struct rte_crypto_op **ops, struct snow3g_session *session,
 		if (ops[i]->status == RTE_CRYPTO_OP_STATUS_NOT_PROCESSED)
 			ops[i]->status = RTE_CRYPTO_OP_STATUS_SUCCESS;
 		/* Free session if a session-less crypto op. */
-		if (ops[i]->sym->sess_type == RTE_CRYPTO_SYM_OP_SESSIONLESS) {
-			rte_mempool_put(qp->sess_mp, ops[i]->sym->session);
-			ops[i]->sym->session = NULL;
-		}
+		put_session(qp, ops[i]);
 	}
 
 	return processed_ops;
@@ -370,8 +454,10 @@ snow3g_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 				curr_sess->op == SNOW3G_OP_NOT_SUPPORTED)) {
 			curr_c_op->status =
 					RTE_CRYPTO_OP_STATUS_INVALID_SESSION;
-			qp->qp_stats.enqueue_err_count += nb_ops - enqueued_ops;
-			return enqueued_ops;
+			if (curr_sess != NULL)
+				put_session(qp, curr_c_op);
+			/* Still process the ops batched so far. */
+			break;
 		}
 
 		/* Batch ops that share the same session. */
@@ -441,6 +527,9 @@ snow3g_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 		}
 	}
 
+	/* Ops left after an invalid session. */
+	qp->qp_stats.enqueue_err_count += nb_ops - enqueued_ops;
+
 	return enqueued_ops;
 }
 
@@ -491,7 +580,8 @@ cryptodev_snow3g_create(const char *name,
 	dev->enqueue_burst = snow3g_pmd_enqueue_burst;
 
 	dev->feature_flags = RTE_CRYPTODEV_FF_SYMMETRIC_CRYPTO |
-			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING;
+			RTE_CRYPTODEV_FF_SYM_OPERATION_CHAINING |
+			RTE_CRYPTODEV_FF_MBUF_SCATTER_GATHER;
 
 	internals = dev->data->dev_private;
 
@@ -511,9 +601,9 @@ cryptodev_snow3g_init(const char *name,
 		const char *input_args)
 {
 	struct rte_crypto_vdev_init_params init_params = {
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
-		RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
-		rte_socket_id()
+		.max_nb_queue_pairs = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS,
+		.max_nb_sessions = RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS,
+		.socket_id = rte_socket_id()
 	};
 
 	rte_cryptodev_parse_vdev_init_params(&init_params, input_args);
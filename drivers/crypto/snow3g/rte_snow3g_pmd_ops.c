@@ -167,8 +167,11 @@ snow3g_pmd_info_get(struct rte_cryptodev *dev,
 static int
 snow3g_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 {
-	if (dev->data->queue_pairs[qp_id] != NULL) {
-		rte_free(dev->data->queue_pairs[qp_id]);
+	struct snow3g_qp *qp = dev->data->queue_pairs[qp_id];
+
+	if (qp != NULL) {
+		rte_free(qp->sgl_buf);
+		rte_free(qp);
 		dev->data->queue_pairs[qp_id] = NULL;
 	}
 	return 0;
@@ -244,6 +247,11 @@ snow3g_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 	if (qp->processed_ops == NULL)
 		goto qp_setup_cleanup;
 
+	qp->sgl_buf = rte_malloc_socket("SNOW3G PMD SGL Buffer",
+			SNOW3G_SGL_BUF_SIZE, RTE_CACHE_LINE_SIZE, socket_id);
+	if (qp->sgl_buf == NULL)
+		goto qp_setup_cleanup;
+
 	qp->sess_mp = dev->data->session_pool;
 
 	memset(&qp->qp_stats, 0, sizeof(qp->qp_stats));
@@ -251,8 +259,10 @@ snow3g_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 	return 0;
 
 qp_setup_cleanup:
-	if (qp)
+	if (qp) {
+		rte_free(qp->sgl_buf);
 		rte_free(qp);
+	}
 
 	return -1;
 }
@@ -55,6 +55,12 @@
 #define SNOW3G_LOG_DBG(fmt, args...)
 #endif
 
+/**
+ * Size of the buffer in which the data of chained mbufs is gathered, the
+ * SNOW 3G library only processes contiguous data
+ */
+#define SNOW3G_SGL_BUF_SIZE	(64 * 1024)
+
 /** private data structure for each virtual SNOW 3G device */
 struct snow3g_private {
 	unsigned max_nb_queue_pairs;
@@ -73,6 +79,8 @@ struct snow3g_qp {
 	/**< Ring for placing processed ops */
 	struct rte_mempool *sess_mp;
 	/**< Session Mempool */
+	uint8_t *sgl_buf;
+	/**< Buffer for gathering chained mbuf data */
 	struct rte_cryptodev_stats qp_stats;
 	/**< Queue pair statistics */
 } __rte_cache_aligned;
@@ -702,6 +702,84 @@ selection_logic(struct bond_dev_private *internals, uint8_t slave_id)
 	port->selected = SELECTED;
 }
 
+/**
+ * Rebuild the list of slaves in DISTRIBUTING state used by the TX path when
+ * slow packets are on dedicated queues. The list is written before its size
+ * so a concurrent reader sees a consistent prefix.
+ */
+static void
+update_distributing_slaves(struct bond_dev_private *internals)
+{
+	struct mode8023ad_private *mode4 = &internals->mode4;
+	uint8_t slaves[RTE_MAX_ETHPORTS];
+	uint8_t i, slave_id, count = 0;
+
+	for (i = 0; i < internals->active_slave_count; i++) {
+		slave_id = internals->active_slaves[i];
+		if (ACTOR_STATE(&mode_8023ad_ports[slave_id], DISTRIBUTING))
+			slaves[count++] = slave_id;
+	}
+
+	if (count < mode4->distributing_count) {
+		mode4->distributing_count = count;
+		rte_wmb();
+	}
+
+	memcpy(mode4->distributing_slaves, slaves, sizeof(slaves[0]) * count);
+	rte_wmb();
+	mode4->distributing_count = count;
+}
+
+/**
+ * Receive slow packets of a slave from its dedicated queue and pass them to
+ * the state machines.
+ */
+static void
+rx_dedicated_queue(struct bond_dev_private *internals, uint8_t slave_id)
+{
+	struct rte_mbuf *pkts[BOND_MODE_8023AX_SLAVE_RX_PKTS];
+	struct ether_hdr *hdr;
+	uint16_t nb_rx, j;
+
+	nb_rx = rte_eth_rx_burst(slave_id,
+			internals->mode4.dedicated_queues.rx_qid, pkts,
+			BOND_MODE_8023AX_SLAVE_RX_PKTS);
+
+	for (j = 0; j < nb_rx; j++) {
+		hdr = rte_pktmbuf_mtod(pkts[j], struct ether_hdr *);
+		if (likely(hdr->ether_type ==
+				rte_cpu_to_be_16(ETHER_TYPE_SLOW)))
+			bond_mode_8023ad_handle_slow_pkt(internals, slave_id,
+					pkts[j]);
+		else
+			rte_pktmbuf_free(pkts[j]);
+	}
+}
+
+/**
+ * Transmit slow packets queued by the state machines on the dedicated queue
+ * of a slave.
+ */
+static void
+tx_dedicated_queue(struct bond_dev_private *internals, uint8_t slave_id)
+{
+	struct port *port = &mode_8023ad_ports[slave_id];
+	struct rte_mbuf *pkts[BOND_MODE_8023AX_SLAVE_TX_PKTS];
+	uint16_t nb_pkts, nb_tx;
+
+	nb_pkts = rte_ring_dequeue_burst(port->tx_ring, (void **)pkts,
+			BOND_MODE_8023AX_SLAVE_TX_PKTS);
+	if (nb_pkts == 0)
+		return;
+
+	nb_tx = rte_eth_tx_burst(slave_id,
+			internals->mode4.dedicated_queues.tx_qid, pkts, nb_pkts);
+
+	/* Slow packets which can't be sent are dropped */
+	for ( ; nb_tx < nb_pkts; nb_tx++)
+		rte_pktmbuf_free(pkts[nb_tx]);
+}
+
 /* Function maps DPDK speed to bonding speed stored in key field */
 static uint16_t
 link_speed_key(uint16_t speed) {
@@ -806,6 +884,9 @@ bond_mode_8023ad_periodic_cb(void *arg)
 
 		SM_FLAG_SET(port, LACP_ENABLED);
 
+		if (internals->mode4.dedicated_queues.enabled)
+			rx_dedicated_queue(internals, slave_id);
+
 		/* Find LACP packet to this port. Do not check subtype, it is done in
 		 * function that queued packet */
 		if (rte_ring_dequeue(port->rx_ring, &pkt) == 0) {
@@ -826,10 +907,16 @@ bond_mode_8023ad_periodic_cb(void *arg)
 		tx_machine(internals, slave_id);
 		selection_logic(internals, slave_id);
 
+		if (internals->mode4.dedicated_queues.enabled)
+			tx_dedicated_queue(internals, slave_id);
+
 		SM_FLAG_CLR(port, BEGIN);
 		show_warnings(slave_id);
 	}
 
+	if (internals->mode4.dedicated_queues.enabled)
+		update_distributing_slaves(internals);
+
 	rte_eal_alarm_set(internals->mode4.update_timeout_us,
 			bond_mode_8023ad_periodic_cb, arg);
 }
@@ -966,6 +1053,11 @@ bond_mode_8023ad_deactivate_slave(struct rte_eth_dev *bond_dev,
 
 	while (rte_ring_dequeue(port->tx_ring, &pkt) == 0)
 			rte_pktmbuf_free((struct rte_mbuf *)pkt);
+
+	/* Stop distributing to this slave before it leaves the active list */
+	if (internals->mode4.dedicated_queues.enabled)
+		update_distributing_slaves(internals);
+
 	return 0;
 }
 
@@ -1142,6 +1234,89 @@ free_out:
 	rte_pktmbuf_free(pkt);
 }
 
+static int
+dedicated_queues_filter(uint8_t slave_id, uint16_t queue,
+		enum rte_filter_op filter_op)
+{
+	struct rte_eth_ethertype_filter filter = {
+		.mac_addr = { { 0 } },
+		.ether_type = ETHER_TYPE_SLOW,
+		.flags = 0,
+		.queue = queue,
+	};
+
+	return rte_eth_dev_filter_ctrl(slave_id, RTE_ETH_FILTER_ETHERTYPE,
+			filter_op, &filter);
+}
+
+int
+bond_mode_8023ad_dedicated_queues_supported(uint8_t slave_id)
+{
+	return rte_eth_dev_filter_supported(slave_id,
+			RTE_ETH_FILTER_ETHERTYPE);
+}
+
+int
+bond_mode_8023ad_dedicated_queues_setup(struct rte_eth_dev *dev,
+		uint8_t slave_id)
+{
+	struct bond_dev_private *internals = dev->data->dev_private;
+	struct port *port = &mode_8023ad_ports[slave_id];
+	uint16_t rx_qid = internals->mode4.dedicated_queues.rx_qid;
+	uint16_t tx_qid = internals->mode4.dedicated_queues.tx_qid;
+	char mem_name[RTE_ETH_NAME_MAX_LEN];
+	int socket_id = rte_eth_devices[slave_id].data->numa_node;
+	int retval;
+
+	if (port->slow_pool == NULL) {
+		snprintf(mem_name, RTE_DIM(mem_name), "slave_port%u_slow_pool",
+				slave_id);
+		port->slow_pool = rte_pktmbuf_pool_create(mem_name,
+				BOND_MODE_8023AX_DEDICATED_POOL_SIZE,
+				RTE_MEMPOOL_CACHE_MAX_SIZE >= 32 ?
+					32 : RTE_MEMPOOL_CACHE_MAX_SIZE,
+				0, RTE_MBUF_DEFAULT_BUF_SIZE, socket_id);
+		if (port->slow_pool == NULL) {
+			RTE_LOG(ERR, PMD,
+				"Slave %u: Failed to create memory pool '%s': %s\n",
+				slave_id, mem_name, rte_strerror(rte_errno));
+			return -ENOMEM;
+		}
+	}
+
+	retval = rte_eth_rx_queue_setup(slave_id, rx_qid,
+			BOND_MODE_8023AX_DEDICATED_RXQ_SIZE, socket_id, NULL,
+			port->slow_pool);
+	if (retval != 0)
+		return retval;
+
+	retval = rte_eth_tx_queue_setup(slave_id, tx_qid,
+			BOND_MODE_8023AX_DEDICATED_TXQ_SIZE, socket_id, NULL);
+	if (retval != 0)
+		return retval;
+
+	/* Filter may be left over from a previous start of the slave */
+	dedicated_queues_filter(slave_id, rx_qid, RTE_ETH_FILTER_DELETE);
+	return dedicated_queues_filter(slave_id, rx_qid, RTE_ETH_FILTER_ADD);
+}
+
+void
+bond_mode_8023ad_dedicated_queues_release(struct rte_eth_dev *dev,
+		uint8_t slave_id)
+{
+	struct bond_dev_private *internals = dev->data->dev_private;
+	struct port *port = &mode_8023ad_ports[slave_id];
+
+	dedicated_queues_filter(slave_id,
+			internals->mode4.dedicated_queues.rx_qid,
+			RTE_ETH_FILTER_DELETE);
+
+	/* A stopped slave holds no more mbufs of its slow packet pool */
+	rte_eth_dev_stop(slave_id);
+	rte_mempool_free(port->slow_pool);
+	port->slow_pool = NULL;
+}
+
 int
 rte_eth_bond_8023ad_conf_get(uint8_t port_id,
 		struct rte_eth_bond_8023ad_conf *conf)
@@ -1221,3 +1396,48 @@ rte_eth_bond_8023ad_slave_info(uint8_t port_id, uint8_t slave_id,
 	info->agg_port_id = port->aggregator_port_id;
 	return 0;
 }
+
+static int
+bond_8023ad_dedicated_queues_set(uint8_t port_id, uint8_t enable)
+{
+	struct rte_eth_dev *dev;
+	struct bond_dev_private *internals;
+	uint8_t i;
+
+	if (valid_bonded_port_id(port_id) != 0)
+		return -EINVAL;
+
+	dev = &rte_eth_devices[port_id];
+	internals = dev->data->dev_private;
+
+	if (internals->mode != BONDING_MODE_8023AD)
+		return -EINVAL;
+
+	/* Queues of the slaves are only reconfigured on device start */
+	if (dev->data->dev_started)
+		return -EINVAL;
+
+	if (enable) {
+		for (i = 0; i < internals->slave_count; i++)
+			if (bond_mode_8023ad_dedicated_queues_supported(
+					internals->slaves[i].port_id) != 0)
+				return -ENOTSUP;
+	}
+
+	internals->mode4.dedicated_queues.enabled = enable;
+	internals->mode4.distributing_count = 0;
+
+	return bond_ethdev_mode_set(dev, internals->mode);
+}
+
+int
+rte_eth_bond_8023ad_dedicated_queues_enable(uint8_t port_id)
+{
+	return bond_8023ad_dedicated_queues_set(port_id, 1);
+}
+
+int
+rte_eth_bond_8023ad_dedicated_queues_disable(uint8_t port_id)
+{
+	return bond_8023ad_dedicated_queues_set(port_id, 0);
+}
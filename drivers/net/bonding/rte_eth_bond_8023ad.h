@@ -215,6 +215,46 @@ int
 rte_eth_bond_8023ad_slave_info(uint8_t port_id, uint8_t slave_id,
 		struct rte_eth_bond_8023ad_slave_info *conf);
 
+/**
+ * Enable dedicated slave queues for the slow packets (LACP and marker
+ * frames) of a bonded port in mode 4.
+ *
+ * Every slave is configured with one more RX and TX queue than the bonded
+ * port. The slow packets received by a slave are steered to its extra RX
+ * queue by an ethertype filter, and the mode 4 state machines receive and
+ * send them on the extra queues. The RX and TX burst functions of the bonded
+ * port then never inspect nor inject slow packets, and no longer need to be
+ * called every 100ms for the LACP protocol to be handled.
+ *
+ * A slave removed from the bonded port is stopped and the mempool backing its
+ * extra RX queue is freed, so the slave must be configured again before it
+ * is restarted.
+ *
+ * @pre Bonded port must be stopped, and its slaves must support ethertype
+ * filters.
+ *
+ * @param port_id	Bonding device id
+ *
+ * @return
+ *   0 on success, negative value otherwise.
+ */
+int
+rte_eth_bond_8023ad_dedicated_queues_enable(uint8_t port_id);
+
+/**
+ * Disable dedicated slave queues for the slow packets of a bonded port in
+ * mode 4, they are handled by the RX and TX burst functions again.
+ *
+ * @pre Bonded port must be stopped.
+ *
+ * @param port_id	Bonding device id
+ *
+ * @return
+ *   0 on success, negative value otherwise.
+ */
+int
+rte_eth_bond_8023ad_dedicated_queues_disable(uint8_t port_id);
+
 #ifdef __cplusplus
 }
 #endif
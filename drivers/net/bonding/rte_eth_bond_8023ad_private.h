@@ -47,6 +47,11 @@
 #define BOND_MODE_8023AX_SLAVE_RX_PKTS        3
 /** Maximum number of LACP packets from one slave queued in TX ring. */
 #define BOND_MODE_8023AX_SLAVE_TX_PKTS        1
+/** Number of descriptors of the slave queues dedicated to slow packets. */
+#define BOND_MODE_8023AX_DEDICATED_RXQ_SIZE   128
+#define BOND_MODE_8023AX_DEDICATED_TXQ_SIZE   128
+/** Number of mbufs backing the RX queue dedicated to slow packets. */
+#define BOND_MODE_8023AX_DEDICATED_POOL_SIZE  511
 /**
  * Timeouts deffinitions (5.4.4 in 802.1AX documentation).
  */
@@ -155,6 +160,9 @@ struct port {
 	/** Ring of slow protocol packets (LACP and MARKERS) to TX burst function */
 	struct rte_ring *tx_ring;
 
+	/** Memory pool of the RX queue dedicated to slow packets */
+	struct rte_mempool *slow_pool;
+
 	/** Timer which is also used as mutex. If is 0 (not running) RX marker
 	 * packet might be responded. Otherwise shall be dropped. It is zeroed in
 	 * mode 4 callback function after expire. */
@@ -173,6 +181,20 @@ struct mode8023ad_private {
 	uint64_t tx_period_timeout;
 	uint64_t rx_marker_timeout;
 	uint64_t update_timeout_us;
+
+	struct {
+		uint8_t enabled;
+		/**< Slow packets use dedicated slave queues */
+		uint16_t rx_qid;
+		/**< Slave RX queue the slow packets are steered to */
+		uint16_t tx_qid;
+		/**< Slave TX queue the slow packets are sent on */
+	} dedicated_queues;
+
+	/** Number of active slaves in distributing state */
+	volatile uint8_t distributing_count;
+	/** Active slaves in distributing state, updated by state machines */
+	uint8_t distributing_slaves[RTE_MAX_ETHPORTS];
 };
 
 /**
@@ -298,6 +320,52 @@ bond_mode_8023ad_activate_slave(struct rte_eth_dev *dev, uint8_t port_id);
 int
 bond_mode_8023ad_deactivate_slave(struct rte_eth_dev *dev, uint8_t slave_pos);
 
+/**
+ * @internal
+ *
+ * Sets up the slave queues dedicated to slow packets and steers the slow
+ * packets received by the slave to its dedicated RX queue.
+ *
+ * @pre Slave must be configured with one more RX and TX queue than the
+ * bonded interface, and must not be started.
+ *
+ * @param dev       Bonded interface.
+ * @param slave_id  Slave port ID.
+ *
+ * @return
+ *  0 on success, negative value otherwise.
+ */
+int
+bond_mode_8023ad_dedicated_queues_setup(struct rte_eth_dev *dev,
+		uint8_t slave_id);
+
+/**
+ * @internal
+ *
+ * Checks if a slave can steer slow packets to a dedicated queue.
+ *
+ * @param slave_id  Slave port ID.
+ *
+ * @return
+ *  0 if supported, negative value otherwise.
+ */
+int
+bond_mode_8023ad_dedicated_queues_supported(uint8_t slave_id);
+
+/**
+ * @internal
+ *
+ * Removes the slow packet filter of a slave leaving the bonded interface or
+ * no longer using dedicated queues. The slave is stopped and the memory pool
+ * of its dedicated RX queue is freed.
+ *
+ * @param dev       Bonded interface.
+ * @param slave_id  Slave port ID.
+ */
+void
+bond_mode_8023ad_dedicated_queues_release(struct rte_eth_dev *dev,
+		uint8_t slave_id);
+
 /**
  * Updates state when MAC was changed on bonded device or one of its slaves.
  * @param bond_dev Bonded device
@@ -45,6 +45,7 @@
 #include <rte_dev.h>
 #include <rte_alarm.h>
 #include <rte_cycles.h>
+#include <rte_prefetch.h>
 
 #include "rte_eth_bond.h"
 #include "rte_eth_bond_private.h"
@@ -54,6 +55,9 @@
 
 #define HASH_L4_PORTS(h) ((h)->src_port ^ (h)->dst_port)
 
+/* Number of packets whose headers are prefetched ahead of hashing */
+#define BURST_HASH_PREFETCH_OFFSET 4
+
 /* Table for statistics in mode 5 TLB */
 static uint64_t tlb_last_obytets[RTE_MAX_ETHPORTS];
 
@@ -194,6 +198,72 @@ bond_ethdev_rx_burst_8023ad(void *queue, struct rte_mbuf **bufs,
 	return num_rx_total;
 }
 
+static uint16_t
+bond_ethdev_rx_burst_8023ad_fast_queue(void *queue, struct rte_mbuf **bufs,
+		uint16_t nb_pkts)
+{
+	/* Cast to structure, containing bonded device's port id and queue id */
+	struct bond_rx_queue *bd_rx_q = (struct bond_rx_queue *)queue;
+	struct bond_dev_private *internals = bd_rx_q->dev_private;
+	struct ether_addr bond_mac;
+
+	struct ether_hdr *hdr;
+
+	uint16_t num_rx_total = 0;	/* Total number of received packets */
+	uint16_t num_rx_slave;
+	uint8_t slaves[RTE_MAX_ETHPORTS];
+	uint8_t slave_count;
+
+	const uint8_t promisc = internals->promiscuous_en;
+	uint16_t j, k;
+	uint8_t i;
+
+	if (!promisc)
+		rte_eth_macaddr_get(internals->port_id, &bond_mac);
+
+	/* Copy slave list to protect against slave up/down changes during rx
+	 * bursting */
+	slave_count = internals->active_slave_count;
+	memcpy(slaves, internals->active_slaves,
+			sizeof(internals->active_slaves[0]) * slave_count);
+
+	for (i = 0; i < slave_count && num_rx_total < nb_pkts; i++) {
+		/* Slow packets are steered to a dedicated queue, so received
+		 * packets are only checked against the collecting state and the
+		 * MAC address of the bonded device */
+		num_rx_slave = rte_eth_rx_burst(slaves[i], bd_rx_q->queue_id,
+				&bufs[num_rx_total], nb_pkts - num_rx_total);
+		if (num_rx_slave == 0)
+			continue;
+
+		if (unlikely(!ACTOR_STATE(&mode_8023ad_ports[slaves[i]],
+				COLLECTING))) {
+			for (j = 0; j < num_rx_slave; j++)
+				rte_pktmbuf_free(bufs[num_rx_total + j]);
+			continue;
+		}
+
+		if (promisc) {
+			num_rx_total += num_rx_slave;
+			continue;
+		}
+
+		for (j = num_rx_total, k = num_rx_total;
+				j < num_rx_total + num_rx_slave; j++) {
+			hdr = rte_pktmbuf_mtod(bufs[j], struct ether_hdr *);
+			if (likely(is_multicast_ether_addr(&hdr->d_addr) ||
+					is_same_ether_addr(&bond_mac,
+						&hdr->d_addr)))
+				bufs[k++] = bufs[j];
+			else
+				rte_pktmbuf_free(bufs[j]);
+		}
+		num_rx_total = k;
+	}
+
+	return num_rx_total;
+}
+
 #if defined(RTE_LIBRTE_BOND_DEBUG_ALB) || defined(RTE_LIBRTE_BOND_DEBUG_ALB_L1)
 uint32_t burstnumberRX;
 uint32_t burstnumberTX;
@@ -498,18 +568,18 @@ ipv6_hash(struct ipv6_hdr *ipv6_hdr)
 			(word_src_addr[3] ^ word_dst_addr[3]);
 }
 
-uint16_t
-xmit_l2_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+static inline uint32_t
+l2_hash(const struct rte_mbuf *buf)
 {
 	struct ether_hdr *eth_hdr = rte_pktmbuf_mtod(buf, struct ether_hdr *);
 
 	uint32_t hash = ether_hash(eth_hdr);
 
-	return (hash ^= hash >> 8) % slave_count;
+	return hash ^ (hash >> 8);
 }
 
-uint16_t
-xmit_l23_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+static inline uint32_t
+l23_hash(const struct rte_mbuf *buf)
 {
 	struct ether_hdr *eth_hdr = rte_pktmbuf_mtod(buf, struct ether_hdr *);
 	uint16_t proto = eth_hdr->ether_type;
@@ -533,11 +603,11 @@ xmit_l23_hash(const struct rte_mbuf *buf, uint8_t slave_count)
 	hash ^= hash >> 16;
 	hash ^= hash >> 8;
 
-	return hash % slave_count;
+	return hash;
 }
 
-uint16_t
-xmit_l34_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+static inline uint32_t
+l34_hash(const struct rte_mbuf *buf)
 {
 	struct ether_hdr *eth_hdr = rte_pktmbuf_mtod(buf, struct ether_hdr *);
 	uint16_t proto = eth_hdr->ether_type;
@@ -587,7 +657,71 @@ xmit_l34_hash(const struct rte_mbuf *buf, uint8_t slave_count)
 	hash ^= hash >> 16;
 	hash ^= hash >> 8;
 
-	return hash % slave_count;
+	return hash;
+}
+
+uint16_t
+xmit_l2_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+{
+	return l2_hash(buf) % slave_count;
+}
+
+uint16_t
+xmit_l23_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+{
+	return l23_hash(buf) % slave_count;
+}
+
+uint16_t
+xmit_l34_hash(const struct rte_mbuf *buf, uint8_t slave_count)
+{
+	return l34_hash(buf) % slave_count;
+}
+
+/*
+ * Select the output slave of each packet of a burst. Hashing is bound by the
+ * loads of the packet headers, so the headers of the next packets are
+ * prefetched while hashing the current one. The hash function is inlined by
+ * the callers.
+ */
+static inline __attribute__((always_inline)) void
+burst_xmit_hash(struct rte_mbuf **buf, uint16_t nb_pkts, uint8_t slave_count,
+		uint16_t *slaves, uint32_t (*hash)(const struct rte_mbuf *))
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts && i < BURST_HASH_PREFETCH_OFFSET; i++)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i], void *));
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (i + BURST_HASH_PREFETCH_OFFSET < nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(
+					buf[i + BURST_HASH_PREFETCH_OFFSET],
+					void *));
+
+		slaves[i] = (*hash)(buf[i]) % slave_count;
+	}
+}
+
+void
+burst_xmit_l2_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash(buf, nb_pkts, slave_count, slaves, l2_hash);
+}
+
+void
+burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash(buf, nb_pkts, slave_count, slaves, l23_hash);
+}
+
+void
+burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves)
+{
+	burst_xmit_hash(buf, nb_pkts, slave_count, slaves, l34_hash);
 }
 
 struct bwg_slave {
@@ -894,6 +1028,59 @@ bond_ethdev_tx_burst_alb(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_tx_total;
 }
 
+/*
+ * Spread a burst over slaves using the transmit policy hash, the packets
+ * which could not be sent are moved to the end of bufs.
+ */
+static inline uint16_t
+tx_burst_distribute(struct bond_dev_private *internals, uint16_t queue_id,
+		struct rte_mbuf **bufs, uint16_t nb_pkts,
+		const uint8_t *slaves, uint8_t num_of_slaves)
+{
+	uint16_t num_tx_total = 0, num_tx_slave, tx_fail_total = 0;
+	uint16_t bufs_slave_idx[nb_pkts];
+	uint16_t i;
+
+	struct rte_mbuf *slave_bufs[num_of_slaves][nb_pkts];
+	uint16_t slave_nb_pkts[num_of_slaves];
+
+	memset(slave_nb_pkts, 0, sizeof(slave_nb_pkts));
+
+	/* Select output slave of every packet using the xmit policy hash */
+	internals->burst_xmit_hash(bufs, nb_pkts, num_of_slaves,
+			bufs_slave_idx);
+
+	/* Populate slaves mbuf with the packets which are to be sent on it */
+	for (i = 0; i < nb_pkts; i++) {
+		uint16_t idx = bufs_slave_idx[i];
+
+		slave_bufs[idx][slave_nb_pkts[idx]++] = bufs[i];
+	}
+
+	/* Send packet burst on each slave device */
+	for (i = 0; i < num_of_slaves; i++) {
+		if (slave_nb_pkts[i] == 0)
+			continue;
+
+		num_tx_slave = rte_eth_tx_burst(slaves[i], queue_id,
+				slave_bufs[i], slave_nb_pkts[i]);
+
+		/* if tx burst fails move packets to end of bufs */
+		if (unlikely(num_tx_slave < slave_nb_pkts[i])) {
+			int slave_tx_fail_count = slave_nb_pkts[i] - num_tx_slave;
+
+			tx_fail_total += slave_tx_fail_count;
+			memcpy(&bufs[nb_pkts - tx_fail_total],
+					&slave_bufs[i][num_tx_slave],
+					slave_tx_fail_count * sizeof(bufs[0]));
+		}
+
+		num_tx_total += num_tx_slave;
+	}
+
+	return num_tx_total;
+}
+
 static uint16_t
 bond_ethdev_tx_burst_balance(void *queue, struct rte_mbuf **bufs,
 		uint16_t nb_pkts)
@@ -904,13 +1091,6 @@ bond_ethdev_tx_burst_balance(void *queue, struct rte_mbuf **bufs,
 	uint8_t num_of_slaves;
 	uint8_t slaves[RTE_MAX_ETHPORTS];
 
-	uint16_t num_tx_total = 0, num_tx_slave = 0, tx_fail_total = 0;
-
-	int i, op_slave_id;
-
-	struct rte_mbuf *slave_bufs[RTE_MAX_ETHPORTS][nb_pkts];
-	uint16_t slave_nb_pkts[RTE_MAX_ETHPORTS] = { 0 };
-
 	bd_tx_q = (struct bond_tx_queue *)queue;
 	internals = bd_tx_q->dev_private;
 
@@ -920,39 +1100,11 @@ bond_ethdev_tx_burst_balance(void *queue, struct rte_mbuf **bufs,
 	memcpy(slaves, internals->active_slaves,
 			sizeof(internals->active_slaves[0]) * num_of_slaves);
 
-	if (num_of_slaves < 1)
-		return num_tx_total;
-
-	/* Populate slaves mbuf with the packets which are to be sent on it  */
-	for (i = 0; i < nb_pkts; i++) {
-		/* Select output slave using hash based on xmit policy */
-		op_slave_id = internals->xmit_hash(bufs[i], num_of_slaves);
-
-		/* Populate slave mbuf arrays with mbufs for that slave */
-		slave_bufs[op_slave_id][slave_nb_pkts[op_slave_id]++] = bufs[i];
-	}
-
-	/* Send packet burst on each slave device */
-	for (i = 0; i < num_of_slaves; i++) {
-		if (slave_nb_pkts[i] > 0) {
-			num_tx_slave = rte_eth_tx_burst(slaves[i], bd_tx_q->queue_id,
-					slave_bufs[i], slave_nb_pkts[i]);
-
-			/* if tx burst fails move packets to end of bufs */
-			if (unlikely(num_tx_slave < slave_nb_pkts[i])) {
-				int slave_tx_fail_count = slave_nb_pkts[i] - num_tx_slave;
-
-				tx_fail_total += slave_tx_fail_count;
-				memcpy(&bufs[nb_pkts - tx_fail_total],
-						&slave_bufs[i][num_tx_slave],
-						slave_tx_fail_count * sizeof(bufs[0]));
-			}
-
-			num_tx_total += num_tx_slave;
-		}
-	}
+	if (num_of_slaves < 1 || nb_pkts == 0)
+		return 0;
 
-	return num_tx_total;
+	return tx_burst_distribute(internals, bd_tx_q->queue_id, bufs, nb_pkts,
+			slaves, num_of_slaves);
 }
 
 static uint16_t
@@ -969,8 +1121,9 @@ bond_ethdev_tx_burst_8023ad(void *queue, struct rte_mbuf **bufs,
 	uint8_t distributing_count;
 
 	uint16_t num_tx_slave, num_tx_total = 0, num_tx_fail_total = 0;
-	uint16_t i, j, op_slave_idx;
+	uint16_t i, j;
 	const uint16_t buffs_size = nb_pkts + BOND_MODE_8023AX_SLAVE_TX_PKTS + 1;
+	uint16_t bufs_slave_idx[nb_pkts];
 
 	/* Allocate additional packets in case 8023AD mode. */
 	struct rte_mbuf *slave_bufs[RTE_MAX_ETHPORTS][buffs_size];
@@ -1007,15 +1160,16 @@ bond_ethdev_tx_burst_8023ad(void *queue, struct rte_mbuf **bufs,
 			distributing_offsets[distributing_count++] = i;
 	}
 
-	if (likely(distributing_count > 0)) {
+	if (likely(distributing_count > 0 && nb_pkts > 0)) {
+		/* Select output slave using hash based on xmit policy */
+		internals->burst_xmit_hash(bufs, nb_pkts, distributing_count,
+				bufs_slave_idx);
+
 		/* Populate slaves mbuf with the packets which are to be sent on it */
 		for (i = 0; i < nb_pkts; i++) {
-			/* Select output slave using hash based on xmit policy */
-			op_slave_idx = internals->xmit_hash(bufs[i], distributing_count);
-
 			/* Populate slave mbuf arrays with mbufs for that slave. Use only
 			 * slaves that are currently distributing. */
-			uint8_t slave_offset = distributing_offsets[op_slave_idx];
+			uint8_t slave_offset = distributing_offsets[bufs_slave_idx[i]];
 			slave_bufs[slave_offset][slave_nb_pkts[slave_offset]] = bufs[i];
 			slave_nb_pkts[slave_offset]++;
 		}
@@ -1047,6 +1201,29 @@ bond_ethdev_tx_burst_8023ad(void *queue, struct rte_mbuf **bufs,
 	return num_tx_total;
 }
 
+static uint16_t
+bond_ethdev_tx_burst_8023ad_fast_queue(void *queue, struct rte_mbuf **bufs,
+		uint16_t nb_pkts)
+{
+	struct bond_tx_queue *bd_tx_q = (struct bond_tx_queue *)queue;
+	struct bond_dev_private *internals = bd_tx_q->dev_private;
+
+	uint8_t distributing_count;
+	uint8_t slaves[RTE_MAX_ETHPORTS];
+
+	/* Slow packets are sent on dedicated queues by the state machines, only
+	 * take a copy of the slaves currently distributing */
+	distributing_count = internals->mode4.distributing_count;
+	if (unlikely(distributing_count == 0 || nb_pkts == 0))
+		return 0;
+
+	memcpy(slaves, internals->mode4.distributing_slaves,
+			sizeof(slaves[0]) * distributing_count);
+
+	return tx_burst_distribute(internals, bd_tx_q->queue_id, bufs, nb_pkts,
+			slaves, distributing_count);
+}
+
 static uint16_t
 bond_ethdev_tx_burst_broadcast(void *queue, struct rte_mbuf **bufs,
 		uint16_t nb_pkts)
@@ -1272,11 +1449,18 @@ bond_ethdev_mode_set(struct rte_eth_dev *eth_dev, int mode)
 		if (bond_mode_8023ad_enable(eth_dev) != 0)
 			return -1;
 
-		eth_dev->rx_pkt_burst = bond_ethdev_rx_burst_8023ad;
-		eth_dev->tx_pkt_burst = bond_ethdev_tx_burst_8023ad;
-		RTE_LOG(WARNING, PMD,
+		if (internals->mode4.dedicated_queues.enabled) {
+			eth_dev->rx_pkt_burst =
+					bond_ethdev_rx_burst_8023ad_fast_queue;
+			eth_dev->tx_pkt_burst =
+					bond_ethdev_tx_burst_8023ad_fast_queue;
+		} else {
+			eth_dev->rx_pkt_burst = bond_ethdev_rx_burst_8023ad;
+			eth_dev->tx_pkt_burst = bond_ethdev_tx_burst_8023ad;
+			RTE_LOG(WARNING, PMD,
 				"Using mode 4, it is necessary to do TX burst and RX burst "
 				"at least every 100ms.\n");
+		}
 		break;
 	case BONDING_MODE_TLB:
 		eth_dev->tx_pkt_burst = bond_ethdev_tx_burst_tlb;
@@ -1305,8 +1489,14 @@ slave_configure(struct rte_eth_dev *bonded_eth_dev,
 	struct bond_rx_queue *bd_rx_q;
 	struct bond_tx_queue *bd_tx_q;
 
+	struct bond_dev_private *internals = bonded_eth_dev->data->dev_private;
+
 	uint16_t old_nb_tx_queues = slave_eth_dev->data->nb_tx_queues;
 	uint16_t old_nb_rx_queues = slave_eth_dev->data->nb_rx_queues;
+	uint16_t nb_rx_queues = bonded_eth_dev->data->nb_rx_queues;
+	uint16_t nb_tx_queues = bonded_eth_dev->data->nb_tx_queues;
+	int dedicated_queues = internals->mode == BONDING_MODE_8023AD &&
+			internals->mode4.dedicated_queues.enabled;
 	int errval;
 	uint16_t q_id;
 
@@ -1335,10 +1525,15 @@ slave_configure(struct rte_eth_dev *bonded_eth_dev,
 				bonded_eth_dev->data->dev_conf.rxmode.mq_mode;
 	}
 
+	/* Slow packets use an extra queue on top of the bonded device ones */
+	if (dedicated_queues) {
+		internals->mode4.dedicated_queues.rx_qid = nb_rx_queues++;
+		internals->mode4.dedicated_queues.tx_qid = nb_tx_queues++;
+	}
+
 	/* Configure device */
 	errval = rte_eth_dev_configure(slave_eth_dev->data->port_id,
-			bonded_eth_dev->data->nb_rx_queues,
-			bonded_eth_dev->data->nb_tx_queues,
+			nb_rx_queues, nb_tx_queues,
 			&(slave_eth_dev->data->dev_conf));
 	if (errval != 0) {
 		RTE_BOND_LOG(ERR, "Cannot configure slave device: port %u , err (%d)",
@@ -1346,6 +1541,13 @@ slave_configure(struct rte_eth_dev *bonded_eth_dev,
 		return errval;
 	}
 
+	/* Dedicated queues were disabled since the slave was last configured */
+	if (!dedicated_queues &&
+			mode_8023ad_ports[slave_eth_dev->data->port_id].slow_pool !=
+				NULL)
+		bond_mode_8023ad_dedicated_queues_release(bonded_eth_dev,
+				slave_eth_dev->data->port_id);
+
 	/* Setup Rx Queues */
 	/* Use existing queues, if any */
 	for (q_id = old_nb_rx_queues;
@@ -1382,6 +1584,17 @@ slave_configure(struct rte_eth_dev *bonded_eth_dev,
 		}
 	}
 
+	if (dedicated_queues) {
+		errval = bond_mode_8023ad_dedicated_queues_setup(bonded_eth_dev,
+				slave_eth_dev->data->port_id);
+		if (errval != 0) {
+			RTE_BOND_LOG(ERR,
+					"Cannot set up slow packet queues: port=%u, err (%d)",
+					slave_eth_dev->data->port_id, errval);
+			return errval;
+		}
+	}
+
 	/* Start device */
 	errval = rte_eth_dev_start(slave_eth_dev->data->port_id);
 	if (errval != 0) {
@@ -1603,6 +1816,7 @@ bond_ethdev_stop(struct rte_eth_dev *eth_dev)
 		void *pkt = NULL;
 
 		bond_mode_8023ad_stop(eth_dev);
+		internals->mode4.distributing_count = 0;
 
 		/* Discard all messages to/from mode 4 state machines */
 		for (i = 0; i < internals->active_slave_count; i++) {
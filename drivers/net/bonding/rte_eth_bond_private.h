@@ -110,6 +110,9 @@ struct bond_slave_details {
 
 typedef uint16_t (*xmit_hash_t)(const struct rte_mbuf *buf, uint8_t slave_count);
 
+typedef void (*burst_xmit_hash_t)(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves);
+
 /** Link Bonding PMD device private configuration Structure */
 struct bond_dev_private {
 	uint8_t port_id;					/**< Port Id of Bonded Port */
@@ -126,6 +129,8 @@ struct bond_dev_private {
 	/**< Transmit policy - l2 / l23 / l34 for operation in balance mode */
 	xmit_hash_t xmit_hash;
 	/**< Transmit policy hash function */
+	burst_xmit_hash_t burst_xmit_hash;
+	/**< Transmit policy hash function applied to a whole burst */
 
 	uint8_t user_defined_mac;
 	/**< Flag for whether MAC address is user defined or not */
@@ -251,6 +256,18 @@ xmit_l23_hash(const struct rte_mbuf *buf, uint8_t slave_count);
 uint16_t
 xmit_l34_hash(const struct rte_mbuf *buf, uint8_t slave_count);
 
+void
+burst_xmit_l2_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves);
+
+void
+burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves);
+
+void
+burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint8_t slave_count, uint16_t *slaves);
+
 void
 bond_ethdev_primary_set(struct bond_dev_private *internals,
 		uint8_t slave_port_id);
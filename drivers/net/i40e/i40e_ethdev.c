@@ -306,6 +306,9 @@ static void i40e_dev_stats_get(struct rte_eth_dev *dev,
 			       struct rte_eth_stats *stats);
 static int i40e_dev_xstats_get(struct rte_eth_dev *dev,
 			       struct rte_eth_xstats *xstats, unsigned n);
+static int i40e_dev_xstats_get_by_id(struct rte_eth_dev *dev,
+				     const uint64_t *ids, uint64_t *values,
+				     unsigned n);
 static void i40e_dev_stats_reset(struct rte_eth_dev *dev);
 static int i40e_dev_queue_stats_mapping_set(struct rte_eth_dev *dev,
 					    uint16_t queue_id,
@@ -469,6 +472,7 @@ static const struct eth_dev_ops i40e_eth_dev_ops = {
 	.xstats_get                   = i40e_dev_xstats_get,
 	.stats_reset                  = i40e_dev_stats_reset,
 	.xstats_reset                 = i40e_dev_stats_reset,
+	.xstats_get_by_id             = i40e_dev_xstats_get_by_id,
 	.queue_stats_mapping_set      = i40e_dev_queue_stats_mapping_set,
 	.dev_infos_get                = i40e_dev_info_get,
 	.dev_supported_ptypes_get     = i40e_dev_supported_ptypes_get,
@@ -2271,6 +2275,51 @@ i40e_dev_xstats_get(struct rte_eth_dev *dev, struct rte_eth_xstats *xstats,
 	return count;
 }
 
+static int
+i40e_dev_xstats_get_by_id(struct rte_eth_dev *dev, const uint64_t *ids,
+			  uint64_t *values, unsigned n)
+{
+	struct i40e_pf *pf = I40E_DEV_PRIVATE_TO_PF(dev->data->dev_private);
+	struct i40e_hw *hw = I40E_DEV_PRIVATE_TO_HW(dev->data->dev_private);
+	struct i40e_hw_port_stats *hw_stats = &pf->stats;
+	uint64_t id;
+	unsigned i;
+	char *base;
+
+	for (i = 0; i < n; i++)
+		if (ids[i] >= i40e_xstats_calc_num())
+			return -EINVAL;
+
+	i40e_read_stats_registers(pf, hw);
+
+	for (i = 0; i < n; i++) {
+		id = ids[i];
+		if (id < I40E_NB_ETH_XSTATS) {
+			base = (char *)&hw_stats->eth +
+				rte_i40e_stats_strings[id].offset;
+		} else if (id < I40E_NB_ETH_XSTATS + I40E_NB_HW_PORT_XSTATS) {
+			id -= I40E_NB_ETH_XSTATS;
+			base = (char *)hw_stats +
+				rte_i40e_hw_port_strings[id].offset;
+		} else if (id < I40E_NB_ETH_XSTATS + I40E_NB_HW_PORT_XSTATS +
+				I40E_NB_RXQ_PRIO_XSTATS * 8) {
+			id -= I40E_NB_ETH_XSTATS + I40E_NB_HW_PORT_XSTATS;
+			base = (char *)hw_stats +
+				rte_i40e_rxq_prio_strings[id / 8].offset +
+				sizeof(uint64_t) * (id % 8);
+		} else {
+			id -= I40E_NB_ETH_XSTATS + I40E_NB_HW_PORT_XSTATS +
+				I40E_NB_RXQ_PRIO_XSTATS * 8;
+			base = (char *)hw_stats +
+				rte_i40e_txq_prio_strings[id / 8].offset +
+				sizeof(uint64_t) * (id % 8);
+		}
+		values[i] = *(uint64_t *)base;
+	}
+
+	return n;
+}
+
 static int
 i40e_dev_queue_stats_mapping_set(__rte_unused struct rte_eth_dev *dev,
 				 __rte_unused uint16_t queue_id,
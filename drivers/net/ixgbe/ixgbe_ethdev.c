@@ -175,6 +175,9 @@ static void ixgbe_dev_stats_get(struct rte_eth_dev *dev,
 				struct rte_eth_stats *stats);
 static int ixgbe_dev_xstats_get(struct rte_eth_dev *dev,
 				struct rte_eth_xstats *xstats, unsigned n);
+static int ixgbe_dev_xstats_get_by_id(struct rte_eth_dev *dev,
+				const uint64_t *ids, uint64_t *values,
+				unsigned n);
 static int ixgbevf_dev_xstats_get(struct rte_eth_dev *dev,
 				  struct rte_eth_xstats *xstats, unsigned n);
 static void ixgbe_dev_stats_reset(struct rte_eth_dev *dev);
@@ -466,6 +469,7 @@ static const struct eth_dev_ops ixgbe_eth_dev_ops = {
 	.xstats_get           = ixgbe_dev_xstats_get,
 	.stats_reset          = ixgbe_dev_stats_reset,
 	.xstats_reset         = ixgbe_dev_xstats_reset,
+	.xstats_get_by_id     = ixgbe_dev_xstats_get_by_id,
 	.queue_stats_mapping_set = ixgbe_dev_queue_stats_mapping_set,
 	.dev_infos_get        = ixgbe_dev_info_get,
 	.dev_supported_ptypes_get = ixgbe_dev_supported_ptypes_get,
@@ -2767,6 +2771,51 @@ ixgbe_dev_xstats_get(struct rte_eth_dev *dev, struct rte_eth_xstats *xstats,
 	return count;
 }
 
+static int
+ixgbe_dev_xstats_get_by_id(struct rte_eth_dev *dev, const uint64_t *ids,
+			   uint64_t *values, unsigned n)
+{
+	struct ixgbe_hw *hw =
+			IXGBE_DEV_PRIVATE_TO_HW(dev->data->dev_private);
+	struct ixgbe_hw_stats *hw_stats =
+			IXGBE_DEV_PRIVATE_TO_STATS(dev->data->dev_private);
+	uint64_t total_missed_rx, total_qbrc, total_qprc, total_qprdc;
+	uint64_t id;
+	unsigned i, offset;
+
+	for (i = 0; i < n; i++)
+		if (ids[i] >= ixgbe_xstats_calc_num())
+			return -EINVAL;
+
+	total_missed_rx = 0;
+	total_qbrc = 0;
+	total_qprc = 0;
+	total_qprdc = 0;
+
+	/* The counters are cleared on read, so they are all accumulated */
+	ixgbe_read_stats_registers(hw, hw_stats, &total_missed_rx, &total_qbrc,
+				   &total_qprc, &total_qprdc);
+
+	for (i = 0; i < n; i++) {
+		id = ids[i];
+		if (id < IXGBE_NB_HW_STATS) {
+			offset = rte_ixgbe_stats_strings[id].offset;
+		} else if (id < IXGBE_NB_HW_STATS +
+				IXGBE_NB_RXQ_PRIO_STATS * 8) {
+			id -= IXGBE_NB_HW_STATS;
+			offset = rte_ixgbe_rxq_strings[id / 8].offset +
+				sizeof(uint64_t) * (id % 8);
+		} else {
+			id -= IXGBE_NB_HW_STATS + IXGBE_NB_RXQ_PRIO_STATS * 8;
+			offset = rte_ixgbe_txq_strings[id / 8].offset +
+				sizeof(uint64_t) * (id % 8);
+		}
+		values[i] = *(uint64_t *)(((char *)hw_stats) + offset);
+	}
+
+	return n;
+}
+
 static void
 ixgbe_dev_xstats_reset(struct rte_eth_dev *dev)
 {
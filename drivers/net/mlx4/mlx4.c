@@ -1225,11 +1225,15 @@ mlx4_mp2mr(struct ibv_pd *pd, const struct rte_mempool *mp)
 	      (const void *)mp, (void *)start, (void *)end,
 	      (size_t)(end - start));
 	/* Round start and end to page boundary if found in memory segments. */
-	for (i = 0; (i < RTE_MAX_MEMSEG) && (ms[i].addr != NULL); ++i) {
+	for (i = 0; (i < RTE_MAX_MEMSEG); ++i) {
 		uintptr_t addr = (uintptr_t)ms[i].addr;
 		size_t len = ms[i].len;
 		unsigned int align = ms[i].hugepage_sz;
 
+		/* Segments released at runtime leave holes. */
+		if (ms[i].addr == NULL)
+			continue;
+
 		if ((start > addr) && (start < addr + len))
 			start = RTE_ALIGN_FLOOR(start, align);
 		if ((end > addr) && (end < addr + len))
@@ -120,6 +120,54 @@ pipeline_msg_req_stats_table_handler(struct pipeline *p,
 	return rsp;
 }
 
+void *
+pipeline_msg_req_cycles_port_in_handler(struct pipeline *p,
+	void *msg)
+{
+	struct pipeline_stats_msg_req *req = msg;
+	struct pipeline_cycles_port_in_msg_rsp *rsp = msg;
+	uint32_t port_id;
+
+	/* Check request */
+	if (req->id >= p->n_ports_in) {
+		rsp->status = -1;
+		return rsp;
+	}
+	port_id = p->port_in_id[req->id];
+
+	/* Process request */
+	rsp->status = rte_pipeline_port_in_cycles_read(p->p,
+		port_id,
+		&rsp->cycles,
+		1);
+
+	return rsp;
+}
+
+void *
+pipeline_msg_req_cycles_table_handler(struct pipeline *p,
+	void *msg)
+{
+	struct pipeline_stats_msg_req *req = msg;
+	struct pipeline_cycles_table_msg_rsp *rsp = msg;
+	uint32_t table_id;
+
+	/* Check request */
+	if (req->id >= p->n_tables) {
+		rsp->status = -1;
+		return rsp;
+	}
+	table_id = p->table_id[req->id];
+
+	/* Process request */
+	rsp->status = rte_pipeline_table_cycles_read(p->p,
+		table_id,
+		&rsp->cycles,
+		1);
+
+	return rsp;
+}
+
 void *
 pipeline_msg_req_port_in_enable_handler(struct pipeline *p,
 	void *msg)
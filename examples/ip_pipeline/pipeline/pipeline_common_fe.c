@@ -227,6 +227,97 @@ app_pipeline_stats_table(struct app_params *app,
 	return status;
 }
 
+int
+app_pipeline_cycles_port_in(struct app_params *app,
+	uint32_t pipeline_id,
+	uint32_t port_id,
+	struct rte_pipeline_port_in_cycles *cycles)
+{
+	struct app_pipeline_params *p;
+	struct pipeline_stats_msg_req *req;
+	struct pipeline_cycles_port_in_msg_rsp *rsp;
+	int status = 0;
+
+	/* Check input arguments */
+	if ((app == NULL) ||
+		(cycles == NULL))
+		return -1;
+
+	APP_PARAM_FIND_BY_ID(app->pipeline_params, "PIPELINE", pipeline_id, p);
+	if ((p == NULL) ||
+		(port_id >= p->n_pktq_in))
+		return -1;
+
+	/* Message buffer allocation */
+	req = app_msg_alloc(app);
+	if (req == NULL)
+		return -1;
+
+	/* Fill in request */
+	req->type = PIPELINE_MSG_REQ_CYCLES_PORT_IN;
+	req->id = port_id;
+
+	/* Send request and wait for response */
+	rsp = app_msg_send_recv(app, pipeline_id, req, MSG_TIMEOUT_DEFAULT);
+	if (rsp == NULL)
+		return -1;
+
+	/* Check response */
+	status = rsp->status;
+	if (status == 0)
+		memcpy(cycles, &rsp->cycles, sizeof(rsp->cycles));
+
+	/* Message buffer free */
+	app_msg_free(app, rsp);
+
+	return status;
+}
+
+int
+app_pipeline_cycles_table(struct app_params *app,
+	uint32_t pipeline_id,
+	uint32_t table_id,
+	struct rte_pipeline_table_cycles *cycles)
+{
+	struct app_pipeline_params *p;
+	struct pipeline_stats_msg_req *req;
+	struct pipeline_cycles_table_msg_rsp *rsp;
+	int status = 0;
+
+	/* Check input arguments */
+	if ((app == NULL) ||
+		(cycles == NULL))
+		return -1;
+
+	APP_PARAM_FIND_BY_ID(app->pipeline_params, "PIPELINE", pipeline_id, p);
+	if (p == NULL)
+		return -1;
+
+	/* Message buffer allocation */
+	req = app_msg_alloc(app);
+	if (req == NULL)
+		return -1;
+
+	/* Fill in request */
+	req->type = PIPELINE_MSG_REQ_CYCLES_TABLE;
+	req->id = table_id;
+
+	/* Send request and wait for response */
+	rsp = app_msg_send_recv(app, pipeline_id, req, MSG_TIMEOUT_DEFAULT);
+	if (rsp == NULL)
+		return -1;
+
+	/* Check response */
+	status = rsp->status;
+	if (status == 0)
+		memcpy(cycles, &rsp->cycles, sizeof(rsp->cycles));
+
+	/* Message buffer free */
+	app_msg_free(app, rsp);
+
+	return status;
+}
+
 int
 app_pipeline_port_in_enable(struct app_params *app,
 	uint32_t pipeline_id,
@@ -740,6 +831,199 @@ cmdline_parse_inst_t cmd_stats_table = {
 	},
 };
 
+/*
+ * cycles port in
+ */
+
+static void
+print_pipeline_cycles(const char *name, const struct rte_pipeline_cycles *c)
+{
+	uint32_t i;
+
+	printf("\t%s: %" PRIu64 " bursts, %" PRIu64 " pkts\n",
+		name, c->n_bursts, c->n_pkts);
+	if (c->n_bursts == 0)
+		return;
+
+	printf("\t\tCycles per pkt: avg %" PRIu64 "\n"
+		"\t\tCycles per burst: avg %" PRIu64 ", p50 %" PRIu64
+		", p90 %" PRIu64 ", p99 %" PRIu64 ", p99.9 %" PRIu64
+		", max %" PRIu64 "\n",
+		c->n_pkts ? c->cycles / c->n_pkts : 0,
+		c->cycles / c->n_bursts,
+		rte_pipeline_cycles_percentile(c, 50),
+		rte_pipeline_cycles_percentile(c, 90),
+		rte_pipeline_cycles_percentile(c, 99),
+		rte_pipeline_cycles_percentile(c, 99.9),
+		c->cycles_max);
+
+	for (i = 0; i < RTE_PIPELINE_CYCLES_HIST_SIZE; i++) {
+		if (c->hist[i] == 0)
+			continue;
+
+		if (i == RTE_PIPELINE_CYCLES_HIST_SIZE - 1)
+			printf("\t\t[%" PRIu64 ", ...): %" PRIu64 "\n",
+				rte_pipeline_cycles_bucket_min(i), c->hist[i]);
+		else
+			printf("\t\t[%" PRIu64 ", %" PRIu64 "): %" PRIu64 "\n",
+				rte_pipeline_cycles_bucket_min(i),
+				rte_pipeline_cycles_bucket_min(i + 1),
+				c->hist[i]);
+	}
+}
+
+struct cmd_cycles_port_in_result {
+	cmdline_fixed_string_t p_string;
+	uint32_t pipeline_id;
+	cmdline_fixed_string_t cycles_string;
+	cmdline_fixed_string_t port_string;
+	cmdline_fixed_string_t in_string;
+	uint32_t port_in_id;
+};
+
+static void
+cmd_cycles_port_in_parsed(
+	void *parsed_result,
+	__rte_unused struct cmdline *cl,
+	void *data)
+{
+	struct cmd_cycles_port_in_result *params = parsed_result;
+	struct app_params *app = data;
+	struct rte_pipeline_port_in_cycles cycles;
+	int status;
+
+	status = app_pipeline_cycles_port_in(app,
+			params->pipeline_id,
+			params->port_in_id,
+			&cycles);
+
+	if (status != 0) {
+		printf("Command failed\n");
+		return;
+	}
+
+	/* Display cycles */
+	printf("Pipeline %" PRIu32 " - cycles for input port %" PRIu32 ":\n",
+		params->pipeline_id,
+		params->port_in_id);
+	print_pipeline_cycles("RX", &cycles.rx);
+	print_pipeline_cycles("AH", &cycles.ah);
+}
+
+cmdline_parse_token_string_t cmd_cycles_port_in_p_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_port_in_result, p_string,
+		"p");
+
+cmdline_parse_token_num_t cmd_cycles_port_in_pipeline_id =
+	TOKEN_NUM_INITIALIZER(struct cmd_cycles_port_in_result, pipeline_id,
+		UINT32);
+
+cmdline_parse_token_string_t cmd_cycles_port_in_cycles_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_port_in_result,
+		cycles_string, "cycles");
+
+cmdline_parse_token_string_t cmd_cycles_port_in_port_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_port_in_result, port_string,
+		"port");
+
+cmdline_parse_token_string_t cmd_cycles_port_in_in_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_port_in_result, in_string,
+		"in");
+
+cmdline_parse_token_num_t cmd_cycles_port_in_port_in_id =
+	TOKEN_NUM_INITIALIZER(struct cmd_cycles_port_in_result, port_in_id,
+		UINT32);
+
+cmdline_parse_inst_t cmd_cycles_port_in = {
+	.f = cmd_cycles_port_in_parsed,
+	.data = NULL,
+	.help_str = "Pipeline input port cycles",
+	.tokens = {
+		(void *) &cmd_cycles_port_in_p_string,
+		(void *) &cmd_cycles_port_in_pipeline_id,
+		(void *) &cmd_cycles_port_in_cycles_string,
+		(void *) &cmd_cycles_port_in_port_string,
+		(void *) &cmd_cycles_port_in_in_string,
+		(void *) &cmd_cycles_port_in_port_in_id,
+		NULL,
+	},
+};
+
+/*
+ * cycles table
+ */
+
+struct cmd_cycles_table_result {
+	cmdline_fixed_string_t p_string;
+	uint32_t pipeline_id;
+	cmdline_fixed_string_t cycles_string;
+	cmdline_fixed_string_t table_string;
+	uint32_t table_id;
+};
+
+static void
+cmd_cycles_table_parsed(
+	void *parsed_result,
+	__rte_unused struct cmdline *cl,
+	void *data)
+{
+	struct cmd_cycles_table_result *params = parsed_result;
+	struct app_params *app = data;
+	struct rte_pipeline_table_cycles cycles;
+	int status;
+
+	status = app_pipeline_cycles_table(app,
+			params->pipeline_id,
+			params->table_id,
+			&cycles);
+
+	if (status != 0) {
+		printf("Command failed\n");
+		return;
+	}
+
+	/* Display cycles */
+	printf("Pipeline %" PRIu32 " - cycles for table %" PRIu32 ":\n",
+		params->pipeline_id,
+		params->table_id);
+	print_pipeline_cycles("Lookup", &cycles.lookup);
+	print_pipeline_cycles("Lookup hit AH", &cycles.lkp_hit_ah);
+	print_pipeline_cycles("Lookup miss AH", &cycles.lkp_miss_ah);
+}
+
+cmdline_parse_token_string_t cmd_cycles_table_p_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_table_result, p_string,
+		"p");
+
+cmdline_parse_token_num_t cmd_cycles_table_pipeline_id =
+	TOKEN_NUM_INITIALIZER(struct cmd_cycles_table_result, pipeline_id,
+		UINT32);
+
+cmdline_parse_token_string_t cmd_cycles_table_cycles_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_table_result, cycles_string,
+		"cycles");
+
+cmdline_parse_token_string_t cmd_cycles_table_table_string =
+	TOKEN_STRING_INITIALIZER(struct cmd_cycles_table_result, table_string,
+		"table");
+
+cmdline_parse_token_num_t cmd_cycles_table_table_id =
+	TOKEN_NUM_INITIALIZER(struct cmd_cycles_table_result, table_id, UINT32);
+
+cmdline_parse_inst_t cmd_cycles_table = {
+	.f = cmd_cycles_table_parsed,
+	.data = NULL,
+	.help_str = "Pipeline table cycles",
+	.tokens = {
+		(void *) &cmd_cycles_table_p_string,
+		(void *) &cmd_cycles_table_pipeline_id,
+		(void *) &cmd_cycles_table_cycles_string,
+		(void *) &cmd_cycles_table_table_string,
+		(void *) &cmd_cycles_table_table_id,
+		NULL,
+	},
+};
+
 /*
  * port in enable
  */
@@ -1280,6 +1564,8 @@ static cmdline_parse_ctx_t pipeline_common_cmds[] = {
 	(cmdline_parse_inst_t *) &cmd_stats_port_in,
 	(cmdline_parse_inst_t *) &cmd_stats_port_out,
 	(cmdline_parse_inst_t *) &cmd_stats_table,
+	(cmdline_parse_inst_t *) &cmd_cycles_port_in,
+	(cmdline_parse_inst_t *) &cmd_cycles_table,
 	(cmdline_parse_inst_t *) &cmd_port_in_enable,
 	(cmdline_parse_inst_t *) &cmd_port_in_disable,
 	NULL,
@@ -204,6 +204,18 @@ app_pipeline_stats_table(struct app_params *app,
 	uint32_t table_id,
 	struct rte_pipeline_table_stats *stats);
 
+int
+app_pipeline_cycles_port_in(struct app_params *app,
+	uint32_t pipeline_id,
+	uint32_t port_id,
+	struct rte_pipeline_port_in_cycles *cycles);
+
+int
+app_pipeline_cycles_table(struct app_params *app,
+	uint32_t pipeline_id,
+	uint32_t table_id,
+	struct rte_pipeline_table_cycles *cycles);
+
 int
 app_pipeline_port_in_enable(struct app_params *app,
 	uint32_t pipeline_id,
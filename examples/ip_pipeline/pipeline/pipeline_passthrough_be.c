@@ -64,6 +64,10 @@ static pipeline_msg_req_handler handlers[] = {
 		pipeline_msg_req_port_in_enable_handler,
 	[PIPELINE_MSG_REQ_PORT_IN_DISABLE] =
 		pipeline_msg_req_port_in_disable_handler,
+	[PIPELINE_MSG_REQ_CYCLES_PORT_IN] =
+		pipeline_msg_req_cycles_port_in_handler,
+	[PIPELINE_MSG_REQ_CYCLES_TABLE] =
+		pipeline_msg_req_cycles_table_handler,
 	[PIPELINE_MSG_REQ_CUSTOM] =
 		pipeline_msg_req_invalid_handler,
 };
@@ -127,11 +127,8 @@ send_burst(struct lcore_conf *qconf, uint16_t n, uint8_t port)
 	m_table = (struct rte_mbuf **)qconf->tx_mbufs[port].m_table;
 
 	ret = rte_eth_tx_burst(port, queueid, m_table, n);
-	if (unlikely(ret < n)) {
-		do {
-			rte_pktmbuf_free(m_table[ret]);
-		} while (++ret < n);
-	}
+	if (unlikely(ret < n))
+		rte_pktmbuf_free_bulk(m_table + ret, n - ret);
 
 	return 0;
 }
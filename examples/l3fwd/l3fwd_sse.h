@@ -328,11 +328,8 @@ send_packetsx4(struct lcore_conf *qconf, uint8_t port, struct rte_mbuf *m[],
 	 */
 	if (num >= MAX_TX_BURST && len == 0) {
 		n = rte_eth_tx_burst(port, qconf->tx_queue_id[port], m, num);
-		if (unlikely(n < num)) {
-			do {
-				rte_pktmbuf_free(m[n]);
-			} while (++n < num);
-		}
+		if (unlikely(n < num))
+			rte_pktmbuf_free_bulk(m + n, num - n);
 		return;
 	}
 
@@ -483,7 +480,6 @@ send_packets_multi(struct lcore_conf *qconf, struct rte_mbuf **pkts_burst,
 	 */
 	for (j = 0; j < nb_rx; j += k) {
 
-		int32_t m;
 		uint16_t pn;
 
 		pn = dst_port[j];
@@ -492,8 +488,7 @@ send_packets_multi(struct lcore_conf *qconf, struct rte_mbuf **pkts_burst,
 		if (likely(pn != BAD_PORT))
 			send_packetsx4(qconf, pn, pkts_burst + j, k);
 		else
-			for (m = j; m != j + k; m++)
-				rte_pktmbuf_free(pkts_burst[m]);
+			rte_pktmbuf_free_bulk(pkts_burst + j, k);
 
 	}
 }
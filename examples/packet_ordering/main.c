@@ -36,6 +36,7 @@
 
 #include <rte_eal.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
@@ -50,6 +51,8 @@
 
 #define MAX_PKTS_BURST 32
 #define REORDER_BUFFER_SIZE 8192
+/* Time after which packets held back by a lost one are sent anyway */
+#define REORDER_DRAIN_TIMEOUT_US 100
 #define MBUF_PER_POOL 65535
 #define MBUF_POOL_CACHE_SIZE 250
 
@@ -503,11 +506,12 @@ worker_thread(void *args_ptr)
 static int
 send_thread(struct send_thread_args *args)
 {
-	int ret;
 	unsigned int i, dret;
 	uint16_t nb_dq_mbufs;
 	uint8_t outp;
 	unsigned sent;
+	const uint64_t drain_timeout = rte_get_tsc_hz() / US_PER_S *
+			REORDER_DRAIN_TIMEOUT_US;
 	struct rte_mbuf *mbufs[MAX_PKTS_BURST];
 	struct rte_mbuf *rombufs[MAX_PKTS_BURST] = {NULL};
 	static struct rte_eth_dev_tx_buffer *tx_buffer[RTE_MAX_ETHPORTS];
@@ -522,16 +526,16 @@ send_thread(struct send_thread_args *args)
 		nb_dq_mbufs = rte_ring_dequeue_burst(args->ring_in,
 				(void *)mbufs, MAX_PKTS_BURST);
 
-		if (unlikely(nb_dq_mbufs == 0))
-			continue;
-
 		app_stats.tx.dequeue_pkts += nb_dq_mbufs;
 
 		for (i = 0; i < nb_dq_mbufs; i++) {
 			/* send dequeued mbufs for reordering */
-			ret = rte_reorder_insert(args->buffer, mbufs[i]);
+			i += rte_reorder_insert_burst(args->buffer, &mbufs[i],
+					nb_dq_mbufs - i);
+			if (i == nb_dq_mbufs)
+				break;
 
-			if (ret == -1 && rte_errno == ERANGE) {
+			if (rte_errno == ERANGE) {
 				/* Too early pkts should be transmitted out directly */
 				LOG_DEBUG(REORDERAPP, "%s():Cannot reorder early packet "
 						"direct enqueuing to TX\n", __func__);
@@ -545,7 +549,7 @@ send_thread(struct send_thread_args *args)
 					app_stats.tx.early_pkts_tx_failed_woro++;
 				} else
 					app_stats.tx.early_pkts_txtd_woro++;
-			} else if (ret == -1 && rte_errno == ENOSPC) {
+			} else if (rte_errno == ENOSPC) {
 				/**
 				 * Early pkts just outside of window should be dropped
 				 */
@@ -554,10 +558,11 @@ send_thread(struct send_thread_args *args)
 		}
 
 		/*
-		 * drain MAX_PKTS_BURST of reordered
-		 * mbufs for transmit
+		 * drain MAX_PKTS_BURST of reordered mbufs for transmit, not
+		 * waiting for lost packets longer than the drain timeout
 		 */
-		dret = rte_reorder_drain(args->buffer, rombufs, MAX_PKTS_BURST);
+		dret = rte_reorder_drain_until(args->buffer, rombufs,
+				MAX_PKTS_BURST, rte_rdtsc() - drain_timeout);
 		for (i = 0; i < dret; i++) {
 
 			struct rte_eth_dev_tx_buffer *outbuf;
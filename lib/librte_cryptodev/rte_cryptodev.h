@@ -209,6 +209,8 @@ struct rte_cryptodev_capabilities {
 /**< Utilises CPU AES-NI instructions */
 #define	RTE_CRYPTODEV_FF_HW_ACCELERATED		(1ULL << 7)
 /**< Operations are off-loaded to an external hardware accelerator */
+#define	RTE_CRYPTODEV_FF_MBUF_SCATTER_GATHER	(1ULL << 8)
+/**< Chained (multi-segment) mbufs are supported as source and destination */
 
 
 /**
@@ -286,6 +288,7 @@ struct rte_cryptodev_stats {
 
 #define RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_QUEUE_PAIRS	8
 #define RTE_CRYPTODEV_VDEV_DEFAULT_MAX_NB_SESSIONS	2048
+#define RTE_CRYPTODEV_VDEV_MAX_WORKER_LCORES		16
 
 /**
  * @internal
@@ -295,16 +298,24 @@ struct rte_crypto_vdev_init_params {
 	unsigned max_nb_queue_pairs;
 	unsigned max_nb_sessions;
 	uint8_t socket_id;
+	unsigned nb_worker_lcores;
+	/**< Number of lcores dedicated to processing the device operations,
+	 * 0 if operations are processed on the enqueuing lcore */
+	unsigned worker_lcores[RTE_CRYPTODEV_VDEV_MAX_WORKER_LCORES];
+	/**< Identifiers of the dedicated worker lcores */
 };
 
 #define RTE_CRYPTODEV_VDEV_MAX_NB_QP_ARG		("max_nb_queue_pairs")
 #define RTE_CRYPTODEV_VDEV_MAX_NB_SESS_ARG		("max_nb_sessions")
 #define RTE_CRYPTODEV_VDEV_SOCKET_ID			("socket_id")
+#define RTE_CRYPTODEV_VDEV_WORKER_LCORE_ARG		("worker_lcore")
 
 static const char *cryptodev_vdev_valid_params[] = {
 	RTE_CRYPTODEV_VDEV_MAX_NB_QP_ARG,
 	RTE_CRYPTODEV_VDEV_MAX_NB_SESS_ARG,
-	RTE_CRYPTODEV_VDEV_SOCKET_ID
+	RTE_CRYPTODEV_VDEV_SOCKET_ID,
+	RTE_CRYPTODEV_VDEV_WORKER_LCORE_ARG,
+	NULL
 };
 
 static inline uint8_t
@@ -339,6 +350,31 @@ __rte_cryptodev_parse_integer_arg(const char *key __rte_unused,
 	return 0;
 }
 
+/** Parse a worker lcore argument, may be given multiple times */
+static inline int
+__rte_cryptodev_parse_worker_lcore_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	struct rte_crypto_vdev_init_params *params =
+			(struct rte_crypto_vdev_init_params *) extra_args;
+	int lcore_id = atoi(value);
+
+	if (lcore_id < 0 || lcore_id >= RTE_MAX_LCORE) {
+		CDEV_LOG_ERR("Invalid worker lcore %s.", value);
+		return -1;
+	}
+
+	if (params->nb_worker_lcores >= RTE_CRYPTODEV_VDEV_MAX_WORKER_LCORES) {
+		CDEV_LOG_ERR("Too many worker lcores, maximum is %u.",
+				RTE_CRYPTODEV_VDEV_MAX_WORKER_LCORES);
+		return -1;
+	}
+
+	params->worker_lcores[params->nb_worker_lcores++] = lcore_id;
+
+	return 0;
+}
+
 /**
  * Parse virtual device initialisation parameters input arguments
  * @internal
@@ -386,6 +422,13 @@ rte_cryptodev_parse_vdev_init_params(struct rte_crypto_vdev_init_params *params,
 		if (ret < 0)
 			goto free_kvlist;
 
+		ret = rte_kvargs_process(kvlist,
+					RTE_CRYPTODEV_VDEV_WORKER_LCORE_ARG,
+					&__rte_cryptodev_parse_worker_lcore_arg,
+					params);
+		if (ret < 0)
+			goto free_kvlist;
+
 		if (params->socket_id >= number_of_sockets()) {
 			CDEV_LOG_ERR("Invalid socket id specified to create "
 				"the virtual crypto device on");
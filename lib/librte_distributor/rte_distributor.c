@@ -40,6 +40,7 @@
 #include <rte_errno.h>
 #include <rte_string_fns.h>
 #include <rte_eal_memconfig.h>
+#include <rte_reorder.h>
 #include "rte_distributor.h"
 
 #define NO_FLAGS 0
@@ -111,7 +112,11 @@ struct rte_distributor {
 	union rte_distributor_buffer bufs[RTE_DISTRIB_MAX_WORKERS];
 
 	struct rte_distributor_returned_pkts returns;
-};
+
+	struct rte_reorder_mp_buffer *reorder;
+		/**< Buffer where returned packets are reordered, or NULL */
+	uint32_t next_seqn; /**< Sequence number of the next packet */
+} __rte_cache_aligned;
 
 TAILQ_HEAD(rte_distributor_list, rte_distributor);
 
@@ -191,11 +196,21 @@ backlog_pop(struct rte_distributor_backlog *bl)
 	return bl->pkts[bl->start++ & RTE_DISTRIB_BACKLOG_MASK];
 }
 
+static int
+distributor_process(struct rte_distributor *d,
+		struct rte_mbuf **mbufs, unsigned num_mbufs);
+
 /* stores a packet returned from a worker inside the returns array */
 static inline void
 store_return(uintptr_t oldbuf, struct rte_distributor *d,
 		unsigned *ret_start, unsigned *ret_count)
 {
+	/* packets which can't be reordered anymore are returned as usual */
+	if (d->reorder != NULL && oldbuf != 0 &&
+			rte_reorder_mp_insert(d->reorder,
+				(struct rte_mbuf *)oldbuf) == 0)
+		return;
+
 	/* store returns in a circular buffer - code is branch-free */
 	d->returns.mbufs[(*ret_start + *ret_count) & RTE_DISTRIB_RETURNS_MASK]
 			= (void *)oldbuf;
@@ -234,7 +249,7 @@ handle_worker_shutdown(struct rte_distributor *d, unsigned wkr)
 		 * Note that the tags were set before first level call
 		 * to rte_distributor_process.
 		 */
-		rte_distributor_process(d, pkts, i);
+		distributor_process(d, pkts, i);
 		bl->count = bl->start = 0;
 	}
 }
@@ -282,8 +297,8 @@ process_returns(struct rte_distributor *d)
 }
 
 /* process a set of packets to distribute them to workers */
-int
-rte_distributor_process(struct rte_distributor *d,
+static int
+distributor_process(struct rte_distributor *d,
 		struct rte_mbuf **mbufs, unsigned num_mbufs)
 {
 	unsigned next_idx = 0;
@@ -385,6 +400,20 @@ rte_distributor_process(struct rte_distributor *d,
 	return num_mbufs;
 }
 
+int
+rte_distributor_process(struct rte_distributor *d,
+		struct rte_mbuf **mbufs, unsigned num_mbufs)
+{
+	unsigned i;
+
+	/* stamp packets with their order of arrival */
+	if (d->reorder != NULL)
+		for (i = 0; i < num_mbufs; i++)
+			mbufs[i]->seqn = d->next_seqn++;
+
+	return distributor_process(d, mbufs, num_mbufs);
+}
+
 /* return to the caller, packets returned from workers */
 int
 rte_distributor_returned_pkts(struct rte_distributor *d,
@@ -428,7 +457,7 @@ rte_distributor_flush(struct rte_distributor *d)
 	const unsigned flushed = total_outstanding(d);
 
 	while (total_outstanding(d) > 0)
-		rte_distributor_process(d, NULL, 0);
+		distributor_process(d, NULL, 0);
 
 	return flushed;
 }
@@ -443,6 +472,22 @@ rte_distributor_clear_returns(struct rte_distributor *d)
 #endif
 }
 
+/* sets the buffer where packets returned by workers are reordered */
+int
+rte_distributor_reorder_set(struct rte_distributor *d,
+		struct rte_reorder_mp_buffer *b)
+{
+	if (total_outstanding(d) != 0)
+		return -EBUSY;
+
+	d->reorder = b;
+	d->next_seqn = 0;
+	if (b != NULL)
+		rte_reorder_mp_reset(b, 0);
+
+	return 0;
+}
+
 /* creates a distributor instance */
 struct rte_distributor *
 rte_distributor_create(const char *name,
@@ -475,6 +520,8 @@ rte_distributor_create(const char *name,
 	d = mz->addr;
 	snprintf(d->name, sizeof(d->name), "%s", name);
 	d->num_workers = num_workers;
+	d->reorder = NULL;
+	d->next_seqn = 0;
 
 	distributor_list = RTE_TAILQ_CAST(rte_distributor_tailq.head,
 					  rte_distributor_list);
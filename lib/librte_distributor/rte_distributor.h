@@ -50,6 +50,7 @@ extern "C" {
 
 struct rte_distributor;
 struct rte_mbuf;
+struct rte_reorder_mp_buffer;
 
 /**
  * Function to create a new distributor instance
@@ -150,6 +151,32 @@ rte_distributor_flush(struct rte_distributor *d);
 void
 rte_distributor_clear_returns(struct rte_distributor *d);
 
+/**
+ * Set a multi-producer reorder buffer where the packets returned by workers
+ * are put back in the order they were passed to rte_distributor_process().
+ *
+ * Packets are then stamped with a sequence number by
+ * rte_distributor_process(), and the ones returned by workers are inserted
+ * in the reorder buffer instead of the array read by
+ * rte_distributor_returned_pkts(). Workers may also insert their packets
+ * in the reorder buffer directly and request new packets without returning
+ * any. Another lcore, e.g. the TX one, drains the reorder buffer. Packets
+ * which can't be inserted in the reorder buffer are returned as usual.
+ *
+ * This should only be called on the same lcore as rte_distributor_process(),
+ * when no packets are in flight. The reorder buffer is reset.
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param b
+ *   The reorder buffer, or NULL to stop reordering returned packets
+ * @return
+ *   0 on success, -EBUSY if packets are in flight.
+ */
+int
+rte_distributor_reorder_set(struct rte_distributor *d,
+		struct rte_reorder_mp_buffer *b);
+
 /*  *** APIS to be called on the worker lcores ***  */
 /*
  * The following APIs are the public APIs which are designed for use on
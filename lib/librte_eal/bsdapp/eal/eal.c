@@ -552,6 +552,9 @@ rte_eal_init(int argc, char **argv)
 	if (rte_eal_tailqs_init() < 0)
 		rte_panic("Cannot init tail queues for objects\n");
 
+	if (rte_eal_trace_init() < 0)
+		rte_panic("Cannot init trace buffers\n");
+
 /*	if (rte_eal_log_init(argv[0], internal_config.syslog_facility) < 0)
 		rte_panic("Cannot init logs\n");*/
 
@@ -583,7 +586,11 @@ rte_eal_init(int argc, char **argv)
 	if (rte_eal_dev_init() < 0)
 		rte_panic("Cannot init pmd devices\n");
 
-	RTE_LCORE_FOREACH_SLAVE(i) {
+	/* slave and service lcores each get a thread */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (rte_config.lcore_role[i] == ROLE_OFF ||
+				i == (int)rte_config.master_lcore)
+			continue;
 
 		/*
 		 * create communication pipes between master thread
@@ -615,6 +622,9 @@ rte_eal_init(int argc, char **argv)
 	rte_eal_mp_remote_launch(sync_func, NULL, SKIP_MASTER);
 	rte_eal_mp_wait_lcore();
 
+	if (rte_eal_service_init() < 0)
+		rte_panic("Cannot start service lcores\n");
+
 	/* Probe & Initialize PCI devices */
 	if (rte_eal_pci_probe())
 		rte_panic("Cannot probe PCI\n");
@@ -36,6 +36,7 @@
 #include <sys/sysctl.h>
 #include <inttypes.h>
 #include <fcntl.h>
+#include <errno.h>
 
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
@@ -192,3 +193,24 @@ error:
 		close(fd_hugepage);
 	return -1;
 }
+
+/* contigmem buffers are all mapped at init, memory cannot grow */
+int
+rte_eal_memseg_grow(size_t len __rte_unused, int socket_id __rte_unused,
+		uint64_t hugepage_sz __rte_unused,
+		struct rte_memseg *segs[] __rte_unused,
+		unsigned max_segs __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+void
+rte_eal_memseg_release(const struct rte_memseg *ms __rte_unused)
+{
+}
+
+int
+rte_eal_memseg_is_dynamic(const struct rte_memseg *ms __rte_unused)
+{
+	return 0;
+}
@@ -59,6 +59,13 @@ RTE_DEFINE_PER_LCORE(unsigned, _lcore_id) = LCORE_ID_ANY;
 RTE_DEFINE_PER_LCORE(unsigned, _socket_id) = (unsigned)SOCKET_ID_ANY;
 RTE_DEFINE_PER_LCORE(rte_cpuset_t, _cpuset);
 
+/* messages sent on the pipe from master to slave */
+#define EAL_THREAD_MSG_LAUNCH 0
+#define EAL_THREAD_MSG_WAKEUP 1
+
+/* a wakeup message is in the pipe of the lcore, not read yet */
+static rte_atomic32_t wakeup_pending[RTE_MAX_LCORE];
+
 /*
  * Send a message to a slave lcore identified by slave_id to call a
  * function f with argument arg. Once the execution is done, the
@@ -68,7 +75,7 @@ int
 rte_eal_remote_launch(int (*f)(void *), void *arg, unsigned slave_id)
 {
 	int n;
-	char c = 0;
+	char c = EAL_THREAD_MSG_LAUNCH;
 	int m2s = lcore_config[slave_id].pipe_master2slave[1];
 	int s2m = lcore_config[slave_id].pipe_slave2master[0];
 
@@ -96,6 +103,26 @@ rte_eal_remote_launch(int (*f)(void *), void *arg, unsigned slave_id)
 	return 0;
 }
 
+/*
+ * Only one wakeup message at a time is written in the pipe, so that
+ * posting many work items cannot fill it.
+ */
+void
+eal_thread_wakeup(unsigned lcore_id)
+{
+	int n = 0;
+	char c = EAL_THREAD_MSG_WAKEUP;
+
+	if (lcore_id == rte_get_master_lcore() ||
+			rte_atomic32_test_and_set(&wakeup_pending[lcore_id]) == 0)
+		return;
+
+	while (n == 0 || (n < 0 && errno == EINTR))
+		n = write(lcore_config[lcore_id].pipe_master2slave[1], &c, 1);
+	if (n < 0)
+		rte_panic("cannot write on configuration pipe\n");
+}
+
 /* set affinity for current thread */
 static int
 eal_thread_set_affinity(void)
@@ -133,8 +160,10 @@ eal_thread_loop(__attribute__((unused)) void *arg)
 	thread_id = pthread_self();
 
 	/* retrieve our lcore_id from the configuration structure */
-	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
-		if (thread_id == lcore_config[lcore_id].thread_id)
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (lcore_id != rte_get_master_lcore() &&
+				rte_eal_lcore_role(lcore_id) != ROLE_OFF &&
+				thread_id == lcore_config[lcore_id].thread_id)
 			break;
 	}
 	if (lcore_id == RTE_MAX_LCORE)
@@ -167,6 +196,12 @@ eal_thread_loop(__attribute__((unused)) void *arg)
 		if (n <= 0)
 			rte_panic("cannot read on configuration pipe\n");
 
+		if (c == EAL_THREAD_MSG_WAKEUP) {
+			rte_atomic32_clear(&wakeup_pending[lcore_id]);
+			rte_eal_mailbox_poll();
+			continue;
+		}
+
 		lcore_config[lcore_id].state = RUNNING;
 
 		/* send ack */
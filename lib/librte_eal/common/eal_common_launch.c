@@ -43,6 +43,30 @@
 #include <rte_atomic.h>
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
+#include <rte_branch_prediction.h>
+
+#include "eal_thread.h"
+
+#if (RTE_EAL_MAILBOX_SIZE & (RTE_EAL_MAILBOX_SIZE - 1)) != 0
+#error RTE_EAL_MAILBOX_SIZE must be a power of 2
+#endif
+#define MAILBOX_MASK (RTE_EAL_MAILBOX_SIZE - 1)
+
+/*
+ * Work items posted to an lcore. Any thread may post (multi-producer),
+ * only the lcore itself calls the items (single consumer).
+ */
+struct lcore_mailbox {
+	volatile uint32_t prod_head; /**< next slot to reserve */
+	volatile uint32_t prod_tail; /**< slots before this one are written */
+	volatile uint32_t cons __rte_cache_aligned; /**< next slot to call */
+	struct {
+		lcore_function_t *f;
+		void *arg;
+	} items[RTE_EAL_MAILBOX_SIZE];
+} __rte_cache_aligned;
+
+static struct lcore_mailbox lcore_mailbox[RTE_MAX_LCORE];
 
 /*
  * Wait until a lcore finished its job.
@@ -54,7 +78,8 @@ rte_eal_wait_lcore(unsigned slave_id)
 		return 0;
 
 	while (lcore_config[slave_id].state != WAIT &&
-	       lcore_config[slave_id].state != FINISHED);
+	       lcore_config[slave_id].state != FINISHED)
+		rte_pause();
 
 	rte_rmb();
 
@@ -116,3 +141,62 @@ rte_eal_mp_wait_lcore(void)
 		rte_eal_wait_lcore(lcore_id);
 	}
 }
+
+/*
+ * Reserve a slot like a multi-producer ring does, fill it, then make it
+ * visible once the slots reserved before it are visible too.
+ */
+int
+rte_eal_mailbox_post(unsigned lcore_id, lcore_function_t *f, void *arg)
+{
+	struct lcore_mailbox *mb;
+	uint32_t head;
+
+	if (lcore_id >= RTE_MAX_LCORE ||
+			rte_eal_lcore_role(lcore_id) == ROLE_OFF || f == NULL)
+		return -EINVAL;
+
+	mb = &lcore_mailbox[lcore_id];
+	do {
+		head = mb->prod_head;
+		if (head - mb->cons >= RTE_EAL_MAILBOX_SIZE)
+			return -ENOBUFS;
+	} while (rte_atomic32_cmpset(&mb->prod_head, head, head + 1) == 0);
+
+	mb->items[head & MAILBOX_MASK].f = f;
+	mb->items[head & MAILBOX_MASK].arg = arg;
+	rte_wmb();
+
+	while (unlikely(mb->prod_tail != head))
+		rte_pause();
+	mb->prod_tail = head + 1;
+
+	eal_thread_wakeup(lcore_id);
+	return 0;
+}
+
+unsigned
+rte_eal_mailbox_poll(void)
+{
+	unsigned lcore_id = rte_lcore_id();
+	struct lcore_mailbox *mb;
+	lcore_function_t *f;
+	void *arg;
+	unsigned n = 0;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return 0;
+
+	mb = &lcore_mailbox[lcore_id];
+	while (mb->cons != mb->prod_tail) {
+		rte_rmb();
+		f = mb->items[mb->cons & MAILBOX_MASK].f;
+		arg = mb->items[mb->cons & MAILBOX_MASK].arg;
+		/* the slot may be reused once cons moves past it */
+		rte_mb();
+		mb->cons++;
+		f(arg);
+		n++;
+	}
+	return n;
+}
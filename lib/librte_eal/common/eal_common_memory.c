@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <inttypes.h>
+#include <errno.h>
 #include <sys/queue.h>
 
 #include <rte_memory.h>
@@ -43,10 +44,24 @@
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
 #include <rte_log.h>
+#include <rte_rwlock.h>
 
 #include "eal_private.h"
 #include "eal_internal_cfg.h"
 
+/* registered memory event function, per process */
+struct mem_event_callback {
+	TAILQ_ENTRY(mem_event_callback) next;
+	rte_mem_event_callback_t cb;
+	void *arg;
+};
+
+TAILQ_HEAD(mem_event_callback_list, mem_event_callback);
+
+static struct mem_event_callback_list mem_event_callbacks =
+	TAILQ_HEAD_INITIALIZER(mem_event_callbacks);
+static rte_rwlock_t mem_event_lock = RTE_RWLOCK_INITIALIZER;
+
 /*
  * Return a pointer to a read-only table of struct rte_physmem_desc
  * elements, containing the layout of all addressable physical
@@ -72,7 +87,7 @@ rte_eal_get_physmem_size(void)
 
 	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
 		if (mcfg->memseg[i].addr == NULL)
-			break;
+			continue;
 
 		total_len += mcfg->memseg[i].len;
 	}
@@ -92,7 +107,7 @@ rte_dump_physmem_layout(FILE *f)
 
 	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
 		if (mcfg->memseg[i].addr == NULL)
-			break;
+			continue;
 
 		fprintf(f, "Segment %u: phys:0x%"PRIx64", len:%zu, "
 		       "virt:%p, socket_id:%"PRId32", "
@@ -152,3 +167,83 @@ rte_eal_memory_init(void)
 
 	return 0;
 }
+
+int
+rte_mem_event_callback_register(rte_mem_event_callback_t cb, void *arg)
+{
+	struct mem_event_callback *entry;
+	int ret = 0;
+
+	if (cb == NULL)
+		return -EINVAL;
+
+	rte_rwlock_write_lock(&mem_event_lock);
+	TAILQ_FOREACH(entry, &mem_event_callbacks, next) {
+		if (entry->cb == cb && entry->arg == arg) {
+			ret = -EEXIST;
+			goto out;
+		}
+	}
+
+	entry = malloc(sizeof(*entry));
+	if (entry == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	entry->cb = cb;
+	entry->arg = arg;
+	TAILQ_INSERT_TAIL(&mem_event_callbacks, entry, next);
+out:
+	rte_rwlock_write_unlock(&mem_event_lock);
+	return ret;
+}
+
+int
+rte_mem_event_callback_unregister(rte_mem_event_callback_t cb, void *arg)
+{
+	struct mem_event_callback *entry;
+
+	rte_rwlock_write_lock(&mem_event_lock);
+	TAILQ_FOREACH(entry, &mem_event_callbacks, next) {
+		if (entry->cb == cb && entry->arg == arg)
+			break;
+	}
+	if (entry != NULL)
+		TAILQ_REMOVE(&mem_event_callbacks, entry, next);
+	rte_rwlock_write_unlock(&mem_event_lock);
+
+	if (entry == NULL)
+		return -ENOENT;
+	free(entry);
+	return 0;
+}
+
+/*
+ * call the registered functions, stopping at the first failure: the
+ * functions which accepted the segment are then told it is freed
+ */
+int
+rte_eal_mem_event_notify(enum rte_mem_event event,
+		const struct rte_memseg *ms)
+{
+	struct mem_event_callback *entry, *failed;
+	int ret = 0;
+
+	rte_rwlock_read_lock(&mem_event_lock);
+	TAILQ_FOREACH(entry, &mem_event_callbacks, next) {
+		ret = entry->cb(event, ms, entry->arg);
+		if (ret < 0 && event == RTE_MEM_EVENT_ALLOC)
+			break;
+	}
+	if (entry != NULL && event == RTE_MEM_EVENT_ALLOC) {
+		failed = entry;
+		TAILQ_FOREACH(entry, &mem_event_callbacks, next) {
+			if (entry == failed)
+				break;
+			entry->cb(RTE_MEM_EVENT_FREE, ms, entry->arg);
+		}
+	}
+	rte_rwlock_read_unlock(&mem_event_lock);
+
+	return event == RTE_MEM_EVENT_ALLOC ? ret : 0;
+}
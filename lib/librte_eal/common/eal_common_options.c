@@ -75,10 +75,12 @@ const struct option
 eal_long_options[] = {
 	{OPT_BASE_VIRTADDR,     1, NULL, OPT_BASE_VIRTADDR_NUM    },
 	{OPT_CREATE_UIO_DEV,    0, NULL, OPT_CREATE_UIO_DEV_NUM   },
+	{OPT_DYNAMIC_MEM,       0, NULL, OPT_DYNAMIC_MEM_NUM      },
 	{OPT_FILE_PREFIX,       1, NULL, OPT_FILE_PREFIX_NUM      },
 	{OPT_HELP,              0, NULL, OPT_HELP_NUM             },
 	{OPT_HUGE_DIR,          1, NULL, OPT_HUGE_DIR_NUM         },
 	{OPT_HUGE_UNLINK,       0, NULL, OPT_HUGE_UNLINK_NUM      },
+	{OPT_IOVA_MODE,         1, NULL, OPT_IOVA_MODE_NUM        },
 	{OPT_LCORES,            1, NULL, OPT_LCORES_NUM           },
 	{OPT_LOG_LEVEL,         1, NULL, OPT_LOG_LEVEL_NUM        },
 	{OPT_MASTER_LCORE,      1, NULL, OPT_MASTER_LCORE_NUM     },
@@ -89,6 +91,7 @@ eal_long_options[] = {
 	{OPT_PCI_BLACKLIST,     1, NULL, OPT_PCI_BLACKLIST_NUM    },
 	{OPT_PCI_WHITELIST,     1, NULL, OPT_PCI_WHITELIST_NUM    },
 	{OPT_PROC_TYPE,         1, NULL, OPT_PROC_TYPE_NUM        },
+	{OPT_SERVICE_LCORES,    1, NULL, OPT_SERVICE_LCORES_NUM   },
 	{OPT_SOCKET_MEM,        1, NULL, OPT_SOCKET_MEM_NUM       },
 	{OPT_SYSLOG,            1, NULL, OPT_SYSLOG_NUM           },
 	{OPT_VDEV,              1, NULL, OPT_VDEV_NUM             },
@@ -117,6 +120,8 @@ static const char *default_solib_dir = RTE_EAL_PMD_PATH;
 
 static int master_lcore_parsed;
 static int mem_parsed;
+/* lcores given with --service-lcores */
+static uint8_t service_lcores[RTE_MAX_LCORE];
 
 void
 eal_reset_internal_config(struct internal_config *internal_cfg)
@@ -146,6 +151,10 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	/* if set to NONE, interrupt mode is determined automatically */
 	internal_cfg->vfio_intr_mode = RTE_INTR_MODE_NONE;
 
+	/* device addresses are physical addresses unless asked otherwise */
+	internal_cfg->iova_va = 0;
+	internal_cfg->dynamic_mem = 0;
+
 #ifdef RTE_LIBEAL_USE_HPET
 	internal_cfg->no_hpet = 0;
 #else
@@ -387,6 +396,41 @@ eal_parse_corelist(const char *corelist)
 	return 0;
 }
 
+/* Parse a list of lcores, in the corelist format, to run services */
+static int
+eal_parse_service_lcores(const char *list)
+{
+	unsigned idx, min, max;
+	char *end = NULL;
+
+	memset(service_lcores, 0, sizeof(service_lcores));
+	do {
+		while (isblank(*list))
+			list++;
+		errno = 0;
+		min = strtoul(list, &end, 10);
+		if (errno || end == list || min >= RTE_MAX_LCORE)
+			return -1;
+		max = min;
+		if (*end == '-') {
+			list = end + 1;
+			max = strtoul(list, &end, 10);
+			if (errno || end == list || max >= RTE_MAX_LCORE ||
+					max < min)
+				return -1;
+		}
+		while (isblank(*end))
+			end++;
+		if (*end != ',' && *end != '\0')
+			return -1;
+		for (idx = min; idx <= max; idx++)
+			service_lcores[idx] = 1;
+		list = end + 1;
+	} while (*end != '\0');
+
+	return 0;
+}
+
 /* Changes the lcore id of the master thread */
 static int
 eal_parse_master_lcore(const char *arg)
@@ -896,6 +940,14 @@ eal_parse_common_option(int opt, const char *optarg,
 		}
 		break;
 
+	case OPT_SERVICE_LCORES_NUM:
+		if (eal_parse_service_lcores(optarg) < 0) {
+			RTE_LOG(ERR, EAL, "invalid parameter for --"
+				OPT_SERVICE_LCORES "\n");
+			return -1;
+		}
+		break;
+
 	/* don't know what to do, leave this to caller */
 	default:
 		return 1;
@@ -918,6 +970,20 @@ eal_adjust_config(struct internal_config *internal_cfg)
 	if (!master_lcore_parsed)
 		cfg->master_lcore = rte_get_next_lcore(-1, 0, 0);
 
+	/* service lcores are taken from the slave lcores */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (!service_lcores[i])
+			continue;
+		if (cfg->lcore_role[i] != ROLE_RTE ||
+				(unsigned)i == cfg->master_lcore) {
+			RTE_LOG(ERR, EAL, "Service lcore %d is not a slave "
+				"lcore\n", i);
+			return -1;
+		}
+		cfg->lcore_role[i] = ROLE_SERVICE;
+		cfg->lcore_count--;
+	}
+
 	/* if no memory amounts were requested, this will result in 0 and
 	 * will be overridden later, right after eal_hugepage_info_init() */
 	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
@@ -990,6 +1056,9 @@ eal_common_usage(void)
 	       "                      '( )' can be omitted for single element group,\n"
 	       "                      '@' can be omitted if cpus and lcores have the same value\n"
 	       "  --"OPT_MASTER_LCORE" ID   Core ID that is used as master\n"
+	       "  --"OPT_SERVICE_LCORES" CORELIST\n"
+	       "                      Lcores running services instead of application\n"
+	       "                      jobs, taken from the lcores to run on\n"
 	       "  -n CHANNELS         Number of memory channels\n"
 	       "  -m MB               Memory to allocate (see also --"OPT_SOCKET_MEM")\n"
 	       "  -r RANKS            Force number of memory ranks (don't detect)\n"
@@ -0,0 +1,390 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <ctype.h>
+#include <fnmatch.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_memory.h>
+#include <rte_memzone.h>
+#include <rte_spinlock.h>
+#include <rte_cycles.h>
+#include <rte_trace.h>
+
+#include "eal_private.h"
+
+#define TRACE_MZ_NAME "RTE_TRACE"
+#define TRACE_BUF_MZ_NAME "RTE_TRACE_%u"
+
+/* tracepoints, shared by all processes */
+struct trace_shared {
+	rte_spinlock_t lock;
+	uint32_t nb_points;
+	pid_t pid;          /* primary process, for the dumps */
+	uint8_t enabled[RTE_TRACE_POINT_MAX];
+	char names[RTE_TRACE_POINT_MAX][RTE_TRACE_NAME_MAX];
+};
+
+/* all tracepoints are disabled until the buffers are initialized */
+static uint8_t trace_disabled[RTE_TRACE_POINT_MAX];
+
+volatile uint8_t *rte_trace_enabled = trace_disabled;
+struct rte_trace_buffer *rte_trace_buffers[RTE_MAX_LCORE];
+
+static struct trace_shared *trace_shared;
+
+static int
+trace_name_valid(const char *name)
+{
+	size_t i;
+
+	for (i = 0; name[i] != '\0'; i++) {
+		if (i == RTE_TRACE_NAME_MAX - 1)
+			return 0;
+		if (!isalnum((unsigned char)name[i]) &&
+				strchr("._-:", name[i]) == NULL)
+			return 0;
+	}
+	return i > 0;
+}
+
+int
+rte_trace_register(const char *name, uint16_t *id)
+{
+	uint32_t i;
+	int ret = 0;
+
+	if (trace_shared == NULL)
+		return -ENODEV;
+	if (name == NULL || id == NULL || !trace_name_valid(name))
+		return -EINVAL;
+
+	rte_spinlock_lock(&trace_shared->lock);
+	for (i = 0; i < trace_shared->nb_points; i++) {
+		if (strcmp(trace_shared->names[i], name) == 0)
+			break;
+	}
+	if (i == trace_shared->nb_points) {
+		if (i == RTE_TRACE_POINT_MAX) {
+			ret = -ENOSPC;
+		} else {
+			snprintf(trace_shared->names[i], RTE_TRACE_NAME_MAX,
+				"%s", name);
+			trace_shared->enabled[i] = 0;
+			trace_shared->nb_points++;
+		}
+	}
+	rte_spinlock_unlock(&trace_shared->lock);
+
+	if (ret == 0)
+		*id = i;
+	return ret;
+}
+
+const char *
+rte_trace_get_name(uint16_t id)
+{
+	if (trace_shared == NULL || id >= trace_shared->nb_points)
+		return NULL;
+	return trace_shared->names[id];
+}
+
+int
+rte_trace_set_enable(uint16_t id, int enable)
+{
+	if (trace_shared == NULL || id >= trace_shared->nb_points)
+		return -EINVAL;
+	rte_trace_enabled[id] = !!enable;
+	return 0;
+}
+
+int
+rte_trace_set_enable_pattern(const char *pattern, int enable)
+{
+	uint32_t i;
+	int count = 0;
+
+	if (trace_shared == NULL || pattern == NULL)
+		return 0;
+	for (i = 0; i < trace_shared->nb_points; i++) {
+		if (fnmatch(pattern, trace_shared->names[i], 0) == 0) {
+			rte_trace_enabled[i] = !!enable;
+			count++;
+		}
+	}
+	return count;
+}
+
+int
+rte_trace_is_enabled(uint16_t id)
+{
+	if (trace_shared == NULL || id >= trace_shared->nb_points)
+		return 0;
+	return rte_trace_enabled[id];
+}
+
+unsigned
+rte_trace_read(unsigned lcore_id, struct rte_trace_record *recs, unsigned n)
+{
+	struct rte_trace_buffer *buf;
+	struct rte_trace_record *rec;
+	uint64_t head, first, i;
+	uint32_t seq;
+	unsigned count = 0;
+
+	if (lcore_id >= RTE_MAX_LCORE || recs == NULL)
+		return 0;
+	buf = rte_trace_buffers[lcore_id];
+	if (buf == NULL)
+		return 0;
+
+	head = buf->head;
+	rte_smp_rmb();
+	first = head > (uint64_t)buf->mask + 1 ? head - buf->mask - 1 : 0;
+	if (head - first > n)
+		first = head - n;
+
+	for (i = first; i < head; i++) {
+		rec = &buf->records[i & buf->mask];
+		seq = *(volatile uint32_t *)&rec->seq;
+		rte_smp_rmb();
+		recs[count] = *rec;
+		rte_smp_rmb();
+		/* skip the record if it is being or has been overwritten */
+		if (seq != (uint32_t)i + 1 ||
+				*(volatile uint32_t *)&rec->seq != seq)
+			continue;
+		count++;
+	}
+	return count;
+}
+
+void
+rte_trace_reset(void)
+{
+	unsigned lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (rte_trace_buffers[lcore_id] != NULL)
+			rte_trace_buffers[lcore_id]->head = 0;
+	}
+}
+
+/* read the records of all lcores, NULL entries for empty buffers */
+static int
+trace_read_all(struct rte_trace_record *recs[], unsigned counts[])
+{
+	struct rte_trace_buffer *buf;
+	unsigned lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		recs[lcore_id] = NULL;
+		counts[lcore_id] = 0;
+		buf = rte_trace_buffers[lcore_id];
+		if (buf == NULL || buf->head == 0)
+			continue;
+		recs[lcore_id] = malloc(sizeof(**recs) * (buf->mask + 1));
+		if (recs[lcore_id] == NULL)
+			return -1;
+		counts[lcore_id] = rte_trace_read(lcore_id, recs[lcore_id],
+			buf->mask + 1);
+	}
+	return 0;
+}
+
+static void
+trace_free_all(struct rte_trace_record *recs[])
+{
+	unsigned lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		free(recs[lcore_id]);
+}
+
+static const char *
+trace_record_name(const struct rte_trace_record *rec)
+{
+	const char *name = rte_trace_get_name(rec->id);
+
+	return name != NULL ? name : "unknown";
+}
+
+void
+rte_trace_dump(FILE *f)
+{
+	struct rte_trace_record *recs[RTE_MAX_LCORE];
+	unsigned counts[RTE_MAX_LCORE];
+	unsigned lcore_id, i;
+
+	if (trace_read_all(recs, counts) < 0) {
+		trace_free_all(recs);
+		return;
+	}
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		for (i = 0; i < counts[lcore_id]; i++) {
+			const struct rte_trace_record *rec = &recs[lcore_id][i];
+
+			fprintf(f, "lcore %u tsc %"PRIu64" %s 0x%"PRIx64
+				" 0x%"PRIx64"\n", rec->lcore_id, rec->tsc,
+				trace_record_name(rec), rec->arg0, rec->arg1);
+		}
+	}
+	trace_free_all(recs);
+}
+
+int
+rte_trace_dump_json(FILE *f)
+{
+	struct rte_trace_record *recs[RTE_MAX_LCORE];
+	unsigned counts[RTE_MAX_LCORE];
+	unsigned lcore_id, i;
+	uint64_t tsc0 = UINT64_MAX;
+	double us_per_cycle = 1e6 / rte_get_tsc_hz();
+	int pid = trace_shared != NULL ? trace_shared->pid : getpid();
+	int nb_events = 0;
+
+	if (trace_read_all(recs, counts) < 0) {
+		trace_free_all(recs);
+		return -1;
+	}
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (counts[lcore_id] != 0 && recs[lcore_id][0].tsc < tsc0)
+			tsc0 = recs[lcore_id][0].tsc;
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (counts[lcore_id] == 0)
+			continue;
+		fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\","
+			"\"pid\":%d,\"tid\":%u,"
+			"\"args\":{\"name\":\"lcore %u\"}}",
+			nb_events == 0 ? "" : ",\n", pid, lcore_id, lcore_id);
+		nb_events++;
+		for (i = 0; i < counts[lcore_id]; i++) {
+			const struct rte_trace_record *rec = &recs[lcore_id][i];
+
+			fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"i\","
+				"\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,"
+				"\"args\":{\"arg0\":%"PRIu64","
+				"\"arg1\":%"PRIu64"}}",
+				trace_record_name(rec),
+				(rec->tsc - tsc0) * us_per_cycle,
+				pid, rec->lcore_id, rec->arg0, rec->arg1);
+			nb_events++;
+		}
+	}
+	fprintf(f, "\n]}\n");
+	trace_free_all(recs);
+
+	return ferror(f) ? -1 : nb_events;
+}
+
+/* reserve the trace buffer of an lcore, or find it in a secondary */
+static struct rte_trace_buffer *
+trace_buffer_init(unsigned lcore_id)
+{
+	const struct rte_memzone *mz;
+	struct rte_trace_buffer *buf;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	snprintf(name, sizeof(name), TRACE_BUF_MZ_NAME, lcore_id);
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		mz = rte_memzone_lookup(name);
+		return mz != NULL ? mz->addr : NULL;
+	}
+
+	mz = rte_memzone_reserve(name, sizeof(*buf) + RTE_TRACE_BUFFER_SIZE *
+		sizeof(struct rte_trace_record),
+		rte_lcore_to_socket_id(lcore_id), 0);
+	if (mz == NULL)
+		return NULL;
+	buf = mz->addr;
+	buf->head = 0;
+	buf->mask = RTE_TRACE_BUFFER_SIZE - 1;
+	buf->lcore_id = lcore_id;
+	return buf;
+}
+
+int
+rte_eal_trace_init(void)
+{
+	const struct rte_memzone *mz;
+	unsigned lcore_id;
+
+	RTE_BUILD_BUG_ON(sizeof(struct rte_trace_record) != 32);
+	RTE_BUILD_BUG_ON(!rte_is_power_of_2(RTE_TRACE_BUFFER_SIZE));
+
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		mz = rte_memzone_reserve(TRACE_MZ_NAME,
+			sizeof(struct trace_shared), SOCKET_ID_ANY, 0);
+		if (mz == NULL)
+			return -1;
+		trace_shared = mz->addr;
+		memset(trace_shared, 0, sizeof(*trace_shared));
+		rte_spinlock_init(&trace_shared->lock);
+		trace_shared->pid = getpid();
+	} else {
+		mz = rte_memzone_lookup(TRACE_MZ_NAME);
+		if (mz == NULL)
+			return -1;
+		trace_shared = mz->addr;
+	}
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (rte_eal_process_type() == RTE_PROC_PRIMARY &&
+				rte_eal_lcore_role(lcore_id) == ROLE_OFF)
+			continue;
+		rte_trace_buffers[lcore_id] = trace_buffer_init(lcore_id);
+		if (rte_trace_buffers[lcore_id] == NULL &&
+				rte_eal_process_type() == RTE_PROC_PRIMARY) {
+			RTE_LOG(ERR, EAL, "Cannot reserve trace buffer of "
+				"lcore %u\n", lcore_id);
+			return -1;
+		}
+	}
+
+	rte_trace_enabled = trace_shared->enabled;
+	return 0;
+}
@@ -81,6 +81,10 @@ struct internal_config {
 	volatile uint32_t log_level;	  /**< default log level */
 	/** default interrupt mode for VFIO */
 	volatile enum rte_intr_mode vfio_intr_mode;
+	/** true to use virtual addresses as device (IOMMU) addresses */
+	volatile unsigned iova_va;
+	/** true to map and release hugepages at runtime */
+	volatile unsigned dynamic_mem;
 	const char *hugefile_prefix;      /**< the base filename of hugetlbfs files */
 	const char *hugepage_dir;         /**< specific hugetlbfs directory to use */
 
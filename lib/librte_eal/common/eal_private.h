@@ -36,6 +36,7 @@
 
 #include <stdio.h>
 #include <rte_pci.h>
+#include <rte_memory.h>
 
 /**
  * Initialize the memzone subsystem (private to eal).
@@ -328,4 +329,64 @@ int rte_eal_hugepage_init(void);
  */
 int rte_eal_hugepage_attach(void);
 
+/**
+ * Map new hugepages of hugepage_sz bytes, for at least len bytes on a
+ * socket, in new memory segments. Each segment is physically
+ * contiguous. The registered memory event functions are called for
+ * each segment.
+ *
+ * This function is private to the EAL.
+ *
+ * @return
+ *   The number of segments stored in segs, or a negative value on error.
+ */
+int rte_eal_memseg_grow(size_t len, int socket_id, uint64_t hugepage_sz,
+		struct rte_memseg *segs[], unsigned max_segs);
+
+/**
+ * Unmap a memory segment added by rte_eal_memseg_grow(), after calling
+ * the registered memory event functions.
+ *
+ * This function is private to the EAL.
+ */
+void rte_eal_memseg_release(const struct rte_memseg *ms);
+
+/**
+ * Check whether a memory segment was added by rte_eal_memseg_grow().
+ *
+ * This function is private to the EAL.
+ */
+int rte_eal_memseg_is_dynamic(const struct rte_memseg *ms);
+
+/**
+ * Call the registered memory event functions for a segment. On
+ * RTE_MEM_EVENT_ALLOC, stop at the first failure and return it, after
+ * sending RTE_MEM_EVENT_FREE to the functions which accepted the segment.
+ *
+ * This function is private to the EAL.
+ */
+int rte_eal_mem_event_notify(enum rte_mem_event event,
+		const struct rte_memseg *ms);
+
+/**
+ * Start the service lcores given with --service-lcores.
+ *
+ * This function is private to the EAL.
+ *
+ * @return
+ *   0 on success, negative on error
+ */
+int rte_eal_service_init(void);
+
+/**
+ * Reserve the trace buffers of the lcores, or find them in a secondary
+ * process.
+ *
+ * This function is private to the EAL.
+ *
+ * @return
+ *   0 on success, negative on error
+ */
+int rte_eal_trace_init(void);
+
 #endif /* _EAL_PRIVATE_H_ */
@@ -52,6 +52,16 @@ __attribute__((noreturn)) void *eal_thread_loop(void *arg);
  */
 void eal_thread_init_master(unsigned lcore_id);
 
+/**
+ * Wake up a slave lcore waiting for a command, so that it checks its
+ * state and mailbox. A running lcore is not interrupted.
+ * This function is private to EAL.
+ *
+ * @param lcore_id
+ *   identifier of the lcore
+ */
+void eal_thread_wakeup(unsigned lcore_id);
+
 /**
  * Get the NUMA socket id from cpu id.
  * This function is private to EAL.
@@ -60,6 +60,7 @@ extern "C" {
 enum rte_lcore_role_t {
 	ROLE_RTE,
 	ROLE_OFF,
+	ROLE_SERVICE, /**< runs services, see rte_service.h */
 };
 
 /**
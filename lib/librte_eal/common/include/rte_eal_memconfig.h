@@ -68,6 +68,8 @@ struct rte_mem_config {
 	rte_rwlock_t mplock;  /**< only used by mempool LIB for thread-safe. */
 
 	uint32_t memzone_cnt; /**< Number of allocated memzones */
+	uint32_t dynamic_mem; /**< Memory segments change at runtime */
+	uint32_t iova_va;     /**< Devices use virtual addresses as IOVA */
 
 	/* memory segments and zones */
 	struct rte_memseg memseg[RTE_MAX_MEMSEG];    /**< Physmem descriptors. */
@@ -77,9 +77,10 @@ typedef int (lcore_function_t)(void *);
  * The MASTER lcore returns as soon as the message is sent and knows
  * nothing about the completion of f.
  *
- * Note: This function is not designed to offer optimum
- * performance. It is just a practical way to launch a function on
- * another lcore at initialization time.
+ * On Linux, the message is written in shared memory: a slave lcore
+ * that finished its previous job less than CONFIG_RTE_EAL_THREAD_SPIN_US
+ * microseconds ago is still polling and starts without any system
+ * call, otherwise it is woken up through a futex.
  *
  * @param f
  *   The function to be called.
@@ -170,6 +171,43 @@ int rte_eal_wait_lcore(unsigned slave_id);
  */
 void rte_eal_mp_wait_lcore(void);
 
+/**
+ * Post a work item to the mailbox of an lcore.
+ *
+ * The function f is called with argument arg by the lcore identified by
+ * lcore_id: right away if the lcore is in the WAIT state, or, if it is
+ * running a job, when this job calls rte_eal_mailbox_poll(). Work items
+ * are called in the order of posting and their return value is ignored,
+ * so they are meant for short tasks or to hand over work to a running
+ * job. This function can be called from any thread, including the
+ * target lcore.
+ *
+ * @param lcore_id
+ *   The identifier of the lcore.
+ * @param f
+ *   The function to be called.
+ * @param arg
+ *   The argument for the function.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): The lcore is not used by the EAL, or f is NULL.
+ *   - (-ENOBUFS): The mailbox already holds CONFIG_RTE_EAL_MAILBOX_SIZE
+ *     work items.
+ */
+int rte_eal_mailbox_post(unsigned lcore_id, lcore_function_t *f, void *arg);
+
+/**
+ * Call the work items posted to the mailbox of the calling lcore.
+ *
+ * Slave lcores do it by themselves while in the WAIT state; a long
+ * running job, or the MASTER lcore, has to call this function to
+ * process its mailbox.
+ *
+ * @return
+ *   The number of work items called, 0 in a non-EAL thread.
+ */
+unsigned rte_eal_mailbox_poll(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,8 +63,8 @@ extern "C" {
 struct lcore_config {
 	unsigned detected;         /**< true if lcore was detected */
 	pthread_t thread_id;       /**< pthread identifier */
-	int pipe_master2slave[2];  /**< communication pipe with master */
-	int pipe_slave2master[2];  /**< communication pipe with master */
+	int pipe_master2slave[2];  /**< communication pipe with master (BSD) */
+	int pipe_slave2master[2];  /**< communication pipe with master (BSD) */
 	lcore_function_t * volatile f;         /**< function to call */
 	void * volatile arg;       /**< argument of function */
 	volatile int ret;          /**< return value of function */
@@ -167,7 +167,10 @@ rte_lcore_to_socket_id(unsigned lcore_id)
  *   The identifier of the lcore, which MUST be between 0 and
  *   RTE_MAX_LCORE-1.
  * @return
- *   True if the given lcore is enabled; false otherwise.
+ *   True if the given lcore is enabled; false otherwise. Service lcores
+ *   are not considered enabled, as the application cannot launch work on
+ *   them. A library accepting service lcores as targets, like the timer
+ *   library, checks rte_eal_lcore_role() instead.
  */
 static inline int
 rte_lcore_is_enabled(unsigned lcore_id)
@@ -175,7 +178,7 @@ rte_lcore_is_enabled(unsigned lcore_id)
 	struct rte_config *cfg = rte_eal_get_configuration();
 	if (lcore_id >= RTE_MAX_LCORE)
 		return 0;
-	return cfg->lcore_role[lcore_id] != ROLE_OFF;
+	return cfg->lcore_role[lcore_id] == ROLE_RTE;
 }
 
 /**
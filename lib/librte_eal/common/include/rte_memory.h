@@ -135,6 +135,8 @@ int rte_mem_lock_page(const void *virt);
  * Get physical address of any mapped virtual address in the current process.
  * It is found by browsing the /proc/self/pagemap special file.
  * The page must be locked.
+ * When devices are given virtual addresses (--iova-mode=va), the virtual
+ * address is returned.
  *
  * @param virt
  *   The virtual address.
@@ -154,7 +156,9 @@ phys_addr_t rte_mem_virt2phy(const void *virt);
  *  - On success, return a pointer to a read-only table of struct
  *    rte_physmem_desc elements, containing the layout of all
  *    addressable physical memory. The last element of the table
- *    contains a NULL address.
+ *    contains a NULL address. With dynamic memory (--dynamic-mem),
+ *    segments are added and removed at runtime, so unused elements
+ *    (NULL address) may be followed by valid ones.
  *  - On error, return NULL. This should not happen since it is a fatal
  *    error that will probably cause the entire system to panic.
  */
@@ -194,6 +198,63 @@ unsigned rte_memory_get_nchannel(void);
  */
 unsigned rte_memory_get_nrank(void);
 
+/**
+ * Memory segment events, reported when hugepage memory is mapped or
+ * released at runtime (see --dynamic-mem).
+ */
+enum rte_mem_event {
+	RTE_MEM_EVENT_ALLOC, /**< Segment mapped, not used yet. */
+	RTE_MEM_EVENT_FREE,  /**< Segment no longer used, about to be unmapped. */
+};
+
+/**
+ * Function called on memory segment events.
+ *
+ * It is called without the malloc heap lock held, from the thread
+ * allocating or freeing the memory which made the segment be mapped or
+ * unmapped.
+ *
+ * @param event
+ *   The memory event.
+ * @param ms
+ *   The memory segment added or removed.
+ * @param arg
+ *   The argument given at registration.
+ * @return
+ *   0 on success. A negative value on RTE_MEM_EVENT_ALLOC makes the
+ *   segment be released, without being used.
+ */
+typedef int (*rte_mem_event_callback_t)(enum rte_mem_event event,
+		const struct rte_memseg *ms, void *arg);
+
+/**
+ * Register a function called when memory segments are added or removed
+ * at runtime, for instance to set up DMA mappings of the new memory.
+ * Segments existing at registration time are not reported.
+ *
+ * @param cb
+ *   The function to call.
+ * @param arg
+ *   The argument given to the function.
+ * @return
+ *   0 on success, -EINVAL if cb is NULL, -EEXIST if already registered
+ *   or -ENOMEM.
+ */
+int rte_mem_event_callback_register(rte_mem_event_callback_t cb, void *arg);
+
+/**
+ * Unregister a function registered with rte_mem_event_callback_register().
+ *
+ * @param cb
+ *   The function to unregister.
+ * @param arg
+ *   The argument given at registration.
+ * @return
+ *   0 on success, -ENOENT if not registered.
+ */
+int rte_mem_event_callback_unregister(rte_mem_event_callback_t cb,
+		void *arg);
+
 #ifdef RTE_LIBRTE_XEN_DOM0
 
 /**< Internal use only - should DOM0 memory mapping be used */
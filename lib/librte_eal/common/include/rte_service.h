@@ -0,0 +1,297 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_SERVICE_H_
+#define _RTE_SERVICE_H_
+
+/**
+ * @file
+ *
+ * Service cores
+ *
+ * Components with background work (periodic checks, timers, software
+ * devices) register it as a service: a function called repeatedly.
+ * Instead of dedicating an lcore to each of them, the EAL runs the
+ * services on a few service lcores, each of them calling in turn the
+ * services mapped to it. A service may also be run by the application,
+ * from its own loop, with rte_service_run_iter_on_app_lcore().
+ *
+ * Service lcores are given with the --service-lcores EAL option, or
+ * taken from the slave lcores with rte_service_lcore_add(). They are
+ * not part of the lcores browsed by RTE_LCORE_FOREACH() and are not
+ * counted by rte_lcore_count().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+/** Maximum number of services. */
+#define RTE_SERVICE_NUM_MAX 64
+
+/** Maximum length of a service name, including the final '\0'. */
+#define RTE_SERVICE_NAME_MAX 32
+
+/**
+ * The service function may be called by several lcores at the same
+ * time. Without this capability, the calls of a service mapped to
+ * several lcores are serialized.
+ */
+#define RTE_SERVICE_CAP_MT_SAFE (1 << 0)
+
+/**
+ * Service function, called repeatedly while the service is running.
+ * It should do a bounded amount of work and return, so that the other
+ * services of the lcore get their turn.
+ */
+typedef int32_t (*rte_service_func)(void *args);
+
+/**
+ * Description of a service, given at registration.
+ */
+struct rte_service_spec {
+	char name[RTE_SERVICE_NAME_MAX]; /**< Unique name of the service. */
+	rte_service_func callback;       /**< Function to call. */
+	void *callback_userdata;         /**< Argument of the function. */
+	uint32_t capabilities;           /**< RTE_SERVICE_CAP_* flags. */
+	int socket_id;                   /**< Socket of the service data. */
+};
+
+/**
+ * Statistics of a service, for all the lcores running it.
+ */
+struct rte_service_stats {
+	uint64_t calls;  /**< Number of calls of the service function. */
+	uint64_t cycles; /**< TSC cycles spent in it, if enabled. */
+};
+
+/**
+ * Register a service.
+ *
+ * The service is stopped until rte_service_runstate_set() starts it. If
+ * there are service lcores, it is mapped to the one with the fewest
+ * services.
+ *
+ * @param spec
+ *   The description of the service, copied.
+ * @param id
+ *   The identifier of the new service.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid spec.
+ *   - (-EEXIST): A service with the same name is registered.
+ *   - (-ENOSPC): RTE_SERVICE_NUM_MAX services are registered.
+ */
+int rte_service_register(const struct rte_service_spec *spec, uint32_t *id);
+
+/**
+ * Unregister a service. When this function returns, the service
+ * function is no longer being called.
+ *
+ * @param id
+ *   The identifier of the service.
+ * @return
+ *   0 on success, -EINVAL if the service is not registered.
+ */
+int rte_service_unregister(uint32_t id);
+
+/**
+ * Get the identifier of a service from its name.
+ *
+ * @return
+ *   0 on success, -ENODEV if no service has this name.
+ */
+int rte_service_get_by_name(const char *name, uint32_t *id);
+
+/**
+ * Get the name of a service, or NULL if it is not registered.
+ */
+const char *rte_service_get_name(uint32_t id);
+
+/**
+ * Get the number of registered services.
+ */
+uint32_t rte_service_count(void);
+
+/**
+ * Start or stop a service.
+ *
+ * @param id
+ *   The identifier of the service.
+ * @param runstate
+ *   1 to run the service, 0 to stop it.
+ * @return
+ *   0 on success, -EINVAL if the service is not registered.
+ */
+int rte_service_runstate_set(uint32_t id, uint32_t runstate);
+
+/**
+ * Get the run state of a service.
+ *
+ * @return
+ *   1 if running, 0 if stopped, -EINVAL if not registered.
+ */
+int rte_service_runstate_get(uint32_t id);
+
+/**
+ * Map a service to a service lcore, or unmap it.
+ *
+ * @param id
+ *   The identifier of the service.
+ * @param lcore_id
+ *   The service lcore.
+ * @param enable
+ *   1 to map the service to the lcore, 0 to unmap it.
+ * @return
+ *   0 on success, -EINVAL if the service is not registered or the lcore
+ *   is not a service lcore.
+ */
+int rte_service_map_lcore_set(uint32_t id, uint32_t lcore_id,
+		uint32_t enable);
+
+/**
+ * Check whether a service is mapped to a service lcore.
+ *
+ * @return
+ *   1 if mapped, 0 if not, -EINVAL on invalid parameters.
+ */
+int rte_service_map_lcore_get(uint32_t id, uint32_t lcore_id);
+
+/**
+ * Enable or disable the accounting of the cycles spent in a service.
+ * Calls are always counted; reading the TSC around each call is only
+ * done when enabled.
+ *
+ * @return
+ *   0 on success, -EINVAL if the service is not registered.
+ */
+int rte_service_set_stats_enable(uint32_t id, uint32_t enable);
+
+/**
+ * Get the statistics of a service.
+ *
+ * @return
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+int rte_service_stats_get(uint32_t id, struct rte_service_stats *stats);
+
+/**
+ * Reset the statistics of a service.
+ *
+ * @return
+ *   0 on success, -EINVAL if the service is not registered.
+ */
+int rte_service_stats_reset(uint32_t id);
+
+/**
+ * Call a running service once from the calling lcore, which does not
+ * need to be a service lcore.
+ *
+ * @return
+ *   - 0: The service was called.
+ *   - (-EINVAL): The service is not registered.
+ *   - (-ENOEXEC): The service is stopped.
+ *   - (-EBUSY): The service is not MT safe and another lcore is
+ *     calling it.
+ */
+int rte_service_run_iter_on_app_lcore(uint32_t id);
+
+/**
+ * Turn a slave lcore into a service lcore. The lcore must be in the
+ * WAIT state; it is then no longer browsed by RTE_LCORE_FOREACH().
+ *
+ * @return
+ *   0 on success, -EINVAL if the lcore is not an idle slave lcore,
+ *   -EALREADY if it is already a service lcore.
+ */
+int rte_service_lcore_add(uint32_t lcore_id);
+
+/**
+ * Turn a stopped service lcore back into a slave lcore. Its services
+ * are unmapped.
+ *
+ * @return
+ *   0 on success, -EINVAL if the lcore is not a service lcore, -EBUSY
+ *   if it is running.
+ */
+int rte_service_lcore_del(uint32_t lcore_id);
+
+/**
+ * Start running the mapped services on a service lcore.
+ *
+ * @return
+ *   0 on success, -EINVAL if the lcore is not a service lcore,
+ *   -EALREADY if it is already running.
+ */
+int rte_service_lcore_start(uint32_t lcore_id);
+
+/**
+ * Stop a service lcore, waiting for the end of the service function
+ * it is calling.
+ *
+ * @return
+ *   0 on success, -EINVAL if the lcore is not a service lcore,
+ *   -EALREADY if it is already stopped.
+ */
+int rte_service_lcore_stop(uint32_t lcore_id);
+
+/**
+ * Get the number of service lcores.
+ */
+uint32_t rte_service_lcore_count(void);
+
+/**
+ * Get the identifiers of the service lcores.
+ *
+ * @param array
+ *   Array filled with the lcore identifiers.
+ * @param n
+ *   Size of the array.
+ * @return
+ *   The number of service lcores, which may be more than n.
+ */
+uint32_t rte_service_lcore_list(uint32_t array[], uint32_t n);
+
+/**
+ * Dump the services, their mapping and statistics.
+ */
+void rte_service_dump(FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_SERVICE_H_ */
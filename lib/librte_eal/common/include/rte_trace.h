@@ -0,0 +1,252 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_TRACE_H_
+#define _RTE_TRACE_H_
+
+/**
+ * @file
+ *
+ * Per-lcore trace buffers
+ *
+ * A tracepoint writes a fixed-size binary record (TSC, lcore, tracepoint
+ * identifier and two arguments) in a ring buffer of the calling lcore,
+ * without lock, formatting nor system call, so that it can be left in
+ * the data path. The buffers are in shared memory and keep the latest
+ * RTE_TRACE_BUFFER_SIZE records of each lcore: another process, such as
+ * dpdk_proc_info, can enable the tracepoints and dump the buffers in the
+ * Trace Event Format read by trace viewers.
+ *
+ * A tracepoint is compiled out if its level is above RTE_TRACE_LEVEL, and
+ * costs a load and a branch while it is disabled at runtime.
+ *
+ * Only the EAL threads have a trace buffer: the tracepoints of other
+ * threads are ignored. Each lcore must be used by a single process.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_branch_prediction.h>
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+
+/** Maximum number of tracepoints. */
+#define RTE_TRACE_POINT_MAX 256
+
+/** Maximum length of a tracepoint name, including the final '\0'. */
+#define RTE_TRACE_NAME_MAX 32
+
+/** Trace record, 32 bytes. */
+struct rte_trace_record {
+	uint64_t tsc;      /**< TSC when the tracepoint was hit. */
+	uint16_t id;       /**< Tracepoint identifier. */
+	uint16_t lcore_id; /**< Lcore which hit the tracepoint. */
+	uint32_t seq;      /**< Low bits of the record number, plus 1. */
+	uint64_t arg0;     /**< First argument of the tracepoint. */
+	uint64_t arg1;     /**< Second argument of the tracepoint. */
+};
+
+/** Trace buffer of an lcore. */
+struct rte_trace_buffer {
+	volatile uint64_t head; /**< Number of records written. */
+	uint32_t mask;          /**< Number of records minus 1. */
+	uint32_t lcore_id;      /**< Lcore owning the buffer. */
+	struct rte_trace_record records[0] __rte_cache_aligned;
+} __rte_cache_aligned;
+
+/** @internal Runtime state of the tracepoints, in shared memory. */
+extern volatile uint8_t *rte_trace_enabled;
+
+/** @internal Trace buffer of each lcore, NULL if it has none. */
+extern struct rte_trace_buffer *rte_trace_buffers[RTE_MAX_LCORE];
+
+/**
+ * @internal Write a trace record, see RTE_TRACE().
+ */
+static inline int
+rte_trace(uint16_t id, uint64_t arg0, uint64_t arg1)
+{
+	struct rte_trace_buffer *buf;
+	struct rte_trace_record *rec;
+	unsigned lcore_id;
+	uint64_t head;
+
+	if (likely(rte_trace_enabled[id] == 0))
+		return 0;
+
+	lcore_id = rte_lcore_id();
+	if (unlikely(lcore_id >= RTE_MAX_LCORE))
+		return 0;
+	buf = rte_trace_buffers[lcore_id];
+	if (unlikely(buf == NULL))
+		return 0;
+
+	/* the buffer has a single writer, readers check seq to skip
+	 * the records overwritten while they are copied */
+	head = buf->head;
+	rec = &buf->records[head & buf->mask];
+	rec->seq = 0;
+	rte_smp_wmb();
+	rec->tsc = rte_rdtsc();
+	rec->id = id;
+	rec->lcore_id = lcore_id;
+	rec->arg0 = arg0;
+	rec->arg1 = arg1;
+	rte_smp_wmb();
+	rec->seq = (uint32_t)head + 1;
+	buf->head = head + 1;
+	return 0;
+}
+
+/**
+ * Hit a tracepoint.
+ *
+ * It is compiled out if the level is above RTE_TRACE_LEVEL, otherwise a
+ * record is written in the trace buffer of the calling lcore if the
+ * tracepoint is enabled.
+ *
+ * @param l
+ *   Level of the tracepoint, as for RTE_LOG(): a value between EMERG (1)
+ *   and DEBUG (8). Per-packet tracepoints should use DEBUG.
+ * @param id
+ *   Tracepoint identifier, from rte_trace_register().
+ * @param arg0
+ *   First argument, recorded as uint64_t.
+ * @param arg1
+ *   Second argument, recorded as uint64_t.
+ */
+#define RTE_TRACE(l, id, arg0, arg1)					\
+	(void)((RTE_LOG_ ## l <= RTE_TRACE_LEVEL) ?			\
+	 rte_trace(id, (uint64_t)(arg0), (uint64_t)(arg1)) :		\
+	 0)
+
+/**
+ * Register a tracepoint, disabled, or get the identifier of a tracepoint
+ * already registered with the same name, possibly by another process.
+ *
+ * It must be called after rte_eal_init().
+ *
+ * @param name
+ *   Name of the tracepoint.
+ * @param id
+ *   The identifier of the tracepoint.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid name.
+ *   - (-ENOSPC): RTE_TRACE_POINT_MAX tracepoints are registered.
+ *   - (-ENODEV): The trace buffers are not initialized.
+ */
+int rte_trace_register(const char *name, uint16_t *id);
+
+/**
+ * Get the name of a tracepoint, or NULL if it is not registered.
+ */
+const char *rte_trace_get_name(uint16_t id);
+
+/**
+ * Enable or disable a tracepoint.
+ *
+ * @return
+ *   0 on success, -EINVAL if the tracepoint is not registered.
+ */
+int rte_trace_set_enable(uint16_t id, int enable);
+
+/**
+ * Enable or disable the tracepoints matching a shell pattern, such as
+ * "ethdev.*".
+ *
+ * @return
+ *   The number of matching tracepoints.
+ */
+int rte_trace_set_enable_pattern(const char *pattern, int enable);
+
+/**
+ * Check if a tracepoint is enabled.
+ *
+ * @return
+ *   1 if enabled, 0 if disabled or not registered.
+ */
+int rte_trace_is_enabled(uint16_t id);
+
+/**
+ * Copy the valid records of an lcore trace buffer, oldest first. The
+ * records overwritten during the copy are skipped.
+ *
+ * @param lcore_id
+ *   Lcore of the trace buffer.
+ * @param recs
+ *   Array receiving the records.
+ * @param n
+ *   Size of the array: the latest n records are copied.
+ * @return
+ *   The number of records copied.
+ */
+unsigned rte_trace_read(unsigned lcore_id, struct rte_trace_record *recs,
+		unsigned n);
+
+/**
+ * Empty the trace buffers of all lcores. It must not be called while
+ * the lcores write records.
+ */
+void rte_trace_reset(void);
+
+/**
+ * Dump the trace buffers as text, one record per line.
+ */
+void rte_trace_dump(FILE *f);
+
+/**
+ * Dump the trace buffers in the JSON Trace Event Format, which can be
+ * loaded by chrome://tracing, Perfetto or Trace Compass. Each record is
+ * an instant event of the thread of its lcore, with a timestamp in
+ * microseconds since the oldest record.
+ *
+ * @return
+ *   The number of events written, or -1 on error.
+ */
+int rte_trace_dump_json(FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_TRACE_H_ */
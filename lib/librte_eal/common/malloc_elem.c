@@ -47,6 +47,7 @@
 
 #include "malloc_elem.h"
 #include "malloc_heap.h"
+#include "eal_private.h"
 
 #define MIN_DATA_SIZE (RTE_CACHE_LINE_SIZE)
 
@@ -271,10 +272,14 @@ join_elem(struct malloc_elem *elem1, struct malloc_elem *elem2)
 int
 malloc_elem_free(struct malloc_elem *elem)
 {
+	struct malloc_heap *heap = elem->heap;
+	struct malloc_elem *free_elem;
+	const struct rte_memseg *unused_ms;
+
 	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY)
 		return -1;
 
-	rte_spinlock_lock(&(elem->heap->lock));
+	rte_spinlock_lock(&heap->lock);
 	struct malloc_elem *next = RTE_PTR_ADD(elem, elem->size);
 	if (next->state == ELEM_FREE){
 		/* remove from free list, join to this one */
@@ -289,15 +294,23 @@ malloc_elem_free(struct malloc_elem *elem)
 		elem_free_list_remove(elem->prev);
 		join_elem(elem->prev, elem);
 		malloc_elem_free_list_insert(elem->prev);
+		free_elem = elem->prev;
 	}
 	/* otherwise add ourselves to the free list */
 	else {
 		malloc_elem_free_list_insert(elem);
 		elem->pad = 0;
+		free_elem = elem;
 	}
 	/* decrease heap's count of allocated elements */
-	elem->heap->alloc_count--;
-	rte_spinlock_unlock(&(elem->heap->lock));
+	heap->alloc_count--;
+	/* segment mapped at runtime and now unused, beyond the spare one */
+	unused_ms = malloc_heap_shrink(heap, free_elem);
+	rte_spinlock_unlock(&heap->lock);
+
+	/* unmapping takes long and calls the memory event functions */
+	if (unused_ms != NULL)
+		rte_eal_memseg_release(unused_ms);
 
 	return 0;
 }
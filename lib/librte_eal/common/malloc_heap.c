@@ -52,6 +52,8 @@
 
 #include "malloc_elem.h"
 #include "malloc_heap.h"
+#include "eal_private.h"
+#include "eal_internal_cfg.h"
 
 static unsigned
 check_hugepage_sz(unsigned flags, uint64_t hugepage_sz)
@@ -145,11 +147,120 @@ find_suitable_element(struct malloc_heap *heap, size_t size,
 	return NULL;
 }
 
+/*
+ * Check whether a free element spans a whole memory segment mapped at
+ * runtime, the only element followed by the end marker having no
+ * previous element.
+ */
+static int
+elem_spans_dynamic_memseg(const struct malloc_elem *elem)
+{
+	const struct malloc_elem *next = RTE_PTR_ADD(elem, elem->size);
+
+	return elem->state == ELEM_FREE && elem->prev == NULL &&
+		next->size == 0 && rte_eal_memseg_is_dynamic(elem->ms);
+}
+
+/*
+ * Take a free element spanning a whole memory segment mapped at runtime
+ * out of the heap, so that the segment can be released once the heap
+ * lock is dropped. The heap lock must be held.
+ */
+static const struct rte_memseg *
+malloc_heap_take_memseg(struct malloc_heap *heap, struct malloc_elem *elem)
+{
+	LIST_REMOVE(elem, free_list);
+	heap->total_size -= elem->size;
+	return elem->ms;
+}
+
+/*
+ * Map new hugepages of one size to the heap, enough for an element of
+ * the requested size and alignment. The heap lock must be held, it is
+ * released while the pages are mapped, so the free lists are scanned
+ * again afterwards. Returns the element, or NULL if the pages could not
+ * be mapped or added to the heap.
+ */
+static struct malloc_elem *
+malloc_heap_grow_pgsz(struct malloc_heap *heap, size_t size, unsigned flags,
+		size_t align, size_t bound, uint64_t hugepage_sz)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct rte_memseg *segs[RTE_MAX_MEMSEG];
+	const struct rte_memseg *unused[RTE_MAX_MEMSEG];
+	struct malloc_elem *elem;
+	size_t len;
+	int i, nb_segs, nb_unused = 0;
+
+	/* room for the headers and end marker, and to align the data */
+	len = size + align + 2 * MALLOC_ELEM_OVERHEAD + RTE_CACHE_LINE_SIZE;
+	if (bound != 0)
+		len += size;
+
+	/* mapping the pages takes long and calls the memory event functions */
+	rte_spinlock_unlock(&heap->lock);
+	nb_segs = rte_eal_memseg_grow(len, heap - mcfg->malloc_heaps,
+			hugepage_sz, segs, RTE_DIM(segs));
+	rte_spinlock_lock(&heap->lock);
+
+	for (i = 0; i < nb_segs; i++)
+		malloc_heap_add_memseg(heap, segs[i]);
+
+	/* memory may also have been freed or added by another thread */
+	elem = find_suitable_element(heap, size, flags, align, bound);
+	if (elem != NULL || nb_segs <= 0)
+		return elem;
+
+	/* the pages are not physically contiguous enough, give them back */
+	for (i = 0; i < nb_segs; i++) {
+		elem = segs[i]->addr;
+		if (elem_spans_dynamic_memseg(elem))
+			unused[nb_unused++] = malloc_heap_take_memseg(heap, elem);
+	}
+	rte_spinlock_unlock(&heap->lock);
+	for (i = 0; i < nb_unused; i++)
+		rte_eal_memseg_release(unused[i]);
+	rte_spinlock_lock(&heap->lock);
+	return NULL;
+}
+
+/*
+ * Map new hugepages to the heap, trying the smallest page sizes first
+ * so that as little memory as possible is taken from the system. The
+ * heap lock must be held, it is released while mapping.
+ */
+static struct malloc_elem *
+malloc_heap_grow(struct malloc_heap *heap, size_t size, unsigned flags,
+		size_t align, size_t bound)
+{
+	const struct hugepage_info *hpi;
+	struct malloc_elem *elem;
+	int i, hint, match;
+
+	/* page sizes matching the flags, then any size if it is a hint */
+	for (hint = 0; hint < 2; hint++) {
+		if (hint && !(flags & RTE_MEMZONE_SIZE_HINT_ONLY))
+			break;
+		for (i = internal_config.num_hugepage_sizes - 1; i >= 0; i--) {
+			hpi = &internal_config.hugepage_info[i];
+			match = check_hugepage_sz(flags, hpi->hugepage_sz) != 0;
+			if (hpi->hugedir == NULL || match == hint)
+				continue;
+			elem = malloc_heap_grow_pgsz(heap, size, flags, align,
+					bound, hpi->hugepage_sz);
+			if (elem != NULL)
+				return elem;
+		}
+	}
+	return NULL;
+}
+
 /*
  * Main function to allocate a block of memory from the heap.
  * It locks the free list, scans it, and adds a new memseg if the
  * scan fails. Once the new memseg is added, it re-scans and should return
- * the new element after releasing the lock.
+ * the new element after releasing the lock. With --dynamic-mem, new
+ * hugepages are mapped when no free element is large enough.
  */
 void *
 malloc_heap_alloc(struct malloc_heap *heap,
@@ -164,6 +275,8 @@ malloc_heap_alloc(struct malloc_heap *heap,
 	rte_spinlock_lock(&heap->lock);
 
 	elem = find_suitable_element(heap, size, flags, align, bound);
+	if (elem == NULL && internal_config.dynamic_mem)
+		elem = malloc_heap_grow(heap, size, flags, align, bound);
 	if (elem != NULL) {
 		elem = malloc_elem_alloc(elem, size, align, bound);
 		/* increase heap's count of allocated elements */
@@ -174,6 +287,35 @@ malloc_heap_alloc(struct malloc_heap *heap,
 	return elem == NULL ? NULL : (void *)(&elem[1]);
 }
 
+/*
+ * Check whether a free element spans a whole memory segment mapped at
+ * runtime, and another one of the heap is already unused. Keeping one
+ * unused segment avoids mapping and unmapping hugepages on each
+ * allocation and free of a large block. The heap lock must be held.
+ * Returns the segment of the element, taken out of the heap and to be
+ * released with rte_eal_memseg_release() once the heap lock is dropped,
+ * or NULL.
+ */
+const struct rte_memseg *
+malloc_heap_shrink(struct malloc_heap *heap, struct malloc_elem *elem)
+{
+	struct malloc_elem *spare;
+	size_t idx;
+
+	if (!elem_spans_dynamic_memseg(elem))
+		return NULL;
+
+	for (idx = 0; idx < RTE_HEAP_NUM_FREELISTS; idx++) {
+		LIST_FOREACH(spare, &heap->free_head[idx], free_list) {
+			if (spare != elem && elem_spans_dynamic_memseg(spare))
+				return malloc_heap_take_memseg(heap, elem);
+		}
+	}
+
+	/* keep it as the spare segment of the heap */
+	return NULL;
+}
+
 /*
  * Function to retrieve data for heap on given socket
  */
@@ -37,6 +37,8 @@
 #include <rte_malloc.h>
 #include <rte_malloc_heap.h>
 
+struct malloc_elem;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,6 +58,9 @@ void *
 malloc_heap_alloc(struct malloc_heap *heap,	const char *type, size_t size,
 		unsigned flags, size_t align, size_t bound);
 
+const struct rte_memseg *
+malloc_heap_shrink(struct malloc_heap *heap, struct malloc_elem *elem);
+
 int
 malloc_heap_get_stats(const struct malloc_heap *heap,
 		struct rte_malloc_socket_stats *socket_stats);
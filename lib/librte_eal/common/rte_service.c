@@ -0,0 +1,543 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_atomic.h>
+#include <rte_spinlock.h>
+#include <rte_cycles.h>
+#include <rte_branch_prediction.h>
+#include <rte_log.h>
+#include <rte_service.h>
+
+#include "eal_private.h"
+
+/* state of a registered service */
+struct rte_service {
+	struct rte_service_spec spec;
+	volatile uint8_t registered;
+	volatile uint8_t runstate;
+	volatile uint8_t stats_enabled;
+	rte_atomic32_t execute_lock; /**< serializes non MT safe calls */
+	uint32_t nb_lcores;          /**< number of mapped service lcores */
+	/* calls from non-EAL threads, which share no lcore state */
+	rte_atomic32_t app_active;   /**< non-EAL calls in progress */
+	rte_atomic64_t app_calls;
+	rte_atomic64_t app_cycles;
+} __rte_cache_aligned;
+
+/* state of an lcore calling services, service lcore or not */
+struct service_lcore {
+	volatile uint64_t service_mask; /**< services mapped to the lcore */
+	volatile uint8_t runstate;      /**< service lcore started */
+	volatile uint32_t current;      /**< service being called + 1, or 0 */
+	uint64_t calls[RTE_SERVICE_NUM_MAX];
+	uint64_t cycles[RTE_SERVICE_NUM_MAX];
+} __rte_cache_aligned;
+
+static struct rte_service services[RTE_SERVICE_NUM_MAX];
+static struct service_lcore service_lcores[RTE_MAX_LCORE];
+static uint32_t nb_services;
+/* protects the registry and the mappings, not the service calls */
+static rte_spinlock_t service_lock = RTE_SPINLOCK_INITIALIZER;
+
+static inline int
+service_valid(uint32_t id)
+{
+	return id < RTE_SERVICE_NUM_MAX && services[id].registered;
+}
+
+static inline int
+service_lcore_valid(uint32_t lcore_id)
+{
+	return lcore_id < RTE_MAX_LCORE &&
+		rte_eal_lcore_role(lcore_id) == ROLE_SERVICE;
+}
+
+/*
+ * call a service once from the calling lcore, or from a non-EAL thread
+ * if cs is NULL: the accounting is then shared, so atomic
+ */
+static inline int
+service_run(uint32_t id, struct service_lcore *cs)
+{
+	struct rte_service *s = &services[id];
+	uint64_t start, cycles = 0;
+	int serialize;
+
+	if (!s->runstate)
+		return -ENOEXEC;
+
+	serialize = !(s->spec.capabilities & RTE_SERVICE_CAP_MT_SAFE);
+	if (serialize && rte_atomic32_test_and_set(&s->execute_lock) == 0)
+		return -EBUSY;
+
+	if (cs != NULL)
+		cs->current = id + 1;
+	else
+		rte_atomic32_inc(&s->app_active);
+	rte_mb();
+	/* the service may have been unregistered in the meantime */
+	if (likely(s->registered)) {
+		if (s->stats_enabled) {
+			start = rte_rdtsc();
+			s->spec.callback(s->spec.callback_userdata);
+			cycles = rte_rdtsc() - start;
+		} else
+			s->spec.callback(s->spec.callback_userdata);
+		if (cs != NULL) {
+			cs->cycles[id] += cycles;
+			cs->calls[id]++;
+		} else {
+			rte_atomic64_add(&s->app_cycles, cycles);
+			rte_atomic64_inc(&s->app_calls);
+		}
+	}
+	if (cs != NULL)
+		cs->current = 0;
+	else
+		rte_atomic32_dec(&s->app_active);
+
+	if (serialize)
+		rte_atomic32_clear(&s->execute_lock);
+	return 0;
+}
+
+/* main loop of a service lcore */
+static int
+service_runner(__attribute__((unused)) void *arg)
+{
+	struct service_lcore *cs = &service_lcores[rte_lcore_id()];
+	uint64_t mask;
+	uint32_t id;
+
+	while (cs->runstate) {
+		mask = cs->service_mask;
+		while (mask != 0) {
+			id = __builtin_ctzll(mask);
+			mask &= mask - 1;
+			service_run(id, cs);
+		}
+		/* work items posted to this lcore */
+		rte_eal_mailbox_poll();
+	}
+	return 0;
+}
+
+/* wait until no lcore is calling a service */
+static void
+service_wait_idle(uint32_t id)
+{
+	unsigned lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		while (service_lcores[lcore_id].current == id + 1)
+			rte_pause();
+	while (rte_atomic32_read(&services[id].app_active) != 0)
+		rte_pause();
+}
+
+static void
+service_map(uint32_t id, uint32_t lcore_id, uint32_t enable)
+{
+	struct service_lcore *cs = &service_lcores[lcore_id];
+	uint64_t bit = UINT64_C(1) << id;
+
+	if (enable && !(cs->service_mask & bit)) {
+		cs->service_mask |= bit;
+		services[id].nb_lcores++;
+	} else if (!enable && (cs->service_mask & bit)) {
+		cs->service_mask &= ~bit;
+		services[id].nb_lcores--;
+	}
+}
+
+int
+rte_service_register(const struct rte_service_spec *spec, uint32_t *id)
+{
+	uint32_t i, free_id = RTE_SERVICE_NUM_MAX;
+	uint32_t lcore_id, best_lcore = RTE_MAX_LCORE, best_count = UINT32_MAX;
+	uint32_t count;
+
+	if (spec == NULL || id == NULL || spec->callback == NULL ||
+			spec->name[0] == '\0' ||
+			memchr(spec->name, '\0', sizeof(spec->name)) == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&service_lock);
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (!services[i].registered) {
+			if (free_id == RTE_SERVICE_NUM_MAX)
+				free_id = i;
+			continue;
+		}
+		if (strcmp(services[i].spec.name, spec->name) == 0) {
+			rte_spinlock_unlock(&service_lock);
+			return -EEXIST;
+		}
+	}
+	if (free_id == RTE_SERVICE_NUM_MAX) {
+		rte_spinlock_unlock(&service_lock);
+		return -ENOSPC;
+	}
+
+	memset(&services[free_id], 0, sizeof(services[free_id]));
+	services[free_id].spec = *spec;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		service_lcores[lcore_id].calls[free_id] = 0;
+		service_lcores[lcore_id].cycles[free_id] = 0;
+	}
+	rte_wmb();
+	services[free_id].registered = 1;
+	nb_services++;
+
+	/* spread the services over the service lcores */
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (!service_lcore_valid(lcore_id))
+			continue;
+		count = __builtin_popcountll(
+			service_lcores[lcore_id].service_mask);
+		if (count < best_count) {
+			best_count = count;
+			best_lcore = lcore_id;
+		}
+	}
+	if (best_lcore != RTE_MAX_LCORE)
+		service_map(free_id, best_lcore, 1);
+	rte_spinlock_unlock(&service_lock);
+
+	RTE_LOG(DEBUG, EAL, "Service %s registered with id %u\n",
+		spec->name, free_id);
+	*id = free_id;
+	return 0;
+}
+
+int
+rte_service_unregister(uint32_t id)
+{
+	uint32_t lcore_id;
+
+	rte_spinlock_lock(&service_lock);
+	if (!service_valid(id)) {
+		rte_spinlock_unlock(&service_lock);
+		return -EINVAL;
+	}
+	services[id].runstate = 0;
+	services[id].registered = 0;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		service_map(id, lcore_id, 0);
+	nb_services--;
+	rte_mb();
+	rte_spinlock_unlock(&service_lock);
+
+	service_wait_idle(id);
+	return 0;
+}
+
+int
+rte_service_get_by_name(const char *name, uint32_t *id)
+{
+	uint32_t i;
+
+	if (name == NULL || id == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (service_valid(i) &&
+				strcmp(services[i].spec.name, name) == 0) {
+			*id = i;
+			return 0;
+		}
+	}
+	return -ENODEV;
+}
+
+const char *
+rte_service_get_name(uint32_t id)
+{
+	if (!service_valid(id))
+		return NULL;
+	return services[id].spec.name;
+}
+
+uint32_t
+rte_service_count(void)
+{
+	return nb_services;
+}
+
+int
+rte_service_runstate_set(uint32_t id, uint32_t runstate)
+{
+	if (!service_valid(id))
+		return -EINVAL;
+	services[id].runstate = !!runstate;
+	rte_mb();
+	return 0;
+}
+
+int
+rte_service_runstate_get(uint32_t id)
+{
+	if (!service_valid(id))
+		return -EINVAL;
+	return services[id].runstate;
+}
+
+int
+rte_service_map_lcore_set(uint32_t id, uint32_t lcore_id, uint32_t enable)
+{
+	int ret = 0;
+
+	rte_spinlock_lock(&service_lock);
+	if (!service_valid(id) || !service_lcore_valid(lcore_id))
+		ret = -EINVAL;
+	else
+		service_map(id, lcore_id, enable);
+	rte_spinlock_unlock(&service_lock);
+	return ret;
+}
+
+int
+rte_service_map_lcore_get(uint32_t id, uint32_t lcore_id)
+{
+	if (!service_valid(id) || !service_lcore_valid(lcore_id))
+		return -EINVAL;
+	return !!(service_lcores[lcore_id].service_mask &
+		(UINT64_C(1) << id));
+}
+
+int
+rte_service_set_stats_enable(uint32_t id, uint32_t enable)
+{
+	if (!service_valid(id))
+		return -EINVAL;
+	services[id].stats_enabled = !!enable;
+	return 0;
+}
+
+int
+rte_service_stats_get(uint32_t id, struct rte_service_stats *stats)
+{
+	uint32_t lcore_id;
+
+	if (!service_valid(id) || stats == NULL)
+		return -EINVAL;
+
+	stats->calls = rte_atomic64_read(&services[id].app_calls);
+	stats->cycles = rte_atomic64_read(&services[id].app_cycles);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		stats->calls += service_lcores[lcore_id].calls[id];
+		stats->cycles += service_lcores[lcore_id].cycles[id];
+	}
+	return 0;
+}
+
+int
+rte_service_stats_reset(uint32_t id)
+{
+	uint32_t lcore_id;
+
+	if (!service_valid(id))
+		return -EINVAL;
+
+	rte_atomic64_clear(&services[id].app_calls);
+	rte_atomic64_clear(&services[id].app_cycles);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		service_lcores[lcore_id].calls[id] = 0;
+		service_lcores[lcore_id].cycles[id] = 0;
+	}
+	return 0;
+}
+
+int
+rte_service_run_iter_on_app_lcore(uint32_t id)
+{
+	unsigned lcore_id = rte_lcore_id();
+
+	if (!service_valid(id))
+		return -EINVAL;
+	if (lcore_id >= RTE_MAX_LCORE)
+		return service_run(id, NULL);
+	return service_run(id, &service_lcores[lcore_id]);
+}
+
+int
+rte_service_lcore_add(uint32_t lcore_id)
+{
+	struct rte_config *cfg = rte_eal_get_configuration();
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+	if (cfg->lcore_role[lcore_id] == ROLE_SERVICE)
+		return -EALREADY;
+	if (cfg->lcore_role[lcore_id] != ROLE_RTE ||
+			lcore_id == cfg->master_lcore ||
+			rte_eal_get_lcore_state(lcore_id) != WAIT)
+		return -EINVAL;
+
+	rte_spinlock_lock(&service_lock);
+	service_lcores[lcore_id].service_mask = 0;
+	service_lcores[lcore_id].runstate = 0;
+	cfg->lcore_role[lcore_id] = ROLE_SERVICE;
+	cfg->lcore_count--;
+	rte_spinlock_unlock(&service_lock);
+	return 0;
+}
+
+int
+rte_service_lcore_del(uint32_t lcore_id)
+{
+	struct rte_config *cfg = rte_eal_get_configuration();
+	uint32_t id;
+
+	if (!service_lcore_valid(lcore_id))
+		return -EINVAL;
+	if (service_lcores[lcore_id].runstate)
+		return -EBUSY;
+
+	rte_spinlock_lock(&service_lock);
+	for (id = 0; id < RTE_SERVICE_NUM_MAX; id++)
+		service_map(id, lcore_id, 0);
+	cfg->lcore_role[lcore_id] = ROLE_RTE;
+	cfg->lcore_count++;
+	rte_spinlock_unlock(&service_lock);
+	return 0;
+}
+
+int
+rte_service_lcore_start(uint32_t lcore_id)
+{
+	if (!service_lcore_valid(lcore_id))
+		return -EINVAL;
+	if (service_lcores[lcore_id].runstate)
+		return -EALREADY;
+
+	/* collect the return value of the previous run, if any */
+	rte_eal_wait_lcore(lcore_id);
+	service_lcores[lcore_id].runstate = 1;
+	rte_wmb();
+	if (rte_eal_remote_launch(service_runner, NULL, lcore_id) != 0) {
+		service_lcores[lcore_id].runstate = 0;
+		return -EBUSY;
+	}
+	return 0;
+}
+
+int
+rte_service_lcore_stop(uint32_t lcore_id)
+{
+	if (!service_lcore_valid(lcore_id))
+		return -EINVAL;
+	if (!service_lcores[lcore_id].runstate)
+		return -EALREADY;
+
+	service_lcores[lcore_id].runstate = 0;
+	rte_mb();
+	rte_eal_wait_lcore(lcore_id);
+	return 0;
+}
+
+uint32_t
+rte_service_lcore_list(uint32_t array[], uint32_t n)
+{
+	uint32_t lcore_id, count = 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (!service_lcore_valid(lcore_id))
+			continue;
+		if (array != NULL && count < n)
+			array[count] = lcore_id;
+		count++;
+	}
+	return count;
+}
+
+uint32_t
+rte_service_lcore_count(void)
+{
+	return rte_service_lcore_list(NULL, 0);
+}
+
+void
+rte_service_dump(FILE *f)
+{
+	struct rte_service_stats stats;
+	uint32_t id, lcore_id;
+
+	fprintf(f, "Services: %u\n", nb_services);
+	for (id = 0; id < RTE_SERVICE_NUM_MAX; id++) {
+		if (rte_service_stats_get(id, &stats) < 0)
+			continue;
+		fprintf(f, "  %u %s: %s, calls:%"PRIu64", cycles:%"PRIu64
+			", cycles/call:%"PRIu64", lcores:",
+			id, services[id].spec.name,
+			services[id].runstate ? "running" : "stopped",
+			stats.calls, stats.cycles,
+			stats.calls ? stats.cycles / stats.calls : 0);
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			if (rte_service_map_lcore_get(id, lcore_id) == 1)
+				fprintf(f, " %u", lcore_id);
+		fprintf(f, "\n");
+	}
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (!service_lcore_valid(lcore_id))
+			continue;
+		fprintf(f, "  service lcore %u: %s\n", lcore_id,
+			service_lcores[lcore_id].runstate ?
+			"running" : "stopped");
+	}
+}
+
+/* start the service lcores given with --service-lcores */
+int
+rte_eal_service_init(void)
+{
+	uint32_t lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (!service_lcore_valid(lcore_id))
+			continue;
+		if (rte_service_lcore_start(lcore_id) < 0)
+			return -1;
+	}
+	return 0;
+}
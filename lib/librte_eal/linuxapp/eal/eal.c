@@ -82,6 +82,7 @@
 #include "eal_filesystem.h"
 #include "eal_hugepages.h"
 #include "eal_options.h"
+#include "eal_pci_init.h"
 
 #define MEMSIZE_IF_NO_HUGE_PAGE (64ULL * 1024ULL * 1024ULL)
 
@@ -342,6 +343,8 @@ eal_usage(const char *prgname)
 	       "  --"OPT_BASE_VIRTADDR"     Base virtual address\n"
 	       "  --"OPT_CREATE_UIO_DEV"    Create /dev/uioX (usually done by hotplug)\n"
 	       "  --"OPT_VFIO_INTR"         Interrupt mode for VFIO (legacy|msi|msix)\n"
+	       "  --"OPT_IOVA_MODE"         Device addresses of hugepages (pa|va)\n"
+	       "  --"OPT_DYNAMIC_MEM"       Map and release hugepages at runtime\n"
 	       "  --"OPT_XEN_DOM0"          Support running on Xen dom0 without hugetlbfs\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
@@ -465,6 +468,18 @@ eal_parse_vfio_intr(const char *mode)
 	return -1;
 }
 
+static int
+eal_parse_iova_mode(const char *mode)
+{
+	if (!strcmp(mode, "pa"))
+		internal_config.iova_va = 0;
+	else if (!strcmp(mode, "va"))
+		internal_config.iova_va = 1;
+	else
+		return -1;
+	return 0;
+}
+
 static inline size_t
 eal_get_hugepage_mem_size(void)
 {
@@ -614,6 +629,20 @@ eal_parse_args(int argc, char **argv)
 			}
 			break;
 
+		case OPT_IOVA_MODE_NUM:
+			if (eal_parse_iova_mode(optarg) < 0) {
+				RTE_LOG(ERR, EAL, "invalid parameters for --"
+						OPT_IOVA_MODE "\n");
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
+		case OPT_DYNAMIC_MEM_NUM:
+			internal_config.dynamic_mem = 1;
+			break;
+
 		case OPT_CREATE_UIO_DEV_NUM:
 			internal_config.create_uio_dev = 1;
 			break;
@@ -658,6 +687,37 @@ eal_parse_args(int argc, char **argv)
 		goto out;
 	}
 
+	/* IOVA as VA relies on the IOMMU and on one mapping per hugepage */
+	if (internal_config.iova_va) {
+#if !defined(RTE_EAL_VFIO) || defined(RTE_EAL_SINGLE_FILE_SEGMENTS)
+		RTE_LOG(ERR, EAL, "Option --"OPT_IOVA_MODE"=va requires "
+			"RTE_EAL_VFIO=y and RTE_EAL_SINGLE_FILE_SEGMENTS=n\n");
+		eal_usage(prgname);
+		ret = -1;
+		goto out;
+#endif
+	}
+
+	/* runtime memory needs hugetlbfs, one file per page */
+	if (internal_config.dynamic_mem) {
+#ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
+		RTE_LOG(ERR, EAL, "Option --"OPT_DYNAMIC_MEM" requires "
+			"RTE_EAL_SINGLE_FILE_SEGMENTS=n\n");
+		eal_usage(prgname);
+		ret = -1;
+		goto out;
+#endif
+		if (internal_config.no_hugetlbfs ||
+				internal_config.xen_dom0_support) {
+			RTE_LOG(ERR, EAL, "Option --"OPT_DYNAMIC_MEM" cannot "
+				"be specified together with --"OPT_NO_HUGE
+				" or --"OPT_XEN_DOM0"\n");
+			eal_usage(prgname);
+			ret = -1;
+			goto out;
+		}
+	}
+
 	if (optind >= 0)
 		argv[optind-1] = prgname;
 	ret = optind-1;
@@ -788,6 +848,15 @@ rte_eal_init(int argc, char **argv)
 	if (rte_eal_pci_init() < 0)
 		rte_panic("Cannot init PCI\n");
 
+	/* UIO devices, or VFIO ones without IOMMU, need physical addresses */
+	if (internal_config.iova_va &&
+			internal_config.process_type == RTE_PROC_PRIMARY &&
+			!pci_iova_va_supported()) {
+		RTE_LOG(WARNING, EAL, "Cannot use --"OPT_IOVA_MODE"=va, "
+			"falling back to physical addresses\n");
+		internal_config.iova_va = 0;
+	}
+
 #ifdef RTE_LIBRTE_IVSHMEM
 	if (rte_eal_ivshmem_init() < 0)
 		rte_panic("Cannot init IVSHMEM\n");
@@ -805,6 +874,9 @@ rte_eal_init(int argc, char **argv)
 	if (rte_eal_tailqs_init() < 0)
 		rte_panic("Cannot init tail queues for objects\n");
 
+	if (rte_eal_trace_init() < 0)
+		rte_panic("Cannot init trace buffers\n");
+
 #ifdef RTE_LIBRTE_IVSHMEM
 	if (rte_eal_ivshmem_obj_init() < 0)
 		rte_panic("Cannot init IVSHMEM objects\n");
@@ -838,17 +910,11 @@ rte_eal_init(int argc, char **argv)
 	if (rte_eal_intr_init() < 0)
 		rte_panic("Cannot init interrupt-handling thread\n");
 
-	RTE_LCORE_FOREACH_SLAVE(i) {
-
-		/*
-		 * create communication pipes between master thread
-		 * and children
-		 */
-		if (pipe(lcore_config[i].pipe_master2slave) < 0)
-			rte_panic("Cannot create pipe\n");
-		if (pipe(lcore_config[i].pipe_slave2master) < 0)
-			rte_panic("Cannot create pipe\n");
-
+	/* slave and service lcores each get a thread */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (rte_config.lcore_role[i] == ROLE_OFF ||
+				i == (int)rte_config.master_lcore)
+			continue;
 		lcore_config[i].state = WAIT;
 
 		/* create a thread for each lcore */
@@ -874,6 +940,9 @@ rte_eal_init(int argc, char **argv)
 	rte_eal_mp_remote_launch(sync_func, NULL, SKIP_MASTER);
 	rte_eal_mp_wait_lcore();
 
+	if (rte_eal_service_init() < 0)
+		rte_panic("Cannot start service lcores\n");
+
 	/* Probe & Initialize PCI devices */
 	if (rte_eal_pci_probe())
 		rte_panic("Cannot probe PCI\n");
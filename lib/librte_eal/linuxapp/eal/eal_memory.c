@@ -80,6 +80,8 @@
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
 
 #include <rte_log.h>
 #include <rte_memory.h>
@@ -91,11 +93,13 @@
 #include <rte_lcore.h>
 #include <rte_common.h>
 #include <rte_string_fns.h>
+#include <rte_spinlock.h>
 
 #include "eal_private.h"
 #include "eal_internal_cfg.h"
 #include "eal_filesystem.h"
 #include "eal_hugepages.h"
+#include "eal_thread.h"
 
 #ifdef RTE_LIBRTE_XEN_DOM0
 int rte_xen_dom0_supported(void)
@@ -120,6 +124,25 @@ static uint64_t baseaddr_offset;
 
 static unsigned proc_pagemap_readable;
 
+/* minimum amount of memory worth a mapping thread at init */
+#define HUGEPAGE_MAP_JOB_MIN_SIZE (64ULL << 20)
+
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+/* hugepages of the memory segments mapped at runtime, in the primary */
+struct dynamic_memseg {
+	struct hugepage_file *pages; /**< NULL if not mapped at runtime */
+	unsigned nb_pages;
+};
+
+static struct dynamic_memseg dynamic_memsegs[RTE_MAX_MEMSEG];
+/* next file number of each hugepage size */
+static int dynamic_file_id[MAX_HUGEPAGE_SIZES];
+static rte_spinlock_t dynamic_memseg_lock = RTE_SPINLOCK_INITIALIZER;
+/* CPUs allowed at init, before the affinity of the master lcore is set */
+static rte_cpuset_t dynamic_socket_cpus[RTE_MAX_NUMA_NODES];
+static unsigned dynamic_nb_cpus[RTE_MAX_NUMA_NODES];
+#endif
+
 #define RANDOMIZE_VA_SPACE_FILE "/proc/sys/kernel/randomize_va_space"
 
 static void
@@ -151,43 +174,26 @@ rte_mem_lock_page(const void *virt)
 }
 
 /*
- * Get physical address of any mapped virtual address in the current process.
+ * Get physical address of a virtual address, using the given file
+ * descriptor of /proc/self/pagemap.
  */
-phys_addr_t
-rte_mem_virt2phy(const void *virtaddr)
+static phys_addr_t
+pagemap_virt2phy(int fd, const void *virtaddr)
 {
-	int fd;
-	uint64_t page, physaddr;
+	uint64_t page;
 	unsigned long virt_pfn;
 	int page_size;
 	off_t offset;
 
-	/* Cannot parse /proc/self/pagemap, no need to log errors everywhere */
-	if (!proc_pagemap_readable)
-		return RTE_BAD_PHYS_ADDR;
-
 	/* standard page size */
 	page_size = getpagesize();
 
-	fd = open("/proc/self/pagemap", O_RDONLY);
-	if (fd < 0) {
-		RTE_LOG(ERR, EAL, "%s(): cannot open /proc/self/pagemap: %s\n",
-			__func__, strerror(errno));
-		return RTE_BAD_PHYS_ADDR;
-	}
-
 	virt_pfn = (unsigned long)virtaddr / page_size;
 	offset = sizeof(uint64_t) * virt_pfn;
-	if (lseek(fd, offset, SEEK_SET) == (off_t) -1) {
-		RTE_LOG(ERR, EAL, "%s(): seek error in /proc/self/pagemap: %s\n",
-				__func__, strerror(errno));
-		close(fd);
-		return RTE_BAD_PHYS_ADDR;
-	}
-	if (read(fd, &page, sizeof(uint64_t)) < 0) {
+	if (pread(fd, &page, sizeof(uint64_t), offset) !=
+			(ssize_t)sizeof(uint64_t)) {
 		RTE_LOG(ERR, EAL, "%s(): cannot read /proc/self/pagemap: %s\n",
 				__func__, strerror(errno));
-		close(fd);
 		return RTE_BAD_PHYS_ADDR;
 	}
 
@@ -195,31 +201,83 @@ rte_mem_virt2phy(const void *virtaddr)
 	 * the pfn (page frame number) are bits 0-54 (see
 	 * pagemap.txt in linux Documentation)
 	 */
-	physaddr = ((page & 0x7fffffffffffffULL) * page_size)
+	return ((page & 0x7fffffffffffffULL) * page_size)
 		+ ((unsigned long)virtaddr % page_size);
+}
+
+/*
+ * Get physical address of any mapped virtual address in the current process.
+ */
+phys_addr_t
+rte_mem_virt2phy(const void *virtaddr)
+{
+	int fd;
+	phys_addr_t physaddr;
+
+	/* devices see virtual addresses through the IOMMU */
+	if (internal_config.iova_va)
+		return (uintptr_t)virtaddr;
+
+	/* Cannot parse /proc/self/pagemap, no need to log errors everywhere */
+	if (!proc_pagemap_readable)
+		return RTE_BAD_PHYS_ADDR;
+
+	fd = open("/proc/self/pagemap", O_RDONLY);
+	if (fd < 0) {
+		RTE_LOG(ERR, EAL, "%s(): cannot open /proc/self/pagemap: %s\n",
+			__func__, strerror(errno));
+		return RTE_BAD_PHYS_ADDR;
+	}
+
+	physaddr = pagemap_virt2phy(fd, virtaddr);
 	close(fd);
 	return physaddr;
 }
 
 /*
  * For each hugepage in hugepg_tbl, fill the physaddr value. We find
- * it by browsing the /proc/self/pagemap special file.
+ * it by browsing the /proc/self/pagemap special file, opened once for
+ * all pages.
  */
 static int
 find_physaddrs(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi)
 {
 	unsigned i;
 	phys_addr_t addr;
+	int fd;
+
+	if (!proc_pagemap_readable)
+		return -1;
+
+	fd = open("/proc/self/pagemap", O_RDONLY);
+	if (fd < 0) {
+		RTE_LOG(ERR, EAL, "%s(): cannot open /proc/self/pagemap: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
 
 	for (i = 0; i < hpi->num_pages[0]; i++) {
-		addr = rte_mem_virt2phy(hugepg_tbl[i].orig_va);
-		if (addr == RTE_BAD_PHYS_ADDR)
+		addr = pagemap_virt2phy(fd, hugepg_tbl[i].orig_va);
+		if (addr == RTE_BAD_PHYS_ADDR) {
+			close(fd);
 			return -1;
+		}
 		hugepg_tbl[i].physaddr = addr;
 	}
+	close(fd);
 	return 0;
 }
 
+/* Monotonic time in microseconds, to report hugepage init phases. */
+static uint64_t
+hugepage_init_time_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 /*
  * Check whether address-space layout randomization is enabled in
  * the kernel. This is important for multi-process as it can prevent
@@ -309,49 +367,270 @@ get_virtual_area(size_t *size, size_t hugepage_sz)
 	return addr;
 }
 
+/*
+ * Open a hugepage file and mmap() it at addr, either as a hint or, when
+ * MAP_FIXED is given in flags, over an area reserved beforehand. The
+ * page tables are populated, so the kernel clears the page in the calling
+ * thread. Returns the mapped address or NULL on error.
+ */
+static void *
+map_hugepage(const struct hugepage_file *hf, void *addr, int flags)
+{
+	int fd;
+	void *virtaddr;
+
+	/* try to create hugepage file */
+	fd = open(hf->filepath, O_CREAT | O_RDWR, 0755);
+	if (fd < 0) {
+		RTE_LOG(ERR, EAL, "%s(): open failed: %s\n", __func__,
+				strerror(errno));
+		return NULL;
+	}
+
+	/* map the segment, and populate page tables,
+	 * the kernel fills this segment with zeros */
+	virtaddr = mmap(addr, hf->size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE | flags, fd, 0);
+	if (virtaddr == MAP_FAILED) {
+		RTE_LOG(ERR, EAL, "%s(): mmap failed: %s\n", __func__,
+				strerror(errno));
+		close(fd);
+		return NULL;
+	}
+
+	/* set shared flock on the file. */
+	if (flock(fd, LOCK_SH | LOCK_NB) == -1) {
+		RTE_LOG(ERR, EAL, "%s(): Locking file failed:%s \n",
+			__func__, strerror(errno));
+		munmap(virtaddr, hf->size);
+		close(fd);
+		return NULL;
+	}
+
+	close(fd);
+	return virtaddr;
+}
+
+/* Range of hugepages mapped by one thread during the first mapping. */
+struct hugepage_map_job {
+	pthread_t thread;
+	struct hugepage_file *tbl;
+	unsigned start;       /**< first page of the range */
+	unsigned end;         /**< page following the range */
+	void *va;             /**< fixed address of page 0, or NULL */
+	rte_cpuset_t cpuset;  /**< CPUs of the NUMA socket to run on */
+	int threaded;         /**< true if run by its own thread */
+	int ret;
+};
+
+static void *
+map_hugepage_job(void *arg)
+{
+	struct hugepage_map_job *job = arg;
+	struct hugepage_file *hf;
+	void *addr = NULL;
+	unsigned i;
+
+	job->ret = 0;
+	for (i = job->start; i < job->end; i++) {
+		hf = &job->tbl[i];
+		if (job->va != NULL)
+			addr = RTE_PTR_ADD(job->va, (size_t)i * hf->size);
+		hf->orig_va = map_hugepage(hf, addr,
+				job->va != NULL ? MAP_FIXED : 0);
+		if (hf->orig_va == NULL) {
+			job->ret = -1;
+			break;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Get the CPUs of each NUMA socket the process is allowed to run on.
+ */
+static void
+hugepage_socket_cpus(rte_cpuset_t socket_cpus[], unsigned nb_cpus[])
+{
+	rte_cpuset_t allowed;
+	unsigned cpu, socket;
+
+	/* only pin threads to CPUs the process is allowed to run on */
+	if (pthread_getaffinity_np(pthread_self(), sizeof(allowed),
+			&allowed) != 0)
+		CPU_ZERO(&allowed);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		CPU_ZERO(&socket_cpus[socket]);
+		nb_cpus[socket] = 0;
+	}
+	for (cpu = 0; cpu < RTE_MAX_LCORE && cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &allowed) || !eal_cpu_detected(cpu))
+			continue;
+		socket = eal_cpu_socket_id(cpu);
+		if (socket >= RTE_MAX_NUMA_NODES)
+			continue;
+		CPU_SET(cpu, &socket_cpus[socket]);
+		nb_cpus[socket]++;
+	}
+}
+
+/*
+ * Split nb_pages hugepages of hugepage_sz bytes in ranges, one per
+ * mapping thread. Up to RTE_EAL_HUGEPAGE_INIT_THREADS threads are used
+ * on each NUMA socket, each of them running on the CPUs of its socket so
+ * that the kernel allocates and clears the pages on the local node.
+ * Returns the number of jobs.
+ */
+static unsigned
+hugepage_map_jobs_init(struct hugepage_map_job *jobs, unsigned max_jobs,
+		unsigned nb_pages, uint64_t hugepage_sz)
+{
+	rte_cpuset_t socket_cpus[RTE_MAX_NUMA_NODES];
+	unsigned nb_cpus[RTE_MAX_NUMA_NODES];
+	unsigned socket, thread, nb_jobs = 0, max_size_jobs, i;
+
+	hugepage_socket_cpus(socket_cpus, nb_cpus);
+
+	/* do not bother spawning threads for a few pages */
+	max_size_jobs = (nb_pages * hugepage_sz) / HUGEPAGE_MAP_JOB_MIN_SIZE;
+	if (max_size_jobs < max_jobs)
+		max_jobs = max_size_jobs;
+
+	/* spread the threads over the sockets */
+	for (thread = 0; thread < RTE_EAL_HUGEPAGE_INIT_THREADS; thread++) {
+		for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+			if (nb_jobs == max_jobs || nb_cpus[socket] <= thread)
+				continue;
+			jobs[nb_jobs++].cpuset = socket_cpus[socket];
+		}
+	}
+
+	/* no usable CPU information: map everything from this thread */
+	if (nb_jobs == 0) {
+		CPU_ZERO(&jobs[0].cpuset);
+		nb_jobs = 1;
+	}
+
+	for (i = 0; i < nb_jobs; i++) {
+		jobs[i].start = (uint64_t)nb_pages * i / nb_jobs;
+		jobs[i].end = (uint64_t)nb_pages * (i + 1) / nb_jobs;
+	}
+	return nb_jobs;
+}
+
+/*
+ * Start a mapping job in a thread running on the CPUs of the job. If
+ * the thread cannot be started, the job is done by the calling thread.
+ */
+static void
+hugepage_map_job_start(struct hugepage_map_job *job)
+{
+	pthread_attr_t attr;
+
+	job->threaded = 0;
+	if (CPU_COUNT(&job->cpuset) != 0 && pthread_attr_init(&attr) == 0) {
+		if (pthread_attr_setaffinity_np(&attr, sizeof(job->cpuset),
+				&job->cpuset) == 0 &&
+				pthread_create(&job->thread, &attr,
+					map_hugepage_job, job) == 0)
+			job->threaded = 1;
+		pthread_attr_destroy(&attr);
+	}
+
+	if (!job->threaded)
+		map_hugepage_job(job);
+}
+
+/* Wait for the end of a mapping job, returns its status. */
+static int
+hugepage_map_job_wait(struct hugepage_map_job *job)
+{
+	if (job->threaded)
+		pthread_join(job->thread, NULL);
+	return job->ret;
+}
+
 /*
  * Mmap all hugepages of hugepage table: it first open a file in
- * hugetlbfs, then mmap() hugepage_sz data in it. If orig is set, the
- * virtual address is stored in hugepg_tbl[i].orig_va, else it is stored
- * in hugepg_tbl[i].final_va. The second mapping (when orig is 0) tries to
- * map continguous physical blocks in contiguous virtual blocks.
+ * hugetlbfs, then mmap() hugepage_sz data in it. The virtual address is
+ * stored in hugepg_tbl[i].orig_va. If va is not NULL, page i is mapped at
+ * va + i * hugepage_sz, in an area reserved by the caller. Mapping, and
+ * the clearing of the pages by the kernel, is shared among several
+ * threads per NUMA socket.
  */
 static int
 map_all_hugepages(struct hugepage_file *hugepg_tbl,
-		struct hugepage_info *hpi, int orig)
+		struct hugepage_info *hpi, void *va, unsigned *nb_threads)
 {
-	int fd;
-	unsigned i;
-	void *virtaddr;
-	void *vma_addr = NULL;
-	size_t vma_len = 0;
+	struct hugepage_map_job jobs[RTE_MAX_NUMA_NODES *
+			RTE_EAL_HUGEPAGE_INIT_THREADS];
+	unsigned i, nb_jobs;
+	int ret = 0;
 
+	for (i = 0; i < hpi->num_pages[0]; i++) {
+		hugepg_tbl[i].file_id = i;
+		hugepg_tbl[i].size = hpi->hugepage_sz;
 #ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
-	RTE_SET_USED(vma_len);
+		eal_get_hugefile_temp_path(hugepg_tbl[i].filepath,
+				sizeof(hugepg_tbl[i].filepath), hpi->hugedir,
+				hugepg_tbl[i].file_id);
+#else
+		eal_get_hugefile_path(hugepg_tbl[i].filepath,
+				sizeof(hugepg_tbl[i].filepath), hpi->hugedir,
+				hugepg_tbl[i].file_id);
 #endif
+		hugepg_tbl[i].filepath[sizeof(hugepg_tbl[i].filepath) - 1] = '\0';
+	}
+
+	nb_jobs = hugepage_map_jobs_init(jobs, RTE_DIM(jobs),
+			hpi->num_pages[0], hpi->hugepage_sz);
+	*nb_threads = nb_jobs;
+
+	/* a single job is run by the current thread */
+	if (nb_jobs == 1) {
+		jobs[0].tbl = hugepg_tbl;
+		jobs[0].va = va;
+		map_hugepage_job(&jobs[0]);
+		return jobs[0].ret;
+	}
+
+	for (i = 0; i < nb_jobs; i++) {
+		jobs[i].tbl = hugepg_tbl;
+		jobs[i].va = va;
+		hugepage_map_job_start(&jobs[i]);
+	}
+
+	for (i = 0; i < nb_jobs; i++) {
+		if (hugepage_map_job_wait(&jobs[i]) < 0)
+			ret = -1;
+	}
+	return ret;
+}
+
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+/*
+ * Map again all hugepages of hugepage table, sorted by physical address:
+ * the virtual address is stored in hugepg_tbl[i].final_va. This second
+ * mapping tries to map continguous physical blocks in contiguous virtual
+ * blocks.
+ */
+static int
+remap_hugepages_physcontig(struct hugepage_file *hugepg_tbl,
+		struct hugepage_info *hpi)
+{
+	unsigned i;
+	void *vma_addr = NULL;
+	size_t vma_len = 0;
 
 	for (i = 0; i < hpi->num_pages[0]; i++) {
 		uint64_t hugepage_sz = hpi->hugepage_sz;
 
-		if (orig) {
-			hugepg_tbl[i].file_id = i;
-			hugepg_tbl[i].size = hugepage_sz;
-#ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
-			eal_get_hugefile_temp_path(hugepg_tbl[i].filepath,
-					sizeof(hugepg_tbl[i].filepath), hpi->hugedir,
-					hugepg_tbl[i].file_id);
-#else
-			eal_get_hugefile_path(hugepg_tbl[i].filepath,
-					sizeof(hugepg_tbl[i].filepath), hpi->hugedir,
-					hugepg_tbl[i].file_id);
-#endif
-			hugepg_tbl[i].filepath[sizeof(hugepg_tbl[i].filepath) - 1] = '\0';
-		}
 #ifndef RTE_ARCH_64
 		/* for 32-bit systems, don't remap 1G and 16G pages, just reuse
 		 * original map address as final map address.
 		 */
-		else if ((hugepage_sz == RTE_PGSIZE_1G)
+		if ((hugepage_sz == RTE_PGSIZE_1G)
 			|| (hugepage_sz == RTE_PGSIZE_16G)) {
 			hugepg_tbl[i].final_va = hugepg_tbl[i].orig_va;
 			hugepg_tbl[i].orig_va = NULL;
@@ -359,8 +638,7 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl,
 		}
 #endif
 
-#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
-		else if (vma_len == 0) {
+		if (vma_len == 0) {
 			unsigned j, num_pages;
 
 			/* reserve a virtual area for next contiguous
@@ -389,43 +667,11 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl,
 			if (vma_addr == NULL)
 				vma_len = hugepage_sz;
 		}
-#endif
 
-		/* try to create hugepage file */
-		fd = open(hugepg_tbl[i].filepath, O_CREAT | O_RDWR, 0755);
-		if (fd < 0) {
-			RTE_LOG(ERR, EAL, "%s(): open failed: %s\n", __func__,
-					strerror(errno));
-			return -1;
-		}
-
-		/* map the segment, and populate page tables,
-		 * the kernel fills this segment with zeros */
-		virtaddr = mmap(vma_addr, hugepage_sz, PROT_READ | PROT_WRITE,
-				MAP_SHARED | MAP_POPULATE, fd, 0);
-		if (virtaddr == MAP_FAILED) {
-			RTE_LOG(ERR, EAL, "%s(): mmap failed: %s\n", __func__,
-					strerror(errno));
-			close(fd);
-			return -1;
-		}
-
-		if (orig) {
-			hugepg_tbl[i].orig_va = virtaddr;
-		}
-		else {
-			hugepg_tbl[i].final_va = virtaddr;
-		}
-
-		/* set shared flock on the file. */
-		if (flock(fd, LOCK_SH | LOCK_NB) == -1) {
-			RTE_LOG(ERR, EAL, "%s(): Locking file failed:%s \n",
-				__func__, strerror(errno));
-			close(fd);
+		hugepg_tbl[i].final_va = map_hugepage(&hugepg_tbl[i],
+				vma_addr, 0);
+		if (hugepg_tbl[i].final_va == NULL)
 			return -1;
-		}
-
-		close(fd);
 
 		vma_addr = (char *)vma_addr + hugepage_sz;
 		vma_len -= hugepage_sz;
@@ -433,6 +679,51 @@ map_all_hugepages(struct hugepage_file *hugepg_tbl,
 	return 0;
 }
 
+/*
+ * Reserve a virtual area for size bytes of hugepages, aligned on the
+ * hugepage size, so that pages can be mapped at fixed addresses in it
+ * without a second mapping. The area is not backed by memory.
+ */
+static void *
+reserve_hugepage_area(size_t size, size_t hugepage_sz)
+{
+	void *addr = NULL;
+	uintptr_t aligned;
+	uint64_t offset;
+	size_t head;
+
+	/* areas may be reserved by several threads at runtime */
+	rte_spinlock_lock(&dynamic_memseg_lock);
+	offset = baseaddr_offset;
+	baseaddr_offset += size;
+	rte_spinlock_unlock(&dynamic_memseg_lock);
+
+	if (internal_config.base_virtaddr != 0)
+		addr = (void *)(uintptr_t)(internal_config.base_virtaddr +
+				offset);
+
+	addr = mmap(addr, size + hugepage_sz, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (addr == MAP_FAILED) {
+		RTE_LOG(ERR, EAL, "Cannot reserve a virtual area of 0x%zx "
+			"bytes: %s\n", size, strerror(errno));
+		return NULL;
+	}
+
+	/* trim the area to a hugepage size boundary */
+	aligned = RTE_ALIGN_CEIL((uintptr_t)addr, hugepage_sz);
+	head = aligned - (uintptr_t)addr;
+	if (head != 0)
+		munmap(addr, head);
+	munmap((void *)(aligned + size), hugepage_sz - head);
+
+	RTE_LOG(DEBUG, EAL, "Virtual area reserved at 0x%" PRIxPTR
+		" (size = 0x%zx)\n", aligned, size);
+
+	return (void *)aligned;
+}
+#endif /* RTE_EAL_SINGLE_FILE_SEGMENTS */
+
 #ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
 
 /*
@@ -611,9 +902,24 @@ unmap_all_hugepages_orig(struct hugepage_file *hugepg_tbl, struct hugepage_info
 }
 #endif /* RTE_EAL_SINGLE_FILE_SEGMENTS */
 
+static int
+cmp_orig_va(const void *a, const void *b)
+{
+	const struct hugepage_file *p1 = *(const struct hugepage_file * const *)a;
+	const struct hugepage_file *p2 = *(const struct hugepage_file * const *)b;
+
+	if (p1->orig_va < p2->orig_va)
+		return -1;
+	else if (p1->orig_va > p2->orig_va)
+		return 1;
+	else
+		return 0;
+}
+
 /*
  * Parse /proc/self/numa_maps to get the NUMA socket ID for each huge
- * page.
+ * page. Pages are looked up by their original address in a sorted
+ * array of pointers to the hugepage table.
  */
 static int
 find_numasocket(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi)
@@ -624,6 +930,7 @@ find_numasocket(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi)
 	uint64_t virt_addr;
 	char buf[BUFSIZ];
 	char hugedir_str[PATH_MAX];
+	struct hugepage_file **sorted, key, *pkey = &key, **found;
 	FILE *f;
 
 	f = fopen("/proc/self/numa_maps", "r");
@@ -633,6 +940,15 @@ find_numasocket(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi)
 		return 0;
 	}
 
+	sorted = malloc(hpi->num_pages[0] * sizeof(sorted[0]));
+	if (sorted == NULL) {
+		fclose(f);
+		return -1;
+	}
+	for (i = 0; i < hpi->num_pages[0]; i++)
+		sorted[i] = &hugepg_tbl[i];
+	qsort(sorted, hpi->num_pages[0], sizeof(sorted[0]), cmp_orig_va);
+
 	snprintf(hugedir_str, sizeof(hugedir_str),
 			"%s/%s", hpi->hugedir, internal_config.hugefile_prefix);
 
@@ -673,22 +989,24 @@ find_numasocket(struct hugepage_file *hugepg_tbl, struct hugepage_info *hpi)
 		}
 
 		/* if we find this page in our mappings, set socket_id */
-		for (i = 0; i < hpi->num_pages[0]; i++) {
-			void *va = (void *)(unsigned long)virt_addr;
-			if (hugepg_tbl[i].orig_va == va) {
-				hugepg_tbl[i].socket_id = socket_id;
-				hp_count++;
-			}
+		key.orig_va = (void *)(unsigned long)virt_addr;
+		found = bsearch(&pkey, sorted, hpi->num_pages[0],
+				sizeof(sorted[0]), cmp_orig_va);
+		if (found != NULL) {
+			(*found)->socket_id = socket_id;
+			hp_count++;
 		}
 	}
 
 	if (hp_count < hpi->num_pages[0])
 		goto error;
 
+	free(sorted);
 	fclose(f);
 	return 0;
 
 error:
+	free(sorted);
 	fclose(f);
 	return -1;
 }
@@ -712,6 +1030,33 @@ cmp_physaddr(const void *a, const void *b)
 		return 0;
 }
 
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+/*
+ * Pages mapped at their final address: group them by socket, keeping
+ * the address order within a socket.
+ */
+static int
+cmp_socket_va(const void *a, const void *b)
+{
+#ifndef RTE_ARCH_PPC_64
+	const struct hugepage_file *p1 = (const struct hugepage_file *)a;
+	const struct hugepage_file *p2 = (const struct hugepage_file *)b;
+#else
+	/* PowerPC needs memory sorted in reverse order from x86 */
+	const struct hugepage_file *p1 = (const struct hugepage_file *)b;
+	const struct hugepage_file *p2 = (const struct hugepage_file *)a;
+#endif
+	if (p1->socket_id != p2->socket_id)
+		return p1->socket_id < p2->socket_id ? -1 : 1;
+	if (p1->final_va < p2->final_va)
+		return -1;
+	else if (p1->final_va > p2->final_va)
+		return 1;
+	else
+		return 0;
+}
+#endif
+
 /*
  * Uses mmap to create a shared memory area for storage of data
  * Used in this file to store the hugepage file map on disk
@@ -1039,13 +1384,17 @@ calc_num_pages_per_socket(uint64_t * memory,
 /*
  * Prepare physical memory mapping: fill configuration structure with
  * these infos, return 0 on success.
- *  1. map N huge pages in separate files in hugetlbfs
+ *  1. map N huge pages in separate files in hugetlbfs, from several
+ *     threads per NUMA socket
  *  2. find associated physical addr
  *  3. find associated NUMA socket ID
  *  4. sort all huge pages by physical address
  *  5. remap these N huge pages in the correct order
  *  6. unmap the first mapping
  *  7. fill memsegs in configuration with contiguous zones
+ * With --iova-mode=va, the pages are mapped at their final address in
+ * step 1, the virtual address is used as physical address and steps 5
+ * and 6 are skipped.
  */
 int
 rte_eal_hugepage_init(void)
@@ -1060,6 +1409,9 @@ rte_eal_hugepage_init(void)
 	int i, j, new_memseg;
 	int nr_hugefiles, nr_hugepages = 0;
 	void *addr;
+	void *va_area = NULL;
+	unsigned k, nb_threads;
+	uint64_t t_start, t_map, t_phys, t_numa, t_end;
 #ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
 	int new_pages_count[MAX_HUGEPAGE_SIZES];
 #endif
@@ -1071,6 +1423,15 @@ rte_eal_hugepage_init(void)
 	/* get pointer to global configuration */
 	mcfg = rte_eal_get_configuration()->mem_config;
 
+	/* secondary processes only map the segments existing at startup */
+	mcfg->dynamic_mem = internal_config.dynamic_mem;
+	/* and give devices the same addresses as the primary process */
+	mcfg->iova_va = internal_config.iova_va;
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+	if (internal_config.dynamic_mem)
+		hugepage_socket_cpus(dynamic_socket_cpus, dynamic_nb_cpus);
+#endif
+
 	/* hugetlbfs can be disabled */
 	if (internal_config.no_hugetlbfs) {
 		addr = mmap(NULL, internal_config.memory, PROT_READ | PROT_WRITE,
@@ -1106,6 +1467,11 @@ rte_eal_hugepage_init(void)
 		used_hp[i].hugepage_sz = internal_config.hugepage_info[i].hugepage_sz;
 
 		nr_hugepages += internal_config.hugepage_info[i].num_pages[0];
+
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+		/* pages mapped at runtime get the next file numbers */
+		dynamic_file_id[i] = internal_config.hugepage_info[i].num_pages[0];
+#endif
 	}
 
 	/*
@@ -1136,30 +1502,51 @@ rte_eal_hugepage_init(void)
 		if (hpi->num_pages[0] == 0)
 			continue;
 
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+		/* with IOVA as VA, pages are mapped once at their final
+		 * address, physical contiguity being irrelevant */
+		if (internal_config.iova_va) {
+			va_area = reserve_hugepage_area(
+					hpi->num_pages[0] * hpi->hugepage_sz,
+					hpi->hugepage_sz);
+			if (va_area == NULL)
+				goto fail;
+		}
+#endif
+		t_start = hugepage_init_time_us();
+
 		/* map all hugepages available */
-		if (map_all_hugepages(&tmp_hp[hp_offset], hpi, 1) < 0){
+		if (map_all_hugepages(&tmp_hp[hp_offset], hpi, va_area,
+				&nb_threads) < 0) {
 			RTE_LOG(DEBUG, EAL, "Failed to mmap %u MB hugepages\n",
 					(unsigned)(hpi->hugepage_sz / 0x100000));
 			goto fail;
 		}
+		t_map = hugepage_init_time_us();
 
 		/* find physical addresses and sockets for each hugepage */
-		if (find_physaddrs(&tmp_hp[hp_offset], hpi) < 0){
+		if (va_area != NULL) {
+			for (k = 0; k < hpi->num_pages[0]; k++)
+				tmp_hp[hp_offset + k].physaddr = (phys_addr_t)
+					(uintptr_t)tmp_hp[hp_offset + k].orig_va;
+		} else if (find_physaddrs(&tmp_hp[hp_offset], hpi) < 0){
 			RTE_LOG(DEBUG, EAL, "Failed to find phys addr for %u MB pages\n",
 					(unsigned)(hpi->hugepage_sz / 0x100000));
 			goto fail;
 		}
+		t_phys = hugepage_init_time_us();
 
 		if (find_numasocket(&tmp_hp[hp_offset], hpi) < 0){
 			RTE_LOG(DEBUG, EAL, "Failed to find NUMA socket for %u MB pages\n",
 					(unsigned)(hpi->hugepage_sz / 0x100000));
 			goto fail;
 		}
+		t_numa = hugepage_init_time_us();
 
+#ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
 		qsort(&tmp_hp[hp_offset], hpi->num_pages[0],
 		      sizeof(struct hugepage_file), cmp_physaddr);
 
-#ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
 		/* remap all hugepages into single file segments */
 		new_pages_count[i] = remap_all_hugepages(&tmp_hp[hp_offset], hpi);
 		if (new_pages_count[i] < 0){
@@ -1171,20 +1558,45 @@ rte_eal_hugepage_init(void)
 		/* we have processed a num of hugepages of this size, so inc offset */
 		hp_offset += new_pages_count[i];
 #else
-		/* remap all hugepages */
-		if (map_all_hugepages(&tmp_hp[hp_offset], hpi, 0) < 0){
-			RTE_LOG(DEBUG, EAL, "Failed to remap %u MB pages\n",
-					(unsigned)(hpi->hugepage_sz / 0x100000));
-			goto fail;
-		}
+		if (va_area != NULL) {
+			/* the first mapping is the final one */
+			for (k = 0; k < hpi->num_pages[0]; k++) {
+				tmp_hp[hp_offset + k].final_va =
+					tmp_hp[hp_offset + k].orig_va;
+				tmp_hp[hp_offset + k].orig_va = NULL;
+			}
+			qsort(&tmp_hp[hp_offset], hpi->num_pages[0],
+			      sizeof(struct hugepage_file), cmp_socket_va);
+			va_area = NULL;
+		} else {
+			qsort(&tmp_hp[hp_offset], hpi->num_pages[0],
+			      sizeof(struct hugepage_file), cmp_physaddr);
+
+			/* remap all hugepages */
+			if (remap_hugepages_physcontig(&tmp_hp[hp_offset],
+					hpi) < 0) {
+				RTE_LOG(DEBUG, EAL, "Failed to remap %u MB pages\n",
+						(unsigned)(hpi->hugepage_sz / 0x100000));
+				goto fail;
+			}
 
-		/* unmap original mappings */
-		if (unmap_all_hugepages_orig(&tmp_hp[hp_offset], hpi) < 0)
-			goto fail;
+			/* unmap original mappings */
+			if (unmap_all_hugepages_orig(&tmp_hp[hp_offset], hpi) < 0)
+				goto fail;
+		}
 
 		/* we have processed a num of hugepages of this size, so inc offset */
 		hp_offset += hpi->num_pages[0];
 #endif
+		t_end = hugepage_init_time_us();
+
+		RTE_LOG(INFO, EAL, "Mapped %u hugepages of %u MB with %u "
+			"thread(s): map %" PRIu64 " us, physaddr %" PRIu64
+			" us, numa %" PRIu64 " us, sort/remap %" PRIu64 " us\n",
+			hpi->num_pages[0],
+			(unsigned)(hpi->hugepage_sz / 0x100000), nb_threads,
+			t_map - t_start, t_phys - t_map, t_numa - t_phys,
+			t_end - t_numa);
 	}
 
 #ifdef RTE_EAL_SINGLE_FILE_SEGMENTS
@@ -1377,6 +1789,262 @@ fail:
 	return -1;
 }
 
+#ifndef RTE_EAL_SINGLE_FILE_SEGMENTS
+static void memseg_unmap(const struct rte_memseg *ms);
+
+/*
+ * Unmap and remove the hugepages of a failed memory growth: the whole
+ * reserved area is unmapped, whether pages were mapped in it or not.
+ */
+static void
+memseg_grow_rollback(struct hugepage_file *pages, unsigned nb_pages,
+		void *va)
+{
+	unsigned i;
+
+	munmap(va, nb_pages * pages[0].size);
+	for (i = 0; i < nb_pages; i++)
+		unlink(pages[i].filepath);
+}
+
+int
+rte_eal_memseg_grow(size_t len, int socket_id, uint64_t hugepage_sz,
+		struct rte_memseg *segs[], unsigned max_segs)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct hugepage_info hpi;
+	struct hugepage_file *pages;
+	struct hugepage_map_job job;
+	unsigned i, j, h, nb_pages, nb_segs = 0, ms_idx = 0;
+	struct rte_memseg *ms;
+	void *va;
+
+	if (!internal_config.dynamic_mem ||
+			internal_config.process_type != RTE_PROC_PRIMARY ||
+			socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return -EINVAL;
+
+	for (h = 0; h < internal_config.num_hugepage_sizes; h++)
+		if (internal_config.hugepage_info[h].hugepage_sz ==
+				hugepage_sz)
+			break;
+	if (h == internal_config.num_hugepage_sizes)
+		return -EINVAL;
+	hpi = internal_config.hugepage_info[h];
+
+	/* pages are faulted from a CPU of the socket to get local memory */
+	if (dynamic_nb_cpus[socket_id] == 0)
+		return -ENODEV;
+
+	nb_pages = RTE_ALIGN_CEIL(len, hugepage_sz) / hugepage_sz;
+	pages = calloc(nb_pages, sizeof(*pages));
+	if (pages == NULL)
+		return -ENOMEM;
+
+	va = reserve_hugepage_area(nb_pages * hugepage_sz, hugepage_sz);
+	if (va == NULL) {
+		free(pages);
+		return -ENOMEM;
+	}
+
+	/* number the files after those of the pages mapped at init */
+	rte_spinlock_lock(&dynamic_memseg_lock);
+	for (i = 0; i < nb_pages; i++) {
+		pages[i].file_id = dynamic_file_id[h]++;
+		pages[i].size = hugepage_sz;
+		eal_get_hugefile_path(pages[i].filepath,
+				sizeof(pages[i].filepath), hpi.hugedir,
+				pages[i].file_id);
+	}
+	rte_spinlock_unlock(&dynamic_memseg_lock);
+
+	memset(&job, 0, sizeof(job));
+	job.tbl = pages;
+	job.start = 0;
+	job.end = nb_pages;
+	job.va = va;
+	job.cpuset = dynamic_socket_cpus[socket_id];
+	hugepage_map_job_start(&job);
+	if (hugepage_map_job_wait(&job) < 0)
+		goto fail;
+
+	/* the kernel may have fallen back to another node */
+	hpi.num_pages[0] = nb_pages;
+	if (find_numasocket(pages, &hpi) < 0)
+		goto fail;
+	for (i = 0; i < nb_pages; i++) {
+		if (pages[i].socket_id != socket_id) {
+			RTE_LOG(DEBUG, EAL, "No free %u MB hugepage on "
+				"socket %d\n",
+				(unsigned)(hugepage_sz / 0x100000), socket_id);
+			goto fail;
+		}
+	}
+
+	if (internal_config.iova_va) {
+		for (i = 0; i < nb_pages; i++)
+			pages[i].physaddr =
+				(phys_addr_t)(uintptr_t)pages[i].orig_va;
+	} else if (find_physaddrs(pages, &hpi) < 0)
+		goto fail;
+
+	for (i = 0; i < nb_pages; i++) {
+		pages[i].final_va = pages[i].orig_va;
+		pages[i].orig_va = NULL;
+		if (internal_config.hugepage_unlink)
+			unlink(pages[i].filepath);
+	}
+
+	/* one segment per physically contiguous run of pages */
+	rte_spinlock_lock(&dynamic_memseg_lock);
+	for (i = 0; i < nb_pages; i = j) {
+		for (j = i + 1; j < nb_pages; j++)
+			if (pages[j].physaddr !=
+					pages[j - 1].physaddr + hugepage_sz)
+				break;
+
+		while (ms_idx < RTE_MAX_MEMSEG &&
+				mcfg->memseg[ms_idx].len != 0)
+			ms_idx++;
+		if (ms_idx == RTE_MAX_MEMSEG || nb_segs == max_segs) {
+			RTE_LOG(ERR, EAL, "No free memory segment, %s=%d is "
+				"not enough\n", RTE_STR(CONFIG_RTE_MAX_MEMSEG),
+				RTE_MAX_MEMSEG);
+			goto fail_segs;
+		}
+
+		dynamic_memsegs[ms_idx].pages = malloc((j - i) *
+				sizeof(*pages));
+		if (dynamic_memsegs[ms_idx].pages == NULL)
+			goto fail_segs;
+		memcpy(dynamic_memsegs[ms_idx].pages, &pages[i],
+				(j - i) * sizeof(*pages));
+		dynamic_memsegs[ms_idx].nb_pages = j - i;
+
+		ms = &mcfg->memseg[ms_idx];
+		ms->phys_addr = pages[i].physaddr;
+		ms->len = (j - i) * hugepage_sz;
+		ms->hugepage_sz = hugepage_sz;
+		ms->socket_id = socket_id;
+		ms->nchannel = mcfg->nchannel;
+		ms->nrank = mcfg->nrank;
+		ms->addr = pages[i].final_va;
+		segs[nb_segs++] = ms;
+	}
+	rte_spinlock_unlock(&dynamic_memseg_lock);
+	free(pages);
+
+	for (i = 0; i < nb_segs; i++) {
+		if (rte_eal_mem_event_notify(RTE_MEM_EVENT_ALLOC,
+				segs[i]) < 0) {
+			/*
+			 * the segments are unmapped one by one, only those
+			 * announced before are notified of their release
+			 */
+			for (j = 0; j < i; j++)
+				rte_eal_memseg_release(segs[j]);
+			for (; j < nb_segs; j++)
+				memseg_unmap(segs[j]);
+			return -1;
+		}
+	}
+
+	RTE_LOG(DEBUG, EAL, "Mapped %u hugepages of %u MB on socket %d "
+		"in %u segment(s)\n", nb_pages,
+		(unsigned)(hugepage_sz / 0x100000), socket_id, nb_segs);
+	return nb_segs;
+
+fail_segs:
+	for (i = 0; i < nb_segs; i++) {
+		ms_idx = segs[i] - mcfg->memseg;
+		free(dynamic_memsegs[ms_idx].pages);
+		dynamic_memsegs[ms_idx].pages = NULL;
+		dynamic_memsegs[ms_idx].nb_pages = 0;
+		memset(segs[i], 0, sizeof(*segs[i]));
+	}
+	rte_spinlock_unlock(&dynamic_memseg_lock);
+fail:
+	memseg_grow_rollback(pages, nb_pages, va);
+	free(pages);
+	return -1;
+}
+
+void
+rte_eal_memseg_release(const struct rte_memseg *ms)
+{
+	if (!rte_eal_memseg_is_dynamic(ms))
+		return;
+
+	rte_eal_mem_event_notify(RTE_MEM_EVENT_FREE, ms);
+	memseg_unmap(ms);
+}
+
+/* unmap a dynamic segment and remove its pages, without notification */
+static void
+memseg_unmap(const struct rte_memseg *ms)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned ms_idx = ms - mcfg->memseg;
+	struct hugepage_file *pages;
+	unsigned i, nb_pages;
+	uint64_t hugepage_sz;
+	void *addr;
+	size_t len;
+
+	rte_spinlock_lock(&dynamic_memseg_lock);
+	pages = dynamic_memsegs[ms_idx].pages;
+	nb_pages = dynamic_memsegs[ms_idx].nb_pages;
+	dynamic_memsegs[ms_idx].pages = NULL;
+	dynamic_memsegs[ms_idx].nb_pages = 0;
+	addr = ms->addr;
+	len = ms->len;
+	hugepage_sz = ms->hugepage_sz;
+	memset(&mcfg->memseg[ms_idx], 0, sizeof(mcfg->memseg[ms_idx]));
+	rte_spinlock_unlock(&dynamic_memseg_lock);
+
+	munmap(addr, len);
+	for (i = 0; i < nb_pages && !internal_config.hugepage_unlink; i++) {
+		if (unlink(pages[i].filepath) < 0)
+			RTE_LOG(WARNING, EAL, "%s(): Removing %s failed: %s\n",
+				__func__, pages[i].filepath, strerror(errno));
+	}
+	free(pages);
+
+	RTE_LOG(DEBUG, EAL, "Released %u hugepages of %u MB\n", nb_pages,
+		(unsigned)(hugepage_sz / 0x100000));
+}
+
+int
+rte_eal_memseg_is_dynamic(const struct rte_memseg *ms)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+
+	if (ms < mcfg->memseg || ms >= &mcfg->memseg[RTE_MAX_MEMSEG])
+		return 0;
+	return dynamic_memsegs[ms - mcfg->memseg].pages != NULL;
+}
+#else /* RTE_EAL_SINGLE_FILE_SEGMENTS */
+int
+rte_eal_memseg_grow(size_t len __rte_unused, int socket_id __rte_unused,
+		uint64_t hugepage_sz __rte_unused,
+		struct rte_memseg *segs[] __rte_unused,
+		unsigned max_segs __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+void
+rte_eal_memseg_release(const struct rte_memseg *ms __rte_unused)
+{
+}
+
+int
+rte_eal_memseg_is_dynamic(const struct rte_memseg *ms __rte_unused)
+{
+	return 0;
+}
+#endif /* RTE_EAL_SINGLE_FILE_SEGMENTS */
+
 /*
  * uses fstat to report the size of a file on disk
  */
@@ -1414,6 +2082,15 @@ rte_eal_hugepage_attach(void)
 
 	test_proc_pagemap_readable();
 
+	if (mcfg->dynamic_mem) {
+		RTE_LOG(ERR, EAL, "Secondary processes are not supported "
+			"when the primary process uses --dynamic-mem\n");
+		return -1;
+	}
+
+	/* the IOVA mode is the one chosen by the primary process */
+	internal_config.iova_va = mcfg->iova_va;
+
 	if (internal_config.xen_dom0_support) {
 #ifdef RTE_LIBRTE_XEN_DOM0
 		if (rte_xen_dom0_memory_attach() < 0) {
@@ -122,12 +122,60 @@ pci_get_kernel_driver_by_path(const char *filename, char *dri_name)
 	return -1;
 }
 
+/*
+ * Check if a device can be given virtual addresses: it must be bound to VFIO
+ * with an actual IOMMU translating them. Devices not managed by a kernel
+ * driver supported by the EAL are never mapped, so they do not matter.
+ */
+static int
+pci_device_iova_va_ok(const struct rte_pci_device *dev)
+{
+	switch (dev->kdrv) {
+	case RTE_KDRV_IGB_UIO:
+	case RTE_KDRV_UIO_GENERIC:
+		return 0;
+	case RTE_KDRV_VFIO:
+#ifdef VFIO_PRESENT
+		return !pci_vfio_is_noiommu(dev);
+#else
+		return 0;
+#endif
+	default:
+		return 1;
+	}
+}
+
+/* Check if all the scanned devices can be given virtual addresses */
+int
+pci_iova_va_supported(void)
+{
+	struct rte_pci_device *dev;
+
+	TAILQ_FOREACH(dev, &pci_device_list, next) {
+		if (pci_device_iova_va_ok(dev))
+			continue;
+		RTE_LOG(WARNING, EAL, "PCI device "PCI_PRI_FMT" needs "
+			"physical addresses (UIO driver or VFIO no-IOMMU)\n",
+			dev->addr.domain, dev->addr.bus, dev->addr.devid,
+			dev->addr.function);
+		return 0;
+	}
+	return 1;
+}
+
 /* Map pci device */
 int
 rte_eal_pci_map_device(struct rte_pci_device *dev)
 {
 	int ret = -1;
 
+	/* hotplugged devices were not checked at initialization */
+	if (internal_config.iova_va && !pci_device_iova_va_ok(dev)) {
+		RTE_LOG(ERR, EAL, "  Device cannot use virtual addresses "
+			"(--iova-mode=va), skipped\n");
+		return -1;
+	}
+
 	/* try mapping the NIC resources using VFIO if it exists */
 	switch (dev->kdrv) {
 	case RTE_KDRV_VFIO:
@@ -181,7 +229,7 @@ pci_find_max_end_va(void)
 
 	for (i = 0; i < RTE_MAX_MEMSEG; i++, seg++) {
 		if (seg->addr == NULL)
-			break;
+			continue;
 
 		if (seg->addr > last->addr)
 			last = seg;
@@ -42,6 +42,12 @@
 extern void *pci_map_addr;
 void *pci_find_max_end_va(void);
 
+/*
+ * Check if the devices found by the PCI scan can use virtual addresses
+ * as IOVA. Returns 1 if they can, 0 otherwise.
+ */
+int pci_iova_va_supported(void);
+
 int pci_uio_alloc_resource(struct rte_pci_device *dev,
 		struct mapped_pci_resource **uio_res);
 void pci_uio_free_resource(struct rte_pci_device *dev,
@@ -68,6 +74,7 @@ int pci_uio_ioport_unmap(struct rte_pci_ioport *p);
 
 int pci_vfio_enable(void);
 int pci_vfio_is_enabled(void);
+int pci_vfio_is_noiommu(const struct rte_pci_device *dev);
 int pci_vfio_mp_sync_setup(void);
 
 /* access config space */
@@ -102,35 +102,74 @@ static const struct vfio_iommu_type iommu_types[] = {
 	{ RTE_VFIO_NOIOMMU, "No-IOMMU", &vfio_noiommu_dma_map},
 };
 
-int
-vfio_type1_dma_map(int vfio_container_fd)
+/* map or unmap one memory segment for DMA, using 1:1 PA to IOVA mapping */
+static int
+vfio_type1_dma_mem_map(int vfio_container_fd, const struct rte_memseg *ms,
+		int do_map)
 {
-	const struct rte_memseg *ms = rte_eal_get_physmem_layout();
-	int i, ret;
+	int ret;
 
-	/* map all DPDK segments for DMA. use 1:1 PA to IOVA mapping */
-	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
+	if (do_map) {
 		struct vfio_iommu_type1_dma_map dma_map;
 
-		if (ms[i].addr == NULL)
-			break;
-
 		memset(&dma_map, 0, sizeof(dma_map));
 		dma_map.argsz = sizeof(struct vfio_iommu_type1_dma_map);
-		dma_map.vaddr = ms[i].addr_64;
-		dma_map.size = ms[i].len;
-		dma_map.iova = ms[i].phys_addr;
+		dma_map.vaddr = ms->addr_64;
+		dma_map.size = ms->len;
+		dma_map.iova = ms->phys_addr;
 		dma_map.flags = VFIO_DMA_MAP_FLAG_READ | VFIO_DMA_MAP_FLAG_WRITE;
 
 		ret = ioctl(vfio_container_fd, VFIO_IOMMU_MAP_DMA, &dma_map);
+	} else {
+		struct vfio_iommu_type1_dma_unmap dma_unmap;
 
-		if (ret) {
-			RTE_LOG(ERR, EAL, "  cannot set up DMA remapping, "
-					"error %i (%s)\n", errno, strerror(errno));
+		memset(&dma_unmap, 0, sizeof(dma_unmap));
+		dma_unmap.argsz = sizeof(struct vfio_iommu_type1_dma_unmap);
+		dma_unmap.size = ms->len;
+		dma_unmap.iova = ms->phys_addr;
+
+		ret = ioctl(vfio_container_fd, VFIO_IOMMU_UNMAP_DMA, &dma_unmap);
+	}
+
+	if (ret) {
+		RTE_LOG(ERR, EAL, "  cannot %s DMA remapping, error %i (%s)\n",
+				do_map ? "set up" : "clear", errno,
+				strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/* keep DMA mappings in sync with segments added or removed at runtime */
+static int
+vfio_type1_mem_event(enum rte_mem_event event, const struct rte_memseg *ms,
+		void *arg __rte_unused)
+{
+	return vfio_type1_dma_mem_map(vfio_cfg.vfio_container_fd, ms,
+			event == RTE_MEM_EVENT_ALLOC);
+}
+
+int
+vfio_type1_dma_map(int vfio_container_fd)
+{
+	const struct rte_memseg *ms = rte_eal_get_physmem_layout();
+	int i;
+
+	/* map all DPDK segments for DMA. use 1:1 PA to IOVA mapping */
+	for (i = 0; i < RTE_MAX_MEMSEG; i++) {
+		if (ms[i].addr == NULL)
+			continue;
+
+		if (vfio_type1_dma_mem_map(vfio_container_fd, &ms[i], 1) < 0)
 			return -1;
-		}
 	}
 
+	/* segments mapped later are registered when added */
+	if (internal_config.dynamic_mem &&
+			rte_mem_event_callback_register(vfio_type1_mem_event,
+				NULL) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -631,6 +670,30 @@ pci_vfio_get_group_no(const char *pci_addr, int *iommu_group_no)
 	return 1;
 }
 
+/* check if the IOMMU group of a PCI device is a VFIO no-IOMMU group */
+int
+pci_vfio_is_noiommu(const struct rte_pci_device *dev)
+{
+	char filename[PATH_MAX];
+	char name[32];
+	const struct rte_pci_addr *loc = &dev->addr;
+	FILE *f;
+	int ret;
+
+	/* groups of devices behind an actual IOMMU have no name */
+	snprintf(filename, sizeof(filename),
+		SYSFS_PCI_DEVICES "/" PCI_PRI_FMT "/iommu_group/name",
+		loc->domain, loc->bus, loc->devid, loc->function);
+	f = fopen(filename, "r");
+	if (f == NULL)
+		return 0;
+
+	ret = fgets(name, sizeof(name), f) != NULL &&
+		strncmp(name, "vfio-noiommu", strlen("vfio-noiommu")) == 0;
+	fclose(f);
+	return ret;
+}
+
 static void
 clear_current_group(void)
 {
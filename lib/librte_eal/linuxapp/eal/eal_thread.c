@@ -40,6 +40,7 @@
 #include <sched.h>
 #include <sys/queue.h>
 #include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <rte_debug.h>
 #include <rte_atomic.h>
@@ -51,6 +52,7 @@
 #include <rte_eal.h>
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
+#include <rte_cycles.h>
 
 #include "eal_private.h"
 #include "eal_thread.h"
@@ -59,6 +61,55 @@ RTE_DEFINE_PER_LCORE(unsigned, _lcore_id) = LCORE_ID_ANY;
 RTE_DEFINE_PER_LCORE(unsigned, _socket_id) = (unsigned)SOCKET_ID_ANY;
 RTE_DEFINE_PER_LCORE(rte_cpuset_t, _cpuset);
 
+/*
+ * Wakeup word of each slave lcore: it is incremented to wake the lcore
+ * up, and the lcore sleeps on it with a futex after spinning a while.
+ */
+struct eal_thread_wake {
+	rte_atomic32_t seq;         /**< incremented on each wakeup */
+	volatile uint32_t sleeping; /**< lcore is (about to be) in futex */
+} __rte_cache_aligned;
+
+static struct eal_thread_wake thread_wake[RTE_MAX_LCORE];
+
+void
+eal_thread_wakeup(unsigned lcore_id)
+{
+	struct eal_thread_wake *w = &thread_wake[lcore_id];
+
+	/* full barrier: seq is written before sleeping is read */
+	rte_atomic32_inc(&w->seq);
+	if (w->sleeping)
+		syscall(SYS_futex, &w->seq.cnt, FUTEX_WAKE_PRIVATE, 1,
+			NULL, NULL, 0);
+}
+
+/*
+ * Wait until the wakeup word of an lcore differs from seq: poll it for
+ * RTE_EAL_THREAD_SPIN_US, so that a job launched right after the
+ * previous one starts without system call, then sleep in the kernel.
+ */
+static void
+eal_thread_sleep(unsigned lcore_id, uint32_t seq)
+{
+	struct eal_thread_wake *w = &thread_wake[lcore_id];
+	uint64_t end = rte_get_tsc_cycles() +
+		rte_get_tsc_hz() * RTE_EAL_THREAD_SPIN_US / 1000000;
+
+	while ((uint32_t)rte_atomic32_read(&w->seq) == seq) {
+		if (rte_get_tsc_cycles() < end) {
+			rte_pause();
+			continue;
+		}
+		w->sleeping = 1;
+		rte_mb();
+		/* returns right away if seq changed since it was read */
+		syscall(SYS_futex, &w->seq.cnt, FUTEX_WAIT_PRIVATE, seq,
+			NULL, NULL, 0);
+		w->sleeping = 0;
+	}
+}
+
 /*
  * Send a message to a slave lcore identified by slave_id to call a
  * function f with argument arg. Once the execution is done, the
@@ -67,32 +118,15 @@ RTE_DEFINE_PER_LCORE(rte_cpuset_t, _cpuset);
 int
 rte_eal_remote_launch(int (*f)(void *), void *arg, unsigned slave_id)
 {
-	int n;
-	char c = 0;
-	int m2s = lcore_config[slave_id].pipe_master2slave[1];
-	int s2m = lcore_config[slave_id].pipe_slave2master[0];
-
 	if (lcore_config[slave_id].state != WAIT)
 		return -EBUSY;
 
 	lcore_config[slave_id].f = f;
 	lcore_config[slave_id].arg = arg;
+	rte_wmb();
+	lcore_config[slave_id].state = RUNNING;
 
-	/* send message */
-	n = 0;
-	while (n == 0 || (n < 0 && errno == EINTR))
-		n = write(m2s, &c, 1);
-	if (n < 0)
-		rte_panic("cannot write on configuration pipe\n");
-
-	/* wait ack */
-	do {
-		n = read(s2m, &c, 1);
-	} while (n < 0 && errno == EINTR);
-
-	if (n <= 0)
-		rte_panic("cannot read on configuration pipe\n");
-
+	eal_thread_wakeup(slave_id);
 	return 0;
 }
 
@@ -123,26 +157,24 @@ void eal_thread_init_master(unsigned lcore_id)
 __attribute__((noreturn)) void *
 eal_thread_loop(__attribute__((unused)) void *arg)
 {
-	char c;
-	int n, ret;
+	int ret;
 	unsigned lcore_id;
+	uint32_t seq;
 	pthread_t thread_id;
-	int m2s, s2m;
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 
 	thread_id = pthread_self();
 
 	/* retrieve our lcore_id from the configuration structure */
-	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
-		if (thread_id == lcore_config[lcore_id].thread_id)
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (lcore_id != rte_get_master_lcore() &&
+				rte_eal_lcore_role(lcore_id) != ROLE_OFF &&
+				thread_id == lcore_config[lcore_id].thread_id)
 			break;
 	}
 	if (lcore_id == RTE_MAX_LCORE)
 		rte_panic("cannot retrieve lcore id\n");
 
-	m2s = lcore_config[lcore_id].pipe_master2slave[0];
-	s2m = lcore_config[lcore_id].pipe_slave2master[1];
-
 	/* set the lcore ID in per-lcore memory area */
 	RTE_PER_LCORE(_lcore_id) = lcore_id;
 
@@ -155,26 +187,21 @@ eal_thread_loop(__attribute__((unused)) void *arg)
 	RTE_LOG(DEBUG, EAL, "lcore %u is ready (tid=%x;cpuset=[%s%s])\n",
 		lcore_id, (int)thread_id, cpuset, ret == 0 ? "" : "...");
 
-	/* read on our pipe to get commands */
+	/* wait for commands and work items in shared memory */
 	while (1) {
 		void *fct_arg;
 
-		/* wait command */
-		do {
-			n = read(m2s, &c, 1);
-		} while (n < 0 && errno == EINTR);
-
-		if (n <= 0)
-			rte_panic("cannot read on configuration pipe\n");
+		/* read before checking, not to miss a wakeup */
+		seq = rte_atomic32_read(&thread_wake[lcore_id].seq);
+		rte_rmb();
 
-		lcore_config[lcore_id].state = RUNNING;
+		rte_eal_mailbox_poll();
 
-		/* send ack */
-		n = 0;
-		while (n == 0 || (n < 0 && errno == EINTR))
-			n = write(s2m, &c, 1);
-		if (n < 0)
-			rte_panic("cannot write on configuration pipe\n");
+		if (lcore_config[lcore_id].state != RUNNING) {
+			eal_thread_sleep(lcore_id, seq);
+			continue;
+		}
+		rte_rmb();
 
 		if (lcore_config[lcore_id].f == NULL)
 			rte_panic("NULL function pointer\n");
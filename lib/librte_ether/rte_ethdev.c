@@ -1311,10 +1311,7 @@ void
 rte_eth_tx_buffer_drop_callback(struct rte_mbuf **pkts, uint16_t unsent,
 		void *userdata __rte_unused)
 {
-	unsigned i;
-
-	for (i = 0; i < unsent; i++)
-		rte_pktmbuf_free(pkts[i]);
+	rte_pktmbuf_free_bulk(pkts, unsent);
 }
 
 void
@@ -1322,10 +1319,8 @@ rte_eth_tx_buffer_count_callback(struct rte_mbuf **pkts, uint16_t unsent,
 		void *userdata)
 {
 	uint64_t *count = userdata;
-	unsigned i;
 
-	for (i = 0; i < unsent; i++)
-		rte_pktmbuf_free(pkts[i]);
+	rte_pktmbuf_free_bulk(pkts, unsent);
 
 	*count += unsent;
 }
@@ -1587,6 +1582,169 @@ rte_eth_xstats_get(uint8_t port_id, struct rte_eth_xstats *xstats,
 	return count + xcount;
 }
 
+int
+rte_eth_xstats_get_id_by_name(uint8_t port_id, const char *name,
+	uint64_t *id)
+{
+	struct rte_eth_xstats *xstats;
+	int count, i, ret = -EINVAL;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	if (name == NULL || id == NULL)
+		return -EINVAL;
+
+	count = rte_eth_xstats_get(port_id, NULL, 0);
+	if (count < 0)
+		return count;
+
+	xstats = malloc(sizeof(xstats[0]) * count);
+	if (xstats == NULL)
+		return -ENOMEM;
+
+	count = rte_eth_xstats_get(port_id, xstats, count);
+	for (i = 0; i < count; i++) {
+		if (strcmp(xstats[i].name, name) == 0) {
+			*id = i;
+			ret = 0;
+			break;
+		}
+	}
+
+	free(xstats);
+	return ret;
+}
+
+/* offset in struct rte_eth_stats of a generic extended statistic */
+static size_t
+get_xstats_generic_offset(struct rte_eth_dev *dev, uint64_t id)
+{
+	unsigned q;
+
+	if (id < RTE_NB_STATS)
+		return rte_stats_strings[id].offset;
+	id -= RTE_NB_STATS;
+
+	if (id < dev->data->nb_rx_queues * RTE_NB_RXQ_STATS) {
+		q = id / RTE_NB_RXQ_STATS;
+		return rte_rxq_stats_strings[id % RTE_NB_RXQ_STATS].offset +
+			q * sizeof(uint64_t);
+	}
+	id -= dev->data->nb_rx_queues * RTE_NB_RXQ_STATS;
+
+	q = id / RTE_NB_TXQ_STATS;
+	return rte_txq_stats_strings[id % RTE_NB_TXQ_STATS].offset +
+		q * sizeof(uint64_t);
+}
+
+/* get the driver statistics with the full xstats_get operation */
+static int
+get_xstats_by_id_fallback(struct rte_eth_dev *dev, const uint64_t *ids,
+	uint64_t *values, unsigned n, unsigned count)
+{
+	struct rte_eth_xstats *xstats;
+	int xcount, ret = 0;
+	unsigned i;
+
+	if (dev->dev_ops->xstats_get == NULL)
+		return -EINVAL;
+
+	xcount = (*dev->dev_ops->xstats_get)(dev, NULL, 0);
+	if (xcount <= 0)
+		return xcount < 0 ? xcount : -EINVAL;
+
+	xstats = malloc(sizeof(xstats[0]) * xcount);
+	if (xstats == NULL)
+		return -ENOMEM;
+
+	xcount = (*dev->dev_ops->xstats_get)(dev, xstats, xcount);
+	if (xcount < 0) {
+		free(xstats);
+		return xcount;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (ids[i] < count)
+			continue;
+		if (ids[i] - count >= (uint64_t)xcount) {
+			ret = -EINVAL;
+			break;
+		}
+		values[i] = xstats[ids[i] - count].value;
+	}
+
+	free(xstats);
+	return ret;
+}
+
+#define RTE_ETH_XSTATS_BY_ID_BURST 64
+
+int
+rte_eth_xstats_get_by_id(uint8_t port_id, const uint64_t *ids,
+	uint64_t *values, unsigned n)
+{
+	uint64_t drv_ids[RTE_ETH_XSTATS_BY_ID_BURST];
+	uint64_t drv_values[RTE_ETH_XSTATS_BY_ID_BURST];
+	unsigned drv_idx[RTE_ETH_XSTATS_BY_ID_BURST];
+	struct rte_eth_stats eth_stats;
+	struct rte_eth_dev *dev;
+	unsigned count, nb_drv = 0, i, j;
+	int stats_read = 0, ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	if (n > 0 && (ids == NULL || values == NULL))
+		return -EINVAL;
+
+	dev = &rte_eth_devices[port_id];
+	count = RTE_NB_STATS + (dev->data->nb_rx_queues * RTE_NB_RXQ_STATS) +
+		(dev->data->nb_tx_queues * RTE_NB_TXQ_STATS);
+
+	/* generic statistics, read once */
+	for (i = 0; i < n; i++) {
+		if (ids[i] >= count) {
+			nb_drv++;
+			continue;
+		}
+		if (!stats_read) {
+			rte_eth_stats_get(port_id, &eth_stats);
+			stats_read = 1;
+		}
+		values[i] = *(uint64_t *)RTE_PTR_ADD(&eth_stats,
+			get_xstats_generic_offset(dev, ids[i]));
+	}
+
+	if (nb_drv == 0)
+		return n;
+
+	if (dev->dev_ops->xstats_get_by_id == NULL) {
+		ret = get_xstats_by_id_fallback(dev, ids, values, n, count);
+		return ret < 0 ? ret : (int)n;
+	}
+
+	/* driver statistics, by bursts of identifiers relative to the driver */
+	nb_drv = 0;
+	for (i = 0; i < n; i++) {
+		if (ids[i] >= count) {
+			drv_idx[nb_drv] = i;
+			drv_ids[nb_drv++] = ids[i] - count;
+		}
+		if (nb_drv == 0 ||
+				(nb_drv < RTE_ETH_XSTATS_BY_ID_BURST && i + 1 < n))
+			continue;
+
+		ret = (*dev->dev_ops->xstats_get_by_id)(dev, drv_ids,
+				drv_values, nb_drv);
+		if (ret < 0)
+			return ret;
+		for (j = 0; j < nb_drv; j++)
+			values[drv_idx[j]] = drv_values[j];
+		nb_drv = 0;
+	}
+
+	return n;
+}
+
 /* reset ethdev extended statistics */
 void
 rte_eth_xstats_reset(uint8_t port_id)
@@ -2647,6 +2805,12 @@ rte_eth_dev_rx_intr_ctl(uint8_t port_id, int epfd, int op, void *data)
 	}
 
 	dev = &rte_eth_devices[port_id];
+	/* virtual devices have no interrupt handle */
+	if (dev->pci_dev == NULL) {
+		RTE_PMD_DEBUG_TRACE("RX Intr handle unset\n");
+		return -ENOTSUP;
+	}
+
 	intr_handle = &dev->pci_dev->intr_handle;
 	if (!intr_handle->intr_vec) {
 		RTE_PMD_DEBUG_TRACE("RX Intr vector unset\n");
@@ -2710,6 +2874,12 @@ rte_eth_dev_rx_intr_ctl_q(uint8_t port_id, uint16_t queue_id,
 		return -EINVAL;
 	}
 
+	/* virtual devices have no interrupt handle */
+	if (dev->pci_dev == NULL) {
+		RTE_PMD_DEBUG_TRACE("RX Intr handle unset\n");
+		return -ENOTSUP;
+	}
+
 	intr_handle = &dev->pci_dev->intr_handle;
 	if (!intr_handle->intr_vec) {
 		RTE_PMD_DEBUG_TRACE("RX Intr vector unset\n");
@@ -2952,6 +3122,29 @@ rte_eth_add_rx_callback(uint8_t port_id, uint16_t queue_id,
 	return cb;
 }
 
+static uint16_t
+rx_compact_callback(uint8_t port_id __rte_unused,
+		uint16_t queue_id __rte_unused, struct rte_mbuf *pkts[],
+		uint16_t nb_pkts, uint16_t max_pkts __rte_unused,
+		void *user_param)
+{
+	rte_pktmbuf_compact_burst(pkts, nb_pkts, user_param);
+	return nb_pkts;
+}
+
+void *
+rte_eth_add_rx_compact_callback(uint8_t port_id, uint16_t queue_id,
+		struct rte_mempool *mp)
+{
+	if (mp == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	return rte_eth_add_rx_callback(port_id, queue_id,
+			rx_compact_callback, mp);
+}
+
 void *
 rte_eth_add_tx_callback(uint8_t port_id, uint16_t queue_id,
 		rte_tx_callback_fn fn, void *user_param)
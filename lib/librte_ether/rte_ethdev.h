@@ -1051,6 +1051,11 @@ typedef int (*eth_xstats_get_t)(struct rte_eth_dev *dev,
 	struct rte_eth_xstats *stats, unsigned n);
 /**< @internal Get extended stats of an Ethernet device. */
 
+typedef int (*eth_xstats_get_by_id_t)(struct rte_eth_dev *dev,
+	const uint64_t *ids, uint64_t *values, unsigned n);
+/**< @internal Get the values of the given extended stats of an Ethernet
+ * device, identified by their index in the table filled by xstats_get. */
+
 typedef void (*eth_xstats_reset_t)(struct rte_eth_dev *dev);
 /**< @internal Reset extended stats of an Ethernet device. */
 
@@ -1401,6 +1406,8 @@ struct eth_dev_ops {
 	eth_stats_reset_t          stats_reset;   /**< Reset generic device statistics. */
 	eth_xstats_get_t           xstats_get;    /**< Get extended device statistics. */
 	eth_xstats_reset_t         xstats_reset;  /**< Reset extended device statistics. */
+	eth_xstats_get_by_id_t     xstats_get_by_id;
+	/**< Get extended device statistics by identifier. */
 	eth_queue_stats_mapping_set_t queue_stats_mapping_set;
 	/**< Configure per queue stat counter mapping. */
 	eth_dev_infos_get_t        dev_infos_get; /**< Get device info. */
@@ -2276,6 +2283,55 @@ void rte_eth_stats_reset(uint8_t port_id);
 int rte_eth_xstats_get(uint8_t port_id, struct rte_eth_xstats *xstats,
 		unsigned n);
 
+/**
+ * Retrieve the identifier of an extended statistic of an Ethernet device.
+ *
+ * The identifier is the index of the statistic in the table filled by
+ * rte_eth_xstats_get(). It is meant to be resolved once and given to
+ * rte_eth_xstats_get_by_id(), and stays valid until the number of queues
+ * of the port is changed.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param name
+ *   The name of the extended statistic.
+ * @param id
+ *   A pointer to the identifier to be filled.
+ * @return
+ *   - 0 on success.
+ *   - -ENODEV if *port_id* is invalid.
+ *   - -EINVAL if there is no statistic named *name*.
+ *   - -ENOMEM if the statistics table cannot be allocated.
+ */
+int rte_eth_xstats_get_id_by_name(uint8_t port_id, const char *name,
+		uint64_t *id);
+
+/**
+ * Retrieve the values of some extended statistics of an Ethernet device.
+ *
+ * Unlike rte_eth_xstats_get(), only the requested values are copied,
+ * without names. The generic statistics are read once from
+ * rte_eth_stats_get(), and the statistics of the driver from its
+ * xstats_get_by_id operation when it has one.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param ids
+ *   A table of statistic identifiers, as given by
+ *   rte_eth_xstats_get_id_by_name().
+ * @param values
+ *   A table of n values to be filled, in the order of *ids*.
+ * @param n
+ *   The number of identifiers.
+ * @return
+ *   - n on success.
+ *   - -ENODEV if *port_id* is invalid.
+ *   - -EINVAL if an identifier is invalid.
+ *   - -ENOMEM if the fallback statistics table cannot be allocated.
+ */
+int rte_eth_xstats_get_by_id(uint8_t port_id, const uint64_t *ids,
+		uint64_t *values, unsigned n);
+
 /**
  * Reset extended statistics of an Ethernet device.
  *
@@ -3825,6 +3881,29 @@ int rte_eth_dev_get_dcb_info(uint8_t port_id,
 void *rte_eth_add_rx_callback(uint8_t port_id, uint16_t queue_id,
 		rte_rx_callback_fn fn, void *user_param);
 
+/**
+ * Add a callback copying short received packets into a pool of small mbufs.
+ *
+ * Each burst received on the given port and queue is passed to
+ * rte_pktmbuf_compact_burst(), so that the packets fitting in the mbufs
+ * of mp are returned to the application in compact buffers while the
+ * large RX buffers are recycled immediately. The callback can be removed
+ * with rte_eth_remove_rx_callback().
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The queue on the Ethernet device on which the callback is to be added.
+ * @param mp
+ *   The mempool of small mbufs.
+ *
+ * @return
+ *   NULL on error.
+ *   On success, a pointer value which can later be used to remove the callback.
+ */
+void *rte_eth_add_rx_compact_callback(uint8_t port_id, uint16_t queue_id,
+		struct rte_mempool *mp);
+
 /**
  * Add a callback to be called on packet TX on a given port and queue.
  *
@@ -0,0 +1,277 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GRO_TCP4_H_
+#define _GRO_TCP4_H_
+
+#include <string.h>
+
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+
+/* maximum L3 length of a merged packet */
+#define GRO_TCP4_MAX_L3_LENGTH UINT16_MAX
+
+/* only segments with the ACK flag alone are merged */
+#define GRO_TCP4_ACK_FLAG 0x10
+
+/* length of the TCP header, options included */
+#define GRO_TCP4_HDR_LEN(tcph) \
+	((uint16_t)(((tcph)->data_off & 0xf0) >> 2))
+
+/* the packets of a flow share this key */
+struct tcp4_flow_key {
+	struct ether_addr eth_saddr;
+	struct ether_addr eth_daddr;
+	uint32_t ip_src_addr;
+	uint32_t ip_dst_addr;
+	uint32_t recv_ack;
+	uint16_t src_port;
+	uint16_t dst_port;
+};
+
+struct gro_tcp4_flow {
+	struct tcp4_flow_key key;
+	/* index of the first item of the flow, INVALID_ARRAY_INDEX if unused */
+	uint32_t start_index;
+};
+
+struct gro_tcp4_item {
+	/* first and last segments of the merged packet */
+	struct rte_mbuf *firstseg;
+	struct rte_mbuf *lastseg;
+	/* TSC at which the first packet of the item was stored */
+	uint64_t start_time;
+	/* index of the next item of the same flow */
+	uint32_t next_pkt_idx;
+	/* TCP sequence number of the first byte of the payload */
+	uint32_t sent_seq;
+	/* IPv4 ID of the first merged packet */
+	uint16_t ip_id;
+	/* number of packets merged in the item */
+	uint16_t nb_merged;
+	/* position of the item in the burst, for rte_gro_reassemble_burst() */
+	uint16_t pkt_idx;
+	/* IPv4 DF flag of the merged packets */
+	uint8_t is_atomic;
+};
+
+/* TCP/IPv4 reassembly table */
+struct gro_tcp4_tbl {
+	struct gro_tcp4_item *items;
+	struct gro_tcp4_flow *flows;
+	uint32_t item_num;
+	uint32_t max_item_num;
+	uint32_t flow_num;
+	uint32_t max_flow_num;
+};
+
+/* Create a TCP/IPv4 reassembly table. */
+void *gro_tcp4_tbl_create(int socket_id, uint16_t max_flow_num,
+		uint16_t max_item_per_flow);
+
+/* Destroy a TCP/IPv4 reassembly table. */
+void gro_tcp4_tbl_destroy(void *tbl);
+
+/* Initialize a table on caller provided arrays, used for bursts. */
+void gro_tcp4_tbl_init(struct gro_tcp4_tbl *tbl,
+		struct gro_tcp4_item *items, uint32_t max_item_num,
+		struct gro_tcp4_flow *flows, uint32_t max_flow_num);
+
+/*
+ * Merge a TCP/IPv4 packet, whose l2_len, l3_len and l4_len are set, with
+ * a neighbour stored in the table, or store it in a new item.
+ *
+ * Returns 1 if the packet was merged, 0 if it was stored in a new item,
+ * and a negative value if it cannot be processed or the table is full.
+ */
+int32_t gro_tcp4_reassemble(struct rte_mbuf *pkt, struct gro_tcp4_tbl *tbl,
+		uint64_t start_time, uint16_t pkt_idx);
+
+/*
+ * Flush the items stored before flush_timestamp, updating the headers of
+ * the merged packets. Returns the number of packets written to out.
+ */
+uint16_t gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
+		uint64_t flush_timestamp, struct rte_mbuf **out,
+		uint16_t nb_out);
+
+/*
+ * Store each item of the table, with updated headers, at its position in
+ * the burst it was built from.
+ */
+void gro_tcp4_tbl_burst_flush(struct gro_tcp4_tbl *tbl,
+		struct rte_mbuf **pkts);
+
+/* Number of packets stored in the table. */
+static inline uint32_t
+gro_tcp4_tbl_pkt_count(const struct gro_tcp4_tbl *tbl)
+{
+	return tbl->item_num;
+}
+
+static inline int
+is_same_tcp4_flow(const struct tcp4_flow_key *k1,
+		const struct tcp4_flow_key *k2)
+{
+	return is_same_ether_addr(&k1->eth_saddr, &k2->eth_saddr) &&
+		is_same_ether_addr(&k1->eth_daddr, &k2->eth_daddr) &&
+		k1->ip_src_addr == k2->ip_src_addr &&
+		k1->ip_dst_addr == k2->ip_dst_addr &&
+		k1->recv_ack == k2->recv_ack &&
+		k1->src_port == k2->src_port &&
+		k1->dst_port == k2->dst_port;
+}
+
+/*
+ * Check if a packet is the neighbour of an item. The TCP/IPv4 headers
+ * start at l2_offset + l2_len, l2_offset being the length of the outer
+ * headers of a tunnel.
+ *
+ * Returns 1 if the packet follows the item, -1 if it precedes it, and 0
+ * if they are not neighbours.
+ */
+static inline int
+check_tcp4_seq_option(const struct gro_tcp4_item *item,
+		const struct rte_mbuf *pkt, const struct tcp_hdr *tcph,
+		uint32_t sent_seq, uint16_t ip_id, uint16_t tcp_dl,
+		uint16_t l2_offset, uint8_t is_atomic)
+{
+	const struct rte_mbuf *pkt_orig = item->firstseg;
+	const struct tcp_hdr *tcph_orig;
+	uint16_t tcp_hl = pkt->l4_len;
+	uint32_t len;
+
+	/* the headers must have the same layout */
+	if (pkt->outer_l2_len != pkt_orig->outer_l2_len ||
+			pkt->outer_l3_len != pkt_orig->outer_l3_len ||
+			pkt->l2_len != pkt_orig->l2_len ||
+			pkt->l3_len != pkt_orig->l3_len ||
+			tcp_hl != pkt_orig->l4_len)
+		return 0;
+
+	tcph_orig = rte_pktmbuf_mtod_offset(pkt_orig, const struct tcp_hdr *,
+			l2_offset + pkt_orig->l2_len + pkt_orig->l3_len);
+
+	/* the TCP options must be the same */
+	if (tcp_hl > sizeof(struct tcp_hdr) &&
+			memcmp(tcph + 1, tcph_orig + 1,
+				tcp_hl - sizeof(struct tcp_hdr)) != 0)
+		return 0;
+
+	/* the DF flags must be the same */
+	if (is_atomic != item->is_atomic)
+		return 0;
+
+	/* append: the IPv4 ID increases unless DF is set */
+	len = pkt_orig->pkt_len - l2_offset - pkt_orig->l2_len -
+		pkt_orig->l3_len - tcp_hl;
+	if (sent_seq == item->sent_seq + len && (is_atomic ||
+			ip_id == (uint16_t)(item->ip_id + item->nb_merged)))
+		return 1;
+
+	/* prepend */
+	if (sent_seq + tcp_dl == item->sent_seq && (is_atomic ||
+			(uint16_t)(ip_id + 1) == item->ip_id))
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Merge a packet with an item, after (cmp > 0) or before (cmp < 0) it.
+ * The headers of the packet following the other one are removed.
+ * max_l3_len bounds the length of the merged packet from its (inner)
+ * IPv4 header, so that the lengths of the outer headers fit in 16 bits.
+ *
+ * Returns 1 on success, 0 if the merged packet would be too large.
+ */
+static inline int
+merge_two_tcp4_packets(struct gro_tcp4_item *item, struct rte_mbuf *pkt,
+		int cmp, uint32_t sent_seq, uint16_t ip_id, uint16_t l2_offset,
+		uint16_t max_l3_len)
+{
+	struct rte_mbuf *pkt_head, *pkt_tail, *lastseg;
+	uint16_t hdr_len;
+
+	if (cmp > 0) {
+		pkt_head = item->firstseg;
+		pkt_tail = pkt;
+	} else {
+		pkt_head = pkt;
+		pkt_tail = item->firstseg;
+	}
+
+	hdr_len = l2_offset + pkt_tail->l2_len + pkt_tail->l3_len +
+		pkt_tail->l4_len;
+	if (pkt_head->pkt_len - l2_offset - pkt_head->l2_len +
+			pkt_tail->pkt_len - hdr_len > max_l3_len)
+		return 0;
+	if (pkt_head->nb_segs + pkt_tail->nb_segs > UINT8_MAX)
+		return 0;
+
+	/* remove the headers of the tail packet */
+	if (rte_pktmbuf_adj(pkt_tail, hdr_len) == NULL)
+		return 0;
+
+	if (cmp > 0) {
+		item->lastseg->next = pkt;
+		item->lastseg = rte_pktmbuf_lastseg(pkt);
+	} else {
+		lastseg = rte_pktmbuf_lastseg(pkt);
+		lastseg->next = item->firstseg;
+		item->firstseg = pkt;
+		item->sent_seq = sent_seq;
+		item->ip_id = ip_id;
+	}
+	item->nb_merged++;
+
+	pkt_head->nb_segs += pkt_tail->nb_segs;
+	pkt_head->pkt_len += pkt_tail->pkt_len;
+
+	return 1;
+}
+
+/* update the length and checksum of an IPv4 header after a merge */
+static inline void
+update_ipv4_header(struct ipv4_hdr *ipv4_hdr, uint16_t len)
+{
+	ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+	ipv4_hdr->hdr_checksum = 0;
+	ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+}
+
+#endif /* _GRO_TCP4_H_ */
@@ -0,0 +1,437 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_udp.h>
+
+#include "gro_vxlan_tcp4.h"
+
+void *
+gro_vxlan_tcp4_tbl_create(int socket_id, uint16_t max_flow_num,
+		uint16_t max_item_per_flow)
+{
+	struct gro_vxlan_tcp4_tbl *tbl;
+	uint32_t entries_num, i;
+
+	entries_num = (uint32_t)max_flow_num * max_item_per_flow;
+	if (entries_num == 0)
+		return NULL;
+
+	tbl = rte_zmalloc_socket(__func__, sizeof(*tbl), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl == NULL)
+		return NULL;
+
+	tbl->items = rte_zmalloc_socket(__func__,
+			sizeof(struct gro_vxlan_tcp4_item) * entries_num,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	tbl->flows = rte_zmalloc_socket(__func__,
+			sizeof(struct gro_vxlan_tcp4_flow) * max_flow_num,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (tbl->items == NULL || tbl->flows == NULL) {
+		gro_vxlan_tcp4_tbl_destroy(tbl);
+		return NULL;
+	}
+
+	tbl->max_item_num = entries_num;
+	tbl->max_flow_num = max_flow_num;
+	for (i = 0; i < max_flow_num; i++)
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+
+	return tbl;
+}
+
+void
+gro_vxlan_tcp4_tbl_destroy(void *tbl)
+{
+	struct gro_vxlan_tcp4_tbl *vxlan_tbl = tbl;
+
+	if (vxlan_tbl == NULL)
+		return;
+
+	rte_free(vxlan_tbl->items);
+	rte_free(vxlan_tbl->flows);
+	rte_free(vxlan_tbl);
+}
+
+void
+gro_vxlan_tcp4_tbl_init(struct gro_vxlan_tcp4_tbl *tbl,
+		struct gro_vxlan_tcp4_item *items, uint32_t max_item_num,
+		struct gro_vxlan_tcp4_flow *flows, uint32_t max_flow_num)
+{
+	uint32_t i;
+
+	tbl->items = items;
+	tbl->flows = flows;
+	tbl->item_num = 0;
+	tbl->flow_num = 0;
+	tbl->max_item_num = max_item_num;
+	tbl->max_flow_num = max_flow_num;
+
+	for (i = 0; i < max_item_num; i++)
+		items[i].inner_item.firstseg = NULL;
+	for (i = 0; i < max_flow_num; i++)
+		flows[i].start_index = INVALID_ARRAY_INDEX;
+}
+
+static inline int
+is_same_vxlan_tcp4_flow(const struct vxlan_tcp4_flow_key *k1,
+		const struct vxlan_tcp4_flow_key *k2)
+{
+	return is_same_tcp4_flow(&k1->inner_key, &k2->inner_key) &&
+		k1->vxlan_hdr.vx_flags == k2->vxlan_hdr.vx_flags &&
+		k1->vxlan_hdr.vx_vni == k2->vxlan_hdr.vx_vni &&
+		is_same_ether_addr(&k1->outer_eth_saddr,
+			&k2->outer_eth_saddr) &&
+		is_same_ether_addr(&k1->outer_eth_daddr,
+			&k2->outer_eth_daddr) &&
+		k1->outer_ip_src_addr == k2->outer_ip_src_addr &&
+		k1->outer_ip_dst_addr == k2->outer_ip_dst_addr &&
+		k1->outer_src_port == k2->outer_src_port &&
+		k1->outer_dst_port == k2->outer_dst_port;
+}
+
+static inline uint32_t
+find_free_item(const struct gro_vxlan_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	for (i = 0; i < tbl->max_item_num; i++) {
+		if (tbl->items[i].inner_item.firstseg == NULL)
+			return i;
+	}
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+find_free_flow(const struct gro_vxlan_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	for (i = 0; i < tbl->max_flow_num; i++) {
+		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
+			return i;
+	}
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+insert_new_item(struct gro_vxlan_tcp4_tbl *tbl, struct rte_mbuf *pkt,
+		uint64_t start_time, uint32_t prev_idx, uint32_t sent_seq,
+		uint16_t outer_ip_id, uint16_t ip_id, uint8_t outer_is_atomic,
+		uint8_t is_atomic, uint16_t pkt_idx)
+{
+	struct gro_vxlan_tcp4_item *item;
+	uint32_t item_idx;
+
+	item_idx = find_free_item(tbl);
+	if (item_idx == INVALID_ARRAY_INDEX)
+		return INVALID_ARRAY_INDEX;
+
+	item = &tbl->items[item_idx];
+	item->inner_item.firstseg = pkt;
+	item->inner_item.lastseg = rte_pktmbuf_lastseg(pkt);
+	item->inner_item.start_time = start_time;
+	item->inner_item.next_pkt_idx = INVALID_ARRAY_INDEX;
+	item->inner_item.sent_seq = sent_seq;
+	item->inner_item.ip_id = ip_id;
+	item->inner_item.nb_merged = 1;
+	item->inner_item.pkt_idx = pkt_idx;
+	item->inner_item.is_atomic = is_atomic;
+	item->outer_ip_id = outer_ip_id;
+	item->outer_is_atomic = outer_is_atomic;
+	tbl->item_num++;
+
+	/* chain the new item after the previous one of the flow */
+	if (prev_idx != INVALID_ARRAY_INDEX) {
+		item->inner_item.next_pkt_idx =
+			tbl->items[prev_idx].inner_item.next_pkt_idx;
+		tbl->items[prev_idx].inner_item.next_pkt_idx = item_idx;
+	}
+
+	return item_idx;
+}
+
+static inline uint32_t
+delete_item(struct gro_vxlan_tcp4_tbl *tbl, uint32_t item_idx,
+		uint32_t prev_idx)
+{
+	uint32_t next_idx = tbl->items[item_idx].inner_item.next_pkt_idx;
+
+	tbl->items[item_idx].inner_item.firstseg = NULL;
+	tbl->item_num--;
+	if (prev_idx != INVALID_ARRAY_INDEX)
+		tbl->items[prev_idx].inner_item.next_pkt_idx = next_idx;
+
+	return next_idx;
+}
+
+static inline uint32_t
+insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
+		const struct vxlan_tcp4_flow_key *key, uint32_t item_idx)
+{
+	uint32_t flow_idx;
+
+	flow_idx = find_free_flow(tbl);
+	if (flow_idx == INVALID_ARRAY_INDEX)
+		return INVALID_ARRAY_INDEX;
+
+	tbl->flows[flow_idx].key = *key;
+	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flow_num++;
+
+	return flow_idx;
+}
+
+/* check the inner TCP/IPv4 headers, then the outer IPv4 ID */
+static inline int
+check_vxlan_seq_option(const struct gro_vxlan_tcp4_item *item,
+		const struct rte_mbuf *pkt, const struct tcp_hdr *tcp_hdr,
+		uint32_t sent_seq, uint16_t outer_ip_id, uint16_t ip_id,
+		uint16_t tcp_dl, uint16_t l2_offset, uint8_t outer_is_atomic,
+		uint8_t is_atomic)
+{
+	int cmp;
+
+	cmp = check_tcp4_seq_option(&item->inner_item, pkt, tcp_hdr,
+			sent_seq, ip_id, tcp_dl, l2_offset, is_atomic);
+	if (cmp == 0 || outer_is_atomic != item->outer_is_atomic)
+		return 0;
+	if (outer_is_atomic)
+		return cmp;
+
+	if (cmp > 0 && outer_ip_id == (uint16_t)(item->outer_ip_id +
+			item->inner_item.nb_merged))
+		return 1;
+	if (cmp < 0 && (uint16_t)(outer_ip_id + 1) == item->outer_ip_id)
+		return -1;
+
+	return 0;
+}
+
+/* update the outer IPv4 and UDP headers and the inner IPv4 header */
+static inline void
+update_header(struct gro_vxlan_tcp4_item *item)
+{
+	struct rte_mbuf *pkt = item->inner_item.firstseg;
+	struct ipv4_hdr *ipv4_hdr;
+	struct udp_hdr *udp_hdr;
+	uint16_t len;
+
+	if (item->inner_item.nb_merged == 1)
+		return;
+
+	len = pkt->pkt_len - pkt->outer_l2_len;
+	ipv4_hdr = rte_pktmbuf_mtod_offset(pkt, struct ipv4_hdr *,
+			pkt->outer_l2_len);
+	update_ipv4_header(ipv4_hdr, len);
+
+	len -= pkt->outer_l3_len;
+	udp_hdr = (struct udp_hdr *)((char *)ipv4_hdr + pkt->outer_l3_len);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+	udp_hdr->dgram_cksum = 0;
+
+	len -= pkt->l2_len;
+	ipv4_hdr = (struct ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
+	update_ipv4_header(ipv4_hdr, len);
+}
+
+int32_t
+gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_tcp4_tbl *tbl, uint64_t start_time,
+		uint16_t pkt_idx)
+{
+	struct ether_hdr *outer_eth_hdr, *eth_hdr;
+	struct ipv4_hdr *outer_ipv4_hdr, *ipv4_hdr;
+	struct udp_hdr *udp_hdr;
+	struct vxlan_hdr *vxlan_hdr;
+	struct tcp_hdr *tcp_hdr;
+	struct vxlan_tcp4_flow_key key;
+	struct gro_vxlan_tcp4_item *item;
+	uint32_t sent_seq, cur_idx, prev_idx, item_idx, i, remaining;
+	uint16_t tcp_dl, ip_id, outer_ip_id, hdr_len, l2_offset, max_l3_len;
+	uint8_t is_atomic, outer_is_atomic;
+	int cmp;
+
+	l2_offset = pkt->outer_l2_len + pkt->outer_l3_len;
+	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct ether_hdr *);
+	outer_ipv4_hdr = (struct ipv4_hdr *)((char *)outer_eth_hdr +
+			pkt->outer_l2_len);
+	udp_hdr = (struct udp_hdr *)((char *)outer_ipv4_hdr +
+			pkt->outer_l3_len);
+	vxlan_hdr = (struct vxlan_hdr *)(udp_hdr + 1);
+	eth_hdr = (struct ether_hdr *)(vxlan_hdr + 1);
+	ipv4_hdr = (struct ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
+	tcp_hdr = (struct tcp_hdr *)((char *)ipv4_hdr + pkt->l3_len);
+	hdr_len = l2_offset + pkt->l2_len + pkt->l3_len + pkt->l4_len;
+	/* the outer IPv4 total length also covers the outer headers */
+	max_l3_len = GRO_TCP4_MAX_L3_LENGTH - pkt->outer_l3_len - pkt->l2_len;
+
+	/* packets with control flags, or without payload, are not merged */
+	if (tcp_hdr->tcp_flags != GRO_TCP4_ACK_FLAG)
+		return -1;
+	tcp_dl = pkt->pkt_len - hdr_len;
+	if (tcp_dl == 0)
+		return -1;
+
+	outer_is_atomic = (outer_ipv4_hdr->fragment_offset &
+			rte_cpu_to_be_16(IPV4_HDR_DF_FLAG)) != 0;
+	outer_ip_id = rte_be_to_cpu_16(outer_ipv4_hdr->packet_id);
+	is_atomic = (ipv4_hdr->fragment_offset &
+			rte_cpu_to_be_16(IPV4_HDR_DF_FLAG)) != 0;
+	ip_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
+
+	ether_addr_copy(&eth_hdr->s_addr, &key.inner_key.eth_saddr);
+	ether_addr_copy(&eth_hdr->d_addr, &key.inner_key.eth_daddr);
+	key.inner_key.ip_src_addr = ipv4_hdr->src_addr;
+	key.inner_key.ip_dst_addr = ipv4_hdr->dst_addr;
+	key.inner_key.src_port = tcp_hdr->src_port;
+	key.inner_key.dst_port = tcp_hdr->dst_port;
+	key.inner_key.recv_ack = tcp_hdr->recv_ack;
+	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
+	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	ether_addr_copy(&outer_eth_hdr->s_addr, &key.outer_eth_saddr);
+	ether_addr_copy(&outer_eth_hdr->d_addr, &key.outer_eth_daddr);
+	key.outer_ip_src_addr = outer_ipv4_hdr->src_addr;
+	key.outer_ip_dst_addr = outer_ipv4_hdr->dst_addr;
+	key.outer_src_port = udp_hdr->src_port;
+	key.outer_dst_port = udp_hdr->dst_port;
+
+	/* look for the flow of the packet */
+	remaining = tbl->flow_num;
+	for (i = 0; i < tbl->max_flow_num && remaining > 0; i++) {
+		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
+			continue;
+		if (is_same_vxlan_tcp4_flow(&tbl->flows[i].key, &key))
+			break;
+		remaining--;
+	}
+
+	/* new flow */
+	if (i == tbl->max_flow_num || remaining == 0) {
+		item_idx = insert_new_item(tbl, pkt, start_time,
+				INVALID_ARRAY_INDEX, sent_seq, outer_ip_id,
+				ip_id, outer_is_atomic, is_atomic, pkt_idx);
+		if (item_idx == INVALID_ARRAY_INDEX)
+			return -1;
+		if (insert_new_flow(tbl, &key, item_idx) ==
+				INVALID_ARRAY_INDEX) {
+			delete_item(tbl, item_idx, INVALID_ARRAY_INDEX);
+			return -1;
+		}
+		return 0;
+	}
+
+	/* look for a neighbour among the items of the flow */
+	cur_idx = tbl->flows[i].start_index;
+	prev_idx = cur_idx;
+	do {
+		item = &tbl->items[cur_idx];
+		cmp = check_vxlan_seq_option(item, pkt, tcp_hdr, sent_seq,
+				outer_ip_id, ip_id, tcp_dl, l2_offset,
+				outer_is_atomic, is_atomic);
+		if (cmp != 0 && merge_two_tcp4_packets(&item->inner_item,
+					pkt, cmp, sent_seq, ip_id, l2_offset,
+					max_l3_len)) {
+			if (cmp < 0)
+				item->outer_ip_id = outer_ip_id;
+			return 1;
+		}
+		prev_idx = cur_idx;
+		cur_idx = item->inner_item.next_pkt_idx;
+	} while (cur_idx != INVALID_ARRAY_INDEX);
+
+	/* no neighbour, store the packet in a new item of the flow */
+	if (insert_new_item(tbl, pkt, start_time, prev_idx, sent_seq,
+			outer_ip_id, ip_id, outer_is_atomic, is_atomic,
+			pkt_idx) == INVALID_ARRAY_INDEX)
+		return -1;
+	return 0;
+}
+
+uint16_t
+gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
+		uint64_t flush_timestamp, struct rte_mbuf **out,
+		uint16_t nb_out)
+{
+	struct gro_vxlan_tcp4_item *item;
+	uint16_t k = 0;
+	uint32_t i, j, prev;
+
+	for (i = 0; i < tbl->max_flow_num && k < nb_out; i++) {
+		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
+			continue;
+
+		prev = INVALID_ARRAY_INDEX;
+		j = tbl->flows[i].start_index;
+		while (j != INVALID_ARRAY_INDEX && k < nb_out) {
+			item = &tbl->items[j];
+			if (item->inner_item.start_time > flush_timestamp) {
+				prev = j;
+				j = item->inner_item.next_pkt_idx;
+				continue;
+			}
+
+			update_header(item);
+			out[k++] = item->inner_item.firstseg;
+			if (prev == INVALID_ARRAY_INDEX)
+				tbl->flows[i].start_index =
+					item->inner_item.next_pkt_idx;
+			j = delete_item(tbl, j, prev);
+		}
+
+		/* delete the flow once all its items are flushed */
+		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
+			tbl->flow_num--;
+	}
+
+	return k;
+}
+
+void
+gro_vxlan_tcp4_tbl_burst_flush(struct gro_vxlan_tcp4_tbl *tbl,
+		struct rte_mbuf **pkts)
+{
+	struct gro_vxlan_tcp4_item *item;
+	uint32_t i;
+
+	for (i = 0; i < tbl->max_item_num; i++) {
+		item = &tbl->items[i];
+		if (item->inner_item.firstseg == NULL)
+			continue;
+		update_header(item);
+		pkts[item->inner_item.pkt_idx] = item->inner_item.firstseg;
+	}
+}
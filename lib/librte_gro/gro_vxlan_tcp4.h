@@ -0,0 +1,122 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GRO_VXLAN_TCP4_H_
+#define _GRO_VXLAN_TCP4_H_
+
+#include "gro_tcp4.h"
+
+/* the packets of a VXLAN flow share this key */
+struct vxlan_tcp4_flow_key {
+	struct tcp4_flow_key inner_key;
+	struct vxlan_hdr vxlan_hdr;
+	struct ether_addr outer_eth_saddr;
+	struct ether_addr outer_eth_daddr;
+	uint32_t outer_ip_src_addr;
+	uint32_t outer_ip_dst_addr;
+	uint16_t outer_src_port;
+	uint16_t outer_dst_port;
+};
+
+struct gro_vxlan_tcp4_flow {
+	struct vxlan_tcp4_flow_key key;
+	/* index of the first item of the flow, INVALID_ARRAY_INDEX if unused */
+	uint32_t start_index;
+};
+
+struct gro_vxlan_tcp4_item {
+	/* inner TCP/IPv4 packet */
+	struct gro_tcp4_item inner_item;
+	/* outer IPv4 ID of the first merged packet */
+	uint16_t outer_ip_id;
+	/* outer IPv4 DF flag of the merged packets */
+	uint8_t outer_is_atomic;
+};
+
+/* VXLAN TCP/IPv4 reassembly table */
+struct gro_vxlan_tcp4_tbl {
+	struct gro_vxlan_tcp4_item *items;
+	struct gro_vxlan_tcp4_flow *flows;
+	uint32_t item_num;
+	uint32_t max_item_num;
+	uint32_t flow_num;
+	uint32_t max_flow_num;
+};
+
+/* Create a VXLAN TCP/IPv4 reassembly table. */
+void *gro_vxlan_tcp4_tbl_create(int socket_id, uint16_t max_flow_num,
+		uint16_t max_item_per_flow);
+
+/* Destroy a VXLAN TCP/IPv4 reassembly table. */
+void gro_vxlan_tcp4_tbl_destroy(void *tbl);
+
+/* Initialize a table on caller provided arrays, used for bursts. */
+void gro_vxlan_tcp4_tbl_init(struct gro_vxlan_tcp4_tbl *tbl,
+		struct gro_vxlan_tcp4_item *items, uint32_t max_item_num,
+		struct gro_vxlan_tcp4_flow *flows, uint32_t max_flow_num);
+
+/*
+ * Merge a VXLAN packet carrying TCP/IPv4, whose outer_l2_len,
+ * outer_l3_len, l2_len (outer UDP, VXLAN and inner Ethernet headers),
+ * l3_len and l4_len are set, or store it in a new item.
+ *
+ * Returns 1 if the packet was merged, 0 if it was stored in a new item,
+ * and a negative value if it cannot be processed or the table is full.
+ */
+int32_t gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_tcp4_tbl *tbl, uint64_t start_time,
+		uint16_t pkt_idx);
+
+/*
+ * Flush the items stored before flush_timestamp, updating the headers of
+ * the merged packets. Returns the number of packets written to out.
+ */
+uint16_t gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
+		uint64_t flush_timestamp, struct rte_mbuf **out,
+		uint16_t nb_out);
+
+/*
+ * Store each item of the table, with updated headers, at its position in
+ * the burst it was built from.
+ */
+void gro_vxlan_tcp4_tbl_burst_flush(struct gro_vxlan_tcp4_tbl *tbl,
+		struct rte_mbuf **pkts);
+
+/* Number of packets stored in the table. */
+static inline uint32_t
+gro_vxlan_tcp4_tbl_pkt_count(const struct gro_vxlan_tcp4_tbl *tbl)
+{
+	return tbl->item_num;
+}
+
+#endif /* _GRO_VXLAN_TCP4_H_ */
@@ -0,0 +1,376 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <netinet/in.h>
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_udp.h>
+
+#include "rte_gro.h"
+#include "gro_tcp4.h"
+#include "gro_vxlan_tcp4.h"
+
+#define GRO_SUPPORTED_TYPES (RTE_GRO_TCP_IPV4 | RTE_GRO_IPV4_VXLAN_TCP_IPV4)
+
+/* the I flag of a VXLAN header, for a valid VNI */
+#define GRO_VXLAN_FLAG_VNI 0x08000000
+
+/* GRO context, holding one reassembly table per type of packets */
+struct gro_ctx {
+	uint64_t gro_types;
+	uint16_t vxlan_port;
+	struct gro_tcp4_tbl *tcp4_tbl;
+	struct gro_vxlan_tcp4_tbl *vxlan_tcp4_tbl;
+};
+
+/*
+ * Parse the IPv4 and TCP headers following an Ethernet header at offset
+ * off. Fragments, and frames with padding after the IPv4 packet, are
+ * rejected. All the headers must be in the first segment.
+ */
+static inline int
+parse_eth_ipv4_tcp(const struct rte_mbuf *pkt, uint16_t off,
+		uint16_t *l3_len, uint16_t *l4_len)
+{
+	const struct ether_hdr *eth_hdr;
+	const struct ipv4_hdr *ipv4_hdr;
+	const struct tcp_hdr *tcp_hdr;
+	uint16_t ip_hl, tcp_hl;
+
+	if (pkt->data_len < off + ETHER_HDR_LEN + sizeof(struct ipv4_hdr) +
+			sizeof(struct tcp_hdr))
+		return -1;
+
+	eth_hdr = rte_pktmbuf_mtod_offset(pkt, const struct ether_hdr *, off);
+	if (eth_hdr->ether_type != rte_cpu_to_be_16(ETHER_TYPE_IPv4))
+		return -1;
+
+	ipv4_hdr = (const struct ipv4_hdr *)(eth_hdr + 1);
+	ip_hl = (ipv4_hdr->version_ihl & IPV4_HDR_IHL_MASK) *
+		IPV4_IHL_MULTIPLIER;
+	if ((ipv4_hdr->version_ihl >> 4) != 4 ||
+			ip_hl < sizeof(struct ipv4_hdr) ||
+			ipv4_hdr->next_proto_id != IPPROTO_TCP)
+		return -1;
+	if (ipv4_hdr->fragment_offset & rte_cpu_to_be_16(IPV4_HDR_MF_FLAG |
+			IPV4_HDR_OFFSET_MASK))
+		return -1;
+	if ((uint32_t)off + ETHER_HDR_LEN +
+			rte_be_to_cpu_16(ipv4_hdr->total_length) != pkt->pkt_len)
+		return -1;
+	if (pkt->data_len < off + ETHER_HDR_LEN + ip_hl +
+			sizeof(struct tcp_hdr))
+		return -1;
+
+	tcp_hdr = (const struct tcp_hdr *)((const char *)ipv4_hdr + ip_hl);
+	tcp_hl = GRO_TCP4_HDR_LEN(tcp_hdr);
+	if (tcp_hl < sizeof(struct tcp_hdr) ||
+			pkt->data_len < off + ETHER_HDR_LEN + ip_hl + tcp_hl)
+		return -1;
+
+	*l3_len = ip_hl;
+	*l4_len = tcp_hl;
+	return 0;
+}
+
+/* parse a TCP/IPv4 packet and set its header lengths */
+static inline int
+gro_parse_tcp4(struct rte_mbuf *pkt)
+{
+	uint16_t l3_len, l4_len;
+
+	if (parse_eth_ipv4_tcp(pkt, 0, &l3_len, &l4_len) < 0)
+		return -1;
+
+	pkt->outer_l2_len = 0;
+	pkt->outer_l3_len = 0;
+	pkt->l2_len = ETHER_HDR_LEN;
+	pkt->l3_len = l3_len;
+	pkt->l4_len = l4_len;
+	return 0;
+}
+
+/* parse a VXLAN packet carrying TCP/IPv4 and set its header lengths */
+static inline int
+gro_parse_vxlan_tcp4(struct rte_mbuf *pkt, uint16_t vxlan_port)
+{
+	const struct ether_hdr *eth_hdr;
+	const struct ipv4_hdr *ipv4_hdr;
+	const struct udp_hdr *udp_hdr;
+	const struct vxlan_hdr *vxlan_hdr;
+	uint16_t outer_ip_hl, l3_len, l4_len;
+
+	if (pkt->data_len < ETHER_HDR_LEN + sizeof(struct ipv4_hdr) +
+			ETHER_VXLAN_HLEN)
+		return -1;
+
+	eth_hdr = rte_pktmbuf_mtod(pkt, const struct ether_hdr *);
+	if (eth_hdr->ether_type != rte_cpu_to_be_16(ETHER_TYPE_IPv4))
+		return -1;
+
+	ipv4_hdr = (const struct ipv4_hdr *)(eth_hdr + 1);
+	outer_ip_hl = (ipv4_hdr->version_ihl & IPV4_HDR_IHL_MASK) *
+		IPV4_IHL_MULTIPLIER;
+	if ((ipv4_hdr->version_ihl >> 4) != 4 ||
+			outer_ip_hl < sizeof(struct ipv4_hdr) ||
+			ipv4_hdr->next_proto_id != IPPROTO_UDP)
+		return -1;
+	if (ipv4_hdr->fragment_offset & rte_cpu_to_be_16(IPV4_HDR_MF_FLAG |
+			IPV4_HDR_OFFSET_MASK))
+		return -1;
+	if ((uint32_t)ETHER_HDR_LEN +
+			rte_be_to_cpu_16(ipv4_hdr->total_length) != pkt->pkt_len)
+		return -1;
+	if (pkt->data_len < ETHER_HDR_LEN + outer_ip_hl + ETHER_VXLAN_HLEN)
+		return -1;
+
+	udp_hdr = (const struct udp_hdr *)((const char *)ipv4_hdr +
+			outer_ip_hl);
+	if (udp_hdr->dst_port != rte_cpu_to_be_16(vxlan_port))
+		return -1;
+	vxlan_hdr = (const struct vxlan_hdr *)(udp_hdr + 1);
+	if (!(vxlan_hdr->vx_flags & rte_cpu_to_be_32(GRO_VXLAN_FLAG_VNI)))
+		return -1;
+
+	if (parse_eth_ipv4_tcp(pkt, ETHER_HDR_LEN + outer_ip_hl +
+			ETHER_VXLAN_HLEN, &l3_len, &l4_len) < 0)
+		return -1;
+
+	pkt->outer_l2_len = ETHER_HDR_LEN;
+	pkt->outer_l3_len = outer_ip_hl;
+	pkt->l2_len = ETHER_VXLAN_HLEN + ETHER_HDR_LEN;
+	pkt->l3_len = l3_len;
+	pkt->l4_len = l4_len;
+	return 0;
+}
+
+uint16_t
+rte_gro_reassemble_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+		const struct rte_gro_param *param)
+{
+	struct gro_tcp4_item tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_tcp4_flow tcp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_vxlan_tcp4_item vxlan_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_vxlan_tcp4_flow vxlan_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_tcp4_tbl tcp_tbl;
+	struct gro_vxlan_tcp4_tbl vxlan_tbl;
+	uint32_t item_num, flow_num;
+	uint16_t i, nb_left, nb_merged = 0, vxlan_port;
+	int do_tcp4, do_vxlan;
+	int32_t ret;
+
+	do_tcp4 = (param->gro_types & RTE_GRO_TCP_IPV4) != 0;
+	do_vxlan = (param->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4) != 0;
+	if ((!do_tcp4 && !do_vxlan) || nb_pkts < 2)
+		return nb_pkts;
+
+	item_num = RTE_MIN((uint32_t)param->max_flow_num *
+			param->max_item_per_flow, RTE_GRO_MAX_BURST_ITEM_NUM);
+	item_num = RTE_MIN(item_num, (uint32_t)nb_pkts);
+	flow_num = RTE_MIN((uint32_t)param->max_flow_num, item_num);
+	if (item_num == 0)
+		return nb_pkts;
+
+	if (do_tcp4)
+		gro_tcp4_tbl_init(&tcp_tbl, tcp_items, item_num, tcp_flows,
+				flow_num);
+	if (do_vxlan)
+		gro_vxlan_tcp4_tbl_init(&vxlan_tbl, vxlan_items, item_num,
+				vxlan_flows, flow_num);
+	vxlan_port = param->vxlan_port != 0 ? param->vxlan_port :
+		RTE_GRO_VXLAN_DEFAULT_PORT;
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (do_vxlan && gro_parse_vxlan_tcp4(pkts[i], vxlan_port) == 0)
+			ret = gro_vxlan_tcp4_reassemble(pkts[i], &vxlan_tbl, 0,
+					i);
+		else if (do_tcp4 && gro_parse_tcp4(pkts[i]) == 0)
+			ret = gro_tcp4_reassemble(pkts[i], &tcp_tbl, 0, i);
+		else
+			continue;
+
+		/* merged packets are removed from the burst */
+		if (ret > 0) {
+			pkts[i] = NULL;
+			nb_merged++;
+		}
+	}
+
+	if (nb_merged == 0)
+		return nb_pkts;
+
+	/* put the merged packets back at the place of their first packet */
+	if (do_tcp4)
+		gro_tcp4_tbl_burst_flush(&tcp_tbl, pkts);
+	if (do_vxlan)
+		gro_vxlan_tcp4_tbl_burst_flush(&vxlan_tbl, pkts);
+
+	nb_left = 0;
+	for (i = 0; i < nb_pkts; i++) {
+		if (pkts[i] != NULL)
+			pkts[nb_left++] = pkts[i];
+	}
+
+	return nb_left;
+}
+
+void *
+rte_gro_ctx_create(const struct rte_gro_param *param)
+{
+	struct gro_ctx *ctx;
+
+	if (param == NULL || param->gro_types == 0 ||
+			(param->gro_types & ~GRO_SUPPORTED_TYPES) != 0 ||
+			param->max_flow_num == 0 ||
+			param->max_item_per_flow == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ctx = rte_zmalloc_socket(__func__, sizeof(*ctx), RTE_CACHE_LINE_SIZE,
+			param->socket_id);
+	if (ctx == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ctx->gro_types = param->gro_types;
+	ctx->vxlan_port = param->vxlan_port != 0 ? param->vxlan_port :
+		RTE_GRO_VXLAN_DEFAULT_PORT;
+
+	if (ctx->gro_types & RTE_GRO_TCP_IPV4) {
+		ctx->tcp4_tbl = gro_tcp4_tbl_create(param->socket_id,
+				param->max_flow_num, param->max_item_per_flow);
+		if (ctx->tcp4_tbl == NULL)
+			goto nomem;
+	}
+	if (ctx->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4) {
+		ctx->vxlan_tcp4_tbl = gro_vxlan_tcp4_tbl_create(
+				param->socket_id, param->max_flow_num,
+				param->max_item_per_flow);
+		if (ctx->vxlan_tcp4_tbl == NULL)
+			goto nomem;
+	}
+
+	return ctx;
+
+nomem:
+	rte_gro_ctx_destroy(ctx);
+	rte_errno = ENOMEM;
+	return NULL;
+}
+
+void
+rte_gro_ctx_destroy(void *ctx)
+{
+	struct gro_ctx *gro_ctx = ctx;
+
+	if (gro_ctx == NULL)
+		return;
+
+	gro_tcp4_tbl_destroy(gro_ctx->tcp4_tbl);
+	gro_vxlan_tcp4_tbl_destroy(gro_ctx->vxlan_tcp4_tbl);
+	rte_free(gro_ctx);
+}
+
+uint16_t
+rte_gro_reassemble(struct rte_mbuf **pkts, uint16_t nb_pkts, void *ctx)
+{
+	struct gro_ctx *gro_ctx = ctx;
+	uint64_t now;
+	uint16_t i, nb_left = 0;
+	int32_t ret;
+
+	now = rte_rdtsc();
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (gro_ctx->vxlan_tcp4_tbl != NULL &&
+				gro_parse_vxlan_tcp4(pkts[i],
+					gro_ctx->vxlan_port) == 0)
+			ret = gro_vxlan_tcp4_reassemble(pkts[i],
+					gro_ctx->vxlan_tcp4_tbl, now, 0);
+		else if (gro_ctx->tcp4_tbl != NULL &&
+				gro_parse_tcp4(pkts[i]) == 0)
+			ret = gro_tcp4_reassemble(pkts[i], gro_ctx->tcp4_tbl,
+					now, 0);
+		else
+			ret = -1;
+
+		/* the context keeps the merged and stored packets */
+		if (ret < 0)
+			pkts[nb_left++] = pkts[i];
+	}
+
+	return nb_left;
+}
+
+uint16_t
+rte_gro_timeout_flush(void *ctx, uint64_t timeout_cycles,
+		uint64_t gro_types, struct rte_mbuf **out, uint16_t max_nb_out)
+{
+	struct gro_ctx *gro_ctx = ctx;
+	uint64_t now, flush_timestamp;
+	uint16_t nb_out = 0;
+
+	now = rte_rdtsc();
+	flush_timestamp = timeout_cycles < now ? now - timeout_cycles : 0;
+	gro_types &= gro_ctx->gro_types;
+
+	if (gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4)
+		nb_out = gro_vxlan_tcp4_tbl_timeout_flush(
+				gro_ctx->vxlan_tcp4_tbl, flush_timestamp,
+				out, max_nb_out);
+	if ((gro_types & RTE_GRO_TCP_IPV4) && nb_out < max_nb_out)
+		nb_out += gro_tcp4_tbl_timeout_flush(gro_ctx->tcp4_tbl,
+				flush_timestamp, out + nb_out,
+				max_nb_out - nb_out);
+
+	return nb_out;
+}
+
+uint64_t
+rte_gro_get_pkt_count(void *ctx)
+{
+	struct gro_ctx *gro_ctx = ctx;
+	uint64_t count = 0;
+
+	if (gro_ctx->tcp4_tbl != NULL)
+		count += gro_tcp4_tbl_pkt_count(gro_ctx->tcp4_tbl);
+	if (gro_ctx->vxlan_tcp4_tbl != NULL)
+		count += gro_vxlan_tcp4_tbl_pkt_count(gro_ctx->vxlan_tcp4_tbl);
+
+	return count;
+}
@@ -0,0 +1,192 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_GRO_H_
+#define _RTE_GRO_H_
+
+/**
+ * @file
+ * RTE GRO
+ *
+ * The GRO library merges the consecutive TCP segments of a flow received
+ * in several packets into a single large packet, made of chained mbufs,
+ * to reduce the per packet processing cost of the applications and of
+ * the stacks they feed, for instance through KNI or vhost.
+ *
+ * Two modes are provided. rte_gro_reassemble_burst() merges the packets
+ * of a single burst and returns them right away. A GRO context, created
+ * with rte_gro_ctx_create(), keeps the packets across bursts with
+ * rte_gro_reassemble() until they are flushed by rte_gro_timeout_flush().
+ *
+ * The merged packets have their IPv4 total length and header checksum
+ * updated, but not their TCP checksum. The outer UDP checksum of the
+ * VXLAN packets is cleared.
+ */
+
+#include <stdint.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** TCP/IPv4 packets. */
+#define RTE_GRO_TCP_IPV4 (1ULL << 0)
+/** TCP/IPv4 packets encapsulated in VXLAN over IPv4. */
+#define RTE_GRO_IPV4_VXLAN_TCP_IPV4 (1ULL << 1)
+
+/** Maximum number of packets processed by rte_gro_reassemble_burst(). */
+#define RTE_GRO_MAX_BURST_ITEM_NUM 128U
+
+/** Default UDP destination port of the VXLAN packets. */
+#define RTE_GRO_VXLAN_DEFAULT_PORT 4789
+
+/**
+ * GRO parameters.
+ */
+struct rte_gro_param {
+	uint64_t gro_types;
+	/**< Types of packets to merge, RTE_GRO_* flags. */
+	uint16_t max_flow_num;
+	/**< Maximum number of flows of each type. */
+	uint16_t max_item_per_flow;
+	/**< Maximum number of packets kept per flow. */
+	uint16_t vxlan_port;
+	/**< UDP destination port of VXLAN, 0 for the default one. */
+	int socket_id;
+	/**< Socket of the memory of a GRO context. */
+};
+
+/**
+ * Merge the packets of a burst.
+ *
+ * The TCP segments of a flow found in the burst are merged in their first
+ * packet, and the following ones are removed from the burst. Packets of
+ * other types, or that cannot be merged, are left untouched, and the
+ * order of the remaining packets is preserved. The headers are parsed by
+ * the library: the l2_len, l3_len and l4_len fields (and outer_l2_len and
+ * outer_l3_len for VXLAN) of the processed packets are updated.
+ *
+ * The headers up to the TCP options must be in the first segment, and
+ * VLAN tagged packets are not merged.
+ *
+ * @param pkts
+ *   The burst of packets, updated in place.
+ * @param nb_pkts
+ *   The number of packets. Only the first RTE_GRO_MAX_BURST_ITEM_NUM
+ *   packets that can be merged are kept in the reassembly tables.
+ * @param param
+ *   The GRO parameters. max_flow_num and max_item_per_flow limit the
+ *   number of flows and packets kept for the burst.
+ * @return
+ *   The number of packets left in the burst.
+ */
+uint16_t rte_gro_reassemble_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+		const struct rte_gro_param *param);
+
+/**
+ * Create a GRO context.
+ *
+ * @param param
+ *   The GRO parameters.
+ * @return
+ *   The context on success, NULL on error, with rte_errno set to:
+ *    - EINVAL - invalid parameters
+ *    - ENOMEM - no appropriate memory area found
+ */
+void *rte_gro_ctx_create(const struct rte_gro_param *param);
+
+/**
+ * Destroy a GRO context. The packets it holds are not freed, they must
+ * be flushed before.
+ *
+ * @param ctx
+ *   The GRO context.
+ */
+void rte_gro_ctx_destroy(void *ctx);
+
+/**
+ * Store the packets of a burst in a GRO context.
+ *
+ * The packets of the configured types are merged with the packets held
+ * by the context or stored in it, with the current TSC as their arrival
+ * time. The other packets, and the ones that cannot be stored because
+ * the context is full, are returned at the beginning of the pkts array.
+ *
+ * @param pkts
+ *   The burst of packets.
+ * @param nb_pkts
+ *   The number of packets.
+ * @param ctx
+ *   The GRO context.
+ * @return
+ *   The number of packets returned in pkts.
+ */
+uint16_t rte_gro_reassemble(struct rte_mbuf **pkts, uint16_t nb_pkts,
+		void *ctx);
+
+/**
+ * Flush the packets held by a GRO context for a given time.
+ *
+ * @param ctx
+ *   The GRO context.
+ * @param timeout_cycles
+ *   The packets stored for at least this number of TSC cycles are
+ *   flushed. 0 flushes all the packets.
+ * @param gro_types
+ *   The types of packets to flush, RTE_GRO_* flags.
+ * @param out
+ *   The array receiving the flushed packets.
+ * @param max_nb_out
+ *   The size of the out array.
+ * @return
+ *   The number of packets written to out.
+ */
+uint16_t rte_gro_timeout_flush(void *ctx, uint64_t timeout_cycles,
+		uint64_t gro_types, struct rte_mbuf **out, uint16_t max_nb_out);
+
+/**
+ * Get the number of packets held by a GRO context.
+ *
+ * @param ctx
+ *   The GRO context.
+ * @return
+ *   The number of merged packets the context would flush.
+ */
+uint64_t rte_gro_get_pkt_count(void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRO_H_ */
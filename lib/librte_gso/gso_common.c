@@ -0,0 +1,166 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+
+#include <rte_memcpy.h>
+
+#include "gso_common.h"
+
+uint16_t
+gso_l4_cksum(const struct rte_mbuf *m, uint32_t off, uint32_t len,
+		uint16_t phdr_cksum)
+{
+	uint32_t sum, seg_len, done;
+	uint16_t cksum;
+
+	while (m != NULL && off >= m->data_len) {
+		off -= m->data_len;
+		m = m->next;
+	}
+
+	sum = phdr_cksum;
+	done = 0;
+	while (m != NULL && len > 0) {
+		seg_len = RTE_MIN(len, (uint32_t)m->data_len - off);
+		cksum = rte_raw_cksum(rte_pktmbuf_mtod_offset(m, const char *,
+				off), seg_len);
+		/* the words of a chunk starting at an odd offset are swapped */
+		if (done & 1)
+			cksum = (uint16_t)((cksum >> 8) | (cksum << 8));
+		sum += cksum;
+		done += seg_len;
+		len -= seg_len;
+		off = 0;
+		m = m->next;
+	}
+
+	cksum = (uint16_t)~__rte_raw_cksum_reduce(sum);
+	if (cksum == 0)
+		cksum = 0xffff;
+	return cksum;
+}
+
+/* copy the headers and the TX metadata of pkt to an output packet */
+static inline int
+hdr_segment_init(struct rte_mbuf *hdr_seg, const struct rte_mbuf *pkt,
+		uint16_t hdr_len)
+{
+	char *p;
+
+	p = rte_pktmbuf_append(hdr_seg, hdr_len);
+	if (p == NULL)
+		return -1;
+	rte_memcpy(p, rte_pktmbuf_mtod(pkt, const char *), hdr_len);
+
+	hdr_seg->ol_flags = pkt->ol_flags;
+	hdr_seg->tx_offload = pkt->tx_offload;
+	hdr_seg->vlan_tci = pkt->vlan_tci;
+	hdr_seg->vlan_tci_outer = pkt->vlan_tci_outer;
+	hdr_seg->packet_type = pkt->packet_type;
+	hdr_seg->port = pkt->port;
+	return 0;
+}
+
+int
+gso_do_segment(struct rte_mbuf *pkt, uint16_t hdr_len,
+		uint16_t pyld_unit_size, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_mbuf *pkt_in, *hdr_seg, *pyld_seg, *prev_seg;
+	uint32_t pos, len;
+	uint16_t nb_segs, left;
+
+	if (unlikely(pkt->data_len < hdr_len || pyld_unit_size == 0))
+		return -EINVAL;
+
+	pkt_in = pkt;
+	pos = hdr_len;
+	nb_segs = 0;
+
+	/* skip the segments of pkt that only hold headers */
+	while (pkt_in != NULL && pos >= pkt_in->data_len) {
+		pos -= pkt_in->data_len;
+		pkt_in = pkt_in->next;
+	}
+
+	while (pkt_in != NULL) {
+		if (unlikely(nb_segs >= nb_pkts_out)) {
+			gso_free_segments(pkts_out, nb_segs);
+			return -EINVAL;
+		}
+
+		hdr_seg = rte_pktmbuf_alloc(direct_pool);
+		if (unlikely(hdr_seg == NULL)) {
+			gso_free_segments(pkts_out, nb_segs);
+			return -ENOMEM;
+		}
+		pkts_out[nb_segs++] = hdr_seg;
+		if (unlikely(hdr_segment_init(hdr_seg, pkt, hdr_len) < 0)) {
+			gso_free_segments(pkts_out, nb_segs);
+			return -EINVAL;
+		}
+
+		/* attach up to pyld_unit_size bytes of payload */
+		prev_seg = hdr_seg;
+		left = pyld_unit_size;
+		while (left > 0 && pkt_in != NULL) {
+			pyld_seg = rte_pktmbuf_alloc(indirect_pool);
+			if (unlikely(pyld_seg == NULL)) {
+				gso_free_segments(pkts_out, nb_segs);
+				return -ENOMEM;
+			}
+			rte_pktmbuf_attach(pyld_seg, pkt_in);
+			len = RTE_MIN((uint32_t)left, pkt_in->data_len - pos);
+			pyld_seg->data_off = (uint16_t)(pkt_in->data_off + pos);
+			pyld_seg->data_len = (uint16_t)len;
+			pyld_seg->pkt_len = len;
+
+			prev_seg->next = pyld_seg;
+			prev_seg = pyld_seg;
+			hdr_seg->pkt_len += len;
+			hdr_seg->nb_segs++;
+			left -= len;
+			pos += len;
+
+			/* move to the next segment of pkt holding data */
+			while (pkt_in != NULL && pos >= pkt_in->data_len) {
+				pos = 0;
+				pkt_in = pkt_in->next;
+			}
+		}
+	}
+
+	return nb_segs;
+}
@@ -0,0 +1,119 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GSO_COMMON_H_
+#define _GSO_COMMON_H_
+
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+#include <rte_ip.h>
+
+/* TCP flags only kept in the first or in the last segment of a packet */
+#define GSO_TCP_FIN_FLAG 0x01
+#define GSO_TCP_PSH_FLAG 0x08
+#define GSO_TCP_CWR_FLAG 0x80
+
+/* free the n first output packets, on error */
+static inline void
+gso_free_segments(struct rte_mbuf **segs, uint16_t n)
+{
+	uint16_t i;
+
+	for (i = 0; i < n; i++)
+		rte_pktmbuf_free(segs[i]);
+}
+
+/* compute the header checksum of an IPv4 header, options included */
+static inline uint16_t
+gso_ipv4_cksum(const struct ipv4_hdr *ip, uint16_t l3_len)
+{
+	uint16_t cksum;
+
+	cksum = rte_raw_cksum(ip, l3_len);
+	return (cksum == 0xffff) ? cksum : (uint16_t)~cksum;
+}
+
+/*
+ * Compute the non-complemented pseudo-header checksum of the L4 header
+ * following an IPv4 header with options.
+ */
+static inline uint16_t
+gso_ipv4_phdr_cksum(const struct ipv4_hdr *ip, uint16_t l4_len)
+{
+	uint32_t sum;
+
+	sum = __rte_raw_cksum(&ip->src_addr, 2 * sizeof(ip->src_addr), 0);
+	sum += rte_cpu_to_be_16((uint16_t)ip->next_proto_id);
+	sum += rte_cpu_to_be_16(l4_len);
+	return __rte_raw_cksum_reduce(sum);
+}
+
+/*
+ * Update the IPv4 header of an output packet, and compute its checksum
+ * unless it is offloaded.
+ */
+static inline void
+gso_update_ipv4_hdr(struct ipv4_hdr *ip, uint16_t l3_len, uint16_t len,
+		uint16_t ip_id, int cksum_offload)
+{
+	ip->total_length = rte_cpu_to_be_16(len);
+	ip->packet_id = rte_cpu_to_be_16(ip_id);
+	ip->hdr_checksum = 0;
+	if (!cksum_offload)
+		ip->hdr_checksum = gso_ipv4_cksum(ip, l3_len);
+}
+
+/*
+ * Compute the complemented checksum of the len bytes following offset off
+ * in the packet m, whatever its segmentation, starting from the
+ * pseudo-header checksum phdr_cksum.
+ */
+uint16_t gso_l4_cksum(const struct rte_mbuf *m, uint32_t off, uint32_t len,
+		uint16_t phdr_cksum);
+
+/*
+ * Split the payload of pkt, following its hdr_len bytes of headers, into
+ * output packets holding at most pyld_unit_size bytes of it each. The
+ * headers are copied into a direct mbuf allocated from direct_pool, which
+ * is chained to indirect mbufs allocated from indirect_pool and attached
+ * to the segments of pkt. The headers of the output packets are left to
+ * the caller. Return the number of output packets, or a negative errno
+ * after freeing them on error.
+ */
+int gso_do_segment(struct rte_mbuf *pkt, uint16_t hdr_len,
+		uint16_t pyld_unit_size, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out);
+
+#endif /* _GSO_COMMON_H_ */
@@ -0,0 +1,195 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "gso_common.h"
+#include "gso_tcp4.h"
+
+/* payload length of the segments of a packet with hdr_len bytes of headers */
+static inline int
+tcp4_pyld_unit_size(const struct rte_mbuf *pkt, uint16_t hdr_len,
+		uint16_t gso_size)
+{
+	uint16_t mss;
+
+	if (unlikely(pkt->l3_len < sizeof(struct ipv4_hdr) ||
+			pkt->l4_len < sizeof(struct tcp_hdr) ||
+			hdr_len >= gso_size))
+		return -EINVAL;
+
+	mss = gso_size - hdr_len;
+	if (pkt->tso_segsz != 0 && pkt->tso_segsz < mss)
+		mss = pkt->tso_segsz;
+	return mss;
+}
+
+/*
+ * Update the IPv4 and TCP headers of the output packets, the IPv4 header
+ * being at offset l3_off.
+ */
+static void
+update_tcp4_headers(struct rte_mbuf **segs, uint16_t nb_segs,
+		uint16_t l3_off, uint8_t ipid_delta)
+{
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+	struct tcp_hdr *tcp;
+	uint32_t sent_seq;
+	uint16_t ip_id, l4_off, l4_len, phdr_cksum, i;
+	uint8_t tcp_flags;
+
+	m = segs[0];
+	l4_off = l3_off + m->l3_len;
+	ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, l3_off);
+	tcp = rte_pktmbuf_mtod_offset(m, struct tcp_hdr *, l4_off);
+	ip_id = rte_be_to_cpu_16(ip->packet_id);
+	sent_seq = rte_be_to_cpu_32(tcp->sent_seq);
+	tcp_flags = tcp->tcp_flags;
+
+	for (i = 0; i < nb_segs; i++) {
+		m = segs[i];
+		m->ol_flags &= ~PKT_TX_TCP_SEG;
+		ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, l3_off);
+		tcp = rte_pktmbuf_mtod_offset(m, struct tcp_hdr *, l4_off);
+		l4_len = (uint16_t)(m->pkt_len - l4_off);
+
+		gso_update_ipv4_hdr(ip, m->l3_len, l4_len + m->l3_len, ip_id,
+			m->ol_flags & PKT_TX_IP_CKSUM);
+
+		tcp->sent_seq = rte_cpu_to_be_32(sent_seq);
+		tcp->tcp_flags = tcp_flags;
+		if (i > 0)
+			tcp->tcp_flags &= ~GSO_TCP_CWR_FLAG;
+		if (i < nb_segs - 1)
+			tcp->tcp_flags &= ~(GSO_TCP_FIN_FLAG | GSO_TCP_PSH_FLAG);
+
+		tcp->cksum = 0;
+		phdr_cksum = gso_ipv4_phdr_cksum(ip, l4_len);
+		if ((m->ol_flags & PKT_TX_L4_MASK) == PKT_TX_TCP_CKSUM)
+			tcp->cksum = phdr_cksum;
+		else
+			tcp->cksum = gso_l4_cksum(m, l4_off, l4_len,
+				phdr_cksum);
+
+		ip_id += ipid_delta;
+		sent_seq += l4_len - m->l4_len;
+	}
+}
+
+int
+gso_tcp4_segment(struct rte_mbuf *pkt, uint16_t gso_size,
+		uint8_t ipid_delta, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	uint16_t hdr_len;
+	int pyld_unit_size, nb_segs;
+
+	hdr_len = pkt->l2_len + pkt->l3_len + pkt->l4_len;
+	pyld_unit_size = tcp4_pyld_unit_size(pkt, hdr_len, gso_size);
+	if (pyld_unit_size < 0)
+		return pyld_unit_size;
+
+	nb_segs = gso_do_segment(pkt, hdr_len, pyld_unit_size, direct_pool,
+		indirect_pool, pkts_out, nb_pkts_out);
+	if (nb_segs > 0)
+		update_tcp4_headers(pkts_out, nb_segs, pkt->l2_len,
+			ipid_delta);
+	return nb_segs;
+}
+
+/* update the outer IPv4 and UDP headers of the output packets */
+static void
+update_vxlan_outer_headers(struct rte_mbuf **segs, uint16_t nb_segs,
+		uint8_t ipid_delta)
+{
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	uint16_t ip_id, l4_off, i;
+
+	m = segs[0];
+	l4_off = m->outer_l2_len + m->outer_l3_len;
+	ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, m->outer_l2_len);
+	ip_id = rte_be_to_cpu_16(ip->packet_id);
+
+	for (i = 0; i < nb_segs; i++) {
+		m = segs[i];
+		ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *,
+			m->outer_l2_len);
+		gso_update_ipv4_hdr(ip, m->outer_l3_len,
+			m->pkt_len - m->outer_l2_len, ip_id,
+			m->ol_flags & PKT_TX_OUTER_IP_CKSUM);
+
+		udp = rte_pktmbuf_mtod_offset(m, struct udp_hdr *, l4_off);
+		udp->dgram_len = rte_cpu_to_be_16(m->pkt_len - l4_off);
+		udp->dgram_cksum = 0;
+
+		ip_id += ipid_delta;
+	}
+}
+
+int
+gso_vxlan_tcp4_segment(struct rte_mbuf *pkt, uint16_t gso_size,
+		uint8_t ipid_delta, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	uint16_t l3_off, hdr_len;
+	int pyld_unit_size, nb_segs;
+
+	if (unlikely(pkt->outer_l3_len < sizeof(struct ipv4_hdr) ||
+			pkt->l2_len < sizeof(struct udp_hdr) +
+			sizeof(struct vxlan_hdr) + ETHER_HDR_LEN))
+		return -EINVAL;
+
+	l3_off = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
+	hdr_len = l3_off + pkt->l3_len + pkt->l4_len;
+	pyld_unit_size = tcp4_pyld_unit_size(pkt, hdr_len, gso_size);
+	if (pyld_unit_size < 0)
+		return pyld_unit_size;
+
+	nb_segs = gso_do_segment(pkt, hdr_len, pyld_unit_size, direct_pool,
+		indirect_pool, pkts_out, nb_pkts_out);
+	if (nb_segs > 0) {
+		update_vxlan_outer_headers(pkts_out, nb_segs, ipid_delta);
+		update_tcp4_headers(pkts_out, nb_segs, l3_off, ipid_delta);
+	}
+	return nb_segs;
+}
@@ -0,0 +1,62 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GSO_TCP4_H_
+#define _GSO_TCP4_H_
+
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+
+/*
+ * Split a TCP/IPv4 packet with the PKT_TX_TCP_SEG flag into segments no
+ * longer than gso_size. The IPv4 ID is incremented by ipid_delta from a
+ * segment to the next one.
+ */
+int gso_tcp4_segment(struct rte_mbuf *pkt, uint16_t gso_size,
+		uint8_t ipid_delta, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out);
+
+/*
+ * Split a TCP/IPv4 packet encapsulated in VXLAN over IPv4, with the
+ * PKT_TX_TCP_SEG and PKT_TX_OUTER_IPV4 flags, into segments no longer
+ * than gso_size. The outer and inner IPv4 IDs are both incremented by
+ * ipid_delta from a segment to the next one.
+ */
+int gso_vxlan_tcp4_segment(struct rte_mbuf *pkt, uint16_t gso_size,
+		uint8_t ipid_delta, struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out);
+
+#endif /* _GSO_TCP4_H_ */
@@ -0,0 +1,130 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+
+#include <rte_ip.h>
+#include <rte_udp.h>
+
+#include "gso_common.h"
+#include "gso_udp4.h"
+
+/*
+ * Compute the checksum of the whole UDP datagram, which cannot be done
+ * by the NIC on its fragments. The checksum field of the UDP header is
+ * left untouched, and excluded from the sum.
+ */
+static uint16_t
+udp4_cksum(const struct rte_mbuf *pkt, const struct ipv4_hdr *ip,
+		uint16_t l4_off)
+{
+	const struct udp_hdr *udp;
+	uint32_t sum;
+	uint16_t l4_len;
+
+	udp = rte_pktmbuf_mtod_offset(pkt, const struct udp_hdr *, l4_off);
+	l4_len = (uint16_t)(pkt->pkt_len - l4_off);
+	sum = gso_ipv4_phdr_cksum(ip, l4_len);
+	sum += (uint16_t)~udp->dgram_cksum;
+	return gso_l4_cksum(pkt, l4_off, l4_len,
+		__rte_raw_cksum_reduce(sum));
+}
+
+/* update the IPv4 headers of the fragments */
+static void
+update_udp4_headers(struct rte_mbuf **segs, uint16_t nb_segs)
+{
+	struct rte_mbuf *m;
+	struct ipv4_hdr *ip;
+	uint16_t hdr_len, frag_off, i;
+
+	frag_off = 0;
+	for (i = 0; i < nb_segs; i++) {
+		m = segs[i];
+		m->ol_flags &= ~(PKT_TX_UDP_SEG | PKT_TX_L4_MASK);
+		hdr_len = m->l2_len + m->l3_len;
+		ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, m->l2_len);
+
+		ip->fragment_offset = frag_off / IPV4_HDR_OFFSET_UNITS;
+		if (i < nb_segs - 1)
+			ip->fragment_offset |= IPV4_HDR_MF_FLAG;
+		ip->fragment_offset = rte_cpu_to_be_16(ip->fragment_offset);
+		gso_update_ipv4_hdr(ip, m->l3_len, m->pkt_len - m->l2_len,
+			rte_be_to_cpu_16(ip->packet_id),
+			m->ol_flags & PKT_TX_IP_CKSUM);
+
+		frag_off += m->pkt_len - hdr_len;
+	}
+}
+
+int
+gso_udp4_segment(struct rte_mbuf *pkt, uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	uint16_t hdr_len, pyld_unit_size, cksum = 0;
+	int udp_cksum, nb_segs;
+
+	hdr_len = pkt->l2_len + pkt->l3_len;
+	if (unlikely(pkt->l3_len < sizeof(struct ipv4_hdr) ||
+			hdr_len >= gso_size ||
+			pkt->data_len < hdr_len + sizeof(struct udp_hdr)))
+		return -EINVAL;
+
+	/* the payload of all the fragments but the last is 8-byte aligned */
+	pyld_unit_size = (gso_size - hdr_len) &
+		~(uint16_t)(IPV4_HDR_OFFSET_UNITS - 1);
+	if (unlikely(pyld_unit_size == 0))
+		return -EINVAL;
+
+	ip = rte_pktmbuf_mtod_offset(pkt, struct ipv4_hdr *, pkt->l2_len);
+	udp_cksum = (pkt->ol_flags & PKT_TX_L4_MASK) == PKT_TX_UDP_CKSUM;
+	if (udp_cksum)
+		cksum = udp4_cksum(pkt, ip, hdr_len);
+
+	nb_segs = gso_do_segment(pkt, hdr_len, pyld_unit_size, direct_pool,
+		indirect_pool, pkts_out, nb_pkts_out);
+	if (nb_segs > 0) {
+		/* the UDP header is in the payload shared with the fragments */
+		if (udp_cksum) {
+			udp = rte_pktmbuf_mtod_offset(pkt, struct udp_hdr *,
+				hdr_len);
+			udp->dgram_cksum = cksum;
+		}
+		update_udp4_headers(pkts_out, nb_segs);
+	}
+	return nb_segs;
+}
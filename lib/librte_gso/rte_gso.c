@@ -0,0 +1,198 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+
+#include "rte_gso.h"
+#include "gso_common.h"
+#include "gso_tcp4.h"
+#include "gso_udp4.h"
+
+#define GSO_SUPPORTED_TYPES (RTE_GSO_TCP_IPV4 | RTE_GSO_UDP_IPV4 | \
+	RTE_GSO_IPV4_VXLAN_TCP_IPV4)
+
+/* maximum number of segments of a packet sent by rte_gso_tx_burst() */
+#define GSO_TX_MAX_SEGS 128
+
+#define GSO_IPV4_FRAG_MASK (IPV4_HDR_DF_FLAG | IPV4_HDR_MF_FLAG | \
+	IPV4_HDR_OFFSET_MASK)
+
+/* get the RTE_GSO_* type of a packet to segment, 0 if none */
+static inline uint64_t
+gso_pkt_type(const struct rte_mbuf *pkt, const struct rte_gso_ctx *ctx)
+{
+	const struct ipv4_hdr *ip;
+	uint64_t ol_flags = pkt->ol_flags;
+
+	if (ol_flags & PKT_TX_TCP_SEG) {
+		if (!(ol_flags & PKT_TX_IPV4))
+			return 0;
+		if (!(ol_flags & PKT_TX_OUTER_IPV4))
+			return ctx->gso_types & RTE_GSO_TCP_IPV4;
+
+		if (!(ctx->gso_types & RTE_GSO_IPV4_VXLAN_TCP_IPV4) ||
+				pkt->data_len < pkt->outer_l2_len +
+				sizeof(struct ipv4_hdr))
+			return 0;
+		ip = rte_pktmbuf_mtod_offset(pkt, const struct ipv4_hdr *,
+			pkt->outer_l2_len);
+		if (ip->next_proto_id != IPPROTO_UDP)
+			return 0;
+		return RTE_GSO_IPV4_VXLAN_TCP_IPV4;
+	}
+
+	if (!(ol_flags & PKT_TX_UDP_SEG) ||
+			!(ctx->gso_types & RTE_GSO_UDP_IPV4) ||
+			(ol_flags & (PKT_TX_IPV4 | PKT_TX_OUTER_IPV4)) !=
+			PKT_TX_IPV4 ||
+			pkt->pkt_len <= ctx->gso_size ||
+			pkt->data_len < pkt->l2_len + sizeof(struct ipv4_hdr))
+		return 0;
+	ip = rte_pktmbuf_mtod_offset(pkt, const struct ipv4_hdr *,
+		pkt->l2_len);
+	if (ip->next_proto_id != IPPROTO_UDP ||
+			(ip->fragment_offset &
+			 rte_cpu_to_be_16(GSO_IPV4_FRAG_MASK)) != 0)
+		return 0;
+	return RTE_GSO_UDP_IPV4;
+}
+
+int
+rte_gso_segment(struct rte_mbuf *pkt, const struct rte_gso_ctx *ctx,
+		struct rte_mbuf **pkts_out, uint16_t nb_pkts_out)
+{
+	uint8_t ipid_delta;
+	int ret;
+
+	if (pkt == NULL || ctx == NULL || pkts_out == NULL ||
+			nb_pkts_out == 0 || ctx->direct_pool == NULL ||
+			ctx->indirect_pool == NULL ||
+			(ctx->gso_types & ~GSO_SUPPORTED_TYPES) != 0)
+		return -EINVAL;
+
+	ipid_delta = (ctx->flag & RTE_GSO_FLAG_IPID_FIXED) ? 0 : 1;
+
+	switch (gso_pkt_type(pkt, ctx)) {
+	case RTE_GSO_TCP_IPV4:
+		ret = gso_tcp4_segment(pkt, ctx->gso_size, ipid_delta,
+			ctx->direct_pool, ctx->indirect_pool, pkts_out,
+			nb_pkts_out);
+		break;
+	case RTE_GSO_IPV4_VXLAN_TCP_IPV4:
+		ret = gso_vxlan_tcp4_segment(pkt, ctx->gso_size, ipid_delta,
+			ctx->direct_pool, ctx->indirect_pool, pkts_out,
+			nb_pkts_out);
+		break;
+	case RTE_GSO_UDP_IPV4:
+		ret = gso_udp4_segment(pkt, ctx->gso_size, ctx->direct_pool,
+			ctx->indirect_pool, pkts_out, nb_pkts_out);
+		break;
+	default:
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
+	/* the output packets hold their own references on the payload */
+	if (ret > 0)
+		rte_pktmbuf_free(pkt);
+	return ret;
+}
+
+/* take or release a reference on all the segments of a packet */
+static inline void
+gso_pkt_refcnt_update(struct rte_mbuf *pkt, int16_t value)
+{
+	for (; pkt != NULL; pkt = pkt->next)
+		rte_mbuf_refcnt_update(pkt, value);
+}
+
+uint16_t
+rte_gso_tx_burst(uint8_t port_id, uint16_t queue_id,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts,
+		const struct rte_gso_ctx *ctx, uint16_t *nb_drops)
+{
+	struct rte_mbuf *segs[GSO_TX_MAX_SEGS];
+	uint16_t i, first, nb_tx;
+	int nb_segs;
+
+	if (nb_drops != NULL)
+		*nb_drops = 0;
+	first = 0;
+	for (i = 0; i < nb_pkts; i++) {
+		if (gso_pkt_type(tx_pkts[i], ctx) == 0)
+			continue;
+
+		/* send the packets preceding the one to segment */
+		if (first < i) {
+			nb_tx = rte_eth_tx_burst(port_id, queue_id,
+				&tx_pkts[first], i - first);
+			if (nb_tx < i - first)
+				return first + nb_tx;
+		}
+
+		/*
+		 * Keep a reference on the packet, to give it back to the
+		 * caller if none of its segments can be sent.
+		 */
+		gso_pkt_refcnt_update(tx_pkts[i], 1);
+		nb_segs = rte_gso_segment(tx_pkts[i], ctx, segs,
+			RTE_DIM(segs));
+		if (nb_segs < 0) {
+			gso_pkt_refcnt_update(tx_pkts[i], -1);
+			return i;
+		}
+
+		nb_tx = rte_eth_tx_burst(port_id, queue_id, segs, nb_segs);
+		if (nb_tx == 0) {
+			gso_free_segments(segs, nb_segs);
+			return i;
+		}
+		rte_pktmbuf_free(tx_pkts[i]);
+		first = i + 1;
+		if (nb_tx < nb_segs) {
+			rte_pktmbuf_free_bulk(&segs[nb_tx], nb_segs - nb_tx);
+			if (nb_drops != NULL)
+				*nb_drops = nb_segs - nb_tx;
+			return first;
+		}
+	}
+
+	if (first < nb_pkts)
+		first += rte_eth_tx_burst(port_id, queue_id, &tx_pkts[first],
+			nb_pkts - first);
+	return first;
+}
@@ -0,0 +1,168 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_GSO_H_
+#define _RTE_GSO_H_
+
+/**
+ * @file
+ * RTE GSO
+ *
+ * The GSO library splits the large TCP/IPv4 packets, plain or encapsulated
+ * in VXLAN, into MSS sized segments, and fragments the large UDP/IPv4
+ * datagrams, for the ports that do not support TSO.
+ *
+ * Each output packet is made of a direct mbuf holding a copy of the headers,
+ * chained to indirect mbufs attached to the payload of the input packet, so
+ * that the payload is never copied. The IPv4 total lengths, IDs and
+ * fragment offsets, TCP sequence numbers and flags, and outer UDP lengths
+ * of the output packets are updated, and their checksums are computed in
+ * software unless their computation is requested to the NIC in the
+ * ol_flags of the input packet.
+ */
+
+#include <stdint.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** TCP/IPv4 packets, with the PKT_TX_TCP_SEG flag. */
+#define RTE_GSO_TCP_IPV4 (1ULL << 0)
+/** UDP/IPv4 datagrams longer than gso_size, with the PKT_TX_UDP_SEG flag. */
+#define RTE_GSO_UDP_IPV4 (1ULL << 1)
+/** TCP/IPv4 packets encapsulated in VXLAN over IPv4, with PKT_TX_TCP_SEG. */
+#define RTE_GSO_IPV4_VXLAN_TCP_IPV4 (1ULL << 2)
+
+/** Use the same IPv4 ID for all the TCP segments of a packet. */
+#define RTE_GSO_FLAG_IPID_FIXED (1U << 0)
+
+/**
+ * GSO context, describing how the packets are segmented.
+ */
+struct rte_gso_ctx {
+	struct rte_mempool *direct_pool;
+	/**< Pool of the mbufs holding the headers of the output packets. */
+	struct rte_mempool *indirect_pool;
+	/**< Pool of the indirect mbufs attached to the payload. */
+	uint64_t gso_types;
+	/**< Types of packets to segment, RTE_GSO_* flags. */
+	uint16_t gso_size;
+	/**< Maximum length of the output packets, headers included. */
+	uint8_t flag;
+	/**< RTE_GSO_FLAG_* flags. */
+};
+
+/**
+ * Segment a packet.
+ *
+ * The TCP/IPv4 packets with the PKT_TX_TCP_SEG flag are split into
+ * segments of at most tso_segsz bytes of payload, no longer than gso_size.
+ * The l2_len, l3_len and l4_len fields of the mbuf must be set, as well as
+ * outer_l2_len, outer_l3_len and the PKT_TX_OUTER_IPV4 flag for VXLAN,
+ * whose l2_len covers the UDP, VXLAN and inner Ethernet headers. The
+ * PKT_TX_TCP_SEG flag is cleared in the output packets, and the TCP
+ * checksum is computed in software unless PKT_TX_TCP_CKSUM is set.
+ *
+ * The UDP/IPv4 datagrams with the PKT_TX_UDP_SEG flag and longer than
+ * gso_size are split into IPv4 fragments, with the l2_len and l3_len fields
+ * set. Their UDP checksum is computed in software when PKT_TX_UDP_CKSUM is
+ * set, and the PKT_TX_UDP_SEG flag is cleared in the fragments. The
+ * datagrams with the DF flag set, or that already are fragments, are not
+ * segmented.
+ *
+ * In all cases, the headers must be in the first segment of the packet,
+ * and the IPv4 header checksums are computed in software unless
+ * PKT_TX_IP_CKSUM (or PKT_TX_OUTER_IP_CKSUM) is set.
+ *
+ * @param pkt
+ *   The packet to segment. On success, the reference held on it by the
+ *   caller is released: it is freed once all the output packets are.
+ *   On error, it is left untouched.
+ * @param ctx
+ *   The GSO context.
+ * @param pkts_out
+ *   The array receiving the output packets. A packet that does not need
+ *   to be segmented is returned as is in pkts_out[0].
+ * @param nb_pkts_out
+ *   The size of the pkts_out array.
+ * @return
+ *   The number of packets written to pkts_out on success, or a negative
+ *   value on error:
+ *    - -EINVAL - invalid parameters, or pkts_out is too small
+ *    - -ENOMEM - no mbuf available in the pools of the context
+ */
+int rte_gso_segment(struct rte_mbuf *pkt, const struct rte_gso_ctx *ctx,
+		struct rte_mbuf **pkts_out, uint16_t nb_pkts_out);
+
+/**
+ * Segment and send a burst of packets on a TX queue of an Ethernet device.
+ *
+ * This function is a replacement of rte_eth_tx_burst() for the ports that
+ * do not support TSO: the packets are segmented with rte_gso_segment()
+ * before being sent, and the other packets are sent unchanged.
+ *
+ * When the TX queue is full, the segments of a packet that have not been
+ * sent are freed if some of its segments have been sent: the packet is
+ * then consumed, and the number of segments freed is reported in nb_drops
+ * so that the caller can account for them as drops. A packet none of whose
+ * segments could be sent, or that could not be segmented, is returned to
+ * the caller.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The index of the transmit queue.
+ * @param tx_pkts
+ *   The packets to send.
+ * @param nb_pkts
+ *   The number of packets.
+ * @param ctx
+ *   The GSO context.
+ * @param nb_drops
+ *   If not NULL, set to the number of segments dropped because the TX queue
+ *   filled up in the middle of a packet, 0 if none.
+ * @return
+ *   The number of packets of tx_pkts consumed, the remaining ones are left
+ *   to the caller.
+ */
+uint16_t rte_gso_tx_burst(uint8_t port_id, uint16_t queue_id,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts,
+		const struct rte_gso_ctx *ctx, uint16_t *nb_drops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GSO_H_ */
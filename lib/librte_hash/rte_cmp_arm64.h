@@ -112,3 +112,31 @@ rte_hash_k128_cmp_eq(const void *key1, const void *key2, size_t key_len)
 		rte_hash_k64_cmp_eq((const char *) key1 + 64,
 				(const char *) key2 + 64, key_len);
 }
+
+/*
+ * Function to compare a 16-bit short signature against the 8 short
+ * signatures of a bucket in one instruction. Returns a mask with
+ * 2 bits set for each matching entry.
+ */
+static inline uint32_t
+rte_hash_sig_cmp_eq(const uint16_t *sigs, uint16_t sig)
+{
+	/* Bits of the mask for each entry, disjoint so adding them is OR */
+	static const uint16_t entry_bits[8] = {
+		0x0003, 0x000c, 0x0030, 0x00c0,
+		0x0300, 0x0c00, 0x3000, 0xc000
+	};
+	uint16x8_t hits;
+
+	hits = vceqq_u16(vld1q_u16(sigs), vdupq_n_u16(sig));
+	return vaddvq_u16(vandq_u16(hits, vld1q_u16(entry_bits)));
+}
+
+/* Function to compare a short signature against the signatures of two buckets */
+static inline void
+rte_hash_sig_cmp_eq_x2(const uint16_t *prim_sigs, const uint16_t *sec_sigs,
+		uint16_t sig, uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+	*prim_hitmask = rte_hash_sig_cmp_eq(prim_sigs, sig);
+	*sec_hitmask = rte_hash_sig_cmp_eq(sec_sigs, sig);
+}
@@ -107,3 +107,37 @@ rte_hash_k128_cmp_eq(const void *key1, const void *key2, size_t key_len)
 		rte_hash_k64_cmp_eq((const char *) key1 + 64,
 				(const char *) key2 + 64, key_len);
 }
+
+/*
+ * Function to compare a 16-bit short signature against the 8 short
+ * signatures of a bucket in one instruction. Returns a mask with
+ * 2 bits set for each matching entry.
+ */
+static inline uint32_t
+rte_hash_sig_cmp_eq(const uint16_t *sigs, uint16_t sig)
+{
+	return _mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128((const __m128i *)sigs),
+			_mm_set1_epi16(sig)));
+}
+
+/* Function to compare a short signature against the signatures of two buckets */
+static inline void
+rte_hash_sig_cmp_eq_x2(const uint16_t *prim_sigs, const uint16_t *sec_sigs,
+		uint16_t sig, uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+#ifdef RTE_MACHINE_CPUFLAG_AVX2
+	/* Primary bucket in the low lane, secondary bucket in the high lane */
+	const __m256i sigs = _mm256_inserti128_si256(_mm256_castsi128_si256(
+			_mm_load_si128((const __m128i *)prim_sigs)),
+			_mm_load_si128((const __m128i *)sec_sigs), 1);
+	const uint32_t hitmask = _mm256_movemask_epi8(
+			_mm256_cmpeq_epi16(sigs, _mm256_set1_epi16(sig)));
+
+	*prim_hitmask = hitmask & 0xffff;
+	*sec_hitmask = hitmask >> 16;
+#else
+	*prim_hitmask = rte_hash_sig_cmp_eq(prim_sigs, sig);
+	*sec_hitmask = rte_hash_sig_cmp_eq(sec_sigs, sig);
+#endif
+}
@@ -57,6 +57,7 @@
 #include <rte_spinlock.h>
 #include <rte_ring.h>
 #include <rte_compat.h>
+#include <rte_vect.h>
 
 #include "rte_hash.h"
 #if defined(RTE_ARCH_X86)
@@ -94,14 +95,43 @@ EAL_REGISTER_TAILQ(rte_hash_tailq)
 #endif
 
 /** Number of items per bucket. */
-#define RTE_HASH_BUCKET_ENTRIES		4
+#define RTE_HASH_BUCKET_ENTRIES		8
 
-#define NULL_SIGNATURE			0
+/** Key index of an unused bucket entry (key slot 0 is the dummy entry) */
+#define EMPTY_SLOT			0
 
 #define KEY_ALIGNMENT			16
 
 #define LCORE_CACHE_SIZE		8
 
+#if !defined(RTE_ARCH_X86) && !defined(RTE_ARCH_ARM64)
+/*
+ * Compare a short signature against the 8 short signatures of a bucket.
+ * Returns a mask with 2 bits set for each matching entry,
+ * so entry index is the position of the first set bit divided by 2.
+ */
+static inline uint32_t
+rte_hash_sig_cmp_eq(const uint16_t *sigs, uint16_t sig)
+{
+	uint32_t hitmask = 0;
+	unsigned i;
+
+	for (i = 0; i < 8; i++)
+		hitmask |= (uint32_t)(sigs[i] == sig) << (i << 1);
+
+	return hitmask * 3;
+}
+
+/* Compare a short signature against the signatures of two buckets */
+static inline void
+rte_hash_sig_cmp_eq_x2(const uint16_t *prim_sigs, const uint16_t *sec_sigs,
+		uint16_t sig, uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+	*prim_hitmask = rte_hash_sig_cmp_eq(prim_sigs, sig);
+	*sec_hitmask = rte_hash_sig_cmp_eq(sec_sigs, sig);
+}
+#endif
+
 #if defined(RTE_ARCH_X86) || defined(RTE_ARCH_ARM64)
 /*
  * All different options to select a key compare function,
@@ -192,17 +222,6 @@ struct rte_hash {
 	/**< Local cache per lcore, storing some indexes of the free slots */
 } __rte_cache_aligned;
 
-/* Structure storing both primary and secondary hashes */
-struct rte_hash_signatures {
-	union {
-		struct {
-			hash_sig_t current;
-			hash_sig_t alt;
-		};
-		uint64_t sig;
-	};
-};
-
 /* Structure that stores key-value pair */
 struct rte_hash_key {
 	union {
@@ -213,9 +232,15 @@ struct rte_hash_key {
 	char key[0];
 } __attribute__((aligned(KEY_ALIGNMENT)));
 
-/** Bucket structure */
+/**
+ * Bucket structure, fitting in a single cache line.
+ * Only the 16-bit short signature of each key is stored: the alternative
+ * bucket of an entry is derived from it and from the current bucket index,
+ * and the full key is kept out of line, in the key table.
+ */
 struct rte_hash_bucket {
-	struct rte_hash_signatures signatures[RTE_HASH_BUCKET_ENTRIES];
+	/* Short signatures, compared all at once with vector instructions */
+	uint16_t sig_current[RTE_HASH_BUCKET_ENTRIES];
 	/* Includes dummy key index that always contains index 0 */
 	uint32_t key_idx[RTE_HASH_BUCKET_ENTRIES + 1];
 	uint8_t flag[RTE_HASH_BUCKET_ENTRIES];
@@ -496,16 +521,54 @@ rte_hash_hash(const struct rte_hash *h, const void *key)
 	return h->hash_func(key, h->key_len, h->hash_func_init_val);
 }
 
-/* Calc the secondary hash value from the primary hash value of a given key */
-static inline hash_sig_t
-rte_hash_secondary_hash(const hash_sig_t primary_hash)
+/* Calc the short signature stored in the buckets from the hash of a key */
+static inline uint16_t
+rte_hash_short_sig(const hash_sig_t hash)
 {
-	static const unsigned all_bits_shift = 12;
-	static const unsigned alt_bits_xor = 0x5bd1e995;
+	return hash >> 16;
+}
 
-	uint32_t tag = primary_hash >> all_bits_shift;
+/*
+ * Calc the alternative bucket index of an entry from its current bucket
+ * index and its short signature. Applied to the primary bucket index it
+ * gives the secondary one and vice versa.
+ */
+static inline uint32_t
+rte_hash_alt_bucket_idx(const struct rte_hash *h, uint32_t bucket_idx,
+		uint16_t short_sig)
+{
+	return (bucket_idx ^ short_sig) & h->bucket_bitmask;
+}
 
-	return primary_hash ^ ((tag + 1) * alt_bits_xor);
+/*
+ * Search a key in a bucket, comparing the full key only on the entries
+ * whose short signature matches. Returns the entry index and the key slot
+ * if found, -1 otherwise.
+ */
+static inline int
+search_one_bucket(const struct rte_hash *h, const struct rte_hash_bucket *bkt,
+		const void *key, uint16_t short_sig,
+		struct rte_hash_key **key_slot)
+{
+	struct rte_hash_key *k, *keys = h->key_store;
+	uint32_t hitmask;
+	unsigned i;
+
+	hitmask = rte_hash_sig_cmp_eq(bkt->sig_current, short_sig);
+	while (hitmask) {
+		i = __builtin_ctz(hitmask) >> 1;
+		hitmask &= ~(3U << (i << 1));
+		if (bkt->key_idx[i] == EMPTY_SLOT)
+			continue;
+		k = (struct rte_hash_key *) ((char *)keys +
+				bkt->key_idx[i] * h->key_entry_size);
+		if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+			*key_slot = k;
+			return i;
+		}
+	}
+
+	return -1;
 }
 
 void
@@ -541,19 +604,22 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
 {
 	unsigned i, j;
 	int ret;
-	uint32_t next_bucket_idx;
+	uint32_t bucket_idx, next_bucket_idx;
 	struct rte_hash_bucket *next_bkt[RTE_HASH_BUCKET_ENTRIES];
 
+	bucket_idx = bkt - h->buckets;
+
 	/*
 	 * Push existing item (search for bucket with space in
 	 * alternative locations) to its alternative location
 	 */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Search for space in alternative locations */
-		next_bucket_idx = bkt->signatures[i].alt & h->bucket_bitmask;
+		next_bucket_idx = rte_hash_alt_bucket_idx(h, bucket_idx,
+				bkt->sig_current[i]);
 		next_bkt[i] = &h->buckets[next_bucket_idx];
 		for (j = 0; j < RTE_HASH_BUCKET_ENTRIES; j++) {
-			if (next_bkt[i]->signatures[j].sig == NULL_SIGNATURE)
+			if (next_bkt[i]->key_idx[j] == EMPTY_SLOT)
 				break;
 		}
 
@@ -563,8 +629,7 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
 
 	/* Alternative location has spare room (end of recursive function) */
 	if (i != RTE_HASH_BUCKET_ENTRIES) {
-		next_bkt[i]->signatures[j].alt = bkt->signatures[i].current;
-		next_bkt[i]->signatures[j].current = bkt->signatures[i].alt;
+		next_bkt[i]->sig_current[j] = bkt->sig_current[i];
 		next_bkt[i]->key_idx[j] = bkt->key_idx[i];
 		return i;
 	}
@@ -590,8 +655,7 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
 	 */
 	bkt->flag[i] = 0;
 	if (ret >= 0) {
-		next_bkt[i]->signatures[ret].alt = bkt->signatures[i].current;
-		next_bkt[i]->signatures[ret].current = bkt->signatures[i].alt;
+		next_bkt[i]->sig_current[ret] = bkt->sig_current[i];
 		next_bkt[i]->key_idx[ret] = bkt->key_idx[i];
 		return i;
 	} else
@@ -620,7 +684,7 @@ static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
 {
-	hash_sig_t alt_hash;
+	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	unsigned i;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt;
@@ -632,12 +696,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	unsigned lcore_id;
 	struct lcore_cache *cached_free_slots = NULL;
 
+	short_sig = rte_hash_short_sig(sig);
 	prim_bucket_idx = sig & h->bucket_bitmask;
 	prim_bkt = &h->buckets[prim_bucket_idx];
 	rte_prefetch0(prim_bkt);
 
-	alt_hash = rte_hash_secondary_hash(sig);
-	sec_bucket_idx = alt_hash & h->bucket_bitmask;
+	sec_bucket_idx = rte_hash_alt_bucket_idx(h, prim_bucket_idx, short_sig);
 	sec_bkt = &h->buckets[sec_bucket_idx];
 	rte_prefetch0(sec_bkt);
 
@@ -669,43 +733,31 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	new_idx = (uint32_t)((uintptr_t) slot_id);
 
 	/* Check if key is already inserted in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (prim_bkt->signatures[i].current == sig &&
-				prim_bkt->signatures[i].alt == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					prim_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return prim_bkt->key_idx[i] - 1;
-			}
-		}
+	ret = search_one_bucket(h, prim_bkt, key, short_sig, &k);
+	if (ret >= 0) {
+		/* Enqueue index of free slot back in the ring. */
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		/* Update data */
+		k->pdata = data;
+		/*
+		 * Return index where key is stored,
+		 * substracting the first dummy index
+		 */
+		return prim_bkt->key_idx[ret] - 1;
 	}
 
 	/* Check if key is already inserted in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (sec_bkt->signatures[i].alt == sig &&
-				sec_bkt->signatures[i].current == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					sec_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return sec_bkt->key_idx[i] - 1;
-			}
-		}
+	ret = search_one_bucket(h, sec_bkt, key, short_sig, &k);
+	if (ret >= 0) {
+		/* Enqueue index of free slot back in the ring. */
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		/* Update data */
+		k->pdata = data;
+		/*
+		 * Return index where key is stored,
+		 * substracting the first dummy index
+		 */
+		return sec_bkt->key_idx[ret] - 1;
 	}
 
 	/* Copy key */
@@ -715,9 +767,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* Insert new entry is there is room in the primary bucket */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Check if slot is available */
-		if (likely(prim_bkt->signatures[i].sig == NULL_SIGNATURE)) {
-			prim_bkt->signatures[i].current = sig;
-			prim_bkt->signatures[i].alt = alt_hash;
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = short_sig;
 			prim_bkt->key_idx[i] = new_idx;
 			return new_idx - 1;
 		}
@@ -732,8 +783,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	 * store the new slot back in the ring
 	 */
 	if (ret >= 0) {
-		prim_bkt->signatures[ret].current = sig;
-		prim_bkt->signatures[ret].alt = alt_hash;
+		prim_bkt->sig_current[ret] = short_sig;
 		prim_bkt->key_idx[ret] = new_idx;
 		return new_idx - 1;
 	}
@@ -791,56 +841,35 @@ __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
 	uint32_t bucket_idx;
-	hash_sig_t alt_hash;
-	unsigned i;
+	uint16_t short_sig;
+	int ret;
 	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
+	short_sig = rte_hash_short_sig(sig);
 	bucket_idx = sig & h->bucket_bitmask;
 	bkt = &h->buckets[bucket_idx];
 
 	/* Check if key is in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->signatures[i].current == sig &&
-				bkt->signatures[i].sig != NULL_SIGNATURE) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				if (data != NULL)
-					*data = k->pdata;
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
-		}
-	}
-
-	/* Calculate secondary hash */
-	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
-
-	/* Check if key is in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->signatures[i].current == alt_hash &&
-				bkt->signatures[i].alt == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				if (data != NULL)
-					*data = k->pdata;
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
-		}
+	ret = search_one_bucket(h, bkt, key, short_sig, &k);
+	if (ret < 0) {
+		/* Calculate secondary bucket index */
+		bucket_idx = rte_hash_alt_bucket_idx(h, bucket_idx, short_sig);
+		bkt = &h->buckets[bucket_idx];
+
+		/* Check if key is in secondary location */
+		ret = search_one_bucket(h, bkt, key, short_sig, &k);
+		if (ret < 0)
+			return -ENOENT;
 	}
 
-	return -ENOENT;
+	if (data != NULL)
+		*data = k->pdata;
+	/*
+	 * Return index where key is stored,
+	 * substracting the first dummy index
+	 */
+	return bkt->key_idx[ret] - 1;
 }
 
 int32_t
@@ -878,8 +907,10 @@ remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 {
 	unsigned lcore_id, n_slots;
 	struct lcore_cache *cached_free_slots;
+	uint32_t key_idx = bkt->key_idx[i];
 
-	bkt->signatures[i].sig = NULL_SIGNATURE;
+	bkt->sig_current[i] = 0;
+	bkt->key_idx[i] = EMPTY_SLOT;
 	if (h->hw_trans_mem_support) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
@@ -893,11 +924,11 @@ remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 		}
 		/* Put index of new free slot in cache. */
 		cached_free_slots->objs[cached_free_slots->len] =
-				(void *)((uintptr_t)bkt->key_idx[i]);
+				(void *)((uintptr_t)key_idx);
 		cached_free_slots->len++;
 	} else {
 		rte_ring_sp_enqueue(h->free_slots,
-				(void *)((uintptr_t)bkt->key_idx[i]));
+				(void *)((uintptr_t)key_idx));
 	}
 }
 
@@ -905,57 +936,37 @@ static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
-	uint32_t bucket_idx;
-	hash_sig_t alt_hash;
-	unsigned i;
+	uint32_t bucket_idx, key_idx;
+	uint16_t short_sig;
+	int ret;
 	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
+	short_sig = rte_hash_short_sig(sig);
 	bucket_idx = sig & h->bucket_bitmask;
 	bkt = &h->buckets[bucket_idx];
 
 	/* Check if key is in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->signatures[i].current == sig &&
-				bkt->signatures[i].sig != NULL_SIGNATURE) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				remove_entry(h, bkt, i);
-
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
-		}
+	ret = search_one_bucket(h, bkt, key, short_sig, &k);
+	if (ret < 0) {
+		/* Calculate secondary bucket index */
+		bucket_idx = rte_hash_alt_bucket_idx(h, bucket_idx, short_sig);
+		bkt = &h->buckets[bucket_idx];
+
+		/* Check if key is in secondary location */
+		ret = search_one_bucket(h, bkt, key, short_sig, &k);
+		if (ret < 0)
+			return -ENOENT;
 	}
 
-	/* Calculate secondary hash */
-	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
-
-	/* Check if key is in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->signatures[i].current == alt_hash &&
-				bkt->signatures[i].sig != NULL_SIGNATURE) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				remove_entry(h, bkt, i);
-
-				/*
-				 * Return index where key is stored,
-				 * substracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
-			}
-		}
-	}
+	key_idx = bkt->key_idx[ret];
+	remove_entry(h, bkt, ret);
 
-	return -ENOENT;
+	/*
+	 * Return index where key is stored,
+	 * substracting the first dummy index
+	 */
+	return key_idx - 1;
 }
 
 int32_t
@@ -987,55 +998,66 @@ lookup_stage0(unsigned *idx, uint64_t *lookup_mask,
 }
 
 /*
- * Lookup bulk stage 1: Calculate primary/secondary hashes
- * and prefetch primary/secondary buckets
+ * Lookup bulk stage 1: Calculate hash, short signature and primary/secondary
+ * bucket indexes, and prefetch primary/secondary buckets
  */
 static inline void
-lookup_stage1(unsigned idx, hash_sig_t *prim_hash, hash_sig_t *sec_hash,
+lookup_stage1(unsigned idx, uint16_t *short_sig,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
 		hash_sig_t *hash_vals, const void * const *keys,
 		const struct rte_hash *h)
 {
-	*prim_hash = rte_hash_hash(h, keys[idx]);
-	hash_vals[idx] = *prim_hash;
-	*sec_hash = rte_hash_secondary_hash(*prim_hash);
+	hash_sig_t hash;
+	uint32_t prim_bucket_idx;
+
+	hash = rte_hash_hash(h, keys[idx]);
+	hash_vals[idx] = hash;
+	*short_sig = rte_hash_short_sig(hash);
 
-	*primary_bkt = &h->buckets[*prim_hash & h->bucket_bitmask];
-	*secondary_bkt = &h->buckets[*sec_hash & h->bucket_bitmask];
+	prim_bucket_idx = hash & h->bucket_bitmask;
+	*primary_bkt = &h->buckets[prim_bucket_idx];
+	*secondary_bkt = &h->buckets[rte_hash_alt_bucket_idx(h,
+					prim_bucket_idx, *short_sig)];
 
 	rte_prefetch0(*primary_bkt);
 	rte_prefetch0(*secondary_bkt);
 }
 
 /*
- * Lookup bulk stage 2:  Search for match hashes in primary/secondary locations
- * and prefetch first key slot
+ * Lookup bulk stage 2:  Search for match signatures in primary/secondary
+ * locations and prefetch first key slot
  */
 static inline void
-lookup_stage2(unsigned idx, hash_sig_t prim_hash, hash_sig_t sec_hash,
+lookup_stage2(unsigned idx, uint16_t short_sig,
 		const struct rte_hash_bucket *prim_bkt,
 		const struct rte_hash_bucket *sec_bkt,
 		const struct rte_hash_key **key_slot, int32_t *positions,
 		uint64_t *extra_hits_mask, const void *keys,
 		const struct rte_hash *h)
 {
-	unsigned prim_hash_matches, sec_hash_matches, key_idx, i;
-	unsigned total_hash_matches;
+	uint32_t prim_hitmask, sec_hitmask;
+	unsigned key_idx, total_hash_matches;
 
-	prim_hash_matches = 1 << RTE_HASH_BUCKET_ENTRIES;
-	sec_hash_matches = 1 << RTE_HASH_BUCKET_ENTRIES;
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		prim_hash_matches |= ((prim_hash == prim_bkt->signatures[i].current) << i);
-		sec_hash_matches |= ((sec_hash == sec_bkt->signatures[i].current) << i);
-	}
+	/* Compare the short signature against both buckets at once */
+	rte_hash_sig_cmp_eq_x2(prim_bkt->sig_current, sec_bkt->sig_current,
+			short_sig, &prim_hitmask, &sec_hitmask);
+
+	/* Each match sets 2 bits, so there is more than one if above 2 */
+	total_hash_matches = __builtin_popcount(prim_hitmask) +
+				__builtin_popcount(sec_hitmask);
+
+	/*
+	 * Bit set after the last entry selects the dummy key index,
+	 * which always contains index 0, if there is no match
+	 */
+	prim_hitmask |= 1 << (RTE_HASH_BUCKET_ENTRIES << 1);
+	sec_hitmask |= 1 << (RTE_HASH_BUCKET_ENTRIES << 1);
 
-	key_idx = prim_bkt->key_idx[__builtin_ctzl(prim_hash_matches)];
+	key_idx = prim_bkt->key_idx[__builtin_ctz(prim_hitmask) >> 1];
 	if (key_idx == 0)
-		key_idx = sec_bkt->key_idx[__builtin_ctzl(sec_hash_matches)];
+		key_idx = sec_bkt->key_idx[__builtin_ctz(sec_hitmask) >> 1];
 
-	total_hash_matches = (prim_hash_matches |
-				(sec_hash_matches << (RTE_HASH_BUCKET_ENTRIES + 1)));
 	*key_slot = (const struct rte_hash_key *) ((const char *)keys +
 					key_idx * h->key_entry_size);
 
@@ -1046,7 +1068,7 @@ lookup_stage2(unsigned idx, hash_sig_t prim_hash, hash_sig_t sec_hash,
 	 */
 	positions[idx] = (key_idx - 1);
 
-	*extra_hits_mask |= (uint64_t)(__builtin_popcount(total_hash_matches) > 3) << idx;
+	*extra_hits_mask |= (uint64_t)(total_hash_matches > 2) << idx;
 
 }
 
@@ -1091,10 +1113,7 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 	const struct rte_hash_bucket *primary_bkt20, *primary_bkt21;
 	const struct rte_hash_bucket *secondary_bkt20, *secondary_bkt21;
 	const struct rte_hash_key *k_slot20, *k_slot21, *k_slot30, *k_slot31;
-	hash_sig_t primary_hash10, primary_hash11;
-	hash_sig_t secondary_hash10, secondary_hash11;
-	hash_sig_t primary_hash20, primary_hash21;
-	hash_sig_t secondary_hash20, secondary_hash21;
+	uint16_t short_sig10, short_sig11, short_sig20, short_sig21;
 
 	lookup_mask = (uint64_t) -1 >> (64 - num_keys);
 	miss_mask = lookup_mask;
@@ -1106,32 +1125,30 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 
 	lookup_stage0(&idx00, &lookup_mask, keys);
 	lookup_stage0(&idx01, &lookup_mask, keys);
-	lookup_stage1(idx10, &primary_hash10, &secondary_hash10,
+	lookup_stage1(idx10, &short_sig10,
 			&primary_bkt10, &secondary_bkt10, hash_vals, keys, h);
-	lookup_stage1(idx11, &primary_hash11, &secondary_hash11,
+	lookup_stage1(idx11, &short_sig11,
 			&primary_bkt11,	&secondary_bkt11, hash_vals, keys, h);
 
 	primary_bkt20 = primary_bkt10;
 	primary_bkt21 = primary_bkt11;
 	secondary_bkt20 = secondary_bkt10;
 	secondary_bkt21 = secondary_bkt11;
-	primary_hash20 = primary_hash10;
-	primary_hash21 = primary_hash11;
-	secondary_hash20 = secondary_hash10;
-	secondary_hash21 = secondary_hash11;
+	short_sig20 = short_sig10;
+	short_sig21 = short_sig11;
 	idx20 = idx10, idx21 = idx11;
 	idx10 = idx00, idx11 = idx01;
 
 	lookup_stage0(&idx00, &lookup_mask, keys);
 	lookup_stage0(&idx01, &lookup_mask, keys);
-	lookup_stage1(idx10, &primary_hash10, &secondary_hash10,
+	lookup_stage1(idx10, &short_sig10,
 			&primary_bkt10, &secondary_bkt10, hash_vals, keys, h);
-	lookup_stage1(idx11, &primary_hash11, &secondary_hash11,
+	lookup_stage1(idx11, &short_sig11,
 			&primary_bkt11,	&secondary_bkt11, hash_vals, keys, h);
-	lookup_stage2(idx20, primary_hash20, secondary_hash20, primary_bkt20,
+	lookup_stage2(idx20, short_sig20, primary_bkt20,
 			secondary_bkt20, &k_slot20, positions, &extra_hits_mask,
 			key_store, h);
-	lookup_stage2(idx21, primary_hash21, secondary_hash21, primary_bkt21,
+	lookup_stage2(idx21, short_sig21, primary_bkt21,
 			secondary_bkt21, &k_slot21, positions, &extra_hits_mask,
 			key_store, h);
 
@@ -1142,23 +1159,21 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		primary_bkt21 = primary_bkt11;
 		secondary_bkt20 = secondary_bkt10;
 		secondary_bkt21 = secondary_bkt11;
-		primary_hash20 = primary_hash10;
-		primary_hash21 = primary_hash11;
-		secondary_hash20 = secondary_hash10;
-		secondary_hash21 = secondary_hash11;
+		short_sig20 = short_sig10;
+		short_sig21 = short_sig11;
 		idx20 = idx10, idx21 = idx11;
 		idx10 = idx00, idx11 = idx01;
 
 		lookup_stage0(&idx00, &lookup_mask, keys);
 		lookup_stage0(&idx01, &lookup_mask, keys);
-		lookup_stage1(idx10, &primary_hash10, &secondary_hash10,
+		lookup_stage1(idx10, &short_sig10,
 			&primary_bkt10, &secondary_bkt10, hash_vals, keys, h);
-		lookup_stage1(idx11, &primary_hash11, &secondary_hash11,
+		lookup_stage1(idx11, &short_sig11,
 			&primary_bkt11,	&secondary_bkt11, hash_vals, keys, h);
-		lookup_stage2(idx20, primary_hash20, secondary_hash20,
+		lookup_stage2(idx20, short_sig20,
 			primary_bkt20, secondary_bkt20, &k_slot20, positions,
 			&extra_hits_mask, key_store, h);
-		lookup_stage2(idx21, primary_hash21, secondary_hash21,
+		lookup_stage2(idx21, short_sig21,
 			primary_bkt21, secondary_bkt21,	&k_slot21, positions,
 			&extra_hits_mask, key_store, h);
 		lookup_stage3(idx30, k_slot30, keys, positions, data, &hits, h);
@@ -1171,21 +1186,19 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 	primary_bkt21 = primary_bkt11;
 	secondary_bkt20 = secondary_bkt10;
 	secondary_bkt21 = secondary_bkt11;
-	primary_hash20 = primary_hash10;
-	primary_hash21 = primary_hash11;
-	secondary_hash20 = secondary_hash10;
-	secondary_hash21 = secondary_hash11;
+	short_sig20 = short_sig10;
+	short_sig21 = short_sig11;
 	idx20 = idx10, idx21 = idx11;
 	idx10 = idx00, idx11 = idx01;
 
-	lookup_stage1(idx10, &primary_hash10, &secondary_hash10,
+	lookup_stage1(idx10, &short_sig10,
 		&primary_bkt10, &secondary_bkt10, hash_vals, keys, h);
-	lookup_stage1(idx11, &primary_hash11, &secondary_hash11,
+	lookup_stage1(idx11, &short_sig11,
 		&primary_bkt11,	&secondary_bkt11, hash_vals, keys, h);
-	lookup_stage2(idx20, primary_hash20, secondary_hash20, primary_bkt20,
+	lookup_stage2(idx20, short_sig20, primary_bkt20,
 		secondary_bkt20, &k_slot20, positions, &extra_hits_mask,
 		key_store, h);
-	lookup_stage2(idx21, primary_hash21, secondary_hash21, primary_bkt21,
+	lookup_stage2(idx21, short_sig21, primary_bkt21,
 		secondary_bkt21, &k_slot21, positions, &extra_hits_mask,
 		key_store, h);
 	lookup_stage3(idx30, k_slot30, keys, positions, data, &hits, h);
@@ -1197,16 +1210,14 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 	primary_bkt21 = primary_bkt11;
 	secondary_bkt20 = secondary_bkt10;
 	secondary_bkt21 = secondary_bkt11;
-	primary_hash20 = primary_hash10;
-	primary_hash21 = primary_hash11;
-	secondary_hash20 = secondary_hash10;
-	secondary_hash21 = secondary_hash11;
+	short_sig20 = short_sig10;
+	short_sig21 = short_sig11;
 	idx20 = idx10, idx21 = idx11;
 
-	lookup_stage2(idx20, primary_hash20, secondary_hash20, primary_bkt20,
+	lookup_stage2(idx20, short_sig20, primary_bkt20,
 		secondary_bkt20, &k_slot20, positions, &extra_hits_mask,
 		key_store, h);
-	lookup_stage2(idx21, primary_hash21, secondary_hash21, primary_bkt21,
+	lookup_stage2(idx21, short_sig21, primary_bkt21,
 		secondary_bkt21, &k_slot21, positions, &extra_hits_mask,
 		key_store, h);
 	lookup_stage3(idx30, k_slot30, keys, positions, data, &hits, h);
@@ -1299,7 +1310,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
 	/* If current position is empty, go to the next one */
-	while (h->buckets[bucket_idx].signatures[idx].sig == NULL_SIGNATURE) {
+	while (h->buckets[bucket_idx].key_idx[idx] == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
 		if (*next == total_entries)
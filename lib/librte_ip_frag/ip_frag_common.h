@@ -36,6 +36,8 @@
 
 #include "rte_ip_frag.h"
 
+#include <rte_vect.h>
+
 /* logging macros. */
 #ifdef RTE_LIBRTE_IP_FRAG_DEBUG
 
@@ -62,19 +64,43 @@ if (!(exp))	{							\
 #define IPv6_KEY_BYTES_FMT \
 	"%08" PRIx64 "%08" PRIx64 "%08" PRIx64 "%08" PRIx64
 
+/* max number of fragments handled by one pass of the burst reassembly */
+#define IP_FRAG_BURST_SIZE	IP_FRAG_DEATH_ROW_LEN
+
+/* fragment description gathered by the first pass of the burst reassembly */
+struct ip_frag_burst_ent {
+	struct ip_frag_key key;   /* key_len == 0 for non-fragmented packets */
+	uint32_t sig[2];          /* both hash signatures of the key */
+	uint16_t ofs;             /* fragment offset */
+	uint16_t len;             /* fragment payload length */
+	uint16_t more_frags;      /* non-zero if more fragments follow */
+};
+
 /* internal functions declarations */
-struct rte_mbuf * ip_frag_process(struct ip_frag_pkt *fp,
-		struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb,
-		uint16_t ofs, uint16_t len, uint16_t more_frags);
+struct rte_mbuf * ip_frag_process(struct rte_ip_frag_tbl *tbl,
+		struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
+		struct rte_mbuf *mb, uint16_t ofs, uint16_t len,
+		uint16_t more_frags);
 
 struct ip_frag_pkt * ip_frag_find(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
-		const struct ip_frag_key *key, uint64_t tms);
+		const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms);
 
 struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
 
+void ip_frag_hash(const struct ip_frag_key *key, uint32_t sig[2]);
+
+void ip_frag_prefetch(const struct rte_ip_frag_tbl *tbl, const uint32_t sig[2]);
+
+void ip_frag_death_row_reserve(struct rte_ip_frag_death_row *dr,
+	uint32_t nb_pkts);
+
+uint16_t ip_frag_process_burst(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+	const struct ip_frag_burst_ent *ent, uint16_t nb_pkts, uint64_t tms);
+
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf * ipv4_frag_reassemble(const struct ip_frag_pkt *fp);
 struct rte_mbuf * ipv6_frag_reassemble(const struct ip_frag_pkt *fp);
@@ -105,15 +131,134 @@ ip_frag_key_invalidate(struct ip_frag_key * key)
 		key->src_dst[i] = 0;
 }
 
-/* compare two keys */
-static inline int
+/*
+ * compare two keys, returns zero if they are equal.
+ * Key length is compared along with the id, so IPv4 and IPv6 keys
+ * sharing the same table never match each other.
+ */
+static inline uint64_t
 ip_frag_key_cmp(const struct ip_frag_key * k1, const struct ip_frag_key * k2)
 {
-	uint32_t i, val;
-	val = k1->id ^ k2->id;
-	for (i = 0; i < k1->key_len; i++)
-		val |= k1->src_dst[i] ^ k2->src_dst[i];
-	return val;
+	uint64_t val;
+
+	val = (k1->id ^ k2->id) | (k1->key_len ^ k2->key_len);
+	if (k1->key_len == IPV4_KEYLEN)
+		return val | (k1->src_dst[0] ^ k2->src_dst[0]);
+
+#if defined(RTE_MACHINE_CPUFLAG_AVX2)
+	{
+		__m256i x;
+
+		x = _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i *)k1->src_dst),
+			_mm256_loadu_si256((const __m256i *)k2->src_dst));
+		return val | !_mm256_testz_si256(x, x);
+	}
+#elif defined(RTE_MACHINE_CPUFLAG_SSE4_1)
+	{
+		__m128i x;
+
+		x = _mm_or_si128(
+			_mm_xor_si128(
+				_mm_loadu_si128((const __m128i *)k1->src_dst),
+				_mm_loadu_si128((const __m128i *)k2->src_dst)),
+			_mm_xor_si128(
+				_mm_loadu_si128((const __m128i *)k1->src_dst + 1),
+				_mm_loadu_si128((const __m128i *)k2->src_dst + 1)));
+		return val | !_mm_testz_si128(x, x);
+	}
+#else
+	{
+		uint32_t i;
+
+		for (i = 0; i < k1->key_len; i++)
+			val |= k1->src_dst[i] ^ k2->src_dst[i];
+		return val;
+	}
+#endif
+}
+
+/*
+ * burst fragmentation helpers
+ */
+
+/* max number of indirect mbufs bulk allocated for one packet */
+#define IP_FRAG_BULK_SEGS_MAX	256
+
+/*
+ * Count fragments and indirect mbufs needed to split the data of the
+ * packet, starting at offset ofs, into fragments of frag_len bytes.
+ * Follows the same steps as ip_frag_attach().
+ */
+static inline uint32_t
+ip_frag_count(const struct rte_mbuf *m, uint32_t ofs, uint32_t frag_len,
+	uint32_t *nb_segs)
+{
+	uint32_t len, left, nb_frags, n;
+
+	n = 0;
+	nb_frags = 0;
+	while (m != NULL) {
+		nb_frags++;
+		left = frag_len;
+		do {
+			n++;
+			len = RTE_MIN(left, m->data_len - ofs);
+			left -= len;
+			ofs += len;
+			if (ofs == m->data_len) {
+				m = m->next;
+				ofs = 0;
+			}
+		} while (left != 0 && m != NULL);
+	}
+
+	*nb_segs = n;
+	return nb_frags;
+}
+
+/*
+ * Attach the data of the input packet to pre-allocated indirect mbufs,
+ * until the output fragment reaches mtu_size bytes.
+ * Returns non-zero if there is more data left in the input packet.
+ */
+static inline uint32_t
+ip_frag_attach(struct rte_mbuf *out_pkt, struct rte_mbuf **ind,
+	uint32_t *ind_pos, struct rte_mbuf **in_seg, uint32_t *in_seg_data_pos,
+	uint32_t mtu_size)
+{
+	struct rte_mbuf *seg, *out_seg, *out_seg_prev;
+	uint32_t len, pos, k;
+
+	seg = *in_seg;
+	pos = *in_seg_data_pos;
+	k = *ind_pos;
+	out_seg_prev = out_pkt;
+
+	do {
+		out_seg = ind[k++];
+		out_seg_prev->next = out_seg;
+		out_seg_prev = out_seg;
+
+		rte_pktmbuf_attach(out_seg, seg);
+		len = RTE_MIN(mtu_size - out_pkt->pkt_len,
+			(uint32_t)seg->data_len - pos);
+		out_seg->data_off = (uint16_t)(seg->data_off + pos);
+		out_seg->data_len = (uint16_t)len;
+		out_pkt->pkt_len += len;
+		out_pkt->nb_segs++;
+		pos += len;
+
+		if (pos == seg->data_len) {
+			seg = seg->next;
+			pos = 0;
+		}
+	} while (out_pkt->pkt_len < mtu_size && seg != NULL);
+
+	*in_seg = seg;
+	*in_seg_data_pos = pos;
+	*ind_pos = k;
+	return seg != NULL;
 }
 
 /*
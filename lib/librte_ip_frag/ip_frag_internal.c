@@ -33,6 +33,7 @@
 
 #include <stddef.h>
 
+#include <rte_prefetch.h>
 #include <rte_jhash.h>
 #ifdef RTE_MACHINE_CPUFLAG_SSE4_2
 #include <rte_hash_crc.h>
@@ -136,9 +137,36 @@ ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
 	*v2 = (v << 7) + (v >> 14);
 }
 
+void
+ip_frag_hash(const struct ip_frag_key *key, uint32_t sig[2])
+{
+	/* different hashing methods for IPv4 and IPv6 */
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, &sig[0], &sig[1]);
+	else
+		ipv6_frag_hash(key, &sig[0], &sig[1]);
+}
+
+/* prefetch the keys of both hash buckets for the given signatures. */
+void
+ip_frag_prefetch(const struct rte_ip_frag_tbl *tbl, const uint32_t sig[2])
+{
+	const struct ip_frag_pkt *p1, *p2;
+	uint32_t i;
+
+	p1 = IP_FRAG_TBL_POS(tbl, sig[0]);
+	p2 = IP_FRAG_TBL_POS(tbl, sig[1]);
+
+	for (i = 0; i != tbl->bucket_entries; i++) {
+		rte_prefetch0(&p1[i].key);
+		rte_prefetch0(&p2[i].key);
+	}
+}
+
 struct rte_mbuf *
-ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
-	struct rte_mbuf *mb, uint16_t ofs, uint16_t len, uint16_t more_frags)
+ip_frag_process(struct rte_ip_frag_tbl *tbl, struct ip_frag_pkt *fp,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb, uint16_t ofs,
+	uint16_t len, uint16_t more_frags)
 {
 	uint32_t idx;
 
@@ -156,8 +184,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 				IP_LAST_FRAG_IDX : UINT32_MAX;
 
 	/* this is the intermediate fragment. */
-	} else if ((idx = fp->last_idx) <
-		sizeof (fp->frags) / sizeof (fp->frags[0])) {
+	} else if ((idx = fp->last_idx) < tbl->max_frags) {
 		fp->last_idx++;
 	}
 
@@ -165,7 +192,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 	 * errorneous packet: either exceeed max allowed number of fragments,
 	 * or duplicate first/last fragment encountered.
 	 */
-	if (idx >= sizeof (fp->frags) / sizeof (fp->frags[0])) {
+	if (idx >= tbl->max_frags) {
 
 		/* report an error. */
 		if (fp->key.key_len == IPV4_KEYLEN)
@@ -270,7 +297,7 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
  */
 struct ip_frag_pkt *
 ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	const struct ip_frag_key *key, uint64_t tms)
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms)
 {
 	struct ip_frag_pkt *pkt, *free, *stale, *lru;
 	uint64_t max_cycles;
@@ -285,7 +312,7 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
 
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	if ((pkt = ip_frag_lookup(tbl, key, sig, tms, &free, &stale)) == NULL) {
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
@@ -332,13 +359,13 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 struct ip_frag_pkt *
 ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc, hash[2];
 
 	empty = NULL;
 	old = NULL;
@@ -349,14 +376,14 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
 		return tbl->last;
 
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
+	/* signatures might be already calculated by the caller. */
+	if (sig == NULL) {
+		ip_frag_hash(key, hash);
+		sig = hash;
+	}
 
-	p1 = IP_FRAG_TBL_POS(tbl, sig1);
-	p2 = IP_FRAG_TBL_POS(tbl, sig2);
+	p1 = IP_FRAG_TBL_POS(tbl, sig[0]);
+	p2 = IP_FRAG_TBL_POS(tbl, sig[1]);
 
 	for (i = 0; i != assoc; i++) {
 		if (p1->key.key_len == IPV4_KEYLEN)
@@ -416,3 +443,48 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	*stale = old;
 	return NULL;
 }
+
+/*
+ * Second pass of the burst reassembly: lookup/add table entries for
+ * the fragments described by ent[] and process them.
+ * Reassembled and non-fragmented packets are stored back into mbufs[],
+ * returns their number.
+ */
+uint16_t
+ip_frag_process_burst(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+	const struct ip_frag_burst_ent *ent, uint16_t nb_pkts, uint64_t tms)
+{
+	struct ip_frag_pkt *fp;
+	struct rte_mbuf *mb;
+	uint16_t i, n;
+
+	n = 0;
+	for (i = 0; i != nb_pkts; i++) {
+
+		mb = mbufs[i];
+
+		/* not a fragment, pass it through as is. */
+		if (ent[i].key.key_len == 0) {
+			mbufs[n++] = mb;
+			continue;
+		}
+
+		/* try to find/add entry into the fragment's table. */
+		fp = ip_frag_find(tbl, dr, &ent[i].key, ent[i].sig, tms);
+		if (fp == NULL) {
+			IP_FRAG_MBUF2DR(dr, mb);
+			continue;
+		}
+
+		/* process the fragmented packet. */
+		mb = ip_frag_process(tbl, fp, dr, mb, ent[i].ofs, ent[i].len,
+			ent[i].more_frags);
+		ip_frag_inuse(tbl, fp);
+
+		if (mb != NULL)
+			mbufs[n++] = mb;
+	}
+
+	return n;
+}
@@ -121,6 +121,7 @@ struct rte_ip_frag_tbl {
 	uint32_t             bucket_entries;  /**< hash assocaitivity. */
 	uint32_t             nb_entries;      /**< total size of the table. */
 	uint32_t             nb_buckets;      /**< num of associativity lines. */
+	uint32_t             max_frags;       /**< max fragments per packet. */
 	struct ip_frag_pkt *last;         /**< last used entry. */
 	struct ip_pkt_list lru;           /**< LRU list for table entries. */
 	struct ip_frag_tbl_stat stat;     /**< statistics counters. */
@@ -174,6 +175,24 @@ struct rte_ip_frag_tbl * rte_ip_frag_table_create(uint32_t bucket_num,
 		uint32_t bucket_entries,  uint32_t max_entries,
 		uint64_t max_cycles, int socket_id);
 
+/**
+ * Set maximum number of fragments per packet accepted by the table.
+ * Packets split into more fragments are dropped as soon as the limit
+ * is exceeded, which bounds the work spent on fragment floods.
+ * By default the table accepts up to IP_MAX_FRAG_NUM fragments,
+ * which is also the upper limit (RTE_LIBRTE_IP_FRAG_MAX_FRAG).
+ *
+ * @param tbl
+ *   Fragmentation table to configure.
+ * @param max_frags
+ *   Maximum number of fragments per packet,
+ *   between IP_MIN_FRAG_NUM and IP_MAX_FRAG_NUM.
+ * @return
+ *   0 on success, -EINVAL if the value is out of range.
+ */
+int rte_ip_frag_table_max_frags_set(struct rte_ip_frag_tbl *tbl,
+		uint32_t max_frags);
+
 /*
  * Free allocated IP fragmentation table.
  *
@@ -215,6 +234,50 @@ rte_ipv6_fragment_packet(struct rte_mbuf *pkt_in,
 		struct rte_mempool *pool_direct,
 		struct rte_mempool *pool_indirect);
 
+/**
+ * Burst IPv6 fragmentation.
+ *
+ * Packets no longer than the MTU are moved to the output array unchanged,
+ * longer packets are fragmented as by rte_ipv6_fragment_packet(), with
+ * the direct and indirect buffers of all their fragments bulk allocated
+ * and the fragment headers built from a single copy of the packet header.
+ * Fragments of a packet are stored contiguously in the output array, in
+ * the order of the input packets. Input packets are not freed: as with
+ * rte_ipv6_fragment_packet(), the fragmented ones should be freed by the
+ * caller, their data stays attached to the fragments.
+ *
+ * Processing stops at the first packet which does not fit into the
+ * output array or can't be fragmented (e.g. out of mbufs);
+ * rte_ipv6_fragment_packet() can tell the reason for it.
+ *
+ * @param pkts_in
+ *   The input packets.
+ * @param nb_pkts_in
+ *   Number of input packets.
+ * @param pkts_out
+ *   Array storing the output packets.
+ * @param nb_pkts_out
+ *   Size of the output array.
+ * @param nb_frags
+ *   Array of at least nb_pkts_in entries, receives the number of output
+ *   packets produced by each consumed input packet, 1 if it was not
+ *   fragmented.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv6
+ *   datagrams. This value includes the size of the IPv6 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @return
+ *   Number of input packets consumed.
+ */
+uint16_t rte_ipv6_fragment_burst(struct rte_mbuf **pkts_in,
+		uint16_t nb_pkts_in, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out, uint16_t *nb_frags, uint16_t mtu_size,
+		struct rte_mempool *pool_direct,
+		struct rte_mempool *pool_indirect);
+
 /*
  * This function implements reassembly of fragmented IPv6 packets.
  * Incoming mbuf should have its l2_len/l3_len fields setup correctly.
@@ -241,6 +304,36 @@ struct rte_mbuf *rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_mbuf *mb, uint64_t tms, struct ipv6_hdr *ip_hdr,
 		struct ipv6_extension_fragment *frag_hdr);
 
+/**
+ * Burst reassembly of IPv6 packets.
+ *
+ * Hashes the keys of all fragments and prefetches the matching table
+ * buckets before any lookup is done, amortising table cache misses
+ * over the whole burst.
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly,
+ * the fragment header is expected right after the fixed IPv6 header.
+ * Packets that are not fragments are returned unmodified.
+ * Mbufs to be freed are put on the death row; it is flushed by this
+ * function when it runs out of room.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbufs
+ *   Array of incoming mbufs. On return, it contains the reassembled and
+ *   the non-fragmented packets, in their order of completion.
+ * @param nb_pkts
+ *   Number of mbufs in the array.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @return
+ *   Number of packets stored at the beginning of mbufs.
+ */
+uint16_t rte_ipv6_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+		uint16_t nb_pkts, uint64_t tms);
+
 /*
  * Return a pointer to the packet's fragment header, if found.
  * It only looks at the extension header that's right after the fixed IPv6
@@ -291,6 +384,51 @@ int32_t rte_ipv4_fragment_packet(struct rte_mbuf *pkt_in,
 			struct rte_mempool *pool_direct,
 			struct rte_mempool *pool_indirect);
 
+/**
+ * Burst IPv4 fragmentation.
+ *
+ * Packets no longer than the MTU are moved to the output array unchanged,
+ * longer packets are fragmented as by rte_ipv4_fragment_packet(), with
+ * the direct and indirect buffers of all their fragments bulk allocated
+ * and the fragment headers built from a single copy of the packet header.
+ * Fragments of a packet are stored contiguously in the output array, in
+ * the order of the input packets. Input packets are not freed: as with
+ * rte_ipv4_fragment_packet(), the fragmented ones should be freed by the
+ * caller, their data stays attached to the fragments.
+ *
+ * Processing stops at the first packet which does not fit into the
+ * output array or can't be fragmented (e.g. Don't Fragment flag set
+ * or out of mbufs);
+ * rte_ipv4_fragment_packet() can tell the reason for it.
+ *
+ * @param pkts_in
+ *   The input packets.
+ * @param nb_pkts_in
+ *   Number of input packets.
+ * @param pkts_out
+ *   Array storing the output packets.
+ * @param nb_pkts_out
+ *   Size of the output array.
+ * @param nb_frags
+ *   Array of at least nb_pkts_in entries, receives the number of output
+ *   packets produced by each consumed input packet, 1 if it was not
+ *   fragmented.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv4
+ *   datagrams. This value includes the size of the IPv4 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @return
+ *   Number of input packets consumed.
+ */
+uint16_t rte_ipv4_fragment_burst(struct rte_mbuf **pkts_in,
+		uint16_t nb_pkts_in, struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out, uint16_t *nb_frags, uint16_t mtu_size,
+		struct rte_mempool *pool_direct,
+		struct rte_mempool *pool_indirect);
+
 /*
  * This function implements reassembly of fragmented IPv4 packets.
  * Incoming mbufs should have its l2_len/l3_len fields setup correclty.
@@ -314,6 +452,35 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct ipv4_hdr *ip_hdr);
 
+/**
+ * Burst reassembly of IPv4 packets.
+ *
+ * Hashes the keys of all fragments and prefetches the matching table
+ * buckets before any lookup is done, amortising table cache misses
+ * over the whole burst.
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ * Packets that are not fragments are returned unmodified.
+ * Mbufs to be freed are put on the death row; it is flushed by this
+ * function when it runs out of room.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbufs
+ *   Array of incoming mbufs. On return, it contains the reassembled and
+ *   the non-fragmented packets, in their order of completion.
+ * @param nb_pkts
+ *   Number of mbufs in the array.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @return
+ *   Number of packets stored at the beginning of mbufs.
+ */
+uint16_t rte_ipv4_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+		uint16_t nb_pkts, uint64_t tms);
+
 /*
  * Check if the IPv4 packet is fragmented
  *
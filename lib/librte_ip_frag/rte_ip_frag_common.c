@@ -33,6 +33,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <errno.h>
 
 #include <rte_memory.h>
 #include <rte_log.h>
@@ -41,6 +42,9 @@
 
 #define	IP_FRAG_HASH_FNUM	2
 
+/* number of mbufs to prefetch when flushing the death row internally */
+#define	IP_FRAG_DEATH_ROW_PREFETCH	3
+
 /* free mbufs from death row */
 void
 rte_ip_frag_free_death_row(struct rte_ip_frag_death_row *dr,
@@ -103,12 +107,34 @@ rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
 	tbl->nb_entries = (uint32_t)nb_entries;
 	tbl->nb_buckets = bucket_num;
 	tbl->bucket_entries = bucket_entries;
+	tbl->max_frags = IP_MAX_FRAG_NUM;
 	tbl->entry_mask = (tbl->nb_entries - 1) & ~(tbl->bucket_entries  - 1);
 
 	TAILQ_INIT(&(tbl->lru));
 	return tbl;
 }
 
+/* limit number of fragments per packet */
+int
+rte_ip_frag_table_max_frags_set(struct rte_ip_frag_tbl *tbl,
+	uint32_t max_frags)
+{
+	if (tbl == NULL || max_frags < IP_MIN_FRAG_NUM ||
+			max_frags > IP_MAX_FRAG_NUM)
+		return -EINVAL;
+
+	tbl->max_frags = max_frags;
+	return 0;
+}
+
+/* flush the death row if it can't take another burst of fragments */
+void
+ip_frag_death_row_reserve(struct rte_ip_frag_death_row *dr, uint32_t nb_pkts)
+{
+	if (dr->cnt + nb_pkts * (IP_MAX_FRAG_NUM + 1) > RTE_DIM(dr->row))
+		rte_ip_frag_free_death_row(dr, IP_FRAG_DEATH_ROW_PREFETCH);
+}
+
 /* dump frag table statistics to file */
 void
 rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
@@ -207,3 +207,114 @@ rte_ipv4_fragment_packet(struct rte_mbuf *pkt_in,
 
 	return out_pkt_pos;
 }
+
+/*
+ * IPv4 burst fragmentation.
+ * Direct and indirect mbufs are bulk allocated for each packet and the
+ * fragment headers are built from a copy of the original header.
+ */
+uint16_t
+rte_ipv4_fragment_burst(struct rte_mbuf **pkts_in, uint16_t nb_pkts_in,
+	struct rte_mbuf **pkts_out, uint16_t nb_pkts_out, uint16_t *nb_frags,
+	uint16_t mtu_size,
+	struct rte_mempool *pool_direct,
+	struct rte_mempool *pool_indirect)
+{
+	struct rte_mbuf *ind[IP_FRAG_BULK_SEGS_MAX];
+	struct rte_mbuf *pkt, *in_seg, *out_pkt;
+	struct ipv4_hdr tmpl, *out_hdr;
+	uint32_t i, j, k, n, nb_segs, out_pos, in_seg_data_pos, more_in_segs;
+	uint16_t fragment_offset, flag_offset, frag_size;
+	int32_t ret;
+
+	frag_size = (uint16_t)(mtu_size - sizeof(struct ipv4_hdr));
+
+	/* Fragment size should be a multiply of 8. */
+	IP_FRAG_ASSERT((frag_size & IPV4_HDR_FO_MASK) == 0);
+
+	out_pos = 0;
+	for (i = 0; i != nb_pkts_in; i++) {
+
+		pkt = pkts_in[i];
+
+		/* Small enough, pass the packet through */
+		if (pkt->pkt_len <= mtu_size) {
+			if (unlikely(out_pos == nb_pkts_out))
+				break;
+			pkts_out[out_pos++] = pkt;
+			nb_frags[i] = 1;
+			continue;
+		}
+
+		/* Header template shared by all fragments of the packet */
+		rte_memcpy(&tmpl, rte_pktmbuf_mtod(pkt, struct ipv4_hdr *),
+			sizeof(tmpl));
+		flag_offset = rte_cpu_to_be_16(tmpl.fragment_offset);
+
+		/* If Don't Fragment flag is set */
+		if (unlikely((flag_offset & IPV4_HDR_DF_MASK) != 0))
+			break;
+
+		/* Check that pkts_out has room for all fragments */
+		n = ip_frag_count(pkt, sizeof(struct ipv4_hdr), frag_size,
+			&nb_segs);
+		if (unlikely(n > nb_pkts_out - out_pos))
+			break;
+
+		/* Too many segments to bulk allocate, do it one by one */
+		if (unlikely(nb_segs > RTE_DIM(ind))) {
+			ret = rte_ipv4_fragment_packet(pkt, pkts_out + out_pos,
+				(uint16_t)(nb_pkts_out - out_pos), mtu_size,
+				pool_direct, pool_indirect);
+			if (ret < 0)
+				break;
+			out_pos += ret;
+			nb_frags[i] = (uint16_t)ret;
+			continue;
+		}
+
+		/* Allocate direct and indirect buffers */
+		if (unlikely(rte_pktmbuf_alloc_bulk(pool_direct,
+				pkts_out + out_pos, n) != 0))
+			break;
+		if (unlikely(rte_pktmbuf_alloc_bulk(pool_indirect,
+				ind, nb_segs) != 0)) {
+			__free_fragments(pkts_out + out_pos, n);
+			break;
+		}
+
+		in_seg = pkt;
+		in_seg_data_pos = sizeof(struct ipv4_hdr);
+		fragment_offset = 0;
+		k = 0;
+
+		for (j = 0; j != n; j++) {
+			out_pkt = pkts_out[out_pos + j];
+
+			/* Reserve space for the IP header */
+			out_pkt->data_len = sizeof(struct ipv4_hdr);
+			out_pkt->pkt_len = sizeof(struct ipv4_hdr);
+
+			more_in_segs = ip_frag_attach(out_pkt, ind, &k,
+				&in_seg, &in_seg_data_pos, mtu_size);
+
+			/* Build the IP header */
+			out_hdr = rte_pktmbuf_mtod(out_pkt, struct ipv4_hdr *);
+
+			__fill_ipv4hdr_frag(out_hdr, &tmpl,
+			    (uint16_t)out_pkt->pkt_len,
+			    flag_offset, fragment_offset, more_in_segs);
+
+			fragment_offset = (uint16_t)(fragment_offset +
+			    out_pkt->pkt_len - sizeof(struct ipv4_hdr));
+
+			out_pkt->ol_flags |= PKT_TX_IP_CKSUM;
+			out_pkt->l3_len = sizeof(struct ipv4_hdr);
+		}
+
+		out_pos += n;
+		nb_frags[i] = (uint16_t)n;
+	}
+
+	return (uint16_t)i;
+}
@@ -151,7 +151,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		tbl->use_entries);
 
 	/* try to find/add entry into the fragment's table. */
-	if ((fp = ip_frag_find(tbl, dr, &key, tms)) == NULL) {
+	if ((fp = ip_frag_find(tbl, dr, &key, NULL, tms)) == NULL) {
 		IP_FRAG_MBUF2DR(dr, mb);
 		return NULL;
 	}
@@ -167,7 +167,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 
 	/* process the fragmented packet. */
-	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len, ip_flag);
+	mb = ip_frag_process(tbl, fp, dr, mb, ip_ofs, ip_len, ip_flag);
 	ip_frag_inuse(tbl, fp);
 
 	IP_FRAG_LOG(DEBUG, "%s:%d:\n"
@@ -182,3 +182,67 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Process a burst of mbufs with IPV4 fragments.
+ * Keys of the whole burst are hashed and the table buckets are
+ * prefetched before any of the fragments is looked up.
+ */
+uint16_t
+rte_ipv4_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+		uint16_t nb_pkts, uint64_t tms)
+{
+	struct ip_frag_burst_ent ent[IP_FRAG_BURST_SIZE];
+	struct ipv4_hdr *ip_hdr;
+	const unaligned_uint64_t *psd;
+	uint16_t i, j, k, n, nb_out;
+	uint16_t flag_offset;
+
+	nb_out = 0;
+	for (i = 0; i < nb_pkts; i += n) {
+
+		n = (uint16_t)RTE_MIN(nb_pkts - i, IP_FRAG_BURST_SIZE);
+		ip_frag_death_row_reserve(dr, n);
+
+		for (j = 0; j != n; j++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(mbufs[i + j],
+				void *, mbufs[i + j]->l2_len));
+
+		/* extract keys, hash them and prefetch the table buckets. */
+		for (j = 0; j != n; j++) {
+			ip_hdr = rte_pktmbuf_mtod_offset(mbufs[i + j],
+				struct ipv4_hdr *, mbufs[i + j]->l2_len);
+
+			if (rte_ipv4_frag_pkt_is_fragmented(ip_hdr) == 0) {
+				ent[j].key.key_len = 0;
+				continue;
+			}
+
+			flag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
+			ent[j].ofs = (uint16_t)((flag_offset &
+				IPV4_HDR_OFFSET_MASK) * IPV4_HDR_OFFSET_UNITS);
+			ent[j].more_frags = (uint16_t)(flag_offset &
+				IPV4_HDR_MF_FLAG);
+			ent[j].len = (uint16_t)(rte_be_to_cpu_16(
+				ip_hdr->total_length) - mbufs[i + j]->l3_len);
+
+			psd = (unaligned_uint64_t *)&ip_hdr->src_addr;
+			ent[j].key.src_dst[0] = psd[0];
+			ent[j].key.id = ip_hdr->packet_id;
+			ent[j].key.key_len = IPV4_KEYLEN;
+
+			ip_frag_hash(&ent[j].key, ent[j].sig);
+			ip_frag_prefetch(tbl, ent[j].sig);
+		}
+
+		k = ip_frag_process_burst(tbl, dr, mbufs + i, ent, n, tms);
+
+		/* compact the output at the beginning of the array. */
+		for (j = 0; j != k; j++)
+			mbufs[nb_out + j] = mbufs[i + j];
+		nb_out += k;
+	}
+
+	return nb_out;
+}
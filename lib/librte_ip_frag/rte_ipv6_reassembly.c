@@ -190,7 +190,7 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		tbl->use_entries);
 
 	/* try to find/add entry into the fragment's table. */
-	fp = ip_frag_find(tbl, dr, &key, tms);
+	fp = ip_frag_find(tbl, dr, &key, NULL, tms);
 	if (fp == NULL) {
 		IP_FRAG_MBUF2DR(dr, mb);
 		return NULL;
@@ -207,7 +207,7 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 
 	/* process the fragmented packet. */
-	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len,
+	mb = ip_frag_process(tbl, fp, dr, mb, ip_ofs, ip_len,
 			MORE_FRAGS(frag_hdr->frag_data));
 	ip_frag_inuse(tbl, fp);
 
@@ -223,3 +223,64 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Process a burst of mbufs with IPV6 fragments.
+ * Keys of the whole burst are hashed and the table buckets are
+ * prefetched before any of the fragments is looked up.
+ */
+uint16_t
+rte_ipv6_frag_reassemble_burst(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbufs,
+		uint16_t nb_pkts, uint64_t tms)
+{
+	struct ip_frag_burst_ent ent[IP_FRAG_BURST_SIZE];
+	struct ipv6_hdr *ip_hdr;
+	struct ipv6_extension_fragment *frag_hdr;
+	uint16_t i, j, k, n, nb_out;
+
+	nb_out = 0;
+	for (i = 0; i < nb_pkts; i += n) {
+
+		n = (uint16_t)RTE_MIN(nb_pkts - i, IP_FRAG_BURST_SIZE);
+		ip_frag_death_row_reserve(dr, n);
+
+		for (j = 0; j != n; j++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(mbufs[i + j],
+				void *, mbufs[i + j]->l2_len));
+
+		/* extract keys, hash them and prefetch the table buckets. */
+		for (j = 0; j != n; j++) {
+			ip_hdr = rte_pktmbuf_mtod_offset(mbufs[i + j],
+				struct ipv6_hdr *, mbufs[i + j]->l2_len);
+
+			frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(ip_hdr);
+			if (frag_hdr == NULL) {
+				ent[j].key.key_len = 0;
+				continue;
+			}
+
+			ent[j].ofs = (uint16_t)(FRAG_OFFSET(frag_hdr->frag_data) * 8);
+			ent[j].more_frags = MORE_FRAGS(frag_hdr->frag_data);
+			ent[j].len = (uint16_t)(rte_be_to_cpu_16(ip_hdr->payload_len) -
+				sizeof(*frag_hdr));
+
+			rte_memcpy(&ent[j].key.src_dst[0], ip_hdr->src_addr, 16);
+			rte_memcpy(&ent[j].key.src_dst[2], ip_hdr->dst_addr, 16);
+			ent[j].key.id = frag_hdr->id;
+			ent[j].key.key_len = IPV6_KEYLEN;
+
+			ip_frag_hash(&ent[j].key, ent[j].sig);
+			ip_frag_prefetch(tbl, ent[j].sig);
+		}
+
+		k = ip_frag_process_burst(tbl, dr, mbufs + i, ent, n, tms);
+
+		/* compact the output at the beginning of the array. */
+		for (j = 0; j != k; j++)
+			mbufs[nb_out + j] = mbufs[i + j];
+		nb_out += k;
+	}
+
+	return nb_out;
+}
@@ -0,0 +1,483 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_branch_prediction.h>
+#include <rte_cycles.h>
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_memzone.h>
+
+#include "rte_latencystats.h"
+
+/* Macros for printing using RTE_LOG */
+#define RTE_LOGTYPE_LATENCY_STATS RTE_LOGTYPE_USER1
+
+#define LATENCYSTATS_MZ_NAME "RTE_LATSTATS_%u"
+
+/* weight of the last sample in the jitter, as in RFC 3550 */
+#define LATENCYSTATS_JITTER_SHIFT 4
+
+/* attempts to read a queue while it is written */
+#define LATENCYSTATS_READ_RETRIES 1000000
+
+/*
+ * Statistics of a TX queue, shared with the secondary processes. They are
+ * written by the lcore transmitting on the queue only, which makes seq
+ * odd for the duration of each update, so that the readers can retry
+ * until they get a consistent copy.
+ */
+struct latency_queue {
+	volatile uint32_t seq;
+	volatile uint32_t reset_req;
+	uint32_t reset_done;
+	uint64_t samples;
+	uint64_t unstamped;
+	uint64_t cycles;
+	uint64_t min;
+	uint64_t max;
+	uint64_t last;
+	uint64_t jitter; /* scaled by 1 << LATENCYSTATS_JITTER_SHIFT */
+	uint64_t hist[RTE_LATENCYSTATS_HIST_SIZE];
+} __rte_cache_aligned;
+
+/* memzone of a port */
+struct latency_port {
+	uint64_t tsc_hz;
+	uint16_t nb_queues;
+	uint16_t max_queues;
+	volatile uint8_t enabled;
+	struct latency_queue queues[0];
+};
+
+/* callbacks added by the primary process */
+static struct latency_port_cbs {
+	void **rx;
+	void **tx;
+	uint16_t nb_rx;
+	uint16_t nb_tx;
+} latency_cbs[RTE_MAX_ETHPORTS];
+
+static void
+latency_queue_clear(struct latency_queue *q)
+{
+	q->samples = 0;
+	q->unstamped = 0;
+	q->cycles = 0;
+	q->min = UINT64_MAX;
+	q->max = 0;
+	q->last = 0;
+	q->jitter = 0;
+	memset(q->hist, 0, sizeof(q->hist));
+}
+
+static uint16_t
+latency_rx_cb(uint8_t port_id __rte_unused, uint16_t queue_id __rte_unused,
+	struct rte_mbuf **pkts, uint16_t nb_pkts, uint16_t max_pkts __rte_unused,
+	void *user_param __rte_unused)
+{
+	uint64_t now = rte_rdtsc();
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++) {
+		pkts[i]->timestamp = now;
+		pkts[i]->ol_flags |= PKT_RX_TIMESTAMP;
+	}
+
+	return nb_pkts;
+}
+
+static uint16_t
+latency_tx_cb(uint8_t port_id __rte_unused, uint16_t queue_id __rte_unused,
+	struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_param)
+{
+	struct latency_queue *q = user_param;
+	uint64_t now = rte_rdtsc();
+	uint64_t lat, diff, last, jitter;
+	uint16_t i;
+
+	q->seq++;
+	rte_smp_wmb();
+
+	if (unlikely(q->reset_done != q->reset_req)) {
+		q->reset_done = q->reset_req;
+		latency_queue_clear(q);
+	}
+
+	last = q->last;
+	jitter = q->jitter;
+
+	for (i = 0; i < nb_pkts; i++) {
+		struct rte_mbuf *m = pkts[i];
+
+		if (!(m->ol_flags & PKT_RX_TIMESTAMP)) {
+			q->unstamped++;
+			continue;
+		}
+		/* measured already, before the PMD refused it */
+		if (unlikely(m->timestamp == 0))
+			continue;
+
+		/* the TSC of another core may be slightly ahead */
+		lat = (now > m->timestamp) ? now - m->timestamp : 0;
+
+		if (q->samples != 0) {
+			diff = (lat > last) ? lat - last : last - lat;
+			jitter += diff - (jitter >> LATENCYSTATS_JITTER_SHIFT);
+		}
+		last = lat;
+
+		q->samples++;
+		q->cycles += lat;
+		if (lat < q->min)
+			q->min = lat;
+		if (lat > q->max)
+			q->max = lat;
+		q->hist[rte_latencystats_bucket(lat)]++;
+		m->timestamp = 0;
+	}
+
+	q->last = last;
+	q->jitter = jitter;
+
+	rte_smp_wmb();
+	q->seq++;
+
+	return nb_pkts;
+}
+
+static struct latency_port *
+latency_port_lookup(uint8_t port_id)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+
+	snprintf(name, sizeof(name), LATENCYSTATS_MZ_NAME, port_id);
+	mz = rte_memzone_lookup(name);
+
+	return (mz == NULL) ? NULL : mz->addr;
+}
+
+/*
+ * Reserve the memzone of a port, or reuse it. Secondary processes may be
+ * reading it at any time, so it is never freed: it is sized for the
+ * largest number of TX queues of the port.
+ */
+static struct latency_port *
+latency_port_reserve(uint8_t port_id, uint16_t nb_queues)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	struct rte_eth_dev_info dev_info;
+	const struct rte_memzone *mz;
+	struct latency_port *lp;
+	struct latency_queue *q;
+	uint16_t i, max_queues;
+
+	snprintf(name, sizeof(name), LATENCYSTATS_MZ_NAME, port_id);
+	mz = rte_memzone_lookup(name);
+	if (mz == NULL) {
+		rte_eth_dev_info_get(port_id, &dev_info);
+		max_queues = RTE_MAX(dev_info.max_tx_queues, nb_queues);
+		mz = rte_memzone_reserve(name, sizeof(*lp) +
+			max_queues * sizeof(struct latency_queue),
+			rte_eth_dev_socket_id(port_id), 0);
+		if (mz == NULL)
+			return NULL;
+		lp = mz->addr;
+		lp->max_queues = max_queues;
+	} else
+		lp = mz->addr;
+
+	if (nb_queues > lp->max_queues)
+		return NULL;
+
+	lp->tsc_hz = rte_get_tsc_hz();
+	for (i = 0; i < nb_queues; i++) {
+		q = &lp->queues[i];
+		q->seq++;
+		rte_smp_wmb();
+		q->reset_done = q->reset_req;
+		latency_queue_clear(q);
+		rte_smp_wmb();
+		q->seq++;
+	}
+	lp->nb_queues = nb_queues;
+
+	return lp;
+}
+
+static void
+latency_port_remove_cbs(uint8_t port_id, struct latency_port_cbs *cbs)
+{
+	uint16_t i;
+
+	/* the queues are not polled, the callbacks can be freed */
+	for (i = 0; i < cbs->nb_rx; i++)
+		if (cbs->rx[i] != NULL && rte_eth_remove_rx_callback(port_id,
+				i, cbs->rx[i]) == 0)
+			rte_free(cbs->rx[i]);
+	for (i = 0; i < cbs->nb_tx; i++)
+		if (cbs->tx[i] != NULL && rte_eth_remove_tx_callback(port_id,
+				i, cbs->tx[i]) == 0)
+			rte_free(cbs->tx[i]);
+
+	rte_free(cbs->rx);
+	memset(cbs, 0, sizeof(*cbs));
+}
+
+int
+rte_latencystats_enable(uint8_t port_id)
+{
+	struct latency_port_cbs *cbs;
+	struct latency_port *lp;
+	uint16_t nb_rx, nb_tx, i;
+	int ret;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return -EPERM;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	cbs = &latency_cbs[port_id];
+	if (cbs->rx != NULL)
+		return -EEXIST;
+
+	nb_rx = rte_eth_devices[port_id].data->nb_rx_queues;
+	nb_tx = rte_eth_devices[port_id].data->nb_tx_queues;
+	if (nb_rx == 0 || nb_tx == 0)
+		return -EINVAL;
+
+	lp = latency_port_reserve(port_id, nb_tx);
+	if (lp == NULL)
+		return -ENOMEM;
+
+	cbs->rx = rte_zmalloc("latencystats",
+		(nb_rx + nb_tx) * sizeof(cbs->rx[0]), 0);
+	if (cbs->rx == NULL)
+		return -ENOMEM;
+	cbs->tx = cbs->rx + nb_rx;
+	cbs->nb_rx = nb_rx;
+	cbs->nb_tx = nb_tx;
+
+	/* measure on TX before stamping on RX */
+	for (i = 0; i < nb_tx; i++) {
+		cbs->tx[i] = rte_eth_add_tx_callback(port_id, i,
+			latency_tx_cb, &lp->queues[i]);
+		if (cbs->tx[i] == NULL)
+			goto error;
+	}
+	for (i = 0; i < nb_rx; i++) {
+		cbs->rx[i] = rte_eth_add_rx_callback(port_id, i,
+			latency_rx_cb, NULL);
+		if (cbs->rx[i] == NULL)
+			goto error;
+	}
+
+	lp->enabled = 1;
+
+	return 0;
+
+error:
+	ret = -rte_errno;
+	RTE_LOG(ERR, LATENCY_STATS, "Cannot add callbacks on port %u: %s\n",
+		port_id, rte_strerror(rte_errno));
+	latency_port_remove_cbs(port_id, cbs);
+	return ret;
+}
+
+int
+rte_latencystats_disable(uint8_t port_id)
+{
+	struct latency_port *lp;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return -EPERM;
+
+	if (port_id >= RTE_MAX_ETHPORTS || latency_cbs[port_id].rx == NULL)
+		return -ENOENT;
+
+	latency_port_remove_cbs(port_id, &latency_cbs[port_id]);
+
+	lp = latency_port_lookup(port_id);
+	if (lp != NULL)
+		lp->enabled = 0;
+
+	return 0;
+}
+
+static uint64_t
+latency_cycles_to_ns(uint64_t cycles, uint64_t hz)
+{
+	return cycles / hz * NS_PER_S + cycles % hz * NS_PER_S / hz;
+}
+
+int
+rte_latencystats_get(uint8_t port_id, uint16_t queue_id,
+	struct rte_latencystats *stats)
+{
+	struct latency_port *lp;
+	struct latency_queue *q;
+	struct latency_queue copy;
+	uint64_t hz;
+	uint32_t seq, retries = 0;
+
+	if (stats == NULL)
+		return -EINVAL;
+
+	lp = latency_port_lookup(port_id);
+	if (lp == NULL)
+		return -ENOENT;
+	if (queue_id >= lp->nb_queues)
+		return -EINVAL;
+	q = &lp->queues[queue_id];
+
+	for (;;) {
+		seq = q->seq;
+		rte_smp_rmb();
+		memcpy(&copy, q, sizeof(copy));
+		rte_smp_rmb();
+		if (!(seq & 1) && seq == q->seq)
+			break;
+		if (++retries == LATENCYSTATS_READ_RETRIES)
+			return -EAGAIN;
+		rte_pause();
+	}
+
+	hz = lp->tsc_hz;
+	memset(stats, 0, sizeof(*stats));
+	stats->samples = copy.samples;
+	stats->unstamped = copy.unstamped;
+	stats->tsc_hz = hz;
+	if (copy.samples != 0) {
+		stats->min_ns = latency_cycles_to_ns(copy.min, hz);
+		stats->avg_ns = latency_cycles_to_ns(copy.cycles / copy.samples,
+			hz);
+		stats->max_ns = latency_cycles_to_ns(copy.max, hz);
+		stats->jitter_ns = latency_cycles_to_ns(
+			copy.jitter >> LATENCYSTATS_JITTER_SHIFT, hz);
+		memcpy(stats->hist, copy.hist, sizeof(stats->hist));
+	}
+
+	return 0;
+}
+
+int
+rte_latencystats_reset(uint8_t port_id, uint16_t queue_id)
+{
+	struct latency_port *lp;
+	struct latency_queue *q;
+
+	lp = latency_port_lookup(port_id);
+	if (lp == NULL)
+		return -ENOENT;
+	if (queue_id >= lp->nb_queues)
+		return -EINVAL;
+	q = &lp->queues[queue_id];
+
+	if (lp->enabled) {
+		q->reset_req++;
+	} else {
+		q->seq++;
+		rte_smp_wmb();
+		latency_queue_clear(q);
+		rte_smp_wmb();
+		q->seq++;
+	}
+
+	return 0;
+}
+
+uint16_t
+rte_latencystats_queue_count(uint8_t port_id)
+{
+	struct latency_port *lp = latency_port_lookup(port_id);
+
+	return (lp == NULL) ? 0 : lp->nb_queues;
+}
+
+uint64_t
+rte_latencystats_percentile(const struct rte_latencystats *stats,
+	double percentile)
+{
+	uint64_t n, n_target;
+	uint32_t i;
+
+	if (stats == NULL || stats->samples == 0 || stats->tsc_hz == 0)
+		return 0;
+
+	n_target = (uint64_t) (stats->samples * percentile / 100);
+	if (n_target >= stats->samples)
+		return stats->max_ns;
+
+	for (i = 0, n = 0; i < RTE_LATENCYSTATS_HIST_SIZE - 1; i++) {
+		n += stats->hist[i];
+		if (n > n_target)
+			return RTE_MIN(latency_cycles_to_ns(
+				rte_latencystats_bucket_min(i + 1) - 1,
+				stats->tsc_hz), stats->max_ns);
+	}
+
+	return stats->max_ns;
+}
+
+void
+rte_latencystats_dump(FILE *f, uint8_t port_id)
+{
+	struct rte_latencystats stats;
+	uint16_t i, nb_queues;
+
+	nb_queues = rte_latencystats_queue_count(port_id);
+	for (i = 0; i < nb_queues; i++) {
+		if (rte_latencystats_get(port_id, i, &stats) != 0)
+			continue;
+		fprintf(f, "port %u queue %u: samples=%" PRIu64
+			" unstamped=%" PRIu64 " min=%" PRIu64 "ns avg=%" PRIu64
+			"ns max=%" PRIu64 "ns jitter=%" PRIu64 "ns p50=%" PRIu64
+			"ns p99=%" PRIu64 "ns p99.9=%" PRIu64 "ns\n",
+			port_id, i, stats.samples, stats.unstamped,
+			stats.min_ns, stats.avg_ns, stats.max_ns,
+			stats.jitter_ns,
+			rte_latencystats_percentile(&stats, 50),
+			rte_latencystats_percentile(&stats, 99),
+			rte_latencystats_percentile(&stats, 99.9));
+	}
+}
@@ -0,0 +1,258 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_LATENCYSTATS_H_
+#define _RTE_LATENCYSTATS_H_
+
+/**
+ * @file
+ * RTE Latency Statistics
+ *
+ * The latency statistics library measures the time spent by the packets
+ * between their reception and their transmission on ethdev queues.
+ *
+ * Once enabled on a port, a RX callback stores the TSC value in the
+ * timestamp field of each received mbuf and sets PKT_RX_TIMESTAMP, and a
+ * TX callback computes the latency of the packets sent with that flag.
+ * The statistics are kept per TX queue in a memzone, written without lock
+ * by the lcore transmitting on the queue, and can be read at any time from
+ * the primary or a secondary process.
+ *
+ * The latency of a packet is measured when it is first passed to
+ * rte_eth_tx_burst(), before the PMD handles it. The TX callback then sets
+ * the timestamp of the packet to 0, so that a packet refused by the PMD
+ * and passed again is not measured twice.
+ *
+ * The callbacks are added and removed with the queues of the port not
+ * polled, so that they can be freed on removal (see
+ * rte_eth_remove_rx_callback()).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of buckets of the latency histograms. */
+#define RTE_LATENCYSTATS_HIST_SIZE 128
+
+/**
+ * Latency statistics of a TX queue.
+ *
+ * The histogram buckets count TSC cycles and have a logarithmic width:
+ * values below 4 have a bucket each, then each power of 2 is split in 4
+ * buckets, so that the relative error on a value is below 25%. The last
+ * bucket also counts the values above its range. See
+ * rte_latencystats_bucket().
+ */
+struct rte_latencystats {
+	/** Number of packets measured. */
+	uint64_t samples;
+
+	/** Number of packets sent without RX timestamp, not measured. */
+	uint64_t unstamped;
+
+	/** Lowest latency, in nanoseconds. */
+	uint64_t min_ns;
+
+	/** Average latency, in nanoseconds. */
+	uint64_t avg_ns;
+
+	/** Highest latency, in nanoseconds. */
+	uint64_t max_ns;
+
+	/** Smoothed difference of latency between consecutive packets, as
+	 * the interarrival jitter of RFC 3550, in nanoseconds. */
+	uint64_t jitter_ns;
+
+	/** TSC frequency, to convert the histogram buckets. */
+	uint64_t tsc_hz;
+
+	/** Number of packets per range of latency cycles. */
+	uint64_t hist[RTE_LATENCYSTATS_HIST_SIZE];
+};
+
+/**
+ * Histogram bucket of a latency.
+ *
+ * @param cycles
+ *   Latency, in TSC cycles.
+ * @return
+ *   Index of the bucket in the hist array of struct rte_latencystats.
+ */
+static inline uint32_t
+rte_latencystats_bucket(uint64_t cycles)
+{
+	uint32_t msb, bucket;
+
+	if (cycles < 4)
+		return (uint32_t) cycles;
+
+	msb = 63 - __builtin_clzll(cycles);
+	bucket = (msb - 1) * 4 + ((cycles >> (msb - 2)) & 3);
+
+	return (bucket < RTE_LATENCYSTATS_HIST_SIZE) ?
+		bucket : RTE_LATENCYSTATS_HIST_SIZE - 1;
+}
+
+/**
+ * Lowest latency counted by a histogram bucket.
+ *
+ * @param bucket
+ *   Index of the bucket in the hist array of struct rte_latencystats.
+ * @return
+ *   Lowest latency of the bucket, in TSC cycles.
+ */
+static inline uint64_t
+rte_latencystats_bucket_min(uint32_t bucket)
+{
+	if (bucket < 4)
+		return bucket;
+
+	return (uint64_t) (4 | (bucket & 3)) << (bucket / 4 - 1);
+}
+
+/**
+ * Enable the latency measurement on all the queues of a port.
+ *
+ * The port must be configured, and the callbacks are added to the queues
+ * known at this time. The statistics of the queues are cleared. This
+ * function must be called from the primary process, while no lcore polls
+ * the queues of the port, as the callbacks are freed if one of them
+ * cannot be added.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @return
+ *   - 0: Success.
+ *   - -ENODEV: Invalid port.
+ *   - -EINVAL: The port has no RX or TX queue.
+ *   - -EEXIST: The measurement is already enabled on the port.
+ *   - -EPERM: Called from a secondary process.
+ *   - -ENOMEM: Not enough memory.
+ *   - -ENOTSUP: RX/TX callbacks are not supported.
+ */
+int rte_latencystats_enable(uint8_t port_id);
+
+/**
+ * Disable the latency measurement on a port.
+ *
+ * The callbacks are removed from the queues and freed, and the statistics
+ * remain readable until the measurement is enabled again. This function
+ * must be called while no lcore polls the queues of the port, for instance
+ * once the forwarding lcores are stopped.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @return
+ *   0 on success, -ENOENT if the measurement is not enabled on the port,
+ *   -EPERM if called from a secondary process.
+ */
+int rte_latencystats_disable(uint8_t port_id);
+
+/**
+ * Read the latency statistics of a TX queue.
+ *
+ * This function does not block the lcore transmitting on the queue, and
+ * can be called from the primary or a secondary process.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @param queue_id
+ *   The TX queue identifier.
+ * @param stats
+ *   Statistics filled on success.
+ * @return
+ *   0 on success, -ENOENT if the measurement was never enabled on the port,
+ *   -EINVAL if the queue is not measured or stats is NULL.
+ */
+int rte_latencystats_get(uint8_t port_id, uint16_t queue_id,
+	struct rte_latencystats *stats);
+
+/**
+ * Clear the latency statistics of a TX queue.
+ *
+ * Since the statistics are only written by the lcore transmitting on the
+ * queue, they are cleared before it measures its next burst.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @param queue_id
+ *   The TX queue identifier.
+ * @return
+ *   0 on success, -ENOENT if the measurement was never enabled on the port,
+ *   -EINVAL if the queue is not measured.
+ */
+int rte_latencystats_reset(uint8_t port_id, uint16_t queue_id);
+
+/**
+ * Number of TX queues measured on a port.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @return
+ *   Number of queues, 0 if the measurement was never enabled on the port.
+ */
+uint16_t rte_latencystats_queue_count(uint8_t port_id);
+
+/**
+ * Latency percentile, estimated from the histogram.
+ *
+ * @param stats
+ *   Statistics read by rte_latencystats_get().
+ * @param percentile
+ *   Percentile, between 0 and 100.
+ * @return
+ *   Upper bound of the histogram bucket holding the percentile, limited
+ *   to the highest latency, in nanoseconds. 0 if no packet was measured.
+ */
+uint64_t rte_latencystats_percentile(const struct rte_latencystats *stats,
+	double percentile);
+
+/**
+ * Print the latency statistics of the queues of a port.
+ *
+ * @param f
+ *   Output stream.
+ * @param port_id
+ *   The port identifier.
+ */
+void rte_latencystats_dump(FILE *f, uint8_t port_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LATENCYSTATS_H_ */
@@ -56,6 +56,7 @@
 #include <rte_ring.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
+#include <rte_memcpy.h>
 #include <rte_string_fns.h>
 #include <rte_hexdump.h>
 #include <rte_errno.h>
@@ -186,7 +187,7 @@ rte_mbuf_sanity_check(const struct rte_mbuf *m, int is_header)
 	/* generic checks */
 	if (m->pool == NULL)
 		rte_panic("bad mbuf pool\n");
-	if (m->buf_physaddr == 0)
+	if (m->buf_physaddr == 0 && !RTE_MBUF_HAS_EXTBUF(m))
 		rte_panic("bad phys addr\n");
 	if (m->buf_addr == NULL)
 		rte_panic("bad virt addr\n");
@@ -241,6 +242,227 @@ rte_pktmbuf_dump(FILE *f, const struct rte_mbuf *m, unsigned dump_len)
 	}
 }
 
+/* read len data bytes in a mbuf at specified offset (internal) */
+const void *__rte_pktmbuf_read(const struct rte_mbuf *m, uint32_t off,
+	uint32_t len, void *buf)
+{
+	const struct rte_mbuf *seg = m;
+	uint32_t buf_off = 0, copy_len;
+
+	/* off + len may wrap */
+	if (off > rte_pktmbuf_pkt_len(m) ||
+			len > rte_pktmbuf_pkt_len(m) - off)
+		return NULL;
+
+	/* nothing to read, off may be the end of the last segment */
+	if (len == 0)
+		return buf;
+
+	while (off >= rte_pktmbuf_data_len(seg)) {
+		off -= rte_pktmbuf_data_len(seg);
+		seg = seg->next;
+	}
+
+	if (off + len <= rte_pktmbuf_data_len(seg))
+		return rte_pktmbuf_mtod_offset(seg, char *, off);
+
+	/* rare case: header is split among several segments */
+	while (len > 0) {
+		copy_len = rte_pktmbuf_data_len(seg) - off;
+		if (copy_len > len)
+			copy_len = len;
+		rte_memcpy((char *)buf + buf_off,
+			rte_pktmbuf_mtod_offset(seg, char *, off), copy_len);
+		off = 0;
+		buf_off += copy_len;
+		len -= copy_len;
+		seg = seg->next;
+	}
+
+	return buf;
+}
+
+/* write len bytes of a buffer in a mbuf at specified offset */
+int
+rte_pktmbuf_write(struct rte_mbuf *m, uint32_t off, uint32_t len,
+	const void *buf)
+{
+	struct rte_mbuf *seg = m;
+	uint32_t buf_off = 0, copy_len;
+	char *dst;
+
+	/* off + len may wrap */
+	if (off > rte_pktmbuf_pkt_len(m) ||
+			len > rte_pktmbuf_pkt_len(m) - off)
+		return -1;
+
+	/* nothing to write, off may be the end of the last segment */
+	if (len == 0)
+		return 0;
+
+	while (off >= rte_pktmbuf_data_len(seg)) {
+		off -= rte_pktmbuf_data_len(seg);
+		seg = seg->next;
+	}
+
+	while (len > 0) {
+		copy_len = rte_pktmbuf_data_len(seg) - off;
+		if (copy_len > len)
+			copy_len = len;
+		dst = rte_pktmbuf_mtod_offset(seg, char *, off);
+		/* data read in place by rte_pktmbuf_read() */
+		if (dst != (const char *)buf + buf_off)
+			rte_memcpy(dst, (const char *)buf + buf_off, copy_len);
+		off = 0;
+		buf_off += copy_len;
+		len -= copy_len;
+		seg = seg->next;
+	}
+
+	return 0;
+}
+
+/* number of mbufs copied per bulk allocation in rte_pktmbuf_compact_burst() */
+#define PKTMBUF_COMPACT_BURST 32
+
+/* copy the data and the metadata of a single-segment mbuf into another one */
+static inline void
+pktmbuf_compact_copy(struct rte_mbuf *md, const struct rte_mbuf *ms)
+{
+	md->port = ms->port;
+	md->ol_flags = ms->ol_flags;
+	md->packet_type = ms->packet_type;
+	md->vlan_tci = ms->vlan_tci;
+	md->vlan_tci_outer = ms->vlan_tci_outer;
+	md->hash = ms->hash;
+	md->seqn = ms->seqn;
+	md->udata64 = ms->udata64;
+	md->tx_offload = ms->tx_offload;
+	md->timesync = ms->timesync;
+	md->timestamp = ms->timestamp;
+	md->data_len = ms->data_len;
+	md->pkt_len = ms->pkt_len;
+	rte_memcpy(rte_pktmbuf_mtod(md, void *), rte_pktmbuf_mtod(ms, void *),
+		ms->data_len);
+}
+
+/* copy short packets into mbufs of a smaller pool */
+uint16_t
+rte_pktmbuf_compact_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	struct rte_mempool *mp)
+{
+	struct rte_mbuf *small[PKTMBUF_COMPACT_BURST];
+	uint16_t idx[PKTMBUF_COMPACT_BURST];
+	uint32_t max_len;
+	uint16_t i, j, n, nb_copied = 0;
+	struct rte_mbuf *m;
+
+	max_len = rte_pktmbuf_data_room_size(mp);
+	if (max_len <= RTE_PKTMBUF_HEADROOM)
+		return 0;
+	max_len -= RTE_PKTMBUF_HEADROOM;
+
+	i = 0;
+	while (i != nb_pkts) {
+		/* select the candidates of the next chunk */
+		for (n = 0; i != nb_pkts && n != PKTMBUF_COMPACT_BURST; i++) {
+			m = pkts[i];
+			if (m->pkt_len > max_len || m->nb_segs != 1 ||
+					m->pool == mp || !RTE_MBUF_DIRECT(m) ||
+					rte_mbuf_refcnt_read(m) != 1)
+				continue;
+			idx[n++] = i;
+		}
+		if (n == 0)
+			continue;
+
+		/* on allocation failure, the original mbufs are kept */
+		if (rte_pktmbuf_alloc_bulk(mp, small, n) != 0)
+			break;
+
+		for (j = 0; j != n; j++) {
+			m = pkts[idx[j]];
+			pktmbuf_compact_copy(small[j], m);
+			pkts[idx[j]] = small[j];
+			rte_pktmbuf_free_seg(m);
+		}
+		nb_copied += n;
+	}
+
+	return nb_copied;
+}
+
+/* maximum number of mbufs returned by one put in rte_pktmbuf_free_bulk() */
+#define PKTMBUF_FREE_BULK_SZ 64
+
+/* mbufs of the same mempool waiting to be put back in bulk */
+struct pktmbuf_free_batch {
+	struct rte_mempool *mp;
+	unsigned n;
+	void *objs[PKTMBUF_FREE_BULK_SZ];
+};
+
+static inline void
+pktmbuf_free_batch_flush(struct pktmbuf_free_batch *b)
+{
+	if (b->n != 0)
+		rte_mempool_put_bulk(b->mp, b->objs, b->n);
+	b->n = 0;
+}
+
+/* add an mbuf whose refcnt dropped to 0, flushing when the pool changes */
+static inline void
+pktmbuf_free_batch_add(struct pktmbuf_free_batch *b, struct rte_mbuf *m)
+{
+	RTE_MBUF_ASSERT(rte_mbuf_refcnt_read(m) == 0);
+
+	if (b->n == PKTMBUF_FREE_BULK_SZ || (b->n != 0 && m->pool != b->mp))
+		pktmbuf_free_batch_flush(b);
+	b->mp = m->pool;
+	b->objs[b->n++] = m;
+}
+
+/* free an array of packet mbufs, grouping the puts by mempool */
+void
+rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned count)
+{
+	struct pktmbuf_free_batch b;
+	struct rte_mbuf *m, *m_next, *md;
+	unsigned i;
+
+	b.mp = NULL;
+	b.n = 0;
+
+	for (i = 0; i != count; i++) {
+		m = mbufs[i];
+		if (m == NULL)
+			continue;
+
+		__rte_mbuf_sanity_check(m, 1);
+
+		for (; m != NULL; m = m_next) {
+			m_next = m->next;
+
+			/* no atomic operation when the segment is not shared */
+			if (rte_mbuf_refcnt_update(m, -1) != 0)
+				continue;
+
+			if (RTE_MBUF_INDIRECT(m)) {
+				md = rte_mbuf_from_indirect(m);
+				rte_pktmbuf_detach(m);
+				if (rte_mbuf_refcnt_update(md, -1) == 0)
+					pktmbuf_free_batch_add(&b, md);
+			} else if (RTE_MBUF_HAS_EXTBUF(m)) {
+				rte_pktmbuf_detach(m);
+			}
+			m->next = NULL;
+			pktmbuf_free_batch_add(&b, m);
+		}
+	}
+
+	pktmbuf_free_batch_flush(&b);
+}
+
 /*
  * Get the name of a RX offload flag. Must be kept synchronized with flag
  * definitions in rte_mbuf.h.
@@ -260,6 +482,7 @@ const char *rte_get_rx_ol_flag_name(uint64_t mask)
 	/* case PKT_RX_MAC_ERR: return "PKT_RX_MAC_ERR"; */
 	case PKT_RX_IEEE1588_PTP: return "PKT_RX_IEEE1588_PTP";
 	case PKT_RX_IEEE1588_TMST: return "PKT_RX_IEEE1588_TMST";
+	case PKT_RX_TIMESTAMP: return "PKT_RX_TIMESTAMP";
 	default: return NULL;
 	}
 }
@@ -278,6 +501,7 @@ const char *rte_get_tx_ol_flag_name(uint64_t mask)
 	case PKT_TX_UDP_CKSUM: return "PKT_TX_UDP_CKSUM";
 	case PKT_TX_IEEE1588_TMST: return "PKT_TX_IEEE1588_TMST";
 	case PKT_TX_TCP_SEG: return "PKT_TX_TCP_SEG";
+	case PKT_TX_UDP_SEG: return "PKT_TX_UDP_SEG";
 	case PKT_TX_IPV4: return "PKT_TX_IPV4";
 	case PKT_TX_IPV6: return "PKT_TX_IPV6";
 	case PKT_TX_OUTER_IP_CKSUM: return "PKT_TX_OUTER_IP_CKSUM";
@@ -94,10 +94,18 @@ extern "C" {
 #define PKT_RX_FDIR_ID       (1ULL << 13) /**< FD id reported if FDIR match. */
 #define PKT_RX_FDIR_FLX      (1ULL << 14) /**< Flexible bytes reported if FDIR match. */
 #define PKT_RX_QINQ_PKT      (1ULL << 15)  /**< RX packet with double VLAN stripped. */
+#define PKT_RX_TIMESTAMP     (1ULL << 16) /**< RX TSC timestamp in mbuf->timestamp. */
 /* add new RX flags here */
 
 /* add new TX flags here */
 
+/**
+ * UDP segmentation request. Set on a UDP datagram to have it split into
+ * IPv4 fragments of the maximum length given to the GSO library, with the
+ * PKT_TX_IPV4 flag and the l2_len and l3_len fields set.
+ */
+#define PKT_TX_UDP_SEG       (1ULL << 48)
+
 /**
  * Second VLAN insertion (QinQ) flag.
  */
@@ -188,7 +196,7 @@ extern "C" {
  */
 #define PKT_TX_OUTER_IPV6    (1ULL << 60)
 
-#define __RESERVED           (1ULL << 61) /**< reserved for future mbuf use */
+#define EXT_ATTACHED_MBUF    (1ULL << 61) /**< Mbuf attached to external buffer */
 
 #define IND_ATTACHED_MBUF    (1ULL << 62) /**< Indirect attached mbuf */
 
@@ -273,6 +281,23 @@ extern "C" {
  * <'ether type'=0x88CC>
  */
 #define RTE_PTYPE_L2_ETHER_LLDP             0x00000004
+/**
+ * VLAN tagged Ethernet packet type.
+ *
+ * Packet format:
+ * <'ether type'=0x8100
+ * | 'inner ether type'=[0x0800|0x86DD]>
+ */
+#define RTE_PTYPE_L2_ETHER_VLAN             0x00000006
+/**
+ * QinQ (double VLAN tagged) Ethernet packet type.
+ *
+ * Packet format:
+ * <'ether type'=0x88A8
+ * | 'inner ether type'=0x8100
+ * | 'inner ether type'=[0x0800|0x86DD]>
+ */
+#define RTE_PTYPE_L2_ETHER_QINQ             0x00000007
 /**
  * Mask of layer 2 packet types.
  * It is used for outer packet for tunneling cases.
@@ -724,6 +749,26 @@ typedef uint8_t  MARKER8[0];  /**< generic marker with 1B alignment */
 typedef uint64_t MARKER64[0]; /**< marker that allows us to overwrite 8 bytes
                                * with a single assignment */
 
+/**
+ * Function called to free an external buffer when its last reference
+ * is released.
+ */
+typedef void (*rte_mbuf_extbuf_free_callback_t)(void *addr, void *opaque);
+
+/**
+ * Shared data of an external buffer.
+ *
+ * It holds the reference counter of the buffer, shared by all the mbufs
+ * attached to it, and the callback used to free the buffer. It is
+ * usually stored at the end of the buffer itself, see
+ * rte_pktmbuf_ext_shinfo_init_helper().
+ */
+struct rte_mbuf_ext_shared_info {
+	rte_mbuf_extbuf_free_callback_t free_cb; /**< Free callback function */
+	void *fcb_opaque;             /**< Free callback argument */
+	rte_atomic16_t refcnt_atomic; /**< Atomically accessed refcnt */
+};
+
 /**
  * The generic rte_mbuf, containing a packet mbuf.
  */
@@ -840,6 +885,14 @@ struct rte_mbuf {
 
 	/** Timesync flags for use with IEEE1588. */
 	uint16_t timesync;
+
+	/** TSC value at reception, valid if PKT_RX_TIMESTAMP is set. See
+	 * rte_latencystats_enable(). */
+	uint64_t timestamp;
+
+	/** Shared data of the external buffer the mbuf is attached to, if
+	 * EXT_ATTACHED_MBUF is set. See rte_pktmbuf_attach_extbuf(). */
+	struct rte_mbuf_ext_shared_info *shinfo;
 } __rte_cache_aligned;
 
 static inline uint16_t rte_pktmbuf_priv_size(struct rte_mempool *mp);
@@ -911,10 +964,20 @@ rte_mbuf_to_baddr(struct rte_mbuf *md)
  */
 #define RTE_MBUF_INDIRECT(mb)   ((mb)->ol_flags & IND_ATTACHED_MBUF)
 
+/**
+ * Returns TRUE if given mbuf is attached to an external buffer, or FALSE
+ * otherwise.
+ */
+#define RTE_MBUF_HAS_EXTBUF(mb) ((mb)->ol_flags & EXT_ATTACHED_MBUF)
+
 /**
  * Returns TRUE if given mbuf is direct, or FALSE otherwise.
+ *
+ * A direct mbuf owns the data buffer embedded after its private area, it
+ * is neither indirect nor attached to an external buffer.
  */
-#define RTE_MBUF_DIRECT(mb)     (!RTE_MBUF_INDIRECT(mb))
+#define RTE_MBUF_DIRECT(mb) \
+	(!((mb)->ol_flags & (IND_ATTACHED_MBUF | EXT_ATTACHED_MBUF)))
 
 /**
  * Private data in case of pktmbuf pool.
@@ -1044,6 +1107,60 @@ rte_mbuf_refcnt_set(struct rte_mbuf *m, uint16_t new_value)
 
 #endif /* RTE_MBUF_REFCNT_ATOMIC */
 
+/**
+ * Reads the refcnt of an external buffer.
+ *
+ * @param shinfo
+ *   Shared data of the external buffer.
+ * @return
+ *   Reference count number.
+ */
+static inline uint16_t
+rte_mbuf_ext_refcnt_read(const struct rte_mbuf_ext_shared_info *shinfo)
+{
+	return (uint16_t)(rte_atomic16_read(&shinfo->refcnt_atomic));
+}
+
+/**
+ * Sets the refcnt of an external buffer.
+ *
+ * @param shinfo
+ *   Shared data of the external buffer.
+ * @param new_value
+ *   Value set
+ */
+static inline void
+rte_mbuf_ext_refcnt_set(struct rte_mbuf_ext_shared_info *shinfo,
+	uint16_t new_value)
+{
+	rte_atomic16_set(&shinfo->refcnt_atomic, new_value);
+}
+
+/**
+ * Adds given value to the refcnt of an external buffer and returns its
+ * new value.
+ *
+ * @param shinfo
+ *   Shared data of the external buffer.
+ * @param value
+ *   Value to add/subtract
+ * @return
+ *   Updated value
+ */
+static inline uint16_t
+rte_mbuf_ext_refcnt_update(struct rte_mbuf_ext_shared_info *shinfo,
+	int16_t value)
+{
+	/* same fast path as rte_mbuf_refcnt_update() for the sole owner */
+	if (likely(rte_mbuf_ext_refcnt_read(shinfo) == 1)) {
+		rte_mbuf_ext_refcnt_set(shinfo, 1 + value);
+		return 1 + value;
+	}
+
+	return (uint16_t)(rte_atomic16_add_return(&shinfo->refcnt_atomic,
+		value));
+}
+
 /** Mbuf prefetch */
 #define RTE_MBUF_PREFETCH_TO_FREE(m) do {       \
 	if ((m) != NULL)                        \
@@ -1412,11 +1529,103 @@ static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
 	return 0;
 }
 
+/**
+ * Initialize the shared data of an external buffer at its end.
+ *
+ * The shared data is stored in the tail of the buffer, aligned on a
+ * pointer size, and buf_len is reduced accordingly. Its refcnt is set to
+ * 1, for the first mbuf attached with rte_pktmbuf_attach_extbuf().
+ *
+ * @param buf_addr
+ *   The virtual address of the external buffer.
+ * @param buf_len
+ *   The length of the external buffer, updated to the length left for
+ *   the data.
+ * @param free_cb
+ *   The function called to free the buffer when its last reference is
+ *   released.
+ * @param fcb_opaque
+ *   The argument of the free callback.
+ * @return
+ *   - The pointer to the shared data on success.
+ *   - NULL if the buffer is too small.
+ */
+static inline struct rte_mbuf_ext_shared_info *
+rte_pktmbuf_ext_shinfo_init_helper(void *buf_addr, uint16_t *buf_len,
+	rte_mbuf_extbuf_free_callback_t free_cb, void *fcb_opaque)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+	void *buf_end = RTE_PTR_ADD(buf_addr, *buf_len);
+
+	if (*buf_len < sizeof(*shinfo) + sizeof(uintptr_t))
+		return NULL;
+
+	shinfo = (struct rte_mbuf_ext_shared_info *)RTE_PTR_ALIGN_FLOOR(
+		RTE_PTR_SUB(buf_end, sizeof(*shinfo)), sizeof(uintptr_t));
+	if ((void *)shinfo <= buf_addr)
+		return NULL;
+
+	shinfo->free_cb = free_cb;
+	shinfo->fcb_opaque = fcb_opaque;
+	rte_mbuf_ext_refcnt_set(shinfo, 1);
+
+	*buf_len = (uint16_t)RTE_PTR_DIFF(shinfo, buf_addr);
+	return shinfo;
+}
+
+/**
+ * Attach an external buffer to a packet mbuf.
+ *
+ * The mbuf then references the external buffer instead of its embedded
+ * data buffer, so memory owned by something else than a mempool can be
+ * carried in mbufs without copy. The reference counter of the buffer is
+ * held in the shared data, it is not incremented by this function: the
+ * caller gives one reference to the mbuf, as done by
+ * rte_pktmbuf_ext_shinfo_init_helper() for the first attachment.
+ * rte_pktmbuf_clone() and rte_pktmbuf_attach() share the buffer with
+ * other mbufs, and when the last of them is freed or detached, the free
+ * callback of the shared data is called.
+ *
+ * The data offset and length of the mbuf are reset to 0. The mbuf must
+ * be direct and not shared.
+ *
+ * @param m
+ *   The packet mbuf.
+ * @param buf_addr
+ *   The virtual address of the external buffer.
+ * @param buf_physaddr
+ *   The physical address of the external buffer, or 0 if it is not used
+ *   for DMA.
+ * @param buf_len
+ *   The length of the external buffer.
+ * @param shinfo
+ *   The shared data of the external buffer.
+ */
+static inline void
+rte_pktmbuf_attach_extbuf(struct rte_mbuf *m, void *buf_addr,
+	phys_addr_t buf_physaddr, uint16_t buf_len,
+	struct rte_mbuf_ext_shared_info *shinfo)
+{
+	RTE_MBUF_ASSERT(RTE_MBUF_DIRECT(m) && rte_mbuf_refcnt_read(m) == 1);
+	RTE_MBUF_ASSERT(shinfo->free_cb != NULL);
+
+	m->buf_addr = buf_addr;
+	m->buf_physaddr = buf_physaddr;
+	m->buf_len = buf_len;
+	m->data_off = 0;
+	m->data_len = 0;
+	m->ol_flags |= EXT_ATTACHED_MBUF;
+	m->shinfo = shinfo;
+}
+
 /**
  * Attach packet mbuf to another packet mbuf.
  *
  * After attachment we refer the mbuf we attached as 'indirect',
  * while mbuf we attached to as 'direct'.
+ * If m is attached to an external buffer, mi is attached to the same
+ * external buffer instead and the refcnt of its shared data is
+ * incremented.
  * Right now, not supported:
  *  - attachment for already indirect mbuf (e.g. - mi has to be direct).
  *  - mbuf we trying to attach (mi) is used by someone else
@@ -1434,14 +1643,22 @@ static inline void rte_pktmbuf_attach(struct rte_mbuf *mi, struct rte_mbuf *m)
 	RTE_MBUF_ASSERT(RTE_MBUF_DIRECT(mi) &&
 	    rte_mbuf_refcnt_read(mi) == 1);
 
-	/* if m is not direct, get the mbuf that embeds the data */
-	if (RTE_MBUF_DIRECT(m))
-		md = m;
-	else
-		md = rte_mbuf_from_indirect(m);
+	if (RTE_MBUF_HAS_EXTBUF(m)) {
+		rte_mbuf_ext_refcnt_update(m->shinfo, 1);
+		mi->ol_flags = m->ol_flags;
+		mi->shinfo = m->shinfo;
+	} else {
+		/* if m is not direct, get the mbuf that embeds the data */
+		if (RTE_MBUF_DIRECT(m))
+			md = m;
+		else
+			md = rte_mbuf_from_indirect(m);
+
+		rte_mbuf_refcnt_update(md, 1);
+		mi->priv_size = m->priv_size;
+		mi->ol_flags = m->ol_flags | IND_ATTACHED_MBUF;
+	}
 
-	rte_mbuf_refcnt_update(md, 1);
-	mi->priv_size = m->priv_size;
 	mi->buf_physaddr = m->buf_physaddr;
 	mi->buf_addr = m->buf_addr;
 	mi->buf_len = m->buf_len;
@@ -1454,11 +1671,11 @@ static inline void rte_pktmbuf_attach(struct rte_mbuf *mi, struct rte_mbuf *m)
 	mi->vlan_tci_outer = m->vlan_tci_outer;
 	mi->tx_offload = m->tx_offload;
 	mi->hash = m->hash;
+	mi->timestamp = m->timestamp;
 
 	mi->next = NULL;
 	mi->pkt_len = mi->data_len;
 	mi->nb_segs = 1;
-	mi->ol_flags = m->ol_flags | IND_ATTACHED_MBUF;
 	mi->packet_type = m->packet_type;
 
 	__rte_mbuf_sanity_check(mi, 1);
@@ -1468,6 +1685,8 @@ static inline void rte_pktmbuf_attach(struct rte_mbuf *mi, struct rte_mbuf *m)
 /**
  * Detach an indirect packet mbuf.
  *
+ *  - release the reference to the external buffer, if any. Its free
+ *    callback is called if this was the last reference.
  *  - restore original mbuf address and length values.
  *  - reset pktmbuf data and data_len to their default values.
  *  All other fields of the given packet mbuf will be left intact.
@@ -1478,8 +1697,15 @@ static inline void rte_pktmbuf_attach(struct rte_mbuf *mi, struct rte_mbuf *m)
 static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 {
 	struct rte_mempool *mp = m->pool;
+	struct rte_mbuf_ext_shared_info *shinfo;
 	uint32_t mbuf_size, buf_len, priv_size;
 
+	if (RTE_MBUF_HAS_EXTBUF(m)) {
+		shinfo = m->shinfo;
+		if (rte_mbuf_ext_refcnt_update(shinfo, -1) == 0)
+			shinfo->free_cb(m->buf_addr, shinfo->fcb_opaque);
+	}
+
 	priv_size = rte_pktmbuf_priv_size(mp);
 	mbuf_size = sizeof(struct rte_mbuf) + priv_size;
 	buf_len = rte_pktmbuf_data_room_size(mp);
@@ -1509,6 +1735,9 @@ __rte_pktmbuf_prefree_seg(struct rte_mbuf *m)
 			rte_pktmbuf_detach(m);
 			if (rte_mbuf_refcnt_update(md, -1) == 0)
 				__rte_mbuf_raw_free(md);
+		} else if (RTE_MBUF_HAS_EXTBUF(m)) {
+			/* release the external buffer */
+			rte_pktmbuf_detach(m);
 		}
 		return m;
 	}
@@ -1555,6 +1784,21 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
 	}
 }
 
+/**
+ * Free an array of packet mbufs back into their original mempools.
+ *
+ * This is equivalent to calling rte_pktmbuf_free() on each mbuf of the
+ * array, but the segments released to consecutive mbufs of the same
+ * mempool are returned with a single rte_mempool_put_bulk(). Chained,
+ * indirect and shared mbufs are handled, NULL entries are skipped.
+ *
+ * @param mbufs
+ *   Array of pointers to packet mbufs.
+ * @param count
+ *   Array size.
+ */
+void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned count);
+
 /**
  * Creates a "clone" of the given packet mbuf.
  *
@@ -1919,6 +2163,96 @@ static inline int rte_pktmbuf_chain(struct rte_mbuf *head, struct rte_mbuf *tail
 	return 0;
 }
 
+/**
+ * @internal used by rte_pktmbuf_read().
+ */
+const void *__rte_pktmbuf_read(const struct rte_mbuf *m, uint32_t off,
+	uint32_t len, void *buf);
+
+/**
+ * Read len data bytes in a mbuf at specified offset.
+ *
+ * If the data is contiguous, return the pointer in the mbuf data, else
+ * copy the data in the buffer provided by the user and return its
+ * pointer.
+ *
+ * @param m
+ *   The pointer to the mbuf.
+ * @param off
+ *   The offset of the data in the mbuf.
+ * @param len
+ *   The amount of bytes to read.
+ * @param buf
+ *   The buffer where data is copied if it is not contiguous in mbuf
+ *   data. Its length should be at least equal to the len parameter.
+ * @return
+ *   The pointer to the data, either in the mbuf if it is contiguous,
+ *   or in the user buffer. If mbuf is too small, NULL is returned.
+ */
+static inline const void *rte_pktmbuf_read(const struct rte_mbuf *m,
+	uint32_t off, uint32_t len, void *buf)
+{
+	if (likely(off <= rte_pktmbuf_data_len(m) &&
+			len <= rte_pktmbuf_data_len(m) - off))
+		return rte_pktmbuf_mtod_offset(m, char *, off);
+	else
+		return __rte_pktmbuf_read(m, off, len, buf);
+}
+
+/**
+ * Write len bytes of a buffer in a mbuf at specified offset.
+ *
+ * The data is copied across the segments of the mbuf as needed, the
+ * length of the mbuf is not modified. This is the counterpart of
+ * rte_pktmbuf_read(): nothing is copied if buf already points to the
+ * mbuf data at the given offset.
+ *
+ * @param m
+ *   The pointer to the mbuf.
+ * @param off
+ *   The offset of the data in the mbuf.
+ * @param len
+ *   The amount of bytes to write.
+ * @param buf
+ *   The buffer to copy the data from.
+ * @return
+ *   - 0: On success.
+ *   - -1: If the mbuf is too small.
+ */
+int rte_pktmbuf_write(struct rte_mbuf *m, uint32_t off, uint32_t len,
+	const void *buf);
+
+/**
+ * Copy short packets of a burst into mbufs allocated from a smaller pool.
+ *
+ * Every packet of the burst whose data fits in the data room of the
+ * mbufs of mp (minus RTE_PKTMBUF_HEADROOM) is copied, along with its
+ * metadata, into a newly allocated mbuf of mp. The original mbuf is then
+ * freed back to its own pool and replaced in the pkts array, so the order
+ * of the burst is preserved.
+ *
+ * This lets an application receive in large buffers and keep only
+ * compact mbufs for small packets that are held for a long time (in
+ * reassembly or reorder buffers, queues, ...), reducing the memory and
+ * cache footprint of the pools. It is typically installed as a RX
+ * callback, see rte_eth_add_rx_compact_callback().
+ *
+ * Only direct, single-segment, non-shared mbufs are copied. The private
+ * area of the mbufs is not copied. If the allocation from mp fails, the
+ * remaining packets are left untouched.
+ *
+ * @param pkts
+ *   The burst of packets, updated in place.
+ * @param nb_pkts
+ *   The number of packets in the burst.
+ * @param mp
+ *   The mempool of small mbufs, created with rte_pktmbuf_pool_create().
+ * @return
+ *   The number of packets that were copied.
+ */
+uint16_t rte_pktmbuf_compact_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	struct rte_mempool *mp);
+
 /**
  * Dump an mbuf structure to the console.
  *
@@ -728,6 +728,19 @@ rte_dom0_mempool_create(const char *name, unsigned n, unsigned elt_size,
 		rte_mempool_obj_ctor_t *obj_init, void *obj_init_arg,
 		int socket_id, unsigned flags);
 
+/**
+ * Free a mempool.
+ *
+ * Unlink the mempool from the global list and free the ring and the memory
+ * zone allocated by rte_mempool_create() or rte_mempool_xmem_create(). All
+ * the objects must have been returned to the pool and nothing may use the
+ * pool afterwards. The external memory given to rte_mempool_xmem_create()
+ * is left to the caller.
+ *
+ * @param mp
+ *   A pointer to the mempool structure. If NULL, the function does nothing.
+ */
+void rte_mempool_free(struct rte_mempool *mp);
 
 /**
  * Dump the status of the mempool to the console.
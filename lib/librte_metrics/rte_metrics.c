@@ -0,0 +1,280 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_atomic.h>
+#include <rte_eal.h>
+#include <rte_memory.h>
+#include <rte_memzone.h>
+#include <rte_spinlock.h>
+
+#include "rte_metrics.h"
+
+#define METRICS_MZ_NAME "RTE_METRICS"
+
+#if RTE_METRICS_MAX_METRICS > UINT16_MAX
+#error "RTE_METRICS_MAX_METRICS must fit in the 16-bit hash entries"
+#endif
+
+/* open addressing table of the names, kept half empty */
+#define METRICS_HASH_SIZE (RTE_METRICS_MAX_METRICS * 2)
+
+/*
+ * Metrics shared by all processes. The registration is serialized by the
+ * lock, and publishes a name in the hash table and in nb_metrics only
+ * once it is written, so that the lookups and the readers need no lock.
+ */
+struct metrics_shared {
+	rte_spinlock_t lock;
+	volatile uint32_t nb_metrics;
+	volatile uint16_t hash[METRICS_HASH_SIZE]; /* id + 1, 0 if free */
+	struct rte_metric_name names[RTE_METRICS_MAX_METRICS];
+	volatile uint64_t values[RTE_METRICS_MAX_METRICS];
+};
+
+static struct metrics_shared *metrics;
+
+static struct metrics_shared *
+metrics_get(int create)
+{
+	const struct rte_memzone *mz;
+
+	if (metrics != NULL)
+		return metrics;
+
+	mz = rte_memzone_lookup(METRICS_MZ_NAME);
+	if (mz != NULL)
+		metrics = mz->addr;
+	else if (create)
+		rte_metrics_init(SOCKET_ID_ANY);
+
+	return metrics;
+}
+
+int
+rte_metrics_init(int socket_id)
+{
+	const struct rte_memzone *mz;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return -EPERM;
+
+	if (metrics_get(0) != NULL)
+		return 0;
+
+	mz = rte_memzone_reserve(METRICS_MZ_NAME,
+		sizeof(struct metrics_shared), socket_id, 0);
+	if (mz == NULL)
+		return -ENOMEM;
+
+	memset(mz->addr, 0, sizeof(struct metrics_shared));
+	rte_spinlock_init(&((struct metrics_shared *)mz->addr)->lock);
+	metrics = mz->addr;
+
+	return 0;
+}
+
+/* FNV-1a */
+static uint32_t
+metrics_hash(const char *name)
+{
+	uint32_t h = 2166136261U;
+
+	while (*name != '\0') {
+		h ^= (uint8_t) *name++;
+		h *= 16777619U;
+	}
+
+	return h;
+}
+
+static int
+metrics_lookup(const struct metrics_shared *m, const char *name, uint32_t h)
+{
+	uint32_t i = h % METRICS_HASH_SIZE;
+	uint16_t entry;
+
+	while ((entry = m->hash[i]) != 0) {
+		if (strcmp(m->names[entry - 1].name, name) == 0)
+			return entry - 1;
+		i = (i + 1) % METRICS_HASH_SIZE;
+	}
+
+	return -1;
+}
+
+/* names are written in line-oriented outputs */
+static int
+metrics_name_valid(const char *name)
+{
+	size_t i;
+
+	if (name == NULL || name[0] == '\0')
+		return 0;
+
+	for (i = 0; name[i] != '\0'; i++)
+		if (i == RTE_METRICS_NAME_SIZE - 1 || !isgraph(name[i]))
+			return 0;
+
+	return 1;
+}
+
+int
+rte_metrics_reg_name(const char *name)
+{
+	struct metrics_shared *m;
+	uint32_t h, i;
+	int id;
+
+	m = metrics_get(1);
+	if (m == NULL)
+		return -ENOENT;
+	if (!metrics_name_valid(name))
+		return -EINVAL;
+
+	h = metrics_hash(name);
+	id = metrics_lookup(m, name, h);
+	if (id >= 0)
+		return id;
+
+	rte_spinlock_lock(&m->lock);
+
+	id = metrics_lookup(m, name, h);
+	if (id < 0 && m->nb_metrics == RTE_METRICS_MAX_METRICS)
+		id = -ENOSPC;
+	else if (id < 0) {
+		id = m->nb_metrics;
+		strcpy(m->names[id].name, name);
+		m->values[id] = 0;
+		rte_smp_wmb();
+
+		for (i = h % METRICS_HASH_SIZE; m->hash[i] != 0;
+				i = (i + 1) % METRICS_HASH_SIZE)
+			;
+		m->hash[i] = id + 1;
+		m->nb_metrics = id + 1;
+	}
+
+	rte_spinlock_unlock(&m->lock);
+
+	return id;
+}
+
+int
+rte_metrics_reg_names(const char * const *names, int *ids, uint16_t count)
+{
+	uint16_t i;
+
+	if (names == NULL || ids == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		ids[i] = rte_metrics_reg_name(names[i]);
+		if (ids[i] < 0)
+			return ids[i];
+	}
+
+	return 0;
+}
+
+int
+rte_metrics_update_value(int id, uint64_t value)
+{
+	struct metrics_shared *m = metrics_get(0);
+
+	if (m == NULL)
+		return -ENOENT;
+	if (id < 0 || (uint32_t) id >= m->nb_metrics)
+		return -EINVAL;
+
+	m->values[id] = value;
+
+	return 0;
+}
+
+int
+rte_metrics_update_values(const int *ids, const uint64_t *values,
+	uint16_t count)
+{
+	uint16_t i;
+	int ret;
+
+	if (ids == NULL || values == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		ret = rte_metrics_update_value(ids[i], values[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+int
+rte_metrics_get_names(struct rte_metric_name *names, uint16_t capacity)
+{
+	struct metrics_shared *m = metrics_get(0);
+	uint32_t n;
+
+	if (m == NULL)
+		return -ENOENT;
+
+	n = m->nb_metrics;
+	rte_smp_rmb();
+	if (names != NULL)
+		memcpy(names, m->names, RTE_MIN(n, capacity) * sizeof(*names));
+
+	return n;
+}
+
+int
+rte_metrics_get_values(uint64_t *values, uint16_t capacity)
+{
+	struct metrics_shared *m = metrics_get(0);
+	uint32_t i, n;
+
+	if (m == NULL)
+		return -ENOENT;
+
+	n = m->nb_metrics;
+	if (values != NULL)
+		for (i = 0; i < RTE_MIN(n, capacity); i++)
+			values[i] = m->values[i];
+
+	return n;
+}
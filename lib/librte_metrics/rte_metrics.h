@@ -0,0 +1,264 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_METRICS_H_
+#define _RTE_METRICS_H_
+
+/**
+ * @file
+ * RTE Metrics
+ *
+ * The metrics library keeps named 64-bit values in shared memory, so that
+ * a secondary process, such as dpdk_proc_info, can monitor the primary
+ * process without calling into it.
+ *
+ * The primary process registers the names once, then updates the values,
+ * usually from a control lcore or a service, at the rate it chooses. The
+ * values are read without lock: each of them should be updated by a
+ * single writer. Names cannot be unregistered, and registering a name
+ * again returns its existing identifier.
+ *
+ * Publishing helpers read the statistics of the ethdev ports, mempools,
+ * rings, job stats and hierarchical schedulers, and update the matching
+ * metrics, named after the object and the statistic with dots, such as
+ * "ethdev.0.rx_good_packets" or "ring.MP_mbuf_pool.count".
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct rte_mempool;
+struct rte_ring;
+struct rte_jobstats;
+struct rte_jobstats_context;
+struct rte_sched_port;
+
+/** Maximum length of a metric name, including the terminating '\0'. */
+#define RTE_METRICS_NAME_SIZE 64
+
+/** Name of a metric. */
+struct rte_metric_name {
+	char name[RTE_METRICS_NAME_SIZE];
+};
+
+/**
+ * Allocate the metrics in shared memory.
+ *
+ * This function is called implicitly by the first registration with
+ * SOCKET_ID_ANY. The secondary processes do not need to call it.
+ *
+ * @param socket_id
+ *   Socket of the memory, or SOCKET_ID_ANY.
+ * @return
+ *   0 on success, -EPERM if called from a secondary process, -ENOMEM if
+ *   the memory cannot be allocated.
+ */
+int rte_metrics_init(int socket_id);
+
+/**
+ * Register a metric.
+ *
+ * @param name
+ *   Name of the metric, made of printable characters without space.
+ * @return
+ *   Identifier of the metric on success, which is the existing one if the
+ *   name was already registered. Otherwise a negative value:
+ *   - -EINVAL: Invalid name.
+ *   - -ENOSPC: RTE_METRICS_MAX_METRICS names are already registered.
+ *   - -ENOENT: The metrics are not allocated by the primary process.
+ */
+int rte_metrics_reg_name(const char *name);
+
+/**
+ * Register several metrics.
+ *
+ * @param names
+ *   Names of the metrics.
+ * @param ids
+ *   Array filled with the identifiers of the metrics.
+ * @param count
+ *   Number of metrics.
+ * @return
+ *   0 on success, a negative value as returned by rte_metrics_reg_name()
+ *   otherwise.
+ */
+int rte_metrics_reg_names(const char * const *names, int *ids,
+	uint16_t count);
+
+/**
+ * Update the value of a metric.
+ *
+ * @param id
+ *   Identifier of the metric.
+ * @param value
+ *   New value.
+ * @return
+ *   0 on success, -EINVAL if the metric is not registered, -ENOENT if the
+ *   metrics are not allocated.
+ */
+int rte_metrics_update_value(int id, uint64_t value);
+
+/**
+ * Update the values of several metrics.
+ *
+ * @param ids
+ *   Identifiers of the metrics.
+ * @param values
+ *   New values.
+ * @param count
+ *   Number of metrics.
+ * @return
+ *   0 on success, -EINVAL if a metric is not registered, -ENOENT if the
+ *   metrics are not allocated.
+ */
+int rte_metrics_update_values(const int *ids, const uint64_t *values,
+	uint16_t count);
+
+/**
+ * Get the names of the registered metrics, indexed by their identifier.
+ *
+ * @param names
+ *   Array filled with the names, or NULL to only get their number.
+ * @param capacity
+ *   Number of entries of the array.
+ * @return
+ *   Number of registered metrics, which may be higher than capacity, or
+ *   -ENOENT if the metrics are not allocated.
+ */
+int rte_metrics_get_names(struct rte_metric_name *names, uint16_t capacity);
+
+/**
+ * Get the values of the registered metrics, indexed by their identifier.
+ *
+ * @param values
+ *   Array filled with the values, or NULL to only get their number.
+ * @param capacity
+ *   Number of entries of the array.
+ * @return
+ *   Number of registered metrics, which may be higher than capacity, or
+ *   -ENOENT if the metrics are not allocated.
+ */
+int rte_metrics_get_values(uint64_t *values, uint16_t capacity);
+
+/**
+ * Publish the extended statistics of an ethdev port.
+ *
+ * The metrics are named "ethdev.<port_id>.<xstat name>".
+ *
+ * @param port_id
+ *   The port identifier.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_ethdev(uint8_t port_id);
+
+/**
+ * Publish the usage of a mempool.
+ *
+ * The metrics are named "mempool.<name>.avail", ".in_use" and
+ * ".cache_count", the latter being the number of objects held in the
+ * per-lcore caches.
+ *
+ * @param mp
+ *   The mempool.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_mempool(const struct rte_mempool *mp);
+
+/**
+ * Publish the fill level of a ring.
+ *
+ * The metrics are named "ring.<name>.count" and "ring.<name>.free".
+ *
+ * @param r
+ *   The ring.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_ring(const struct rte_ring *r);
+
+/**
+ * Publish the statistics of a job stats context.
+ *
+ * The metrics are named "jobstats.<name>.loop_cnt", ".job_exec_cnt",
+ * ".exec_time", ".min_exec_time", ".max_exec_time", ".management_time",
+ * ".min_management_time" and ".max_management_time", in TSC cycles.
+ *
+ * @param ctx
+ *   The job stats context.
+ * @param name
+ *   Name of the context in the metrics, such as its lcore.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_jobstats(const struct rte_jobstats_context *ctx,
+	const char *name);
+
+/**
+ * Publish the statistics of a job.
+ *
+ * The metrics are named "job.<job name>.period", ".exec_cnt",
+ * ".exec_time", ".min_exec_time" and ".max_exec_time", in TSC cycles.
+ *
+ * @param job
+ *   The job, which must have a name.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_job(const struct rte_jobstats *job);
+
+/**
+ * Publish the queue depths of a hierarchical scheduler port.
+ *
+ * The metrics are named "sched.<name>.<subport_id>.tc<tc>.qlen", and
+ * count the packets queued in each traffic class of each subport. The
+ * statistics of the scheduler are not cleared.
+ *
+ * @param port
+ *   The scheduler port.
+ * @param name
+ *   Name of the scheduler port in the metrics.
+ * @return
+ *   0 on success, a negative value otherwise.
+ */
+int rte_metrics_publish_sched(struct rte_sched_port *port, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_METRICS_H_ */
@@ -0,0 +1,274 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_ethdev.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#ifdef RTE_LIBRTE_JOBSTATS
+#include <rte_jobstats.h>
+#endif
+#ifdef RTE_LIBRTE_SCHED
+#include <rte_sched.h>
+#endif
+
+#include "rte_metrics.h"
+
+/* register the metric "<prefix>.<stat>" and set its value */
+static int
+metrics_publish(const char *prefix, const char *stat, uint64_t value)
+{
+	char name[RTE_METRICS_NAME_SIZE];
+	char *c;
+	int id;
+
+	if (snprintf(name, sizeof(name), "%s.%s", prefix, stat) >=
+			(int)sizeof(name))
+		return -EINVAL;
+	for (c = name; *c != '\0'; c++)
+		if (!isgraph(*c))
+			*c = '_';
+
+	id = rte_metrics_reg_name(name);
+	if (id < 0)
+		return id;
+
+	return rte_metrics_update_value(id, value);
+}
+
+int
+rte_metrics_publish_ethdev(uint8_t port_id)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	struct rte_eth_xstats *xstats;
+	int n, i, ret;
+
+	n = rte_eth_xstats_get(port_id, NULL, 0);
+	if (n < 0)
+		return n;
+
+	xstats = malloc(n * sizeof(xstats[0]));
+	if (xstats == NULL)
+		return -ENOMEM;
+
+	ret = rte_eth_xstats_get(port_id, xstats, n);
+	if (ret > n)
+		ret = -EAGAIN;
+	if (ret < 0)
+		goto out;
+
+	/* only the entries filled by the second call are valid */
+	n = ret;
+	snprintf(prefix, sizeof(prefix), "ethdev.%u", port_id);
+	for (i = 0; i < n; i++) {
+		ret = metrics_publish(prefix, xstats[i].name, xstats[i].value);
+		if (ret < 0)
+			break;
+	}
+
+out:
+	free(xstats);
+	return ret;
+}
+
+int
+rte_metrics_publish_mempool(const struct rte_mempool *mp)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	uint64_t avail, cache_count = 0;
+	int ret;
+
+	if (mp == NULL)
+		return -EINVAL;
+
+#if RTE_MEMPOOL_CACHE_MAX_SIZE > 0
+	if (mp->cache_size != 0) {
+		unsigned lcore_id;
+
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			cache_count += mp->local_cache[lcore_id].len;
+	}
+#endif
+	avail = rte_mempool_count(mp);
+
+	snprintf(prefix, sizeof(prefix), "mempool.%s", mp->name);
+	ret = metrics_publish(prefix, "avail", avail);
+	if (ret == 0)
+		ret = metrics_publish(prefix, "in_use", mp->size - avail);
+	if (ret == 0)
+		ret = metrics_publish(prefix, "cache_count", cache_count);
+
+	return ret;
+}
+
+int
+rte_metrics_publish_ring(const struct rte_ring *r)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	int ret;
+
+	if (r == NULL)
+		return -EINVAL;
+
+	snprintf(prefix, sizeof(prefix), "ring.%s", r->name);
+	ret = metrics_publish(prefix, "count", rte_ring_count(r));
+	if (ret == 0)
+		ret = metrics_publish(prefix, "free", rte_ring_free_count(r));
+
+	return ret;
+}
+
+#ifdef RTE_LIBRTE_JOBSTATS
+
+int
+rte_metrics_publish_jobstats(const struct rte_jobstats_context *ctx,
+	const char *name)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	const struct {
+		const char *stat;
+		uint64_t value;
+	} stats[] = {
+		{ "loop_cnt", ctx->loop_cnt },
+		{ "job_exec_cnt", ctx->job_exec_cnt },
+		{ "exec_time", ctx->exec_time },
+		{ "min_exec_time", ctx->min_exec_time },
+		{ "max_exec_time", ctx->max_exec_time },
+		{ "management_time", ctx->management_time },
+		{ "min_management_time", ctx->min_management_time },
+		{ "max_management_time", ctx->max_management_time },
+	};
+	unsigned i;
+	int ret = 0;
+
+	if (name == NULL)
+		return -EINVAL;
+
+	snprintf(prefix, sizeof(prefix), "jobstats.%s", name);
+	for (i = 0; i < RTE_DIM(stats) && ret == 0; i++)
+		ret = metrics_publish(prefix, stats[i].stat, stats[i].value);
+
+	return ret;
+}
+
+int
+rte_metrics_publish_job(const struct rte_jobstats *job)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	const struct {
+		const char *stat;
+		uint64_t value;
+	} stats[] = {
+		{ "period", job->period },
+		{ "exec_cnt", job->exec_cnt },
+		{ "exec_time", job->exec_time },
+		{ "min_exec_time", job->min_exec_time },
+		{ "max_exec_time", job->max_exec_time },
+	};
+	unsigned i;
+	int ret = 0;
+
+	if (job->name[0] == '\0')
+		return -EINVAL;
+
+	snprintf(prefix, sizeof(prefix), "job.%s", job->name);
+	for (i = 0; i < RTE_DIM(stats) && ret == 0; i++)
+		ret = metrics_publish(prefix, stats[i].stat, stats[i].value);
+
+	return ret;
+}
+
+#else
+
+int
+rte_metrics_publish_jobstats(
+	const struct rte_jobstats_context *ctx __rte_unused,
+	const char *name __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+int
+rte_metrics_publish_job(const struct rte_jobstats *job __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+#endif /* RTE_LIBRTE_JOBSTATS */
+
+#ifdef RTE_LIBRTE_SCHED
+
+int
+rte_metrics_publish_sched(struct rte_sched_port *port, const char *name)
+{
+	char prefix[RTE_METRICS_NAME_SIZE];
+	char stat[RTE_METRICS_NAME_SIZE];
+	uint32_t tc_qlen[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+	uint32_t subport_id, tc;
+	int ret;
+
+	if (port == NULL || name == NULL)
+		return -EINVAL;
+
+	snprintf(prefix, sizeof(prefix), "sched.%s", name);
+	for (subport_id = 0;
+			rte_sched_subport_read_qlen(port, subport_id, tc_qlen) == 0;
+			subport_id++) {
+		for (tc = 0; tc < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; tc++) {
+			snprintf(stat, sizeof(stat), "%u.tc%u.qlen",
+				subport_id, tc);
+			ret = metrics_publish(prefix, stat, tc_qlen[tc]);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	return (subport_id == 0) ? -EINVAL : 0;
+}
+
+#else
+
+int
+rte_metrics_publish_sched(struct rte_sched_port *port __rte_unused,
+	const char *name __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+#endif /* RTE_LIBRTE_SCHED */
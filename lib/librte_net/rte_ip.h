@@ -82,6 +82,9 @@
 
 #include <rte_byteorder.h>
 #include <rte_mbuf.h>
+#ifdef RTE_MACHINE_CPUFLAG_AVX2
+#include <rte_vect.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -151,6 +154,65 @@ struct ipv4_hdr {
 #define IS_IPV4_MCAST(x) \
 	((x) >= IPV4_MIN_MCAST && (x) <= IPV4_MAX_MCAST) /**< check if IPv4 address is multicast */
 
+#ifdef RTE_MACHINE_CPUFLAG_AVX2
+/** Minimum length of a buffer whose checksum is computed with AVX2. */
+#define RTE_RAW_CKSUM_AVX2_MIN_LEN 256
+
+/**
+ * @internal Sum the 16-bit words of a buffer with AVX2.
+ * Helper routine for the __rte_raw_cksum().
+ *
+ * @param buf
+ *   Pointer to the buffer.
+ * @param len
+ *   Length of the buffer, a multiple of 32 bytes.
+ * @param sum
+ *   Initial value of the sum.
+ * @return
+ *   sum += Sum of all words in the buffer, folded to 17 bits.
+ */
+static inline uint32_t
+__rte_raw_cksum_avx2(const void *buf, size_t len, uint32_t sum)
+{
+	const __m256i *p = (const __m256i *)buf;
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc_lo, acc_hi, v;
+	uint32_t lanes[8];
+	uint64_t total = sum;
+	size_t n, i;
+
+	while (len > 0) {
+		/* a 32-bit lane adds one word per loop, up to 0xffff loops */
+		n = len / sizeof(*p);
+		if (n > 0xffff)
+			n = 0xffff;
+		acc_lo = zero;
+		acc_hi = zero;
+		for (i = 0; i < n; i++) {
+			v = _mm256_loadu_si256(p + i);
+			acc_lo = _mm256_add_epi32(acc_lo,
+				_mm256_unpacklo_epi16(v, zero));
+			acc_hi = _mm256_add_epi32(acc_hi,
+				_mm256_unpackhi_epi16(v, zero));
+		}
+		p += n;
+		len -= n * sizeof(*p);
+
+		_mm256_storeu_si256((__m256i *)lanes, acc_lo);
+		for (i = 0; i < 8; i++)
+			total += lanes[i];
+		_mm256_storeu_si256((__m256i *)lanes, acc_hi);
+		for (i = 0; i < 8; i++)
+			total += lanes[i];
+	}
+
+	total = (total & 0xffffffff) + (total >> 32);
+	total = (total & 0xffff) + (total >> 16);
+	total = (total & 0xffff) + (total >> 16);
+	return (uint32_t)total;
+}
+#endif
+
 /**
  * @internal Calculate a sum of all words in the buffer.
  * Helper routine for the rte_raw_cksum().
@@ -170,7 +232,18 @@ __rte_raw_cksum(const void *buf, size_t len, uint32_t sum)
 	/* workaround gcc strict-aliasing warning */
 	uintptr_t ptr = (uintptr_t)buf;
 	typedef uint16_t __attribute__((__may_alias__)) u16_p;
-	const u16_p *u16 = (const u16_p *)ptr;
+	const u16_p *u16;
+
+#ifdef RTE_MACHINE_CPUFLAG_AVX2
+	if (len >= RTE_RAW_CKSUM_AVX2_MIN_LEN) {
+		size_t vlen = len & ~(size_t)31;
+
+		sum = __rte_raw_cksum_avx2(buf, vlen, sum);
+		ptr += vlen;
+		len -= vlen;
+	}
+#endif
+	u16 = (const u16_p *)ptr;
 
 	while (len >= (sizeof(*u16) * 4)) {
 		sum += u16[0];
@@ -0,0 +1,419 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_mbuf.h>
+#include <rte_prefetch.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_sctp.h>
+#include <rte_gre.h>
+
+#include "rte_net.h"
+
+/* maximum number of IPv6 extension headers skipped */
+#define IPV6_MAX_EXT_HDRS 5
+
+/* get the packet type of an IPv4 header from its length */
+static inline uint32_t
+ptype_l3_ipv4(const struct ipv4_hdr *ip4h)
+{
+	if ((ip4h->version_ihl & 0xf) == sizeof(*ip4h) / 4)
+		return RTE_PTYPE_L3_IPV4;
+	return RTE_PTYPE_L3_IPV4_EXT;
+}
+
+/* get the packet type of an inner IPv4 header from its length */
+static inline uint32_t
+ptype_inner_l3_ipv4(const struct ipv4_hdr *ip4h)
+{
+	if ((ip4h->version_ihl & 0xf) == sizeof(*ip4h) / 4)
+		return RTE_PTYPE_INNER_L3_IPV4;
+	return RTE_PTYPE_INNER_L3_IPV4_EXT;
+}
+
+/* get the L4 packet type of an IP protocol */
+static inline uint32_t
+ptype_l4(uint8_t proto)
+{
+	switch (proto) {
+	case IPPROTO_TCP:
+		return RTE_PTYPE_L4_TCP;
+	case IPPROTO_UDP:
+		return RTE_PTYPE_L4_UDP;
+	case IPPROTO_SCTP:
+		return RTE_PTYPE_L4_SCTP;
+	case IPPROTO_ICMP:
+	case IPPROTO_ICMPV6:
+		return RTE_PTYPE_L4_ICMP;
+	default:
+		return RTE_PTYPE_L4_NONFRAG;
+	}
+}
+
+/* the inner L4 packet types are the outer ones shifted */
+#define PTYPE_INNER_L4_SHIFT 16
+
+/*
+ * Skip the IPv6 extension headers at offset *off, and return the next
+ * protocol, or -1 if the headers are truncated. frag is set if a fragment
+ * header is found, ending the IPv6 headers.
+ */
+static int
+skip_ipv6_ext(const struct rte_mbuf *m, uint32_t *off, uint8_t proto,
+	int *frag)
+{
+	struct ext_hdr {
+		uint8_t next_hdr;
+		uint8_t len;
+	};
+	const struct ext_hdr *xh;
+	struct ext_hdr xh_copy;
+	unsigned i;
+
+	*frag = 0;
+	for (i = 0; i < IPV6_MAX_EXT_HDRS; i++) {
+		switch (proto) {
+		case IPPROTO_HOPOPTS:
+		case IPPROTO_ROUTING:
+		case IPPROTO_DSTOPTS:
+			xh = rte_pktmbuf_read(m, *off, sizeof(*xh), &xh_copy);
+			if (xh == NULL)
+				return -1;
+			*off += (xh->len + 1) * 8;
+			proto = xh->next_hdr;
+			break;
+		case IPPROTO_FRAGMENT:
+			xh = rte_pktmbuf_read(m, *off, sizeof(*xh), &xh_copy);
+			if (xh == NULL)
+				return -1;
+			*off += 8;
+			*frag = 1;
+			return xh->next_hdr;
+		default:
+			return proto;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Parse the IPv4 or IPv6 header of ethertype proto at offset *off, and
+ * get its L3 length and the next protocol. Return the L3 packet type, or
+ * 0 if the header is truncated or unknown. The L4_FRAG packet type is
+ * also returned for fragments, whose L4 header is not parsed.
+ */
+static uint32_t
+parse_l3(const struct rte_mbuf *m, uint32_t *off, uint16_t proto,
+	uint16_t *l3_len, uint8_t *next_proto, int inner)
+{
+	const struct ipv4_hdr *ip4h;
+	struct ipv4_hdr ip4h_copy;
+	const struct ipv6_hdr *ip6h;
+	struct ipv6_hdr ip6h_copy;
+	uint32_t pkt_type, start = *off;
+	int ret, frag;
+
+	if (proto == rte_cpu_to_be_16(ETHER_TYPE_IPv4)) {
+		ip4h = rte_pktmbuf_read(m, *off, sizeof(*ip4h), &ip4h_copy);
+		if (unlikely(ip4h == NULL))
+			return 0;
+		*l3_len = (ip4h->version_ihl & 0xf) * 4;
+		if (unlikely(*l3_len < sizeof(*ip4h)))
+			return 0;
+		*off += *l3_len;
+		*next_proto = ip4h->next_proto_id;
+		pkt_type = inner ? ptype_inner_l3_ipv4(ip4h) :
+			ptype_l3_ipv4(ip4h);
+		if (ip4h->fragment_offset & rte_cpu_to_be_16(
+				IPV4_HDR_MF_FLAG | IPV4_HDR_OFFSET_MASK))
+			pkt_type |= RTE_PTYPE_L4_FRAG;
+		return pkt_type;
+	}
+
+	if (proto == rte_cpu_to_be_16(ETHER_TYPE_IPv6)) {
+		ip6h = rte_pktmbuf_read(m, *off, sizeof(*ip6h), &ip6h_copy);
+		if (unlikely(ip6h == NULL))
+			return 0;
+		*off += sizeof(*ip6h);
+		ret = skip_ipv6_ext(m, off, ip6h->proto, &frag);
+		if (unlikely(ret < 0))
+			return 0;
+		*l3_len = *off - start;
+		*next_proto = ret;
+		if (*l3_len == sizeof(*ip6h))
+			pkt_type = inner ? RTE_PTYPE_INNER_L3_IPV6 :
+				RTE_PTYPE_L3_IPV6;
+		else
+			pkt_type = inner ? RTE_PTYPE_INNER_L3_IPV6_EXT :
+				RTE_PTYPE_L3_IPV6_EXT;
+		if (frag)
+			pkt_type |= RTE_PTYPE_L4_FRAG;
+		return pkt_type;
+	}
+
+	return 0;
+}
+
+/* get the length of the L4 header of protocol proto at offset off */
+static uint8_t
+parse_l4_len(const struct rte_mbuf *m, uint32_t off, uint8_t proto)
+{
+	const struct tcp_hdr *th;
+	struct tcp_hdr th_copy;
+
+	switch (proto) {
+	case IPPROTO_TCP:
+		th = rte_pktmbuf_read(m, off, sizeof(*th), &th_copy);
+		if (unlikely(th == NULL))
+			return 0;
+		return (th->data_off & 0xf0) >> 2;
+	case IPPROTO_UDP:
+		return sizeof(struct udp_hdr);
+	case IPPROTO_SCTP:
+		return sizeof(struct sctp_hdr);
+	default:
+		return 0;
+	}
+}
+
+/* parse the inner headers of a tunneled packet, from offset off */
+static uint32_t
+parse_inner(const struct rte_mbuf *m, uint32_t off, uint16_t proto,
+	struct rte_net_hdr_lens *hdr_lens, uint32_t layers)
+{
+	const struct ether_hdr *eh;
+	struct ether_hdr eh_copy;
+	const struct vlan_hdr *vh;
+	struct vlan_hdr vh_copy;
+	uint32_t pkt_type = 0, l3_type;
+	uint8_t next_proto;
+
+	if (proto == rte_cpu_to_be_16(ETHER_TYPE_TEB)) {
+		if ((layers & RTE_PTYPE_INNER_L2_MASK) == 0)
+			return 0;
+		eh = rte_pktmbuf_read(m, off, sizeof(*eh), &eh_copy);
+		if (unlikely(eh == NULL))
+			return 0;
+		pkt_type = RTE_PTYPE_INNER_L2_ETHER;
+		proto = eh->ether_type;
+		off += sizeof(*eh);
+		hdr_lens->inner_l2_len = sizeof(*eh);
+
+		if (proto == rte_cpu_to_be_16(ETHER_TYPE_VLAN)) {
+			vh = rte_pktmbuf_read(m, off, sizeof(*vh), &vh_copy);
+			if (unlikely(vh == NULL))
+				return pkt_type;
+			pkt_type = RTE_PTYPE_INNER_L2_ETHER_VLAN;
+			proto = vh->eth_proto;
+			off += sizeof(*vh);
+			hdr_lens->inner_l2_len += sizeof(*vh);
+		}
+	}
+
+	if ((layers & RTE_PTYPE_INNER_L3_MASK) == 0)
+		return pkt_type;
+	l3_type = parse_l3(m, &off, proto, &hdr_lens->inner_l3_len,
+		&next_proto, 1);
+	if (l3_type == 0)
+		return pkt_type;
+	pkt_type |= l3_type & RTE_PTYPE_INNER_L3_MASK;
+
+	if ((layers & RTE_PTYPE_INNER_L4_MASK) == 0)
+		return pkt_type;
+	if ((l3_type & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_FRAG)
+		return pkt_type | RTE_PTYPE_INNER_L4_FRAG;
+	hdr_lens->inner_l4_len = parse_l4_len(m, off, next_proto);
+	return pkt_type | (ptype_l4(next_proto) << PTYPE_INNER_L4_SHIFT);
+}
+
+/* get the length of a GRE header, and the protocol it carries */
+static uint8_t
+parse_gre(const struct rte_mbuf *m, uint32_t off, uint16_t *proto,
+	uint32_t *tunnel_type)
+{
+	const struct gre_hdr *gh;
+	struct gre_hdr gh_copy;
+	uint8_t len;
+
+	gh = rte_pktmbuf_read(m, off, sizeof(*gh), &gh_copy);
+	if (unlikely(gh == NULL) || gh->ver != 0)
+		return 0;
+
+	len = sizeof(*gh) + (gh->c + gh->k + gh->s) * 4;
+	*proto = gh->proto;
+	*tunnel_type = RTE_PTYPE_TUNNEL_GRE;
+	if (gh->k && *proto == rte_cpu_to_be_16(ETHER_TYPE_TEB))
+		*tunnel_type = RTE_PTYPE_TUNNEL_NVGRE;
+	return len;
+}
+
+uint32_t
+rte_net_get_ptype(const struct rte_mbuf *m,
+	struct rte_net_hdr_lens *hdr_lens, uint32_t layers)
+{
+	struct rte_net_hdr_lens local_hdr_lens;
+	const struct ether_hdr *eh;
+	struct ether_hdr eh_copy;
+	const struct vlan_hdr *vh;
+	struct vlan_hdr vh_copy[2];
+	const struct udp_hdr *uh;
+	struct udp_hdr uh_copy;
+	uint32_t pkt_type, l3_type, tunnel_type;
+	uint32_t off;
+	uint16_t proto;
+	uint8_t next_proto;
+
+	if (hdr_lens == NULL)
+		hdr_lens = &local_hdr_lens;
+	memset(hdr_lens, 0, sizeof(*hdr_lens));
+
+	if ((layers & RTE_PTYPE_L2_MASK) == 0)
+		return 0;
+	eh = rte_pktmbuf_read(m, 0, sizeof(*eh), &eh_copy);
+	if (unlikely(eh == NULL))
+		return 0;
+	pkt_type = RTE_PTYPE_L2_ETHER;
+	proto = eh->ether_type;
+	off = sizeof(*eh);
+
+	if (proto == rte_cpu_to_be_16(ETHER_TYPE_VLAN)) {
+		vh = rte_pktmbuf_read(m, off, sizeof(*vh), vh_copy);
+		if (unlikely(vh == NULL))
+			return pkt_type;
+		pkt_type = RTE_PTYPE_L2_ETHER_VLAN;
+		proto = vh->eth_proto;
+		off += sizeof(*vh);
+	} else if (proto == rte_cpu_to_be_16(ETHER_TYPE_QINQ)) {
+		vh = rte_pktmbuf_read(m, off, 2 * sizeof(*vh), vh_copy);
+		if (unlikely(vh == NULL))
+			return pkt_type;
+		pkt_type = RTE_PTYPE_L2_ETHER_QINQ;
+		proto = vh[1].eth_proto;
+		off += 2 * sizeof(*vh);
+	} else if (proto == rte_cpu_to_be_16(ETHER_TYPE_ARP)) {
+		pkt_type = RTE_PTYPE_L2_ETHER_ARP;
+	} else if (proto == rte_cpu_to_be_16(ETHER_TYPE_LLDP)) {
+		pkt_type = RTE_PTYPE_L2_ETHER_LLDP;
+	} else if (proto == rte_cpu_to_be_16(ETHER_TYPE_1588)) {
+		pkt_type = RTE_PTYPE_L2_ETHER_TIMESYNC;
+	}
+	hdr_lens->l2_len = off;
+
+	if ((layers & RTE_PTYPE_L3_MASK) == 0)
+		return pkt_type;
+	l3_type = parse_l3(m, &off, proto, &hdr_lens->l3_len, &next_proto,
+		0);
+	if (l3_type == 0)
+		return pkt_type;
+	pkt_type |= l3_type;
+
+	if ((layers & RTE_PTYPE_L4_MASK) == 0 ||
+			(l3_type & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_FRAG)
+		return pkt_type;
+
+	/* IP tunnels are described by their tunnel type only */
+	tunnel_type = 0;
+	switch (next_proto) {
+	case IPPROTO_GRE:
+		if ((layers & RTE_PTYPE_TUNNEL_MASK) == 0)
+			break;
+		hdr_lens->tunnel_len = parse_gre(m, off, &proto,
+			&tunnel_type);
+		if (hdr_lens->tunnel_len == 0)
+			return pkt_type;
+		off += hdr_lens->tunnel_len;
+		break;
+	case IPPROTO_IPIP:
+		proto = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+		tunnel_type = RTE_PTYPE_TUNNEL_IP;
+		break;
+	case IPPROTO_IPV6:
+		proto = rte_cpu_to_be_16(ETHER_TYPE_IPv6);
+		tunnel_type = RTE_PTYPE_TUNNEL_IP;
+		break;
+	}
+	if (tunnel_type != 0 && (layers & RTE_PTYPE_TUNNEL_MASK) != 0)
+		return pkt_type | tunnel_type |
+			parse_inner(m, off, proto, hdr_lens, layers);
+
+	pkt_type |= ptype_l4(next_proto);
+	hdr_lens->l4_len = parse_l4_len(m, off, next_proto);
+	if (next_proto != IPPROTO_UDP ||
+			(layers & RTE_PTYPE_TUNNEL_MASK) == 0)
+		return pkt_type;
+
+	uh = rte_pktmbuf_read(m, off, sizeof(*uh), &uh_copy);
+	if (unlikely(uh == NULL) ||
+			uh->dst_port != rte_cpu_to_be_16(
+				RTE_NET_VXLAN_DEFAULT_PORT))
+		return pkt_type;
+	off += sizeof(*uh) + sizeof(struct vxlan_hdr);
+	hdr_lens->tunnel_len = sizeof(struct vxlan_hdr);
+	return pkt_type | RTE_PTYPE_TUNNEL_VXLAN |
+		parse_inner(m, off, rte_cpu_to_be_16(ETHER_TYPE_TEB),
+			hdr_lens, layers);
+}
+
+void
+rte_net_get_ptype_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	uint32_t layers)
+{
+	struct rte_net_hdr_lens hdr_lens;
+	struct rte_mbuf *m;
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (i + 1 < nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1], void *));
+
+		m = pkts[i];
+		m->packet_type = rte_net_get_ptype(m, &hdr_lens, layers);
+		if (m->packet_type & RTE_PTYPE_TUNNEL_MASK) {
+			m->outer_l2_len = hdr_lens.l2_len;
+			m->outer_l3_len = hdr_lens.l3_len;
+			m->l2_len = hdr_lens.l4_len + hdr_lens.tunnel_len +
+				hdr_lens.inner_l2_len;
+			m->l3_len = hdr_lens.inner_l3_len;
+			m->l4_len = hdr_lens.inner_l4_len;
+		} else {
+			m->l2_len = hdr_lens.l2_len;
+			m->l3_len = hdr_lens.l3_len;
+			m->l4_len = hdr_lens.l4_len;
+		}
+	}
+}
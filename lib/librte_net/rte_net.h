@@ -0,0 +1,120 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_NET_H_
+#define _RTE_NET_H_
+
+/**
+ * @file
+ *
+ * Software packet type parser
+ *
+ * The packet type of the packets received by the PMDs that do not get it
+ * from the hardware, like the ring, pcap, af_packet or vhost PMDs, can be
+ * obtained by parsing their headers in software. The parser recognizes
+ * VLAN and QinQ tagged Ethernet frames, IPv4 and IPv6 with options or
+ * extension headers, TCP, UDP and SCTP, and VXLAN, GRE and IP in IP
+ * tunnels.
+ */
+
+#include <stdint.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default UDP destination port of the VXLAN packets. */
+#define RTE_NET_VXLAN_DEFAULT_PORT 4789
+
+/**
+ * Lengths of the headers of a packet.
+ */
+struct rte_net_hdr_lens {
+	uint8_t l2_len;        /**< Ethernet header, VLAN tags included. */
+	uint16_t l3_len;       /**< IP header, options included. */
+	uint8_t l4_len;        /**< L4 header, 0 for a tunnel but VXLAN. */
+	uint8_t tunnel_len;    /**< VXLAN or GRE header. */
+	uint8_t inner_l2_len;  /**< Inner Ethernet header, if any. */
+	uint16_t inner_l3_len; /**< Inner IP header. */
+	uint8_t inner_l4_len;  /**< Inner L4 header. */
+};
+
+/**
+ * Parse the headers of a packet to get its packet type.
+ *
+ * The headers may be split over several segments. Parsing stops at the
+ * first unknown or truncated header, the packet type only describing the
+ * headers parsed so far.
+ *
+ * @param m
+ *   The packet, starting with an Ethernet header.
+ * @param hdr_lens
+ *   If not NULL, receives the lengths of the headers parsed.
+ * @param layers
+ *   The layers to parse, as a mask of the RTE_PTYPE_*_MASK flags. Parsing
+ *   stops at the first layer not in the mask.
+ * @return
+ *   The packet type, as RTE_PTYPE_* flags.
+ */
+uint32_t rte_net_get_ptype(const struct rte_mbuf *m,
+	struct rte_net_hdr_lens *hdr_lens, uint32_t layers);
+
+/**
+ * Parse the headers of a burst of packets, setting their packet_type.
+ *
+ * The l2_len, l3_len and l4_len fields of the mbufs are set as well, with
+ * the TX offload conventions: for a tunneled packet, outer_l2_len and
+ * outer_l3_len describe the outer headers, l2_len covers the outer L4,
+ * the tunnel and the inner Ethernet headers, and l3_len and l4_len the
+ * inner headers.
+ *
+ * It can be called from a RX callback, registered with
+ * rte_eth_add_rx_callback(), to provide the packet type on the ports that
+ * do not support it.
+ *
+ * @param pkts
+ *   The burst of packets.
+ * @param nb_pkts
+ *   The number of packets.
+ * @param layers
+ *   The layers to parse, as a mask of the RTE_PTYPE_*_MASK flags.
+ */
+void rte_net_get_ptype_burst(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	uint32_t layers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_NET_H_ */
@@ -75,6 +75,33 @@
 
 #endif
 
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+
+#define RTE_PIPELINE_CYCLES_START(tsc)					\
+	({ (tsc) = rte_rdtsc(); })
+
+#define RTE_PIPELINE_CYCLES_STOP(tsc, c, n)				\
+	rte_pipeline_cycles_add(&(c), rte_rdtsc() - (tsc), (n))
+
+static inline void
+rte_pipeline_cycles_add(struct rte_pipeline_cycles *c, uint64_t cycles,
+	uint32_t n_pkts)
+{
+	c->n_bursts++;
+	c->n_pkts += n_pkts;
+	c->cycles += cycles;
+	if (cycles > c->cycles_max)
+		c->cycles_max = cycles;
+	c->hist[rte_pipeline_cycles_bucket(cycles)]++;
+}
+
+#else
+
+#define RTE_PIPELINE_CYCLES_START(tsc)
+#define RTE_PIPELINE_CYCLES_STOP(tsc, c, n)
+
+#endif
+
 struct rte_port_in {
 	/* Input parameters */
 	struct rte_port_in_ops ops;
@@ -93,6 +120,9 @@ struct rte_port_in {
 
 	/* Statistics */
 	uint64_t n_pkts_dropped_by_ah;
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	struct rte_pipeline_port_in_cycles cycles;
+#endif
 };
 
 struct rte_port_out {
@@ -128,6 +158,9 @@ struct rte_table {
 	uint64_t n_pkts_dropped_by_lkp_miss_ah;
 	uint64_t n_pkts_dropped_lkp_hit;
 	uint64_t n_pkts_dropped_lkp_miss;
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	struct rte_pipeline_table_cycles cycles;
+#endif
 };
 
 #define RTE_PIPELINE_MAX_NAME_SZ                           124
@@ -1345,17 +1378,22 @@ rte_pipeline_run(struct rte_pipeline *p)
 {
 	struct rte_port_in *port_in = p->port_in_next;
 	uint32_t n_pkts, table_id;
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	uint64_t tsc;
+#endif
 
 	if (port_in == NULL)
 		return 0;
 
 	/* Input port RX */
+	RTE_PIPELINE_CYCLES_START(tsc);
 	n_pkts = port_in->ops.f_rx(port_in->h_port, p->pkts,
 		port_in->burst_size);
 	if (n_pkts == 0) {
 		p->port_in_next = port_in->next;
 		return 0;
 	}
+	RTE_PIPELINE_CYCLES_STOP(tsc, port_in->cycles.rx, n_pkts);
 
 	p->pkts_mask = RTE_LEN2MASK(n_pkts, uint64_t);
 	p->action_mask0[RTE_PIPELINE_ACTION_DROP] = 0;
@@ -1365,7 +1403,9 @@ rte_pipeline_run(struct rte_pipeline *p)
 
 	/* Input port user actions */
 	if (port_in->f_action != NULL) {
+		RTE_PIPELINE_CYCLES_START(tsc);
 		port_in->f_action(p, p->pkts, n_pkts, port_in->arg_ah);
+		RTE_PIPELINE_CYCLES_STOP(tsc, port_in->cycles.ah, n_pkts);
 
 		RTE_PIPELINE_STATS_AH_DROP_READ(p,
 			port_in->n_pkts_dropped_by_ah);
@@ -1378,8 +1418,11 @@ rte_pipeline_run(struct rte_pipeline *p)
 
 		/* Lookup */
 		table = &p->tables[table_id];
+		RTE_PIPELINE_CYCLES_START(tsc);
 		table->ops.f_lookup(table->h_table, p->pkts, p->pkts_mask,
 			&lookup_hit_mask, (void **) p->entries);
+		RTE_PIPELINE_CYCLES_STOP(tsc, table->cycles.lookup,
+			__builtin_popcountll(p->pkts_mask));
 		lookup_miss_mask = p->pkts_mask & (~lookup_hit_mask);
 
 		/* Lookup miss */
@@ -1391,11 +1434,15 @@ rte_pipeline_run(struct rte_pipeline *p)
 
 			/* Table user actions */
 			if (table->f_action_miss != NULL) {
+				RTE_PIPELINE_CYCLES_START(tsc);
 				table->f_action_miss(p,
 					p->pkts,
 					lookup_miss_mask,
 					default_entry,
 					table->arg_ah);
+				RTE_PIPELINE_CYCLES_STOP(tsc,
+					table->cycles.lkp_miss_ah,
+					__builtin_popcountll(lookup_miss_mask));
 
 				RTE_PIPELINE_STATS_AH_DROP_READ(p,
 					table->n_pkts_dropped_by_lkp_miss_ah);
@@ -1425,11 +1472,15 @@ rte_pipeline_run(struct rte_pipeline *p)
 
 			/* Table user actions */
 			if (table->f_action_hit != NULL) {
+				RTE_PIPELINE_CYCLES_START(tsc);
 				table->f_action_hit(p,
 					p->pkts,
 					lookup_hit_mask,
 					p->entries,
 					table->arg_ah);
+				RTE_PIPELINE_CYCLES_STOP(tsc,
+					table->cycles.lkp_hit_ah,
+					__builtin_popcountll(lookup_hit_mask));
 
 				RTE_PIPELINE_STATS_AH_DROP_READ(p,
 					table->n_pkts_dropped_by_lkp_hit_ah);
@@ -1647,3 +1698,99 @@ int rte_pipeline_table_stats_read(struct rte_pipeline *p, uint32_t table_id,
 
 	return 0;
 }
+
+int rte_pipeline_port_in_cycles_read(struct rte_pipeline *p, uint32_t port_id,
+	struct rte_pipeline_port_in_cycles *cycles, int clear)
+{
+	struct rte_port_in *port;
+
+	if (p == NULL) {
+		RTE_LOG(ERR, PIPELINE, "%s: pipeline parameter NULL\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	if (port_id >= p->num_ports_in) {
+		RTE_LOG(ERR, PIPELINE,
+			"%s: port IN ID %u is out of range\n",
+			__func__, port_id);
+		return -EINVAL;
+	}
+
+	port = &p->ports_in[port_id];
+
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	if (cycles != NULL)
+		memcpy(cycles, &port->cycles, sizeof(*cycles));
+
+	if (clear != 0)
+		memset(&port->cycles, 0, sizeof(port->cycles));
+#else
+	RTE_SET_USED(port);
+	RTE_SET_USED(clear);
+
+	if (cycles != NULL)
+		memset(cycles, 0, sizeof(*cycles));
+#endif
+
+	return 0;
+}
+
+int rte_pipeline_table_cycles_read(struct rte_pipeline *p, uint32_t table_id,
+	struct rte_pipeline_table_cycles *cycles, int clear)
+{
+	struct rte_table *table;
+
+	if (p == NULL) {
+		RTE_LOG(ERR, PIPELINE, "%s: pipeline parameter NULL\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	if (table_id >= p->num_tables) {
+		RTE_LOG(ERR, PIPELINE,
+				"%s: table %u is out of range\n", __func__, table_id);
+		return -EINVAL;
+	}
+
+	table = &p->tables[table_id];
+
+#ifdef RTE_PIPELINE_CYCLES_COLLECT
+	if (cycles != NULL)
+		memcpy(cycles, &table->cycles, sizeof(*cycles));
+
+	if (clear != 0)
+		memset(&table->cycles, 0, sizeof(table->cycles));
+#else
+	RTE_SET_USED(table);
+	RTE_SET_USED(clear);
+
+	if (cycles != NULL)
+		memset(cycles, 0, sizeof(*cycles));
+#endif
+
+	return 0;
+}
+
+uint64_t rte_pipeline_cycles_percentile(const struct rte_pipeline_cycles *c,
+	double percentile)
+{
+	uint64_t n, n_target;
+	uint32_t i;
+
+	if ((c == NULL) || (c->n_bursts == 0))
+		return 0;
+
+	n_target = (uint64_t) (c->n_bursts * percentile / 100);
+	if (n_target >= c->n_bursts)
+		return c->cycles_max;
+
+	for (i = 0, n = 0; i < RTE_PIPELINE_CYCLES_HIST_SIZE - 1; i++) {
+		n += c->hist[i];
+		if (n > n_target)
+			return RTE_MIN(rte_pipeline_cycles_bucket_min(i + 1) - 1,
+				c->cycles_max);
+	}
+
+	return c->cycles_max;
+}
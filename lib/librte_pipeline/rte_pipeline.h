@@ -151,6 +151,111 @@ struct rte_pipeline_table_stats {
 	uint64_t n_pkts_dropped_lkp_miss;
 };
 
+/** Number of buckets of the cycle histograms. */
+#define RTE_PIPELINE_CYCLES_HIST_SIZE                      64
+
+/**
+ * TSC cycles spent by a pipeline stage, collected per burst when the
+ * library is built with RTE_PIPELINE_CYCLES_COLLECT.
+ *
+ * The histogram buckets have a logarithmic width: values below 4 have a
+ * bucket each, then each power of 2 is split in 4 buckets, so that the
+ * relative error on a value is below 25%. The last bucket also counts the
+ * values above its range. See rte_pipeline_cycles_bucket().
+ */
+struct rte_pipeline_cycles {
+	/** Number of bursts processed by the stage. */
+	uint64_t n_bursts;
+
+	/** Number of packets processed by the stage. */
+	uint64_t n_pkts;
+
+	/** Total number of cycles. */
+	uint64_t cycles;
+
+	/** Highest number of cycles for a burst. */
+	uint64_t cycles_max;
+
+	/** Number of bursts per range of cycles. */
+	uint64_t hist[RTE_PIPELINE_CYCLES_HIST_SIZE];
+};
+
+/** Pipeline port in cycles. */
+struct rte_pipeline_port_in_cycles {
+	/** Port RX, for bursts of at least one packet. */
+	struct rte_pipeline_cycles rx;
+
+	/** Port action handler. */
+	struct rte_pipeline_cycles ah;
+};
+
+/** Pipeline table cycles. */
+struct rte_pipeline_table_cycles {
+	/** Table lookup. */
+	struct rte_pipeline_cycles lookup;
+
+	/** Lookup hit action handler. */
+	struct rte_pipeline_cycles lkp_hit_ah;
+
+	/** Lookup miss action handler. */
+	struct rte_pipeline_cycles lkp_miss_ah;
+};
+
+/**
+ * Histogram bucket of a number of cycles.
+ *
+ * @param cycles
+ *   Number of cycles.
+ * @return
+ *   Index of the bucket in the hist array of struct rte_pipeline_cycles.
+ */
+static inline uint32_t
+rte_pipeline_cycles_bucket(uint64_t cycles)
+{
+	uint32_t msb, bucket;
+
+	if (cycles < 4)
+		return (uint32_t) cycles;
+
+	msb = 63 - __builtin_clzll(cycles);
+	bucket = (msb - 1) * 4 + ((cycles >> (msb - 2)) & 3);
+
+	return (bucket < RTE_PIPELINE_CYCLES_HIST_SIZE) ?
+		bucket : RTE_PIPELINE_CYCLES_HIST_SIZE - 1;
+}
+
+/**
+ * Lowest number of cycles counted by a histogram bucket.
+ *
+ * @param bucket
+ *   Index of the bucket in the hist array of struct rte_pipeline_cycles.
+ * @return
+ *   Lowest number of cycles of the bucket.
+ */
+static inline uint64_t
+rte_pipeline_cycles_bucket_min(uint32_t bucket)
+{
+	if (bucket < 4)
+		return bucket;
+
+	return (uint64_t) (4 | (bucket & 3)) << (bucket / 4 - 1);
+}
+
+/**
+ * Percentile of the cycles of a pipeline stage, estimated from its
+ * histogram.
+ *
+ * @param c
+ *   Cycles of the stage.
+ * @param percentile
+ *   Percentile, between 0 and 100.
+ * @return
+ *   Upper bound of the histogram bucket holding the percentile (the
+ *   highest value for the last bucket), 0 if no burst was measured.
+ */
+uint64_t rte_pipeline_cycles_percentile(const struct rte_pipeline_cycles *c,
+	double percentile);
+
 /**
  * Pipeline create
  *
@@ -555,6 +660,27 @@ int rte_pipeline_table_entry_delete_bulk(struct rte_pipeline *p,
 int rte_pipeline_table_stats_read(struct rte_pipeline *p, uint32_t table_id,
 	struct rte_pipeline_table_stats *stats, int clear);
 
+/**
+ * Read pipeline table cycles.
+ *
+ * This function reads the cycles spent in the table identified by
+ * *table_id* of given pipeline *p* and in its action handlers.
+ *
+ * @param p
+ *   Handle to pipeline instance.
+ * @param table_id
+ *   Table ID what cycles will be returned.
+ * @param cycles
+ *   Cycles buffer.
+ * @param clear
+ *   If not 0 clear cycles after reading.
+ * @return
+ *   0 on success, error code otherwise. The cycles are zero if the
+ *   library is built without RTE_PIPELINE_CYCLES_COLLECT.
+ */
+int rte_pipeline_table_cycles_read(struct rte_pipeline *p, uint32_t table_id,
+	struct rte_pipeline_table_cycles *cycles, int clear);
+
 /*
  * Port IN
  *
@@ -687,6 +813,27 @@ int rte_pipeline_port_in_disable(struct rte_pipeline *p,
 int rte_pipeline_port_in_stats_read(struct rte_pipeline *p, uint32_t port_id,
 	struct rte_pipeline_port_in_stats *stats, int clear);
 
+/**
+ * Read pipeline port in cycles.
+ *
+ * This function reads the cycles spent in the input port identified by
+ * *port_id* of given pipeline *p* and in its action handler.
+ *
+ * @param p
+ *   Handle to pipeline instance.
+ * @param port_id
+ *   Port ID what cycles will be returned.
+ * @param cycles
+ *   Cycles buffer.
+ * @param clear
+ *   If not 0 clear cycles after reading.
+ * @return
+ *   0 on success, error code otherwise. The cycles are zero if the
+ *   library is built without RTE_PIPELINE_CYCLES_COLLECT.
+ */
+int rte_pipeline_port_in_cycles_read(struct rte_pipeline *p, uint32_t port_id,
+	struct rte_pipeline_port_in_cycles *cycles, int clear);
+
 /*
  * Port OUT
  *
@@ -38,7 +38,7 @@
 
 #include "rte_port_frag.h"
 
-/* Max number of fragments per packet allowed */
+/* Max number of fragments per packet allowed, size of the "frags" buffer */
 #define	RTE_PORT_FRAG_MAX_FRAGS_PER_PACKET 0x80
 
 #ifdef RTE_PORT_STATS_COLLECT
@@ -55,10 +55,12 @@
 
 #endif
 
-typedef int32_t
-		(*frag_op)(struct rte_mbuf *pkt_in,
+typedef uint16_t
+		(*frag_op)(struct rte_mbuf **pkts_in,
+			uint16_t nb_pkts_in,
 			struct rte_mbuf **pkts_out,
 			uint16_t nb_pkts_out,
+			uint16_t *nb_frags,
 			uint16_t mtu_size,
 			struct rte_mempool *pool_direct,
 			struct rte_mempool *pool_indirect);
@@ -136,7 +138,7 @@ rte_port_ring_reader_frag_create(void *params, int socket_id, int is_ipv4)
 	port->pos_frags = 0;
 
 	port->f_frag = (is_ipv4) ?
-			rte_ipv4_fragment_packet : rte_ipv6_fragment_packet;
+			rte_ipv4_fragment_burst : rte_ipv6_fragment_burst;
 
 	return port;
 }
@@ -160,28 +162,24 @@ rte_port_ring_reader_frag_rx(void *port,
 {
 	struct rte_port_ring_reader_frag *p =
 			(struct rte_port_ring_reader_frag *) port;
+	uint16_t nb_frags[RTE_PORT_IN_BURST_SIZE_MAX];
 	uint32_t n_pkts_out;
 
 	n_pkts_out = 0;
 
-	/* Get packets from the "frag" buffer */
-	if (p->n_frags >= n_pkts) {
-		memcpy(pkts, &p->frags[p->pos_frags], n_pkts * sizeof(void *));
-		p->pos_frags += n_pkts;
-		p->n_frags -= n_pkts;
-
-		return n_pkts;
-	}
+	for ( ; ; ) {
+		uint32_t n, i, j;
 
-	memcpy(pkts, &p->frags[p->pos_frags], p->n_frags * sizeof(void *));
-	n_pkts_out = p->n_frags;
-	p->n_frags = 0;
+		/* Get packets from the "frags" buffer */
+		n = RTE_MIN(p->n_frags, n_pkts - n_pkts_out);
+		memcpy(&pkts[n_pkts_out], &p->frags[p->pos_frags],
+			n * sizeof(void *));
+		p->pos_frags += n;
+		p->n_frags -= n;
+		n_pkts_out += n;
 
-	/* Look to "pkts" buffer to get more packets */
-	for ( ; ; ) {
-		struct rte_mbuf *pkt;
-		uint32_t n_pkts_to_provide, i;
-		int status;
+		if (n_pkts_out == n_pkts)
+			return n_pkts;
 
 		/* If "pkts" buffer is empty, read packet burst from ring */
 		if (p->n_pkts == 0) {
@@ -193,68 +191,54 @@ rte_port_ring_reader_frag_rx(void *port,
 			p->pos_pkts = 0;
 		}
 
-		/* Read next packet from "pkts" buffer */
-		pkt = p->pkts[p->pos_pkts++];
-		p->n_pkts--;
-
-		/* If not jumbo, pass current packet to output */
-		if (pkt->pkt_len <= p->mtu) {
-			pkts[n_pkts_out++] = pkt;
-
-			n_pkts_to_provide = n_pkts - n_pkts_out;
-			if (n_pkts_to_provide == 0)
-				return n_pkts;
-
-			continue;
-		}
-
-		/* Fragment current packet into the "frags" buffer */
-		status = p->f_frag(
-			pkt,
+		/*
+		 * Move as many packets from the "pkts" buffer to the empty
+		 * "frags" buffer as it can hold, fragmenting the jumbo ones
+		 */
+		n = p->f_frag(
+			&p->pkts[p->pos_pkts],
+			p->n_pkts,
 			p->frags,
 			RTE_PORT_FRAG_MAX_FRAGS_PER_PACKET,
+			nb_frags,
 			p->mtu,
 			p->pool_direct,
 			p->pool_indirect
 		);
 
-		if (status < 0) {
-			rte_pktmbuf_free(pkt);
-			RTE_PORT_RING_READER_FRAG_STATS_PKTS_DROP_ADD(p, 1);
-			continue;
-		}
-
-		p->n_frags = (uint32_t) status;
 		p->pos_frags = 0;
-
-		/* Copy meta-data from input jumbo packet to its fragments */
-		for (i = 0; i < p->n_frags; i++) {
-			uint8_t *src =
-			  RTE_MBUF_METADATA_UINT8_PTR(pkt, sizeof(struct rte_mbuf));
-			uint8_t *dst =
-			  RTE_MBUF_METADATA_UINT8_PTR(p->frags[i], sizeof(struct rte_mbuf));
-
-			memcpy(dst, src, p->metadata_size);
+		for (i = 0; i < n; i++) {
+			struct rte_mbuf *pkt = p->pkts[p->pos_pkts + i];
+
+			if (nb_frags[i] == 1) {
+				p->n_frags++;
+				continue;
+			}
+
+			/* Copy meta-data from input jumbo packet to its fragments */
+			for (j = 0; j < nb_frags[i]; j++) {
+				uint8_t *src =
+				  RTE_MBUF_METADATA_UINT8_PTR(pkt, sizeof(struct rte_mbuf));
+				uint8_t *dst =
+				  RTE_MBUF_METADATA_UINT8_PTR(p->frags[p->n_frags++],
+					sizeof(struct rte_mbuf));
+
+				memcpy(dst, src, p->metadata_size);
+			}
+
+			/* Free input jumbo packet */
+			rte_pktmbuf_free(pkt);
 		}
-
-		/* Free input jumbo packet */
-		rte_pktmbuf_free(pkt);
-
-		/* Get packets from "frag" buffer */
-		n_pkts_to_provide = n_pkts - n_pkts_out;
-		if (p->n_frags >= n_pkts_to_provide) {
-			memcpy(&pkts[n_pkts_out], p->frags,
-				n_pkts_to_provide * sizeof(void *));
-			p->n_frags -= n_pkts_to_provide;
-			p->pos_frags += n_pkts_to_provide;
-
-			return n_pkts;
+		p->pos_pkts += n;
+		p->n_pkts -= n;
+
+		/* Drop the packet that can't be fragmented */
+		if (n == 0) {
+			rte_pktmbuf_free(p->pkts[p->pos_pkts]);
+			p->pos_pkts++;
+			p->n_pkts--;
+			RTE_PORT_RING_READER_FRAG_STATS_PKTS_DROP_ADD(p, 1);
 		}
-
-		memcpy(&pkts[n_pkts_out], p->frags,
-			p->n_frags * sizeof(void *));
-		n_pkts_out += p->n_frags;
-		p->n_frags = 0;
 	}
 }
 
@@ -0,0 +1,401 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_cycles.h>
+#include <rte_spinlock.h>
+#include <rte_interrupts.h>
+#include <rte_ethdev.h>
+#include <rte_malloc.h>
+
+#include "rte_power.h"
+#include "rte_power_pmd_mgmt.h"
+
+/* Interrupt registration of the queues of an lcore */
+#define PMD_MGMT_INTR_UNKNOWN 0
+#define PMD_MGMT_INTR_READY 1
+#define PMD_MGMT_INTR_UNSUPPORTED -1
+
+struct pmd_mgmt_queue {
+	struct rte_eth_rxtx_callback *cb;
+	uint64_t empty_polls;
+	unsigned lcore_id;
+	uint8_t port_id;
+	uint16_t queue_id;
+	uint8_t enabled;
+};
+
+struct pmd_mgmt_lcore {
+	struct rte_power_pmd_mgmt_conf conf;
+	uint64_t pause_cycles;
+	struct pmd_mgmt_queue queues[RTE_POWER_PMD_MGMT_MAX_QUEUES];
+	unsigned nb_queues;
+	volatile enum rte_power_pmd_mgmt_state state;
+	int intr;
+	int scaled_down;
+	struct rte_power_pmd_mgmt_stats stats;
+	uint8_t configured;
+} __rte_cache_aligned;
+
+static struct pmd_mgmt_lcore pmd_mgmt_lcores[RTE_MAX_LCORE];
+
+/* the RX interrupts of some PMDs share registers between queues */
+static rte_spinlock_t pmd_mgmt_port_locks[RTE_MAX_ETHPORTS];
+
+static void
+pmd_mgmt_default_conf(struct pmd_mgmt_lcore *lc)
+{
+	lc->conf.pause_threshold = RTE_POWER_PMD_MGMT_PAUSE_THRESHOLD;
+	lc->conf.pause_us = RTE_POWER_PMD_MGMT_PAUSE_US;
+	lc->conf.sleep_threshold = RTE_POWER_PMD_MGMT_SLEEP_THRESHOLD;
+	lc->conf.sleep_timeout_ms = RTE_POWER_PMD_MGMT_SLEEP_TIMEOUT_MS;
+	lc->conf.scale_threshold = 0;
+}
+
+static void
+pmd_mgmt_apply_conf(struct pmd_mgmt_lcore *lc)
+{
+	lc->pause_cycles = (uint64_t)lc->conf.pause_us * rte_get_tsc_hz() /
+		1000000;
+	lc->configured = 1;
+}
+
+int
+rte_power_pmd_mgmt_set_conf(unsigned lcore_id,
+	const struct rte_power_pmd_mgmt_conf *conf)
+{
+	struct pmd_mgmt_lcore *lc;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	lc = &pmd_mgmt_lcores[lcore_id];
+	if (conf == NULL)
+		pmd_mgmt_default_conf(lc);
+	else
+		lc->conf = *conf;
+	pmd_mgmt_apply_conf(lc);
+
+	return 0;
+}
+
+/* lower the frequency of an idle lcore */
+static void
+pmd_mgmt_scale_down(struct pmd_mgmt_lcore *lc, unsigned lcore_id)
+{
+	if (rte_power_freq_min == NULL || rte_power_freq_min(lcore_id) < 0) {
+		RTE_LOG(ERR, POWER, "Cannot scale lcore %u, scaling disabled\n",
+			lcore_id);
+		lc->conf.scale_threshold = 0;
+		return;
+	}
+	lc->scaled_down = 1;
+	lc->stats.scale_downs++;
+}
+
+static void
+pmd_mgmt_scale_up(struct pmd_mgmt_lcore *lc, unsigned lcore_id)
+{
+	if (rte_power_freq_max != NULL)
+		rte_power_freq_max(lcore_id);
+	lc->scaled_down = 0;
+	lc->stats.scale_ups++;
+}
+
+static void
+pmd_mgmt_pause(struct pmd_mgmt_lcore *lc)
+{
+	uint64_t start = rte_rdtsc();
+
+	lc->state = RTE_POWER_PMD_MGMT_PAUSE;
+	lc->stats.pauses++;
+	while (rte_rdtsc() - start < lc->pause_cycles)
+		rte_pause();
+}
+
+/* add the queues of the lcore to its epoll instance, from the lcore */
+static int
+pmd_mgmt_intr_register(struct pmd_mgmt_lcore *lc)
+{
+	struct pmd_mgmt_queue *q;
+	unsigned i;
+	int ret;
+
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++) {
+		q = &lc->queues[i];
+		if (!q->enabled)
+			continue;
+		ret = rte_eth_dev_rx_intr_ctl_q(q->port_id, q->queue_id,
+			RTE_EPOLL_PER_THREAD, RTE_INTR_EVENT_ADD, NULL);
+		/* the queues added before a new one are already registered */
+		if (ret != 0 && ret != -EEXIST) {
+			RTE_LOG(INFO, POWER, "No RX interrupt on port %u "
+				"queue %u, lcore %u will not sleep\n",
+				q->port_id, q->queue_id, q->lcore_id);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+pmd_mgmt_intr_set(struct pmd_mgmt_lcore *lc, int on)
+{
+	struct pmd_mgmt_queue *q;
+	unsigned i;
+
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++) {
+		q = &lc->queues[i];
+		if (!q->enabled)
+			continue;
+		rte_spinlock_lock(&pmd_mgmt_port_locks[q->port_id]);
+		if (on)
+			rte_eth_dev_rx_intr_enable(q->port_id, q->queue_id);
+		else
+			rte_eth_dev_rx_intr_disable(q->port_id, q->queue_id);
+		rte_spinlock_unlock(&pmd_mgmt_port_locks[q->port_id]);
+	}
+}
+
+/* wait for an RX interrupt, return -1 if the lcore cannot sleep */
+static int
+pmd_mgmt_sleep(struct pmd_mgmt_lcore *lc)
+{
+	struct rte_epoll_event events[RTE_POWER_PMD_MGMT_MAX_QUEUES];
+	struct pmd_mgmt_queue *q;
+	unsigned i;
+	int n;
+
+	if (lc->intr == PMD_MGMT_INTR_UNKNOWN)
+		lc->intr = pmd_mgmt_intr_register(lc) == 0 ?
+			PMD_MGMT_INTR_READY : PMD_MGMT_INTR_UNSUPPORTED;
+	if (lc->intr != PMD_MGMT_INTR_READY)
+		return -1;
+
+	pmd_mgmt_intr_set(lc, 1);
+
+	/* no interrupt is raised for the packets received before */
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++) {
+		q = &lc->queues[i];
+		if (q->enabled &&
+				rte_eth_rx_queue_count(q->port_id,
+					q->queue_id) > 0) {
+			pmd_mgmt_intr_set(lc, 0);
+			return 0;
+		}
+	}
+
+	lc->state = RTE_POWER_PMD_MGMT_SLEEP;
+	lc->stats.sleeps++;
+	n = rte_epoll_wait(RTE_EPOLL_PER_THREAD, events, lc->nb_queues,
+		lc->conf.sleep_timeout_ms == 0 ? -1 :
+		(int)lc->conf.sleep_timeout_ms);
+	if (n > 0)
+		lc->stats.intr_wakeups++;
+
+	pmd_mgmt_intr_set(lc, 0);
+
+	/* poll again before the next sleep */
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++)
+		lc->queues[i].empty_polls = 0;
+	lc->state = RTE_POWER_PMD_MGMT_BUSY;
+
+	return 0;
+}
+
+static uint16_t
+pmd_mgmt_rx_callback(uint8_t port_id __rte_unused,
+	uint16_t queue_id __rte_unused, struct rte_mbuf *pkts[] __rte_unused,
+	uint16_t nb_pkts, uint16_t max_pkts, void *user_param)
+{
+	struct pmd_mgmt_queue *q = user_param;
+	struct pmd_mgmt_lcore *lc = &pmd_mgmt_lcores[q->lcore_id];
+	uint64_t idle;
+	unsigned i;
+
+	if (nb_pkts != 0) {
+		q->empty_polls = 0;
+		lc->state = RTE_POWER_PMD_MGMT_BUSY;
+		/* a full burst means the queue is filling up */
+		if (unlikely(lc->scaled_down) && nb_pkts == max_pkts)
+			pmd_mgmt_scale_up(lc, q->lcore_id);
+		return nb_pkts;
+	}
+
+	q->empty_polls++;
+	lc->stats.empty_polls++;
+
+	/* the lcore is as idle as its busiest queue */
+	idle = q->empty_polls;
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++)
+		if (lc->queues[i].enabled && lc->queues[i].empty_polls < idle)
+			idle = lc->queues[i].empty_polls;
+
+	if (lc->conf.scale_threshold != 0 && !lc->scaled_down &&
+			idle >= lc->conf.scale_threshold)
+		pmd_mgmt_scale_down(lc, q->lcore_id);
+
+	if (lc->conf.sleep_threshold != 0 &&
+			idle >= lc->conf.sleep_threshold &&
+			pmd_mgmt_sleep(lc) == 0)
+		return 0;
+
+	if (lc->conf.pause_threshold != 0 &&
+			idle >= lc->conf.pause_threshold)
+		pmd_mgmt_pause(lc);
+
+	return 0;
+}
+
+int
+rte_power_pmd_mgmt_queue_enable(unsigned lcore_id, uint8_t port_id,
+	uint16_t queue_id)
+{
+	struct pmd_mgmt_lcore *lc;
+	struct pmd_mgmt_queue *q = NULL;
+	unsigned i;
+
+	if (lcore_id >= RTE_MAX_LCORE || !rte_eth_dev_is_valid_port(port_id) ||
+			queue_id >= rte_eth_devices[port_id].data->nb_rx_queues)
+		return -EINVAL;
+
+	lc = &pmd_mgmt_lcores[lcore_id];
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++) {
+		if (!lc->queues[i].enabled) {
+			if (q == NULL)
+				q = &lc->queues[i];
+		} else if (lc->queues[i].port_id == port_id &&
+				lc->queues[i].queue_id == queue_id)
+			return -EEXIST;
+	}
+	if (q == NULL)
+		return -ENOSPC;
+
+	if (!lc->configured) {
+		pmd_mgmt_default_conf(lc);
+		pmd_mgmt_apply_conf(lc);
+	}
+
+	q->lcore_id = lcore_id;
+	q->port_id = port_id;
+	q->queue_id = queue_id;
+	q->empty_polls = 0;
+	q->cb = rte_eth_add_rx_callback(port_id, queue_id,
+		pmd_mgmt_rx_callback, q);
+	if (q->cb == NULL)
+		return rte_errno == EINVAL ? -EINVAL : -ENOTSUP;
+
+	q->enabled = 1;
+	lc->nb_queues++;
+	/* register the new queue at the next sleep */
+	if (lc->intr == PMD_MGMT_INTR_READY)
+		lc->intr = PMD_MGMT_INTR_UNKNOWN;
+
+	return 0;
+}
+
+int
+rte_power_pmd_mgmt_queue_disable(unsigned lcore_id, uint8_t port_id,
+	uint16_t queue_id)
+{
+	struct pmd_mgmt_lcore *lc;
+	struct pmd_mgmt_queue *q;
+	unsigned i;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	lc = &pmd_mgmt_lcores[lcore_id];
+	for (i = 0; i < RTE_POWER_PMD_MGMT_MAX_QUEUES; i++) {
+		q = &lc->queues[i];
+		if (q->enabled && q->port_id == port_id &&
+				q->queue_id == queue_id)
+			break;
+	}
+	if (i == RTE_POWER_PMD_MGMT_MAX_QUEUES)
+		return -EINVAL;
+
+	/* the queue is not polled, the callback can be freed */
+	if (rte_eth_remove_rx_callback(port_id, queue_id, q->cb) == 0)
+		rte_free(q->cb);
+	if (lc->intr == PMD_MGMT_INTR_READY)
+		rte_eth_dev_rx_intr_ctl_q(port_id, queue_id,
+			RTE_EPOLL_PER_THREAD, RTE_INTR_EVENT_DEL, NULL);
+	q->enabled = 0;
+	q->cb = NULL;
+
+	if (--lc->nb_queues == 0) {
+		if (lc->scaled_down)
+			pmd_mgmt_scale_up(lc, lcore_id);
+		lc->intr = PMD_MGMT_INTR_UNKNOWN;
+		lc->state = RTE_POWER_PMD_MGMT_BUSY;
+	}
+
+	return 0;
+}
+
+enum rte_power_pmd_mgmt_state
+rte_power_pmd_mgmt_get_state(unsigned lcore_id)
+{
+	if (lcore_id >= RTE_MAX_LCORE)
+		return RTE_POWER_PMD_MGMT_BUSY;
+
+	return pmd_mgmt_lcores[lcore_id].state;
+}
+
+int
+rte_power_pmd_mgmt_stats_get(unsigned lcore_id,
+	struct rte_power_pmd_mgmt_stats *stats)
+{
+	if (lcore_id >= RTE_MAX_LCORE || stats == NULL)
+		return -EINVAL;
+
+	*stats = pmd_mgmt_lcores[lcore_id].stats;
+	return 0;
+}
+
+void
+rte_power_pmd_mgmt_stats_reset(unsigned lcore_id)
+{
+	if (lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	memset(&pmd_mgmt_lcores[lcore_id].stats, 0,
+		sizeof(struct rte_power_pmd_mgmt_stats));
+}
@@ -0,0 +1,209 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2016 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTE_POWER_PMD_MGMT_H
+#define _RTE_POWER_PMD_MGMT_H
+
+/**
+ * @file
+ * RTE Power Management of the Polling lcores
+ *
+ * An lcore polling RX queues with rte_eth_rx_burst() keeps a core busy even
+ * when no packet is received. This API adds an RX callback to the queues of
+ * an lcore, which counts the consecutive empty polls and moves the lcore
+ * through the following states:
+ *
+ * - busy: the queues are polled as usual;
+ * - pause: each empty poll is followed by a short pause, which bounds the
+ *   added latency;
+ * - sleep: the lcore waits for an RX interrupt of one of its queues, or for
+ *   a timeout.
+ *
+ * The frequency of the lcore can also be lowered with rte_power when it is
+ * idle, and raised again when it receives full bursts.
+ *
+ * An lcore pauses or sleeps only when all its managed queues are idle, so
+ * all the RX queues polled by an lcore should be managed. The sleep state
+ * needs the RX interrupts of the ports, configured with intr_conf.rxq, and
+ * falls back to the pause state otherwise.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of RX queues managed on an lcore. */
+#define RTE_POWER_PMD_MGMT_MAX_QUEUES 8
+
+/** Power management state of an lcore. */
+enum rte_power_pmd_mgmt_state {
+	RTE_POWER_PMD_MGMT_BUSY = 0, /**< Polling continuously. */
+	RTE_POWER_PMD_MGMT_PAUSE,    /**< Pausing after each empty poll. */
+	RTE_POWER_PMD_MGMT_SLEEP,    /**< Waiting for an RX interrupt. */
+};
+
+/**
+ * Power management configuration of an lcore.
+ *
+ * The thresholds are numbers of consecutive empty polls of all the queues of
+ * the lcore. A threshold of 0 disables the corresponding state.
+ */
+struct rte_power_pmd_mgmt_conf {
+	uint32_t pause_threshold;  /**< Empty polls before pausing. */
+	uint32_t pause_us;         /**< Length of a pause, latency target. */
+	uint32_t sleep_threshold;  /**< Empty polls before sleeping. */
+	uint32_t sleep_timeout_ms; /**< Longest sleep, 0 for no timeout. */
+	uint32_t scale_threshold;  /**< Empty polls before scaling down. */
+};
+
+/** Default number of empty polls before pausing. */
+#define RTE_POWER_PMD_MGMT_PAUSE_THRESHOLD 512
+/** Default length of a pause in microseconds. */
+#define RTE_POWER_PMD_MGMT_PAUSE_US 10
+/** Default number of empty polls before sleeping, about 0.3 s of pauses. */
+#define RTE_POWER_PMD_MGMT_SLEEP_THRESHOLD 32768
+/** Default longest sleep in milliseconds. */
+#define RTE_POWER_PMD_MGMT_SLEEP_TIMEOUT_MS 100
+
+/** Power management statistics of an lcore. */
+struct rte_power_pmd_mgmt_stats {
+	uint64_t empty_polls;  /**< Empty polls of the managed queues. */
+	uint64_t pauses;       /**< Pauses done. */
+	uint64_t sleeps;       /**< Sleeps started. */
+	uint64_t intr_wakeups; /**< Sleeps ended by an RX interrupt. */
+	uint64_t scale_downs;  /**< Frequency lowered to its minimum. */
+	uint64_t scale_ups;    /**< Frequency raised to its maximum. */
+};
+
+/**
+ * Set the power management configuration of an lcore.
+ *
+ * Without configuration, the lcore pauses and sleeps with the default
+ * values, and its frequency is not scaled. The scaling requires
+ * rte_power_init() to be called for the lcore.
+ *
+ * It must not be called while the lcore polls managed queues.
+ *
+ * @param lcore_id
+ *   The lcore polling the queues.
+ * @param conf
+ *   The configuration, or NULL to restore the defaults.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if *lcore_id* is invalid.
+ */
+int rte_power_pmd_mgmt_set_conf(unsigned lcore_id,
+		const struct rte_power_pmd_mgmt_conf *conf);
+
+/**
+ * Enable the power management of an RX queue polled by an lcore.
+ *
+ * It must be called after the queue is set up, and before the lcore
+ * polls it. The RX callbacks must be enabled with
+ * CONFIG_RTE_ETHDEV_RXTX_CALLBACKS.
+ *
+ * @param lcore_id
+ *   The lcore polling the queue.
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The RX queue identifier.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if a parameter is invalid.
+ *   - -EEXIST if the queue is already managed.
+ *   - -ENOSPC if the lcore already manages RTE_POWER_PMD_MGMT_MAX_QUEUES.
+ *   - -ENOTSUP if the RX callbacks are not supported.
+ */
+int rte_power_pmd_mgmt_queue_enable(unsigned lcore_id, uint8_t port_id,
+		uint16_t queue_id);
+
+/**
+ * Disable the power management of an RX queue.
+ *
+ * The lcore must not poll the queue while it is called, as the RX callback
+ * is freed. When it was the last managed queue of the lcore, the lcore
+ * frequency is restored to its maximum if it was lowered.
+ *
+ * @param lcore_id
+ *   The lcore polling the queue.
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The RX queue identifier.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the queue is not managed by this lcore.
+ */
+int rte_power_pmd_mgmt_queue_disable(unsigned lcore_id, uint8_t port_id,
+		uint16_t queue_id);
+
+/**
+ * Get the current power management state of an lcore.
+ *
+ * @param lcore_id
+ *   The lcore identifier.
+ * @return
+ *   The state, RTE_POWER_PMD_MGMT_BUSY if the lcore is not managed.
+ */
+enum rte_power_pmd_mgmt_state rte_power_pmd_mgmt_get_state(unsigned lcore_id);
+
+/**
+ * Get the power management statistics of an lcore.
+ *
+ * @param lcore_id
+ *   The lcore identifier.
+ * @param stats
+ *   A pointer to the statistics to be filled.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if a parameter is invalid.
+ */
+int rte_power_pmd_mgmt_stats_get(unsigned lcore_id,
+		struct rte_power_pmd_mgmt_stats *stats);
+
+/**
+ * Reset the power management statistics of an lcore.
+ *
+ * @param lcore_id
+ *   The lcore identifier.
+ */
+void rte_power_pmd_mgmt_stats_reset(unsigned lcore_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_POWER_PMD_MGMT_H */
@@ -35,11 +35,13 @@
 #include <string.h>
 
 #include <rte_log.h>
+#include <rte_cycles.h>
 #include <rte_mbuf.h>
 #include <rte_memzone.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_atomic.h>
 
 #include "rte_reorder.h"
 
@@ -50,6 +52,13 @@ static struct rte_tailq_elem rte_reorder_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_reorder_tailq)
 
+TAILQ_HEAD(rte_reorder_mp_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_reorder_mp_tailq = {
+	.name = "RTE_REORDER_MP",
+};
+EAL_REGISTER_TAILQ(rte_reorder_mp_tailq)
+
 #define NO_FLAGS 0
 #define RTE_REORDER_PREFIX "RO_"
 #define RTE_REORDER_NAMESIZE 32
@@ -57,6 +66,11 @@ EAL_REGISTER_TAILQ(rte_reorder_tailq)
 /* Macros for printing using RTE_LOG */
 #define RTE_LOGTYPE_REORDER	RTE_LOGTYPE_USER1
 
+/* Bits per word of the order buffer occupancy bitmap */
+#define BITMAP_WORD_BITS 64
+#define BITMAP_WORD_SHIFT 6
+#define BITMAP_WORD_MASK (BITMAP_WORD_BITS - 1)
+
 /* A generic circular buffer */
 struct cir_buffer {
 	unsigned int size;   /**< Number of entries that can be stored */
@@ -73,9 +87,22 @@ struct rte_reorder_buffer {
 	unsigned int memsize; /**< memory area size of reorder buffer */
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
+	uint64_t *order_tsc; /**< TSC at insertion of order_buf entries */
+	uint64_t *order_bmp; /**< bitmap of occupied order_buf entries */
 	int is_initialized;
 } __rte_cache_aligned;
 
+/* Size of the memory area following the reorder buffer structure */
+static inline unsigned int
+rte_reorder_entries_memsize(unsigned int size)
+{
+	unsigned int bmp_words =
+		(size + BITMAP_WORD_BITS - 1) >> BITMAP_WORD_SHIFT;
+
+	return 2 * size * sizeof(struct rte_mbuf *) +
+		size * sizeof(uint64_t) + bmp_words * sizeof(uint64_t);
+}
+
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
 
@@ -83,8 +110,7 @@ struct rte_reorder_buffer *
 rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 		const char *name, unsigned int size)
 {
-	const unsigned int min_bufsize = sizeof(*b) +
-					(2 * size * sizeof(struct rte_mbuf *));
+	const unsigned int min_bufsize = rte_reorder_memory_footprint_get(size);
 
 	if (b == NULL) {
 		RTE_LOG(ERR, REORDER, "Invalid reorder buffer parameter:"
@@ -119,18 +145,28 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 	b->ready_buf.entries = (void *)&b[1];
 	b->order_buf.entries = RTE_PTR_ADD(&b[1],
 			size * sizeof(b->ready_buf.entries[0]));
+	b->order_tsc = RTE_PTR_ADD(b->order_buf.entries,
+			size * sizeof(b->order_buf.entries[0]));
+	b->order_bmp = RTE_PTR_ADD(b->order_tsc,
+			size * sizeof(b->order_tsc[0]));
 
 	return b;
 }
 
+unsigned int
+rte_reorder_memory_footprint_get(unsigned int size)
+{
+	return sizeof(struct rte_reorder_buffer) +
+		rte_reorder_entries_memsize(size);
+}
+
 struct rte_reorder_buffer*
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te;
 	struct rte_reorder_list *reorder_list;
-	const unsigned int bufsize = sizeof(struct rte_reorder_buffer) +
-					(2 * size * sizeof(struct rte_mbuf *));
+	const unsigned int bufsize = rte_reorder_memory_footprint_get(size);
 
 	reorder_list = RTE_TAILQ_CAST(rte_reorder_tailq.head, rte_reorder_list);
 
@@ -269,6 +305,81 @@ rte_reorder_find_existing(const char *name)
 	return b;
 }
 
+static inline void
+order_bmp_set(struct rte_reorder_buffer *b, unsigned int pos)
+{
+	b->order_bmp[pos >> BITMAP_WORD_SHIFT] |=
+			1ULL << (pos & BITMAP_WORD_MASK);
+}
+
+static inline void
+order_bmp_clear(struct rte_reorder_buffer *b, unsigned int pos)
+{
+	b->order_bmp[pos >> BITMAP_WORD_SHIFT] &=
+			~(1ULL << (pos & BITMAP_WORD_MASK));
+}
+
+/*
+ * Return the distance from position start of the order buffer to the first
+ * entry that is occupied (set != 0) or free (set == 0), wrapping around the
+ * buffer. The size of the buffer is returned if there is no such entry.
+ */
+static inline unsigned int
+order_bmp_scan(const struct rte_reorder_buffer *b, unsigned int start, int set)
+{
+	const struct cir_buffer *order_buf = &b->order_buf;
+	unsigned int pos = start, dist = 0, nb_bits, bit;
+	uint64_t word;
+
+	while (dist < order_buf->size) {
+		bit = pos & BITMAP_WORD_MASK;
+		word = b->order_bmp[pos >> BITMAP_WORD_SHIFT];
+		if (!set)
+			word = ~word;
+		word >>= bit;
+
+		/* Don't look past the end of the buffer or of the scan */
+		nb_bits = RTE_MIN(BITMAP_WORD_BITS - bit, order_buf->size - pos);
+		nb_bits = RTE_MIN(nb_bits, order_buf->size - dist);
+		if (nb_bits < BITMAP_WORD_BITS)
+			word &= (1ULL << nb_bits) - 1;
+
+		if (word != 0)
+			return dist + __builtin_ctzll(word);
+
+		dist += nb_bits;
+		pos = (pos + nb_bits) & order_buf->mask;
+	}
+
+	return order_buf->size;
+}
+
+/*
+ * Move the run of contiguous entries at the head of the order buffer to the
+ * mbufs array, at most n entries. Return the number of entries moved.
+ */
+static inline unsigned int
+order_buf_drain_run(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int n)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	unsigned int i, run;
+
+	run = order_bmp_scan(b, order_buf->head, 0);
+	if (run > n)
+		run = n;
+
+	for (i = 0; i < run; i++) {
+		mbufs[i] = order_buf->entries[order_buf->head];
+		order_buf->entries[order_buf->head] = NULL;
+		order_bmp_clear(b, order_buf->head);
+		order_buf->head = (order_buf->head + 1) & order_buf->mask;
+	}
+
+	b->min_seqn += run;
+	return run;
+}
+
 static unsigned
 rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 {
@@ -284,6 +395,7 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 			*ready_buf = &b->ready_buf;
 
 	unsigned int order_head_adv = 0;
+	unsigned int gap, run, i;
 
 	/*
 	 * move at least n packets to ready buffer, assuming ready buffer
@@ -292,36 +404,44 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	while (order_head_adv < n &&
 			((ready_buf->head + 1) & ready_buf->mask) != ready_buf->tail) {
 
-		/* if we are blocked waiting on a packet, skip it */
-		if (order_buf->entries[order_buf->head] == NULL) {
-			order_buf->head = (order_buf->head + 1) & order_buf->mask;
-			order_head_adv++;
-		}
+		/* if we are blocked waiting on packets, skip the whole gap */
+		gap = order_bmp_scan(b, order_buf->head, 1);
+		if (gap > n - order_head_adv)
+			gap = n - order_head_adv;
+		order_buf->head = (order_buf->head + gap) & order_buf->mask;
+		b->min_seqn += gap;
+		order_head_adv += gap;
 
 		/* Move all ready entries that fit to the ready_buf */
-		while (order_buf->entries[order_buf->head] != NULL) {
+		run = order_bmp_scan(b, order_buf->head, 0);
+		if (run > ((ready_buf->tail - ready_buf->head - 1) &
+				ready_buf->mask))
+			run = (ready_buf->tail - ready_buf->head - 1) &
+				ready_buf->mask;
+
+		for (i = 0; i < run; i++) {
 			ready_buf->entries[ready_buf->head] =
 					order_buf->entries[order_buf->head];
-
 			order_buf->entries[order_buf->head] = NULL;
-			order_head_adv++;
+			order_bmp_clear(b, order_buf->head);
 
 			order_buf->head = (order_buf->head + 1) & order_buf->mask;
-
-			if (((ready_buf->head + 1) & ready_buf->mask) == ready_buf->tail)
-				break;
-
 			ready_buf->head = (ready_buf->head + 1) & ready_buf->mask;
 		}
+		b->min_seqn += run;
+		order_head_adv += run;
+
+		if (gap == 0 && run == 0)
+			break;
 	}
 
-	b->min_seqn += order_head_adv;
 	/* Return the number of positions the order_buf head has moved */
 	return order_head_adv;
 }
 
-int
-rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+static inline int
+reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf,
+		uint64_t tsc)
 {
 	uint32_t offset, position;
 	struct cir_buffer *order_buf = &b->order_buf;
@@ -361,7 +481,6 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	 */
 	if (offset < b->order_buf.size) {
 		position = (order_buf->head + offset) & order_buf->mask;
-		order_buf->entries[position] = mbuf;
 	} else if (offset < 2 * b->order_buf.size) {
 		if (rte_reorder_fill_overflow(b, offset + 1 - order_buf->size)
 				< (offset + 1 - order_buf->size)) {
@@ -371,41 +490,414 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 		}
 		offset = mbuf->seqn - b->min_seqn;
 		position = (order_buf->head + offset) & order_buf->mask;
-		order_buf->entries[position] = mbuf;
 	} else {
 		/* Put in handling for enqueue straight to output */
 		rte_errno = ERANGE;
 		return -1;
 	}
+
+	order_buf->entries[position] = mbuf;
+	b->order_tsc[position] = tsc;
+	order_bmp_set(b, position);
 	return 0;
 }
 
+int
+rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	/* No timestamp, the mbuf never expires a gap in rte_reorder_drain_until */
+	return reorder_insert(b, mbuf, 0);
+}
+
+int
+rte_reorder_insert_tsc(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf,
+		uint64_t tsc)
+{
+	return reorder_insert(b, mbuf, tsc);
+}
+
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs)
+{
+	/* All mbufs of a burst share the same insertion time */
+	uint64_t tsc = rte_rdtsc();
+	unsigned int i;
+
+	for (i = 0; i < nb_mbufs; i++)
+		if (reorder_insert(b, mbufs[i], tsc) != 0)
+			break;
+
+	return i;
+}
+
 unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs)
 {
 	unsigned int drain_cnt = 0;
 
-	struct cir_buffer *order_buf = &b->order_buf,
-			*ready_buf = &b->ready_buf;
+	struct cir_buffer *ready_buf = &b->ready_buf;
 
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
+		ready_buf->entries[ready_buf->tail] = NULL;
 		ready_buf->tail = (ready_buf->tail + 1) & ready_buf->mask;
 	}
 
 	/*
 	 * If requested number of buffers not fetched from ready buffer, fetch
-	 * remaining buffers from order buffer
+	 * the run of contiguous buffers at the head of order buffer
 	 */
-	while ((drain_cnt < max_mbufs) &&
-			(order_buf->entries[order_buf->head] != NULL)) {
-		mbufs[drain_cnt++] = order_buf->entries[order_buf->head];
-		order_buf->entries[order_buf->head] = NULL;
-		b->min_seqn++;
-		order_buf->head = (order_buf->head + 1) & order_buf->mask;
+	if (drain_cnt < max_mbufs)
+		drain_cnt += order_buf_drain_run(b, &mbufs[drain_cnt],
+				max_mbufs - drain_cnt);
+
+	return drain_cnt;
+}
+
+unsigned int
+rte_reorder_drain_until(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs, uint64_t tsc)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	unsigned int drain_cnt, gap, position;
+
+	drain_cnt = rte_reorder_drain(b, mbufs, max_mbufs);
+
+	/*
+	 * Skip the gaps which hold back packets inserted before the deadline,
+	 * the missing packets are considered lost.
+	 */
+	while (drain_cnt < max_mbufs) {
+		gap = order_bmp_scan(b, order_buf->head, 1);
+		if (gap == order_buf->size)
+			break;
+
+		position = (order_buf->head + gap) & order_buf->mask;
+		if (b->order_tsc[position] == 0 ||
+				(int64_t)(b->order_tsc[position] - tsc) >= 0)
+			break;
+
+		order_buf->head = position;
+		b->min_seqn += gap;
+
+		drain_cnt += order_buf_drain_run(b, &mbufs[drain_cnt],
+				max_mbufs - drain_cnt);
 	}
 
 	return drain_cnt;
 }
+
+/*
+ * Multi-producer reorder buffer. Each sequence number owns a slot of the
+ * window, producers claim it with a compare-and-set and the single consumer
+ * releases the slots in sequence order.
+ */
+
+struct rte_reorder_mp_slot {
+	volatile uint64_t mbuf;  /**< mbuf pointer, 0 if slot is free */
+	volatile uint64_t tsc;   /**< TSC at insertion of the mbuf */
+	volatile uint32_t tsc_valid; /**< tsc was written for the mbuf */
+};
+
+struct rte_reorder_mp_buffer {
+	char name[RTE_REORDER_NAMESIZE];
+	unsigned int size;  /**< Number of slots of the window */
+	unsigned int mask;  /**< [size - 1]: used for wrap-around */
+	/** Lowest seq. number that can be in the buffer, written by consumer */
+	volatile uint32_t min_seqn __rte_cache_aligned;
+	/** Highest seq. number inserted + 1, written by producers */
+	volatile uint32_t end_seqn __rte_cache_aligned;
+	struct rte_reorder_mp_slot slots[0] __rte_cache_aligned;
+} __rte_cache_aligned;
+
+struct rte_reorder_mp_buffer *
+rte_reorder_mp_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	struct rte_reorder_mp_buffer *b = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_reorder_mp_list *reorder_list;
+
+	reorder_list = RTE_TAILQ_CAST(rte_reorder_mp_tailq.head,
+			rte_reorder_mp_list);
+
+	if (name == NULL) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer name ptr:"
+					" NULL\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if (!rte_is_power_of_2(size)) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer size"
+				" - Not a power of 2\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, reorder_list, next) {
+		b = (struct rte_reorder_mp_buffer *) te->data;
+		if (strncmp(name, b->name, RTE_REORDER_NAMESIZE) == 0)
+			break;
+	}
+	if (te != NULL)
+		goto exit;
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("REORDER_MP_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, REORDER, "Failed to allocate tailq entry\n");
+		rte_errno = ENOMEM;
+		b = NULL;
+		goto exit;
+	}
+
+	b = rte_zmalloc_socket("REORDER_MP_BUFFER", sizeof(*b) +
+			size * sizeof(b->slots[0]), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (b == NULL) {
+		RTE_LOG(ERR, REORDER, "Reorder buffer allocation failed\n");
+		rte_errno = ENOMEM;
+		rte_free(te);
+	} else {
+		snprintf(b->name, sizeof(b->name), "%s", name);
+		b->size = size;
+		b->mask = size - 1;
+		te->data = (void *)b;
+		TAILQ_INSERT_TAIL(reorder_list, te, next);
+	}
+
+exit:
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+	return b;
+}
+
+void
+rte_reorder_mp_reset(struct rte_reorder_mp_buffer *b, uint32_t min_seqn)
+{
+	unsigned int i;
+
+	for (i = 0; i < b->size; i++) {
+		if (b->slots[i].mbuf != 0)
+			rte_pktmbuf_free((struct rte_mbuf *)(uintptr_t)
+					b->slots[i].mbuf);
+		b->slots[i].tsc_valid = 0;
+		b->slots[i].mbuf = 0;
+	}
+
+	b->min_seqn = min_seqn;
+	b->end_seqn = min_seqn;
+}
+
+void
+rte_reorder_mp_free(struct rte_reorder_mp_buffer *b)
+{
+	struct rte_reorder_mp_list *reorder_list;
+	struct rte_tailq_entry *te;
+
+	if (b == NULL)
+		return;
+
+	reorder_list = RTE_TAILQ_CAST(rte_reorder_mp_tailq.head,
+			rte_reorder_mp_list);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, reorder_list, next) {
+		if (te->data == (void *) b)
+			break;
+	}
+	if (te == NULL) {
+		rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+		return;
+	}
+
+	TAILQ_REMOVE(reorder_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	rte_reorder_mp_reset(b, 0);
+	rte_free(b);
+	rte_free(te);
+}
+
+int
+rte_reorder_mp_insert(struct rte_reorder_mp_buffer *b, struct rte_mbuf *mbuf)
+{
+	struct rte_reorder_mp_slot *slot;
+	uint32_t offset, end_seqn;
+
+	/*
+	 * min_seqn only grows, so a stale value keeps an early mbuf out of
+	 * the window. A late mbuf may still be inserted if min_seqn moves
+	 * past it meanwhile, the consumer then returns it on its next lap.
+	 */
+	offset = mbuf->seqn - b->min_seqn;
+	if (offset >= b->size) {
+		rte_errno = (int32_t)offset < 0 ? ERANGE : ENOSPC;
+		return -1;
+	}
+
+	slot = &b->slots[mbuf->seqn & b->mask];
+
+	/* Slot still holds a late mbuf of the previous lap */
+	if (unlikely(rte_atomic64_cmpset(&slot->mbuf, 0,
+			(uint64_t)(uintptr_t)mbuf) == 0)) {
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	/*
+	 * Only the producer which claimed the slot writes its TSC. The
+	 * consumer may see the mbuf before the TSC, it then takes it as just
+	 * inserted until tsc_valid is set.
+	 */
+	slot->tsc = rte_rdtsc();
+	rte_wmb();
+	slot->tsc_valid = 1;
+
+	/* Let the consumer know how far to look for mbufs */
+	end_seqn = b->end_seqn;
+	while ((int32_t)(mbuf->seqn + 1 - end_seqn) > 0 &&
+			rte_atomic32_cmpset(&b->end_seqn, end_seqn,
+				mbuf->seqn + 1) == 0)
+		end_seqn = b->end_seqn;
+
+	return 0;
+}
+
+unsigned int
+rte_reorder_mp_insert_burst(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_mbufs; i++)
+		if (rte_reorder_mp_insert(b, mbufs[i]) != 0)
+			break;
+
+	return i;
+}
+
+/* Take the mbuf of a slot and hand the slot back to producers */
+static inline struct rte_mbuf *
+reorder_mp_slot_take(struct rte_reorder_mp_slot *slot)
+{
+	struct rte_mbuf *mbuf = (struct rte_mbuf *)(uintptr_t)slot->mbuf;
+
+	/* The next producer sets it again once the slot is free */
+	slot->tsc_valid = 0;
+	rte_wmb();
+	slot->mbuf = 0;
+
+	return mbuf;
+}
+
+/*
+ * Move the run of contiguous mbufs at the start of the window to the mbufs
+ * array, at most n. Late mbufs found in the run are returned as well.
+ */
+static inline unsigned int
+reorder_mp_drain_run(struct rte_reorder_mp_buffer *b, uint32_t *min_seqn,
+		struct rte_mbuf **mbufs, unsigned int n)
+{
+	struct rte_reorder_mp_slot *slot;
+	unsigned int cnt = 0;
+	uint32_t seqn = *min_seqn;
+
+	while (cnt < n) {
+		slot = &b->slots[seqn & b->mask];
+		if (slot->mbuf == 0)
+			break;
+
+		mbufs[cnt] = reorder_mp_slot_take(slot);
+		if (likely(mbufs[cnt]->seqn == seqn))
+			seqn++;
+		cnt++;
+	}
+
+	*min_seqn = seqn;
+	return cnt;
+}
+
+unsigned int
+rte_reorder_mp_drain(struct rte_reorder_mp_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	uint32_t min_seqn = b->min_seqn;
+	unsigned int cnt;
+
+	cnt = reorder_mp_drain_run(b, &min_seqn, mbufs, max_mbufs);
+
+	/* Released slots must be seen free before the window moves */
+	rte_wmb();
+	b->min_seqn = min_seqn;
+
+	return cnt;
+}
+
+unsigned int
+rte_reorder_mp_drain_until(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int max_mbufs, uint64_t tsc)
+{
+	struct rte_reorder_mp_slot *slot;
+	struct rte_mbuf *mbuf;
+	uint32_t min_seqn = b->min_seqn;
+	unsigned int cnt, gap, span;
+
+	cnt = reorder_mp_drain_run(b, &min_seqn, mbufs, max_mbufs);
+
+	/*
+	 * Skip the gaps which hold back mbufs inserted before the deadline,
+	 * the missing mbufs are considered lost. Only the slots up to the
+	 * highest sequence number inserted are scanned, so that an idle
+	 * buffer costs nothing. A late mbuf past it is returned once the
+	 * window reaches its slot.
+	 */
+	gap = 1;
+	while (cnt < max_mbufs) {
+		span = b->end_seqn - min_seqn;
+		rte_rmb();
+		if ((int32_t)span <= 0)
+			break;
+		if (span > b->size)
+			span = b->size;
+
+		for (; gap < span; gap++)
+			if (b->slots[(min_seqn + gap) & b->mask].mbuf != 0)
+				break;
+		if (gap >= span)
+			break;
+
+		slot = &b->slots[(min_seqn + gap) & b->mask];
+		mbuf = (struct rte_mbuf *)(uintptr_t)slot->mbuf;
+
+		/* Late mbufs are returned without moving the window */
+		if (unlikely(mbuf->seqn != min_seqn + gap)) {
+			mbufs[cnt++] = reorder_mp_slot_take(slot);
+			gap++;
+			continue;
+		}
+
+		/* The producer hasn't written the TSC yet, mbuf is brand new */
+		if (!slot->tsc_valid)
+			break;
+		rte_rmb();
+		if ((int64_t)(slot->tsc - tsc) >= 0)
+			break;
+
+		min_seqn += gap;
+		cnt += reorder_mp_drain_run(b, &min_seqn, &mbufs[cnt],
+				max_mbufs - cnt);
+		gap = 1;
+	}
+
+	rte_wmb();
+	b->min_seqn = min_seqn;
+	return cnt;
+}
@@ -44,11 +44,14 @@
  *
  */
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct rte_reorder_buffer;
+struct rte_mbuf;
 
 /**
  * Create a new reorder buffer instance
@@ -92,6 +95,17 @@ struct rte_reorder_buffer *
 rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 		const char *name, unsigned int size);
 
+/**
+ * Get the size of the memory area needed by a reorder buffer instance
+ *
+ * @param size
+ *   Number of elements that can be stored in reorder buffer
+ * @return
+ *   Minimum size of the memory area to pass to rte_reorder_init()
+ */
+unsigned int
+rte_reorder_memory_footprint_get(unsigned int size);
+
 /**
  * Find an existing reorder buffer instance
  * and return a pointer to it.
@@ -152,6 +166,50 @@ rte_reorder_free(struct rte_reorder_buffer *b);
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
 
+/**
+ * Insert given mbuf in reorder buffer with its insertion timestamp
+ *
+ * Same as rte_reorder_insert(), the timestamp is compared to the deadline of
+ * rte_reorder_drain_until(). Mbufs inserted with rte_reorder_insert() have
+ * no timestamp, and a gap in front of them is never skipped for time.
+ *
+ * @param b
+ *   Reorder buffer where the mbuf has to be inserted.
+ * @param mbuf
+ *   mbuf of packet that needs to be inserted in reorder buffer.
+ * @param tsc
+ *   Insertion time of the mbuf, usually the current TSC value. 0 means no
+ *   timestamp.
+ * @return
+ *   0 on success, -1 on error with rte_errno set as described for
+ *   rte_reorder_insert().
+ */
+int
+rte_reorder_insert_tsc(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf,
+		uint64_t tsc);
+
+/**
+ * Insert a burst of mbufs in reorder buffer in their correct positions
+ *
+ * Same as calling rte_reorder_insert_tsc() on each mbuf of the array, with
+ * the TSC read once for the whole burst. The insertion stops at the first
+ * mbuf which can't be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   array of mbufs of packets that need to be inserted in reorder buffer.
+ * @param nb_mbufs
+ *   the number of elements in the mbufs array.
+ * @return
+ *   number of mbufs inserted. If it is lower than nb_mbufs, the mbuf at that
+ *   index and the following ones are not inserted, and rte_errno is set as
+ *   described for rte_reorder_insert().
+ */
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs);
+
 /**
  * Fetch reordered buffers
  *
@@ -173,6 +231,173 @@ unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs);
 
+/**
+ * Fetch reordered buffers, skipping gaps older than a deadline
+ *
+ * Same as rte_reorder_drain(), but when the next buffer in sequence is
+ * missing and the following buffer present in the reorder buffer was inserted
+ * before the given TSC value, the missing sequence numbers are considered lost
+ * and skipped. This bounds the time a buffer can be held back by a lost one.
+ * Only the buffers inserted with a timestamp, by rte_reorder_insert_tsc() or
+ * rte_reorder_insert_burst(), are compared to the deadline.
+ *
+ * @param b
+ *   Reorder buffer instance from which packets are to be drained
+ * @param mbufs
+ *   array of mbufs where reordered packets will be inserted from reorder buffer
+ * @param max_mbufs
+ *   the number of elements in the mbufs array.
+ * @param tsc
+ *   TSC deadline, gaps in front of buffers inserted before it are skipped.
+ * @return
+ *   number of mbuf pointers written to mbufs. 0 <= N < max_mbufs.
+ */
+unsigned int
+rte_reorder_drain_until(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs, uint64_t tsc);
+
+/*  *** Multi-producer reorder buffer ***  */
+/*
+ * A multi-producer reorder buffer lets several lcores insert mbufs
+ * concurrently, without locks, while a single consumer lcore drains them in
+ * sequence order. Each sequence number of the window owns a slot, so the
+ * buffer holds up to size mbufs, starting at the minimum sequence number
+ * given at reset (0 after creation).
+ *
+ * Mbufs inserted late, i.e. after the window moved past their sequence
+ * number, are either refused with ERANGE or, when racing with the consumer,
+ * returned by a later drain out of order.
+ */
+
+struct rte_reorder_mp_buffer;
+
+/**
+ * Create a new multi-producer reorder buffer instance
+ *
+ * If a multi-producer reorder buffer with the same name already exists,
+ * it is returned instead.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found
+ *    - EINVAL - invalid parameters
+ */
+struct rte_reorder_mp_buffer *
+rte_reorder_mp_create(const char *name, unsigned socket_id, unsigned int size);
+
+/**
+ * Free the mbufs of a multi-producer reorder buffer instance and restart it
+ * at the given sequence number. It must not be called concurrently with any
+ * other function on the same instance.
+ *
+ * @param b
+ *   Reorder buffer instance which has to be reset
+ * @param min_seqn
+ *   Sequence number of the next mbuf to drain
+ */
+void
+rte_reorder_mp_reset(struct rte_reorder_mp_buffer *b, uint32_t min_seqn);
+
+/**
+ * Free a multi-producer reorder buffer instance and the mbufs it holds.
+ *
+ * @param b
+ *   reorder buffer instance
+ */
+void
+rte_reorder_mp_free(struct rte_reorder_mp_buffer *b);
+
+/**
+ * Insert given mbuf in multi-producer reorder buffer at its position
+ *
+ * This function is multi-thread safe, it may be called concurrently on
+ * several lcores and with a drain on another lcore.
+ *
+ * @param b
+ *   Reorder buffer where the mbuf has to be inserted.
+ * @param mbuf
+ *   mbuf of packet that needs to be inserted in reorder buffer.
+ * @return
+ *   0 on success
+ *   -1 on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOSPC - the mbuf is ahead of the window, it can be inserted once
+ *      the consumer has drained the mbufs preceding it.
+ *    - ERANGE - the mbuf is behind the window and can't be reordered.
+ */
+int
+rte_reorder_mp_insert(struct rte_reorder_mp_buffer *b, struct rte_mbuf *mbuf);
+
+/**
+ * Insert a burst of mbufs in multi-producer reorder buffer
+ *
+ * Same as calling rte_reorder_mp_insert() on each mbuf of the array. The
+ * insertion stops at the first mbuf which can't be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   array of mbufs of packets that need to be inserted in reorder buffer.
+ * @param nb_mbufs
+ *   the number of elements in the mbufs array.
+ * @return
+ *   number of mbufs inserted. If it is lower than nb_mbufs, the mbuf at that
+ *   index and the following ones are not inserted, and rte_errno is set as
+ *   described for rte_reorder_mp_insert().
+ */
+unsigned int
+rte_reorder_mp_insert_burst(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs);
+
+/**
+ * Fetch reordered buffers from a multi-producer reorder buffer
+ *
+ * Returns the mbufs following each other in sequence from the start of the
+ * window. Only a single lcore may drain a given instance.
+ *
+ * @param b
+ *   Reorder buffer instance from which packets are to be drained
+ * @param mbufs
+ *   array of mbufs where reordered packets will be inserted from reorder buffer
+ * @param max_mbufs
+ *   the number of elements in the mbufs array.
+ * @return
+ *   number of mbuf pointers written to mbufs. 0 <= N < max_mbufs.
+ */
+unsigned int
+rte_reorder_mp_drain(struct rte_reorder_mp_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs);
+
+/**
+ * Fetch reordered buffers from a multi-producer reorder buffer, skipping gaps
+ * older than a deadline
+ *
+ * Same as rte_reorder_mp_drain(), with the gap handling described for
+ * rte_reorder_drain_until().
+ *
+ * @param b
+ *   Reorder buffer instance from which packets are to be drained
+ * @param mbufs
+ *   array of mbufs where reordered packets will be inserted from reorder buffer
+ * @param max_mbufs
+ *   the number of elements in the mbufs array.
+ * @param tsc
+ *   TSC deadline, gaps in front of buffers inserted before it are skipped.
+ * @return
+ *   number of mbuf pointers written to mbufs. 0 <= N < max_mbufs.
+ */
+unsigned int
+rte_reorder_mp_drain_until(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int max_mbufs, uint64_t tsc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1047,6 +1047,30 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 	return 0;
 }
 
+int
+rte_sched_subport_read_qlen(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t *tc_qlen)
+{
+	struct rte_sched_queue *q;
+	uint32_t n_queues, i;
+
+	/* Check user parameters */
+	if (port == NULL || subport_id >= port->n_subports_per_port ||
+	    tc_qlen == NULL)
+		return -1;
+
+	n_queues = RTE_SCHED_QUEUES_PER_PIPE * port->n_pipes_per_subport;
+	q = port->queue + subport_id * n_queues;
+
+	memset(tc_qlen, 0,
+		RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE * sizeof(uint32_t));
+	for (i = 0; i < n_queues; i++, q++)
+		tc_qlen[(i >> 2) & 0x3] += (uint16_t) (q->qw - q->qr);
+
+	return 0;
+}
+
 static inline uint32_t
 rte_sched_port_qindex(struct rte_sched_port *port, uint32_t subport, uint32_t pipe, uint32_t traffic_class, uint32_t queue)
 {
@@ -359,6 +359,29 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 	struct rte_sched_queue_stats *stats,
 	uint16_t *qlen);
 
+/**
+ * Hierarchical scheduler subport queue length read
+ *
+ * Unlike the statistics read functions, this function does not clear any
+ * counter, so it can be used for monitoring while the application reads
+ * the statistics.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param tc_qlen
+ *   Pointer to pre-allocated 4-entry array where the number of packets
+ *   queued in each traffic class of the subport, summed over all its
+ *   pipes, should be stored.
+ * @return
+ *   0 upon success, error code otherwise
+ */
+int
+rte_sched_subport_read_qlen(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t *tc_qlen);
+
 /**
  * Scheduler hierarchy path write to packet descriptor. Typically
  * called by the packet classification stage.
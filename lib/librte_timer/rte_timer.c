@@ -425,8 +425,10 @@ rte_timer_reset(struct rte_timer *tim, uint64_t ticks,
 	uint64_t cur_time = rte_get_timer_cycles();
 	uint64_t period;
 
+	/* service lcores can run rte_timer_manage() from a service */
 	if (unlikely((tim_lcore != (unsigned)LCORE_ID_ANY) &&
-			!rte_lcore_is_enabled(tim_lcore)))
+			(tim_lcore >= RTE_MAX_LCORE ||
+			 rte_eal_lcore_role(tim_lcore) == ROLE_OFF)))
 		return -1;
 
 	if (type == PERIODICAL)
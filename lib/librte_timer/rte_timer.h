@@ -209,15 +209,17 @@ void rte_timer_init(struct rte_timer *tim);
  *     STOPPED state after execution.
  * @param tim_lcore
  *   The ID of the lcore where the timer callback function has to be
- *   executed. If tim_lcore is LCORE_ID_ANY, the timer library will
- *   launch it on a different core for each call (round-robin).
+ *   executed. It can be a service lcore. If tim_lcore is LCORE_ID_ANY,
+ *   the timer library will launch it on a different core for each call
+ *   (round-robin), service lcores excluded.
  * @param fct
  *   The callback function of the timer.
  * @param arg
  *   The user argument of the callback function.
  * @return
  *   - 0: Success; the timer is scheduled.
- *   - (-1): Timer is in the RUNNING or CONFIG state.
+ *   - (-1): Timer is in the RUNNING or CONFIG state, or tim_lcore is
+ *     not a valid lcore.
  */
 int rte_timer_reset(struct rte_timer *tim, uint64_t ticks,
 		    enum rte_timer_type type, unsigned tim_lcore,